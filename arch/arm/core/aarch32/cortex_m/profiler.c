@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief ARM Cortex-M profiler sampling
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/arch/arm/aarch32/cortex_m/cmsis.h>
+
+size_t arch_profiler_sample(uintptr_t *buf, size_t size)
+{
+	const uint32_t *esf;
+
+	/* Only threads are sampled: when no other exception is preempted,
+	 * the exception stack frame of the interrupted thread is on the
+	 * process stack. Its call stack cannot be walked reliably in Thumb
+	 * code, only the interrupted PC is stored.
+	 */
+	if ((size == 0U) || ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) == 0U)) {
+		return 0;
+	}
+
+	esf = (const uint32_t *)__get_PSP();
+	buf[0] = esf[6];
+
+	return 1;
+}
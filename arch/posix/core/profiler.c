@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief POSIX arch profiler sampling
+ */
+
+#include <zephyr/kernel.h>
+#include "posix_core.h"
+
+void *posix_irq_frame;
+
+size_t arch_profiler_sample(uintptr_t *buf, size_t size)
+{
+	uintptr_t *fp = posix_irq_frame;
+	size_t idx = 0;
+
+	/* Only threads are sampled, not interrupts interrupted by another */
+	if ((size == 0U) || (_current_cpu->nested != 1U) || (fp == NULL)) {
+		return 0;
+	}
+
+	/* Interrupts are handled by the thread which was running when the
+	 * hardware models raised them, posix_irq_handler() being called from
+	 * the interrupted code. The return address of its frame is the
+	 * interrupted PC, and the frames which follow are the ones of the
+	 * interrupted code.
+	 */
+	while ((idx < size) && (fp != NULL)) {
+		uintptr_t *next = (uintptr_t *)fp[0];
+
+		buf[idx++] = fp[1];
+		if (next <= fp) {
+			break;
+		}
+		fp = next;
+	}
+
+	return idx;
+}
@@ -48,6 +48,15 @@ void posix_core_clean_up(void);
 void posix_new_thread_pre_start(void); /* defined in thread.c */
 void posix_irq_check_idle_exit(void);
 
+#ifdef CONFIG_PROFILER
+/*
+ * Frame of the outermost posix_irq_handler() call, set by the board IRQ
+ * handler. Interrupts are handled on the stack of the interrupted thread,
+ * the profiler walks the interrupted code from there.
+ */
+extern void *posix_irq_frame;
+#endif
+
 #ifdef __cplusplus
 }
 #endif
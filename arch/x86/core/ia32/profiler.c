@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file Profiler sampling - IA-32 implementation
+ */
+
+#include <zephyr/kernel.h>
+#include <kernel_internal.h>
+
+static inline bool in_range(uintptr_t addr, uintptr_t start, size_t size)
+{
+	return (addr - start) < size;
+}
+
+size_t arch_profiler_sample(uintptr_t *buf, size_t size)
+{
+	uintptr_t irq_stack = (uintptr_t)_current_cpu->irq_stack -
+			      CONFIG_ISR_STACK_SIZE;
+	uint32_t *frame;
+	uintptr_t *fp;
+	size_t idx = 0;
+
+	/* Only threads are sampled. When a thread is interrupted,
+	 * _interrupt_enter saves its stack pointer at the base of the
+	 * interrupt stack, pointing to the saved EDI, ECX, EDX, EAX and
+	 * then the interrupted EIP.
+	 */
+	if ((size == 0U) || (_current_cpu->nested != 1U)) {
+		return 0;
+	}
+
+	frame = *((uint32_t **)_current_cpu->irq_stack - 1);
+	buf[idx++] = frame[4];
+
+	/* EBP is left untouched by _interrupt_enter, so the first frame
+	 * out of the interrupt stack is the one of the interrupted thread.
+	 */
+	fp = __builtin_frame_address(0);
+	while (in_range((uintptr_t)fp, irq_stack, CONFIG_ISR_STACK_SIZE)) {
+		uintptr_t *next = (uintptr_t *)fp[0];
+
+		if (next <= fp) {
+			return idx;
+		}
+		fp = next;
+	}
+
+#ifdef CONFIG_THREAD_STACK_INFO
+	while ((idx < size) &&
+	       in_range((uintptr_t)fp, _current->stack_info.start,
+			_current->stack_info.size)) {
+		uintptr_t *next = (uintptr_t *)fp[0];
+
+		buf[idx++] = fp[1];
+		if (next <= fp) {
+			break;
+		}
+		fp = next;
+	}
+#endif
+
+	return idx;
+}
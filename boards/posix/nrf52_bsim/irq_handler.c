@@ -95,6 +95,9 @@ void posix_irq_handler(void)
 
 	if (_kernel.cpus[0].nested == 0) {
 		may_swap = 0;
+#ifdef CONFIG_PROFILER
+		posix_irq_frame = __builtin_frame_address(0);
+#endif
 	}
 
 	_kernel.cpus[0].nested++;
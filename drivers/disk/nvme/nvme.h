@@ -392,7 +392,7 @@ void nvme_controller_data_swapbytes(struct nvme_controller_data *s)
 #define NVME_PCIE_BAR_IDX 0
 
 #define NVME_REQUEST_AMOUNT (CONFIG_NVME_ADMIN_ENTRIES +	\
-			     CONFIG_NVME_IO_ENTRIES)
+			     CONFIG_NVME_IO_QUEUES * CONFIG_NVME_IO_ENTRIES)
 
 /* admin queue + io queue(s) */
 #define NVME_PCIE_MSIX_VECTORS 1 + CONFIG_NVME_IO_QUEUES
@@ -409,8 +409,24 @@ void nvme_controller_data_swapbytes(struct nvme_controller_data *s)
 
 #define NVME_ADMINQ_ALLOCATE(n, n_entries)		\
 	NVME_QUEUE_ALLOCATE(admin_##n, n_entries)
-#define NVME_IOQ_ALLOCATE(n, n_entries)			\
-	NVME_QUEUE_ALLOCATE(io_##n, n_entries)
+
+#define NVME_IOQ_INIT(idx, n, n_entries)		\
+	{						\
+		.num_entries = n_entries,		\
+		.cmd = io_mem_##n[idx].cmd,		\
+		.cpl = io_mem_##n[idx].cpl,		\
+	}
+
+#define NVME_IOQ_ALLOCATE(n, n_entries)					\
+	static struct {							\
+		struct nvme_command cmd[n_entries] __aligned(0x1000);	\
+		struct nvme_completion cpl[n_entries] __aligned(0x1000); \
+	} io_mem_##n[CONFIG_NVME_IO_QUEUES];				\
+									\
+	static struct nvme_cmd_qpair io_##n[CONFIG_NVME_IO_QUEUES] = {	\
+		LISTIFY(CONFIG_NVME_IO_QUEUES, NVME_IOQ_INIT, (,),	\
+			n, n_entries)					\
+	}
 
 struct nvme_controller_config {
 	struct pcie_dev *pcie;
@@ -432,6 +448,8 @@ struct nvme_controller {
 	uint32_t num_io_queues;
 	struct nvme_cmd_qpair *adminq;
 	struct nvme_cmd_qpair *ioq;
+	/** I/O queue the next I/O command is submitted to */
+	uint32_t next_ioq;
 
 	uint32_t ready_timeout_in_ms;
 
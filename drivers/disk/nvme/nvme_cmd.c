@@ -22,6 +22,11 @@ static struct nvme_request request_pool[NVME_REQUEST_AMOUNT];
 static sys_dlist_t free_request;
 static sys_dlist_t pending_request;
 
+/* Protects the pools, the pending requests and the submission queues,
+ * used by the submitting threads and by the completion interrupts.
+ */
+static struct k_spinlock request_lock;
+
 static void request_timeout(struct k_work *work);
 
 static K_WORK_DELAYABLE_DEFINE(request_timer, request_timeout);
@@ -64,7 +69,7 @@ static void nvme_prp_list_free(struct nvme_prp_list *prp_list)
 	sys_dlist_append(&free_prp_list, &prp_list->node);
 }
 
-void nvme_cmd_request_free(struct nvme_request *request)
+static void nvme_cmd_request_free_locked(struct nvme_request *request)
 {
 	if (sys_dnode_is_linked(&request->node)) {
 		sys_dlist_remove(&request->node);
@@ -78,18 +83,31 @@ void nvme_cmd_request_free(struct nvme_request *request)
 	sys_dlist_append(&free_request, &request->node);
 }
 
+void nvme_cmd_request_free(struct nvme_request *request)
+{
+	k_spinlock_key_t key = k_spin_lock(&request_lock);
+
+	nvme_cmd_request_free_locked(request);
+	k_spin_unlock(&request_lock, key);
+}
+
 struct nvme_request *nvme_cmd_request_alloc(void)
 {
+	k_spinlock_key_t key = k_spin_lock(&request_lock);
 	sys_dnode_t *node;
 
 	node = sys_dlist_peek_head(&free_request);
+	if (node != NULL) {
+		sys_dlist_remove(node);
+	}
+
+	k_spin_unlock(&request_lock, key);
+
 	if (!node) {
 		LOG_ERR("Could not allocate request");
 		return NULL;
 	}
 
-	sys_dlist_remove(node);
-
 	return CONTAINER_OF(node, struct nvme_request, node);
 }
 
@@ -108,14 +126,27 @@ static void nvme_cmd_register_request(struct nvme_request *request)
 static void request_timeout(struct k_work *work)
 {
 	uint32_t current = k_uptime_get_32();
-	struct nvme_request *request, *next;
+	struct nvme_request *request;
+	k_spinlock_key_t key;
+	int32_t remaining = 0;
 
 	ARG_UNUSED(work);
 
-	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&pending_request,
-					  request, next, node) {
-		if ((int32_t)(request->req_start +
-			      CONFIG_NVME_REQUEST_TIMEOUT - current) > 0) {
+	while (1) {
+		key = k_spin_lock(&request_lock);
+		request = SYS_DLIST_PEEK_HEAD_CONTAINER(&pending_request,
+							 request, node);
+		if (request != NULL) {
+			remaining = (int32_t)(request->req_start +
+					      CONFIG_NVME_REQUEST_TIMEOUT -
+					      current);
+			if (remaining <= 0) {
+				sys_dlist_remove(&request->node);
+			}
+		}
+		k_spin_unlock(&request_lock, key);
+
+		if ((request == NULL) || (remaining > 0)) {
 			break;
 		}
 
@@ -136,10 +167,7 @@ static void request_timeout(struct k_work *work)
 	}
 
 	if (request) {
-		k_work_reschedule(&request_timer,
-				  K_SECONDS(request->req_start +
-					    CONFIG_NVME_REQUEST_TIMEOUT -
-					    current));
+		k_work_reschedule(&request_timer, K_SECONDS(remaining));
 	}
 }
 
@@ -230,12 +258,29 @@ static void nvme_cmd_request_complete(struct nvme_request *request,
 	}
 
 	if (retry) {
+		struct nvme_cmd_qpair *qpair = request->qpair;
+		nvme_cb_fn_t cb_fn = request->cb_fn;
+		void *cb_arg = request->cb_arg;
+		k_spinlock_key_t key = k_spin_lock(&request_lock);
+		int ret;
+
 		LOG_DBG("Retrying CMD");
 		/* Let's remove it from pending... */
 		sys_dlist_remove(&request->node);
+		k_spin_unlock(&request_lock, key);
+
 		/* ...and re-submit, thus re-adding to pending */
-		nvme_cmd_qpair_submit_request(request->qpair, request);
 		request->retries++;
+		ret = nvme_cmd_qpair_submit_request(qpair, request);
+		if (ret != 0) {
+			/* The request was freed, complete it with the error */
+			LOG_ERR("Could not retry CMD (%d)", ret);
+			qpair->num_failures++;
+
+			if (cb_fn) {
+				cb_fn(cb_arg, cpl);
+			}
+		}
 	} else {
 		LOG_DBG("Request %p CMD complete on %p/%p",
 			request, request->cb_fn, request->cb_arg);
@@ -445,6 +490,7 @@ int nvme_cmd_qpair_submit_request(struct nvme_cmd_qpair *qpair,
 				  struct nvme_request *request)
 {
 	mm_reg_t regs = DEVICE_MMIO_GET(qpair->ctrlr->dev);
+	k_spinlock_key_t key;
 	int ret;
 
 	request->qpair = qpair;
@@ -452,9 +498,17 @@ int nvme_cmd_qpair_submit_request(struct nvme_cmd_qpair *qpair,
 	request->cmd.cdw0.cid = sys_cpu_to_le16((uint16_t)(request -
 							   request_pool));
 
-	ret = nvme_cmd_qpair_fill_dptr(qpair, request);
+	key = k_spin_lock(&request_lock);
+
+	if (((qpair->sq_tail + 1) % qpair->num_entries) == qpair->sq_head) {
+		ret = -EBUSY;
+	} else {
+		ret = nvme_cmd_qpair_fill_dptr(qpair, request);
+	}
+
 	if (ret != 0) {
-		nvme_cmd_request_free(request);
+		nvme_cmd_request_free_locked(request);
+		k_spin_unlock(&request_lock, key);
 		return ret;
 	}
 
@@ -471,6 +525,8 @@ int nvme_cmd_qpair_submit_request(struct nvme_cmd_qpair *qpair,
 	sys_write32(qpair->sq_tail, regs + qpair->sq_tdbl_off);
 	qpair->num_cmds++;
 
+	k_spin_unlock(&request_lock, key);
+
 	LOG_DBG("Request %p %llu submitted: CID %u - sq_tail %u",
 		request, qpair->num_cmds, request->cmd.cdw0.cid,
 		qpair->sq_tail - 1);
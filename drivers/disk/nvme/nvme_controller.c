@@ -469,7 +469,7 @@ static int nvme_controller_init(const struct device *dev)
 		.id = n,						\
 		.num_io_queues = CONFIG_NVME_IO_QUEUES,			\
 		.adminq = &admin_##n,					\
-		.ioq = &io_##n,						\
+		.ioq = io_##n,						\
 	};								\
 									\
 	static struct nvme_controller_config nvme_ctrlr_cfg_##n =	\
@@ -8,9 +8,24 @@ LOG_MODULE_DECLARE(nvme, CONFIG_NVME_LOG_LEVEL);
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/byteorder.h>
+#include <zephyr/storage/disk_access.h>
 
 #include "nvme.h"
 
+/* I/O commands are spread over the I/O queues, so the controller can
+ * process the commands queued by asynchronous requests in parallel.
+ * Called with the controller locked.
+ */
+static struct nvme_cmd_qpair *nvme_disk_ioq(struct nvme_namespace *ns)
+{
+	struct nvme_controller *ctrlr = ns->ctrlr;
+	struct nvme_cmd_qpair *qpair = &ctrlr->ioq[ctrlr->next_ioq];
+
+	ctrlr->next_ioq = (ctrlr->next_ioq + 1) % ctrlr->num_io_queues;
+
+	return qpair;
+}
+
 static int nvme_disk_init(struct disk_info *disk)
 {
 	return 0;
@@ -48,10 +63,10 @@ static int nvme_disk_read(struct disk_info *disk,
 	nvme_namespace_read_cmd(&request->cmd, ns->id,
 				start_sector, num_sector);
 
-	/* We use only the first ioq atm
-	 * ToDo: use smp cpu id and use it to select ioq
-	 */
-	nvme_cmd_qpair_submit_request(ns->ctrlr->ioq, request);
+	ret = nvme_cmd_qpair_submit_request(nvme_disk_ioq(ns), request);
+	if (ret != 0) {
+		goto out;
+	}
 
 	nvme_completion_poll(&status);
 	if (nvme_cpl_status_is_error(&status)) {
@@ -91,10 +106,10 @@ static int nvme_disk_write(struct disk_info *disk,
 	nvme_namespace_write_cmd(&request->cmd, ns->id,
 				 start_sector, num_sector);
 
-	/* We use only the first ioq atm
-	 * ToDo: use smp cpu id and use it to select ioq
-	 */
-	nvme_cmd_qpair_submit_request(ns->ctrlr->ioq, request);
+	ret = nvme_cmd_qpair_submit_request(nvme_disk_ioq(ns), request);
+	if (ret != 0) {
+		goto out;
+	}
 
 	nvme_completion_poll(&status);
 	if (nvme_cpl_status_is_error(&status)) {
@@ -112,6 +127,7 @@ static int nvme_disk_flush(struct nvme_namespace *ns)
 	struct nvme_completion_poll_status status =
 		NVME_CPL_STATUS_POLL_INIT(status);
 	struct nvme_request *request;
+	int ret;
 
 	request = nvme_allocate_request_null(nvme_completion_poll_cb, &status);
 	if (request == NULL) {
@@ -120,10 +136,11 @@ static int nvme_disk_flush(struct nvme_namespace *ns)
 
 	nvme_namespace_flush_cmd(&request->cmd, ns->id);
 
-	/* We use only the first ioq
-	 * ToDo: use smp cpu id and use it to select ioq
-	 */
-	nvme_cmd_qpair_submit_request(ns->ctrlr->ioq, request);
+	/* The flush applies to the commands completed on all queues */
+	ret = nvme_cmd_qpair_submit_request(nvme_disk_ioq(ns), request);
+	if (ret != 0) {
+		return ret;
+	}
 
 	nvme_completion_poll(&status);
 	if (nvme_cpl_status_is_error(&status)) {
@@ -181,12 +198,69 @@ static int nvme_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
 	return ret;
 }
 
+#ifdef CONFIG_DISK_ACCESS_ASYNC
+static void nvme_disk_submit_cb(void *arg, const struct nvme_completion *cpl)
+{
+	struct disk_access_req *req = arg;
+	int result = 0;
+
+	if (cpl == NULL) {
+		result = -ETIMEDOUT;
+	} else if (nvme_completion_is_error(cpl)) {
+		result = -EIO;
+	}
+
+	disk_access_req_done(req, result);
+}
+
+static int nvme_disk_submit(struct disk_info *disk,
+			    struct disk_access_req *req,
+			    uint8_t *data_buf,
+			    uint32_t start_sector,
+			    uint32_t num_sector)
+{
+	struct nvme_namespace *ns = CONTAINER_OF(disk->name,
+						 struct nvme_namespace, name);
+	struct nvme_request *request;
+	uint32_t payload_size;
+	int ret;
+
+	nvme_lock(disk->dev);
+
+	payload_size = num_sector * nvme_namespace_get_sector_size(ns);
+
+	request = nvme_allocate_request_vaddr((void *)data_buf, payload_size,
+					      nvme_disk_submit_cb, req);
+	if (request == NULL) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	if (req->op == DISK_ACCESS_OP_READ) {
+		nvme_namespace_read_cmd(&request->cmd, ns->id,
+					start_sector, num_sector);
+	} else {
+		nvme_namespace_write_cmd(&request->cmd, ns->id,
+					 start_sector, num_sector);
+	}
+
+	/* Completed from the queue interrupt, unless it fails here */
+	ret = nvme_cmd_qpair_submit_request(nvme_disk_ioq(ns), request);
+out:
+	nvme_unlock(disk->dev);
+	return ret;
+}
+#endif /* CONFIG_DISK_ACCESS_ASYNC */
+
 static const struct disk_operations nvme_disk_ops = {
 	.init = nvme_disk_init,
 	.status = nvme_disk_status,
 	.read = nvme_disk_read,
 	.write = nvme_disk_write,
 	.ioctl = nvme_disk_ioctl,
+#ifdef CONFIG_DISK_ACCESS_ASYNC
+	.submit = nvme_disk_submit,
+#endif
 };
 
 int nvme_namespace_disk_setup(struct nvme_namespace *ns,
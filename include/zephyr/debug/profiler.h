@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_PROFILER_H_
+#define ZEPHYR_INCLUDE_DEBUG_PROFILER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup profiler Sampling CPU profiler
+ *  @ingroup os_services
+ *  @brief Statistical profiler driven by the system timer
+ *
+ *  The profiler samples the code interrupted by the system timer
+ *  interrupt and counts the samples of each distinct program counter,
+ *  or call stack when CONFIG_PROFILER_CALL_STACK is enabled.
+ *  @{
+ */
+
+/** Profiler statistics. */
+struct profiler_stats {
+	/** Number of samples taken. */
+	uint32_t samples;
+	/** Number of samples which did not interrupt a thread. */
+	uint32_t missed;
+	/** Number of samples which did not fit in the histogram. */
+	uint32_t lost;
+};
+
+/** @brief Histogram entry callback function
+ *
+ *  @param stack     Sampled addresses, the interrupted program counter
+ *                   first, followed by the return addresses of its call
+ *                   stack, innermost first.
+ *  @param depth     Number of addresses in @p stack.
+ *  @param count     Number of samples of that stack.
+ *  @param user_data User data passed to profiler_foreach().
+ */
+typedef void (*profiler_cb_t)(const uintptr_t *stack, size_t depth,
+			      uint32_t count, void *user_data);
+
+/** @brief Start sampling.
+ *
+ *  Samples are added to the ones of previous runs until profiler_reset()
+ *  is called.
+ *
+ *  @param frequency Sampling frequency in Hz, at most the system clock
+ *                   tick frequency.
+ *
+ *  @retval 0 on success.
+ *  @retval -EALREADY if the profiler is already running.
+ *  @retval -EINVAL if the frequency is not supported.
+ */
+int profiler_start(uint32_t frequency);
+
+/** @brief Stop sampling.
+ *
+ *  @retval 0 on success.
+ *  @retval -EALREADY if the profiler is not running.
+ */
+int profiler_stop(void);
+
+/** @brief Check if the profiler is running.
+ *
+ *  @return true if sampling, false otherwise.
+ */
+bool profiler_is_running(void);
+
+/** @brief Clear the histogram and the statistics. */
+void profiler_reset(void);
+
+/** @brief Get the profiler statistics.
+ *
+ *  @param stats Statistics.
+ */
+void profiler_stats_get(struct profiler_stats *stats);
+
+/** @brief Call a function for each histogram entry.
+ *
+ *  @param cb        Callback function.
+ *  @param user_data User data passed to @p cb.
+ *
+ *  @retval 0 on success.
+ *  @retval -EBUSY if the profiler is running.
+ */
+int profiler_foreach(profiler_cb_t cb, void *user_data);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_PROFILER_H_ */
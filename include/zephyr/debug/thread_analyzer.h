@@ -7,6 +7,7 @@
 #ifndef __STACK_SIZE_ANALYZER_H
 #define __STACK_SIZE_ANALYZER_H
 #include <stddef.h>
+#include <zephyr/kernel.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,13 @@ struct thread_analyzer_info {
 	k_thread_runtime_stats_t  usage;
 #endif
 #endif
+
+#ifdef CONFIG_THREAD_ANALYZER_INCREMENTAL
+	/** CPU load during the last analyzer step interval, in percent */
+	unsigned int load;
+	/** Moving average of the CPU load, in percent */
+	unsigned int load_avg;
+#endif
 };
 
 /** @brief Thread analyzer stack size callback function
@@ -63,6 +71,42 @@ void thread_analyzer_run(thread_analyzer_cb cb);
  */
 void thread_analyzer_print(void);
 
+/** Stack usage threshold crossed */
+#define THREAD_ANALYZER_EVENT_STACK BIT(0)
+/** CPU load threshold crossed */
+#define THREAD_ANALYZER_EVENT_CPU   BIT(1)
+
+/** @brief Thread analyzer event callback function
+ *
+ *  Called from the analyzer step when a thread crosses a threshold.
+ *
+ *  @param thread Thread.
+ *  @param event THREAD_ANALYZER_EVENT_STACK or THREAD_ANALYZER_EVENT_CPU.
+ *  @param value Stack usage or average CPU load, in percent.
+ */
+typedef void (*thread_analyzer_event_cb)(const struct k_thread *thread,
+					 uint32_t event, unsigned int value);
+
+/** @brief Set the threshold event callback
+ *
+ *  By default, the events are printed.
+ *
+ *  @param cb The callback function handler, NULL to restore the default.
+ */
+void thread_analyzer_event_cb_set(thread_analyzer_event_cb cb);
+
+/** @brief Run one incremental analyzer step
+ *
+ *  Update the stack high-water mark and the CPU load of all threads. The
+ *  stack scan of each thread is bounded by CONFIG_THREAD_ANALYZER_SCAN_WINDOW
+ *  and CONFIG_THREAD_ANALYZER_SCAN_BUDGET. The CPU load is computed over
+ *  the time since the previous step.
+ *
+ *  Steps run periodically when CONFIG_THREAD_ANALYZER_INCREMENTAL_INTERVAL
+ *  is not 0.
+ */
+void thread_analyzer_step(void);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -29,8 +29,16 @@
 extern "C" {
 #endif
 
+/** @cond INTERNAL_HIDDEN */
+#ifdef CONFIG_IMG_DOUBLE_BUFFER
+#define FLASH_IMG_BUF_SIZE (2 * CONFIG_IMG_BLOCK_BUF_SIZE)
+#else
+#define FLASH_IMG_BUF_SIZE CONFIG_IMG_BLOCK_BUF_SIZE
+#endif
+/** @endcond */
+
 struct flash_img_context {
-	uint8_t buf[CONFIG_IMG_BLOCK_BUF_SIZE];
+	uint8_t buf[FLASH_IMG_BUF_SIZE];
 	const struct flash_area *flash_area;
 	struct stream_flash_ctx stream;
 };
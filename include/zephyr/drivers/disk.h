@@ -62,6 +62,7 @@ extern "C" {
 #define DISK_STATUS_WR_PROTECT		0x04
 
 struct disk_operations;
+struct disk_access_req;
 
 /**
  * @brief Disk info
@@ -75,6 +76,14 @@ struct disk_info {
 	const struct disk_operations *ops;
 	/** Device associated to this disk */
 	const struct device *dev;
+#if defined(CONFIG_DISK_CACHE) || defined(__DOXYGEN__)
+	/** Sector size used by the disk cache, 0 until first access */
+	uint32_t cache_sector_size;
+	/** Sector count used by the disk cache */
+	uint32_t cache_sector_count;
+	/** Sector following the last read, to detect sequential reads */
+	uint32_t cache_next_read;
+#endif
 };
 
 /**
@@ -88,6 +97,17 @@ struct disk_operations {
 	int (*write)(struct disk_info *disk, const uint8_t *data_buf,
 		     uint32_t start_sector, uint32_t num_sector);
 	int (*ioctl)(struct disk_info *disk, uint8_t cmd, void *buff);
+#if defined(CONFIG_DISK_ACCESS_ASYNC) || defined(__DOXYGEN__)
+	/**
+	 * Optional, queue the transfer of a buffer of request @a req and
+	 * return without waiting for it. The driver calls
+	 * disk_access_req_done() when the transfer completed, unless an
+	 * error is returned.
+	 */
+	int (*submit)(struct disk_info *disk, struct disk_access_req *req,
+		      uint8_t *data_buf, uint32_t start_sector,
+		      uint32_t num_sector);
+#endif
 };
 
 /**
@@ -108,6 +128,18 @@ int disk_access_register(struct disk_info *disk);
  */
 int disk_access_unregister(struct disk_info *disk);
 
+#if defined(CONFIG_DISK_ACCESS_ASYNC) || defined(__DOXYGEN__)
+/**
+ * @brief Report the completion of a transfer queued by the submit operation
+ *
+ * May be called from an interrupt handler.
+ *
+ * @param[in] req    Request the transfer belongs to
+ * @param[in] result 0 on success, negative errno code on fail
+ */
+void disk_access_req_done(struct disk_access_req *req, int result);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_FS_COMPRESS_FS_H_
+#define ZEPHYR_INCLUDE_FS_COMPRESS_FS_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File system info structure for a compressed file system mount
+ *
+ * A compressed file system is stacked on a directory of another mounted
+ * file system, typically littlefs. A file opened as ``<mnt_point>/<path>``
+ * is stored, compressed, as ``<backing_dir>/<path>``. Directories are
+ * created in the backing directory as they are.
+ *
+ * Files are split in blocks of @kconfig{CONFIG_FS_COMPRESS_BLOCK_SIZE} bytes,
+ * compressed with LZ4 independently of each other, so reading from any
+ * position only decompresses the block holding it. Data can only be written
+ * at the end of a file, a file can be truncated to any length.
+ *
+ * A pointer to an object of this type must be stored in the ``.fs_data``
+ * field of a :c:type:`struct fs_mount_t` object of type @c FS_COMPRESS.
+ */
+struct fs_compress {
+	/**
+	 * Absolute path of the backing directory, outside of the mount point.
+	 * It is created when mounting if it does not exist.
+	 */
+	const char *backing_dir;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_FS_COMPRESS_FS_H_ */
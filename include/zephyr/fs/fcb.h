@@ -77,6 +77,19 @@ struct fcb_entry_ctx {
 	/**< Flash area where the entry is placed */
 };
 
+/**
+ * @brief Cached location of a valid FCB entry, see fcb::f_index.
+ */
+struct fcb_index_entry {
+	uint32_t ie_elem_off;
+	/**< Offset from the start of the sector to beginning of element. */
+
+	uint16_t ie_data_len;
+	/**< Size of data area in fcb entry, UINT16_MAX when unused */
+
+	uint8_t ie_sector; /**< Index of the sector in fcb::f_sectors */
+};
+
 /**
  * @brief Flag to disable CRC for the fcb_entries in flash.
  */
@@ -139,6 +152,15 @@ struct fcb {
 	const uint8_t f_flags;
 	/**< Flags for configuring the FCB. */
 #endif
+#if defined(CONFIG_FCB_INDEX) || defined(__DOXYGEN__)
+	struct fcb_index_entry *f_index;
+	/**< Optional array where the locations of the entries verified or
+	 * appended are cached, so that fcb_getnext() and fcb_walk() reach
+	 * them again without reading flash. May be NULL. Filled in by the
+	 * caller of fcb_init, the contents are initialized by fcb_init.
+	 */
+	uint16_t f_index_cnt; /**< Number of elements in f_index array */
+#endif
 };
 
 /**
@@ -189,6 +211,39 @@ int fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *loc);
  */
 int fcb_append_finish(struct fcb *fcb, struct fcb_entry *append_loc);
 
+/**
+ * Appends several entries to circular buffer.
+ *
+ * The entries are written complete, with their data and end markers, in
+ * chunks of up to CONFIG_FCB_APPEND_BATCH_BUF_SIZE bytes instead of with
+ * one flash write per part of each entry. Entries are placed the same way
+ * as with fcb_append().
+ *
+ * @param[in] fcb FCB instance structure.
+ * @param[in] data Payloads of the entries, in append order.
+ * @param[in] lens Payload lengths of the entries.
+ * @param[in] cnt Number of entries.
+ *
+ * @return 0 on success, negative errno code on failure. On failure, the
+ *         entries before the failing one may have been appended.
+ */
+int fcb_append_batch(struct fcb *fcb, const void *const *data,
+		     const uint16_t *lens, int cnt);
+
+/**
+ * Check whether entries can be appended without rotating the FCB.
+ *
+ * Entries are placed the same way as with fcb_append(), the scratch
+ * sectors are not used.
+ *
+ * @param[in] fcb FCB instance structure.
+ * @param[in] lens Payload lengths of the entries, in append order.
+ * @param[in] cnt Number of entries.
+ *
+ * @return true if all the entries fit in the free space of the FCB.
+ */
+bool fcb_append_fits(struct fcb *fcb, const uint16_t *lens, int cnt);
+
 /**
  * FCB Walk callback function type.
  *
@@ -53,6 +53,9 @@ enum {
 	/** Identifier for in-tree LittleFS file system. */
 	FS_LITTLEFS,
 
+	/** Identifier for in-tree compressed file system layer. */
+	FS_COMPRESS,
+
 	/** Base identifier for external file systems. */
 	FS_TYPE_EXTERNAL_BASE,
 };
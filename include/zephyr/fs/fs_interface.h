@@ -54,6 +54,9 @@ struct fs_file_t {
 	void *filep;
 	const struct fs_mount_t *mp;
 	fs_mode_t flags;
+#ifdef CONFIG_FILE_SYSTEM_PATH_CACHE
+	uint32_t path_hash;
+#endif
 };
 
 /**
@@ -31,6 +31,33 @@ extern "C" {
  * @{
  */
 
+/** @cond INTERNAL_HIDDEN */
+
+#if CONFIG_NVS_INDEX
+/* Number of hash buckets of the ID index */
+#define NVS_INDEX_BUCKETS ((CONFIG_NVS_INDEX_SIZE + 1) / 2)
+
+/* ID index entry, chained to the other entries of its bucket */
+struct nvs_index_entry {
+	uint32_t addr;
+	uint16_t id;
+	uint16_t next;
+};
+#endif
+
+/* State of a garbage collection, kept between the steps of a background one */
+struct nvs_gc_state {
+	uint32_t sec_addr;
+	uint32_t gc_addr;
+	uint32_t stop_addr;
+	uint16_t data_end;
+	uint16_t max_len;
+	bool moving;
+	bool active;
+};
+
+/** @endcond */
+
 /**
  * @brief Non-volatile Storage File system structure
  *
@@ -58,6 +85,17 @@ struct nvs_fs {
 #if CONFIG_NVS_LOOKUP_CACHE
 	uint32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
 #endif
+#if CONFIG_NVS_INDEX
+	struct nvs_index_entry index[CONFIG_NVS_INDEX_SIZE];
+	uint16_t index_buckets[NVS_INDEX_BUCKETS];
+	uint16_t index_free;
+	bool index_complete;
+#endif
+#if CONFIG_NVS_GC_BACKGROUND
+	struct k_work gc_work;
+	struct nvs_gc_state gc;
+	bool gc_armed;
+#endif
 };
 
 /**
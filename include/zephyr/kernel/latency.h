@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_KERNEL_LATENCY_H_
+#define ZEPHYR_INCLUDE_KERNEL_LATENCY_H_
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup latency_histograms Latency histograms
+ * @ingroup kernel_apis
+ *
+ * Distributions of kernel latencies, in timing cycles (see
+ * timing_cycles_to_ns()), gathered when CONFIG_LATENCY_HISTOGRAMS is
+ * enabled. The functions are not system calls.
+ * @{
+ */
+
+/** Kinds of latency histograms */
+enum k_latency_type {
+	/** Scheduling latency of a thread, from ready to running */
+	K_LATENCY_SCHED,
+	/** Duration of an interrupt handler */
+	K_LATENCY_ISR,
+	/** Time blocked in k_sem_take() */
+	K_LATENCY_SEM_TAKE,
+	/** Time blocked in k_msgq_get() */
+	K_LATENCY_MSGQ_GET,
+};
+
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+
+/**
+ * @brief Get the start of a histogram bucket
+ *
+ * The bucket counts the durations from its start up to the start of the
+ * next bucket. The last bucket also counts all longer durations.
+ *
+ * @param bucket Bucket index, lower than K_LATENCY_HISTOGRAM_BUCKETS.
+ *
+ * @return Shortest duration counted in the bucket, in timing cycles.
+ */
+uint32_t k_latency_bucket_start(unsigned int bucket);
+
+/**
+ * @brief Get the scheduling latency histogram of a thread
+ *
+ * @param thread Thread.
+ * @param hist Histogram copy.
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if CONFIG_SCHED_LATENCY_HISTOGRAM is disabled.
+ */
+int k_thread_sched_latency_get(k_tid_t thread, struct k_latency_histogram *hist);
+
+/**
+ * @brief Clear the scheduling latency histogram of a thread
+ *
+ * @param thread Thread.
+ */
+void k_thread_sched_latency_reset(k_tid_t thread);
+
+/**
+ * @brief Interrupt handler histogram callback
+ *
+ * @param isr Interrupt handler.
+ * @param hist Histogram of the handler duration.
+ * @param user_data User data.
+ */
+typedef void (*k_isr_latency_cb_t)(const void *isr,
+				   const struct k_latency_histogram *hist,
+				   void *user_data);
+
+/**
+ * @brief Call a function for the histogram of each interrupt handler
+ *
+ * @param cb Callback, called with a copy of each histogram, without any
+ *        lock held.
+ * @param user_data User data passed to @p cb.
+ *
+ * @return Number of handler runs which were not counted because all the
+ *         histograms were taken.
+ */
+uint32_t k_isr_latency_foreach(k_isr_latency_cb_t cb, void *user_data);
+
+/**
+ * @brief Get a wait time histogram
+ *
+ * @param type K_LATENCY_SEM_TAKE or K_LATENCY_MSGQ_GET.
+ * @param hist Histogram copy.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @p type is not a wait time histogram.
+ * @retval -ENOTSUP if CONFIG_WAIT_LATENCY_HISTOGRAMS is disabled.
+ */
+int k_wait_latency_get(enum k_latency_type type,
+		       struct k_latency_histogram *hist);
+
+/**
+ * @brief Clear the interrupt handler and wait time histograms
+ *
+ * The thread histograms are cleared with k_thread_sched_latency_reset().
+ */
+void k_latency_reset(void);
+
+/**
+ * @brief Emit the histograms as tracing events
+ *
+ * One event is emitted for each non-empty bucket of each histogram, the
+ * thread histograms are only emitted with CONFIG_THREAD_MONITOR.
+ */
+void k_latency_trace(void);
+
+#endif /* CONFIG_LATENCY_HISTOGRAMS */
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_KERNEL_LATENCY_H_ */
@@ -25,4 +25,22 @@ struct k_cycle_stats {
 	bool      track_usage;  /* true if gathering usage stats */
 };
 
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+/*
+ * [k_latency_histogram] counts durations, in timing cycles, in log-linear
+ * buckets: each power of two range is split in
+ * 2^CONFIG_LATENCY_HISTOGRAM_PRECISION buckets.
+ */
+
+#define K_LATENCY_HISTOGRAM_BUCKETS					\
+	((CONFIG_LATENCY_HISTOGRAM_RANGE - CONFIG_LATENCY_HISTOGRAM_PRECISION + 1) \
+	 << CONFIG_LATENCY_HISTOGRAM_PRECISION)
+
+struct k_latency_histogram {
+	uint32_t  count;        /* # of durations counted */
+	uint32_t  max;          /* longest duration in cycles */
+	uint32_t  buckets[K_LATENCY_HISTOGRAM_BUCKETS];
+};
+#endif
+
 #endif
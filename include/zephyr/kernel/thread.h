@@ -140,6 +140,12 @@ struct _thread_base {
 #ifdef CONFIG_SCHED_THREAD_USAGE
 	struct k_cycle_stats  usage;   /* Track thread usage statistics */
 #endif
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	/* timing counter when made ready, 0 if not waiting to run */
+	uint32_t ready_stamp;
+	struct k_latency_histogram  sched_latency;
+#endif
 };
 
 typedef struct _thread_base _thread_base_t;
@@ -171,6 +177,31 @@ struct _thread_stack_info {
 typedef struct _thread_stack_info _thread_stack_info_t;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#ifdef CONFIG_THREAD_ANALYZER_INCREMENTAL
+/* State of the incremental thread analyzer, zeroed at thread creation */
+struct _thread_analyzer {
+	/* Stack bytes known to be used, from the highest watermark found */
+	size_t stack_used;
+
+	/* Offset from the stack bottom where the next verification scan
+	 * resumes
+	 */
+	size_t scan_cursor;
+
+	/* Execution cycles at the previous analyzer step */
+	uint64_t cycles;
+
+	/* CPU load during the previous interval, in percent */
+	uint8_t load;
+
+	/* Thresholds crossed, THREAD_ANALYZER_EVENT_* bits */
+	uint8_t events;
+
+	/* Moving average of the CPU load, in 1/256 percent */
+	uint16_t load_avg;
+};
+#endif /* CONFIG_THREAD_ANALYZER_INCREMENTAL */
+
 #if defined(CONFIG_USERSPACE)
 struct _mem_domain_info {
 	/** memory domain queue node */
@@ -342,6 +373,11 @@ struct k_thread {
 	struct _pipe_desc pipe_desc;
 #endif
 
+#ifdef CONFIG_THREAD_ANALYZER_INCREMENTAL
+	/** Incremental thread analyzer state */
+	struct _thread_analyzer analyzer;
+#endif
+
 	/** arch-specifics: must always be at the end */
 	struct _thread_arch arch;
 };
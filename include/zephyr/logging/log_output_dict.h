@@ -47,6 +47,102 @@ struct log_dict_output_dropped_msg_t {
 	uint16_t num_dropped_messages;
 } __packed;
 
+/** Version of the block framing of dictionary based log messages. */
+#define LOG_DICT_BLOCK_VERSION 1
+
+/** Payload of the block is compressed. */
+#define LOG_DICT_BLOCK_FLAG_COMPRESSED BIT(0)
+
+/**
+ * Header of a block of dictionary based log messages.
+ *
+ * The magic is "ZLDB". Multi-byte fields are little endian regardless of
+ * the target endianness. The header is followed by @p len bytes of payload
+ * which are, once decompressed, @p raw_len bytes of log messages.
+ */
+struct log_dict_output_block_hdr_t {
+	uint8_t magic[4];
+	uint8_t version;
+	uint8_t flags;
+	uint16_t seq;
+	uint16_t len;
+	uint16_t raw_len;
+} __packed;
+
+/**
+ * Block framing of dictionary based log messages.
+ *
+ * Messages are accumulated in the block buffer and the block is passed to
+ * the output function in one call, with a struct log_dict_output_block_hdr_t
+ * header, when it is full or flushed. Messages are not split between blocks
+ * unless they are larger than a block.
+ */
+struct log_dict_block {
+	log_output_func_t func;
+	void *ctx;
+	uint8_t *buf;
+	uint8_t *frame;
+	size_t size;
+	size_t len;
+	size_t wr;
+	uint16_t seq;
+};
+
+/** @brief Create a block framing instance.
+ *
+ * @param _name Instance name.
+ * @param _func Function receiving the blocks.
+ * @param _size Size of the block payload.
+ */
+#define LOG_DICT_BLOCK_DEFINE(_name, _func, _size)				\
+	static uint8_t _name##_buf[_size];					\
+	static uint8_t _name##_frame[sizeof(struct log_dict_output_block_hdr_t) + \
+				     (_size)];					\
+	static struct log_dict_block _name = {					\
+		.func = _func,							\
+		.buf = _name##_buf,						\
+		.frame = _name##_frame,						\
+		.size = _size,							\
+	}
+
+/** @brief Set context passed to the function receiving the blocks.
+ *
+ * @param block Pointer to the block framing instance.
+ * @param ctx   User context.
+ */
+static inline void log_dict_block_ctx_set(struct log_dict_block *block, void *ctx)
+{
+	block->ctx = ctx;
+}
+
+/** @brief Output function appending data to a block.
+ *
+ * To be used as the function of the log_output instance given to
+ * log_dict_output_msg_process(), with the block framing instance as context.
+ *
+ * @param data   Data.
+ * @param length Data length.
+ * @param ctx    Pointer to the block framing instance.
+ *
+ * @return Number of bytes consumed.
+ */
+int log_dict_block_out(uint8_t *data, size_t length, void *ctx);
+
+/** @brief Mark the end of a message in the block.
+ *
+ * Data written since the previous call form one message which is kept
+ * together in a block.
+ *
+ * @param block Pointer to the block framing instance.
+ */
+void log_dict_block_commit(struct log_dict_block *block);
+
+/** @brief Output the complete messages of the block now.
+ *
+ * @param block Pointer to the block framing instance.
+ */
+void log_dict_block_flush(struct log_dict_block *block);
+
 /** @brief Process log messages v2 for dictionary-based logging.
  *
  * Function is using provided context with the buffer and output function to
@@ -14,6 +14,7 @@
 #define ZEPHYR_INCLUDE_NET_CAPTURE_H_
 
 #include <zephyr/kernel.h>
+#include <zephyr/net/net_ip.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -192,6 +193,267 @@ static inline int net_capture_send(const struct device *dev, struct net_if *ifac
 #endif
 }
 
+/** Filter matches only the given address family */
+#define NET_CAPTURE_FILTER_FAMILY BIT(0)
+/** Filter matches only the given IP protocol */
+#define NET_CAPTURE_FILTER_PROTO  BIT(1)
+/** Filter matches only the given source or destination port */
+#define NET_CAPTURE_FILTER_PORT   BIT(2)
+/** Filter matches only the given source or destination address */
+#define NET_CAPTURE_FILTER_HOST   BIT(3)
+
+/**
+ * @brief Network packet capture filter.
+ *
+ * @details The filter is evaluated against the network and transport
+ * headers of a packet before the packet is copied anywhere. All the
+ * conditions that are set in @a flags must match for the packet to be
+ * captured. An empty filter (flags == 0) matches every packet.
+ */
+struct net_capture_filter {
+	/** Source or destination address, valid if NET_CAPTURE_FILTER_HOST */
+	struct sockaddr addr;
+	/** Source or destination port in host byte order */
+	uint16_t port;
+	/** IP protocol (IPPROTO_UDP, IPPROTO_TCP, ...) */
+	uint8_t proto;
+	/** Address family (AF_INET or AF_INET6) */
+	sa_family_t family;
+	/** Which of the above conditions are in use */
+	uint8_t flags;
+};
+
+/**
+ * @brief Parse a textual filter expression.
+ *
+ * @details The expression is a list of primitives joined by "and", in
+ * the spirit of pcap-filter(7). Supported primitives are
+ * "ip", "ip6", "tcp", "udp", "icmp", "icmp6", "port <number>" and
+ * "host <address>". An empty string or "any" matches all packets.
+ * Example: "udp and port 5353 and host 192.0.2.2"
+ *
+ * @param expr Filter expression.
+ * @param filter Parsed filter is stored here.
+ *
+ * @return 0 if ok, <0 if the expression could not be parsed.
+ */
+#if defined(CONFIG_NET_CAPTURE)
+int net_capture_filter_parse(const char *expr, struct net_capture_filter *filter);
+#else
+static inline int net_capture_filter_parse(const char *expr,
+					   struct net_capture_filter *filter)
+{
+	ARG_UNUSED(expr);
+	ARG_UNUSED(filter);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Check if a network packet matches a capture filter.
+ *
+ * @details The packet data is not modified and the packet cursor is not
+ * moved. Packets whose network header cannot be located (for example
+ * compressed 6LoWPAN frames) only match an empty filter.
+ *
+ * @param filter Capture filter.
+ * @param iface Network interface the packet is sent to or received from.
+ * @param pkt Network packet.
+ *
+ * @return True if the packet should be captured, false otherwise.
+ */
+#if defined(CONFIG_NET_CAPTURE)
+bool net_capture_filter_match(const struct net_capture_filter *filter,
+			      struct net_if *iface, struct net_pkt *pkt);
+#else
+static inline bool net_capture_filter_match(const struct net_capture_filter *filter,
+					    struct net_if *iface, struct net_pkt *pkt)
+{
+	ARG_UNUSED(filter);
+	ARG_UNUSED(iface);
+	ARG_UNUSED(pkt);
+
+	return false;
+}
+#endif
+
+/**
+ * @brief Set the filter used by a tunnel capture device.
+ *
+ * @details Packets not matching the filter are not cloned nor sent to
+ * the tunnel.
+ *
+ * @param dev Network capture device
+ * @param filter Capture filter, or NULL to capture all packets.
+ *
+ * @return 0 if ok, <0 if the filter could not be set
+ */
+#if defined(CONFIG_NET_CAPTURE)
+int net_capture_set_filter(const struct device *dev,
+			   const struct net_capture_filter *filter);
+#else
+static inline int net_capture_set_filter(const struct device *dev,
+					 const struct net_capture_filter *filter)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(filter);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @typedef net_capture_ring_dump_cb_t
+ * @brief Callback used to output the contents of the capture ring.
+ *
+ * @details The data is in libpcap file format, so concatenating all the
+ * chunks gives a file that can be opened by Wireshark or tcpdump.
+ *
+ * @param data Chunk of pcap data
+ * @param len Length of the chunk
+ * @param user_data A valid pointer to user data or NULL
+ *
+ * @return 0 to continue, <0 to stop the dump.
+ */
+typedef int (*net_capture_ring_dump_cb_t)(const uint8_t *data, size_t len,
+					  void *user_data);
+
+/** Statistics of the in-memory capture ring. */
+struct net_capture_ring_stats {
+	/** Packets stored in the ring */
+	uint32_t captured;
+	/** Packets rejected by the filter */
+	uint32_t filtered;
+	/** Packets that were truncated to the snapshot length */
+	uint32_t truncated;
+	/** Records overwritten before they were dumped */
+	uint32_t overwritten;
+};
+
+/**
+ * @brief Start capturing packets into the in-memory pcap ring.
+ *
+ * @details Unlike the tunnel capture, the ring does not allocate network
+ * packets. The first @a snaplen bytes of each matching packet are copied
+ * into a fixed size slot of the ring. Slots are claimed with an atomic
+ * counter so any number of TX and RX threads can record packets without
+ * taking a lock. When the ring is full the oldest records are overwritten.
+ * Any previous contents of the ring are discarded.
+ *
+ * @param iface Network interface to capture
+ * @param filter Capture filter, or NULL to capture all packets.
+ * @param snaplen Maximum number of bytes to store per packet. Zero or a
+ *        value larger than CONFIG_NET_CAPTURE_RING_SNAPLEN selects
+ *        CONFIG_NET_CAPTURE_RING_SNAPLEN.
+ *
+ * @return 0 if ok, <0 if the capture could not be started
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_enable(struct net_if *iface,
+			    const struct net_capture_filter *filter,
+			    size_t snaplen);
+#else
+static inline int net_capture_ring_enable(struct net_if *iface,
+					  const struct net_capture_filter *filter,
+					  size_t snaplen)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(filter);
+	ARG_UNUSED(snaplen);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Stop capturing packets into the in-memory pcap ring.
+ *
+ * @details The captured records are kept so they can still be dumped.
+ *
+ * @return 0 if ok, <0 if the ring capture was not enabled
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_disable(void);
+#else
+static inline int net_capture_ring_disable(void)
+{
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Is the in-memory pcap ring capture enabled.
+ *
+ * @return True if enabled, False otherwise.
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+bool net_capture_ring_is_enabled(void);
+#else
+static inline bool net_capture_ring_is_enabled(void)
+{
+	return false;
+}
+#endif
+
+/**
+ * @brief Dump the in-memory pcap ring.
+ *
+ * @details Outputs a pcap file header followed by all the records
+ * currently held in the ring, oldest first. Capturing can continue
+ * while the ring is being dumped; records that are overwritten during
+ * the dump are skipped and accounted in the statistics.
+ *
+ * @param cb Callback that receives the pcap data
+ * @param user_data User supplied data
+ *
+ * @return Number of records dumped, <0 on error
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_dump(net_capture_ring_dump_cb_t cb, void *user_data);
+#else
+static inline int net_capture_ring_dump(net_capture_ring_dump_cb_t cb,
+					void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Save the in-memory pcap ring to a file.
+ *
+ * @param path Path of the file. An existing file is overwritten.
+ *
+ * @return Number of records saved, <0 on error
+ */
+#if defined(CONFIG_NET_CAPTURE_RING_FS)
+int net_capture_ring_save(const char *path);
+#else
+static inline int net_capture_ring_save(const char *path)
+{
+	ARG_UNUSED(path);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Get the in-memory pcap ring statistics.
+ *
+ * @param stats Statistics are copied here.
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+void net_capture_ring_get_stats(struct net_capture_ring_stats *stats);
+#else
+static inline void net_capture_ring_get_stats(struct net_capture_ring_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+#endif
+
 /** @cond INTERNAL_HIDDEN */
 
 /**
@@ -211,12 +473,23 @@ static inline void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 }
 #endif
 
+#if defined(CONFIG_NET_CAPTURE_RING)
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt);
+#else
+static inline void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(pkt);
+}
+#endif
+
 struct net_capture_info {
 	const struct device *capture_dev;
 	struct net_if *capture_iface;
 	struct net_if *tunnel_iface;
 	struct sockaddr *peer;
 	struct sockaddr *local;
+	const struct net_capture_filter *filter;
 	bool is_enabled;
 };
 
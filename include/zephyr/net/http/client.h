@@ -93,6 +93,25 @@ typedef void (*http_response_cb_t)(struct http_response *rsp,
 				   enum http_final_call final_data,
 				   void *user_data);
 
+/**
+ * @typedef http_response_body_cb_t
+ * @brief Callback used to stream the response body.
+ *
+ * Called for every piece of the body as soon as it is parsed, with the
+ * chunked transfer encoding already removed. This allows processing a body
+ * of any size with a small receive buffer.
+ *
+ * @param rsp HTTP response information
+ * @param data Body data
+ * @param len Length of the body data
+ * @param user_data User specified data specified in http_client_req()
+ *
+ * @return 0 to continue receiving the response, non-zero to abort it.
+ */
+typedef int (*http_response_body_cb_t)(struct http_response *rsp,
+				       const uint8_t *data, size_t len,
+				       void *user_data);
+
 /**
  * HTTP response from the server.
  */
@@ -194,6 +213,11 @@ struct http_response {
 	uint8_t cl_present : 1;
 	uint8_t body_found : 1;
 	uint8_t message_complete : 1;
+
+	/** The connection can be used for another request once the
+	 * response is complete.
+	 */
+	uint8_t keep_alive : 1;
 };
 
 /** HTTP client internal data that the application should not touch
@@ -215,6 +239,11 @@ struct http_client_internal_data {
 
 	/** HTTP socket */
 	int sock;
+
+	/** Fail with -ECONNRESET instead of giving a null response when
+	 * the connection is closed before any response data is received.
+	 */
+	bool retry_on_close;
 };
 
 /**
@@ -241,6 +270,11 @@ struct http_request {
 	 */
 	const struct http_parser_settings *http_cb;
 
+	/** User supplied callback function to call with every piece of the
+	 * response body. This is optional.
+	 */
+	http_response_body_cb_t body_cb;
+
 	/** User supplied buffer where received data is stored */
 	uint8_t *recv_buf;
 
@@ -286,6 +320,12 @@ struct http_request {
 	 */
 	size_t payload_len;
 
+	/** Send the payload with the chunked transfer encoding. The
+	 * payload_cb must then send the payload with
+	 * http_client_send_chunk(), the last chunk is sent by the client.
+	 */
+	bool chunked;
+
 	/** User supplied callback function to call when optional headers need
 	 * to be sent. This can be NULL, in which case the optional_headers
 	 * field in http_request is used. The idea of this optional_headers
@@ -319,11 +359,119 @@ struct http_request {
  *        The timeout value is in milliseconds.
  * @param user_data User specified data that is passed to the callback.
  *
- * @return <0 if error, >=0 amount of data sent to the server
+ * @return <0 if error, -EBADMSG if the response could not be parsed or the
+ *         body callback aborted it, >=0 amount of data sent to the server
  */
 int http_client_req(int sock, struct http_request *req,
 		    int32_t timeout, void *user_data);
 
+/**
+ * @brief Send a chunk of a chunked request payload.
+ *
+ * To be called from the payload callback of a request that has the chunked
+ * field set.
+ *
+ * @param sock Socket id of the connection.
+ * @param data Chunk data
+ * @param len Length of the chunk, 0 sends the last chunk.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server
+ */
+int http_client_send_chunk(int sock, const void *data, size_t len);
+
+/**
+ * @brief Do several HTTP requests on the same connection without waiting
+ * for the responses in between (HTTP/1.1 pipelining).
+ *
+ * All the requests are sent first, then the responses are received in
+ * order and given to the callbacks of the respective requests. Each
+ * request must have its own receive buffer. Receiving stops at the first
+ * incomplete response or when the server closes the connection.
+ *
+ * @param sock Socket id of the connection.
+ * @param reqs HTTP requests
+ * @param count Number of requests
+ * @param timeout Max timeout to wait for each response, in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, >=0 number of requests that got a complete response
+ */
+int http_client_req_pipeline(int sock, struct http_request **reqs,
+			     size_t count, int32_t timeout, void *user_data);
+
+/** TLS security tag value meaning that the connection does not use TLS */
+#define HTTP_CLIENT_NO_TLS (-1)
+
+/**
+ * Server a pooled connection goes to. Connections are shared between
+ * requests having the same endpoint.
+ */
+struct http_client_endpoint {
+	/** Host name or address of the server, also used for the TLS SNI */
+	const char *host;
+
+	/** Port of the server */
+	uint16_t port;
+
+	/** TLS security tag, or HTTP_CLIENT_NO_TLS */
+	int sec_tag;
+};
+
+#if defined(CONFIG_HTTP_CLIENT_POOL) || defined(__DOXYGEN__)
+/**
+ * @brief Get a connection to the endpoint from the connection pool.
+ *
+ * An idle keep-alive connection to the endpoint is reused if there is one,
+ * otherwise a new connection is opened. If the pool is full, the least
+ * recently used idle connection is closed, or the call waits for a
+ * connection to be released.
+ *
+ * @param ep Endpoint to connect to
+ * @param timeout Max time to wait for a free connection, in milliseconds.
+ *
+ * @return <0 if error, socket id of the connection otherwise.
+ */
+int http_client_pool_get(const struct http_client_endpoint *ep,
+			 int32_t timeout);
+
+/**
+ * @brief Give a connection back to the connection pool.
+ *
+ * @param sock Socket id returned by http_client_pool_get()
+ * @param reuse Whether the connection can be reused for another request,
+ *        otherwise it is closed.
+ */
+void http_client_pool_put(int sock, bool reuse);
+
+/**
+ * @brief Close all the idle connections of the connection pool.
+ */
+void http_client_pool_flush(void);
+
+/**
+ * @brief Do a HTTP request on a pooled connection.
+ *
+ * Same as http_client_req() but the connection is taken from the pool and
+ * given back to it afterwards, so consecutive requests to the same server
+ * pay the TCP and TLS handshakes only once. If a reused connection fails
+ * or is closed before any response data is received, e.g. because the
+ * server closed it while it was idle, the request is retried once on a new
+ * connection. A request which timed out or failed after response data was
+ * received is not retried, as the server may have processed it.
+ *
+ * @param ep Endpoint to send the request to
+ * @param req HTTP request information
+ * @param timeout Max timeout to wait for a connection and for the data,
+ *        in milliseconds.
+ * @param user_data User specified data that is passed to the callback.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server
+ */
+int http_client_pool_req(const struct http_client_endpoint *ep,
+			 struct http_request *req, int32_t timeout,
+			 void *user_data);
+#endif /* CONFIG_HTTP_CLIENT_POOL */
+
 #ifdef __cplusplus
 }
 #endif
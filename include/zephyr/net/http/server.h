@@ -0,0 +1,298 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief HTTP server API
+ *
+ * An HTTP/1.1 server serving the resources of the services defined with
+ * HTTP_SERVICE_DEFINE(). All the connections are handled by a single
+ * thread waiting on the sockets with poll(), so a connection costs only
+ * its context and not a thread.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/http/parser.h>
+#include <zephyr/net/http/service.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <zephyr/fs/fs.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+/** How a resource is served */
+enum http_resource_type {
+	/** Constant data, sent without copy, typically from flash */
+	HTTP_RESOURCE_TYPE_STATIC,
+
+	/** Files of a directory of the file system */
+	HTTP_RESOURCE_TYPE_STATIC_FS,
+
+	/** Data generated by an application callback */
+	HTTP_RESOURCE_TYPE_DYNAMIC,
+
+	/** WebSocket endpoint */
+	HTTP_RESOURCE_TYPE_WEBSOCKET,
+};
+
+/**
+ * Common part of the resource details, the detail of a resource given to
+ * HTTP_RESOURCE_DEFINE() is one of the http_resource_detail_* structures.
+ */
+struct http_resource_detail {
+	/** Bitmask of the supported methods, BIT(HTTP_GET) etc. */
+	uint32_t bitmask_of_supported_http_methods;
+
+	/** Type of the resource */
+	enum http_resource_type type;
+
+	/** Content-Type of the resource, optional */
+	const char *content_type;
+
+	/** Content-Encoding of the resource, e.g. "gzip", optional */
+	const char *content_encoding;
+};
+
+/** Detail of a HTTP_RESOURCE_TYPE_STATIC resource */
+struct http_resource_detail_static {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Data of the resource */
+	const void *static_data;
+
+	/** Length of the data */
+	size_t static_data_len;
+};
+
+/**
+ * Detail of a HTTP_RESOURCE_TYPE_STATIC_FS resource. The resource name
+ * should end with a '*' so that the resource matches all the paths
+ * starting with it, the remaining part of the path being the name of the
+ * file in the directory.
+ */
+struct http_resource_detail_static_fs {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Directory where the files are */
+	const char *fs_path;
+};
+
+/** Status of the data given to a dynamic resource callback */
+enum http_data_status {
+	/** The request was aborted, e.g. the connection was closed */
+	HTTP_SERVER_DATA_ABORTED = -1,
+
+	/** Part of the request body */
+	HTTP_SERVER_DATA_MORE = 0,
+
+	/** The request is complete, the response is to be written */
+	HTTP_SERVER_DATA_FINAL = 1,
+};
+
+struct http_client_ctx;
+
+/**
+ * @typedef http_resource_dynamic_cb_t
+ * @brief Callback of a dynamic resource.
+ *
+ * Called with HTTP_SERVER_DATA_MORE for every piece of the request body,
+ * and with HTTP_SERVER_DATA_FINAL once the request is complete. In the
+ * latter case @p data is a buffer of @p len bytes where the callback writes
+ * the body of the response.
+ *
+ * @param client Client the request comes from
+ * @param status Status of the data
+ * @param data Request body, or response buffer
+ * @param len Length of the data or of the response buffer
+ * @param user_data User data of the resource
+ *
+ * @return Length of the response body for HTTP_SERVER_DATA_FINAL, 0 for
+ *         the other statuses, <0 if error in which case the server replies
+ *         with 500 Internal Server Error.
+ */
+typedef int (*http_resource_dynamic_cb_t)(struct http_client_ctx *client,
+					  enum http_data_status status,
+					  uint8_t *data, size_t len,
+					  void *user_data);
+
+/** Detail of a HTTP_RESOURCE_TYPE_DYNAMIC resource */
+struct http_resource_detail_dynamic {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Callback generating the response */
+	http_resource_dynamic_cb_t cb;
+
+	/** User data given to the callback */
+	void *user_data;
+};
+
+/**
+ * @typedef http_resource_websocket_cb_t
+ * @brief Callback of a WebSocket resource.
+ *
+ * Called once the upgrade of the connection is done. The callback owns the
+ * WebSocket from then on, it is to be used with the Websocket API and
+ * closed with websocket_disconnect().
+ *
+ * @param ws_sock WebSocket id
+ * @param user_data User data of the resource
+ *
+ * @return 0 if ok, <0 if the WebSocket is to be closed by the server.
+ */
+typedef int (*http_resource_websocket_cb_t)(int ws_sock, void *user_data);
+
+/**
+ * Detail of a HTTP_RESOURCE_TYPE_WEBSOCKET resource. The receive buffer
+ * belongs to the WebSocket until it is closed, so a resource serves one
+ * WebSocket at a time.
+ */
+struct http_resource_detail_websocket {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Callback taking over the WebSocket */
+	http_resource_websocket_cb_t cb;
+
+	/** Receive buffer of the WebSocket */
+	uint8_t *data_buffer;
+
+	/** Length of the receive buffer */
+	size_t data_buffer_len;
+
+	/** User data given to the callback */
+	void *user_data;
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+/* Headers the server needs to know about */
+enum http_server_header {
+	HTTP_SERVER_HEADER_OTHER,
+	HTTP_SERVER_HEADER_UPGRADE,
+	HTTP_SERVER_HEADER_WS_KEY,
+	HTTP_SERVER_HEADER_WS_VERSION,
+};
+
+#define HTTP_SERVER_WS_KEY_LEN 24
+#define HTTP_SERVER_HEADER_BUF_LEN 192
+
+/** @endcond */
+
+/**
+ * Connection of a client. Only the documented fields are meant to be read
+ * by the application, from the dynamic resource callbacks.
+ */
+struct http_client_ctx {
+	/** Socket of the connection */
+	int fd;
+
+	/** Service the client connected to */
+	const struct http_service_desc *service;
+
+	/** Method of the current request */
+	enum http_method method;
+
+	/** Path of the current request, without the query */
+	char url_buffer[CONFIG_HTTP_SERVER_MAX_URL_LENGTH];
+
+	/** @cond INTERNAL_HIDDEN */
+
+	struct http_parser parser;
+	struct http_parser_settings parser_settings;
+
+	/* Received data not parsed yet */
+	uint8_t buffer[CONFIG_HTTP_SERVER_CLIENT_BUFFER_SIZE];
+	size_t data_len;
+
+	/* Request state */
+	size_t url_len;
+	const struct http_resource_detail *resource;
+	size_t resource_prefix_len;
+	uint16_t status;
+	enum http_server_header header;
+	char header_name[sizeof("Sec-WebSocket-Version")];
+	size_t header_name_len;
+	char header_value[HTTP_SERVER_WS_KEY_LEN + 1];
+	size_t header_value_len;
+	char ws_key[HTTP_SERVER_WS_KEY_LEN + 1];
+	uint8_t header_in_value : 1;
+	uint8_t url_too_long : 1;
+	uint8_t upgrade_websocket : 1;
+	uint8_t ws_version_ok : 1;
+	uint8_t headers_complete : 1;
+	uint8_t message_complete : 1;
+	uint8_t dynamic_failed : 1;
+
+	/* Response state */
+	char tx_hdr[HTTP_SERVER_HEADER_BUF_LEN];
+	size_t tx_hdr_len;
+	size_t tx_hdr_sent;
+	const uint8_t *tx_body;
+	size_t tx_body_len;
+	uint8_t tx_buf[CONFIG_HTTP_SERVER_CLIENT_BUFFER_SIZE];
+	uint8_t tx_pending : 1;
+	uint8_t close_after_tx : 1;
+	uint8_t ws_after_tx : 1;
+#if defined(CONFIG_FILE_SYSTEM)
+	uint8_t file_open : 1;
+	struct fs_file_t file;
+	size_t file_remaining;
+#endif
+
+	/* Uptime of the last activity on the connection */
+	int64_t last_activity;
+
+	/** @endcond */
+};
+
+/**
+ * @brief Start the HTTP server.
+ *
+ * Creates the listening socket of every service defined with
+ * HTTP_SERVICE_DEFINE() and starts the server thread. The port of a service
+ * defined with port 0 is written back once the socket is bound.
+ *
+ * @return 0 if ok, <0 if error.
+ * @retval -EALREADY The server is already running.
+ */
+int http_server_start(void);
+
+/**
+ * @brief Stop the HTTP server.
+ *
+ * Closes the listening sockets and all the HTTP connections. The
+ * WebSockets given to the application are not affected.
+ *
+ * @return 0 if ok, -EALREADY if the server is not running.
+ */
+int http_server_stop(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
@@ -0,0 +1,175 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief RTIO I/O devices for BSD sockets
+ *
+ * A socket RTIO iodev lets an application submit socket operations to an
+ * RTIO context and reap their completions from the completion queue
+ * instead of blocking in recv()/send() or running a poll() loop.
+ *
+ * The following operations are supported:
+ *
+ * - RTIO_OP_RX: receive into the buffer (see rtio_sqe_prep_read()). The
+ *   buffer may also be taken from the RTIO memory pool, and a multishot
+ *   receive (rtio_sqe_prep_read_multishot()) produces one completion per
+ *   received chunk until it is canceled, the peer closes the connection
+ *   or an error occurs.
+ * - RTIO_OP_TX and RTIO_OP_TINY_TX: send the whole buffer, the result is
+ *   the number of bytes sent (see rtio_sqe_prep_write()).
+ * - RTIO_OP_ACCEPT: accept a connection on a listening socket, the result
+ *   is the new socket (see zsock_rtio_prep_accept()).
+ * - RTIO_OP_CONNECT: connect the socket (see zsock_rtio_prep_connect()).
+ *
+ * Receive and accept operations are executed in submission order, as are
+ * send and connect operations, the two directions being independent.
+ * Socket operations can be chained with operations on any other iodev in
+ * the same RTIO context.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_RTIO_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_RTIO_H_
+
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/net/socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Socket RTIO API
+ * @defgroup socket_rtio Socket RTIO API
+ * @ingroup networking
+ * @{
+ */
+
+/** @cond INTERNAL_HIDDEN */
+
+struct zsock_rtio_data {
+	/* Bound socket, -1 if the iodev is not bound */
+	int sock;
+
+	/* Whether the socket is a stream socket */
+	bool stream;
+
+	/* Pending RX and ACCEPT operations */
+	struct rtio_mpsc rx_q;
+
+	/* Pending TX, TINY_TX and CONNECT operations */
+	struct rtio_mpsc tx_q;
+
+	/* Operations currently being executed */
+	struct rtio_iodev_sqe *rx_cur;
+	struct rtio_iodev_sqe *tx_cur;
+
+	/* Number of bytes of tx_cur already sent */
+	uint32_t tx_off;
+};
+
+extern const struct rtio_iodev_api zsock_rtio_iodev_api;
+
+/** @endcond */
+
+/**
+ * @brief Statically define a socket RTIO iodev
+ *
+ * The iodev must be bound to a socket with zsock_rtio_iodev_bind() before
+ * operations are submitted to it.
+ *
+ * @param name Name of the iodev
+ */
+#define ZSOCK_RTIO_IODEV_DEFINE(name)					\
+	static struct zsock_rtio_data _zsock_rtio_data_##name = {	\
+		.sock = -1,						\
+		.rx_q = RTIO_MPSC_INIT((_zsock_rtio_data_##name.rx_q)),	\
+		.tx_q = RTIO_MPSC_INIT((_zsock_rtio_data_##name.tx_q)),	\
+	};								\
+	RTIO_IODEV_DEFINE(name, &zsock_rtio_iodev_api, &_zsock_rtio_data_##name)
+
+/**
+ * @brief Bind a socket RTIO iodev to a socket
+ *
+ * The socket is switched to non-blocking mode. Only native (non offloaded)
+ * sockets are supported.
+ *
+ * @param iodev Socket iodev defined with ZSOCK_RTIO_IODEV_DEFINE()
+ * @param sock Socket to bind the iodev to
+ *
+ * @return 0 if ok, <0 if error.
+ * @retval -EALREADY The iodev is already bound.
+ * @retval -ENOMEM Too many bound iodevs, see
+ *         CONFIG_NET_SOCKETS_RTIO_MAX_SOCKETS.
+ */
+int zsock_rtio_iodev_bind(struct rtio_iodev *iodev, int sock);
+
+/**
+ * @brief Unbind a socket RTIO iodev from its socket
+ *
+ * The pending operations complete with -ECANCELED. This must be called
+ * before the socket is closed, and no operation may be submitted to the
+ * iodev concurrently.
+ *
+ * @param iodev Socket iodev defined with ZSOCK_RTIO_IODEV_DEFINE()
+ *
+ * @return 0 if ok, -EALREADY if the iodev is not bound.
+ */
+int zsock_rtio_iodev_unbind(struct rtio_iodev *iodev);
+
+/**
+ * @brief Prepare an accept op submission
+ *
+ * @param sqe Submission to prepare
+ * @param iodev Socket iodev bound to a listening socket
+ * @param addr Where to store the peer address, may be NULL
+ * @param addrlen Size of @p addr
+ * @param userdata User data returned with the completion
+ */
+static inline void zsock_rtio_prep_accept(struct rtio_sqe *sqe,
+					  const struct rtio_iodev *iodev,
+					  struct sockaddr *addr,
+					  socklen_t addrlen,
+					  void *userdata)
+{
+	memset(sqe, 0, sizeof(struct rtio_sqe));
+	sqe->op = RTIO_OP_ACCEPT;
+	sqe->iodev = iodev;
+	sqe->buf = (uint8_t *)addr;
+	sqe->buf_len = addr != NULL ? addrlen : 0;
+	sqe->userdata = userdata;
+}
+
+/**
+ * @brief Prepare a connect op submission
+ *
+ * @param sqe Submission to prepare
+ * @param iodev Socket iodev
+ * @param addr Peer address, must stay valid until the completion
+ * @param addrlen Size of @p addr
+ * @param userdata User data returned with the completion
+ */
+static inline void zsock_rtio_prep_connect(struct rtio_sqe *sqe,
+					   const struct rtio_iodev *iodev,
+					   const struct sockaddr *addr,
+					   socklen_t addrlen,
+					   void *userdata)
+{
+	memset(sqe, 0, sizeof(struct rtio_sqe));
+	sqe->op = RTIO_OP_CONNECT;
+	sqe->iodev = iodev;
+	sqe->buf = (uint8_t *)addr;
+	sqe->buf_len = addrlen;
+	sqe->userdata = userdata;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_RTIO_H_ */
@@ -126,6 +126,26 @@ struct websocket_request {
 int websocket_connect(int http_sock, struct websocket_request *req,
 		      int32_t timeout, void *user_data);
 
+/**
+ * @brief Register a socket as a server side Websocket.
+ *
+ * @details Used by a server once it has replied to the HTTP upgrade request
+ * of a client. The frames sent through the returned Websocket are not
+ * masked, as required from a server by RFC 6455. Closing the Websocket also
+ * closes the underlying socket.
+ *
+ * @param http_sock Socket id of the client connection. Like with
+ *        websocket_connect(), this socket must not be used directly after
+ *        this function returns.
+ * @param recv_buf Buffer used when receiving from the socket, it must stay
+ *        valid until the Websocket is closed.
+ * @param recv_buf_len Length of the receive buffer.
+ *
+ * @return <0 if error, Websocket id to be used when sending/receiving
+ *         Websocket data otherwise.
+ */
+int websocket_register(int http_sock, uint8_t *recv_buf, size_t recv_buf_len);
+
 /**
  * @brief Send websocket msg to peer.
  *
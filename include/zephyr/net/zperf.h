@@ -17,6 +17,7 @@
 #ifndef ZEPHYR_INCLUDE_NET_ZPERF_H_
 #define ZEPHYR_INCLUDE_NET_ZPERF_H_
 
+#include <stdbool.h>
 #include <zephyr/net/net_ip.h>
 
 #ifdef __cplusplus
@@ -25,6 +26,7 @@ extern "C" {
 
 enum zperf_status {
 	ZPERF_SESSION_STARTED,
+	ZPERF_SESSION_PERIODIC_RESULT,
 	ZPERF_SESSION_FINISHED,
 	ZPERF_SESSION_ERROR
 } __packed;
@@ -34,6 +36,18 @@ struct zperf_upload_params {
 	uint32_t duration_ms;
 	uint32_t rate_kbps;
 	uint16_t packet_size;
+	/** Number of parallel streams (connections), 0 or 1 for a single
+	 *  stream. At most CONFIG_NET_ZPERF_MAX_STREAMS.
+	 */
+	uint16_t num_streams;
+	/** Interval of ZPERF_SESSION_PERIODIC_RESULT callbacks in
+	 *  asynchronous mode, 0 to disable periodic reports.
+	 */
+	uint32_t report_interval_ms;
+	/** TCP only: ask the zperf server to send data back on each
+	 *  connection during the upload, to load both directions at once.
+	 */
+	bool bidirectional;
 	struct {
 		uint8_t tos;
 		int tcp_nodelay;
@@ -55,6 +69,42 @@ struct zperf_results {
 	uint32_t client_time_in_us;
 	uint32_t packet_size;
 	uint32_t nb_packets_errors;
+	/** Bytes received from the server in a bidirectional TCP upload */
+	uint32_t reverse_total_len;
+};
+
+/** Number of buckets in the round trip time histogram */
+#define ZPERF_LATENCY_HIST_BUCKETS 20
+
+struct zperf_latency_params {
+	struct sockaddr peer_addr;
+	/** Number of requests to send */
+	uint32_t count;
+	/** Delay between the requests */
+	uint32_t interval_ms;
+	/** How long to wait for each response */
+	uint32_t timeout_ms;
+	uint16_t packet_size;
+	struct {
+		uint8_t tos;
+	} options;
+};
+
+struct zperf_latency_results {
+	uint32_t nb_requests;
+	uint32_t nb_replies;
+	uint32_t nb_timeouts;
+	uint32_t nb_outorder;
+	uint32_t rtt_min_us;
+	uint32_t rtt_max_us;
+	uint32_t rtt_avg_us;
+	/** Mean deviation of consecutive round trip times (RFC 3550) */
+	uint32_t jitter_in_us;
+	/** Round trip time histogram. Bucket 0 counts replies faster than
+	 *  2 us, bucket n counts replies between 2^n and 2^(n+1) - 1 us and
+	 *  the last bucket counts all slower replies.
+	 */
+	uint32_t hist[ZPERF_LATENCY_HIST_BUCKETS];
 };
 
 /**
@@ -92,10 +142,27 @@ int zperf_udp_upload(const struct zperf_upload_params *param,
 int zperf_tcp_upload(const struct zperf_upload_params *param,
 		     struct zperf_results *result);
 
+/**
+ * @brief Synchronous UDP request/response latency measurement. Each request
+ *        is echoed back by the zperf UDP server on the peer, and the round
+ *        trip times are collected into a histogram. The function blocks
+ *        until all the requests have been sent and answered or timed out.
+ *
+ * @param param Latency test parameters.
+ * @param result Latency results.
+ *
+ * @return 0 if session completed successfully, a negative error code otherwise.
+ */
+int zperf_udp_latency(const struct zperf_latency_params *param,
+		      struct zperf_latency_results *result);
+
 /**
  * @brief Asynchronous UDP upload operation.
  *
  * @note Only one asynchronous upload can be performed at a time.
+ *       If report_interval_ms is set in the parameters, the callback is
+ *       also called with ZPERF_SESSION_PERIODIC_RESULT and the client side
+ *       results of the last interval.
  *
  * @param param Upload parameters.
  * @param callback Session results callback.
@@ -111,6 +178,9 @@ int zperf_udp_upload_async(const struct zperf_upload_params *param,
  * @brief Asynchronous TCP upload operation.
  *
  * @note Only one asynchronous upload can be performed at a time.
+ *       If report_interval_ms is set in the parameters, the callback is
+ *       also called with ZPERF_SESSION_PERIODIC_RESULT and the client side
+ *       results of the last interval.
  *
  * @param param Upload parameters.
  * @param callback Session results callback.
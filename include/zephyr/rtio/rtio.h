@@ -259,7 +259,7 @@ struct rtio_sqe {
 
 	union {
 
-		/** OP_TX, OP_RX */
+		/** OP_TX, OP_RX, OP_ACCEPT, OP_CONNECT */
 		struct {
 			uint32_t buf_len; /**< Length of buffer */
 			uint8_t *buf; /**< Buffer to use*/
@@ -465,6 +465,12 @@ struct rtio_iodev {
 /** An operation that transceives (reads and writes simultaneously) */
 #define RTIO_OP_TXRX (RTIO_OP_CALLBACK+1)
 
+/** An operation that accepts a connection, the result is the new connection handle */
+#define RTIO_OP_ACCEPT (RTIO_OP_TXRX+1)
+
+/** An operation that connects to a peer address given as the buffer */
+#define RTIO_OP_CONNECT (RTIO_OP_ACCEPT+1)
+
 
 /**
  * @brief Prepare a nop (no op) submission
@@ -344,6 +344,59 @@ int settings_commit(void);
  */
 int settings_commit_subtree(const char *subtree);
 
+/**
+ * Start a settings transaction.
+ *
+ * Until the transaction is committed or aborted, the values saved by the
+ * calling thread with @ref settings_save_one, @ref settings_delete or
+ * @ref settings_save are kept in RAM, a later save of a key replacing the
+ * previous one. Loads do not see these values. Saves from other threads wait
+ * for the end of the transaction.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if there is no destination backend.
+ * @retval -EALREADY if the calling thread has a transaction in progress.
+ */
+int settings_transaction_begin(void);
+
+/**
+ * Commit the transaction of the calling thread.
+ *
+ * The values saved during the transaction are written to the destination
+ * backend. Backends implementing @ref settings_store_itf.csi_save_batch
+ * write them atomically: after a reset, either all or none of them are
+ * loaded. Other backends write them one at a time.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the calling thread has no transaction in progress.
+ * @retval -ENOSPC if the values do not fit in the backend.
+ * @return Other negative error code returned by the backend. The values of
+ * the transaction are discarded.
+ */
+int settings_transaction_commit(void);
+
+/**
+ * Abort the transaction of the calling thread, discarding the values saved.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the calling thread has no transaction in progress.
+ */
+int settings_transaction_abort(void);
+
+/**
+ * Write the values held by the write-back cache to the backend.
+ *
+ * With CONFIG_SETTINGS_WRITE_BACK, the values saved outside of transactions
+ * are written after CONFIG_SETTINGS_WRITE_BACK_DELAY milliseconds, or before
+ * a load. Values saved during a transaction are not written. When writing
+ * fails, the values stay in the cache and are written again by the next
+ * write-back.
+ *
+ * @return 0 on success, negative error code returned by the backend
+ * otherwise.
+ */
+int settings_flush(void);
+
 /**
  * @} settings
  */
@@ -397,6 +450,18 @@ struct settings_load_arg {
 	void *param;
 };
 
+/**
+ * Key-value pair of a batch, see @ref settings_store_itf.csi_save_batch.
+ */
+struct settings_batch_entry {
+	/** Key in string format */
+	const char *name;
+	/** Binary value, NULL to delete the key */
+	const void *value;
+	/** Length of the value in bytes */
+	size_t val_len;
+};
+
 /**
  * Backend handler functions.
  * Sources are registered using a call to @ref settings_src_register.
@@ -449,6 +514,18 @@ struct settings_store_itf {
 	 *  - cs - Corresponding backend handler node
 	 */
 	void *(*csi_storage_get)(struct settings_store *cs);
+
+	int (*csi_save_batch)(struct settings_store *cs,
+			      const struct settings_batch_entry *entries,
+			      size_t cnt);
+	/**< Save key-value pairs atomically, used to commit transactions.
+	 * Optional, the pairs are saved with csi_save otherwise.
+	 *
+	 * Parameters:
+	 *  - cs - Corresponding backend handler node
+	 *  - entries - Key-value pairs, each key appears once
+	 *  - cnt - Number of key-value pairs
+	 */
 };
 
 /**
@@ -692,6 +692,10 @@ struct shell_transport {
  */
 struct shell_stats {
 	atomic_t log_lost_cnt; /*!< Lost log counter.*/
+	atomic_t log_cnt; /*!< Printed log counter.*/
+	atomic_t tx_cnt; /*!< Bytes accepted by the transport.*/
+	atomic_t tx_stall_cnt; /*!< Waits for the transport to send data.*/
+	int64_t reset_time; /*!< Uptime of the last reset in milliseconds.*/
 };
 
 #ifdef CONFIG_SHELL_STATS
@@ -702,6 +706,20 @@ struct shell_stats {
 #define Z_SHELL_STATS_PTR(_name) NULL
 #endif /* CONFIG_SHELL_STATS */
 
+#ifdef CONFIG_SHELL_TX_BUFFER
+#define Z_SHELL_TX_BUFFER_DEFINE(_name)					\
+	static uint8_t __aligned(sizeof(void *))			\
+			_name##_tx_buf_data[CONFIG_SHELL_TX_BUFFER_SIZE]; \
+	static struct ring_buf _name##_tx_buf = {			\
+		.size = CONFIG_SHELL_TX_BUFFER_SIZE,			\
+		.buffer = _name##_tx_buf_data				\
+	}
+#define Z_SHELL_TX_BUFFER_PTR(_name) (&(_name##_tx_buf))
+#else
+#define Z_SHELL_TX_BUFFER_DEFINE(_name)
+#define Z_SHELL_TX_BUFFER_PTR(_name) NULL
+#endif /* CONFIG_SHELL_TX_BUFFER */
+
 /**
  * @internal @brief Flags for shell backend configuration.
  */
@@ -738,6 +756,8 @@ struct shell_backend_ctx_flags {
 	uint32_t cmd_ctx      :1; /*!< Shell is executing command */
 	uint32_t print_noinit :1; /*!< Print request from not initialized shell */
 	uint32_t sync_mode    :1; /*!< Shell in synchronous mode */
+	uint32_t tx_log       :1; /*!< Log message written to the TX buffer */
+	uint32_t tx_log_drop  :1; /*!< Log message does not fit in TX buffer */
 };
 
 BUILD_ASSERT((sizeof(struct shell_backend_ctx_flags) == sizeof(uint32_t)),
@@ -818,10 +838,15 @@ struct shell_ctx {
 	struct k_poll_signal signals[SHELL_SIGNALS];
 
 	/*!< Events that should be used only internally by shell thread.
-	 * Event for SHELL_SIGNAL_TXDONE is initialized but unused.
+	 * Event for SHELL_SIGNAL_TXDONE is used only with the TX buffer.
 	 */
 	struct k_poll_event events[SHELL_SIGNALS];
 
+#if defined CONFIG_SHELL_TX_BUFFER
+	/*!< Bytes of the log message being written claimed in the TX buffer.*/
+	uint32_t tx_log_len;
+#endif
+
 	struct k_mutex wr_mtx;
 	k_tid_t tid;
 	int ret_val;
@@ -854,6 +879,8 @@ struct shell {
 
 	struct shell_stats *stats;
 
+	struct ring_buf *tx_buf; /*!< TX buffer, NULL if not used.*/
+
 	const struct shell_log_backend *log_backend;
 
 	LOG_INSTANCE_PTR_DECLARE(log);
@@ -892,6 +919,7 @@ extern void z_shell_print_stream(const void *user_ctx, const char *data,
 			     true, z_shell_print_stream);		      \
 	LOG_INSTANCE_REGISTER(shell, _name, CONFIG_SHELL_LOG_LEVEL);	      \
 	Z_SHELL_STATS_DEFINE(_name);					      \
+	Z_SHELL_TX_BUFFER_DEFINE(_name);				      \
 	static K_KERNEL_STACK_DEFINE(_name##_stack, CONFIG_SHELL_STACK_SIZE); \
 	static struct k_thread _name##_thread;				      \
 	static const STRUCT_SECTION_ITERABLE(shell, _name) = {		      \
@@ -903,6 +931,7 @@ extern void z_shell_print_stream(const void *user_ctx, const char *data,
 		.shell_flag = _shell_flag,				      \
 		.fprintf_ctx = &_name##_fprintf,			      \
 		.stats = Z_SHELL_STATS_PTR(_name),			      \
+		.tx_buf = Z_SHELL_TX_BUFFER_PTR(_name),			      \
 		.log_backend = Z_SHELL_LOG_BACKEND_PTR(_name),		      \
 		LOG_INSTANCE_PTR_INIT(log, shell, _name)		      \
 		.thread_name = STRINGIFY(_name),			      \
@@ -0,0 +1,377 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Metrics registry.
+ *
+ * Metrics are counters, gauges and histograms defined at build time and
+ * gathered in an iterable section, so they can be enumerated and exported
+ * without any registration. Counters and histograms keep one shard per CPU,
+ * updated with atomic operations only: they can be updated from any context,
+ * including interrupts, without locks. The shards are summed when a metric is
+ * read.
+ */
+
+#ifndef ZEPHYR_INCLUDE_STATS_METRICS_H_
+#define ZEPHYR_INCLUDE_STATS_METRICS_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup metrics Metrics registry
+ * @ingroup os_services
+ * @{
+ */
+
+/** Metric types */
+enum metric_type {
+	/** Monotonic 64-bit count */
+	METRIC_COUNTER,
+	/** Signed value which can go up and down */
+	METRIC_GAUGE,
+	/** Distribution of unsigned 32-bit observations */
+	METRIC_HISTOGRAM,
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+/* Words of a 64-bit sum: low word, then carries */
+#define Z_METRIC_SUM_WORDS 2
+
+#ifdef CONFIG_SMP
+/* Each CPU shard starts a new cache line to avoid false sharing */
+#define Z_METRIC_SHARD_ALIGN 64
+#else
+#define Z_METRIC_SHARD_ALIGN sizeof(atomic_t)
+#endif
+
+#define Z_METRIC_STRIDE(_words) \
+	ROUND_UP(_words, Z_METRIC_SHARD_ALIGN / sizeof(atomic_t))
+
+/** @endcond */
+
+/** Metric descriptor, see the METRIC_*_DEFINE() macros */
+struct metric {
+	/** Metric name */
+	const char *name;
+	/** Description */
+	const char *help;
+	/** Labels, as `name="value"` pairs separated by commas, or NULL */
+	const char *labels;
+	/** Upper bounds of the histogram buckets, in increasing order */
+	const uint32_t *bounds;
+	/** Number of histogram bucket bounds */
+	uint16_t bounds_cnt;
+	/** Atomic words per CPU shard */
+	uint16_t stride;
+	/** Metric type */
+	enum metric_type type;
+	/** Shards */
+	atomic_t *shards;
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+#define Z_METRIC_DEFINE(_var, _name, _labels, _help, _type, _bounds,	\
+			_bounds_cnt, _words, _shards)			\
+	static atomic_t _CONCAT(z_metric_shards_, _var)			\
+		[(_shards) * Z_METRIC_STRIDE(_words)]			\
+		__aligned(Z_METRIC_SHARD_ALIGN);			\
+	const STRUCT_SECTION_ITERABLE(metric, _var) = {			\
+		.name = STRINGIFY(_name),				\
+		.help = _help,						\
+		.labels = _labels,					\
+		.bounds = _bounds,					\
+		.bounds_cnt = _bounds_cnt,				\
+		.stride = Z_METRIC_STRIDE(_words),			\
+		.type = _type,						\
+		.shards = _CONCAT(z_metric_shards_, _var),		\
+	}
+
+#define Z_METRIC_HISTOGRAM_DEFINE(_var, _name, _labels, _help, ...)	\
+	static const uint32_t _CONCAT(z_metric_bounds_, _var)[] = {	\
+		__VA_ARGS__						\
+	};								\
+	Z_METRIC_DEFINE(_var, _name, _labels, _help, METRIC_HISTOGRAM,	\
+			_CONCAT(z_metric_bounds_, _var),		\
+			ARRAY_SIZE(_CONCAT(z_metric_bounds_, _var)),	\
+			ARRAY_SIZE(_CONCAT(z_metric_bounds_, _var)) + 1 + \
+			Z_METRIC_SUM_WORDS,				\
+			CONFIG_MP_MAX_NUM_CPUS)
+
+static inline atomic_t *z_metric_shard(const struct metric *m)
+{
+	return &m->shards[arch_curr_cpu()->id * m->stride];
+}
+
+/* Add to a 64-bit sum kept in two words when atomic_t is 32-bit. A reader
+ * may see the low word wrapped before the carry is added.
+ */
+static inline void z_metric_add64(atomic_t *words, uint32_t n)
+{
+	uint32_t old = (uint32_t)atomic_add(&words[0], (atomic_val_t)n);
+
+	if ((sizeof(atomic_val_t) < sizeof(uint64_t)) && ((uint32_t)(old + n) < old)) {
+		(void)atomic_inc(&words[1]);
+	}
+}
+
+static inline uint64_t z_metric_get64(const atomic_t *words)
+{
+	if (sizeof(atomic_val_t) >= sizeof(uint64_t)) {
+		return (uint64_t)atomic_get(&words[0]);
+	}
+
+	return ((uint64_t)(uint32_t)atomic_get(&words[1]) << 32) |
+	       (uint32_t)atomic_get(&words[0]);
+}
+
+/** @endcond */
+
+/**
+ * @brief Define a counter.
+ *
+ * @param _name Metric name, also the name of the descriptor variable.
+ * @param _help Description.
+ */
+#define METRIC_COUNTER_DEFINE(_name, _help)				\
+	METRIC_COUNTER_DEFINE_LABELED(_name, _name, NULL, _help)
+
+/**
+ * @brief Define a counter with labels.
+ *
+ * Metrics with the same name and different labels are exported together
+ * when their descriptor variables sort next to each other.
+ *
+ * @param _var Descriptor variable name.
+ * @param _name Metric name.
+ * @param _labels Labels string, e.g. "state=\"idle\"".
+ * @param _help Description.
+ */
+#define METRIC_COUNTER_DEFINE_LABELED(_var, _name, _labels, _help)	\
+	Z_METRIC_DEFINE(_var, _name, _labels, _help, METRIC_COUNTER,	\
+			NULL, 0, Z_METRIC_SUM_WORDS, CONFIG_MP_MAX_NUM_CPUS)
+
+/**
+ * @brief Define a gauge.
+ *
+ * Gauges are not sharded, a value set must be seen by all CPUs.
+ *
+ * @param _name Metric name, also the name of the descriptor variable.
+ * @param _help Description.
+ */
+#define METRIC_GAUGE_DEFINE(_name, _help)				\
+	METRIC_GAUGE_DEFINE_LABELED(_name, _name, NULL, _help)
+
+/**
+ * @brief Define a gauge with labels.
+ *
+ * @param _var Descriptor variable name.
+ * @param _name Metric name.
+ * @param _labels Labels string.
+ * @param _help Description.
+ */
+#define METRIC_GAUGE_DEFINE_LABELED(_var, _name, _labels, _help)	\
+	Z_METRIC_DEFINE(_var, _name, _labels, _help, METRIC_GAUGE,	\
+			NULL, 0, 1, 1)
+
+/**
+ * @brief Define a histogram.
+ *
+ * An observation is counted in the first bucket whose upper bound is
+ * greater than or equal to it, or in the implicit +Inf bucket.
+ *
+ * @param _name Metric name, also the name of the descriptor variable.
+ * @param _help Description.
+ * @param ... Upper bounds of the buckets, in increasing order.
+ */
+#define METRIC_HISTOGRAM_DEFINE(_name, _help, ...)			\
+	Z_METRIC_HISTOGRAM_DEFINE(_name, _name, NULL, _help, __VA_ARGS__)
+
+/**
+ * @brief Define a histogram with labels.
+ *
+ * @param _var Descriptor variable name.
+ * @param _name Metric name.
+ * @param _labels Labels string.
+ * @param _help Description.
+ * @param ... Upper bounds of the buckets, in increasing order.
+ */
+#define METRIC_HISTOGRAM_DEFINE_LABELED(_var, _name, _labels, _help, ...) \
+	Z_METRIC_HISTOGRAM_DEFINE(_var, _name, _labels, _help, __VA_ARGS__)
+
+/**
+ * @brief Declare a metric defined in another file.
+ *
+ * @param _var Descriptor variable name.
+ */
+#define METRIC_DECLARE(_var) extern const struct metric _var
+
+/**
+ * @brief Add to a counter.
+ *
+ * @param m Counter.
+ * @param n Amount added.
+ */
+static inline void metric_counter_add(const struct metric *m, uint32_t n)
+{
+	z_metric_add64(z_metric_shard(m), n);
+}
+
+/**
+ * @brief Increment a counter.
+ *
+ * @param m Counter.
+ */
+static inline void metric_counter_inc(const struct metric *m)
+{
+	metric_counter_add(m, 1U);
+}
+
+/**
+ * @brief Set a gauge.
+ *
+ * @param m Gauge.
+ * @param value Value.
+ */
+static inline void metric_gauge_set(const struct metric *m, int32_t value)
+{
+	(void)atomic_set(&m->shards[0], value);
+}
+
+/**
+ * @brief Add to a gauge.
+ *
+ * @param m Gauge.
+ * @param delta Amount added, negative to decrease the gauge.
+ */
+static inline void metric_gauge_add(const struct metric *m, int32_t delta)
+{
+	(void)atomic_add(&m->shards[0], delta);
+}
+
+/**
+ * @brief Count an observation in a histogram.
+ *
+ * @param m Histogram.
+ * @param value Observed value.
+ */
+static inline void metric_histogram_observe(const struct metric *m, uint32_t value)
+{
+	atomic_t *shard = z_metric_shard(m);
+	uint16_t i;
+
+	for (i = 0; i < m->bounds_cnt; i++) {
+		if (value <= m->bounds[i]) {
+			break;
+		}
+	}
+
+	(void)atomic_inc(&shard[i]);
+	z_metric_add64(&shard[m->bounds_cnt + 1], value);
+}
+
+/**
+ * @brief Get the value of a counter.
+ *
+ * @param m Counter.
+ *
+ * @return Sum of the counts of all CPUs.
+ */
+uint64_t metric_counter_get(const struct metric *m);
+
+/**
+ * @brief Get the value of a gauge.
+ *
+ * @param m Gauge.
+ *
+ * @return Gauge value.
+ */
+int32_t metric_gauge_get(const struct metric *m);
+
+/**
+ * @brief Get the buckets of a histogram.
+ *
+ * @param m Histogram.
+ * @param buckets Array of m->bounds_cnt + 1 counts, the last one for the +Inf
+ *                bucket. The counts are not cumulative. May be NULL.
+ * @param count Total count of observations.
+ * @param sum Sum of the observed values.
+ */
+void metric_histogram_get(const struct metric *m, uint64_t *buckets,
+			  uint64_t *count, uint64_t *sum);
+
+/**
+ * @brief Zero a metric.
+ *
+ * Updates done concurrently may be lost.
+ *
+ * @param m Metric.
+ */
+void metric_reset(const struct metric *m);
+
+/**
+ * @brief Find a metric.
+ *
+ * @param name Metric name.
+ * @param labels Labels, or NULL to match a metric without labels.
+ *
+ * @return Metric, or NULL if not found.
+ */
+const struct metric *metric_find(const char *name, const char *labels);
+
+/**
+ * @brief Export output callback.
+ *
+ * @param data Exported data.
+ * @param len Length of @p data.
+ * @param ctx Context passed to the export function.
+ *
+ * @return 0 on success, negative error code to stop the export.
+ */
+typedef int (*metrics_output_t)(const char *data, size_t len, void *ctx);
+
+/**
+ * @brief Export all the metrics in Prometheus text format.
+ *
+ * The output is produced a line at a time.
+ *
+ * @param out Output callback.
+ * @param ctx Context passed to @p out.
+ *
+ * @return 0 on success, or the error returned by @p out.
+ */
+int metrics_export_prometheus(metrics_output_t out, void *ctx);
+
+/**
+ * @brief Export all the metrics in CBOR.
+ *
+ * The metrics are encoded as an array of maps with the keys "name", "type"
+ * (enum metric_type), "labels" (if any), and "value" for counters and gauges,
+ * or "bounds", "buckets" and "sum" for histograms.
+ *
+ * @param buf Output buffer.
+ * @param size Size of @p buf.
+ * @param len Length of the encoded data.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if @p buf is too small.
+ */
+int metrics_export_cbor(uint8_t *buf, size_t size, size_t *len);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_STATS_METRICS_H_ */
@@ -101,6 +101,100 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
  */
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buff);
 
+/**
+ * @brief Get a disk handle
+ *
+ * Resolve a disk name once, to submit requests with the returned handle.
+ *
+ * @param[in] pdrv          Disk name
+ *
+ * @return Disk handle, or NULL if no such disk is registered
+ */
+struct disk_info *disk_access_get(const char *pdrv);
+
+#if defined(CONFIG_DISK_ACCESS_ASYNC) || defined(__DOXYGEN__)
+
+/** Request reading sectors from the disk */
+#define DISK_ACCESS_OP_READ	0
+/** Request writing sectors to the disk */
+#define DISK_ACCESS_OP_WRITE	1
+
+/**
+ * @brief Buffer of a disk access request
+ */
+struct disk_access_buf {
+	/** Sector data */
+	uint8_t *data;
+	/** Number of sectors in the buffer */
+	uint32_t num_sector;
+};
+
+/**
+ * @brief Disk access request
+ *
+ * Transfers sectors starting at @a start_sector, to or from a list of
+ * buffers. The sectors of each buffer follow the ones of the previous
+ * buffer. The request must stay valid and unchanged until it completed.
+ */
+struct disk_access_req {
+	/** DISK_ACCESS_OP_READ or DISK_ACCESS_OP_WRITE */
+	uint8_t op;
+	/** Start disk sector */
+	uint32_t start_sector;
+	/** Buffers to transfer */
+	const struct disk_access_buf *bufs;
+	/** Number of buffers */
+	size_t num_bufs;
+	/**
+	 * Called on completion, possibly from an interrupt handler. When NULL,
+	 * the completion is waited for with disk_access_wait().
+	 */
+	void (*cb)(struct disk_access_req *req);
+	/** Free for use by the submitter */
+	void *user_data;
+	/** 0 on success, negative errno code on fail, set on completion */
+	int result;
+
+	/* Internally used */
+	struct disk_info *disk;
+	struct k_work work;
+	struct k_sem done;
+	atomic_t pending;
+	atomic_t status;
+};
+
+/**
+ * @brief Submit disk access requests
+ *
+ * Queue requests without waiting for them to complete. Requests may complete
+ * in any order. Drivers which can queue several commands execute the
+ * requests concurrently, other disks execute them one after the other in a
+ * work queue thread.
+ *
+ * @param[in] disk          Disk handle from disk_access_get()
+ * @param[in] reqs          Array of requests
+ * @param[in] num_reqs      Number of requests
+ *
+ * @retval 0 if all requests were submitted, their results are reported on
+ *         completion
+ * @retval -EINVAL if the disk or a request is invalid, nothing was submitted
+ */
+int disk_access_submit(struct disk_info *disk, struct disk_access_req *reqs,
+		       size_t num_reqs);
+
+/**
+ * @brief Wait for a disk access request to complete
+ *
+ * @param[in] req           Request submitted without callback
+ * @param[in] timeout       Maximum time to wait
+ *
+ * @return Result of the request once completed, -EAGAIN if it did not
+ *         complete within the timeout, -EINVAL if it has a callback
+ */
+int disk_access_wait(struct disk_access_req *req, k_timeout_t timeout);
+
+#endif /* CONFIG_DISK_ACCESS_ASYNC */
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,9 @@
 
 #include <stdbool.h>
 #include <zephyr/drivers/flash.h>
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+#include <zephyr/kernel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,6 +66,16 @@ struct stream_flash_ctx {
 #ifdef CONFIG_STREAM_FLASH_ERASE
 	off_t last_erased_page_start_offset; /* Last erased offset */
 #endif
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	bool double_buffer; /* Buffer halves programmed in the background */
+	uint8_t *buf_base; /* Start of the buffer given to stream_flash_init */
+	uint8_t *wr_buf; /* Buffer half being programmed */
+	size_t wr_bytes; /* Number of bytes in the buffer half programmed */
+	size_t bytes_submitted; /* Number of bytes handed over for programming */
+	int wr_rc; /* First error reported by background programming */
+	struct k_work work; /* Background programming work item */
+	struct k_sem idle; /* Available when no programming is in progress */
+#endif
 };
 
 /**
@@ -84,6 +97,37 @@ struct stream_flash_ctx {
 int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 		      uint8_t *buf, size_t buf_len, size_t offset, size_t size,
 		      stream_flash_callback_t cb);
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+/**
+ * @brief Program the write buffer of a context in the background.
+ *
+ * The write buffer given to stream_flash_init() is split in two halves: while
+ * one half is programmed to flash from the stream flash work queue, the next
+ * data is buffered in the other one, and stream_flash_buffered_write() only
+ * waits when both halves are full. With CONFIG_STREAM_FLASH_ERASE_AHEAD, the
+ * page following the data programmed is erased right away, before the next
+ * half is handed over.
+ *
+ * Errors of background programming are reported by the next call to
+ * stream_flash_buffered_write(). A flush waits for all the data to be
+ * programmed, and stream_flash_bytes_written() only counts programmed data.
+ * The callback given to stream_flash_init() is invoked from the work queue.
+ *
+ * This function must be called after stream_flash_init() and before the first
+ * write. The last write of a sequence must be a flush, and the context must not
+ * be initialized again before it has returned. Not to be used from contexts
+ * that can not block, e.g. when storing a core dump.
+ *
+ * @param ctx context
+ *
+ * @retval 0 on success.
+ * @retval -EFAULT if @p ctx is NULL.
+ * @retval -EINVAL if the halves of the write buffer are not a multiple of
+ *         the flash device write-block-size, or data is already buffered.
+ */
+int stream_flash_double_buffer_enable(struct stream_flash_ctx *ctx);
+#endif
+
 /**
  * @brief Read number of bytes written to the flash.
  *
@@ -0,0 +1,207 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Public API for the time-series store
+ */
+
+#ifndef ZEPHYR_INCLUDE_STORAGE_TSDB_H_
+#define ZEPHYR_INCLUDE_STORAGE_TSDB_H_
+
+/**
+ * @brief Append-only store of timestamped samples in a flash area
+ *
+ * @defgroup tsdb Time-series store
+ * @ingroup storage_apis
+ * @{
+ */
+
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sample of a time series
+ */
+struct tsdb_sample {
+	int64_t ts;	/**< Timestamp, in units chosen by the user */
+	int32_t value;	/**< Value */
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+/* State of a sector, as known by the store */
+enum tsdb_sector_state {
+	TSDB_SECTOR_DIRTY,	/* May hold anything, must be erased before use */
+	TSDB_SECTOR_ERASED,	/* Erased, ready to be used */
+	TSDB_SECTOR_USED,	/* Holds samples, more can be written */
+	TSDB_SECTOR_CLOSED,	/* Holds samples, no more can be written */
+};
+
+/* Time index of a sector, rebuilt on mount */
+struct tsdb_sector {
+	uint32_t seq;		/* Sequence number of the sector */
+	uint32_t wr_off;	/* Offset of the end of the blocks */
+	uint32_t count;		/* Number of samples in the sector */
+	int64_t first_ts;	/* Timestamp of the oldest sample */
+	int64_t last_ts;	/* Timestamp of the newest sample */
+	uint8_t state;		/* enum tsdb_sector_state */
+};
+
+/** @endcond */
+
+/**
+ * @brief Time-series store structure
+ *
+ * The first four fields are set by the user before calling tsdb_mount(), the
+ * other ones are private.
+ */
+struct tsdb_fs {
+	/** ID of the flash area (flash_map partition) holding the store */
+	uint8_t area_id;
+	/** Size of the sectors, a multiple of the flash erase page size */
+	uint32_t sector_size;
+	/** Number of sectors used, at least 2 */
+	uint16_t sector_count;
+	/**
+	 * Age, relative to the newest sample, after which samples are dropped
+	 * with the sector holding them. 0 keeps samples until the space they
+	 * use is needed for new ones.
+	 */
+	int64_t retention;
+
+	/** @cond INTERNAL_HIDDEN */
+	bool ready;
+	struct k_mutex lock;
+	const struct flash_area *fa;
+	uint8_t write_align;
+	uint8_t erase_value;
+	uint16_t active;
+	uint32_t seq;
+	struct tsdb_sector sectors[CONFIG_TSDB_SECTOR_COUNT_MAX];
+	/* Block of samples not yet written */
+	uint8_t block[CONFIG_TSDB_BLOCK_SIZE];
+	uint16_t block_len;
+	uint16_t block_cnt;
+	int64_t block_first_ts;
+	int64_t last_ts;
+	int64_t last_delta;
+	int32_t last_value;
+	bool empty;
+	/* Buffer for blocks read back by queries */
+	uint8_t read_buf[CONFIG_TSDB_BLOCK_SIZE];
+	/** @endcond */
+
+	/** Number of bytes written to flash since mount */
+	uint32_t bytes_written;
+	/** Number of sectors erased since mount */
+	uint32_t sectors_erased;
+};
+
+/**
+ * @typedef tsdb_query_cb_t
+ *
+ * @brief Callback called for each sample found by tsdb_query().
+ *
+ * The callback is called with the store locked, so it must not call other
+ * functions of this API for the same store.
+ *
+ * @param sample Sample found.
+ * @param user_data User data given to tsdb_query().
+ *
+ * @return 0 to continue the query, any other value to stop it.
+ */
+typedef int (*tsdb_query_cb_t)(const struct tsdb_sample *sample,
+			       void *user_data);
+
+/**
+ * @brief Mount a time-series store.
+ *
+ * Rebuilds the time index of the sectors from the flash contents. Sectors
+ * holding only samples older than the retention are erased.
+ *
+ * @param fs Store, with its flash area and geometry set.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the geometry does not fit the flash area or the flash
+ *         device, or the sector count exceeds CONFIG_TSDB_SECTOR_COUNT_MAX.
+ * @retval -ERRNO on other errors.
+ */
+int tsdb_mount(struct tsdb_fs *fs);
+
+/**
+ * @brief Append a sample to a time-series store.
+ *
+ * Samples are compressed in a block in RAM, written to flash when the block
+ * is full or by tsdb_flush(). When no sector is left for a new block, the
+ * oldest sector is erased.
+ *
+ * @param fs Mounted store.
+ * @param ts Timestamp of the sample, not older than the newest sample stored.
+ * @param value Value of the sample.
+ *
+ * @retval 0 on success.
+ * @retval -EACCES if the store is not mounted.
+ * @retval -EINVAL if the sample is older than the newest sample stored.
+ * @retval -ERRNO on flash errors.
+ */
+int tsdb_append(struct tsdb_fs *fs, int64_t ts, int32_t value);
+
+/**
+ * @brief Write the samples appended so far to flash.
+ *
+ * @param fs Mounted store.
+ *
+ * @retval 0 on success.
+ * @retval -EACCES if the store is not mounted.
+ * @retval -ERRNO on flash errors.
+ */
+int tsdb_flush(struct tsdb_fs *fs);
+
+/**
+ * @brief Get the samples of a time range.
+ *
+ * Samples are reported from the oldest to the newest, including the ones not
+ * written to flash yet. Only the sectors and blocks overlapping the range are
+ * read.
+ *
+ * @param fs Mounted store.
+ * @param from Timestamp of the start of the range, included.
+ * @param to Timestamp of the end of the range, included.
+ * @param cb Callback called for each sample of the range.
+ * @param user_data User data passed to @p cb.
+ *
+ * @return Number of samples reported on success, negative errno code on
+ *         failure. -EACCES if the store is not mounted.
+ */
+int tsdb_query(struct tsdb_fs *fs, int64_t from, int64_t to,
+	       tsdb_query_cb_t cb, void *user_data);
+
+/**
+ * @brief Erase all the samples of a time-series store.
+ *
+ * The store stays mounted.
+ *
+ * @param fs Mounted store.
+ *
+ * @retval 0 on success.
+ * @retval -EACCES if the store is not mounted.
+ * @retval -ERRNO on flash errors.
+ */
+int tsdb_clear(struct tsdb_fs *fs);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_STORAGE_TSDB_H_ */
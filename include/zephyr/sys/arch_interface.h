@@ -1030,6 +1030,32 @@ int arch_gdb_remove_breakpoint(struct gdb_ctx *ctx, uint8_t type,
 #endif
 /** @} */
 
+/**
+ * @defgroup arch-profiler Architecture-specific profiler APIs
+ * @ingroup arch-interface
+ * @{
+ */
+
+#ifdef CONFIG_PROFILER
+/**
+ * @brief Sample the code interrupted by the current interrupt
+ *
+ * Called by the sampling profiler from the system timer interrupt. The
+ * first entry stored is the program counter of the interrupted code,
+ * followed by the return addresses of its call stack, innermost first,
+ * if the architecture can walk it.
+ *
+ * @param buf  Buffer receiving the addresses.
+ * @param size Number of entries of @p buf.
+ *
+ * @return Number of entries stored, 0 if the interrupted code cannot be
+ *         sampled (e.g. another interrupt was interrupted).
+ */
+size_t arch_profiler_sample(uintptr_t *buf, size_t size);
+#endif
+
+/** @} */
+
 #ifdef CONFIG_TIMING_FUNCTIONS
 #include <zephyr/timing/types.h>
 
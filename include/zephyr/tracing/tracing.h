@@ -2006,6 +2006,23 @@
 
 /** @} */ /* end of subsys_tracing_apis_pm_device_runtime */
 
+/**
+ * @brief Latency Histogram Tracing APIs
+ * @defgroup subsys_tracing_apis_latency Latency Histogram Tracing APIs
+ * @{
+ */
+
+/**
+ * @brief Trace a bucket of a latency histogram, see k_latency_trace().
+ * @param type Histogram kind (enum k_latency_type).
+ * @param id Thread or interrupt handler, NULL for wait time histograms.
+ * @param start Start of the bucket, in timing cycles.
+ * @param count Number of durations counted in the bucket.
+ */
+#define sys_port_trace_k_latency_bucket(type, id, start, count)
+
+/** @} */ /* end of subsys_tracing_apis_latency */
+
 #if defined(CONFIG_PERCEPIO_TRACERECORDER)
 #include "tracing_tracerecorder.h"
 #else
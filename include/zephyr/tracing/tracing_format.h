@@ -82,6 +82,14 @@ void tracing_format_raw_data(uint8_t *data, uint32_t length);
  */
 void tracing_format_data(tracing_data_t *tracing_data_array, uint32_t count);
 
+/**
+ * @brief Stop tracing and write out the data kept by the tracing backend.
+ *
+ * Called by the default fatal error handler. A custom
+ * k_sys_fatal_error_handler() should call it to keep the end of the trace.
+ */
+void tracing_panic(void);
+
 /** @} */ /* end of subsys_tracing_format_apis */
 
 #ifdef __cplusplus
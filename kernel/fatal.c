@@ -13,6 +13,7 @@
 #include <zephyr/logging/log_ctrl.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/fatal.h>
+#include <zephyr/tracing/tracing_format.h>
 #ifndef	CONFIG_XTENSA
 #include <zephyr/debug/coredump.h>
 #endif
@@ -42,6 +43,9 @@ __weak void k_sys_fatal_error_handler(unsigned int reason,
 	ARG_UNUSED(esf);
 
 	LOG_PANIC();
+#ifdef CONFIG_TRACING_CORE
+	tracing_panic();
+#endif
 	LOG_ERR("Halting system");
 	arch_system_halt(reason);
 	CODE_UNREACHABLE; /* LCOV_EXCL_LINE */
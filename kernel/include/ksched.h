@@ -8,6 +8,7 @@
 #define ZEPHYR_KERNEL_INCLUDE_KSCHED_H_
 
 #include <zephyr/kernel_structs.h>
+#include <zephyr/kernel/latency.h>
 #include <kernel_internal.h>
 #include <zephyr/timeout_q.h>
 #include <zephyr/tracing/tracing.h>
@@ -417,6 +418,29 @@ void z_sched_usage_stop(void);
 
 void z_sched_usage_start(struct k_thread *thread);
 
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+/* Called when a thread is made ready, and when it is switched in, with the
+ * scheduler lock held or interrupts locked.
+ */
+void z_sched_latency_ready(struct k_thread *thread);
+void z_sched_latency_switched_in(struct k_thread *thread);
+#else
+#define z_sched_latency_ready(thread) do { } while (false)
+#define z_sched_latency_switched_in(thread) do { } while (false)
+#endif
+
+#ifdef CONFIG_WAIT_LATENCY_HISTOGRAMS
+/* Measure the time blocked in a kernel object wait */
+uint32_t z_wait_latency_start(void);
+void z_wait_latency_end(enum k_latency_type type, uint32_t start);
+#else
+static inline uint32_t z_wait_latency_start(void)
+{
+	return 0;
+}
+#define z_wait_latency_end(type, start) ARG_UNUSED(start)
+#endif
+
 /**
  * @brief Retrieves CPU cycle usage data for specified core
  */
@@ -435,6 +459,9 @@ static inline void z_sched_usage_switch(struct k_thread *thread)
 	z_sched_usage_stop();
 	z_sched_usage_start(thread);
 #endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	z_sched_latency_switched_in(thread);
+#endif
 }
 
 #endif /* ZEPHYR_KERNEL_INCLUDE_KSCHED_H_ */
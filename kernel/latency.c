@@ -0,0 +1,389 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/kernel/latency.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/tracing/tracing.h>
+#include <ksched.h>
+#include <string.h>
+
+#define PRECISION CONFIG_LATENCY_HISTOGRAM_PRECISION
+#define RANGE     CONFIG_LATENCY_HISTOGRAM_RANGE
+
+/* Deeper nested interrupts are not measured */
+#define ISR_NESTING_MAX 8
+
+static struct k_spinlock latency_lock;
+
+static uint32_t latency_now(void)
+{
+	uint32_t now = (uint32_t)timing_counter_get();
+
+	/* Edge case: we use a zero as a null ("no start time") */
+	return (now == 0) ? 1 : now;
+}
+
+/*
+ * Durations below 2^PRECISION cycles have a bucket each, the ones above
+ * are split by their most significant bit, then by the PRECISION bits
+ * following it.
+ */
+static unsigned int bucket_get(uint32_t cycles)
+{
+	unsigned int shift;
+
+	if (cycles < BIT(PRECISION)) {
+		return cycles;
+	}
+
+	if (cycles >= BIT(RANGE)) {
+		return K_LATENCY_HISTOGRAM_BUCKETS - 1;
+	}
+
+	shift = 31 - __builtin_clz(cycles) - PRECISION;
+
+	return ((shift + 1) << PRECISION) + (cycles >> shift) - BIT(PRECISION);
+}
+
+uint32_t k_latency_bucket_start(unsigned int bucket)
+{
+	unsigned int shift;
+
+	if (bucket < BIT(PRECISION)) {
+		return bucket;
+	}
+
+	shift = (bucket >> PRECISION) - 1;
+
+	return ((bucket & (BIT(PRECISION) - 1)) + BIT(PRECISION)) << shift;
+}
+
+static void histogram_add(struct k_latency_histogram *hist, uint32_t cycles)
+{
+	hist->count++;
+	hist->buckets[bucket_get(cycles)]++;
+
+	if (hist->max < cycles) {
+		hist->max = cycles;
+	}
+}
+
+static __maybe_unused void histogram_trace(enum k_latency_type type,
+					   const void *id,
+					   const struct k_latency_histogram *hist)
+{
+	ARG_UNUSED(type);
+	ARG_UNUSED(id);
+
+	for (unsigned int i = 0; i < K_LATENCY_HISTOGRAM_BUCKETS; i++) {
+		if (hist->buckets[i] != 0) {
+			SYS_PORT_TRACING_FUNC(k_latency, bucket, type, id,
+					      k_latency_bucket_start(i),
+					      hist->buckets[i]);
+		}
+	}
+}
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+/* Both are called with the scheduler lock held or interrupts locked. A
+ * thread leaving the run queue without running keeps its stamp, it is
+ * overwritten when the thread is made ready again. The histogram is read
+ * and cleared from other CPUs, so it is updated under latency_lock.
+ */
+void z_sched_latency_ready(struct k_thread *thread)
+{
+	if (!z_is_idle_thread_object(thread)) {
+		thread->base.ready_stamp = latency_now();
+	}
+}
+
+void z_sched_latency_switched_in(struct k_thread *thread)
+{
+	uint32_t u0 = thread->base.ready_stamp;
+
+	if (u0 != 0) {
+		uint32_t cycles = latency_now() - u0;
+		k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+		histogram_add(&thread->base.sched_latency, cycles);
+
+		k_spin_unlock(&latency_lock, key);
+		thread->base.ready_stamp = 0;
+	}
+}
+#endif
+
+int k_thread_sched_latency_get(k_tid_t thread, struct k_latency_histogram *hist)
+{
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	*hist = thread->base.sched_latency;
+
+	k_spin_unlock(&latency_lock, key);
+
+	return 0;
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(hist);
+
+	return -ENOTSUP;
+#endif
+}
+
+void k_thread_sched_latency_reset(k_tid_t thread)
+{
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	memset(&thread->base.sched_latency, 0, sizeof(thread->base.sched_latency));
+
+	k_spin_unlock(&latency_lock, key);
+#else
+	ARG_UNUSED(thread);
+#endif
+}
+
+#ifdef CONFIG_ISR_LATENCY_HISTOGRAMS
+struct isr_latency {
+	const void *isr;
+	struct k_latency_histogram hist;
+};
+
+struct isr_frames {
+	uint32_t depth;
+	const void *isr[ISR_NESTING_MAX];
+	uint32_t start[ISR_NESTING_MAX];
+};
+
+static struct isr_latency isr_latency[CONFIG_ISR_LATENCY_HISTOGRAMS_COUNT];
+static struct isr_frames isr_frames[CONFIG_MP_MAX_NUM_CPUS];
+static uint32_t isr_untracked;
+
+/*
+ * Histograms are found by hashing the handler address, a slot is taken by
+ * the first handler hashed to it or to a previous slot. Called with
+ * latency_lock held.
+ */
+static struct k_latency_histogram *isr_histogram_get(const void *isr)
+{
+	size_t i = ((uintptr_t)isr >> 2) % ARRAY_SIZE(isr_latency);
+
+	for (size_t n = 0; n < ARRAY_SIZE(isr_latency); n++) {
+		if (isr_latency[i].isr == NULL) {
+			isr_latency[i].isr = isr;
+		}
+
+		if (isr_latency[i].isr == isr) {
+			return &isr_latency[i].hist;
+		}
+
+		i = (i + 1) % ARRAY_SIZE(isr_latency);
+	}
+
+	return NULL;
+}
+
+/* Called by the interrupt entry code of the architecture. The frames are
+ * only used by their own CPU, locking interrupts is enough for them.
+ */
+void z_isr_latency_enter(const void *isr)
+{
+	unsigned int key = arch_irq_lock();
+	struct isr_frames *frames = &isr_frames[_current_cpu->id];
+
+	if (frames->depth < ISR_NESTING_MAX) {
+		frames->isr[frames->depth] = isr;
+		frames->start[frames->depth] = latency_now();
+	}
+	frames->depth++;
+
+	arch_irq_unlock(key);
+}
+
+void z_isr_latency_exit(void)
+{
+	unsigned int key = arch_irq_lock();
+	struct isr_frames *frames = &isr_frames[_current_cpu->id];
+	uint32_t now = latency_now();
+	struct k_latency_histogram *hist;
+	k_spinlock_key_t lock_key;
+	const void *isr = NULL;
+	uint32_t cycles = 0;
+
+	frames->depth--;
+	if (frames->depth < ISR_NESTING_MAX) {
+		isr = frames->isr[frames->depth];
+		cycles = now - frames->start[frames->depth];
+	}
+
+	arch_irq_unlock(key);
+
+	if (isr == NULL) {
+		return;
+	}
+
+	lock_key = k_spin_lock(&latency_lock);
+
+	hist = isr_histogram_get(isr);
+	if (hist != NULL) {
+		histogram_add(hist, cycles);
+	} else {
+		isr_untracked++;
+	}
+
+	k_spin_unlock(&latency_lock, lock_key);
+}
+#endif /* CONFIG_ISR_LATENCY_HISTOGRAMS */
+
+uint32_t k_isr_latency_foreach(k_isr_latency_cb_t cb, void *user_data)
+{
+	uint32_t untracked = 0;
+
+#ifdef CONFIG_ISR_LATENCY_HISTOGRAMS
+	struct isr_latency entry;
+	k_spinlock_key_t key;
+
+	/* Copy each entry, the callback runs without the lock held */
+	for (size_t i = 0; i < ARRAY_SIZE(isr_latency); i++) {
+		key = k_spin_lock(&latency_lock);
+		entry = isr_latency[i];
+		k_spin_unlock(&latency_lock, key);
+
+		if (entry.isr != NULL) {
+			cb(entry.isr, &entry.hist, user_data);
+		}
+	}
+
+	key = k_spin_lock(&latency_lock);
+	untracked = isr_untracked;
+	k_spin_unlock(&latency_lock, key);
+#else
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+#endif
+
+	return untracked;
+}
+
+#ifdef CONFIG_WAIT_LATENCY_HISTOGRAMS
+static struct k_latency_histogram sem_take_latency;
+static struct k_latency_histogram msgq_get_latency;
+
+static struct k_latency_histogram *wait_histogram_get(enum k_latency_type type)
+{
+	switch (type) {
+	case K_LATENCY_SEM_TAKE:
+		return &sem_take_latency;
+	case K_LATENCY_MSGQ_GET:
+		return &msgq_get_latency;
+	default:
+		return NULL;
+	}
+}
+
+uint32_t z_wait_latency_start(void)
+{
+	return latency_now();
+}
+
+void z_wait_latency_end(enum k_latency_type type, uint32_t start)
+{
+	uint32_t cycles = latency_now() - start;
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	histogram_add(wait_histogram_get(type), cycles);
+
+	k_spin_unlock(&latency_lock, key);
+}
+#endif /* CONFIG_WAIT_LATENCY_HISTOGRAMS */
+
+int k_wait_latency_get(enum k_latency_type type,
+		       struct k_latency_histogram *hist)
+{
+#ifdef CONFIG_WAIT_LATENCY_HISTOGRAMS
+	struct k_latency_histogram *src = wait_histogram_get(type);
+	k_spinlock_key_t key;
+
+	if (src == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&latency_lock);
+	*hist = *src;
+	k_spin_unlock(&latency_lock, key);
+
+	return 0;
+#else
+	ARG_UNUSED(type);
+	ARG_UNUSED(hist);
+
+	return -ENOTSUP;
+#endif
+}
+
+void k_latency_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+#ifdef CONFIG_ISR_LATENCY_HISTOGRAMS
+	for (size_t i = 0; i < ARRAY_SIZE(isr_latency); i++) {
+		memset(&isr_latency[i].hist, 0, sizeof(isr_latency[i].hist));
+	}
+	isr_untracked = 0;
+#endif
+
+#ifdef CONFIG_WAIT_LATENCY_HISTOGRAMS
+	memset(&sem_take_latency, 0, sizeof(sem_take_latency));
+	memset(&msgq_get_latency, 0, sizeof(msgq_get_latency));
+#endif
+
+	k_spin_unlock(&latency_lock, key);
+}
+
+#if defined(CONFIG_SCHED_LATENCY_HISTOGRAM) && defined(CONFIG_THREAD_MONITOR)
+static void thread_trace(const struct k_thread *thread, void *user_data)
+{
+	struct k_latency_histogram hist;
+
+	ARG_UNUSED(user_data);
+
+	(void)k_thread_sched_latency_get((k_tid_t)thread, &hist);
+	histogram_trace(K_LATENCY_SCHED, thread, &hist);
+}
+#endif
+
+#ifdef CONFIG_ISR_LATENCY_HISTOGRAMS
+static void isr_trace(const void *isr, const struct k_latency_histogram *hist,
+		      void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	histogram_trace(K_LATENCY_ISR, isr, hist);
+}
+#endif
+
+void k_latency_trace(void)
+{
+#ifdef CONFIG_WAIT_LATENCY_HISTOGRAMS
+	struct k_latency_histogram hist;
+#endif
+
+#if defined(CONFIG_SCHED_LATENCY_HISTOGRAM) && defined(CONFIG_THREAD_MONITOR)
+	k_thread_foreach_unlocked(thread_trace, NULL);
+#endif
+
+#ifdef CONFIG_ISR_LATENCY_HISTOGRAMS
+	(void)k_isr_latency_foreach(isr_trace, NULL);
+#endif
+
+#ifdef CONFIG_WAIT_LATENCY_HISTOGRAMS
+	(void)k_wait_latency_get(K_LATENCY_SEM_TAKE, &hist);
+	histogram_trace(K_LATENCY_SEM_TAKE, NULL, &hist);
+	(void)k_wait_latency_get(K_LATENCY_MSGQ_GET, &hist);
+	histogram_trace(K_LATENCY_MSGQ_GET, NULL, &hist);
+#endif
+}
@@ -16,6 +16,19 @@
 #include <zephyr/sys/check.h>
 #include <zephyr/sys/iterable_sections.h>
 
+#ifdef CONFIG_MEM_SLAB_METRICS
+#include <zephyr/stats/metrics.h>
+
+METRIC_COUNTER_DEFINE(mem_slab_allocs_total, "Blocks allocated from all memory slabs");
+METRIC_COUNTER_DEFINE(mem_slab_alloc_failures_total,
+		      "Memory slab allocations failed or timed out");
+METRIC_GAUGE_DEFINE(mem_slab_blocks_used, "Blocks in use in all memory slabs");
+
+#define UPDATE_METRIC(cmd) (cmd)
+#else
+#define UPDATE_METRIC(cmd)
+#endif
+
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -117,6 +130,8 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 		slab->max_used = MAX(slab->num_used, slab->max_used);
 #endif
+		UPDATE_METRIC(metric_counter_inc(&mem_slab_allocs_total));
+		UPDATE_METRIC(metric_gauge_add(&mem_slab_blocks_used, 1));
 
 		result = 0;
 	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT) ||
@@ -124,6 +139,7 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 		/* don't wait for a free block to become available */
 		*mem = NULL;
 		result = -ENOMEM;
+		UPDATE_METRIC(metric_counter_inc(&mem_slab_alloc_failures_total));
 	} else {
 		SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_mem_slab, alloc, slab, timeout);
 
@@ -131,6 +147,10 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 		result = z_pend_curr(&slab->lock, key, &slab->wait_q, timeout);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
+			/* The block was handed over, it stayed in use */
+			UPDATE_METRIC(metric_counter_inc(&mem_slab_allocs_total));
+		} else {
+			UPDATE_METRIC(metric_counter_inc(&mem_slab_alloc_failures_total));
 		}
 
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, result);
@@ -165,6 +185,7 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 	**(char ***) mem = slab->free_list;
 	slab->free_list = *(char **) mem;
 	slab->num_used--;
+	UPDATE_METRIC(metric_gauge_add(&mem_slab_blocks_used, -1));
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
 
@@ -211,6 +211,7 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout)
 
 	k_spinlock_key_t key;
 	struct k_thread *pending_thread;
+	uint32_t start;
 	int result;
 
 	key = k_spin_lock(&msgq->lock);
@@ -261,7 +262,9 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout)
 		/* wait for get message success or timeout */
 		_current->base.swap_data = data;
 
+		start = z_wait_latency_start();
 		result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+		z_wait_latency_end(K_LATENCY_MSGQ_GET, start);
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_msgq, get, msgq, timeout, result);
 		return result;
 	}
@@ -609,6 +609,7 @@ static void ready_thread(struct k_thread *thread)
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_ready, thread);
 
+		z_sched_latency_ready(thread);
 		queue_thread(thread);
 		update_cache(0);
 		flag_ipi();
@@ -123,6 +123,7 @@ static inline void z_vrfy_k_sem_give(struct k_sem *sem)
 
 int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 {
+	uint32_t start;
 	int ret = 0;
 
 	__ASSERT(((arch_is_in_isr() == false) ||
@@ -147,7 +148,9 @@ int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 
 	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_sem, take, sem, timeout);
 
+	start = z_wait_latency_start();
 	ret = z_pend_curr(&lock, key, &sem->wait_q, timeout);
+	z_wait_latency_end(K_LATENCY_SEM_TAKE, start);
 
 out:
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_sem, take, sem, timeout, ret);
@@ -583,6 +583,9 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 #ifdef CONFIG_EVENTS
 	new_thread->no_wake_on_timeout = false;
 #endif
+#ifdef CONFIG_THREAD_ANALYZER_INCREMENTAL
+	(void)memset(&new_thread->analyzer, 0, sizeof(new_thread->analyzer));
+#endif
 #ifdef CONFIG_THREAD_MONITOR
 	new_thread->entry.pEntry = entry;
 	new_thread->entry.parameter1 = p1;
@@ -1051,6 +1054,10 @@ void z_thread_mark_switched_in(void)
 	z_sched_usage_start(_current);
 #endif
 
+#if defined(CONFIG_SCHED_LATENCY_HISTOGRAM) && !defined(CONFIG_USE_SWITCH)
+	z_sched_latency_switched_in(_current);
+#endif
+
 #ifdef CONFIG_TRACING
 	SYS_PORT_TRACING_FUNC(k_thread, switched_in);
 #endif
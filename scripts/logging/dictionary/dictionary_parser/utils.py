@@ -9,6 +9,15 @@ Utilities for Dictionary-based Logging Parser
 """
 
 import binascii
+import struct
+
+
+LOG_BLOCK_MAGIC = b"ZLDB"
+LOG_BLOCK_VERSION = 1
+LOG_BLOCK_FLAG_COMPRESSED = 0x01
+
+# magic, version, flags, seq, len, raw_len (always little endian)
+LOG_BLOCK_HDR_FMT = "<4sBBHHH"
 
 
 def convert_hex_file_to_bin(hexfile):
@@ -65,3 +74,71 @@ def find_string_in_mappings(string_mappings, str_ptr):
             return whole_str[str_ptr - ptr:]
 
     return None
+
+
+def is_log_block_data(logdata):
+    """Return True if the log data is framed in blocks"""
+    return logdata[:len(LOG_BLOCK_MAGIC)] == LOG_BLOCK_MAGIC
+
+
+def decompress_log_block(payload):
+    """Expand the runs of zero bytes of a compressed block"""
+    data = bytearray()
+    idx = 0
+
+    while idx < len(payload):
+        if payload[idx] != 0:
+            data.append(payload[idx])
+            idx += 1
+        elif idx + 1 < len(payload):
+            data.extend(bytes(payload[idx + 1]))
+            idx += 2
+        else:
+            break
+
+    return bytes(data)
+
+
+def extract_log_blocks(logdata):
+    """
+    Extract the log messages from data framed in blocks, as written
+    by the file system and network backends. Returns the log messages
+    and the number of blocks found missing from the sequence.
+    """
+    hdr_size = struct.calcsize(LOG_BLOCK_HDR_FMT)
+    data = b''
+    lost = 0
+    next_seq = None
+    offset = 0
+
+    while offset + hdr_size <= len(logdata):
+        magic, version, flags, seq, length, raw_len = \
+            struct.unpack_from(LOG_BLOCK_HDR_FMT, logdata, offset)
+
+        if magic != LOG_BLOCK_MAGIC or version != LOG_BLOCK_VERSION:
+            # Resynchronize on the next block
+            idx = logdata.find(LOG_BLOCK_MAGIC, offset + 1)
+            if idx < 0:
+                break
+            offset = idx
+            continue
+
+        payload = logdata[offset + hdr_size:offset + hdr_size + length]
+        if len(payload) < length:
+            # Truncated block
+            break
+
+        if flags & LOG_BLOCK_FLAG_COMPRESSED:
+            payload = decompress_log_block(payload)
+
+        if len(payload) != raw_len:
+            lost += 1
+        else:
+            if next_seq is not None:
+                lost += (seq - next_seq) & 0xFFFF
+            data += payload
+
+        next_seq = (seq + 1) & 0xFFFF
+        offset += hdr_size + length
+
+    return data, lost
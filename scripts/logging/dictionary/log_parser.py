@@ -123,6 +123,11 @@ def main():
         logger.error("ERROR: cannot read log from file: %s, exiting...", args.logfile)
         sys.exit(1)
 
+    if dictionary_parser.utils.is_log_block_data(logdata):
+        logdata, lost = dictionary_parser.utils.extract_log_blocks(logdata)
+        if lost > 0:
+            logger.warning("WARNING: %d block(s) of log data lost", lost)
+
     log_parser = dictionary_parser.get_parser(database)
     if log_parser is not None:
         logger.debug("# Build ID: %s", database.get_build_id())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Script to replace the addresses of the folded stacks dumped by the sampling
+CPU profiler with the names of the functions they belong to.
+
+Capture the output of the "profiler dump" shell command to a file, then:
+
+    ./scripts/profiler/symbolize_folded.py build/zephyr/zephyr.elf dump.txt \\
+        > profile.folded
+    flamegraph.pl profile.folded > profile.svg
+
+Stacks which resolve to the same functions are merged.
+"""
+
+import argparse
+import bisect
+import collections
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+
+class Symbolizer:
+    def __init__(self, elf_path):
+        funcs = []
+        with open(elf_path, "rb") as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                if not isinstance(section, SymbolTableSection):
+                    continue
+                for sym in section.iter_symbols():
+                    if sym["st_info"]["type"] != "STT_FUNC" or sym["st_size"] == 0:
+                        continue
+                    # Clear the Thumb bit
+                    addr = sym["st_value"] & ~1
+                    funcs.append((addr, addr + sym["st_size"], sym.name))
+        funcs.sort()
+        self.starts = [func[0] for func in funcs]
+        self.funcs = funcs
+
+    def name(self, addr):
+        idx = bisect.bisect_right(self.starts, addr) - 1
+        if idx >= 0:
+            start, end, name = self.funcs[idx]
+            if start <= addr < end:
+                return name
+        return hex(addr)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="Zephyr ELF file")
+    parser.add_argument("dump", nargs="?", type=argparse.FileType("r"),
+                        default=sys.stdin,
+                        help="Output of the profiler dump command (default: stdin)")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    symbolizer = Symbolizer(args.elf)
+    stacks = collections.OrderedDict()
+
+    for line in args.dump:
+        fields = line.strip().rsplit(" ", 1)
+        if len(fields) != 2 or not fields[1].isdigit():
+            # Shell prompt or other output
+            continue
+        try:
+            # Return addresses point after the call, look up the call itself
+            addrs = [int(addr, 16) for addr in fields[0].split(";")]
+        except ValueError:
+            continue
+        names = [symbolizer.name(addr - 1 if i < len(addrs) - 1 else addr)
+                 for i, addr in enumerate(addrs)]
+        stack = ";".join(names)
+        stacks[stack] = stacks.get(stack, 0) + int(fields[1])
+
+    for stack, count in stacks.items():
+        print(f"{stack} {count}")
+
+
+if __name__ == "__main__":
+    main()
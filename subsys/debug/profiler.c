@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Sampling CPU profiler
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/debug/profiler.h>
+#include <string.h>
+
+#ifdef CONFIG_PROFILER_CALL_STACK
+#define STACK_DEPTH CONFIG_PROFILER_STACK_DEPTH
+#else
+#define STACK_DEPTH 1
+#endif
+
+/* Probing is limited to keep the time spent in the timer interrupt
+ * bounded, the sample is lost when no entry is found.
+ */
+#define MAX_PROBES 8
+
+struct profiler_entry {
+	uint32_t count;
+	uint32_t depth;
+	uintptr_t stack[STACK_DEPTH];
+};
+
+static struct profiler_entry entries[CONFIG_PROFILER_HISTOGRAM_SIZE];
+static struct profiler_stats stats;
+static struct k_spinlock lock;
+static bool running;
+
+static uint32_t stack_hash(const uintptr_t *stack, size_t depth)
+{
+	/* FNV-1a over the addresses */
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < depth; i++) {
+		hash = (hash ^ (uint32_t)stack[i]) * 16777619U;
+	}
+
+	return hash ^ (hash >> 16);
+}
+
+static struct profiler_entry *entry_get(const uintptr_t *stack, size_t depth)
+{
+	uint32_t idx = stack_hash(stack, depth) % CONFIG_PROFILER_HISTOGRAM_SIZE;
+
+	for (int i = 0; i < MAX_PROBES; i++) {
+		struct profiler_entry *entry = &entries[idx];
+
+		if (entry->count == 0U) {
+			entry->depth = depth;
+			memcpy(entry->stack, stack, depth * sizeof(stack[0]));
+			return entry;
+		}
+
+		if ((entry->depth == depth) &&
+		    (memcmp(entry->stack, stack, depth * sizeof(stack[0])) == 0)) {
+			return entry;
+		}
+
+		idx = (idx + 1U) % CONFIG_PROFILER_HISTOGRAM_SIZE;
+	}
+
+	return NULL;
+}
+
+static void sample(struct k_timer *timer)
+{
+	uintptr_t stack[STACK_DEPTH];
+	struct profiler_entry *entry;
+	k_spinlock_key_t key;
+	size_t depth;
+
+	ARG_UNUSED(timer);
+
+	depth = arch_profiler_sample(stack, STACK_DEPTH);
+
+	key = k_spin_lock(&lock);
+
+	stats.samples++;
+	if (depth == 0U) {
+		stats.missed++;
+	} else {
+		entry = entry_get(stack, depth);
+		if (entry != NULL) {
+			entry->count++;
+		} else {
+			stats.lost++;
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+static K_TIMER_DEFINE(sample_timer, sample, NULL);
+
+int profiler_start(uint32_t frequency)
+{
+	k_spinlock_key_t key;
+	k_timeout_t period;
+
+	if ((frequency == 0U) || (frequency > CONFIG_SYS_CLOCK_TICKS_PER_SEC)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	if (running) {
+		k_spin_unlock(&lock, key);
+		return -EALREADY;
+	}
+	running = true;
+	k_spin_unlock(&lock, key);
+
+	period = K_TICKS(CONFIG_SYS_CLOCK_TICKS_PER_SEC / frequency);
+	k_timer_start(&sample_timer, period, period);
+
+	return 0;
+}
+
+int profiler_stop(void)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&lock);
+	if (!running) {
+		k_spin_unlock(&lock, key);
+		return -EALREADY;
+	}
+	running = false;
+	k_spin_unlock(&lock, key);
+
+	k_timer_stop(&sample_timer);
+
+	return 0;
+}
+
+bool profiler_is_running(void)
+{
+	return running;
+}
+
+void profiler_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	memset(entries, 0, sizeof(entries));
+	memset(&stats, 0, sizeof(stats));
+
+	k_spin_unlock(&lock, key);
+}
+
+void profiler_stats_get(struct profiler_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*out = stats;
+
+	k_spin_unlock(&lock, key);
+}
+
+int profiler_foreach(profiler_cb_t cb, void *user_data)
+{
+	if (running) {
+		return -EBUSY;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		const struct profiler_entry *entry = &entries[i];
+
+		if (entry->count > 0U) {
+			cb(entry->stack, entry->depth, entry->count, user_data);
+		}
+	}
+
+	return 0;
+}
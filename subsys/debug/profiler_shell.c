@@ -0,0 +1,114 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/shell/shell.h>
+#include <zephyr/debug/profiler.h>
+#include <stdlib.h>
+
+static int cmd_profiler_start(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t frequency = CONFIG_PROFILER_FREQUENCY;
+	int err;
+
+	if (argc > 1) {
+		char *end;
+
+		frequency = strtoul(argv[1], &end, 10);
+		if (*end != '\0') {
+			shell_error(sh, "Invalid frequency: %s", argv[1]);
+			return -EINVAL;
+		}
+	}
+
+	err = profiler_start(frequency);
+	if (err == -EALREADY) {
+		shell_error(sh, "Profiler already running");
+	} else if (err < 0) {
+		shell_error(sh, "Unsupported frequency: %u Hz (max %u Hz)",
+			    frequency, CONFIG_SYS_CLOCK_TICKS_PER_SEC);
+	} else {
+		shell_print(sh, "Sampling at %u Hz", frequency);
+	}
+
+	return err;
+}
+
+static int cmd_profiler_stop(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (profiler_stop() < 0) {
+		shell_error(sh, "Profiler not running");
+		return -EALREADY;
+	}
+
+	return 0;
+}
+
+static int cmd_profiler_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(sh);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	profiler_reset();
+
+	return 0;
+}
+
+static int cmd_profiler_status(const struct shell *sh, size_t argc, char **argv)
+{
+	struct profiler_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	profiler_stats_get(&stats);
+
+	shell_print(sh, "%s, samples: %u, missed: %u, lost: %u",
+		    profiler_is_running() ? "running" : "stopped",
+		    stats.samples, stats.missed, stats.lost);
+
+	return 0;
+}
+
+/* One line per stack, outermost frame first, followed by the count. */
+static void folded_print(const uintptr_t *stack, size_t depth, uint32_t count,
+			 void *user_data)
+{
+	const struct shell *sh = user_data;
+
+	for (size_t i = depth; i > 0; i--) {
+		shell_fprintf(sh, SHELL_NORMAL, "%s%#lx",
+			      (i == depth) ? "" : ";", (unsigned long)stack[i - 1]);
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, " %u\n", count);
+}
+
+static int cmd_profiler_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (profiler_foreach(folded_print, (void *)sh) < 0) {
+		shell_error(sh, "Stop the profiler first");
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_profiler,
+	SHELL_CMD_ARG(start, NULL, "[<frequency (Hz)>]", cmd_profiler_start, 1, 1),
+	SHELL_CMD(stop, NULL, "Stop sampling.", cmd_profiler_stop),
+	SHELL_CMD(reset, NULL, "Clear the samples.", cmd_profiler_reset),
+	SHELL_CMD(status, NULL, "Show the sampling statistics.", cmd_profiler_status),
+	SHELL_CMD(dump, NULL, "Print the samples in folded stack format.",
+		  cmd_profiler_dump),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_REGISTER(profiler, &sub_profiler, "Sampling CPU profiler commands", NULL);
@@ -12,6 +12,7 @@
 #include <kernel_internal.h>
 #include <zephyr/debug/thread_analyzer.h>
 #include <zephyr/debug/stack.h>
+#include <zephyr/init.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <stdio.h>
@@ -36,6 +37,210 @@ LOG_MODULE_REGISTER(thread_analyzer, CONFIG_THREAD_ANALYZER_LOG_LEVEL);
  */
 #define PTR_STR_MAXLEN (sizeof(void *) * 2 + 2)
 
+static const char *thread_name_get(const struct k_thread *thread,
+				   char *hexname, size_t size)
+{
+	const char *name = k_thread_name_get((k_tid_t)thread);
+
+	if (!name || name[0] == '\0') {
+		name = hexname;
+		snprintk(hexname, size, "%p", (void *)thread);
+	}
+
+	return name;
+}
+
+#if defined(CONFIG_THREAD_ANALYZER_INCREMENTAL)
+
+/* The last interval weighs 1/4 in the CPU load moving average */
+#define LOAD_AVG_SHIFT 2
+
+static K_MUTEX_DEFINE(analyzer_mutex);
+static thread_analyzer_event_cb event_cb;
+static uint64_t total_cycles;
+
+/* The used part of a stack only grows, so the scan starts from the known
+ * watermark: bytes below it are checked until a window of untouched
+ * bytes is found. The rest of the untouched part is then verified from
+ * the stack bottom, a budget at a time, to find the usage hidden below
+ * bytes never written, e.g. by a large local array.
+ */
+static int stack_update(struct k_thread *thread, size_t budget, size_t *used)
+{
+	struct _thread_analyzer *state = &thread->analyzer;
+	const uint8_t *stack = (const uint8_t *)thread->stack_info.start;
+	size_t size = thread->stack_info.size;
+	size_t unused;
+	size_t untouched;
+	size_t end;
+	size_t i;
+
+	/* Reading the unused part of the running stack may fault */
+	if (IS_ENABLED(CONFIG_NO_UNUSED_STACK_INSPECTION) &&
+	    (thread == k_current_get())) {
+		return -ENOTSUP;
+	}
+
+	if (IS_ENABLED(CONFIG_STACK_SENTINEL)) {
+		/* The sentinel takes the first 4 bytes, see z_stack_space_get() */
+		stack += 4;
+		size -= 4;
+	}
+
+	unused = MIN(thread->stack_info.size - state->stack_used, size);
+
+	untouched = 0;
+	for (i = unused; (i > 0) && (untouched < CONFIG_THREAD_ANALYZER_SCAN_WINDOW); i--) {
+		if (stack[i - 1] == 0xaaU) {
+			untouched++;
+		} else {
+			unused = i - 1;
+			untouched = 0;
+		}
+	}
+
+	if (state->scan_cursor >= unused) {
+		state->scan_cursor = 0;
+	}
+
+	end = (budget < unused - state->scan_cursor) ?
+	      state->scan_cursor + budget : unused;
+
+	for (i = state->scan_cursor; i < end; i++) {
+		if (stack[i] != 0xaaU) {
+			unused = i;
+			break;
+		}
+	}
+
+	/* Start over once the verification reached the watermark */
+	state->scan_cursor = (i < unused) ? i : 0;
+	state->stack_used = thread->stack_info.size - unused;
+	*used = state->stack_used;
+
+	return 0;
+}
+
+static void load_update(struct k_thread *thread, uint64_t interval)
+{
+	struct _thread_analyzer *state = &thread->analyzer;
+	k_thread_runtime_stats_t rt_stats;
+	uint64_t cycles;
+
+	if (k_thread_runtime_stats_get(thread, &rt_stats) != 0) {
+		return;
+	}
+
+	cycles = rt_stats.execution_cycles - state->cycles;
+	state->cycles = rt_stats.execution_cycles;
+
+	if (interval == 0U) {
+		return;
+	}
+
+	state->load = MIN((cycles * 100U) / interval, 100U);
+	state->load_avg = state->load_avg - (state->load_avg >> LOAD_AVG_SHIFT) +
+			  ((state->load << 8) >> LOAD_AVG_SHIFT);
+}
+
+static void event_raise(const struct k_thread *thread, uint32_t event,
+			unsigned int value)
+{
+	char hexname[PTR_STR_MAXLEN + 1];
+
+	if (event_cb != NULL) {
+		event_cb(thread, event, value);
+		return;
+	}
+
+	THREAD_ANALYZER_PRINT(
+		THREAD_ANALYZER_FMT(" %-20s: %s threshold crossed (%u %%)"),
+		THREAD_ANALYZER_VSTR(thread_name_get(thread, hexname, sizeof(hexname))),
+		(event == THREAD_ANALYZER_EVENT_STACK) ? "stack usage" : "CPU load",
+		value);
+}
+
+static void thread_step_cb(const struct k_thread *cthread, void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	struct _thread_analyzer *state = &thread->analyzer;
+	uint64_t interval = *(uint64_t *)user_data;
+	unsigned int pcnt;
+	size_t used;
+
+	if ((stack_update(thread, CONFIG_THREAD_ANALYZER_SCAN_BUDGET, &used) == 0) &&
+	    (CONFIG_THREAD_ANALYZER_STACK_THRESHOLD > 0) &&
+	    !(state->events & THREAD_ANALYZER_EVENT_STACK)) {
+		pcnt = (used * 100U) / thread->stack_info.size;
+		if (pcnt >= CONFIG_THREAD_ANALYZER_STACK_THRESHOLD) {
+			state->events |= THREAD_ANALYZER_EVENT_STACK;
+			event_raise(thread, THREAD_ANALYZER_EVENT_STACK, pcnt);
+		}
+	}
+
+	load_update(thread, interval);
+
+	if (CONFIG_THREAD_ANALYZER_CPU_THRESHOLD > 0) {
+		pcnt = state->load_avg >> 8;
+		if (pcnt < CONFIG_THREAD_ANALYZER_CPU_THRESHOLD) {
+			state->events &= ~THREAD_ANALYZER_EVENT_CPU;
+		} else if (!(state->events & THREAD_ANALYZER_EVENT_CPU)) {
+			state->events |= THREAD_ANALYZER_EVENT_CPU;
+			event_raise(thread, THREAD_ANALYZER_EVENT_CPU, pcnt);
+		}
+	}
+}
+
+void thread_analyzer_event_cb_set(thread_analyzer_event_cb cb)
+{
+	event_cb = cb;
+}
+
+void thread_analyzer_step(void)
+{
+	k_thread_runtime_stats_t rt_stats_all;
+	uint64_t interval = 0;
+
+	k_mutex_lock(&analyzer_mutex, K_FOREVER);
+
+	if (k_thread_runtime_stats_all_get(&rt_stats_all) == 0) {
+		interval = rt_stats_all.execution_cycles - total_cycles;
+		total_cycles = rt_stats_all.execution_cycles;
+	}
+
+	if (IS_ENABLED(CONFIG_THREAD_ANALYZER_RUN_UNLOCKED)) {
+		k_thread_foreach_unlocked(thread_step_cb, &interval);
+	} else {
+		k_thread_foreach(thread_step_cb, &interval);
+	}
+
+	k_mutex_unlock(&analyzer_mutex);
+}
+
+#if CONFIG_THREAD_ANALYZER_INCREMENTAL_INTERVAL > 0
+static void step_work_handler(struct k_work *work)
+{
+	thread_analyzer_step();
+
+	k_work_reschedule(k_work_delayable_from_work(work),
+			  K_MSEC(CONFIG_THREAD_ANALYZER_INCREMENTAL_INTERVAL));
+}
+
+static K_WORK_DELAYABLE_DEFINE(step_work, step_work_handler);
+
+static int thread_analyzer_step_init(void)
+{
+	k_work_schedule(&step_work,
+			K_MSEC(CONFIG_THREAD_ANALYZER_INCREMENTAL_INTERVAL));
+
+	return 0;
+}
+
+SYS_INIT(thread_analyzer_step_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif
+
+#endif /* CONFIG_THREAD_ANALYZER_INCREMENTAL */
+
 static void thread_print_cb(struct thread_analyzer_info *info)
 {
 	size_t pcnt = (info->stack_used * 100U) / info->stack_size;
@@ -69,6 +274,12 @@ static void thread_print_cb(struct thread_analyzer_info *info)
 		info->stack_size - info->stack_used, info->stack_used,
 		info->stack_size, pcnt);
 #endif
+
+#ifdef CONFIG_THREAD_ANALYZER_INCREMENTAL
+	THREAD_ANALYZER_PRINT(
+		THREAD_ANALYZER_FMT("      : CPU load: %u %%, average %u %%"),
+		info->load, info->load_avg);
+#endif
 }
 
 static void thread_analyze_cb(const struct k_thread *cthread, void *user_data)
@@ -85,16 +296,23 @@ static void thread_analyze_cb(const struct k_thread *cthread, void *user_data)
 	const char *name;
 	size_t unused;
 	int err;
+#if defined(CONFIG_THREAD_ANALYZER_INCREMENTAL)
+	size_t used;
+#endif
 
+	name = thread_name_get(thread, hexname, sizeof(hexname));
 
+#if defined(CONFIG_THREAD_ANALYZER_INCREMENTAL)
+	/* Full scan, which also refreshes the watermark of the steps */
+	thread->analyzer.scan_cursor = 0;
+	err = stack_update(thread, SIZE_MAX, &used);
+	unused = (err == 0) ? size - used : 0;
 
-	name = k_thread_name_get((k_tid_t)thread);
-	if (!name || name[0] == '\0') {
-		name = hexname;
-		snprintk(hexname, sizeof(hexname), "%p", (void *)thread);
-	}
-
+	info.load = thread->analyzer.load;
+	info.load_avg = thread->analyzer.load_avg >> 8;
+#else
 	err = k_thread_stack_space_get(thread, &unused);
+#endif
 	if (err) {
 		THREAD_ANALYZER_PRINT(
 			THREAD_ANALYZER_FMT(
@@ -152,12 +370,20 @@ static void isr_stacks(void)
 
 void thread_analyzer_run(thread_analyzer_cb cb)
 {
+#if defined(CONFIG_THREAD_ANALYZER_INCREMENTAL)
+	k_mutex_lock(&analyzer_mutex, K_FOREVER);
+#endif
+
 	if (IS_ENABLED(CONFIG_THREAD_ANALYZER_RUN_UNLOCKED)) {
 		k_thread_foreach_unlocked(thread_analyze_cb, cb);
 	} else {
 		k_thread_foreach(thread_analyze_cb, cb);
 	}
 
+#if defined(CONFIG_THREAD_ANALYZER_INCREMENTAL)
+	k_mutex_unlock(&analyzer_mutex);
+#endif
+
 	if (IS_ENABLED(CONFIG_THREAD_ANALYZER_ISR_STACK_USAGE)) {
 		isr_stacks();
 	}
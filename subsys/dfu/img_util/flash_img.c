@@ -88,9 +88,17 @@ int flash_img_init_id(struct flash_img_context *ctx, uint8_t area_id)
 
 	flash_dev = flash_area_get_device(ctx->flash_area);
 
-	return stream_flash_init(&ctx->stream, flash_dev, ctx->buf,
-			CONFIG_IMG_BLOCK_BUF_SIZE, ctx->flash_area->fa_off,
+	rc = stream_flash_init(&ctx->stream, flash_dev, ctx->buf,
+			sizeof(ctx->buf), ctx->flash_area->fa_off,
 			ctx->flash_area->fa_size, NULL);
+
+#ifdef CONFIG_IMG_DOUBLE_BUFFER
+	if (rc == 0) {
+		rc = stream_flash_double_buffer_enable(&ctx->stream);
+	}
+#endif
+
+	return rc;
 }
 
 int flash_img_init(struct flash_img_context *ctx)
@@ -13,6 +13,8 @@
 #include <errno.h>
 #include <zephyr/device.h>
 
+#include "disk_cache.h"
+
 #define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(disk);
@@ -53,6 +55,11 @@ struct disk_info *disk_access_get_di(const char *name)
 	return disk;
 }
 
+struct disk_info *disk_access_get(const char *pdrv)
+{
+	return disk_access_get_di(pdrv);
+}
+
 int disk_access_init(const char *pdrv)
 {
 	struct disk_info *disk = disk_access_get_di(pdrv);
@@ -60,6 +67,10 @@ int disk_access_init(const char *pdrv)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->init != NULL)) {
+		if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+			/* The media may have changed */
+			(void)disk_cache_drop(disk);
+		}
 		rc = disk->ops->init(disk);
 	}
 
@@ -79,34 +90,58 @@ int disk_access_status(const char *pdrv)
 	return rc;
 }
 
-int disk_access_read(const char *pdrv, uint8_t *data_buf,
+static int disk_read(struct disk_info *disk, uint8_t *data_buf,
 		     uint32_t start_sector, uint32_t num_sector)
 {
-	struct disk_info *disk = disk_access_get_di(pdrv);
 	int rc = -EINVAL;
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->read != NULL)) {
-		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+			rc = disk_cache_read(disk, data_buf, start_sector,
+					     num_sector);
+		} else {
+			rc = disk->ops->read(disk, data_buf, start_sector,
+					     num_sector);
+		}
 	}
 
 	return rc;
 }
 
-int disk_access_write(const char *pdrv, const uint8_t *data_buf,
+static int disk_write(struct disk_info *disk, const uint8_t *data_buf,
 		      uint32_t start_sector, uint32_t num_sector)
 {
-	struct disk_info *disk = disk_access_get_di(pdrv);
 	int rc = -EINVAL;
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->write != NULL)) {
-		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+			rc = disk_cache_write(disk, data_buf, start_sector,
+					      num_sector);
+		} else {
+			rc = disk->ops->write(disk, data_buf, start_sector,
+					      num_sector);
+		}
 	}
 
 	return rc;
 }
 
+int disk_access_read(const char *pdrv, uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	return disk_read(disk_access_get_di(pdrv), data_buf, start_sector,
+			 num_sector);
+}
+
+int disk_access_write(const char *pdrv, const uint8_t *data_buf,
+		      uint32_t start_sector, uint32_t num_sector)
+{
+	return disk_write(disk_access_get_di(pdrv), data_buf, start_sector,
+			  num_sector);
+}
+
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
 {
 	struct disk_info *disk = disk_access_get_di(pdrv);
@@ -114,7 +149,15 @@ int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->ioctl != NULL)) {
-		rc = disk->ops->ioctl(disk, cmd, buf);
+		rc = 0;
+		if (IS_ENABLED(CONFIG_DISK_CACHE) &&
+		    (cmd == DISK_IOCTL_CTRL_SYNC)) {
+			rc = disk_cache_flush(disk);
+		}
+
+		if (rc == 0) {
+			rc = disk->ops->ioctl(disk, cmd, buf);
+		}
 	}
 
 	return rc;
@@ -161,6 +204,10 @@ int disk_access_unregister(struct disk_info *disk)
 		rc = -EINVAL;
 		goto unreg_err;
 	}
+	if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+		(void)disk_cache_drop(disk);
+	}
+
 	/* remove disk node from the list */
 	sys_dlist_remove(&disk->node);
 	LOG_DBG("disk interface(%s) unregistered", disk->name);
@@ -168,3 +215,165 @@ unreg_err:
 	k_mutex_unlock(&mutex);
 	return rc;
 }
+
+#if defined(CONFIG_DISK_ACCESS_ASYNC)
+static K_KERNEL_STACK_DEFINE(async_stack, CONFIG_DISK_ACCESS_ASYNC_STACK_SIZE);
+static struct k_work_q async_work_q;
+
+void disk_access_req_done(struct disk_access_req *req, int result)
+{
+	if (result != 0) {
+		/* Report the first error */
+		(void)atomic_cas(&req->status, 0, result);
+	}
+
+	if (atomic_dec(&req->pending) != 1) {
+		return;
+	}
+
+	req->result = (int)atomic_get(&req->status);
+	if (req->cb != NULL) {
+		req->cb(req);
+	} else {
+		k_sem_give(&req->done);
+	}
+}
+
+/* Execute a request with the synchronous operations of the disk */
+static void async_work_handler(struct k_work *work)
+{
+	struct disk_access_req *req = CONTAINER_OF(work, struct disk_access_req,
+						   work);
+	uint32_t sector = req->start_sector;
+	int rc = 0;
+
+	for (size_t i = 0; (i < req->num_bufs) && (rc == 0); i++) {
+		const struct disk_access_buf *buf = &req->bufs[i];
+
+		if (req->op == DISK_ACCESS_OP_READ) {
+			rc = disk_read(req->disk, buf->data, sector,
+				       buf->num_sector);
+		} else {
+			rc = disk_write(req->disk, buf->data, sector,
+					buf->num_sector);
+		}
+
+		sector += buf->num_sector;
+	}
+
+	disk_access_req_done(req, rc);
+}
+
+/* Queue the buffers of a request to the driver */
+static void async_submit_bufs(struct disk_access_req *req)
+{
+	struct disk_info *disk = req->disk;
+	uint32_t sector = req->start_sector;
+	int rc;
+
+	for (size_t i = 0; i < req->num_bufs; i++) {
+		const struct disk_access_buf *buf = &req->bufs[i];
+
+		atomic_inc(&req->pending);
+		rc = disk->ops->submit(disk, req, buf->data, sector,
+				       buf->num_sector);
+		if (rc != 0) {
+			disk_access_req_done(req, rc);
+			break;
+		}
+
+		sector += buf->num_sector;
+	}
+
+	/* Drop the reference held while submitting */
+	disk_access_req_done(req, 0);
+}
+
+static bool async_req_is_valid(struct disk_info *disk,
+			       const struct disk_access_req *req)
+{
+	if ((req->num_bufs != 0) && (req->bufs == NULL)) {
+		return false;
+	}
+
+	switch (req->op) {
+	case DISK_ACCESS_OP_READ:
+		return (disk->ops->read != NULL) || (disk->ops->submit != NULL);
+	case DISK_ACCESS_OP_WRITE:
+		return (disk->ops->write != NULL) || (disk->ops->submit != NULL);
+	default:
+		return false;
+	}
+}
+
+int disk_access_submit(struct disk_info *disk, struct disk_access_req *reqs,
+		       size_t num_reqs)
+{
+	bool native;
+
+	if ((disk == NULL) || (disk->ops == NULL) ||
+	    ((num_reqs != 0) && (reqs == NULL))) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < num_reqs; i++) {
+		if (!async_req_is_valid(disk, &reqs[i])) {
+			return -EINVAL;
+		}
+	}
+
+	/*
+	 * The cache does not see the requests queued to the driver, they go
+	 * through the work queue instead to remain coherent with it.
+	 */
+	native = !IS_ENABLED(CONFIG_DISK_CACHE) && (disk->ops->submit != NULL);
+
+	for (size_t i = 0; i < num_reqs; i++) {
+		struct disk_access_req *req = &reqs[i];
+
+		req->disk = disk;
+		req->result = -EINPROGRESS;
+		k_sem_init(&req->done, 0, 1);
+		atomic_set(&req->status, 0);
+		atomic_set(&req->pending, 1);
+
+		if (native) {
+			async_submit_bufs(req);
+		} else {
+			k_work_init(&req->work, async_work_handler);
+			(void)k_work_submit_to_queue(&async_work_q, &req->work);
+		}
+	}
+
+	return 0;
+}
+
+int disk_access_wait(struct disk_access_req *req, k_timeout_t timeout)
+{
+	if (req->cb != NULL) {
+		return -EINVAL;
+	}
+
+	if (k_sem_take(&req->done, timeout) != 0) {
+		return -EAGAIN;
+	}
+
+	return req->result;
+}
+
+static int disk_access_async_init(void)
+{
+	static const struct k_work_queue_config cfg = {
+		.name = "disk_access",
+	};
+
+	k_work_queue_start(&async_work_q, async_stack,
+			   K_KERNEL_STACK_SIZEOF(async_stack),
+			   CONFIG_DISK_ACCESS_ASYNC_THREAD_PRIORITY, &cfg);
+
+	return 0;
+}
+
+SYS_INIT(disk_access_async_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_DISK_ACCESS_ASYNC */
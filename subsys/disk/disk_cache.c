@@ -0,0 +1,489 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/drivers/disk.h>
+
+#include "disk_cache.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(disk, CONFIG_DISK_LOG_LEVEL);
+
+#define DISK_CACHE_BUCKETS	32
+/* Most sectors written to a disk in one operation */
+#define DISK_CACHE_MAX_RUN	32
+/* Accesses larger than this are not cached, they would evict everything */
+#define DISK_CACHE_MAX_ACCESS	(CONFIG_DISK_CACHE_HEAP_SIZE / 2)
+/* Modified data written when more than this is cached */
+#define DISK_CACHE_MAX_DIRTY	(CONFIG_DISK_CACHE_HEAP_SIZE / 2)
+
+/* A cached sector */
+struct disk_cache_page {
+	/* Node in the LRU list, least recently used first */
+	sys_dnode_t node;
+	/* Next page in the same hash bucket */
+	struct disk_cache_page *next;
+	struct disk_info *disk;
+	uint32_t sector;
+	bool dirty;
+	uint8_t data[];
+};
+
+static K_HEAP_DEFINE(cache_heap, CONFIG_DISK_CACHE_HEAP_SIZE);
+static struct disk_cache_page *buckets[DISK_CACHE_BUCKETS];
+static sys_dlist_t lru = SYS_DLIST_STATIC_INIT(&lru);
+static size_t dirty_bytes;
+
+/* lock to protect the cache and serialize the disk operations it does */
+static K_MUTEX_DEFINE(cache_lock);
+
+static struct disk_cache_page **page_bucket(struct disk_info *disk,
+					    uint32_t sector)
+{
+	/* Consecutive sectors go to different buckets */
+	return &buckets[(sector + ((uintptr_t)disk >> 2)) % DISK_CACHE_BUCKETS];
+}
+
+static struct disk_cache_page *page_find(struct disk_info *disk,
+					 uint32_t sector)
+{
+	struct disk_cache_page *page = *page_bucket(disk, sector);
+
+	while ((page != NULL) &&
+	       ((page->disk != disk) || (page->sector != sector))) {
+		page = page->next;
+	}
+
+	return page;
+}
+
+static void page_touch(struct disk_cache_page *page)
+{
+	sys_dlist_remove(&page->node);
+	sys_dlist_append(&lru, &page->node);
+}
+
+static void page_set_dirty(struct disk_cache_page *page, bool dirty)
+{
+	if (page->dirty != dirty) {
+		if (dirty) {
+			dirty_bytes += page->disk->cache_sector_size;
+		} else {
+			dirty_bytes -= page->disk->cache_sector_size;
+		}
+		page->dirty = dirty;
+	}
+}
+
+static void page_free(struct disk_cache_page *page)
+{
+	struct disk_cache_page **pp = page_bucket(page->disk, page->sector);
+
+	while (*pp != page) {
+		pp = &(*pp)->next;
+	}
+	*pp = page->next;
+
+	page_set_dirty(page, false);
+	sys_dlist_remove(&page->node);
+	k_heap_free(&cache_heap, page);
+}
+
+static int page_write_run(struct disk_cache_page *first);
+
+/* Allocate from the cache heap, evicting the least recently used pages as
+ * needed. Modified pages are only evicted, after being written, when
+ * allow_dirty is set.
+ */
+static void *cache_alloc(size_t size, bool allow_dirty)
+{
+	struct disk_cache_page *page;
+	void *ptr;
+
+	while ((ptr = k_heap_alloc(&cache_heap, size, K_NO_WAIT)) == NULL) {
+		SYS_DLIST_FOR_EACH_CONTAINER(&lru, page, node) {
+			if (!page->dirty || allow_dirty) {
+				break;
+			}
+		}
+
+		if (page == NULL) {
+			return NULL;
+		}
+
+		if (page->dirty && (page_write_run(page) != 0)) {
+			return NULL;
+		}
+
+		page_free(page);
+	}
+
+	return ptr;
+}
+
+static struct disk_cache_page *page_new(struct disk_info *disk,
+					uint32_t sector, bool allow_dirty)
+{
+	struct disk_cache_page **bucket = page_bucket(disk, sector);
+	struct disk_cache_page *page;
+
+	page = cache_alloc(sizeof(*page) + disk->cache_sector_size,
+			   allow_dirty);
+	if (page == NULL) {
+		return NULL;
+	}
+
+	page->disk = disk;
+	page->sector = sector;
+	page->dirty = false;
+	page->next = *bucket;
+	*bucket = page;
+	sys_dlist_append(&lru, &page->node);
+
+	return page;
+}
+
+/* Write the run of consecutive modified sectors starting with first, in a
+ * single operation when there is room for a buffer. At least first is
+ * written when successful.
+ */
+static int page_write_run(struct disk_cache_page *first)
+{
+	struct disk_info *disk = first->disk;
+	uint32_t size = disk->cache_sector_size;
+	struct disk_cache_page *page;
+	uint32_t count = 1;
+	uint8_t *buf = NULL;
+	int rc;
+
+	while (count < DISK_CACHE_MAX_RUN) {
+		page = page_find(disk, first->sector + count);
+		if ((page == NULL) || !page->dirty) {
+			break;
+		}
+		count++;
+	}
+
+	/* The pages of the run are modified, they are not evicted */
+	for (; count > 1; count /= 2) {
+		buf = cache_alloc(count * size, false);
+		if (buf != NULL) {
+			break;
+		}
+	}
+
+	if (buf == NULL) {
+		rc = disk->ops->write(disk, first->data, first->sector, 1);
+		if (rc == 0) {
+			page_set_dirty(first, false);
+		}
+
+		return rc;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		page = page_find(disk, first->sector + i);
+		memcpy(buf + i * size, page->data, size);
+	}
+
+	rc = disk->ops->write(disk, buf, first->sector, count);
+	if (rc == 0) {
+		for (uint32_t i = 0; i < count; i++) {
+			page_set_dirty(page_find(disk, first->sector + i), false);
+		}
+	}
+
+	k_heap_free(&cache_heap, buf);
+
+	return rc;
+}
+
+/* Write the modified pages of a disk, or of all disks if disk is NULL, in
+ * increasing sector order.
+ */
+static int cache_flush(struct disk_info *disk)
+{
+	struct disk_cache_page *first;
+	struct disk_cache_page *page;
+	int rc;
+
+	do {
+		first = NULL;
+		SYS_DLIST_FOR_EACH_CONTAINER(&lru, page, node) {
+			if (!page->dirty ||
+			    ((disk != NULL) && (page->disk != disk))) {
+				continue;
+			}
+
+			if ((first == NULL) || ((page->disk == first->disk) &&
+						(page->sector < first->sector))) {
+				first = page;
+			}
+		}
+
+		if (first != NULL) {
+			rc = page_write_run(first);
+			if (rc != 0) {
+				LOG_ERR("Failed to write cached sectors (%d)",
+					rc);
+				return rc;
+			}
+		}
+	} while (first != NULL);
+
+	return 0;
+}
+
+/* Add sectors read from the disk, as long as clean pages can be evicted */
+static void cache_fill(struct disk_info *disk, const uint8_t *buf,
+		       uint32_t start_sector, uint32_t num_sector)
+{
+	uint32_t size = disk->cache_sector_size;
+	struct disk_cache_page *page;
+
+	for (uint32_t i = 0; i < num_sector; i++) {
+		page = page_new(disk, start_sector + i, false);
+		if (page == NULL) {
+			break;
+		}
+
+		memcpy(page->data, buf + i * size, size);
+	}
+}
+
+/* Read the sectors following a sequential read, unless the next one is
+ * already cached because of an earlier read-ahead.
+ */
+static void cache_read_ahead(struct disk_info *disk, uint32_t sector)
+{
+	uint32_t size = disk->cache_sector_size;
+	uint32_t count = 0;
+	uint8_t *buf;
+
+	while ((count < CONFIG_DISK_CACHE_READ_AHEAD) &&
+	       (sector + count < disk->cache_sector_count) &&
+	       (page_find(disk, sector + count) == NULL)) {
+		count++;
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	buf = cache_alloc(count * size, false);
+	if (buf == NULL) {
+		return;
+	}
+
+	if (disk->ops->read(disk, buf, sector, count) == 0) {
+		cache_fill(disk, buf, sector, count);
+	}
+
+	k_heap_free(&cache_heap, buf);
+}
+
+static int cache_setup(struct disk_info *disk)
+{
+	uint32_t size;
+	uint32_t count;
+	int rc;
+
+	if (disk->cache_sector_size != 0) {
+		return 0;
+	}
+
+	if (disk->ops->ioctl == NULL) {
+		return -ENOTSUP;
+	}
+
+	rc = disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE, &size);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT, &count);
+	if (rc != 0) {
+		return rc;
+	}
+
+	if ((size == 0) || (size > DISK_CACHE_MAX_ACCESS)) {
+		return -ENOTSUP;
+	}
+
+	disk->cache_sector_size = size;
+	disk->cache_sector_count = count;
+
+	return 0;
+}
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_page *page;
+	uint32_t size;
+	uint32_t run;
+	bool sequential;
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (cache_setup(disk) != 0) {
+		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		goto out;
+	}
+
+	size = disk->cache_sector_size;
+	sequential = (start_sector == disk->cache_next_read);
+	disk->cache_next_read = start_sector + num_sector;
+
+	if (num_sector * size > DISK_CACHE_MAX_ACCESS) {
+		/* Only modified sectors need to be copied, but clean ones
+		 * hold the same data.
+		 */
+		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		for (uint32_t i = 0; (rc == 0) && (i < num_sector); i++) {
+			page = page_find(disk, start_sector + i);
+			if (page != NULL) {
+				memcpy(data_buf + i * size, page->data, size);
+			}
+		}
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < num_sector; i += run) {
+		run = 1;
+		page = page_find(disk, start_sector + i);
+		if (page != NULL) {
+			memcpy(data_buf + i * size, page->data, size);
+			page_touch(page);
+			continue;
+		}
+
+		/* Read all the missing sectors in a row at once */
+		while ((i + run < num_sector) &&
+		       (page_find(disk, start_sector + i + run) == NULL)) {
+			run++;
+		}
+
+		rc = disk->ops->read(disk, data_buf + i * size,
+				     start_sector + i, run);
+		if (rc != 0) {
+			goto out;
+		}
+
+		cache_fill(disk, data_buf + i * size, start_sector + i, run);
+	}
+
+	if (sequential && (CONFIG_DISK_CACHE_READ_AHEAD > 0)) {
+		cache_read_ahead(disk, start_sector + num_sector);
+	}
+
+	rc = 0;
+out:
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_page *page;
+	uint32_t size;
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (cache_setup(disk) != 0) {
+		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		goto out;
+	}
+
+	size = disk->cache_sector_size;
+
+	if (!IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK) ||
+	    (num_sector * size > DISK_CACHE_MAX_ACCESS)) {
+		/* Write through, updating the sectors already cached */
+		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		for (uint32_t i = 0; (rc == 0) && (i < num_sector); i++) {
+			page = page_find(disk, start_sector + i);
+			if (page != NULL) {
+				memcpy(page->data, data_buf + i * size, size);
+				page_set_dirty(page, false);
+			}
+		}
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < num_sector; i++) {
+		page = page_find(disk, start_sector + i);
+		if (page == NULL) {
+			page = page_new(disk, start_sector + i, true);
+		}
+
+		if (page == NULL) {
+			rc = disk->ops->write(disk, data_buf + i * size,
+					      start_sector + i, 1);
+			if (rc != 0) {
+				goto out;
+			}
+			continue;
+		}
+
+		memcpy(page->data, data_buf + i * size, size);
+		page_set_dirty(page, true);
+		page_touch(page);
+	}
+
+	rc = 0;
+	if (dirty_bytes > DISK_CACHE_MAX_DIRTY) {
+		/* Leave room for clean pages and write buffers */
+		rc = cache_flush(NULL);
+	}
+
+out:
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_flush(struct disk_info *disk)
+{
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rc = cache_flush(disk);
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_drop(struct disk_info *disk)
+{
+	struct disk_cache_page *page;
+	struct disk_cache_page *next;
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* Sectors which could not be written are kept */
+	rc = cache_flush(disk);
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&lru, page, next, node) {
+		if ((page->disk == disk) && !page->dirty) {
+			page_free(page);
+		}
+	}
+
+	if (rc == 0) {
+		disk->cache_sector_size = 0;
+		disk->cache_next_read = 0;
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
@@ -0,0 +1,1043 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <zephyr/init.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/fs_sys.h>
+#include <zephyr/fs/compress_fs.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+
+#include <lz4.h>
+
+#include "fs_impl.h"
+
+LOG_MODULE_DECLARE(fs, CONFIG_FS_LOG_LEVEL);
+
+/*
+ * A file is stored in the backing file system as a sequence of blocks
+ * followed by a footer:
+ *
+ *   block:  raw_len (le16) | stored_len (le16) | stored_len bytes
+ *   footer: size (le32) | data_end (le32) | block_size (le16) |
+ *           version (le16) | magic (le32)
+ *
+ * Every block but the last one holds block_size bytes of data, compressed
+ * with LZ4 or stored as is when that is not smaller (stored_len == raw_len).
+ * data_end is the offset of the end of the full blocks, where the last,
+ * partial, block starts if there is one. An empty file has no footer.
+ *
+ * The footer is only written on sync and close, so a file is consistent
+ * as long as the backing file system commits file changes atomically on
+ * sync, as littlefs does.
+ */
+#define CFS_HDR_SIZE		4
+#define CFS_FOOTER_SIZE		16
+#define CFS_MAGIC		0x5346435aU	/* "ZCFS" */
+#define CFS_VERSION		1
+#define CFS_BLOCK_SIZE		CONFIG_FS_COMPRESS_BLOCK_SIZE
+#define CFS_NO_BLOCK		UINT32_MAX
+
+struct cfs_footer {
+	uint32_t size;
+	uint32_t data_end;
+	uint16_t block_size;
+};
+
+struct cfs_file {
+	struct fs_file_t bf;	/* File in the backing file system */
+	fs_mode_t flags;
+	uint16_t block_size;
+	bool dirty;		/* Backing file does not match the data */
+	uint32_t size;		/* Size of the uncompressed data */
+	uint32_t pos;		/* Position in the uncompressed data */
+	uint32_t blocks;	/* Number of full blocks */
+	uint32_t data_end;	/* Backing offset of the end of the full blocks */
+	uint32_t backing_len;	/* Length of the backing file */
+	uint32_t buf_block;	/* Block held in buf, the last one when dirty */
+	uint32_t buf_len;	/* Number of bytes of the block in buf */
+	/* Last block located, so that sequential reads skip the index */
+	uint32_t hint_block;
+	uint32_t hint_off;
+	/* Offsets of the blocks which are a multiple of 2^index_shift */
+	uint32_t index_cnt;
+	uint8_t index_shift;
+	uint32_t index[CONFIG_FS_COMPRESS_INDEX_SIZE];
+	uint8_t buf[CFS_BLOCK_SIZE];
+};
+
+struct cfs_dir {
+	struct fs_dir_t bd;	/* Directory in the backing file system */
+	char path[CONFIG_FS_COMPRESS_PATH_MAX];
+};
+
+K_MEM_SLAB_DEFINE_STATIC(cfs_file_pool, sizeof(struct cfs_file),
+			 CONFIG_FS_COMPRESS_NUM_FILES, 4);
+K_MEM_SLAB_DEFINE_STATIC(cfs_dir_pool, sizeof(struct cfs_dir),
+			 CONFIG_FS_COMPRESS_NUM_DIRS, 4);
+
+/* Compression state and stored block buffer, shared by all files */
+static K_MUTEX_DEFINE(cfs_lock);
+static LZ4_stream_t lz4_state;
+static uint8_t zbuf[CFS_HDR_SIZE + CFS_BLOCK_SIZE];
+/* Block read while the buffer of a file holds its unwritten last block */
+static uint8_t rbuf[CFS_BLOCK_SIZE];
+
+static int backing_path(const struct fs_mount_t *mp, const char *path,
+			char *out)
+{
+	const struct fs_compress *cfs = mp->fs_data;
+	size_t dir_len = strlen(cfs->backing_dir);
+	size_t path_len;
+
+	path = fs_impl_strip_prefix(path, mp);
+	if (strcmp(path, "/") == 0) {
+		path = "";
+	}
+
+	path_len = strlen(path);
+	if ((dir_len + path_len) >= CONFIG_FS_COMPRESS_PATH_MAX) {
+		return -ENAMETOOLONG;
+	}
+
+	memcpy(out, cfs->backing_dir, dir_len);
+	memcpy(&out[dir_len], path, path_len + 1);
+
+	return 0;
+}
+
+static int backing_length(struct fs_file_t *bf, uint32_t *len)
+{
+	off_t end;
+	int rc;
+
+	rc = fs_seek(bf, 0, FS_SEEK_END);
+	if (rc < 0) {
+		return rc;
+	}
+
+	end = fs_tell(bf);
+	if (end < 0) {
+		return end;
+	}
+
+	*len = end;
+
+	return 0;
+}
+
+static int footer_read(struct fs_file_t *bf, uint32_t len,
+		       struct cfs_footer *ft)
+{
+	uint8_t buf[CFS_FOOTER_SIZE];
+	ssize_t rc;
+
+	if (len == 0U) {
+		ft->size = 0U;
+		ft->data_end = 0U;
+		ft->block_size = CFS_BLOCK_SIZE;
+		return 0;
+	}
+
+	if (len < CFS_FOOTER_SIZE) {
+		return -EIO;
+	}
+
+	rc = fs_seek(bf, len - CFS_FOOTER_SIZE, FS_SEEK_SET);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = fs_read(bf, buf, sizeof(buf));
+	if (rc < 0) {
+		return rc;
+	}
+
+	if ((rc != sizeof(buf)) || (sys_get_le32(&buf[12]) != CFS_MAGIC) ||
+	    (sys_get_le16(&buf[10]) != CFS_VERSION)) {
+		LOG_ERR("Not a compressed file");
+		return -EIO;
+	}
+
+	ft->size = sys_get_le32(&buf[0]);
+	ft->data_end = sys_get_le32(&buf[4]);
+	ft->block_size = sys_get_le16(&buf[8]);
+
+	if ((ft->block_size == 0U) || (ft->block_size > CFS_BLOCK_SIZE)) {
+		LOG_ERR("Unsupported block size %u", ft->block_size);
+		return -ENOTSUP;
+	}
+
+	if (ft->data_end > (len - CFS_FOOTER_SIZE)) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int footer_write(struct cfs_file *f)
+{
+	uint8_t buf[CFS_FOOTER_SIZE];
+	ssize_t rc;
+
+	sys_put_le32(f->size, &buf[0]);
+	sys_put_le32(f->data_end, &buf[4]);
+	sys_put_le16(f->block_size, &buf[8]);
+	sys_put_le16(CFS_VERSION, &buf[10]);
+	sys_put_le32(CFS_MAGIC, &buf[12]);
+
+	rc = fs_write(&f->bf, buf, sizeof(buf));
+	if (rc < 0) {
+		return rc;
+	}
+
+	return (rc == sizeof(buf)) ? 0 : -ENOSPC;
+}
+
+/* Size of the data of a compressed file, from its footer */
+static int backing_file_size(const char *path, size_t *size)
+{
+	struct fs_file_t bf;
+	struct cfs_footer ft;
+	uint32_t len;
+	int rc;
+
+	fs_file_t_init(&bf);
+
+	rc = fs_open(&bf, path, FS_O_READ);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = backing_length(&bf, &len);
+	if (rc == 0) {
+		rc = footer_read(&bf, len, &ft);
+	}
+
+	(void)fs_close(&bf);
+
+	if (rc == 0) {
+		*size = ft.size;
+	}
+
+	return rc;
+}
+
+static void index_reset(struct cfs_file *f)
+{
+	f->index[0] = 0U;
+	f->index_cnt = 1U;
+	f->index_shift = 0U;
+	f->hint_block = 0U;
+	f->hint_off = 0U;
+}
+
+/* Record the offset of a block if it is the next one to be indexed */
+static void index_add(struct cfs_file *f, uint32_t block, uint32_t off)
+{
+	uint32_t i;
+
+	if (((block & (BIT(f->index_shift) - 1U)) != 0U) ||
+	    ((block >> f->index_shift) != f->index_cnt)) {
+		return;
+	}
+
+	if (f->index_cnt == CONFIG_FS_COMPRESS_INDEX_SIZE) {
+		/* Full, keep every second entry */
+		for (i = 1U; (2U * i) < f->index_cnt; i++) {
+			f->index[i] = f->index[2U * i];
+		}
+		f->index_cnt = (f->index_cnt + 1U) / 2U;
+		f->index_shift++;
+
+		if (((block & (BIT(f->index_shift) - 1U)) != 0U) ||
+		    ((block >> f->index_shift) != f->index_cnt)) {
+			return;
+		}
+	}
+
+	f->index[f->index_cnt++] = off;
+}
+
+/* Find the offset of a block in the backing file */
+static int block_locate(struct cfs_file *f, uint32_t block, uint32_t *off)
+{
+	uint8_t hdr[CFS_HDR_SIZE];
+	uint32_t cur_off;
+	uint32_t cur;
+	uint32_t i;
+	ssize_t rc;
+
+	if (block >= f->blocks) {
+		*off = f->data_end;
+		return 0;
+	}
+
+	i = MIN(block >> f->index_shift, f->index_cnt - 1U);
+	cur = i << f->index_shift;
+	cur_off = f->index[i];
+
+	if ((f->hint_block > cur) && (f->hint_block <= block)) {
+		cur = f->hint_block;
+		cur_off = f->hint_off;
+	}
+
+	/* Walk the block headers from the closest known block */
+	while (cur < block) {
+		rc = fs_seek(&f->bf, cur_off, FS_SEEK_SET);
+		if (rc < 0) {
+			return rc;
+		}
+
+		rc = fs_read(&f->bf, hdr, sizeof(hdr));
+		if (rc < 0) {
+			return rc;
+		}
+
+		if (rc != sizeof(hdr)) {
+			return -EIO;
+		}
+
+		cur_off += CFS_HDR_SIZE + sys_get_le16(&hdr[2]);
+		cur++;
+		index_add(f, cur, cur_off);
+	}
+
+	f->hint_block = cur;
+	f->hint_off = cur_off;
+	*off = cur_off;
+
+	return 0;
+}
+
+/*
+ * Read and decompress a block to dst, which must be large enough for its
+ * data. Returns the number of bytes of the block.
+ */
+static ssize_t block_read(struct cfs_file *f, uint32_t block, uint8_t *dst)
+{
+	uint8_t hdr[CFS_HDR_SIZE];
+	uint32_t expected;
+	uint32_t stored;
+	uint32_t raw;
+	uint32_t off;
+	ssize_t rc;
+
+	rc = block_locate(f, block, &off);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = fs_seek(&f->bf, off, FS_SEEK_SET);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = fs_read(&f->bf, hdr, sizeof(hdr));
+	if (rc < 0) {
+		return rc;
+	}
+
+	raw = sys_get_le16(&hdr[0]);
+	stored = sys_get_le16(&hdr[2]);
+	expected = (block < f->blocks) ? f->block_size :
+		   (f->size - (f->blocks * f->block_size));
+
+	if ((rc != sizeof(hdr)) || (raw != expected) || (stored > raw)) {
+		LOG_ERR("Corrupted block %u", block);
+		return -EIO;
+	}
+
+	if (stored == raw) {
+		rc = fs_read(&f->bf, dst, raw);
+		return (rc < 0) ? rc : ((rc == raw) ? raw : -EIO);
+	}
+
+	k_mutex_lock(&cfs_lock, K_FOREVER);
+
+	rc = fs_read(&f->bf, zbuf, stored);
+	if (rc == stored) {
+		rc = LZ4_decompress_safe((const char *)zbuf, (char *)dst,
+					 stored, raw);
+		rc = (rc == raw) ? raw : -EIO;
+	} else if (rc >= 0) {
+		rc = -EIO;
+	}
+
+	k_mutex_unlock(&cfs_lock);
+
+	return rc;
+}
+
+/*
+ * Copy len bytes from offset in of a block to dst, without replacing the
+ * block held in the buffer of the file.
+ */
+static ssize_t block_read_part(struct cfs_file *f, uint32_t block, uint32_t in,
+			       uint8_t *dst, size_t len)
+{
+	ssize_t rc;
+
+	k_mutex_lock(&cfs_lock, K_FOREVER);
+
+	rc = block_read(f, block, rbuf);
+	if (rc >= 0) {
+		memcpy(dst, &rbuf[in], len);
+		rc = len;
+	}
+
+	k_mutex_unlock(&cfs_lock);
+
+	return rc;
+}
+
+/*
+ * Compress and write a block at the current position of the backing file.
+ * Returns the number of bytes written to the backing file.
+ */
+static ssize_t block_write(struct cfs_file *f, const uint8_t *data,
+			   uint32_t len)
+{
+	ssize_t rc;
+	int stored;
+
+	k_mutex_lock(&cfs_lock, K_FOREVER);
+
+	stored = LZ4_compress_fast_extState(&lz4_state, (const char *)data,
+					    (char *)&zbuf[CFS_HDR_SIZE], len,
+					    len - 1,
+					    CONFIG_FS_COMPRESS_ACCELERATION);
+	if (stored <= 0) {
+		/* Does not compress */
+		memcpy(&zbuf[CFS_HDR_SIZE], data, len);
+		stored = len;
+	}
+
+	sys_put_le16(len, &zbuf[0]);
+	sys_put_le16(stored, &zbuf[2]);
+
+	rc = fs_write(&f->bf, zbuf, CFS_HDR_SIZE + stored);
+	if ((rc >= 0) && (rc != (CFS_HDR_SIZE + stored))) {
+		rc = -ENOSPC;
+	}
+
+	k_mutex_unlock(&cfs_lock);
+
+	return rc;
+}
+
+/* Drop what follows the full blocks in the backing file */
+static int backing_trim(struct cfs_file *f)
+{
+	int rc;
+
+	if (f->backing_len > f->data_end) {
+		rc = fs_truncate(&f->bf, f->data_end);
+		if (rc < 0) {
+			return rc;
+		}
+
+		f->backing_len = f->data_end;
+	}
+
+	return fs_seek(&f->bf, f->data_end, FS_SEEK_SET);
+}
+
+/* Write the last block and the footer */
+static int cfs_commit(struct cfs_file *f)
+{
+	ssize_t rc;
+
+	if (!f->dirty) {
+		return 0;
+	}
+
+	rc = backing_trim(f);
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (f->size > 0U) {
+		/* Length unknown until the footer is written */
+		f->backing_len = UINT32_MAX;
+
+		if (f->buf_len > 0U) {
+			rc = block_write(f, f->buf, f->buf_len);
+			if (rc < 0) {
+				return rc;
+			}
+		}
+
+		rc = footer_write(f);
+		if (rc < 0) {
+			return rc;
+		}
+
+		rc = backing_length(&f->bf, &f->backing_len);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	f->dirty = false;
+
+	return 0;
+}
+
+/* Write the buffer, which holds a full block */
+static int cfs_flush_block(struct cfs_file *f)
+{
+	ssize_t rc;
+
+	rc = backing_trim(f);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = block_write(f, f->buf, f->buf_len);
+	if (rc < 0) {
+		f->backing_len = UINT32_MAX;
+		return rc;
+	}
+
+	f->data_end += rc;
+	f->backing_len = f->data_end;
+	f->blocks++;
+	index_add(f, f->blocks, f->data_end);
+
+	f->buf_block = f->blocks;
+	f->buf_len = 0U;
+
+	return 0;
+}
+
+/* Get a block in the buffer */
+static int cfs_load(struct cfs_file *f, uint32_t block)
+{
+	ssize_t rc;
+
+	if (f->buf_block == block) {
+		return 0;
+	}
+
+	/* The last block is only in the buffer while the file is dirty */
+	rc = cfs_commit(f);
+	if (rc < 0) {
+		return rc;
+	}
+
+	f->buf_block = CFS_NO_BLOCK;
+	f->buf_len = 0U;
+
+	if ((block == f->blocks) && ((f->size % f->block_size) == 0U)) {
+		rc = 0;
+	} else {
+		rc = block_read(f, block, f->buf);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	f->buf_block = block;
+	f->buf_len = rc;
+
+	return 0;
+}
+
+static int cfs_open(struct fs_file_t *fp, const char *path, fs_mode_t zflags)
+{
+	char bpath[CONFIG_FS_COMPRESS_PATH_MAX];
+	struct cfs_footer ft;
+	struct cfs_file *f;
+	uint32_t len;
+	int rc;
+
+	rc = backing_path(fp->mp, path, bpath);
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (k_mem_slab_alloc(&cfs_file_pool, &fp->filep, K_NO_WAIT) != 0) {
+		return -ENOMEM;
+	}
+
+	f = fp->filep;
+	memset(f, 0, offsetof(struct cfs_file, buf));
+	fs_file_t_init(&f->bf);
+
+	/* The last block is read back to append to it */
+	rc = fs_open(&f->bf, bpath,
+		     FS_O_READ | (zflags & (FS_O_WRITE | FS_O_CREATE)));
+	if (rc < 0) {
+		goto out;
+	}
+
+	rc = backing_length(&f->bf, &len);
+	if (rc == 0) {
+		rc = footer_read(&f->bf, len, &ft);
+	}
+
+	if (rc < 0) {
+		(void)fs_close(&f->bf);
+		goto out;
+	}
+
+	f->flags = zflags;
+	f->block_size = ft.block_size;
+	f->size = ft.size;
+	f->blocks = ft.size / ft.block_size;
+	f->data_end = ft.data_end;
+	f->backing_len = len;
+	f->buf_block = CFS_NO_BLOCK;
+	index_reset(f);
+
+	return 0;
+
+out:
+	k_mem_slab_free(&cfs_file_pool, &fp->filep);
+	fp->filep = NULL;
+
+	return rc;
+}
+
+static int cfs_close(struct fs_file_t *fp)
+{
+	struct cfs_file *f = fp->filep;
+	int rc;
+	int close_rc;
+
+	rc = cfs_commit(f);
+	close_rc = fs_close(&f->bf);
+
+	k_mem_slab_free(&cfs_file_pool, &fp->filep);
+	fp->filep = NULL;
+
+	return (rc < 0) ? rc : close_rc;
+}
+
+static ssize_t cfs_read(struct fs_file_t *fp, void *ptr, size_t len)
+{
+	struct cfs_file *f = fp->filep;
+	uint8_t *dst = ptr;
+	size_t done = 0;
+	uint32_t block;
+	uint32_t raw;
+	uint32_t in;
+	size_t n;
+	ssize_t rc;
+
+	if ((f->flags & FS_O_READ) == 0) {
+		return -EBADF;
+	}
+
+	len = MIN(len, f->size - f->pos);
+
+	while (done < len) {
+		block = f->pos / f->block_size;
+		in = f->pos % f->block_size;
+		raw = MIN(f->block_size, f->size - (block * f->block_size));
+
+		if ((f->buf_block != block) && (in == 0U) &&
+		    ((len - done) >= raw)) {
+			/* Whole block wanted, decompress it to the caller */
+			rc = block_read(f, block, &dst[done]);
+			if (rc < 0) {
+				return rc;
+			}
+		} else if ((f->buf_block != block) && f->dirty) {
+			/* Loading the block would write the last one first */
+			rc = block_read_part(f, block, in, &dst[done],
+					     MIN(len - done, raw - in));
+			if (rc < 0) {
+				return rc;
+			}
+		} else {
+			rc = cfs_load(f, block);
+			if (rc < 0) {
+				return rc;
+			}
+
+			rc = MIN(len - done, raw - in);
+			memcpy(&dst[done], &f->buf[in], rc);
+		}
+
+		n = rc;
+		f->pos += n;
+		done += n;
+	}
+
+	return done;
+}
+
+static ssize_t cfs_write(struct fs_file_t *fp, const void *ptr, size_t len)
+{
+	struct cfs_file *f = fp->filep;
+	const uint8_t *src = ptr;
+	size_t done = 0;
+	size_t n;
+	int rc;
+
+	if ((f->flags & FS_O_WRITE) == 0) {
+		return -EBADF;
+	}
+
+	if ((f->flags & FS_O_APPEND) != 0) {
+		f->pos = f->size;
+	}
+
+	/* Blocks can not be rewritten */
+	if (f->pos != f->size) {
+		return -ENOTSUP;
+	}
+
+	rc = cfs_load(f, f->blocks);
+	if (rc < 0) {
+		return rc;
+	}
+
+	while (done < len) {
+		n = MIN(len - done, f->block_size - f->buf_len);
+		memcpy(&f->buf[f->buf_len], &src[done], n);
+		f->buf_len += n;
+		f->size += n;
+		f->pos += n;
+		f->dirty = true;
+		done += n;
+
+		if (f->buf_len == f->block_size) {
+			rc = cfs_flush_block(f);
+			if (rc < 0) {
+				return rc;
+			}
+		}
+	}
+
+	return done;
+}
+
+static int cfs_seek(struct fs_file_t *fp, off_t off, int whence)
+{
+	struct cfs_file *f = fp->filep;
+	int64_t pos;
+
+	switch (whence) {
+	case FS_SEEK_SET:
+		pos = off;
+		break;
+	case FS_SEEK_CUR:
+		pos = (int64_t)f->pos + off;
+		break;
+	case FS_SEEK_END:
+		pos = (int64_t)f->size + off;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if ((pos < 0) || (pos > f->size)) {
+		return -EINVAL;
+	}
+
+	f->pos = pos;
+
+	return 0;
+}
+
+static off_t cfs_tell(struct fs_file_t *fp)
+{
+	struct cfs_file *f = fp->filep;
+
+	return f->pos;
+}
+
+static int cfs_truncate(struct fs_file_t *fp, off_t length)
+{
+	static const uint8_t zeros[16];
+	struct cfs_file *f = fp->filep;
+	uint32_t block;
+	uint32_t off;
+	uint32_t pos;
+	ssize_t rc = 0;
+
+	if ((f->flags & FS_O_WRITE) == 0) {
+		return -EBADF;
+	}
+
+	if ((length < 0) || ((uint64_t)length > UINT32_MAX)) {
+		return -EINVAL;
+	}
+
+	if (length > f->size) {
+		/* Extend with zeros, without moving the position */
+		pos = f->pos;
+		f->pos = f->size;
+		while ((rc >= 0) && (f->size < length)) {
+			rc = cfs_write(fp, zeros,
+				       MIN(sizeof(zeros), length - f->size));
+		}
+		f->pos = pos;
+
+		return (rc < 0) ? rc : 0;
+	}
+
+	if (length == f->size) {
+		return 0;
+	}
+
+	block = length / f->block_size;
+	if ((length % f->block_size) != 0U) {
+		rc = cfs_load(f, block);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	rc = block_locate(f, block, &off);
+	if (rc < 0) {
+		return rc;
+	}
+
+	/* The block holding the new end becomes the last one */
+	f->size = length;
+	f->blocks = block;
+	f->data_end = off;
+	f->buf_block = block;
+	f->buf_len = length % f->block_size;
+	f->pos = MIN(f->pos, length);
+	f->dirty = true;
+
+	f->index_cnt = MIN(f->index_cnt, (block >> f->index_shift) + 1U);
+	if (f->hint_block > block) {
+		f->hint_block = 0U;
+		f->hint_off = 0U;
+	}
+
+	return 0;
+}
+
+static int cfs_sync(struct fs_file_t *fp)
+{
+	struct cfs_file *f = fp->filep;
+	int rc;
+
+	rc = cfs_commit(f);
+	if (rc < 0) {
+		return rc;
+	}
+
+	return fs_sync(&f->bf);
+}
+
+static int cfs_opendir(struct fs_dir_t *dp, const char *path)
+{
+	struct cfs_dir *d;
+	int rc;
+
+	if (k_mem_slab_alloc(&cfs_dir_pool, &dp->dirp, K_NO_WAIT) != 0) {
+		return -ENOMEM;
+	}
+
+	d = dp->dirp;
+	fs_dir_t_init(&d->bd);
+
+	rc = backing_path(dp->mp, path, d->path);
+	if (rc == 0) {
+		rc = fs_opendir(&d->bd, d->path);
+	}
+
+	if (rc < 0) {
+		k_mem_slab_free(&cfs_dir_pool, &dp->dirp);
+		dp->dirp = NULL;
+	}
+
+	return rc;
+}
+
+static int cfs_readdir(struct fs_dir_t *dp, struct fs_dirent *entry)
+{
+	char bpath[CONFIG_FS_COMPRESS_PATH_MAX];
+	struct cfs_dir *d = dp->dirp;
+	size_t dir_len = strlen(d->path);
+	size_t name_len;
+	int rc;
+
+	rc = fs_readdir(&d->bd, entry);
+	if ((rc < 0) || (entry->name[0] == '\0') ||
+	    (entry->type != FS_DIR_ENTRY_FILE)) {
+		return rc;
+	}
+
+	/* Report the size of the data rather than the stored one */
+	name_len = strlen(entry->name);
+	if ((dir_len + 1 + name_len) >= sizeof(bpath)) {
+		return -ENAMETOOLONG;
+	}
+
+	memcpy(bpath, d->path, dir_len);
+	bpath[dir_len] = '/';
+	memcpy(&bpath[dir_len + 1], entry->name, name_len + 1);
+
+	return backing_file_size(bpath, &entry->size);
+}
+
+static int cfs_closedir(struct fs_dir_t *dp)
+{
+	struct cfs_dir *d = dp->dirp;
+	int rc;
+
+	rc = fs_closedir(&d->bd);
+
+	k_mem_slab_free(&cfs_dir_pool, &dp->dirp);
+	dp->dirp = NULL;
+
+	return rc;
+}
+
+static int cfs_mount(struct fs_mount_t *mountp)
+{
+	const struct fs_compress *cfs = mountp->fs_data;
+	size_t mnt_len = strlen(mountp->mnt_point);
+	struct fs_dirent entry;
+	size_t len;
+	int rc;
+
+	if ((cfs == NULL) || (cfs->backing_dir == NULL) ||
+	    (cfs->backing_dir[0] != '/')) {
+		return -EINVAL;
+	}
+
+	len = strlen(cfs->backing_dir);
+	if ((len < 2) || (len >= CONFIG_FS_COMPRESS_PATH_MAX) ||
+	    (cfs->backing_dir[len - 1] == '/')) {
+		LOG_ERR("Invalid backing directory %s", cfs->backing_dir);
+		return -EINVAL;
+	}
+
+	/* Files would be stored in themselves */
+	if ((strncmp(cfs->backing_dir, mountp->mnt_point, mnt_len) == 0) &&
+	    ((cfs->backing_dir[mnt_len] == '\0') ||
+	     (cfs->backing_dir[mnt_len] == '/'))) {
+		LOG_ERR("Backing directory in mount point %s",
+			mountp->mnt_point);
+		return -EINVAL;
+	}
+
+	rc = fs_stat(cfs->backing_dir, &entry);
+	if (rc == -ENOENT) {
+		rc = fs_mkdir(cfs->backing_dir);
+	} else if ((rc == 0) && (entry.type != FS_DIR_ENTRY_DIR)) {
+		rc = -ENOTDIR;
+	}
+
+	return rc;
+}
+
+static int cfs_unmount(struct fs_mount_t *mountp)
+{
+	return 0;
+}
+
+static int cfs_unlink(struct fs_mount_t *mountp, const char *path)
+{
+	char bpath[CONFIG_FS_COMPRESS_PATH_MAX];
+	int rc;
+
+	rc = backing_path(mountp, path, bpath);
+	if (rc < 0) {
+		return rc;
+	}
+
+	return fs_unlink(bpath);
+}
+
+static int cfs_rename(struct fs_mount_t *mountp, const char *from,
+		      const char *to)
+{
+	char bfrom[CONFIG_FS_COMPRESS_PATH_MAX];
+	char bto[CONFIG_FS_COMPRESS_PATH_MAX];
+	int rc;
+
+	rc = backing_path(mountp, from, bfrom);
+	if (rc == 0) {
+		rc = backing_path(mountp, to, bto);
+	}
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	return fs_rename(bfrom, bto);
+}
+
+static int cfs_mkdir(struct fs_mount_t *mountp, const char *path)
+{
+	char bpath[CONFIG_FS_COMPRESS_PATH_MAX];
+	int rc;
+
+	rc = backing_path(mountp, path, bpath);
+	if (rc < 0) {
+		return rc;
+	}
+
+	return fs_mkdir(bpath);
+}
+
+static int cfs_stat(struct fs_mount_t *mountp, const char *path,
+		    struct fs_dirent *entry)
+{
+	char bpath[CONFIG_FS_COMPRESS_PATH_MAX];
+	int rc;
+
+	rc = backing_path(mountp, path, bpath);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = fs_stat(bpath, entry);
+	if ((rc < 0) || (entry->type != FS_DIR_ENTRY_FILE)) {
+		return rc;
+	}
+
+	return backing_file_size(bpath, &entry->size);
+}
+
+static int cfs_statvfs(struct fs_mount_t *mountp, const char *path,
+		       struct fs_statvfs *stat)
+{
+	const struct fs_compress *cfs = mountp->fs_data;
+
+	return fs_statvfs(cfs->backing_dir, stat);
+}
+
+/* File system interface */
+static const struct fs_file_system_t compress_fs = {
+	.open = cfs_open,
+	.close = cfs_close,
+	.read = cfs_read,
+	.write = cfs_write,
+	.lseek = cfs_seek,
+	.tell = cfs_tell,
+	.truncate = cfs_truncate,
+	.sync = cfs_sync,
+	.opendir = cfs_opendir,
+	.readdir = cfs_readdir,
+	.closedir = cfs_closedir,
+	.mount = cfs_mount,
+	.unmount = cfs_unmount,
+	.unlink = cfs_unlink,
+	.rename = cfs_rename,
+	.mkdir = cfs_mkdir,
+	.stat = cfs_stat,
+	.statvfs = cfs_statvfs,
+};
+
+static int compress_fs_init(void)
+{
+	return fs_register(FS_COMPRESS, &compress_fs);
+}
+
+SYS_INIT(compress_fs_init, POST_KERNEL, 99);
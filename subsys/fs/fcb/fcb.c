@@ -120,6 +120,8 @@ fcb_init(int f_area_id, struct fcb *fcb)
 		return -EINVAL;
 	}
 
+	fcb_index_clear(fcb);
+
 	/* Fill last used, first used */
 	for (i = 0; i < fcb->f_sector_cnt; i++) {
 		sector = &fcb->f_sectors[i];
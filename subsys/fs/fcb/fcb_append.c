@@ -8,6 +8,8 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <zephyr/sys/crc.h>
+
 #include <zephyr/fs/fcb.h>
 #include "fcb_priv.h"
 
@@ -56,10 +58,33 @@ fcb_append_to_scratch(struct fcb *fcb)
 	return 0;
 }
 
+/*
+ * Make the next sector active, for an element taking len bytes in flash.
+ */
+static int
+fcb_append_new_sector(struct fcb *fcb, int len)
+{
+	struct flash_sector *sector;
+	int rc;
+
+	sector = fcb_new_sector(fcb, fcb->f_scratch_cnt);
+	if (!sector || (sector->fs_size <
+		fcb_len_in_flash(fcb, sizeof(struct fcb_disk_area)) + len)) {
+		return -ENOSPC;
+	}
+	rc = fcb_sector_hdr_init(fcb, sector, fcb->f_active_id + 1);
+	if (rc) {
+		return rc;
+	}
+	fcb->f_active.fe_sector = sector;
+	fcb->f_active.fe_elem_off = fcb_len_in_flash(fcb, sizeof(struct fcb_disk_area));
+	fcb->f_active_id++;
+	return 0;
+}
+
 int
 fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
 {
-	struct flash_sector *sector;
 	struct fcb_entry *active;
 	int cnt;
 	int rc;
@@ -83,19 +108,10 @@ fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
 	}
 	active = &fcb->f_active;
 	if (active->fe_elem_off + len + cnt > active->fe_sector->fs_size) {
-		sector = fcb_new_sector(fcb, fcb->f_scratch_cnt);
-		if (!sector || (sector->fs_size <
-			fcb_len_in_flash(fcb, sizeof(struct fcb_disk_area)) + len + cnt)) {
-			rc = -ENOSPC;
-			goto err;
-		}
-		rc = fcb_sector_hdr_init(fcb, sector, fcb->f_active_id + 1);
+		rc = fcb_append_new_sector(fcb, len + cnt);
 		if (rc) {
 			goto err;
 		}
-		fcb->f_active.fe_sector = sector;
-		fcb->f_active.fe_elem_off = fcb_len_in_flash(fcb, sizeof(struct fcb_disk_area));
-		fcb->f_active_id++;
 	}
 
 	rc = fcb_flash_write(fcb, active->fe_sector, active->fe_elem_off, tmp_str, cnt);
@@ -117,6 +133,58 @@ err:
 	return rc;
 }
 
+bool
+fcb_append_fits(struct fcb *fcb, const uint16_t *lens, int cnt)
+{
+	struct flash_sector *sector;
+	uint32_t off;
+	uint32_t len;
+	int free_cnt;
+	bool fits = true;
+	int i;
+
+	if (k_mutex_lock(&fcb->f_mtx, K_FOREVER)) {
+		return false;
+	}
+
+	sector = fcb->f_active.fe_sector;
+	off = fcb->f_active.fe_elem_off;
+	free_cnt = fcb_free_sector_cnt(fcb);
+
+	/* Place the elements the same way as fcb_append() would */
+	for (i = 0; i < cnt; i++) {
+		if (lens[i] >= FCB_MAX_LEN) {
+			fits = false;
+			break;
+		}
+
+		len = fcb_len_in_flash(fcb, (lens[i] < 0x80) ? 1 : 2) +
+		      fcb_len_in_flash(fcb, lens[i]) +
+		      fcb_len_in_flash(fcb, FCB_CRC_SZ);
+
+		if (off + len > sector->fs_size) {
+			if (free_cnt <= fcb->f_scratch_cnt) {
+				fits = false;
+				break;
+			}
+
+			sector = fcb_getnext_sector(fcb, sector);
+			free_cnt--;
+			off = fcb_len_in_flash(fcb, sizeof(struct fcb_disk_area));
+			if (off + len > sector->fs_size) {
+				fits = false;
+				break;
+			}
+		}
+
+		off += len;
+	}
+
+	k_mutex_unlock(&fcb->f_mtx);
+
+	return fits;
+}
+
 int
 fcb_append_finish(struct fcb *fcb, struct fcb_entry *loc)
 {
@@ -136,5 +204,192 @@ fcb_append_finish(struct fcb *fcb, struct fcb_entry *loc)
 	if (rc) {
 		return -EIO;
 	}
+
+	if (IS_ENABLED(CONFIG_FCB_INDEX) &&
+	    k_mutex_lock(&fcb->f_mtx, K_FOREVER) == 0) {
+		fcb_index_add(fcb, loc);
+		k_mutex_unlock(&fcb->f_mtx);
+	}
 	return 0;
 }
+
+/*
+ * Elements of a batch are packed in a buffer, written to flash when full or
+ * when the batch moves to another sector. The buffer size and all the parts
+ * of an element are multiples of the write alignment.
+ */
+struct fcb_batch {
+	struct fcb *fcb;
+	struct flash_sector *sector;
+	uint32_t off;
+	size_t fill;
+	size_t size;
+	uint8_t *buf;
+};
+
+static int
+fcb_batch_flush(struct fcb_batch *b)
+{
+	int rc;
+
+	if (b->fill == 0) {
+		return 0;
+	}
+
+	rc = fcb_flash_write(b->fcb, b->sector, b->off, b->buf, b->fill);
+	if (rc) {
+		/* Some of the elements indexed may not have been written */
+		fcb_index_drop(b->fcb, b->sector);
+		return -EIO;
+	}
+
+	b->off += b->fill;
+	b->fill = 0;
+	return 0;
+}
+
+/*
+ * Add len bytes to the batch, padded up to len_in_flash bytes.
+ */
+static int
+fcb_batch_put(struct fcb_batch *b, const uint8_t *src, size_t len,
+	      size_t len_in_flash, uint8_t pad)
+{
+	size_t chunk;
+	size_t copy;
+	int rc;
+
+	while (len_in_flash > 0) {
+		if (b->fill == b->size) {
+			rc = fcb_batch_flush(b);
+			if (rc) {
+				return rc;
+			}
+		}
+
+		chunk = MIN(len_in_flash, b->size - b->fill);
+		copy = MIN(chunk, len);
+		memcpy(&b->buf[b->fill], src, copy);
+		memset(&b->buf[b->fill + copy], pad, chunk - copy);
+
+		src += copy;
+		len -= copy;
+		b->fill += chunk;
+		len_in_flash -= chunk;
+	}
+
+	return 0;
+}
+
+static uint8_t
+fcb_batch_endmarker(struct fcb *fcb, const uint8_t *hdr, int hdr_len,
+		    const void *data, uint16_t len)
+{
+	uint8_t crc8;
+
+#ifdef CONFIG_FCB_ALLOW_FIXED_ENDMARKER
+	if (fcb->f_flags & FCB_FLAGS_CRC_DISABLED) {
+		return FCB_FIXED_ENDMARKER;
+	}
+#endif
+
+	crc8 = crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, hdr, hdr_len);
+	return crc8_ccitt(crc8, data, len);
+}
+
+int
+fcb_append_batch(struct fcb *fcb, const void *const *data,
+		 const uint16_t *lens, int cnt)
+{
+	uint8_t buf[CONFIG_FCB_APPEND_BATCH_BUF_SIZE];
+	struct fcb_batch b;
+	struct fcb_entry loc;
+	uint8_t hdr[2];
+	uint8_t em;
+	int hdr_len;
+	int len;
+	int rc;
+	int i;
+
+	rc = k_mutex_lock(&fcb->f_mtx, K_FOREVER);
+	if (rc) {
+		return -EINVAL;
+	}
+
+	b.fcb = fcb;
+	b.sector = fcb->f_active.fe_sector;
+	b.off = fcb->f_active.fe_elem_off;
+	b.fill = 0;
+	b.size = sizeof(buf) - (sizeof(buf) % fcb->f_align);
+	b.buf = buf;
+
+	if (b.size == 0) {
+		k_mutex_unlock(&fcb->f_mtx);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < cnt; i++) {
+		hdr_len = fcb_put_len(fcb, hdr, lens[i]);
+		if (hdr_len < 0) {
+			rc = hdr_len;
+			break;
+		}
+
+		len = fcb_len_in_flash(fcb, hdr_len) +
+		      fcb_len_in_flash(fcb, lens[i]) +
+		      fcb_len_in_flash(fcb, FCB_CRC_SZ);
+
+		if (b.off + b.fill + len > b.sector->fs_size) {
+			rc = fcb_batch_flush(&b);
+			if (rc) {
+				break;
+			}
+			fcb->f_active.fe_elem_off = b.off;
+
+			rc = fcb_append_new_sector(fcb, len);
+			if (rc) {
+				break;
+			}
+			b.sector = fcb->f_active.fe_sector;
+			b.off = fcb->f_active.fe_elem_off;
+		}
+
+		loc.fe_sector = b.sector;
+		loc.fe_elem_off = b.off + b.fill;
+		loc.fe_data_off = loc.fe_elem_off + fcb_len_in_flash(fcb, hdr_len);
+		loc.fe_data_len = lens[i];
+
+		em = fcb_batch_endmarker(fcb, hdr, hdr_len, data[i], lens[i]);
+
+		rc = fcb_batch_put(&b, hdr, hdr_len,
+				   fcb_len_in_flash(fcb, hdr_len),
+				   fcb->f_erase_value);
+		if (!rc) {
+			rc = fcb_batch_put(&b, data[i], lens[i],
+					   fcb_len_in_flash(fcb, lens[i]),
+					   fcb->f_erase_value);
+		}
+		if (!rc) {
+			/* Padded the same way as by fcb_append_finish() */
+			rc = fcb_batch_put(&b, &em, sizeof(em),
+					   fcb_len_in_flash(fcb, FCB_CRC_SZ),
+					   0xFF);
+		}
+		if (rc) {
+			break;
+		}
+
+		fcb_index_add(fcb, &loc);
+	}
+
+	if (!rc) {
+		rc = fcb_batch_flush(&b);
+	}
+	if (b.sector == fcb->f_active.fe_sector) {
+		fcb->f_active.fe_elem_off = b.off;
+	}
+
+	k_mutex_unlock(&fcb->f_mtx);
+
+	return rc;
+}
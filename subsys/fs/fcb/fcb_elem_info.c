@@ -10,8 +10,6 @@
 #include <zephyr/fs/fcb.h>
 #include "fcb_priv.h"
 
-#define FCB_FIXED_ENDMARKER 0xab
-
 /*
  * Given offset in flash sector, fill in rest of the fcb_entry, and crc8 over
  * the data.
@@ -124,6 +122,10 @@ int fcb_elem_info(struct fcb *_fcb, struct fcb_entry *loc)
 	uint8_t fl_em;
 	off_t off;
 
+	if (fcb_index_get(_fcb, loc)) {
+		return 0;
+	}
+
 	rc = fcb_elem_endmarker(_fcb, loc, &em);
 	if (rc) {
 		return rc;
@@ -145,5 +147,7 @@ int fcb_elem_info(struct fcb *_fcb, struct fcb_entry *loc)
 	if (fl_em != em) {
 		return -EBADMSG;
 	}
+
+	fcb_index_add(_fcb, loc);
 	return 0;
 }
@@ -0,0 +1,120 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/fs/fcb.h>
+#include "fcb_priv.h"
+
+/*
+ * The index is a hash table of the entries known to be valid, keyed by their
+ * location. An entry is looked up in a few consecutive slots; when none is
+ * free, the first one is replaced. Entries can not become invalid without
+ * their sector being erased, so only erases drop index entries.
+ */
+#define FCB_INDEX_PROBES	4
+#define FCB_INDEX_UNUSED	UINT16_MAX
+
+static uint32_t
+fcb_index_slot(const struct fcb *fcb, uint8_t sector, uint32_t elem_off)
+{
+	return ((elem_off * 2654435761U) ^ (sector * 40503U)) %
+	       fcb->f_index_cnt;
+}
+
+static bool
+fcb_index_match(const struct fcb_index_entry *ie, uint8_t sector,
+		uint32_t elem_off)
+{
+	return (ie->ie_data_len != FCB_INDEX_UNUSED) &&
+	       (ie->ie_sector == sector) && (ie->ie_elem_off == elem_off);
+}
+
+void
+fcb_index_clear(struct fcb *fcb)
+{
+	if (fcb->f_index == NULL) {
+		return;
+	}
+
+	(void)memset(fcb->f_index, 0xff,
+		     fcb->f_index_cnt * sizeof(fcb->f_index[0]));
+}
+
+bool
+fcb_index_get(struct fcb *fcb, struct fcb_entry *loc)
+{
+	uint8_t sector = loc->fe_sector - fcb->f_sectors;
+	struct fcb_index_entry *ie;
+	uint32_t slot;
+	int i;
+
+	if ((fcb->f_index == NULL) || (fcb->f_index_cnt == 0U)) {
+		return false;
+	}
+
+	slot = fcb_index_slot(fcb, sector, loc->fe_elem_off);
+	for (i = 0; i < MIN(FCB_INDEX_PROBES, fcb->f_index_cnt); i++) {
+		ie = &fcb->f_index[(slot + i) % fcb->f_index_cnt];
+		if (fcb_index_match(ie, sector, loc->fe_elem_off)) {
+			loc->fe_data_len = ie->ie_data_len;
+			loc->fe_data_off = loc->fe_elem_off +
+				fcb_len_in_flash(fcb, (ie->ie_data_len < 0x80) ? 1 : 2);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void
+fcb_index_add(struct fcb *fcb, const struct fcb_entry *loc)
+{
+	uint8_t sector = loc->fe_sector - fcb->f_sectors;
+	struct fcb_index_entry *ie;
+	struct fcb_index_entry *free_ie = NULL;
+	uint32_t slot;
+	int i;
+
+	if ((fcb->f_index == NULL) || (fcb->f_index_cnt == 0U)) {
+		return;
+	}
+
+	slot = fcb_index_slot(fcb, sector, loc->fe_elem_off);
+	for (i = 0; i < MIN(FCB_INDEX_PROBES, fcb->f_index_cnt); i++) {
+		ie = &fcb->f_index[(slot + i) % fcb->f_index_cnt];
+		if (fcb_index_match(ie, sector, loc->fe_elem_off)) {
+			return;
+		}
+		if ((free_ie == NULL) &&
+		    (ie->ie_data_len == FCB_INDEX_UNUSED)) {
+			free_ie = ie;
+		}
+	}
+
+	if (free_ie == NULL) {
+		free_ie = &fcb->f_index[slot];
+	}
+
+	free_ie->ie_elem_off = loc->fe_elem_off;
+	free_ie->ie_data_len = loc->fe_data_len;
+	free_ie->ie_sector = sector;
+}
+
+void
+fcb_index_drop(struct fcb *fcb, const struct flash_sector *sector)
+{
+	uint8_t idx = sector - fcb->f_sectors;
+	int i;
+
+	if (fcb->f_index == NULL) {
+		return;
+	}
+
+	for (i = 0; i < fcb->f_index_cnt; i++) {
+		if (fcb->f_index[i].ie_sector == idx) {
+			fcb->f_index[i].ie_data_len = FCB_INDEX_UNUSED;
+		}
+	}
+}
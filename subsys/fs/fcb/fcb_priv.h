@@ -15,6 +15,8 @@ extern "C" {
 #define FCB_CRC_SZ	sizeof(uint8_t)
 #define FCB_TMP_BUF_SZ	32
 
+#define FCB_FIXED_ENDMARKER 0xab
+
 #define FCB_ID_GT(a, b) (((int16_t)(a) - (int16_t)(b)) > 0)
 
 #define MK32(val) ((((uint32_t)(val)) << 24) |			\
@@ -76,6 +78,31 @@ int fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, uint16_t i
 int fcb_sector_hdr_read(struct fcb *fcb, struct flash_sector *sector,
 			struct fcb_disk_area *fdap);
 
+#ifdef CONFIG_FCB_INDEX
+void fcb_index_clear(struct fcb *fcb);
+bool fcb_index_get(struct fcb *fcb, struct fcb_entry *loc);
+void fcb_index_add(struct fcb *fcb, const struct fcb_entry *loc);
+void fcb_index_drop(struct fcb *fcb, const struct flash_sector *sector);
+#else
+static inline void fcb_index_clear(struct fcb *fcb)
+{
+}
+
+static inline bool fcb_index_get(struct fcb *fcb, struct fcb_entry *loc)
+{
+	return false;
+}
+
+static inline void fcb_index_add(struct fcb *fcb, const struct fcb_entry *loc)
+{
+}
+
+static inline void fcb_index_drop(struct fcb *fcb,
+				  const struct flash_sector *sector)
+{
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,6 +19,8 @@ fcb_rotate(struct fcb *fcb)
 		return -EINVAL;
 	}
 
+	fcb_index_drop(fcb, fcb->f_oldest);
+
 	rc = fcb_erase_sector(fcb, fcb->f_oldest);
 	if (rc) {
 		rc = -EIO;
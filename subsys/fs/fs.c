@@ -79,12 +79,14 @@ static const struct fs_file_system_t *fs_type_get(int type)
 	return (ep != NULL) ? ep->fstp : NULL;
 }
 
+/* The list is kept sorted by decreasing mount point length, so the first
+ * mount point matching a path is its longest match.
+ */
 static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 			    const char *name, size_t *match_len)
 {
 	struct fs_mount_t *mnt_p = NULL, *itr;
-	size_t longest_match = 0;
-	size_t len, name_len = strlen(name);
+	size_t len;
 	sys_dnode_t *node;
 
 	k_mutex_lock(&mutex, K_FOREVER);
@@ -92,12 +94,8 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 		itr = CONTAINER_OF(node, struct fs_mount_t, node);
 		len = itr->mountp_len;
 
-		/*
-		 * Move to next node if mount point length is
-		 * shorter than longest_match match or if path
-		 * name is shorter than the mount point name.
-		 */
-		if ((len < longest_match) || (len > name_len)) {
+		/* Check for mount point match, name is at least len long then */
+		if (strncmp(name, itr->mnt_point, len) != 0) {
 			continue;
 		}
 
@@ -109,11 +107,8 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 			continue;
 		}
 
-		/* Check for mount point match */
-		if (strncmp(name, itr->mnt_point, len) == 0) {
-			mnt_p = itr;
-			longest_match = len;
-		}
+		mnt_p = itr;
+		break;
 	}
 	k_mutex_unlock(&mutex);
 
@@ -129,10 +124,181 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 	return 0;
 }
 
+static int fs_mnt_point_shorter(sys_dnode_t *node, void *data)
+{
+	struct fs_mount_t *itr = CONTAINER_OF(node, struct fs_mount_t, node);
+
+	return itr->mountp_len < *(size_t *)data;
+}
+
+#ifdef CONFIG_FILE_SYSTEM_PATH_CACHE
+/* Recently resolved paths, with the mount point and the result of a stat.
+ * An entry is only valid in the generation it was added in; operations
+ * which may change the result of a stat of several paths move to the next
+ * generation. Operations on an open file only drop the entries of its path.
+ */
+struct path_cache_entry {
+	struct fs_mount_t *mp;
+	uint32_t gen;
+	uint32_t hash;
+	int rc;
+	enum fs_dir_entry_type type;
+	size_t size;
+	char path[CONFIG_FILE_SYSTEM_PATH_CACHE_MAX_LEN + 1];
+};
+
+static struct path_cache_entry path_cache[CONFIG_FILE_SYSTEM_PATH_CACHE_SIZE];
+static size_t path_cache_next;
+static atomic_t path_cache_gen = ATOMIC_INIT(1);
+/* Changed by any invalidation, a stat running meanwhile is not cached */
+static atomic_t path_cache_seq;
+
+static void path_cache_invalidate(void)
+{
+	atomic_inc(&path_cache_seq);
+
+	/* Entries are zeroed when the generation wraps around */
+	if (atomic_inc(&path_cache_gen) == UINT32_MAX) {
+		k_mutex_lock(&mutex, K_FOREVER);
+		memset(path_cache, 0, sizeof(path_cache));
+		atomic_set(&path_cache_gen, 1);
+		k_mutex_unlock(&mutex);
+	}
+}
+
+/* Drop the entries of the path of an open file */
+static void path_cache_invalidate_file(struct fs_file_t *zfp)
+{
+	k_mutex_lock(&mutex, K_FOREVER);
+	atomic_inc(&path_cache_seq);
+
+	for (size_t i = 0; i < ARRAY_SIZE(path_cache); i++) {
+		if (path_cache[i].hash == zfp->path_hash) {
+			path_cache[i].gen = 0;
+		}
+	}
+	k_mutex_unlock(&mutex);
+}
+
+static uint32_t path_cache_hash(const char *path)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*path != '\0') {
+		hash = (hash ^ (uint8_t)*path++) * 16777619U;
+	}
+
+	return hash;
+}
+
+/* Must be called with the mutex held */
+static struct path_cache_entry *path_cache_find(const char *path,
+						uint32_t hash)
+{
+	uint32_t gen = (uint32_t)atomic_get(&path_cache_gen);
+
+	for (size_t i = 0; i < ARRAY_SIZE(path_cache); i++) {
+		struct path_cache_entry *pce = &path_cache[i];
+
+		if ((pce->gen == gen) && (pce->hash == hash) &&
+		    (strcmp(pce->path, path) == 0)) {
+			return pce;
+		}
+	}
+
+	return NULL;
+}
+
+/* Look up a path, return the mount point and the result of its stat on a
+ * hit and -EAGAIN otherwise. entry may be NULL.
+ */
+static int path_cache_get(const char *path, struct fs_mount_t **mnt_pntp,
+			  struct fs_dirent *entry)
+{
+	struct path_cache_entry *pce;
+	int rc = -EAGAIN;
+
+	k_mutex_lock(&mutex, K_FOREVER);
+	pce = path_cache_find(path, path_cache_hash(path));
+	if (pce != NULL) {
+		*mnt_pntp = pce->mp;
+		rc = pce->rc;
+		if ((rc == 0) && (entry != NULL)) {
+			entry->type = pce->type;
+			entry->size = pce->size;
+			strcpy(entry->name, strrchr(pce->path, '/') + 1);
+		}
+	}
+	k_mutex_unlock(&mutex);
+
+	return rc;
+}
+
+/* Add the result of a stat started when path_cache_seq was seq. Only
+ * results which can be rebuilt from the path are cached.
+ */
+static void path_cache_add(const char *path, struct fs_mount_t *mp,
+			   atomic_val_t seq, int rc,
+			   const struct fs_dirent *entry)
+{
+	struct path_cache_entry *pce;
+	uint32_t hash;
+
+	if (strlen(path) > CONFIG_FILE_SYSTEM_PATH_CACHE_MAX_LEN) {
+		return;
+	}
+
+	if ((rc == 0) && (strcmp(entry->name, strrchr(path, '/') + 1) != 0)) {
+		return;
+	}
+
+	if ((rc != 0) && (rc != -ENOENT)) {
+		return;
+	}
+
+	hash = path_cache_hash(path);
+
+	k_mutex_lock(&mutex, K_FOREVER);
+	if (seq == atomic_get(&path_cache_seq)) {
+		pce = path_cache_find(path, hash);
+		if (pce == NULL) {
+			pce = &path_cache[path_cache_next];
+			path_cache_next = (path_cache_next + 1) %
+					  ARRAY_SIZE(path_cache);
+		}
+
+		pce->mp = mp;
+		pce->gen = (uint32_t)atomic_get(&path_cache_gen);
+		pce->hash = hash;
+		pce->rc = rc;
+		pce->type = (rc == 0) ? entry->type : FS_DIR_ENTRY_FILE;
+		pce->size = (rc == 0) ? entry->size : 0;
+		strcpy(pce->path, path);
+	}
+	k_mutex_unlock(&mutex);
+}
+#else
+static inline void path_cache_invalidate(void)
+{
+}
+
+static inline void path_cache_invalidate_file(struct fs_file_t *zfp)
+{
+}
+
+static inline int path_cache_get(const char *path,
+				 struct fs_mount_t **mnt_pntp,
+				 struct fs_dirent *entry)
+{
+	return -EAGAIN;
+}
+#endif /* CONFIG_FILE_SYSTEM_PATH_CACHE */
+
 /* File operations */
 int fs_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
 {
 	struct fs_mount_t *mp;
+	int cached_rc;
 	int rc = -EINVAL;
 
 	if ((file_name == NULL) ||
@@ -145,10 +311,13 @@ int fs_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
 		return -EBUSY;
 	}
 
-	rc = fs_get_mnt_point(&mp, file_name, NULL);
-	if (rc < 0) {
-		LOG_ERR("mount point not found!!");
-		return rc;
+	cached_rc = path_cache_get(file_name, &mp, NULL);
+	if (cached_rc == -EAGAIN) {
+		rc = fs_get_mnt_point(&mp, file_name, NULL);
+		if (rc < 0) {
+			LOG_ERR("mount point not found!!");
+			return rc;
+		}
 	}
 
 	if (((mp->flags & FS_MOUNT_FLAG_READ_ONLY) != 0) &&
@@ -160,6 +329,15 @@ int fs_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
 		return -ENOTSUP;
 	}
 
+	/* Known not to exist */
+	if ((cached_rc == -ENOENT) && !(flags & FS_O_CREATE)) {
+		return -ENOENT;
+	}
+
+#ifdef CONFIG_FILE_SYSTEM_PATH_CACHE
+	zfp->path_hash = path_cache_hash(file_name);
+#endif
+
 	zfp->mp = mp;
 	rc = mp->fs->open(zfp, file_name, flags);
 	if (rc < 0) {
@@ -168,6 +346,10 @@ int fs_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
 		return rc;
 	}
 
+	if (flags & FS_O_CREATE) {
+		path_cache_invalidate_file(zfp);
+	}
+
 	/* Copy flags to zfp for use with other fs_ API calls */
 	zfp->flags = flags;
 
@@ -187,6 +369,9 @@ int fs_close(struct fs_file_t *zfp)
 	}
 
 	rc = zfp->mp->fs->close(zfp);
+	if (zfp->flags & FS_O_WRITE) {
+		path_cache_invalidate_file(zfp);
+	}
 	if (rc < 0) {
 		LOG_ERR("file close error (%d)", rc);
 		return rc;
@@ -230,6 +415,9 @@ ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size)
 	}
 
 	rc = zfp->mp->fs->write(zfp, ptr, size);
+	if (rc > 0) {
+		path_cache_invalidate_file(zfp);
+	}
 	if (rc < 0) {
 		LOG_ERR("file write error (%d)", rc);
 	}
@@ -290,6 +478,9 @@ int fs_truncate(struct fs_file_t *zfp, off_t length)
 	}
 
 	rc = zfp->mp->fs->truncate(zfp, length);
+	if (rc == 0) {
+		path_cache_invalidate_file(zfp);
+	}
 	if (rc < 0) {
 		LOG_ERR("file truncate error (%d)", rc);
 	}
@@ -310,6 +501,9 @@ int fs_sync(struct fs_file_t *zfp)
 	}
 
 	rc = zfp->mp->fs->sync(zfp);
+	if (zfp->flags & FS_O_WRITE) {
+		path_cache_invalidate_file(zfp);
+	}
 	if (rc < 0) {
 		LOG_ERR("file sync error (%d)", rc);
 	}
@@ -500,6 +694,7 @@ int fs_mkdir(const char *abs_path)
 	}
 
 	rc = mp->fs->mkdir(mp, abs_path);
+	path_cache_invalidate();
 	if (rc < 0) {
 		LOG_ERR("failed to create directory (%d)", rc);
 	}
@@ -510,6 +705,7 @@ int fs_mkdir(const char *abs_path)
 int fs_unlink(const char *abs_path)
 {
 	struct fs_mount_t *mp;
+	int cached_rc;
 	int rc = -EINVAL;
 
 	if ((abs_path == NULL) ||
@@ -518,10 +714,13 @@ int fs_unlink(const char *abs_path)
 		return -EINVAL;
 	}
 
-	rc = fs_get_mnt_point(&mp, abs_path, NULL);
-	if (rc < 0) {
-		LOG_ERR("mount point not found!!");
-		return rc;
+	cached_rc = path_cache_get(abs_path, &mp, NULL);
+	if (cached_rc == -EAGAIN) {
+		rc = fs_get_mnt_point(&mp, abs_path, NULL);
+		if (rc < 0) {
+			LOG_ERR("mount point not found!!");
+			return rc;
+		}
 	}
 
 	if (mp->flags & FS_MOUNT_FLAG_READ_ONLY) {
@@ -532,7 +731,13 @@ int fs_unlink(const char *abs_path)
 		return -ENOTSUP;
 	}
 
+	/* Known not to exist */
+	if (cached_rc == -ENOENT) {
+		return -ENOENT;
+	}
+
 	rc = mp->fs->unlink(mp, abs_path);
+	path_cache_invalidate();
 	if (rc < 0) {
 		LOG_ERR("failed to unlink path (%d)", rc);
 	}
@@ -573,6 +778,7 @@ int fs_rename(const char *from, const char *to)
 	}
 
 	rc = mp->fs->rename(mp, from, to);
+	path_cache_invalidate();
 	if (rc < 0) {
 		LOG_ERR("failed to rename file or dir (%d)", rc);
 	}
@@ -583,6 +789,9 @@ int fs_rename(const char *from, const char *to)
 int fs_stat(const char *abs_path, struct fs_dirent *entry)
 {
 	struct fs_mount_t *mp;
+#ifdef CONFIG_FILE_SYSTEM_PATH_CACHE
+	atomic_val_t seq;
+#endif
 	int rc = -EINVAL;
 
 	if ((abs_path == NULL) ||
@@ -591,6 +800,16 @@ int fs_stat(const char *abs_path, struct fs_dirent *entry)
 		return -EINVAL;
 	}
 
+	rc = path_cache_get(abs_path, &mp, entry);
+	if (rc != -EAGAIN) {
+		return rc;
+	}
+
+#ifdef CONFIG_FILE_SYSTEM_PATH_CACHE
+	/* Taken before the lookup, a change in between is not cached */
+	seq = atomic_get(&path_cache_seq);
+#endif
+
 	rc = fs_get_mnt_point(&mp, abs_path, NULL);
 	if (rc < 0) {
 		LOG_ERR("mount point not found!!");
@@ -602,6 +821,9 @@ int fs_stat(const char *abs_path, struct fs_dirent *entry)
 	}
 
 	rc = mp->fs->stat(mp, abs_path, entry);
+#ifdef CONFIG_FILE_SYSTEM_PATH_CACHE
+	path_cache_add(abs_path, mp, seq, rc, entry);
+#endif
 	if (rc == -ENOENT) {
 		/* File doesn't exist, which is a valid stat response */
 	} else if (rc < 0) {
@@ -715,11 +937,13 @@ int fs_mount(struct fs_mount_t *mp)
 		goto mount_err;
 	}
 
-	/* Update mount point data and append it to the list */
+	/* Update mount point data and insert it in the list */
 	mp->mountp_len = len;
 	mp->fs = fs;
 
-	sys_dlist_append(&fs_mnt_list, &mp->node);
+	sys_dlist_insert_at(&fs_mnt_list, &mp->node, fs_mnt_point_shorter,
+			    &len);
+	path_cache_invalidate();
 	LOG_DBG("fs mounted at %s", mp->mnt_point);
 
 mount_err:
@@ -752,6 +976,7 @@ int fs_mkfs(int fs_type, uintptr_t dev_id, void *cfg, int flags)
 	}
 
 	rc = fs->mkfs(dev_id, cfg, flags);
+	path_cache_invalidate();
 	if (rc < 0) {
 		LOG_ERR("mkfs error (%d)", rc);
 		goto mount_err;
@@ -796,6 +1021,7 @@ int fs_unmount(struct fs_mount_t *mp)
 
 	/* remove mount node from the list */
 	sys_dlist_remove(&mp->node);
+	path_cache_invalidate();
 	LOG_DBG("fs unmounted from %s", mp->mnt_point);
 
 unmount_err:
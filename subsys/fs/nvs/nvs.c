@@ -88,6 +88,167 @@ static void nvs_lookup_cache_invalidate(struct nvs_fs *fs, uint32_t sector)
 
 #endif /* CONFIG_NVS_LOOKUP_CACHE */
 
+#ifdef CONFIG_NVS_INDEX
+
+#define NVS_INDEX_END 0xFFFF
+
+/* IDs are mostly allocated in sequence, which the modulo spreads evenly */
+static inline uint16_t *nvs_index_bucket(struct nvs_fs *fs, uint16_t id)
+{
+	return &fs->index_buckets[id % NVS_INDEX_BUCKETS];
+}
+
+static void nvs_index_clear(struct nvs_fs *fs)
+{
+	for (size_t i = 0; i < NVS_INDEX_BUCKETS; i++) {
+		fs->index_buckets[i] = NVS_INDEX_END;
+	}
+
+	for (size_t i = 0; i < CONFIG_NVS_INDEX_SIZE; i++) {
+		fs->index[i].next = i + 1;
+	}
+	fs->index[CONFIG_NVS_INDEX_SIZE - 1].next = NVS_INDEX_END;
+	fs->index_free = 0;
+
+	/* IDs that are not in the index need a walk until it is rebuilt */
+	fs->index_complete = false;
+}
+
+static struct nvs_index_entry *nvs_index_find(struct nvs_fs *fs, uint16_t id)
+{
+	uint16_t i = *nvs_index_bucket(fs, id);
+
+	while (i != NVS_INDEX_END) {
+		if (fs->index[i].id == id) {
+			return &fs->index[i];
+		}
+		i = fs->index[i].next;
+	}
+
+	return NULL;
+}
+
+/* Address of the most recent ATE of id, the address to start a walk from if
+ * id is not in an incomplete index, or NVS_LOOKUP_CACHE_NO_ADDR if id is not
+ * stored.
+ */
+static uint32_t nvs_index_lookup(struct nvs_fs *fs, uint16_t id)
+{
+	struct nvs_index_entry *entry = nvs_index_find(fs, id);
+
+	if (entry != NULL) {
+		return entry->addr;
+	}
+
+	return fs->index_complete ? NVS_LOOKUP_CACHE_NO_ADDR : fs->ate_wra;
+}
+
+static void nvs_index_insert(struct nvs_fs *fs, uint16_t id, uint32_t addr)
+{
+	uint16_t *bucket = nvs_index_bucket(fs, id);
+	struct nvs_index_entry *entry;
+
+	if (fs->index_free == NVS_INDEX_END) {
+		if (fs->index_complete) {
+			LOG_WRN("ID index full, increase CONFIG_NVS_INDEX_SIZE");
+			fs->index_complete = false;
+		}
+		return;
+	}
+
+	entry = &fs->index[fs->index_free];
+	fs->index_free = entry->next;
+
+	entry->id = id;
+	entry->addr = addr;
+	entry->next = *bucket;
+	*bucket = entry - fs->index;
+}
+
+static void nvs_index_update(struct nvs_fs *fs, uint16_t id, uint32_t addr)
+{
+	struct nvs_index_entry *entry = nvs_index_find(fs, id);
+
+	if (entry != NULL) {
+		entry->addr = addr;
+	} else {
+		nvs_index_insert(fs, id, addr);
+	}
+}
+
+static int nvs_index_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	uint32_t addr, ate_addr;
+	struct nvs_ate ate;
+
+	nvs_index_clear(fs);
+	fs->index_complete = true;
+	addr = fs->ate_wra;
+
+	while (true) {
+		/* Make a copy of 'addr' as it will be advanced by nvs_prev_ate() */
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+
+		if (rc) {
+			return rc;
+		}
+
+		/* The walk goes from the most recent ATE to the oldest one */
+		if (ate.id != 0xFFFF && nvs_ate_valid(fs, &ate) &&
+		    nvs_index_find(fs, ate.id) == NULL) {
+			nvs_index_insert(fs, ate.id, ate_addr);
+		}
+
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static void nvs_index_invalidate(struct nvs_fs *fs, uint32_t sector)
+{
+	struct nvs_index_entry *entry;
+	uint16_t *link;
+
+	for (size_t i = 0; i < NVS_INDEX_BUCKETS; i++) {
+		link = &fs->index_buckets[i];
+
+		while (*link != NVS_INDEX_END) {
+			entry = &fs->index[*link];
+
+			if ((entry->addr >> ADDR_SECT_SHIFT) != sector) {
+				link = &entry->next;
+				continue;
+			}
+
+			/* Unlink the entry and give it back */
+			*link = entry->next;
+			entry->next = fs->index_free;
+			fs->index_free = entry - fs->index;
+		}
+	}
+}
+
+#endif /* CONFIG_NVS_INDEX */
+
+/* Address of the ATE to start looking for id from, or
+ * NVS_LOOKUP_CACHE_NO_ADDR when id is known not to be stored.
+ */
+static inline uint32_t nvs_lookup_start(struct nvs_fs *fs, uint16_t id)
+{
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	return fs->lookup_cache[nvs_lookup_cache_pos(id)];
+#elif defined(CONFIG_NVS_INDEX)
+	return nvs_index_lookup(fs, id);
+#else
+	return fs->ate_wra;
+#endif
+}
+
 /* basic routines */
 /* nvs_al_size returns size aligned to fs->write_block_size */
 static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
@@ -172,6 +333,11 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 	if (entry->id != 0xFFFF) {
 		fs->lookup_cache[nvs_lookup_cache_pos(entry->id)] = fs->ate_wra;
 	}
+#endif
+#ifdef CONFIG_NVS_INDEX
+	if (entry->id != 0xFFFF) {
+		nvs_index_update(fs, entry->id, fs->ate_wra);
+	}
 #endif
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
 
@@ -305,6 +471,9 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, uint32_t addr)
 
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 	nvs_lookup_cache_invalidate(fs, addr >> ADDR_SECT_SHIFT);
+#endif
+#ifdef CONFIG_NVS_INDEX
+	nvs_index_invalidate(fs, addr >> ADDR_SECT_SHIFT);
 #endif
 	rc = flash_erase(fs->flash_device, offset, fs->sector_size);
 
@@ -581,23 +750,26 @@ static int nvs_add_gc_done_ate(struct nvs_fs *fs)
 /* garbage collection: the address ate_wra has been updated to the new sector
  * that has just been started. The data to gc is in the sector after this new
  * sector.
+ *
+ * The collection is split in nvs_gc_start(), which finds the ATEs to check,
+ * nvs_gc_step(), which moves the valid entries, and nvs_gc_finish(), which
+ * erases the gc'ed sector, so that it can be run a few ATEs at a time.
  */
-static int nvs_gc(struct nvs_fs *fs)
+static int nvs_gc_start(struct nvs_fs *fs, struct nvs_gc_state *gc)
 {
 	int rc;
-	struct nvs_ate close_ate, gc_ate, wlk_ate;
-	uint32_t sec_addr, gc_addr, gc_prev_addr, wlk_addr, wlk_prev_addr,
-	      data_addr, stop_addr;
+	struct nvs_ate close_ate;
 	size_t ate_size;
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
-	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
-	nvs_sector_advance(fs, &sec_addr);
-	gc_addr = sec_addr + fs->sector_size - ate_size;
+	gc->sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+	nvs_sector_advance(fs, &gc->sec_addr);
+	gc->gc_addr = gc->sec_addr + fs->sector_size - ate_size;
+	gc->moving = false;
 
 	/* if the sector is not closed don't do gc */
-	rc = nvs_flash_ate_rd(fs, gc_addr, &close_ate);
+	rc = nvs_flash_ate_rd(fs, gc->gc_addr, &close_ate);
 	if (rc < 0) {
 		/* flash error */
 		return rc;
@@ -605,41 +777,66 @@ static int nvs_gc(struct nvs_fs *fs)
 
 	rc = nvs_ate_cmp_const(&close_ate, fs->flash_parameters->erase_value);
 	if (!rc) {
-		goto gc_done;
+		return 0;
 	}
 
-	stop_addr = gc_addr - ate_size;
+	gc->stop_addr = gc->gc_addr - ate_size;
 
 	if (nvs_close_ate_valid(fs, &close_ate)) {
-		gc_addr &= ADDR_SECT_MASK;
-		gc_addr += close_ate.offset;
+		gc->gc_addr &= ADDR_SECT_MASK;
+		gc->gc_addr += close_ate.offset;
 	} else {
-		rc = nvs_recover_last_ate(fs, &gc_addr);
+		rc = nvs_recover_last_ate(fs, &gc->gc_addr);
 		if (rc) {
 			return rc;
 		}
 	}
 
-	do {
-		gc_prev_addr = gc_addr;
-		rc = nvs_prev_ate(fs, &gc_addr, &gc_ate);
+	/* The data of the entries lies below the most recent ATE */
+	gc->data_end = gc->gc_addr & ADDR_OFFS_MASK;
+	gc->moving = true;
+
+	return 0;
+}
+
+/* Check up to cnt ATEs of the gc'ed sector and move the valid entries, or
+ * only add up the space they need when need is not NULL. Returns 1 if ATEs
+ * are left, 0 when done, errcode on error.
+ */
+static int nvs_gc_step(struct nvs_fs *fs, struct nvs_gc_state *gc, uint32_t cnt,
+		       size_t *need)
+{
+	int rc;
+	struct nvs_ate gc_ate, wlk_ate;
+	uint32_t gc_prev_addr, wlk_addr, wlk_prev_addr, data_addr;
+	size_t ate_size;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	while (gc->moving && cnt--) {
+		gc_prev_addr = gc->gc_addr;
+		rc = nvs_prev_ate(fs, &gc->gc_addr, &gc_ate);
 		if (rc) {
 			return rc;
 		}
 
+		if (gc_prev_addr == gc->stop_addr) {
+			gc->moving = false;
+		}
+
 		if (!nvs_ate_valid(fs, &gc_ate)) {
 			continue;
 		}
 
-#ifdef CONFIG_NVS_LOOKUP_CACHE
-		wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(gc_ate.id)];
+		/* The older entries have their data below this one */
+		gc->data_end = MIN(gc->data_end, gc_ate.offset);
+
+		wlk_addr = nvs_lookup_start(fs, gc_ate.id);
 
 		if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
 			wlk_addr = fs->ate_wra;
 		}
-#else
-		wlk_addr = fs->ate_wra;
-#endif
+
 		do {
 			wlk_prev_addr = wlk_addr;
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
@@ -661,6 +858,11 @@ static int nvs_gc(struct nvs_fs *fs)
 		 * needed unless it is a deleted item.
 		 */
 		if ((wlk_prev_addr == gc_prev_addr) && gc_ate.len) {
+			if (need != NULL) {
+				*need += nvs_al_size(fs, gc_ate.len) + ate_size;
+				continue;
+			}
+
 			/* copy needed */
 			LOG_DBG("Moving %d, len %d", gc_ate.id, gc_ate.len);
 
@@ -680,9 +882,17 @@ static int nvs_gc(struct nvs_fs *fs)
 				return rc;
 			}
 		}
-	} while (gc_prev_addr != stop_addr);
+	}
 
-gc_done:
+	return gc->moving ? 1 : 0;
+}
+
+static int nvs_gc_finish(struct nvs_fs *fs, struct nvs_gc_state *gc)
+{
+	int rc;
+	size_t ate_size;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	/* Make it possible to detect that gc has finished by writing a
 	 * gc done ate to the sector. In the field we might have nvs systems
@@ -698,13 +908,246 @@ gc_done:
 	}
 
 	/* Erase the gc'ed sector */
-	rc = nvs_flash_erase_sector(fs, sec_addr);
+	rc = nvs_flash_erase_sector(fs, gc->sec_addr);
+	if (rc) {
+		return rc;
+	}
+
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	/* Do not collect again in the background a sector that gc left nearly
+	 * full, the next collection is left to the write that needs it.
+	 */
+	fs->gc_armed = (fs->ate_wra - fs->data_wra) >=
+		       (fs->sector_size * CONFIG_NVS_GC_BACKGROUND_THRESHOLD / 100U);
+#endif
+
+	return 0;
+}
+
+static int nvs_gc(struct nvs_fs *fs)
+{
+	int rc;
+	struct nvs_gc_state gc;
+
+	rc = nvs_gc_start(fs, &gc);
+	if (rc) {
+		return rc;
+	}
+
+	rc = nvs_gc_step(fs, &gc, UINT32_MAX, NULL);
+	if (rc) {
+		return rc;
+	}
+
+	return nvs_gc_finish(fs, &gc);
+}
+
+#ifdef CONFIG_NVS_GC_BACKGROUND
+
+/* Space needed in the write sector to complete the background gc: the ATEs
+ * left to check, their data, the gc done ate, and the largest entry, which
+ * a reset can leave half copied before nvs_gc_resume() copies it again.
+ */
+static size_t nvs_gc_reserve(struct nvs_fs *fs)
+{
+	size_t ate_size, reserve;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	reserve = ate_size;
+
+	if (fs->gc.moving) {
+		reserve += fs->gc.stop_addr + ate_size - fs->gc.gc_addr;
+		reserve += fs->gc.data_end;
+		reserve += fs->gc.max_len + ate_size;
+	}
+
+	return reserve;
+}
+
+/* Find the largest entry of the sector to gc */
+static int nvs_gc_max_len(struct nvs_fs *fs, struct nvs_gc_state *gc)
+{
+	int rc;
+	struct nvs_ate ate;
+	uint32_t addr;
+	size_t ate_size;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	gc->max_len = 0U;
+
+	if (!gc->moving) {
+		return 0;
+	}
+
+	for (addr = gc->gc_addr; addr <= gc->stop_addr; addr += ate_size) {
+		rc = nvs_flash_ate_rd(fs, addr, &ate);
+		if (rc) {
+			return rc;
+		}
+
+		if (nvs_ate_valid(fs, &ate)) {
+			gc->max_len = MAX(gc->max_len, nvs_al_size(fs, ate.len));
+		}
+	}
+
+	return 0;
+}
+
+/* Run the rest of the background gc */
+static int nvs_gc_complete(struct nvs_fs *fs)
+{
+	int rc;
+
+	rc = nvs_gc_step(fs, &fs->gc, UINT32_MAX, NULL);
+	if (rc) {
+		return rc;
+	}
+
+	rc = nvs_gc_finish(fs, &fs->gc);
 	if (rc) {
 		return rc;
 	}
+
+	fs->gc.active = false;
+
 	return 0;
 }
 
+static bool nvs_gc_needed(struct nvs_fs *fs)
+{
+	return fs->gc_armed && !fs->gc.active &&
+	       ((fs->ate_wra - fs->data_wra) <
+		(fs->sector_size * CONFIG_NVS_GC_BACKGROUND_THRESHOLD / 100U));
+}
+
+static void nvs_gc_work_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work);
+	int rc = 0;
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	if (!fs->ready) {
+		goto end;
+	}
+
+	if (!fs->gc.active) {
+		if (!nvs_gc_needed(fs)) {
+			goto end;
+		}
+
+		rc = nvs_sector_close(fs);
+		if (rc) {
+			goto end;
+		}
+
+		rc = nvs_gc_start(fs, &fs->gc);
+		if (rc) {
+			goto end;
+		}
+
+		rc = nvs_gc_max_len(fs, &fs->gc);
+		if (rc) {
+			goto end;
+		}
+
+		fs->gc.active = true;
+	}
+
+	/* Each run is one step, other users of the file system can get the
+	 * lock in between.
+	 */
+	if (fs->gc.moving) {
+		rc = nvs_gc_step(fs, &fs->gc, CONFIG_NVS_GC_BACKGROUND_STEP,
+				 NULL);
+		if (rc >= 0) {
+			rc = 0;
+			(void)k_work_submit(work);
+		}
+	} else {
+		rc = nvs_gc_finish(fs, &fs->gc);
+		if (!rc) {
+			fs->gc.active = false;
+		}
+	}
+
+end:
+	if (rc) {
+		LOG_ERR("Background gc failed: %d", rc);
+	}
+	k_mutex_unlock(&fs->nvs_lock);
+}
+
+#endif /* CONFIG_NVS_GC_BACKGROUND */
+
+/* At this point, the lookup structures weren't built but the gc function
+ * needs to use them. So, temporarily, make lookups walk from the end of the
+ * fs. The lookup structures are rebuilt afterwards.
+ */
+static void nvs_lookup_walk_all(struct nvs_fs *fs)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	for (int i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		fs->lookup_cache[i] = fs->ate_wra;
+	}
+#endif
+#ifdef CONFIG_NVS_INDEX
+	nvs_index_clear(fs);
+#endif
+}
+
+#ifdef CONFIG_NVS_GC_BACKGROUND
+/* Resume an interrupted gc without erasing the write sector first, as entries
+ * may have been written to it during a background gc. Returns 0 when done,
+ * -ENOSPC if the entries left to move do not fit in the write sector, as
+ * neither it nor the sector being collected can be erased without losing
+ * entries, errcode on other errors.
+ */
+static int nvs_gc_resume(struct nvs_fs *fs)
+{
+	int rc;
+	struct nvs_gc_state gc;
+	size_t ate_size, need = 0;
+	uint8_t erase_value = fs->flash_parameters->erase_value;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	/* possible data write after last ate write, update data_wra */
+	while (fs->ate_wra > fs->data_wra) {
+		rc = nvs_flash_cmp_const(fs, fs->data_wra, erase_value,
+					 fs->ate_wra - fs->data_wra);
+		if (rc < 0) {
+			return rc;
+		}
+		if (!rc) {
+			break;
+		}
+
+		fs->data_wra += fs->flash_parameters->write_block_size;
+	}
+
+	nvs_lookup_walk_all(fs);
+
+	rc = nvs_gc_start(fs, &gc);
+	if (rc) {
+		return rc;
+	}
+
+	rc = nvs_gc_step(fs, &gc, UINT32_MAX, &need);
+	if (rc) {
+		return rc;
+	}
+
+	if (fs->ate_wra < (fs->data_wra + need + ate_size)) {
+		LOG_ERR("No room to resume gc");
+		return -ENOSPC;
+	}
+
+	LOG_INF("Resuming gc");
+	return nvs_gc(fs);
+}
+#endif /* CONFIG_NVS_GC_BACKGROUND */
+
 static int nvs_startup(struct nvs_fs *fs)
 {
 	int rc;
@@ -856,6 +1299,10 @@ static int nvs_startup(struct nvs_fs *fs)
 			rc = nvs_flash_erase_sector(fs, addr);
 			goto end;
 		}
+#ifdef CONFIG_NVS_GC_BACKGROUND
+		rc = nvs_gc_resume(fs);
+		goto end;
+#else
 		LOG_INF("No GC Done marker found: restarting gc");
 		rc = nvs_flash_erase_sector(fs, fs->ate_wra);
 		if (rc) {
@@ -864,18 +1311,10 @@ static int nvs_startup(struct nvs_fs *fs)
 		fs->ate_wra &= ADDR_SECT_MASK;
 		fs->ate_wra += (fs->sector_size - 2 * ate_size);
 		fs->data_wra = (fs->ate_wra & ADDR_SECT_MASK);
-#ifdef CONFIG_NVS_LOOKUP_CACHE
-		/**
-		 * At this point, the lookup cache wasn't built but the gc function need to use it.
-		 * So, temporarily, we set the lookup cache to the end of the fs.
-		 * The cache will be rebuilt afterwards
-		 **/
-		for (int i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
-			fs->lookup_cache[i] = fs->ate_wra;
-		}
-#endif
+		nvs_lookup_walk_all(fs);
 		rc = nvs_gc(fs);
 		goto end;
+#endif
 	}
 
 	/* possible data write after last ate write, update data_wra */
@@ -913,6 +1352,11 @@ end:
 	if (!rc) {
 		rc = nvs_lookup_cache_rebuild(fs);
 	}
+#endif
+#ifdef CONFIG_NVS_INDEX
+	if (!rc) {
+		rc = nvs_index_rebuild(fs);
+	}
 #endif
 	/* If the sector is empty add a gc done ate to avoid having insufficient
 	 * space when doing gc.
@@ -936,6 +1380,13 @@ int nvs_clear(struct nvs_fs *fs)
 		return -EACCES;
 	}
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	struct k_work_sync sync;
+
+	(void)k_work_cancel_sync(&fs->gc_work, &sync);
+	fs->gc.active = false;
+#endif
+
 	for (uint16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
@@ -957,6 +1408,15 @@ int nvs_mount(struct nvs_fs *fs)
 	struct flash_pages_info info;
 	size_t write_block_size;
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	if (fs->ready) {
+		struct k_work_sync sync;
+
+		/* Remount, an interrupted background gc is resumed at startup */
+		(void)k_work_cancel_sync(&fs->gc_work, &sync);
+	}
+#endif
+
 	k_mutex_init(&fs->nvs_lock);
 
 	fs->flash_parameters = flash_get_parameters(fs->flash_device);
@@ -990,6 +1450,15 @@ int nvs_mount(struct nvs_fs *fs)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_NVS_INDEX
+	nvs_index_clear(fs);
+#endif
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	k_work_init(&fs->gc_work, nvs_gc_work_handler);
+	fs->gc.active = false;
+	fs->gc_armed = true;
+#endif
+
 	rc = nvs_startup(fs);
 	if (rc) {
 		return rc;
@@ -1009,7 +1478,8 @@ int nvs_mount(struct nvs_fs *fs)
 	return 0;
 }
 
-ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
+static ssize_t nvs_write_entry(struct nvs_fs *fs, uint16_t id, const void *data,
+			       size_t len)
 {
 	int rc, gc_count;
 	size_t ate_size, data_size;
@@ -1036,15 +1506,11 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	}
 
 	/* find latest entry with same id */
-#ifdef CONFIG_NVS_LOOKUP_CACHE
-	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+	wlk_addr = nvs_lookup_start(fs, id);
 
 	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
 		goto no_cached_entry;
 	}
-#else
-	wlk_addr = fs->ate_wra;
-#endif
 	rd_addr = wlk_addr;
 
 	while (1) {
@@ -1062,9 +1528,7 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		}
 	}
 
-#ifdef CONFIG_NVS_LOOKUP_CACHE
 no_cached_entry:
-#endif
 
 	if (prev_found) {
 		/* previous entry found */
@@ -1102,6 +1566,17 @@ no_cached_entry:
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	/* Leave the space the background gc still needs */
+	if (fs->gc.active &&
+	    (fs->ate_wra < (fs->data_wra + required_space + nvs_gc_reserve(fs)))) {
+		rc = nvs_gc_complete(fs);
+		if (rc) {
+			goto end;
+		}
+	}
+#endif
+
 	gc_count = 0;
 	while (1) {
 		if (gc_count == fs->sector_count) {
@@ -1134,18 +1609,45 @@ no_cached_entry:
 		gc_count++;
 	}
 	rc = len;
+
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	if (nvs_gc_needed(fs)) {
+		(void)k_work_submit(&fs->gc_work);
+	}
+#endif
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
 }
 
+ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
+{
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	ssize_t rc;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	/* Keep the background gc from moving entries during the lookup */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	rc = nvs_write_entry(fs, id, data, len);
+	k_mutex_unlock(&fs->nvs_lock);
+
+	return rc;
+#else
+	return nvs_write_entry(fs, id, data, len);
+#endif
+}
+
 int nvs_delete(struct nvs_fs *fs, uint16_t id)
 {
 	return nvs_write(fs, id, NULL, 0);
 }
 
-ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
-		      uint16_t cnt)
+static ssize_t nvs_read_hist_entry(struct nvs_fs *fs, uint16_t id, void *data,
+				   size_t len, uint16_t cnt)
 {
 	int rc;
 	uint32_t wlk_addr, rd_addr;
@@ -1166,16 +1668,12 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
-#ifdef CONFIG_NVS_LOOKUP_CACHE
-	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+	wlk_addr = nvs_lookup_start(fs, id);
 
 	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
 		rc = -ENOENT;
 		goto err;
 	}
-#else
-	wlk_addr = fs->ate_wra;
-#endif
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
@@ -1210,6 +1708,28 @@ err:
 	return rc;
 }
 
+ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
+		      uint16_t cnt)
+{
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	ssize_t rc;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	/* Keep the background gc from erasing the sector being read */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	rc = nvs_read_hist_entry(fs, id, data, len, cnt);
+	k_mutex_unlock(&fs->nvs_lock);
+
+	return rc;
+#else
+	return nvs_read_hist_entry(fs, id, data, len, cnt);
+#endif
+}
+
 ssize_t nvs_read(struct nvs_fs *fs, uint16_t id, void *data, size_t len)
 {
 	int rc;
@@ -1221,7 +1741,7 @@ ssize_t nvs_read(struct nvs_fs *fs, uint16_t id, void *data, size_t len)
 ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 {
 
-	int rc;
+	ssize_t rc;
 	struct nvs_ate step_ate, wlk_ate;
 	uint32_t step_addr, wlk_addr;
 	size_t ate_size, free_space;
@@ -1238,12 +1758,17 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		free_space += (fs->sector_size - ate_size);
 	}
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	/* Keep the background gc from moving entries during the walk */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+#endif
+
 	step_addr = fs->ate_wra;
 
 	while (1) {
 		rc = nvs_prev_ate(fs, &step_addr, &step_ate);
 		if (rc) {
-			return rc;
+			goto end;
 		}
 
 		wlk_addr = fs->ate_wra;
@@ -1251,7 +1776,7 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		while (1) {
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 			if (rc) {
-				return rc;
+				goto end;
 			}
 			if ((wlk_ate.id == step_ate.id) ||
 			    (wlk_addr == fs->ate_wra)) {
@@ -1270,5 +1795,10 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 			break;
 		}
 	}
-	return free_space;
+	rc = free_space;
+end:
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	k_mutex_unlock(&fs->nvs_lock);
+#endif
+	return rc;
 }
@@ -17,6 +17,17 @@ backend = FS
 backend-str = fs
 source "subsys/logging/Kconfig.template.log_format_config"
 
+config LOG_BACKEND_FS_DICT_BLOCK_SIZE
+	int "Size of the blocks of dictionary based log messages"
+	depends on LOG_BACKEND_FS_OUTPUT_DICTIONARY
+	default 512
+	range 64 4096
+	help
+	  In dictionary mode, log messages are gathered in a block which is
+	  written to the file at once, when it is full or when there are no
+	  more pending log messages. Bigger blocks mean fewer file system
+	  writes when a lot is logged.
+
 config LOG_BACKEND_FS_AUTOSTART
 	bool "Automatically start fs backend"
 	default y
@@ -58,4 +69,37 @@ config LOG_BACKEND_FS_FILES_LIMIT
 	  Limit of number of files with logs. It is also limited by
 	  size of file system partition.
 
+config LOG_BACKEND_FS_BUFFERED
+	bool "Buffer log data in RAM before writing it to the file"
+	help
+	  When enabled, log data is accumulated in a RAM buffer and written to
+	  the file in chunks of LOG_BACKEND_FS_BUFFER_SIZE bytes, aligned on
+	  that size in the file, instead of one write and sync per message.
+	  The buffer is also written when it holds data older than
+	  LOG_BACKEND_FS_FLUSH_TIMEOUT_MS and on panic. That timed write is
+	  done from the system work queue, which needs a stack big enough for
+	  the file system operations. A message may be split between two log
+	  files.
+
+if LOG_BACKEND_FS_BUFFERED
+
+config LOG_BACKEND_FS_BUFFER_SIZE
+	int "Size of the RAM buffer"
+	default 4096
+	range 32 65536
+	help
+	  Size of the chunks written to the file. Preferably the erase block
+	  size of the underlying storage, or a multiple of the program size.
+	  LOG_BACKEND_FS_FILE_SIZE should be a multiple of it.
+
+config LOG_BACKEND_FS_FLUSH_TIMEOUT_MS
+	int "Maximum time log data is kept in RAM (in milliseconds)"
+	default 1000
+	range 1 3600000
+	help
+	  Log data is written to the file at the latest after that time,
+	  even if the buffer is not full.
+
+endif # LOG_BACKEND_FS_BUFFERED
+
 endif # LOG_BACKEND_FS
@@ -7,10 +7,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_ctrl.h>
 #include <zephyr/logging/log_output_dict.h>
 #include <zephyr/logging/log_backend_std.h>
 #include <assert.h>
 #include <zephyr/fs/fs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_internal.h>
+
+#include "log_backend_fs_priv.h"
 
 #define MAX_PATH_LEN 256
 #define MAX_FLASH_WRITE_SIZE 256
@@ -446,16 +451,137 @@ static int del_oldest_log(void)
 	return rc;
 }
 
+#ifdef CONFIG_LOG_BACKEND_FS_BUFFERED
+
+#define LOG_BUF_SIZE CONFIG_LOG_BACKEND_FS_BUFFER_SIZE
+#define LOG_BUF_WRITE_RETRIES 3
+
+static uint8_t __aligned(4) log_buf[LOG_BUF_SIZE];
+static size_t log_buf_len;
+/* Buffer length at which the next write ends on a chunk boundary in the file. */
+static size_t log_buf_limit = LOG_BUF_SIZE;
+static K_MUTEX_DEFINE(log_buf_mutex);
+
+static void log_buf_flush_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(log_buf_flush_work, log_buf_flush_work_handler);
+
+/* Must be called with log_buf_mutex locked. */
+static void log_buf_write(void)
+{
+	size_t written = 0;
+	int retries = 0;
+	off_t pos;
+	int rc;
+
+	if (log_buf_len == 0) {
+		return;
+	}
+
+	/* Data which could not be written in a few attempts, after a full
+	 * file system or a lost file, is counted as dropped.
+	 */
+	while (written < log_buf_len) {
+		rc = write_log_to_file(&log_buf[written], log_buf_len - written,
+				       NULL);
+		if (rc > 0) {
+			written += rc;
+			retries = 0;
+		} else if ((backend_state != BACKEND_FS_OK) ||
+			   (++retries > LOG_BUF_WRITE_RETRIES)) {
+			break;
+		}
+	}
+
+	if (written < log_buf_len) {
+		z_log_dropped(false);
+	}
+
+	log_buf_len = 0;
+
+	/* The file may have been rotated, get the position in the current one. */
+	pos = (backend_state == BACKEND_FS_OK) ? fs_tell(&file) : 0;
+	if (pos < 0) {
+		pos = 0;
+	}
+
+	log_buf_limit = LOG_BUF_SIZE - (pos % LOG_BUF_SIZE);
+}
+
+static void log_buf_flush_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	flush_log_buffer();
+}
+
+void flush_log_buffer(void)
+{
+	k_mutex_lock(&log_buf_mutex, K_FOREVER);
+	log_buf_write();
+	k_mutex_unlock(&log_buf_mutex);
+}
+
+int write_log_to_buffer(uint8_t *data, size_t length, void *ctx)
+{
+	size_t chunk;
+
+	ARG_UNUSED(ctx);
+
+	k_mutex_lock(&log_buf_mutex, K_FOREVER);
+
+	chunk = MIN(length, log_buf_limit - log_buf_len);
+	memcpy(&log_buf[log_buf_len], data, chunk);
+	log_buf_len += chunk;
+
+	if (log_buf_len == log_buf_limit) {
+		log_buf_write();
+		(void)k_work_cancel_delayable(&log_buf_flush_work);
+	} else if (log_buf_len > 0) {
+		/* No effect if already scheduled, so the timeout counts from
+		 * the oldest data in the buffer.
+		 */
+		(void)k_work_schedule(&log_buf_flush_work,
+				      K_MSEC(CONFIG_LOG_BACKEND_FS_FLUSH_TIMEOUT_MS));
+	}
+
+	k_mutex_unlock(&log_buf_mutex);
+
+	return chunk;
+}
+
+#define LOG_FS_OUT write_log_to_buffer
+#else
+#define LOG_FS_OUT write_log_to_file
+#endif /* CONFIG_LOG_BACKEND_FS_BUFFERED */
+
 BUILD_ASSERT(!IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE),
 	     "Immediate logging is not supported by LOG FS backend.");
 
 #ifndef CONFIG_LOG_BACKEND_FS_TESTSUITE
 
 static uint8_t __aligned(4) buf[MAX_FLASH_WRITE_SIZE];
-LOG_OUTPUT_DEFINE(log_output, write_log_to_file, buf, MAX_FLASH_WRITE_SIZE);
+LOG_OUTPUT_DEFINE(log_output, LOG_FS_OUT, buf, MAX_FLASH_WRITE_SIZE);
+
+#ifdef CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY
+/* In dictionary mode messages are written to the file in blocks. */
+LOG_DICT_BLOCK_DEFINE(dict_block, LOG_FS_OUT, CONFIG_LOG_BACKEND_FS_DICT_BLOCK_SIZE);
+static uint8_t dict_buf[1];
+LOG_OUTPUT_DEFINE(log_output_dict, log_dict_block_out, dict_buf, sizeof(dict_buf));
+
+static void dict_block_done(void)
+{
+	log_dict_block_commit(&dict_block);
+	if (!log_data_pending()) {
+		log_dict_block_flush(&dict_block);
+	}
+}
+#endif
 
 static void log_backend_fs_init(const struct log_backend *const backend)
 {
+#ifdef CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY
+	log_output_ctx_set(&log_output_dict, &dict_block);
+#endif
 }
 
 static void panic(struct log_backend const *const backend)
@@ -463,6 +589,24 @@ static void panic(struct log_backend const *const backend)
 	/* In case of panic deinitialize backend. It is better to keep
 	 * current data rather than log new and risk of failure.
 	 */
+	if (k_is_in_isr()) {
+		log_backend_deactivate(backend);
+		return;
+	}
+
+#ifdef CONFIG_LOG_BACKEND_FS_BUFFERED
+	/* Save the buffered data, unless it is being written. */
+	if (k_mutex_lock(&log_buf_mutex, K_NO_WAIT) == 0) {
+#ifdef CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY
+		/* Messages already gathered in a block go to the buffer first. */
+		log_dict_block_flush(&dict_block);
+#endif
+		log_buf_write();
+		k_mutex_unlock(&log_buf_mutex);
+	}
+#elif defined(CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY)
+	log_dict_block_flush(&dict_block);
+#endif
 	log_backend_deactivate(backend);
 }
 
@@ -470,11 +614,12 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	if (IS_ENABLED(CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY)) {
-		log_dict_output_dropped_process(&log_output, cnt);
-	} else {
-		log_backend_std_dropped(&log_output, cnt);
-	}
+#ifdef CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY
+	log_dict_output_dropped_process(&log_output_dict, cnt);
+	dict_block_done();
+#else
+	log_backend_std_dropped(&log_output, cnt);
+#endif
 }
 
 static void process(const struct log_backend *const backend,
@@ -484,6 +629,14 @@ static void process(const struct log_backend *const backend,
 
 	log_format_func_t log_output_func = log_format_func_t_get(log_format_current);
 
+#ifdef CONFIG_LOG_BACKEND_FS_OUTPUT_DICTIONARY
+	if (log_format_current == LOG_OUTPUT_DICT) {
+		log_output_func(&log_output_dict, &msg->log, flags);
+		dict_block_done();
+		return;
+	}
+#endif
+
 	log_output_func(&log_output, &msg->log, flags);
 }
 
@@ -0,0 +1,26 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef __LOG_BACKEND_FS_PRIV_H_
+#define __LOG_BACKEND_FS_PRIV_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Output functions of the fs backend, also used by its test suite. */
+int write_log_to_file(uint8_t *data, size_t length, void *ctx);
+
+#ifdef CONFIG_LOG_BACKEND_FS_BUFFERED
+int write_log_to_buffer(uint8_t *data, size_t length, void *ctx);
+void flush_log_buffer(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_BACKEND_FS_PRIV_H_ */
@@ -10,6 +10,8 @@ LOG_MODULE_REGISTER(log_backend_net, CONFIG_LOG_DEFAULT_LEVEL);
 #include <zephyr/logging/log_backend.h>
 #include <zephyr/logging/log_core.h>
 #include <zephyr/logging/log_output.h>
+#include <zephyr/logging/log_output_dict.h>
+#include <zephyr/logging/log_ctrl.h>
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_context.h>
 
@@ -75,6 +77,23 @@ fail:
 
 LOG_OUTPUT_DEFINE(log_output_net, line_out, output_buf, sizeof(output_buf));
 
+#ifdef CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY
+/* In dictionary mode a UDP packet carries a block of binary messages. */
+LOG_DICT_BLOCK_DEFINE(dict_block, line_out,
+		      CONFIG_LOG_BACKEND_NET_MAX_BUF_SIZE -
+		      sizeof(struct log_dict_output_block_hdr_t));
+static uint8_t dict_buf[1];
+LOG_OUTPUT_DEFINE(log_output_dict, log_dict_block_out, dict_buf, sizeof(dict_buf));
+
+static void dict_block_done(void)
+{
+	log_dict_block_commit(&dict_block);
+	if (!log_data_pending()) {
+		log_dict_block_flush(&dict_block);
+	}
+}
+#endif
+
 static int do_net_init(void)
 {
 	struct sockaddr *local_addr = NULL;
@@ -169,6 +188,10 @@ static int do_net_init(void)
 	log_output_ctx_set(&log_output_net, ctx);
 	log_output_hostname_set(&log_output_net, dev_hostname);
 
+#ifdef CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY
+	log_dict_block_ctx_set(&dict_block, ctx);
+#endif
+
 	return 0;
 }
 
@@ -187,9 +210,31 @@ static void process(const struct log_backend *const backend,
 
 	log_format_func_t log_output_func = log_format_func_t_get(log_format_current);
 
+#ifdef CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY
+	if (log_format_current == LOG_OUTPUT_DICT) {
+		log_output_func(&log_output_dict, &msg->log, flags);
+		dict_block_done();
+		return;
+	}
+#endif
+
 	log_output_func(&log_output_net, &msg->log, flags);
 }
 
+#ifdef CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+
+	if (panic_mode || !net_init_done) {
+		return;
+	}
+
+	log_dict_output_dropped_process(&log_output_dict, cnt);
+	dict_block_done();
+}
+#endif
+
 static int format_set(const struct log_backend *const backend, uint32_t log_type)
 {
 	log_format_current = log_type;
@@ -201,6 +246,10 @@ static void init_net(struct log_backend const *const backend)
 	ARG_UNUSED(backend);
 	int ret;
 
+#ifdef CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY
+	log_output_ctx_set(&log_output_dict, &dict_block);
+#endif
+
 	net_sin(&server_addr)->sin_port = htons(514);
 
 	ret = net_ipaddr_parse(CONFIG_LOG_BACKEND_NET_SERVER,
@@ -216,6 +265,12 @@ static void init_net(struct log_backend const *const backend)
 
 static void panic(struct log_backend const *const backend)
 {
+#ifdef CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY
+	/* Send the messages already gathered in a block. */
+	if (net_init_done && !k_is_in_isr()) {
+		log_dict_block_flush(&dict_block);
+	}
+#endif
 	panic_mode = true;
 }
 
@@ -223,6 +278,9 @@ const struct log_backend_api log_backend_net_api = {
 	.panic = panic,
 	.init = init_net,
 	.process = process,
+#ifdef CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY
+	.dropped = dropped,
+#endif
 	.format_set = format_set,
 };
 
@@ -132,6 +132,20 @@ static const struct mpsc_pbuf_buffer_config mpsc_config = {
 };
 #endif
 
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+#define LOG_BUFFER_CNT CONFIG_MP_MAX_NUM_CPUS
+
+/* CPU 0 uses log_buffer, every other CPU has a buffer of its own. */
+static uint32_t __aligned(Z_LOG_MSG_ALIGNMENT)
+	cpu_buf32[LOG_BUFFER_CNT - 1][CONFIG_LOG_PER_CPU_BUFFER_SIZE / sizeof(int)];
+static struct mpsc_pbuf_buffer cpu_log_buffer[LOG_BUFFER_CNT - 1];
+
+/* Message claimed from each buffer and not processed yet. */
+static union log_msg_generic *cpu_msg[LOG_BUFFER_CNT];
+#else
+#define LOG_BUFFER_CNT 1
+#endif
+
 /* Check that default tag can fit in tag buffer. */
 COND_CODE_0(CONFIG_LOG_TAG_MAX_LEN, (),
 	(BUILD_ASSERT(sizeof(CONFIG_LOG_TAG_DEFAULT) <= CONFIG_LOG_TAG_MAX_LEN + 1,
@@ -588,6 +602,61 @@ void z_log_msg_init(void)
 	mpsc_pbuf_init(&log_buffer, &mpsc_config);
 	curr_log_buffer = &log_buffer;
 #endif
+
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+	for (int i = 0; i < ARRAY_SIZE(cpu_log_buffer); i++) {
+		struct mpsc_pbuf_buffer_config config = mpsc_config;
+
+		config.buf = cpu_buf32[i];
+		config.size = ARRAY_SIZE(cpu_buf32[i]);
+		mpsc_pbuf_init(&cpu_log_buffer[i], &config);
+	}
+
+	memset(cpu_msg, 0, sizeof(cpu_msg));
+#endif
+}
+
+/* Get buffer by index, CPU buffers follow the default buffer. */
+static struct mpsc_pbuf_buffer *buffer_get(int idx)
+{
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+	if (idx > 0) {
+		return &cpu_log_buffer[idx - 1];
+	}
+#endif
+
+	return &log_buffer;
+}
+
+/* Buffer used by the current context. */
+static struct mpsc_pbuf_buffer *local_buffer_get(void)
+{
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+	/* Thread may migrate to another CPU right after reading the id. It
+	 * is harmless as the buffer is still protected by its own lock, it
+	 * is only shared with that CPU for this message.
+	 */
+	return buffer_get(arch_curr_cpu()->id);
+#else
+	return &log_buffer;
+#endif
+}
+
+/* Find buffer which contains given message. */
+static struct mpsc_pbuf_buffer *msg_buffer_get(const struct log_msg *msg)
+{
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+	const uint32_t *addr = (const uint32_t *)msg;
+
+	for (int i = 0; i < ARRAY_SIZE(cpu_buf32); i++) {
+		if (addr >= cpu_buf32[i] &&
+		    addr < &cpu_buf32[i][ARRAY_SIZE(cpu_buf32[i])]) {
+			return &cpu_log_buffer[i];
+		}
+	}
+#endif
+
+	return &log_buffer;
 }
 
 static struct log_msg *msg_alloc(struct mpsc_pbuf_buffer *buffer, uint32_t wlen)
@@ -602,7 +671,7 @@ static struct log_msg *msg_alloc(struct mpsc_pbuf_buffer *buffer, uint32_t wlen)
 
 struct log_msg *z_log_msg_alloc(uint32_t wlen)
 {
-	return msg_alloc(&log_buffer, wlen);
+	return msg_alloc(local_buffer_get(), wlen);
 }
 
 static void msg_commit(struct mpsc_pbuf_buffer *buffer, struct log_msg *msg)
@@ -624,7 +693,7 @@ static void msg_commit(struct mpsc_pbuf_buffer *buffer, struct log_msg *msg)
 void z_log_msg_commit(struct log_msg *msg)
 {
 	msg->hdr.timestamp = timestamp_func();
-	msg_commit(&log_buffer, msg);
+	msg_commit(msg_buffer_get(msg), msg);
 }
 
 union log_msg_generic *z_log_msg_local_claim(void)
@@ -704,10 +773,51 @@ union log_msg_generic *z_log_msg_claim_oldest(k_timeout_t *backoff)
 	return msg;
 }
 
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+/* Claim the oldest message (lowest timestamp) of all CPU buffers. A message
+ * claimed from a buffer is held until it is the oldest one.
+ */
+static union log_msg_generic *cpu_msg_claim_oldest(void)
+{
+	union log_msg_generic *msg = NULL;
+	log_timestamp_t t_min = 0;
+	int chosen = 0;
+
+	for (int i = 0; i < LOG_BUFFER_CNT; i++) {
+		log_timestamp_t t;
+
+		if (cpu_msg[i] == NULL) {
+			cpu_msg[i] = (union log_msg_generic *)mpsc_pbuf_claim(buffer_get(i));
+			if (cpu_msg[i] == NULL) {
+				continue;
+			}
+		}
+
+		t = log_msg_get_timestamp(&cpu_msg[i]->log);
+		if (msg == NULL || t < t_min) {
+			t_min = t;
+			msg = cpu_msg[i];
+			chosen = i;
+		}
+	}
+
+	if (msg) {
+		cpu_msg[chosen] = NULL;
+		curr_log_buffer = buffer_get(chosen);
+	}
+
+	return msg;
+}
+#endif
+
 union log_msg_generic *z_log_msg_claim(k_timeout_t *backoff)
 {
 	size_t len;
 
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+	return cpu_msg_claim_oldest();
+#endif
+
 	STRUCT_SECTION_COUNT(log_mpsc_pbuf, &len);
 
 	/* Use only one buffer if others are not registered. */
@@ -744,6 +854,16 @@ bool z_log_msg_pending(void)
 	size_t len;
 	int i = 0;
 
+#ifdef CONFIG_LOG_PER_CPU_BUFFERS
+	for (i = 0; i < LOG_BUFFER_CNT; i++) {
+		if (cpu_msg[i] || msg_pending(buffer_get(i))) {
+			return true;
+		}
+	}
+
+	return false;
+#endif
+
 	STRUCT_SECTION_COUNT(log_mpsc_pbuf, &len);
 
 	if (!IS_ENABLED(CONFIG_LOG_MULTIDOMAIN) || (len == 1)) {
@@ -826,7 +946,16 @@ int log_mem_get_usage(uint32_t *buf_size, uint32_t *usage)
 		return -EINVAL;
 	}
 
-	mpsc_pbuf_get_utilization(&log_buffer, buf_size, usage);
+	*buf_size = 0;
+	*usage = 0;
+
+	for (int i = 0; i < LOG_BUFFER_CNT; i++) {
+		uint32_t size, now;
+
+		mpsc_pbuf_get_utilization(buffer_get(i), &size, &now);
+		*buf_size += size;
+		*usage += now;
+	}
 
 	return 0;
 }
@@ -839,7 +968,24 @@ int log_mem_get_max_usage(uint32_t *max)
 		return -EINVAL;
 	}
 
-	return mpsc_pbuf_get_max_utilization(&log_buffer, max);
+	*max = 0;
+
+	/* Sum of the maximums of each buffer, an upper bound when there are
+	 * more buffers.
+	 */
+	for (int i = 0; i < LOG_BUFFER_CNT; i++) {
+		uint32_t buf_max;
+		int err;
+
+		err = mpsc_pbuf_get_max_utilization(buffer_get(i), &buf_max);
+		if (err < 0) {
+			return err;
+		}
+
+		*max += buf_max;
+	}
+
+	return 0;
 }
 
 static void log_backend_notify_all(enum log_backend_evt event,
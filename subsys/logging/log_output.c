@@ -14,6 +14,7 @@
 #include <time.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #define LOG_COLOR_CODE_DEFAULT "\x1B[0m"
 #define LOG_COLOR_CODE_RED     "\x1B[1;31m"
@@ -134,6 +135,352 @@ static int cr_out_func(int c, void *ctx)
 	return 0;
 }
 
+static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
+			 void *ctx)
+{
+	int processed;
+
+	do {
+		processed = outf(buf, len, ctx);
+		len -= processed;
+		buf += processed;
+	} while (len != 0);
+}
+
+#ifdef CONFIG_LOG_OUTPUT_FAST_FORMATTING
+/* Conversion specification handled by the fast formatter. */
+struct fast_spec {
+	uint8_t width;
+	uint8_t left : 1;
+	uint8_t zero : 1;
+	uint8_t length;
+	char conv;
+};
+
+enum fast_length {
+	FAST_LENGTH_NONE,
+	FAST_LENGTH_HH,
+	FAST_LENGTH_H,
+	FAST_LENGTH_L,
+	FAST_LENGTH_LL,
+	FAST_LENGTH_Z,
+};
+
+/* Maximum width handled by the fast formatter. */
+#define FAST_WIDTH_MAX 64
+
+/* Copy data to the output buffer, flushing it when full. */
+static void chunk_out(const struct log_output *output, const char *data,
+		      size_t len)
+{
+	if (IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE)) {
+		/* Backend must be thread safe in synchronous operation. */
+		if (len > 0) {
+			buffer_write(output->func, (uint8_t *)data, len,
+				     output->control_block->ctx);
+		}
+
+		return;
+	}
+
+	while (len > 0) {
+		size_t chunk;
+
+		if (output->control_block->offset == output->size) {
+			log_output_flush(output);
+		}
+
+		chunk = MIN(len, output->size - output->control_block->offset);
+		memcpy(&output->buf[output->control_block->offset], data, chunk);
+		atomic_add(&output->control_block->offset, chunk);
+		data += chunk;
+		len -= chunk;
+	}
+}
+
+static void pad_out(const struct log_output *output, char c, size_t len)
+{
+	static const char spaces[] = "                ";
+	static const char zeros[] = "0000000000000000";
+
+	while (len > 0) {
+		size_t chunk = MIN(len, sizeof(spaces) - 1);
+
+		chunk_out(output, c == '0' ? zeros : spaces, chunk);
+		len -= chunk;
+	}
+}
+
+/* Parse a conversion specification following '%'. Returns false if it uses
+ * a feature that only cbprintf handles.
+ */
+static bool fast_spec_parse(const char **fmt, struct fast_spec *spec)
+{
+	const char *f = *fmt;
+	uint32_t width = 0;
+
+	spec->left = 0;
+	spec->zero = 0;
+	spec->length = FAST_LENGTH_NONE;
+
+	for (;; f++) {
+		if (*f == '-') {
+			spec->left = 1;
+		} else if (*f == '0') {
+			spec->zero = 1;
+		} else {
+			break;
+		}
+	}
+
+	while (*f >= '0' && *f <= '9') {
+		width = width * 10U + (*f - '0');
+		if (width > FAST_WIDTH_MAX) {
+			return false;
+		}
+		f++;
+	}
+
+	spec->width = width;
+
+	if (*f == 'h') {
+		f++;
+		spec->length = FAST_LENGTH_H;
+		if (*f == 'h') {
+			f++;
+			spec->length = FAST_LENGTH_HH;
+		}
+	} else if (*f == 'l') {
+		f++;
+		spec->length = FAST_LENGTH_L;
+		if (*f == 'l') {
+			/* cbprintf does not convert 64 bit values then */
+			if (IS_ENABLED(CONFIG_CBPRINTF_REDUCED_INTEGRAL)) {
+				return false;
+			}
+			f++;
+			spec->length = FAST_LENGTH_LL;
+		}
+	} else if (*f == 'z') {
+		f++;
+		spec->length = FAST_LENGTH_Z;
+	}
+
+	switch (*f) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'x':
+	case 'X':
+		break;
+	case 'c':
+	case 's':
+	case '%':
+		if (spec->length != FAST_LENGTH_NONE) {
+			return false;
+		}
+		break;
+	default:
+		return false;
+	}
+
+	/* Left justification takes precedence, as in cbprintf. */
+	if (spec->left || *f == 'c' || *f == 's' || *f == '%') {
+		spec->zero = 0;
+	}
+
+	spec->conv = *f;
+	*fmt = f + 1;
+
+	return true;
+}
+
+static bool fast_fmt_supported(const char *fmt)
+{
+	struct fast_spec spec;
+
+	while (*fmt != '\0') {
+		if (*fmt++ != '%') {
+			continue;
+		}
+
+		if (!fast_spec_parse(&fmt, &spec)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Output a converted field padded to the width of the specification. */
+static int field_out(const struct log_output *output,
+		     const struct fast_spec *spec, bool negative,
+		     const char *str, size_t len)
+{
+	size_t total = len + (negative ? 1 : 0);
+	size_t pad = spec->width > total ? spec->width - total : 0;
+
+	if (!spec->left && !spec->zero) {
+		pad_out(output, ' ', pad);
+	}
+
+	if (negative) {
+		chunk_out(output, "-", 1);
+	}
+
+	if (spec->zero) {
+		pad_out(output, '0', pad);
+	}
+
+	chunk_out(output, str, len);
+
+	if (spec->left) {
+		pad_out(output, ' ', pad);
+	}
+
+	return total + pad;
+}
+
+/* Convert a value to digits at the end of the buffer, returns the first
+ * digit. 32 bit arithmetic is used whenever the value fits.
+ */
+static char *digits_get(char *end, uint64_t value, char conv)
+{
+	const char *hex = (conv == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
+	uint32_t base = (conv == 'x' || conv == 'X') ? 16U : 10U;
+	char *p = end;
+	uint32_t v;
+
+	while (value > UINT32_MAX) {
+		*--p = hex[value % base];
+		value /= base;
+	}
+
+	v = (uint32_t)value;
+	do {
+		*--p = hex[v % base];
+		v /= base;
+	} while (v != 0U);
+
+	return p;
+}
+
+static int int_out(const struct log_output *output,
+		   const struct fast_spec *spec, va_list *ap)
+{
+	bool is_signed = (spec->conv == 'd' || spec->conv == 'i');
+	char buf[sizeof("18446744073709551615")];
+	char *end = buf + sizeof(buf);
+	bool negative = false;
+	uint64_t value;
+	int64_t svalue;
+	char *p;
+
+	switch (spec->length) {
+	case FAST_LENGTH_HH:
+		svalue = is_signed ? (signed char)va_arg(*ap, int) :
+				     (unsigned char)va_arg(*ap, unsigned int);
+		break;
+	case FAST_LENGTH_H:
+		svalue = is_signed ? (short)va_arg(*ap, int) :
+				     (unsigned short)va_arg(*ap, unsigned int);
+		break;
+	case FAST_LENGTH_L:
+		svalue = is_signed ? va_arg(*ap, long) :
+				     (int64_t)va_arg(*ap, unsigned long);
+		break;
+	case FAST_LENGTH_LL:
+		svalue = (int64_t)va_arg(*ap, long long);
+		break;
+	case FAST_LENGTH_Z:
+		svalue = is_signed ? (intptr_t)va_arg(*ap, size_t) :
+				     (int64_t)va_arg(*ap, size_t);
+		break;
+	default:
+		svalue = is_signed ? va_arg(*ap, int) :
+				     (int64_t)va_arg(*ap, unsigned int);
+		break;
+	}
+
+	if (is_signed && svalue < 0) {
+		negative = true;
+		value = -(uint64_t)svalue;
+	} else {
+		value = (uint64_t)svalue;
+	}
+
+	p = digits_get(end, value, spec->conv);
+
+	return field_out(output, spec, negative, p, end - p);
+}
+
+/* Formatter used in place of cbvprintf. Literal text is copied in chunks and
+ * common conversions are done here, other formats are given to cbvprintf.
+ */
+static int fast_vprintf(cbprintf_cb out, void *ctx, const char *fmt,
+			va_list ap)
+{
+	const struct log_output *output = (const struct log_output *)ctx;
+	struct fast_spec spec;
+	va_list args;
+	int length = 0;
+
+	if (out != out_func || !fast_fmt_supported(fmt)) {
+		return cbvprintf(out, ctx, fmt, ap);
+	}
+
+	va_copy(args, ap);
+
+	while (*fmt != '\0') {
+		const char *lit = fmt;
+
+		while (*fmt != '\0' && *fmt != '%') {
+			fmt++;
+		}
+
+		chunk_out(output, lit, fmt - lit);
+		length += fmt - lit;
+
+		if (*fmt == '\0') {
+			break;
+		}
+
+		fmt++;
+		(void)fast_spec_parse(&fmt, &spec);
+
+		switch (spec.conv) {
+		case '%':
+			chunk_out(output, "%", 1);
+			length++;
+			break;
+		case 'c': {
+			char c = (char)va_arg(args, int);
+
+			length += field_out(output, &spec, false, &c, 1);
+			break;
+		}
+		case 's': {
+			const char *str = va_arg(args, const char *);
+
+			if (str == NULL) {
+				str = "(null)";
+			}
+
+			length += field_out(output, &spec, false, str, strlen(str));
+			break;
+		}
+		default:
+			length += int_out(output, &spec, &args);
+			break;
+		}
+	}
+
+	va_end(args);
+
+	return length;
+}
+#endif /* CONFIG_LOG_OUTPUT_FAST_FORMATTING */
+
 static int print_formatted(const struct log_output *output,
 			   const char *fmt, ...)
 {
@@ -141,22 +488,32 @@ static int print_formatted(const struct log_output *output,
 	int length = 0;
 
 	va_start(args, fmt);
+#ifdef CONFIG_LOG_OUTPUT_FAST_FORMATTING
+	length = fast_vprintf(out_func, (void *)output, fmt, args);
+#else
 	length = cbvprintf(out_func, (void *)output, fmt, args);
+#endif
 	va_end(args);
 
 	return length;
 }
 
-static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
-			 void *ctx)
+static int package_print(const struct log_output *output, cbprintf_cb cb,
+			 void *package)
 {
-	int processed;
+#ifdef CONFIG_LOG_OUTPUT_FAST_FORMATTING
+#ifdef CONFIG_CBPRINTF_PACKAGE_SUPPORT_TAGGED_ARGUMENTS
+	union cbprintf_package_hdr *hdr = (union cbprintf_package_hdr *)package;
 
-	do {
-		processed = outf(buf, len, ctx);
-		len -= processed;
-		buf += processed;
-	} while (len != 0);
+	if ((hdr->desc.pkg_flags & CBPRINTF_PACKAGE_ARGS_ARE_TAGGED) ==
+	    CBPRINTF_PACKAGE_ARGS_ARE_TAGGED) {
+		return cbpprintf(cb, (void *)output, package);
+	}
+#endif
+	return cbpprintf_external(cb, fast_vprintf, (void *)output, package);
+#else
+	return cbpprintf(cb, (void *)output, package);
+#endif
 }
 
 
@@ -515,7 +872,7 @@ void log_output_process(const struct log_output *output,
 	}
 
 	if (package) {
-		int err = cbpprintf(cb, (void *)output, (void *)package);
+		int err = package_print(output, cb, (void *)package);
 
 		(void)err;
 		__ASSERT_NO_MSG(err >= 0);
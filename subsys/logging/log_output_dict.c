@@ -11,6 +11,8 @@
 #include <zephyr/logging/log_output_dict.h>
 #include <zephyr/sys/__assert.h>
 #include <zephyr/sys/util.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
 
 static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
 			 void *ctx)
@@ -45,18 +47,20 @@ void log_dict_output_msg_process(const struct log_output *output,
 				0U;
 
 	buffer_write(output->func, (uint8_t *)&output_hdr, sizeof(output_hdr),
-		     (void *)output);
+		     output->control_block->ctx);
 
 	size_t len;
 	uint8_t *data = log_msg_get_package(msg, &len);
 
 	if (len > 0U) {
-		buffer_write(output->func, data, len, (void *)output);
+		buffer_write(output->func, data, len,
+			     output->control_block->ctx);
 	}
 
 	data = log_msg_get_data(msg, &len);
 	if (len > 0U) {
-		buffer_write(output->func, data, len, (void *)output);
+		buffer_write(output->func, data, len,
+			     output->control_block->ctx);
 	}
 
 	log_output_flush(output);
@@ -70,5 +74,124 @@ void log_dict_output_dropped_process(const struct log_output *output, uint32_t c
 	msg.num_dropped_messages = MIN(cnt, 9999);
 
 	buffer_write(output->func, (uint8_t *)&msg, sizeof(msg),
-		     (void *)output);
+		     output->control_block->ctx);
 }
+
+#ifdef CONFIG_LOG_DICTIONARY_BLOCK
+
+/* Runs of zero bytes, plentiful in the message headers and packages, are
+ * encoded as a zero byte followed by the length of the run. Other bytes are
+ * copied. Returns the encoded length, or 0 if it is not less than @p len.
+ */
+static size_t block_compress(const uint8_t *src, size_t len, uint8_t *dst)
+{
+	size_t out = 0;
+	size_t i = 0;
+
+	while (i < len) {
+		if (out + 2 >= len) {
+			return 0;
+		}
+
+		if (src[i] != 0U) {
+			dst[out++] = src[i++];
+			continue;
+		}
+
+		size_t run = 1;
+
+		while ((i + run < len) && (src[i + run] == 0U) && (run < UINT8_MAX)) {
+			run++;
+		}
+
+		dst[out++] = 0U;
+		dst[out++] = (uint8_t)run;
+		i += run;
+	}
+
+	return out;
+}
+
+static void block_send(struct log_dict_block *block, size_t len)
+{
+	struct log_dict_output_block_hdr_t *hdr =
+		(struct log_dict_output_block_hdr_t *)block->frame;
+	uint8_t *payload = &block->frame[sizeof(*hdr)];
+	size_t payload_len = 0;
+
+	hdr->magic[0] = 'Z';
+	hdr->magic[1] = 'L';
+	hdr->magic[2] = 'D';
+	hdr->magic[3] = 'B';
+	hdr->version = LOG_DICT_BLOCK_VERSION;
+	hdr->flags = 0U;
+
+	if (IS_ENABLED(CONFIG_LOG_DICTIONARY_BLOCK_COMPRESSION)) {
+		payload_len = block_compress(block->buf, len, payload);
+	}
+
+	if (payload_len > 0) {
+		hdr->flags |= LOG_DICT_BLOCK_FLAG_COMPRESSED;
+	} else {
+		memcpy(payload, block->buf, len);
+		payload_len = len;
+	}
+
+	hdr->seq = sys_cpu_to_le16(block->seq);
+	hdr->len = sys_cpu_to_le16((uint16_t)payload_len);
+	hdr->raw_len = sys_cpu_to_le16((uint16_t)len);
+	block->seq++;
+
+	buffer_write(block->func, block->frame, sizeof(*hdr) + payload_len,
+		     block->ctx);
+}
+
+int log_dict_block_out(uint8_t *data, size_t length, void *ctx)
+{
+	struct log_dict_block *block = ctx;
+	size_t chunk;
+
+	if ((block->wr + length > block->size) && (block->len > 0)) {
+		/* Send the complete messages and move the beginning of the
+		 * current one to the start of the next block.
+		 */
+		size_t partial = block->wr - block->len;
+
+		block_send(block, block->len);
+		memmove(block->buf, &block->buf[block->len], partial);
+		block->wr = partial;
+		block->len = 0;
+	}
+
+	chunk = MIN(length, block->size - block->wr);
+	memcpy(&block->buf[block->wr], data, chunk);
+	block->wr += chunk;
+
+	if (block->wr == block->size) {
+		/* Message does not fit in a block, it is split. */
+		block_send(block, block->wr);
+		block->wr = 0;
+		block->len = 0;
+	}
+
+	return chunk;
+}
+
+void log_dict_block_commit(struct log_dict_block *block)
+{
+	block->len = block->wr;
+}
+
+void log_dict_block_flush(struct log_dict_block *block)
+{
+	if (block->len == 0) {
+		return;
+	}
+
+	block_send(block, block->len);
+	memmove(block->buf, &block->buf[block->len], block->wr - block->len);
+	block->wr -= block->len;
+	block->len = 0;
+}
+
+#endif /* CONFIG_LOG_DICTIONARY_BLOCK */
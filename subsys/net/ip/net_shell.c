@@ -2019,6 +2019,224 @@ static int cmd_net_capture_disable(const struct shell *sh, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_NET_CAPTURE)
+static int capture_parse_filter(const struct shell *sh, size_t argc,
+				char *argv[], struct net_capture_filter *filter)
+{
+	char expr[64];
+	size_t pos = 0;
+	int ret;
+
+	expr[0] = '\0';
+
+	for (size_t i = 0; i < argc; i++) {
+		ret = snprintk(&expr[pos], sizeof(expr) - pos, "%s%s",
+			       i > 0 ? " " : "", argv[i]);
+		if (ret < 0 || ret >= sizeof(expr) - pos) {
+			PR_WARNING("Filter expression too long\n");
+			return -ENOEXEC;
+		}
+
+		pos += ret;
+	}
+
+	ret = net_capture_filter_parse(expr, filter);
+	if (ret < 0) {
+		PR_WARNING("Invalid filter expression \"%s\"\n", expr);
+		return -ENOEXEC;
+	}
+
+	return 0;
+}
+#endif
+
+static int cmd_net_capture_filter(const struct shell *sh, size_t argc,
+				  char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE)
+	struct net_capture_filter filter;
+	int ret;
+
+	if (capture_dev == NULL) {
+		PR_INFO("Network packet capture %s\n", "not configured");
+		return 0;
+	}
+
+	ret = capture_parse_filter(sh, argc - 1, &argv[1], &filter);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = net_capture_set_filter(capture_dev, &filter);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "filter", ret);
+		return -ENOEXEC;
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE", "network packet capture");
+#endif
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+static int capture_ring_dump_cb(const uint8_t *data, size_t len,
+				void *user_data)
+{
+	const struct shell *sh = user_data;
+
+	/* Plain hex so that the output can be turned back into a pcap
+	 * file with "xxd -r -p".
+	 */
+	for (size_t i = 0; i < len; i++) {
+		PR("%02x", data[i]);
+
+		if ((i % 32) == 31) {
+			PR("\n");
+		}
+	}
+
+	if ((len % 32) != 0) {
+		PR("\n");
+	}
+
+	return 0;
+}
+#endif
+
+static int cmd_net_capture_ring(const struct shell *sh, size_t argc,
+				char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+	struct net_capture_ring_stats stats;
+
+	net_capture_ring_get_stats(&stats);
+
+	PR_INFO("Capture ring %s\n",
+		net_capture_ring_is_enabled() ? "enabled" : "disabled");
+	PR("Captured   : %u\n", stats.captured);
+	PR("Filtered   : %u\n", stats.filtered);
+	PR("Truncated  : %u\n", stats.truncated);
+	PR("Overwritten: %u\n", stats.overwritten);
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_ring_enable(const struct shell *sh, size_t argc,
+				       char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_RING)
+	struct net_capture_filter filter;
+	struct net_if *iface;
+	size_t snaplen = 0;
+	int ret, arg = 1;
+	int if_index;
+
+	if_index = atoi(argv[arg++]);
+	iface = net_if_get_by_index(if_index);
+	if (iface == NULL) {
+		PR_WARNING("No such interface with index %d\n", if_index);
+		return -ENOEXEC;
+	}
+
+	if (arg < argc && argv[arg][0] >= '0' && argv[arg][0] <= '9') {
+		snaplen = atoi(argv[arg++]);
+	}
+
+	ret = capture_parse_filter(sh, argc - arg, &argv[arg], &filter);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = net_capture_ring_enable(iface, &filter, snaplen);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "enable", ret);
+		return -ENOEXEC;
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_ring_disable(const struct shell *sh, size_t argc,
+					char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+	(void)net_capture_ring_disable();
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_ring_dump(const struct shell *sh, size_t argc,
+				     char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+	int ret;
+
+	ret = net_capture_ring_dump(capture_ring_dump_cb, (void *)sh);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "dump", ret);
+		return -ENOEXEC;
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_ring_save(const struct shell *sh, size_t argc,
+				     char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_RING_FS)
+	int ret;
+
+	ret = net_capture_ring_save(argv[1]);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "save", ret);
+		return -ENOEXEC;
+	}
+
+	PR_INFO("Saved %d packets to %s\n", ret, argv[1]);
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING_FS", "capture ring file system");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_conn(const struct shell *sh, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -6232,6 +6450,21 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_arp,
 	SHELL_SUBCMD_SET_END
 );
 
+SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture_ring,
+	SHELL_CMD_ARG(enable, NULL, "Capture packets into the in-memory ring.\n"
+		      "'net capture ring enable <iface index> [snaplen] [expression]'",
+		      cmd_net_capture_ring_enable, 2, 16),
+	SHELL_CMD(disable, NULL, "Stop capturing packets into the ring.",
+		  cmd_net_capture_ring_disable),
+	SHELL_CMD(dump, NULL, "Dump the ring as hex encoded pcap data.\n"
+		  "Convert it back to a pcap file with 'xxd -r -p'.",
+		  cmd_net_capture_ring_dump),
+	SHELL_CMD_ARG(save, NULL, "Save the ring to a pcap file.\n"
+		      "'net capture ring save <path>'",
+		      cmd_net_capture_ring_save, 2, 0),
+	SHELL_SUBCMD_SET_END
+);
+
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 	SHELL_CMD(setup, NULL, "Setup network packet capture.\n"
 		  "'net capture setup <remote-ip-addr> <local-addr> <peer-addr>'\n"
@@ -6249,6 +6482,13 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 		  cmd_net_capture_enable),
 	SHELL_CMD(disable, NULL, "Disable network packet capture.",
 		  cmd_net_capture_disable),
+	SHELL_CMD(filter, NULL, "Set the tunnel capture filter.\n"
+		  "'net capture filter [expression]'\n"
+		  "Expression is for example \"udp and port 53 and host 192.0.2.1\"",
+		  cmd_net_capture_filter),
+	SHELL_CMD(ring, &net_cmd_capture_ring,
+		  "Print in-memory capture ring information.",
+		  cmd_net_capture_ring),
 	SHELL_SUBCMD_SET_END
 );
 
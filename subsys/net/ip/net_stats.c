@@ -29,6 +29,14 @@ LOG_MODULE_REGISTER(net_stats, NET_LOG_LEVEL);
  */
 struct net_stats net_stats = { 0 };
 
+#if defined(CONFIG_NET_STATISTICS_METRICS)
+METRIC_COUNTER_DEFINE(net_bytes_received_total, "Bytes received on all interfaces");
+METRIC_COUNTER_DEFINE(net_bytes_sent_total, "Bytes sent on all interfaces");
+METRIC_COUNTER_DEFINE(net_processing_errors_total, "Packets dropped by processing errors");
+METRIC_HISTOGRAM_DEFINE(net_received_packet_bytes, "Size of the received packets",
+			64, 128, 256, 512, 1024, 1536);
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT)
 
 #define PRINT_STATISTICS_INTERVAL (30 * MSEC_PER_SEC)
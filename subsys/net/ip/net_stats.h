@@ -27,6 +27,19 @@ extern struct net_stats net_stats;
 #define GET_STAT_ADDR(iface, s) (&GET_STAT(iface, s))
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_METRICS)
+#include <zephyr/stats/metrics.h>
+
+METRIC_DECLARE(net_bytes_received_total);
+METRIC_DECLARE(net_bytes_sent_total);
+METRIC_DECLARE(net_processing_errors_total);
+METRIC_DECLARE(net_received_packet_bytes);
+
+#define UPDATE_METRIC(cmd) (cmd)
+#else
+#define UPDATE_METRIC(cmd)
+#endif
+
 #define UPDATE_STAT_GLOBAL(cmd) (net_##cmd)
 #define UPDATE_STAT(_iface, _cmd) \
 	{ NET_ASSERT(_iface); (UPDATE_STAT_GLOBAL(_cmd)); \
@@ -36,6 +49,7 @@ extern struct net_stats net_stats;
 static inline void net_stats_update_processing_error(struct net_if *iface)
 {
 	UPDATE_STAT(iface, stats.processing_error++);
+	UPDATE_METRIC(metric_counter_inc(&net_processing_errors_total));
 }
 
 static inline void net_stats_update_ip_errors_protoerr(struct net_if *iface)
@@ -52,12 +66,15 @@ static inline void net_stats_update_bytes_recv(struct net_if *iface,
 					       uint32_t bytes)
 {
 	UPDATE_STAT(iface, stats.bytes.received += bytes);
+	UPDATE_METRIC(metric_counter_add(&net_bytes_received_total, bytes));
+	UPDATE_METRIC(metric_histogram_observe(&net_received_packet_bytes, bytes));
 }
 
 static inline void net_stats_update_bytes_sent(struct net_if *iface,
 					       uint32_t bytes)
 {
 	UPDATE_STAT(iface, stats.bytes.sent += bytes);
+	UPDATE_METRIC(metric_counter_add(&net_bytes_sent_total, bytes));
 }
 #else
 #define net_stats_update_processing_error(iface)
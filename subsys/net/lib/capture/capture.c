@@ -18,6 +18,7 @@ LOG_MODULE_REGISTER(net_capture, CONFIG_NET_CAPTURE_LOG_LEVEL);
 #include <zephyr/net/virtual_mgmt.h>
 #include <zephyr/net/capture.h>
 #include <zephyr/net/ethernet.h>
+#include <zephyr/sys/byteorder.h>
 
 #include "net_private.h"
 #include "ipv4.h"
@@ -80,6 +81,11 @@ struct net_capture {
 	 */
 	struct sockaddr local;
 
+	/**
+	 * Only packets matching this filter are captured.
+	 */
+	struct net_capture_filter filter;
+
 	/**
 	 * Is this context setup already
 	 */
@@ -126,6 +132,7 @@ void net_capture_foreach(net_capture_cb_t cb, void *user_data)
 		info.tunnel_iface = ctx->tunnel_iface;
 		info.peer = &ctx->peer;
 		info.local = &ctx->local;
+		info.filter = &ctx->filter;
 		info.is_enabled = ctx->is_enabled;
 
 		k_mutex_unlock(&lock);
@@ -136,6 +143,318 @@ void net_capture_foreach(net_capture_cb_t cb, void *user_data)
 	k_mutex_unlock(&lock);
 }
 
+static int filter_next_token(const char **expr, char *token, size_t token_len)
+{
+	const char *start = *expr;
+	size_t len;
+
+	while (*start == ' ' || *start == '\t') {
+		start++;
+	}
+
+	len = 0;
+	while (start[len] != '\0' && start[len] != ' ' && start[len] != '\t') {
+		len++;
+	}
+
+	if (len >= token_len) {
+		return -EINVAL;
+	}
+
+	memcpy(token, start, len);
+	token[len] = '\0';
+	*expr = start + len;
+
+	return len;
+}
+
+static int filter_set_family(struct net_capture_filter *filter,
+			     sa_family_t family)
+{
+	if ((filter->flags & NET_CAPTURE_FILTER_FAMILY) &&
+	    filter->family != family) {
+		return -EINVAL;
+	}
+
+	filter->family = family;
+	filter->flags |= NET_CAPTURE_FILTER_FAMILY;
+
+	return 0;
+}
+
+static int filter_set_proto(struct net_capture_filter *filter, uint8_t proto)
+{
+	if ((filter->flags & NET_CAPTURE_FILTER_PROTO) &&
+	    filter->proto != proto) {
+		return -EINVAL;
+	}
+
+	filter->proto = proto;
+	filter->flags |= NET_CAPTURE_FILTER_PROTO;
+
+	return 0;
+}
+
+int net_capture_filter_parse(const char *expr, struct net_capture_filter *filter)
+{
+	char token[NET_IPV6_ADDR_LEN];
+	bool need_term = true;
+	int terms = 0;
+	int ret;
+
+	if (expr == NULL || filter == NULL) {
+		return -EINVAL;
+	}
+
+	memset(filter, 0, sizeof(*filter));
+
+	while ((ret = filter_next_token(&expr, token, sizeof(token))) > 0) {
+		if (!need_term) {
+			if (strcmp(token, "and") != 0 && strcmp(token, "&&") != 0) {
+				NET_ERR("Expected \"%s\" but got \"%s\"", "and", token);
+				return -EINVAL;
+			}
+
+			need_term = true;
+			continue;
+		}
+
+		if (strcmp(token, "any") == 0) {
+			ret = 0;
+		} else if (strcmp(token, "ip") == 0) {
+			ret = filter_set_family(filter, AF_INET);
+		} else if (strcmp(token, "ip6") == 0) {
+			ret = filter_set_family(filter, AF_INET6);
+		} else if (strcmp(token, "tcp") == 0) {
+			ret = filter_set_proto(filter, IPPROTO_TCP);
+		} else if (strcmp(token, "udp") == 0) {
+			ret = filter_set_proto(filter, IPPROTO_UDP);
+		} else if (strcmp(token, "icmp") == 0) {
+			ret = filter_set_proto(filter, IPPROTO_ICMP);
+			if (ret == 0) {
+				ret = filter_set_family(filter, AF_INET);
+			}
+		} else if (strcmp(token, "icmp6") == 0) {
+			ret = filter_set_proto(filter, IPPROTO_ICMPV6);
+			if (ret == 0) {
+				ret = filter_set_family(filter, AF_INET6);
+			}
+		} else if (strcmp(token, "port") == 0) {
+			char *endptr;
+			unsigned long port;
+
+			ret = filter_next_token(&expr, token, sizeof(token));
+			if (ret <= 0) {
+				NET_ERR("Missing %s value", "port");
+				return -EINVAL;
+			}
+
+			port = strtoul(token, &endptr, 10);
+			if (*endptr != '\0' || port == 0 || port > UINT16_MAX) {
+				NET_ERR("Invalid %s value \"%s\"", "port", token);
+				return -EINVAL;
+			}
+
+			filter->port = port;
+			filter->flags |= NET_CAPTURE_FILTER_PORT;
+			ret = 0;
+		} else if (strcmp(token, "host") == 0) {
+			ret = filter_next_token(&expr, token, sizeof(token));
+			if (ret <= 0) {
+				NET_ERR("Missing %s value", "host");
+				return -EINVAL;
+			}
+
+			if (!net_ipaddr_parse(token, strlen(token), &filter->addr)) {
+				NET_ERR("Invalid %s value \"%s\"", "host", token);
+				return -EINVAL;
+			}
+
+			filter->flags |= NET_CAPTURE_FILTER_HOST;
+			ret = filter_set_family(filter, filter->addr.sa_family);
+		} else {
+			NET_ERR("Unknown filter primitive \"%s\"", token);
+			return -EINVAL;
+		}
+
+		if (ret < 0) {
+			NET_ERR("Conflicting filter primitive \"%s\"", token);
+			return ret;
+		}
+
+		need_term = false;
+		terms++;
+	}
+
+	if (ret < 0 || (need_term && terms > 0)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Enough to cover a VLAN tagged Ethernet header, an IPv6 header and
+ * the port numbers of the transport header.
+ */
+#define FILTER_HDR_LEN (sizeof(struct net_eth_hdr) + 4 + \
+			sizeof(struct net_ipv6_hdr) + 4)
+
+bool net_capture_filter_match(const struct net_capture_filter *filter,
+			      struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t hdr[FILTER_HDR_LEN];
+	const uint8_t *src, *dst;
+	sa_family_t family;
+	size_t offset = 0;
+	size_t addr_len;
+	size_t len;
+	uint8_t proto;
+
+	if (filter == NULL || filter->flags == 0) {
+		return true;
+	}
+
+	len = net_buf_linearize(hdr, sizeof(hdr), pkt->buffer, 0, sizeof(hdr));
+
+	switch (net_if_get_link_addr(iface)->type) {
+	case NET_LINK_ETHERNET: {
+		uint16_t type;
+
+		if (len < sizeof(struct net_eth_hdr)) {
+			return false;
+		}
+
+		offset = sizeof(struct net_eth_hdr);
+		type = sys_get_be16(&hdr[offset - 2]);
+
+		if (type == NET_ETH_PTYPE_VLAN) {
+			if (len < offset + 4) {
+				return false;
+			}
+
+			type = sys_get_be16(&hdr[offset + 2]);
+			offset += 4;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return false;
+		}
+
+		break;
+	}
+	case NET_LINK_UNKNOWN:
+	case NET_LINK_DUMMY:
+		/* Raw IP packets */
+		break;
+	default:
+		return false;
+	}
+
+	if (len <= offset) {
+		return false;
+	}
+
+	if ((hdr[offset] & 0xf0) == 0x40) {
+		const struct net_ipv4_hdr *ipv4;
+
+		if (len < offset + sizeof(*ipv4)) {
+			return false;
+		}
+
+		ipv4 = (const struct net_ipv4_hdr *)&hdr[offset];
+		family = AF_INET;
+		proto = ipv4->proto;
+		src = ipv4->src;
+		dst = ipv4->dst;
+		addr_len = sizeof(struct in_addr);
+
+		/* Only the first fragment carries the transport header */
+		if ((sys_get_be16(ipv4->offset) & NET_IPV4_FRAGH_OFFSET_MASK) != 0) {
+			proto = 0;
+		}
+
+		offset += (ipv4->vhl & 0x0f) * 4U;
+	} else if ((hdr[offset] & 0xf0) == 0x60) {
+		const struct net_ipv6_hdr *ipv6;
+
+		if (len < offset + sizeof(*ipv6)) {
+			return false;
+		}
+
+		ipv6 = (const struct net_ipv6_hdr *)&hdr[offset];
+		family = AF_INET6;
+		proto = ipv6->nexthdr;
+		src = ipv6->src;
+		dst = ipv6->dst;
+		addr_len = sizeof(struct in6_addr);
+		offset += sizeof(*ipv6);
+	} else {
+		return false;
+	}
+
+	if ((filter->flags & NET_CAPTURE_FILTER_FAMILY) &&
+	    filter->family != family) {
+		return false;
+	}
+
+	if ((filter->flags & NET_CAPTURE_FILTER_PROTO) &&
+	    filter->proto != proto) {
+		return false;
+	}
+
+	if (filter->flags & NET_CAPTURE_FILTER_HOST) {
+		const uint8_t *addr = family == AF_INET6 ?
+			(const uint8_t *)&net_sin6(&filter->addr)->sin6_addr :
+			(const uint8_t *)&net_sin(&filter->addr)->sin_addr;
+
+		if (memcmp(src, addr, addr_len) != 0 &&
+		    memcmp(dst, addr, addr_len) != 0) {
+			return false;
+		}
+	}
+
+	if (filter->flags & NET_CAPTURE_FILTER_PORT) {
+		if (proto != IPPROTO_UDP && proto != IPPROTO_TCP) {
+			return false;
+		}
+
+		if (len < offset + 4) {
+			return false;
+		}
+
+		if (sys_get_be16(&hdr[offset]) != filter->port &&
+		    sys_get_be16(&hdr[offset + 2]) != filter->port) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int net_capture_set_filter(const struct device *dev,
+			   const struct net_capture_filter *filter)
+{
+	struct net_capture *ctx;
+
+	if (dev == NULL) {
+		return -EINVAL;
+	}
+
+	ctx = dev->data;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	if (filter == NULL) {
+		memset(&ctx->filter, 0, sizeof(ctx->filter));
+	} else {
+		ctx->filter = *filter;
+	}
+
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
 static struct net_capture *alloc_capture_dev(void)
 {
 	struct net_capture *ctx = NULL;
@@ -452,6 +771,7 @@ static int capture_cleanup(const struct device *dev)
 	(void)cleanup_iface(ctx->tunnel_iface, &ctx->local);
 
 	ctx->tunnel_iface = NULL;
+	memset(&ctx->filter, 0, sizeof(ctx->filter));
 	ctx->in_use = false;
 
 	return 0;
@@ -512,6 +832,8 @@ void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 		return;
 	}
 
+	net_capture_ring_pkt(iface, pkt);
+
 	k_mutex_lock(&lock, K_FOREVER);
 
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&net_capture_devlist, sn, sns) {
@@ -524,6 +846,13 @@ void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 			continue;
 		}
 
+		/* Check the filter before cloning so that uninteresting
+		 * packets do not cost any allocations.
+		 */
+		if (!net_capture_filter_match(&ctx->filter, iface, pkt)) {
+			goto out;
+		}
+
 		orig_slab = pkt->slab;
 		pkt->slab = get_net_pkt();
 
@@ -0,0 +1,344 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* In-memory pcap ring for network packet capture.
+ *
+ * The ring is an array of fixed size slots. A producer claims the next
+ * sequence number by atomically incrementing the head, then takes
+ * ownership of its slot by swapping the slot sequence number for
+ * SLOT_BUSY, copies the packet into the slot and publishes it by storing
+ * its sequence number (plus one). A producer finding the slot owned by
+ * another one, which only happens when the ring wraps around while a
+ * record is being written, drops its packet. No lock is taken on the
+ * packet path, so capturing does not serialize the TX and RX threads and
+ * no net_pkt or net_buf is allocated.
+ *
+ * The reader walks the last CONFIG_NET_CAPTURE_RING_SLOTS sequence
+ * numbers, copies each published slot and re-checks the slot sequence
+ * number afterwards to detect records that were overwritten while they
+ * were being copied. Fences order the slot contents with respect to the
+ * sequence number updates on both sides.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_capture, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/capture.h>
+
+#if defined(CONFIG_NET_CAPTURE_RING_FS)
+#include <zephyr/fs/fs.h>
+#endif
+
+#define PCAP_MAGIC         0xa1b2c3d4
+#define PCAP_VERSION_MAJOR 2
+#define PCAP_VERSION_MINOR 4
+
+#define LINKTYPE_ETHERNET           1
+#define LINKTYPE_RAW                101
+#define LINKTYPE_IEEE802_15_4_NOFCS 230
+
+#define RING_SLOTS   CONFIG_NET_CAPTURE_RING_SLOTS
+#define RING_SNAPLEN CONFIG_NET_CAPTURE_RING_SNAPLEN
+
+/* Slot sequence number while a producer writes the slot */
+#define SLOT_BUSY ((atomic_val_t)-1)
+
+struct pcap_file_hdr {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	int32_t thiszone;
+	uint32_t sigfigs;
+	uint32_t snaplen;
+	uint32_t network;
+} __packed;
+
+struct pcap_record_hdr {
+	uint32_t ts_sec;
+	uint32_t ts_usec;
+	uint32_t incl_len;
+	uint32_t orig_len;
+} __packed;
+
+struct capture_slot {
+	/** Sequence number of the record plus one, SLOT_BUSY while written */
+	atomic_t seq;
+	struct pcap_record_hdr hdr;
+	uint8_t data[RING_SNAPLEN];
+};
+
+static struct capture_slot ring[RING_SLOTS];
+
+/* Scratch copy of a slot used while dumping, protected by dump_lock */
+static struct capture_slot dump_slot;
+static K_MUTEX_DEFINE(dump_lock);
+
+static atomic_t ring_head;
+static atomic_t ring_enabled;
+static struct net_if *ring_iface;
+static struct net_capture_filter ring_filter;
+static uint32_t ring_snaplen;
+static uint32_t ring_linktype;
+
+static atomic_t stat_captured;
+static atomic_t stat_filtered;
+static atomic_t stat_truncated;
+static atomic_t stat_torn;
+
+static uint32_t get_linktype(struct net_if *iface)
+{
+	switch (net_if_get_link_addr(iface)->type) {
+	case NET_LINK_ETHERNET:
+		return LINKTYPE_ETHERNET;
+	case NET_LINK_IEEE802154:
+		return LINKTYPE_IEEE802_15_4_NOFCS;
+	default:
+		return LINKTYPE_RAW;
+	}
+}
+
+int net_capture_ring_enable(struct net_if *iface,
+			    const struct net_capture_filter *filter,
+			    size_t snaplen)
+{
+	int ret = 0;
+
+	if (iface == NULL) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&dump_lock, K_FOREVER);
+
+	if (atomic_get(&ring_enabled)) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	if (filter == NULL) {
+		memset(&ring_filter, 0, sizeof(ring_filter));
+	} else {
+		ring_filter = *filter;
+	}
+
+	if (snaplen == 0 || snaplen > RING_SNAPLEN) {
+		snaplen = RING_SNAPLEN;
+	}
+
+	ring_iface = iface;
+	ring_snaplen = snaplen;
+	ring_linktype = get_linktype(iface);
+
+	for (int i = 0; i < RING_SLOTS; i++) {
+		atomic_clear(&ring[i].seq);
+	}
+
+	atomic_clear(&ring_head);
+	atomic_clear(&stat_captured);
+	atomic_clear(&stat_filtered);
+	atomic_clear(&stat_truncated);
+	atomic_clear(&stat_torn);
+
+	atomic_set(&ring_enabled, 1);
+
+out:
+	k_mutex_unlock(&dump_lock);
+
+	return ret;
+}
+
+int net_capture_ring_disable(void)
+{
+	if (!atomic_cas(&ring_enabled, 1, 0)) {
+		return -EALREADY;
+	}
+
+	return 0;
+}
+
+bool net_capture_ring_is_enabled(void)
+{
+	return atomic_get(&ring_enabled) != 0;
+}
+
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct capture_slot *slot;
+	uint64_t now_us;
+	atomic_val_t old;
+	uint32_t caplen;
+	uint32_t seq;
+	size_t len;
+
+	if (!atomic_get(&ring_enabled) || ring_iface != iface) {
+		return;
+	}
+
+	if (!net_capture_filter_match(&ring_filter, iface, pkt)) {
+		atomic_inc(&stat_filtered);
+		return;
+	}
+
+	len = net_pkt_get_len(pkt);
+	caplen = MIN(len, ring_snaplen);
+	now_us = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	seq = (uint32_t)atomic_inc(&ring_head);
+	slot = &ring[seq % RING_SLOTS];
+
+	old = atomic_get(&slot->seq);
+	if (old == SLOT_BUSY || !atomic_cas(&slot->seq, old, SLOT_BUSY)) {
+		/* Still being written by a producer from the previous lap */
+		atomic_inc(&stat_torn);
+		return;
+	}
+
+	/* Readers must see the slot as busy before any of its new contents */
+	barrier_dmem_fence_full();
+
+	slot->hdr.ts_sec = (uint32_t)(now_us / USEC_PER_SEC);
+	slot->hdr.ts_usec = (uint32_t)(now_us % USEC_PER_SEC);
+	slot->hdr.orig_len = len;
+	slot->hdr.incl_len = net_buf_linearize(slot->data, caplen, pkt->buffer,
+					       0, caplen);
+
+	/* Publish the contents before the sequence number */
+	barrier_dmem_fence_full();
+	atomic_set(&slot->seq, (atomic_val_t)(seq + 1U));
+
+	atomic_inc(&stat_captured);
+	if (caplen < len) {
+		atomic_inc(&stat_truncated);
+	}
+}
+
+int net_capture_ring_dump(net_capture_ring_dump_cb_t cb, void *user_data)
+{
+	struct pcap_file_hdr file_hdr = {
+		.magic = PCAP_MAGIC,
+		.version_major = PCAP_VERSION_MAJOR,
+		.version_minor = PCAP_VERSION_MINOR,
+	};
+	uint32_t start, end, seq;
+	int count = 0;
+	int ret;
+
+	if (cb == NULL) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&dump_lock, K_FOREVER);
+
+	file_hdr.snaplen = ring_snaplen != 0U ? ring_snaplen : RING_SNAPLEN;
+	file_hdr.network = ring_linktype != 0U ? ring_linktype : LINKTYPE_RAW;
+
+	ret = cb((const uint8_t *)&file_hdr, sizeof(file_hdr), user_data);
+	if (ret < 0) {
+		goto out;
+	}
+
+	end = (uint32_t)atomic_get(&ring_head);
+	start = end > RING_SLOTS ? end - RING_SLOTS : 0U;
+
+	for (seq = start; seq != end; seq++) {
+		struct capture_slot *slot = &ring[seq % RING_SLOTS];
+
+		if ((uint32_t)atomic_get(&slot->seq) != seq + 1U) {
+			continue;
+		}
+
+		/* Do not read the contents before the sequence number */
+		barrier_dmem_fence_full();
+
+		dump_slot.hdr = slot->hdr;
+		dump_slot.hdr.incl_len = MIN(dump_slot.hdr.incl_len, RING_SNAPLEN);
+		memcpy(dump_slot.data, slot->data, dump_slot.hdr.incl_len);
+
+		/* The producers may have wrapped around while we were
+		 * copying, in which case the copy is not consistent.
+		 */
+		barrier_dmem_fence_full();
+		if ((uint32_t)atomic_get(&slot->seq) != seq + 1U) {
+			atomic_inc(&stat_torn);
+			continue;
+		}
+
+		ret = cb((const uint8_t *)&dump_slot.hdr, sizeof(dump_slot.hdr),
+			 user_data);
+		if (ret < 0) {
+			goto out;
+		}
+
+		ret = cb(dump_slot.data, dump_slot.hdr.incl_len, user_data);
+		if (ret < 0) {
+			goto out;
+		}
+
+		count++;
+	}
+
+	ret = count;
+
+out:
+	k_mutex_unlock(&dump_lock);
+
+	return ret;
+}
+
+void net_capture_ring_get_stats(struct net_capture_ring_stats *stats)
+{
+	uint32_t head = (uint32_t)atomic_get(&ring_head);
+
+	stats->captured = (uint32_t)atomic_get(&stat_captured);
+	stats->filtered = (uint32_t)atomic_get(&stat_filtered);
+	stats->truncated = (uint32_t)atomic_get(&stat_truncated);
+	stats->overwritten = (head > RING_SLOTS ? head - RING_SLOTS : 0U) +
+		(uint32_t)atomic_get(&stat_torn);
+}
+
+#if defined(CONFIG_NET_CAPTURE_RING_FS)
+static int save_cb(const uint8_t *data, size_t len, void *user_data)
+{
+	struct fs_file_t *file = user_data;
+	ssize_t ret;
+
+	ret = fs_write(file, data, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret == len ? 0 : -ENOSPC;
+}
+
+int net_capture_ring_save(const char *path)
+{
+	struct fs_file_t file;
+	int ret, rc;
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+	if (ret < 0) {
+		NET_ERR("Cannot open %s (%d)", path, ret);
+		return ret;
+	}
+
+	ret = fs_truncate(&file, 0);
+	if (ret == 0) {
+		ret = net_capture_ring_dump(save_cb, &file);
+	}
+
+	rc = fs_close(&file);
+	if (ret >= 0 && rc < 0) {
+		ret = rc;
+	}
+
+	return ret;
+}
+#endif /* CONFIG_NET_CAPTURE_RING_FS */
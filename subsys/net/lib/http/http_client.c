@@ -29,6 +29,14 @@ LOG_MODULE_REGISTER(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
 #define HTTP_CONTENT_LEN_SIZE 11
 #define MAX_SEND_BUF_LEN 192
 
+/* Received data that was not consumed by the response it was read for,
+ * i.e. the beginning of the next pipelined response.
+ */
+struct http_pending_data {
+	uint8_t *data;
+	size_t len;
+};
+
 static int sendall(int sock, const void *buf, size_t len)
 {
 	while (len) {
@@ -260,6 +268,7 @@ static int on_body(struct http_parser *parser, const char *at, size_t length)
 	struct http_request *req = CONTAINER_OF(parser,
 						struct http_request,
 						internal.parser);
+	int ret;
 
 	req->internal.response.body_found = 1;
 	req->internal.response.processed += length;
@@ -272,6 +281,15 @@ static int on_body(struct http_parser *parser, const char *at, size_t length)
 		req->internal.response.http_cb->on_body(parser, at, length);
 	}
 
+	if (req->body_cb) {
+		ret = req->body_cb(&req->internal.response, (const uint8_t *)at,
+				   length, req->internal.user_data);
+		if (ret != 0) {
+			NET_DBG("Body callback aborted the response (%d)", ret);
+			return ret;
+		}
+	}
+
 	/* Reset the body_frag_start pointer for each fragment. */
 	if (!req->internal.response.body_frag_start) {
 		req->internal.response.body_frag_start = (uint8_t *)at;
@@ -344,6 +362,18 @@ static int on_message_complete(struct http_parser *parser)
 
 	req->internal.response.message_complete = 1;
 
+	/* The parser skips the body of 5xx responses, so whatever the server
+	 * sent as body is still to be read and the connection cannot be used
+	 * for another request.
+	 */
+	req->internal.response.keep_alive = http_should_keep_alive(parser) &&
+		!(parser->status_code >= 500 && parser->status_code < 600);
+
+	/* Stop at the end of this response, anything after it belongs to
+	 * the next pipelined response.
+	 */
+	http_parser_pause(parser, 1);
+
 	return 0;
 }
 
@@ -413,132 +443,214 @@ static void http_data_final_null_resp(struct http_request *req)
 	}
 }
 
-static int http_wait_data(int sock, struct http_request *req, int32_t timeout)
+/* Read the next piece of the response into the receive buffer, either from
+ * the data left over by the previous pipelined response or from the socket.
+ * Returns the number of bytes read, 0 if the connection was closed,
+ * -ETIMEDOUT if the timeout expired, <0 on other errors.
+ */
+static int http_read_data(int sock, struct http_request *req, size_t offset,
+			  int32_t *remaining_time, int64_t *timestamp,
+			  struct http_pending_data *pending)
 {
-	int total_received = 0;
-	size_t offset = 0;
-	int received, ret;
+	uint8_t *buf = req->internal.response.recv_buf + offset;
+	size_t len = req->internal.response.recv_buf_len - offset;
 	struct zsock_pollfd fds[1];
-	int nfds = 1;
-	int32_t remaining_time = timeout;
-	int64_t timestamp = k_uptime_get();
+	int received, ret;
+
+	if (pending->len > 0) {
+		received = MIN(pending->len, len);
+		memmove(buf, pending->data, received);
+		pending->data += received;
+		pending->len -= received;
+
+		return received;
+	}
 
 	fds[0].fd = sock;
 	fds[0].events = ZSOCK_POLLIN;
 
+	if (*remaining_time > 0) {
+		*remaining_time -= (int32_t)k_uptime_delta(timestamp);
+		if (*remaining_time < 0) {
+			/* timeout, make poll return immediately */
+			*remaining_time = 0;
+		}
+	}
+
+	ret = zsock_poll(fds, 1, *remaining_time);
+	if (ret == 0) {
+		LOG_DBG("Timeout");
+		return -ETIMEDOUT;
+	} else if (ret < 0) {
+		return -errno;
+	}
+
+	if (fds[0].revents & (ZSOCK_POLLERR | ZSOCK_POLLNVAL)) {
+		return -EIO;
+	} else if (fds[0].revents & ZSOCK_POLLHUP) {
+		/* Connection closed */
+		LOG_DBG("Connection closed");
+		return 0;
+	}
+
+	received = zsock_recv(sock, buf, len, 0);
+	if (received == 0) {
+		/* Connection closed */
+		LOG_DBG("Connection closed");
+	} else if (received < 0) {
+		return -errno;
+	}
+
+	return received;
+}
+
+static int http_wait_data(int sock, struct http_request *req, int32_t timeout,
+			  struct http_pending_data *pending)
+{
+	int total_received = 0;
+	size_t offset = 0;
+	size_t parsed;
+	int received;
+	bool from_pending;
+	int32_t remaining_time = timeout;
+	int64_t timestamp = k_uptime_get();
+
 	do {
-		if (timeout > 0) {
-			remaining_time -= (int32_t)k_uptime_delta(&timestamp);
-			if (remaining_time < 0) {
-				/* timeout, make poll return immediately */
-				remaining_time = 0;
-			}
+		from_pending = pending->len > 0;
+
+		received = http_read_data(sock, req, offset, &remaining_time,
+					  &timestamp, pending);
+		if ((received == 0) && (total_received == 0) &&
+		    req->internal.retry_on_close) {
+			/* Nothing was processed, the request can be sent again */
+			LOG_DBG("Connection closed before the response");
+			return -ECONNRESET;
+		} else if ((received == 0) || (received == -ETIMEDOUT)) {
+			http_data_final_null_resp(req);
+			return total_received;
+		} else if (received < 0) {
+			LOG_DBG("Connection error (%d)", received);
+			return received;
 		}
 
-		ret = zsock_poll(fds, nfds, remaining_time);
-		if (ret == 0) {
-			LOG_DBG("Timeout");
-			goto finalize_data;
-		} else if (ret < 0) {
-			goto error;
+		req->internal.response.data_len += received;
+
+		parsed = http_parser_execute(&req->internal.parser,
+					     &req->internal.parser_settings,
+					     req->internal.response.recv_buf + offset,
+					     received);
+
+		if (HTTP_PARSER_ERRNO(&req->internal.parser) != HPE_OK &&
+		    HTTP_PARSER_ERRNO(&req->internal.parser) != HPE_PAUSED) {
+			NET_DBG("HTTP parser error %s",
+				http_errno_name(HTTP_PARSER_ERRNO(&req->internal.parser)));
+			return -EBADMSG;
 		}
-		if (fds[0].revents & (ZSOCK_POLLERR | ZSOCK_POLLNVAL)) {
-			goto error;
-		} else if (fds[0].revents & ZSOCK_POLLHUP) {
-			/* Connection closed */
-			LOG_DBG("Connection closed");
-			goto finalize_data;
-		} else if (fds[0].revents & ZSOCK_POLLIN) {
-			received = zsock_recv(sock, req->internal.response.recv_buf + offset,
-					      req->internal.response.recv_buf_len - offset, 0);
-			if (received == 0) {
-				/* Connection closed */
-				LOG_DBG("Connection closed");
-				goto finalize_data;
-			} else if (received < 0) {
-				goto error;
-			} else {
-				req->internal.response.data_len += received;
 
-				(void)http_parser_execute(
-					&req->internal.parser, &req->internal.parser_settings,
-					req->internal.response.recv_buf + offset, received);
-			}
+		/* Whatever follows the end of the response belongs to the next
+		 * pipelined response, keep it for it.
+		 */
+		if (req->internal.response.message_complete && parsed < received) {
+			size_t extra = received - parsed;
 
-			total_received += received;
-			offset += received;
+			req->internal.response.data_len -= extra;
 
-			if (offset >= req->internal.response.recv_buf_len) {
-				offset = 0;
+			if (from_pending) {
+				pending->data -= extra;
+				pending->len += extra;
+			} else {
+				pending->data = req->internal.response.recv_buf +
+						offset + parsed;
+				pending->len = extra;
 			}
 
-			if (req->internal.response.cb) {
-				bool notify = false;
-				enum http_final_call event;
+			received = parsed;
+		}
+
+		total_received += received;
+		offset += received;
 
-				if (req->internal.response.message_complete) {
-					NET_DBG("Calling callback for %zd len data",
-						req->internal.response.data_len);
+		if (offset >= req->internal.response.recv_buf_len) {
+			offset = 0;
+		}
 
-					notify = true;
-					event = HTTP_DATA_FINAL;
-				} else if (offset == 0) {
-					NET_DBG("Calling callback for partitioned %zd len data",
-						req->internal.response.data_len);
+		if (req->internal.response.cb) {
+			bool notify = false;
+			enum http_final_call event;
 
-					notify = true;
-					event = HTTP_DATA_MORE;
-				}
+			if (req->internal.response.message_complete) {
+				NET_DBG("Calling callback for %zd len data",
+					req->internal.response.data_len);
 
-				if (notify) {
-					req->internal.response.cb(&req->internal.response, event,
-								  req->internal.user_data);
+				notify = true;
+				event = HTTP_DATA_FINAL;
+			} else if (offset == 0) {
+				NET_DBG("Calling callback for partitioned %zd len data",
+					req->internal.response.data_len);
 
-					/* Re-use the result buffer and start to fill it again */
-					req->internal.response.data_len = 0;
-					req->internal.response.body_frag_start = NULL;
-					req->internal.response.body_frag_len = 0;
-				}
+				notify = true;
+				event = HTTP_DATA_MORE;
 			}
 
-			if (req->internal.response.message_complete) {
-				ret = total_received;
-				break;
+			if (notify) {
+				req->internal.response.cb(&req->internal.response, event,
+							  req->internal.user_data);
+
+				/* Re-use the result buffer and start to fill it again */
+				req->internal.response.data_len = 0;
+				req->internal.response.body_frag_start = NULL;
+				req->internal.response.body_frag_len = 0;
 			}
 		}
+	} while (!req->internal.response.message_complete);
 
-	} while (true);
+	return total_received;
+}
 
-	return ret;
+int http_client_send_chunk(int sock, const void *data, size_t len)
+{
+	char chunk_len_str[sizeof("ffffffffffffffff" HTTP_CRLF)];
+	int hdr_len;
+	int ret;
 
-finalize_data:
-	ret = total_received;
+	hdr_len = snprintk(chunk_len_str, sizeof(chunk_len_str), "%zx" HTTP_CRLF,
+			   len);
+	if (hdr_len <= 0 || hdr_len >= (int)sizeof(chunk_len_str)) {
+		return -EINVAL;
+	}
 
-	http_data_final_null_resp(req);
-	return ret;
+	ret = sendall(sock, chunk_len_str, hdr_len);
+	if (ret < 0) {
+		return ret;
+	}
 
-error:
-	LOG_DBG("Connection error (%d)", errno);
-	ret = -errno;
-	return ret;
+	if (len > 0) {
+		ret = sendall(sock, data, len);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/* The last chunk is followed by the empty trailer */
+	ret = sendall(sock, len > 0 ? HTTP_CRLF : HTTP_CRLF HTTP_CRLF,
+		      len > 0 ? 2 : 4);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return hdr_len + len + (len > 0 ? 2 : 4);
 }
 
-int http_client_req(int sock, struct http_request *req,
-		    int32_t timeout, void *user_data)
+static int http_send_req(int sock, struct http_request *req, void *user_data)
 {
 	/* Utilize the network usage by sending data in bigger blocks */
 	char send_buf[MAX_SEND_BUF_LEN];
 	const size_t send_buf_max_len = sizeof(send_buf);
 	size_t send_buf_pos = 0;
 	int total_sent = 0;
-	int ret, total_recv, i;
+	int ret, i;
 	const char *method;
 
-	if (sock < 0 || req == NULL || req->response == NULL ||
-	    req->recv_buf == NULL || req->recv_buf_len == 0) {
-		return -EINVAL;
-	}
-
 	memset(&req->internal.response, 0, sizeof(req->internal.response));
 
 	req->internal.response.http_cb = req->http_cb;
@@ -633,7 +745,12 @@ int http_client_req(int sock, struct http_request *req,
 	}
 
 	if (req->payload || req->payload_cb) {
-		if (req->payload_len) {
+		if (req->chunked) {
+			ret = http_send_data(sock, send_buf, send_buf_max_len,
+					     &send_buf_pos, "Transfer-Encoding",
+					     ": ", "chunked", HTTP_CRLF,
+					     HTTP_CRLF, NULL);
+		} else if (req->payload_len) {
 			char content_len_str[HTTP_CONTENT_LEN_SIZE];
 
 			ret = snprintk(content_len_str, HTTP_CONTENT_LEN_SIZE,
@@ -682,12 +799,30 @@ int http_client_req(int sock, struct http_request *req,
 				length = req->payload_len;
 			}
 
-			ret = sendall(sock, req->payload, length);
+			if (req->chunked) {
+				/* An empty chunk would end the body */
+				ret = length > 0 ?
+				      http_client_send_chunk(sock, req->payload,
+							     length) : 0;
+			} else {
+				ret = sendall(sock, req->payload, length);
+			}
+
 			if (ret < 0) {
 				goto out;
 			}
 
-			total_sent += length;
+			total_sent += req->chunked ? ret : length;
+		}
+
+		/* Terminate the chunked body */
+		if (req->chunked) {
+			ret = http_client_send_chunk(sock, NULL, 0);
+			if (ret < 0) {
+				goto out;
+			}
+
+			total_sent += ret;
 		}
 	} else {
 		ret = http_send_data(sock, send_buf, send_buf_max_len,
@@ -710,19 +845,113 @@ int http_client_req(int sock, struct http_request *req,
 
 	NET_DBG("Sent %d bytes", total_sent);
 
+	return total_sent;
+
+out:
+	return ret;
+}
+
+static bool http_req_is_valid(struct http_request *req)
+{
+	return req != NULL && req->response != NULL && req->recv_buf != NULL &&
+	       req->recv_buf_len > 0;
+}
+
+int http_client_req(int sock, struct http_request *req,
+		    int32_t timeout, void *user_data)
+{
+	struct http_pending_data pending = { 0 };
+	int total_sent, total_recv;
+
+	if (sock < 0 || !http_req_is_valid(req)) {
+		return -EINVAL;
+	}
+
+	total_sent = http_send_req(sock, req, user_data);
+	if (total_sent < 0) {
+		return total_sent;
+	}
+
 	http_client_init_parser(&req->internal.parser,
 				&req->internal.parser_settings);
 
 	/* Request is sent, now wait data to be received */
-	total_recv = http_wait_data(sock, req, timeout);
+	total_recv = http_wait_data(sock, req, timeout, &pending);
 	if (total_recv < 0) {
 		NET_DBG("Wait data failure (%d)", total_recv);
-	} else {
-		NET_DBG("Received %d bytes", total_recv);
+		return total_recv;
+	}
+
+	NET_DBG("Received %d bytes", total_recv);
+
+	/* Data received after the response cannot be matched with any
+	 * request, do not use the connection again.
+	 */
+	if (pending.len > 0) {
+		NET_DBG("Dropping %zu bytes after the response", pending.len);
+		req->internal.response.keep_alive = 0;
 	}
 
 	return total_sent;
+}
 
-out:
-	return ret;
+int http_client_req_pipeline(int sock, struct http_request **reqs,
+			     size_t count, int32_t timeout, void *user_data)
+{
+	struct http_pending_data pending = { 0 };
+	int completed = 0;
+	int ret;
+
+	if (sock < 0 || reqs == NULL || count == 0) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (!http_req_is_valid(reqs[i])) {
+			return -EINVAL;
+		}
+
+		/* The data following a response is moved to the buffer of
+		 * the next request, the buffers must not be shared.
+		 */
+		for (size_t j = 0; j < i; j++) {
+			if (reqs[j]->recv_buf == reqs[i]->recv_buf) {
+				return -EINVAL;
+			}
+		}
+	}
+
+	/* Send all the requests before waiting for the first response */
+	for (size_t i = 0; i < count; i++) {
+		ret = http_send_req(sock, reqs[i], user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		struct http_request *req = reqs[i];
+
+		http_client_init_parser(&req->internal.parser,
+					&req->internal.parser_settings);
+
+		ret = http_wait_data(sock, req, timeout, &pending);
+		if (ret < 0) {
+			NET_DBG("Wait data failure for request %zu (%d)", i, ret);
+			return ret;
+		}
+
+		if (!req->internal.response.message_complete) {
+			break;
+		}
+
+		completed++;
+
+		/* The server will not answer the remaining requests */
+		if (!req->internal.response.keep_alive) {
+			break;
+		}
+	}
+
+	return completed;
 }
@@ -0,0 +1,352 @@
+/** @file
+ * @brief HTTP client connection pool
+ *
+ * Keeps the keep-alive connections of the HTTP client open so that
+ * consecutive requests to the same server do not pay the TCP and TLS
+ * handshakes again.
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+
+#include "net_private.h"
+
+struct http_pool_conn {
+	/* Connected socket, -1 if the slot is free */
+	int sock;
+
+	/* Endpoint the connection goes to */
+	char host[CONFIG_HTTP_CLIENT_POOL_HOST_LEN];
+	uint16_t port;
+	int sec_tag;
+
+	/* The connection is used by a request, otherwise it is idle */
+	bool in_use;
+
+	/* Uptime when the connection became idle */
+	int64_t idle_since;
+};
+
+static struct http_pool_conn pool[CONFIG_HTTP_CLIENT_POOL_SIZE] = {
+	[0 ... (CONFIG_HTTP_CLIENT_POOL_SIZE - 1)] = { .sock = -1 },
+};
+
+static K_MUTEX_DEFINE(pool_lock);
+static K_CONDVAR_DEFINE(pool_released);
+
+static void conn_close(struct http_pool_conn *conn)
+{
+	NET_DBG("Closing connection %d to %s:%u", conn->sock, conn->host,
+		conn->port);
+
+	(void)zsock_close(conn->sock);
+	conn->sock = -1;
+	conn->in_use = false;
+}
+
+static bool conn_matches(struct http_pool_conn *conn,
+			 const struct http_client_endpoint *ep)
+{
+	return conn->port == ep->port && conn->sec_tag == ep->sec_tag &&
+	       strcmp(conn->host, ep->host) == 0;
+}
+
+/* An idle connection must not have anything to read, otherwise the server
+ * has closed it or sent something we cannot match with a request.
+ */
+static bool conn_is_alive(struct http_pool_conn *conn)
+{
+	struct zsock_pollfd fds[1] = {
+		{ .fd = conn->sock, .events = ZSOCK_POLLIN },
+	};
+
+	return zsock_poll(fds, 1, 0) == 0;
+}
+
+static void pool_expire(void)
+{
+	int64_t now = k_uptime_get();
+
+	for (int i = 0; i < ARRAY_SIZE(pool); i++) {
+		if (pool[i].sock < 0 || pool[i].in_use) {
+			continue;
+		}
+
+		if (now - pool[i].idle_since >=
+		    CONFIG_HTTP_CLIENT_POOL_IDLE_TIMEOUT) {
+			conn_close(&pool[i]);
+		}
+	}
+}
+
+static int pool_connect(const struct http_client_endpoint *ep)
+{
+	struct zsock_addrinfo hints = {
+		.ai_socktype = SOCK_STREAM,
+	};
+	struct zsock_addrinfo *res, *ai;
+	char port[sizeof("65535")];
+	int proto = IPPROTO_TCP;
+	int sock = -1;
+	int ret;
+
+	if (ep->sec_tag != HTTP_CLIENT_NO_TLS) {
+		if (!IS_ENABLED(CONFIG_NET_SOCKETS_SOCKOPT_TLS)) {
+			return -EPROTONOSUPPORT;
+		}
+
+		proto = IPPROTO_TLS_1_2;
+	}
+
+	snprintk(port, sizeof(port), "%u", ep->port);
+
+	ret = zsock_getaddrinfo(ep->host, port, &hints, &res);
+	if (ret != 0) {
+		NET_DBG("Cannot resolve %s (%d)", ep->host, ret);
+		return -EHOSTUNREACH;
+	}
+
+	ret = -ECONNREFUSED;
+
+	for (ai = res; ai != NULL; ai = ai->ai_next) {
+		sock = zsock_socket(ai->ai_family, ai->ai_socktype, proto);
+		if (sock < 0) {
+			ret = -errno;
+			continue;
+		}
+
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+		if (proto == IPPROTO_TLS_1_2) {
+			sec_tag_t sec_tag = ep->sec_tag;
+
+			if (zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST,
+					     &sec_tag, sizeof(sec_tag)) < 0 ||
+			    zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME,
+					     ep->host, strlen(ep->host) + 1) < 0) {
+				ret = -errno;
+				(void)zsock_close(sock);
+				sock = -1;
+				break;
+			}
+		}
+#endif
+
+		if (zsock_connect(sock, ai->ai_addr, ai->ai_addrlen) == 0) {
+			ret = sock;
+			break;
+		}
+
+		ret = -errno;
+		(void)zsock_close(sock);
+		sock = -1;
+	}
+
+	zsock_freeaddrinfo(res);
+
+	return ret;
+}
+
+static int pool_get(const struct http_client_endpoint *ep, int32_t timeout,
+		    bool *reused)
+{
+	struct http_pool_conn *conn;
+	int64_t end = k_uptime_get() + timeout;
+	int ret;
+
+	if (ep == NULL || ep->host == NULL ||
+	    strlen(ep->host) >= CONFIG_HTTP_CLIENT_POOL_HOST_LEN) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	while (true) {
+		struct http_pool_conn *free_slot = NULL;
+		struct http_pool_conn *lru = NULL;
+
+		pool_expire();
+
+		for (int i = 0; i < ARRAY_SIZE(pool); i++) {
+			conn = &pool[i];
+
+			if (conn->sock < 0) {
+				if (free_slot == NULL && !conn->in_use) {
+					free_slot = conn;
+				}
+
+				continue;
+			}
+
+			if (conn->in_use) {
+				continue;
+			}
+
+			if (conn_matches(conn, ep)) {
+				if (conn_is_alive(conn)) {
+					conn->in_use = true;
+					*reused = true;
+					ret = conn->sock;
+
+					NET_DBG("Reusing connection %d to %s:%u",
+						ret, ep->host, ep->port);
+					goto out;
+				}
+
+				conn_close(conn);
+
+				if (free_slot == NULL) {
+					free_slot = conn;
+				}
+
+				continue;
+			}
+
+			if (lru == NULL || conn->idle_since < lru->idle_since) {
+				lru = conn;
+			}
+		}
+
+		if (free_slot == NULL && lru != NULL) {
+			conn_close(lru);
+			free_slot = lru;
+		}
+
+		if (free_slot != NULL) {
+			conn = free_slot;
+			break;
+		}
+
+		/* Every connection is in use, wait for one to be released */
+		if (timeout == 0 ||
+		    (timeout > 0 && k_uptime_get() >= end) ||
+		    k_condvar_wait(&pool_released, &pool_lock,
+				   timeout < 0 ? K_FOREVER :
+				   K_MSEC(MAX(end - k_uptime_get(), 0))) != 0) {
+			ret = -EAGAIN;
+			goto out;
+		}
+	}
+
+	/* Reserve the slot while connecting without holding the lock */
+	conn->in_use = true;
+	*reused = false;
+	k_mutex_unlock(&pool_lock);
+
+	ret = pool_connect(ep);
+
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	if (ret < 0) {
+		NET_DBG("Cannot connect to %s:%u (%d)", ep->host, ep->port, ret);
+		conn->in_use = false;
+		k_condvar_signal(&pool_released);
+		goto out;
+	}
+
+	conn->sock = ret;
+	strcpy(conn->host, ep->host);
+	conn->port = ep->port;
+	conn->sec_tag = ep->sec_tag;
+
+	NET_DBG("New connection %d to %s:%u", ret, ep->host, ep->port);
+
+out:
+	k_mutex_unlock(&pool_lock);
+
+	return ret;
+}
+
+int http_client_pool_get(const struct http_client_endpoint *ep,
+			 int32_t timeout)
+{
+	bool reused;
+
+	return pool_get(ep, timeout, &reused);
+}
+
+void http_client_pool_put(int sock, bool reuse)
+{
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(pool); i++) {
+		if (pool[i].sock != sock || !pool[i].in_use) {
+			continue;
+		}
+
+		if (reuse) {
+			pool[i].in_use = false;
+			pool[i].idle_since = k_uptime_get();
+		} else {
+			conn_close(&pool[i]);
+		}
+
+		k_condvar_signal(&pool_released);
+		break;
+	}
+
+	k_mutex_unlock(&pool_lock);
+}
+
+void http_client_pool_flush(void)
+{
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(pool); i++) {
+		if (pool[i].sock >= 0 && !pool[i].in_use) {
+			conn_close(&pool[i]);
+		}
+	}
+
+	k_mutex_unlock(&pool_lock);
+}
+
+int http_client_pool_req(const struct http_client_endpoint *ep,
+			 struct http_request *req, int32_t timeout,
+			 void *user_data)
+{
+	bool reused;
+	int sock;
+	int ret;
+
+	for (int attempt = 0; attempt < 2; attempt++) {
+		sock = pool_get(ep, timeout, &reused);
+		if (sock < 0) {
+			return sock;
+		}
+
+		req->internal.retry_on_close = reused;
+		ret = http_client_req(sock, req, timeout, user_data);
+		req->internal.retry_on_close = false;
+
+		http_client_pool_put(sock, ret >= 0 &&
+				     req->internal.response.message_complete &&
+				     req->internal.response.keep_alive);
+
+		/* The server may have closed an idle connection just before
+		 * the request was sent, retry once on a fresh connection if
+		 * the connection failed before any response data arrived.
+		 * Anything else, a timeout included, may come after the
+		 * server processed the request.
+		 */
+		if (!reused || ((ret != -EPIPE) && (ret != -ECONNRESET)) ||
+		    (req->internal.response.http_status_code != 0)) {
+			break;
+		}
+
+		NET_DBG("Request on reused connection failed (%d), retrying",
+			ret);
+	}
+
+	return ret;
+}
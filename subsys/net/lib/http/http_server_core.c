@@ -0,0 +1,430 @@
+/** @file
+ * @brief HTTP server core
+ *
+ * Listening sockets, connection management and the server thread.
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+
+#if defined(CONFIG_ARCH_POSIX)
+#include <fcntl.h>
+#else
+#include <zephyr/posix/fcntl.h>
+#endif
+
+#include "sockets_internal.h"
+#include "http_server_internal.h"
+
+#define MAX_SERVICES CONFIG_HTTP_SERVER_NUM_SERVICES
+#define MAX_CLIENTS CONFIG_HTTP_SERVER_MAX_CLIENTS
+
+/* The wakeup signal of the server thread takes one more poll entry */
+BUILD_ASSERT(MAX_SERVICES + MAX_CLIENTS + 1 <= CONFIG_NET_SOCKETS_POLL_MAX,
+	     "CONFIG_NET_SOCKETS_POLL_MAX too small for the HTTP server");
+
+struct http_server_ctx {
+	/* Listening sockets and their services */
+	int listen_fds[MAX_SERVICES];
+	const struct http_service_desc *services[MAX_SERVICES];
+	int num_services;
+
+	struct http_client_ctx clients[MAX_CLIENTS];
+
+	/* Poll entries, listening sockets first */
+	struct zsock_pollfd fds[MAX_SERVICES + MAX_CLIENTS];
+
+	/* Wakes the server thread up when it is to stop */
+	struct k_poll_signal wakeup;
+
+	bool running;
+	bool stop;
+};
+
+static struct http_server_ctx server_ctx;
+
+static K_MUTEX_DEFINE(server_lock);
+
+static K_THREAD_STACK_DEFINE(server_stack, CONFIG_HTTP_SERVER_STACK_SIZE);
+static struct k_thread server_thread_data;
+
+static int set_nonblocking(int fd)
+{
+	int flags;
+
+	flags = zsock_fcntl(fd, F_GETFL, 0);
+	if (flags < 0) {
+		return -errno;
+	}
+
+	if (zsock_fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+static int service_bind(const struct http_service_desc *svc)
+{
+	struct sockaddr_storage addr_storage = { 0 };
+	struct sockaddr *addr = (struct sockaddr *)&addr_storage;
+	socklen_t addrlen;
+	int fd, ret;
+	int opt = 1;
+
+	/* A host which is not an address is a host name or a virtual host,
+	 * the service then listens on all the addresses.
+	 */
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    zsock_inet_pton(AF_INET6, svc->host,
+			    &net_sin6(addr)->sin6_addr) == 1) {
+		addr->sa_family = AF_INET6;
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   zsock_inet_pton(AF_INET, svc->host,
+				   &net_sin(addr)->sin_addr) == 1) {
+		addr->sa_family = AF_INET;
+	} else {
+		addr->sa_family = IS_ENABLED(CONFIG_NET_IPV6) ? AF_INET6 : AF_INET;
+	}
+
+	if (addr->sa_family == AF_INET6) {
+		net_sin6(addr)->sin6_port = htons(*svc->port);
+		addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		net_sin(addr)->sin_port = htons(*svc->port);
+		addrlen = sizeof(struct sockaddr_in);
+	}
+
+	fd = zsock_socket(addr->sa_family, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	(void)zsock_setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+	if (zsock_bind(fd, addr, addrlen) < 0 ||
+	    zsock_listen(fd, svc->backlog) < 0) {
+		ret = -errno;
+		goto fail;
+	}
+
+	ret = set_nonblocking(fd);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	/* Let the application know the ephemeral port */
+	if (*svc->port == 0) {
+		if (zsock_getsockname(fd, addr, &addrlen) < 0) {
+			ret = -errno;
+			goto fail;
+		}
+
+		*svc->port = ntohs(addr->sa_family == AF_INET6 ?
+				   net_sin6(addr)->sin6_port :
+				   net_sin(addr)->sin_port);
+	}
+
+	NET_DBG("Service %s listening on port %u (fd %d)", svc->host,
+		*svc->port, fd);
+
+	return fd;
+
+fail:
+	(void)zsock_close(fd);
+	return ret;
+}
+
+static int clients_of(const struct http_service_desc *svc)
+{
+	int count = 0;
+
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (server_ctx.clients[i].fd >= 0 &&
+		    server_ctx.clients[i].service == svc) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static void accept_clients(int idx)
+{
+	const struct http_service_desc *svc = server_ctx.services[idx];
+	struct http_client_ctx *client;
+	int fd;
+
+	while (true) {
+		fd = zsock_accept(server_ctx.listen_fds[idx], NULL, NULL);
+		if (fd < 0) {
+			if (errno != EAGAIN) {
+				NET_DBG("Cannot accept (%d)", -errno);
+			}
+
+			return;
+		}
+
+		client = NULL;
+
+		if (clients_of(svc) < svc->concurrent) {
+			for (int i = 0; i < MAX_CLIENTS; i++) {
+				if (server_ctx.clients[i].fd < 0) {
+					client = &server_ctx.clients[i];
+					break;
+				}
+			}
+		}
+
+		if (client == NULL || set_nonblocking(fd) < 0) {
+			NET_DBG("No room for a new client of %s", svc->host);
+			(void)zsock_close(fd);
+			continue;
+		}
+
+		http_server_client_init(client, fd, svc);
+
+		NET_DBG("[%p] New client (fd %d)", client, fd);
+	}
+}
+
+static void close_client(struct http_client_ctx *client)
+{
+	NET_DBG("[%p] Closing client (fd %d)", client, client->fd);
+
+	http_server_client_release(client, true);
+}
+
+/* Close the inactive connections, returns the time until the next one is
+ * to be closed.
+ */
+static k_timeout_t expire_clients(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		struct http_client_ctx *client = &server_ctx.clients[i];
+		int64_t expiry;
+
+		if (client->fd < 0) {
+			continue;
+		}
+
+		expiry = client->last_activity +
+			 CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT * MSEC_PER_SEC;
+		if (expiry <= now) {
+			close_client(client);
+			continue;
+		}
+
+		next = MIN(next, expiry);
+	}
+
+	if (next == INT64_MAX) {
+		return K_FOREVER;
+	}
+
+	return K_MSEC(next - now);
+}
+
+static void server_thread(void *p1, void *p2, void *p3)
+{
+	struct http_client_ctx *polled[MAX_CLIENTS];
+	int nfds, npolled;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!server_ctx.stop) {
+		k_timeout_t timeout = expire_clients();
+
+		nfds = 0;
+
+		for (int i = 0; i < server_ctx.num_services; i++) {
+			server_ctx.fds[nfds].fd = server_ctx.listen_fds[i];
+			server_ctx.fds[nfds].events = ZSOCK_POLLIN;
+			nfds++;
+		}
+
+		npolled = 0;
+
+		for (int i = 0; i < MAX_CLIENTS; i++) {
+			struct http_client_ctx *client = &server_ctx.clients[i];
+
+			if (client->fd < 0) {
+				continue;
+			}
+
+			/* Do not read the next request before the response to
+			 * the current one is out.
+			 */
+			server_ctx.fds[nfds].fd = client->fd;
+			server_ctx.fds[nfds].events = client->tx_pending ?
+						      ZSOCK_POLLOUT : ZSOCK_POLLIN;
+			polled[npolled++] = client;
+			nfds++;
+		}
+
+		ret = zsock_poll_signal_internal(server_ctx.fds, nfds,
+						 &server_ctx.wakeup, timeout);
+		if (ret < 0) {
+			NET_ERR("Poll failed (%d)", -errno);
+			k_msleep(10);
+			continue;
+		}
+
+		k_poll_signal_reset(&server_ctx.wakeup);
+
+		for (int i = 0; i < server_ctx.num_services; i++) {
+			if (server_ctx.fds[i].revents & ZSOCK_POLLIN) {
+				accept_clients(i);
+			}
+		}
+
+		for (int i = 0; i < npolled; i++) {
+			struct zsock_pollfd *pfd = &server_ctx.fds[server_ctx.num_services + i];
+			struct http_client_ctx *client = polled[i];
+
+			if (pfd->revents == 0 || client->fd != pfd->fd) {
+				continue;
+			}
+
+			if (pfd->revents & (ZSOCK_POLLERR | ZSOCK_POLLNVAL)) {
+				close_client(client);
+				continue;
+			}
+
+			if (pfd->revents & ZSOCK_POLLOUT) {
+				ret = http_server_client_send(client);
+			} else {
+				/* Also called on POLLHUP, recv() then reports
+				 * the end of the connection.
+				 */
+				ret = http_server_client_recv(client);
+			}
+
+			if (ret < 0 && client->fd >= 0) {
+				close_client(client);
+			}
+		}
+	}
+
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (server_ctx.clients[i].fd >= 0) {
+			close_client(&server_ctx.clients[i]);
+		}
+	}
+}
+
+static void close_listeners(void)
+{
+	for (int i = 0; i < server_ctx.num_services; i++) {
+		(void)zsock_close(server_ctx.listen_fds[i]);
+	}
+
+	server_ctx.num_services = 0;
+}
+
+int http_server_start(void)
+{
+	int ret = 0;
+	int fd;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (server_ctx.running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	server_ctx.num_services = 0;
+
+	HTTP_SERVICE_FOREACH(svc) {
+		if (server_ctx.num_services >= MAX_SERVICES) {
+			NET_ERR("Too many services, see "
+				"CONFIG_HTTP_SERVER_NUM_SERVICES");
+			ret = -ENOMEM;
+			break;
+		}
+
+		fd = service_bind(svc);
+		if (fd < 0) {
+			NET_ERR("Cannot listen for service %s (%d)", svc->host,
+				fd);
+			ret = fd;
+			break;
+		}
+
+		server_ctx.listen_fds[server_ctx.num_services] = fd;
+		server_ctx.services[server_ctx.num_services] = svc;
+		server_ctx.num_services++;
+	}
+
+	if (ret < 0) {
+		close_listeners();
+		goto out;
+	}
+
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		server_ctx.clients[i].fd = -1;
+	}
+
+	k_poll_signal_init(&server_ctx.wakeup);
+	server_ctx.stop = false;
+	server_ctx.running = true;
+
+	k_thread_create(&server_thread_data, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server_thread,
+			NULL, NULL, NULL,
+			K_PRIO_PREEMPT(CONFIG_HTTP_SERVER_THREAD_PRIO), 0,
+			K_NO_WAIT);
+	k_thread_name_set(&server_thread_data, "http_server");
+
+	NET_DBG("Started with %d services", server_ctx.num_services);
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
+
+int http_server_stop(void)
+{
+	int ret = 0;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (!server_ctx.running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	server_ctx.stop = true;
+	k_poll_signal_raise(&server_ctx.wakeup, 0);
+
+	(void)k_thread_join(&server_thread_data, K_FOREVER);
+
+	close_listeners();
+	server_ctx.running = false;
+
+	NET_DBG("Stopped");
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
@@ -0,0 +1,808 @@
+/** @file
+ * @brief HTTP server HTTP/1.1 support
+ *
+ * Request parsing and response generation for one connection.
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+
+#if defined(CONFIG_ARCH_POSIX)
+#include <fcntl.h>
+#else
+#include <zephyr/posix/fcntl.h>
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+#include <zephyr/net/websocket.h>
+#include <zephyr/sys/base64.h>
+#include <mbedtls/sha1.h>
+#endif
+
+#include "http_server_internal.h"
+
+/* From RFC 6455 chapter 4.2.2 */
+#define WS_MAGIC "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_SHA1_OUTPUT_LEN 20
+#define WS_ACCEPT_LEN 28
+
+#define FS_PATH_LEN (CONFIG_HTTP_SERVER_MAX_URL_LENGTH + 64)
+
+static const char *status_str(uint16_t status)
+{
+	switch (status) {
+	case 101:
+		return "101 Switching Protocols";
+	case 200:
+		return "200 OK";
+	case 400:
+		return "400 Bad Request";
+	case 404:
+		return "404 Not Found";
+	case 405:
+		return "405 Method Not Allowed";
+	case 414:
+		return "414 URI Too Long";
+	default:
+		return "500 Internal Server Error";
+	}
+}
+
+static const struct http_resource_detail *
+find_resource(const struct http_service_desc *svc, const char *path,
+	      size_t *prefix_len)
+{
+	if (svc->res_begin == NULL) {
+		return NULL;
+	}
+
+	HTTP_SERVICE_FOREACH_RESOURCE(svc, res) {
+		size_t len = strlen(res->resource);
+
+		/* A resource ending with '*' matches all the paths starting
+		 * with it.
+		 */
+		if (len > 0 && res->resource[len - 1] == '*') {
+			if (strncmp(path, res->resource, len - 1) == 0) {
+				*prefix_len = len - 1;
+				return res->detail;
+			}
+		} else if (strcmp(path, res->resource) == 0) {
+			*prefix_len = len;
+			return res->detail;
+		}
+	}
+
+	return NULL;
+}
+
+static void dynamic_abort(struct http_client_ctx *client)
+{
+	const struct http_resource_detail_dynamic *dyn =
+		(const struct http_resource_detail_dynamic *)client->resource;
+
+	if (client->resource == NULL || client->status != 0 ||
+	    client->resource->type != HTTP_RESOURCE_TYPE_DYNAMIC ||
+	    !client->headers_complete || client->message_complete ||
+	    client->dynamic_failed) {
+		return;
+	}
+
+	(void)dyn->cb(client, HTTP_SERVER_DATA_ABORTED, NULL, 0, dyn->user_data);
+	client->dynamic_failed = 1;
+}
+
+static int append_hdr(struct http_client_ctx *client, const char *fmt, ...)
+{
+	size_t avail = sizeof(client->tx_hdr) - client->tx_hdr_len;
+	va_list ap;
+	int ret;
+
+	va_start(ap, fmt);
+	ret = vsnprintk(client->tx_hdr + client->tx_hdr_len, avail, fmt, ap);
+	va_end(ap);
+
+	if (ret < 0 || ret >= avail) {
+		return -ENOMEM;
+	}
+
+	client->tx_hdr_len += ret;
+
+	return 0;
+}
+
+static int build_headers(struct http_client_ctx *client, uint16_t status,
+			 const struct http_resource_detail *detail,
+			 size_t content_len)
+{
+	int ret;
+
+	client->tx_hdr_len = 0;
+
+	ret = append_hdr(client, "HTTP/1.1 %s" HTTP_CRLF, status_str(status));
+	if (ret == 0 && detail != NULL && detail->content_type != NULL) {
+		ret = append_hdr(client, "Content-Type: %s" HTTP_CRLF,
+				 detail->content_type);
+	}
+
+	if (ret == 0 && detail != NULL && detail->content_encoding != NULL) {
+		ret = append_hdr(client, "Content-Encoding: %s" HTTP_CRLF,
+				 detail->content_encoding);
+	}
+
+	if (ret == 0) {
+		ret = append_hdr(client, "Content-Length: %zu" HTTP_CRLF,
+				 content_len);
+	}
+
+	if (ret == 0 && client->close_after_tx) {
+		ret = append_hdr(client, "Connection: close" HTTP_CRLF);
+	}
+
+	if (ret == 0) {
+		ret = append_hdr(client, HTTP_CRLF);
+	}
+
+	return ret;
+}
+
+static void error_response(struct http_client_ctx *client, uint16_t status)
+{
+	NET_DBG("[%p] %s for %s", client, status_str(status),
+		client->url_buffer);
+
+	/* The headers of an error response without a detail always fit */
+	(void)build_headers(client, status, NULL, 0);
+	client->tx_body_len = 0;
+}
+
+static void static_response(struct http_client_ctx *client)
+{
+	const struct http_resource_detail_static *res =
+		(const struct http_resource_detail_static *)client->resource;
+
+	if (build_headers(client, 200, &res->common, res->static_data_len) < 0) {
+		error_response(client, 500);
+		return;
+	}
+
+	/* Sent straight from where the data is, no copy */
+	if (client->method != HTTP_HEAD) {
+		client->tx_body = res->static_data;
+		client->tx_body_len = res->static_data_len;
+	}
+}
+
+static void dynamic_response(struct http_client_ctx *client)
+{
+	const struct http_resource_detail_dynamic *res =
+		(const struct http_resource_detail_dynamic *)client->resource;
+	int ret;
+
+	if (client->dynamic_failed) {
+		error_response(client, 500);
+		return;
+	}
+
+	ret = res->cb(client, HTTP_SERVER_DATA_FINAL, client->tx_buf,
+		      sizeof(client->tx_buf), res->user_data);
+	if (ret < 0 || ret > sizeof(client->tx_buf) ||
+	    build_headers(client, 200, &res->common, ret) < 0) {
+		error_response(client, 500);
+		return;
+	}
+
+	if (client->method != HTTP_HEAD) {
+		client->tx_body = client->tx_buf;
+		client->tx_body_len = ret;
+	}
+}
+
+#if defined(CONFIG_FILE_SYSTEM)
+static void fs_response(struct http_client_ctx *client)
+{
+	const struct http_resource_detail_static_fs *res =
+		(const struct http_resource_detail_static_fs *)client->resource;
+	const char *name = client->url_buffer + client->resource_prefix_len;
+	char path[FS_PATH_LEN];
+	struct fs_dirent entry;
+	int ret;
+
+	while (*name == '/') {
+		name++;
+	}
+
+	/* Only the files of the directory are served */
+	if (*name == '\0' || strstr(name, "..") != NULL) {
+		error_response(client, 404);
+		return;
+	}
+
+	ret = snprintk(path, sizeof(path), "%s/%s", res->fs_path, name);
+	if (ret < 0 || ret >= sizeof(path)) {
+		error_response(client, 414);
+		return;
+	}
+
+	if (fs_stat(path, &entry) < 0 || entry.type != FS_DIR_ENTRY_FILE) {
+		error_response(client, 404);
+		return;
+	}
+
+	if (build_headers(client, 200, &res->common, entry.size) < 0) {
+		error_response(client, 500);
+		return;
+	}
+
+	if (client->method == HTTP_HEAD || entry.size == 0) {
+		return;
+	}
+
+	fs_file_t_init(&client->file);
+
+	if (fs_open(&client->file, path, FS_O_READ) < 0) {
+		error_response(client, 404);
+		return;
+	}
+
+	client->file_open = 1;
+	client->file_remaining = entry.size;
+}
+#endif /* CONFIG_FILE_SYSTEM */
+
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+static void ws_response(struct http_client_ctx *client)
+{
+	char key_accept[HTTP_SERVER_WS_KEY_LEN + sizeof(WS_MAGIC)];
+	uint8_t sha1[WS_SHA1_OUTPUT_LEN];
+	char accept[WS_ACCEPT_LEN + 1];
+	size_t olen;
+
+	if (!(client->parser.upgrade && client->upgrade_websocket &&
+	      client->ws_version_ok && client->ws_key[0] != '\0')) {
+		client->close_after_tx = 1;
+		error_response(client, 400);
+		return;
+	}
+
+	strcpy(key_accept, client->ws_key);
+	strcat(key_accept, WS_MAGIC);
+
+	mbedtls_sha1((const unsigned char *)key_accept, strlen(key_accept),
+		     sha1);
+
+	if (base64_encode((uint8_t *)accept, sizeof(accept), &olen, sha1,
+			  sizeof(sha1)) < 0) {
+		client->close_after_tx = 1;
+		error_response(client, 500);
+		return;
+	}
+
+	client->tx_hdr_len = 0;
+
+	if (append_hdr(client, "HTTP/1.1 %s" HTTP_CRLF
+			       "Upgrade: websocket" HTTP_CRLF
+			       "Connection: Upgrade" HTTP_CRLF
+			       "Sec-WebSocket-Accept: %s" HTTP_CRLF HTTP_CRLF,
+		       status_str(101), accept) < 0) {
+		client->close_after_tx = 1;
+		error_response(client, 500);
+		return;
+	}
+
+	client->ws_after_tx = 1;
+}
+
+static int ws_handoff(struct http_client_ctx *client)
+{
+	const struct http_resource_detail_websocket *res =
+		(const struct http_resource_detail_websocket *)client->resource;
+	int fd = client->fd;
+	int ws_sock, flags;
+
+	/* The Websocket library works with blocking sockets */
+	flags = zsock_fcntl(fd, F_GETFL, 0);
+	if (flags < 0 || zsock_fcntl(fd, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+		return -errno;
+	}
+
+	ws_sock = websocket_register(fd, res->data_buffer,
+				     res->data_buffer_len);
+	if (ws_sock < 0) {
+		NET_DBG("[%p] Cannot register Websocket (%d)", client, ws_sock);
+		return ws_sock;
+	}
+
+	NET_DBG("[%p] Upgraded to Websocket %d", client, ws_sock);
+
+	/* The socket now belongs to the Websocket */
+	http_server_client_release(client, false);
+
+	if (res->cb(ws_sock, res->user_data) < 0) {
+		(void)websocket_disconnect(ws_sock);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_HTTP_SERVER_WEBSOCKET */
+
+static void prepare_response(struct http_client_ctx *client)
+{
+	client->tx_hdr_sent = 0;
+	client->tx_body = NULL;
+	client->tx_body_len = 0;
+	client->tx_pending = 1;
+
+	/* The data following an upgrade request is not HTTP */
+	client->close_after_tx = !http_should_keep_alive(&client->parser) ||
+				 client->parser.upgrade;
+
+	if (client->status != 0) {
+		error_response(client, client->status);
+		return;
+	}
+
+	switch (client->resource->type) {
+	case HTTP_RESOURCE_TYPE_STATIC:
+		static_response(client);
+		break;
+	case HTTP_RESOURCE_TYPE_DYNAMIC:
+		dynamic_response(client);
+		break;
+#if defined(CONFIG_FILE_SYSTEM)
+	case HTTP_RESOURCE_TYPE_STATIC_FS:
+		fs_response(client);
+		break;
+#endif
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+	case HTTP_RESOURCE_TYPE_WEBSOCKET:
+		ws_response(client);
+		break;
+#endif
+	default:
+		error_response(client, 404);
+		break;
+	}
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_client_ctx *client = CONTAINER_OF(parser,
+						      struct http_client_ctx,
+						      parser);
+
+	client->url_len = 0;
+	client->url_buffer[0] = '\0';
+	client->resource = NULL;
+	client->status = 0;
+	client->header_name_len = 0;
+	client->header_value_len = 0;
+	client->ws_key[0] = '\0';
+	client->header_in_value = 0;
+	client->url_too_long = 0;
+	client->upgrade_websocket = 0;
+	client->ws_version_ok = 0;
+	client->headers_complete = 0;
+	client->message_complete = 0;
+	client->dynamic_failed = 0;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = CONTAINER_OF(parser,
+						      struct http_client_ctx,
+						      parser);
+
+	if (client->url_len + length >= sizeof(client->url_buffer)) {
+		client->url_too_long = 1;
+		return 0;
+	}
+
+	memcpy(client->url_buffer + client->url_len, at, length);
+	client->url_len += length;
+	client->url_buffer[client->url_len] = '\0';
+
+	return 0;
+}
+
+/* Called once the value of a header is complete */
+static void header_complete(struct http_client_ctx *client)
+{
+	/* Too long to be one of the values we care about */
+	if (client->header_value_len >= sizeof(client->header_value)) {
+		return;
+	}
+
+	client->header_value[client->header_value_len] = '\0';
+
+	switch (client->header) {
+	case HTTP_SERVER_HEADER_UPGRADE:
+		client->upgrade_websocket =
+			strcasecmp(client->header_value, "websocket") == 0;
+		break;
+	case HTTP_SERVER_HEADER_WS_KEY:
+		if (client->header_value_len == HTTP_SERVER_WS_KEY_LEN) {
+			strcpy(client->ws_key, client->header_value);
+		}
+		break;
+	case HTTP_SERVER_HEADER_WS_VERSION:
+		client->ws_version_ok = strcmp(client->header_value, "13") == 0;
+		break;
+	default:
+		break;
+	}
+}
+
+static int on_header_field(struct http_parser *parser, const char *at,
+			   size_t length)
+{
+	struct http_client_ctx *client = CONTAINER_OF(parser,
+						      struct http_client_ctx,
+						      parser);
+
+	if (client->header_in_value) {
+		header_complete(client);
+		client->header_in_value = 0;
+		client->header_name_len = 0;
+	}
+
+	/* A name longer than the buffer is not one we care about */
+	if (client->header_name_len + length >= sizeof(client->header_name)) {
+		client->header_name_len = sizeof(client->header_name);
+		return 0;
+	}
+
+	memcpy(client->header_name + client->header_name_len, at, length);
+	client->header_name_len += length;
+
+	return 0;
+}
+
+static int on_header_value(struct http_parser *parser, const char *at,
+			   size_t length)
+{
+	struct http_client_ctx *client = CONTAINER_OF(parser,
+						      struct http_client_ctx,
+						      parser);
+
+	if (!client->header_in_value) {
+		client->header_in_value = 1;
+		client->header_value_len = 0;
+		client->header = HTTP_SERVER_HEADER_OTHER;
+
+		if (client->header_name_len < sizeof(client->header_name)) {
+			client->header_name[client->header_name_len] = '\0';
+
+			if (strcasecmp(client->header_name, "Upgrade") == 0) {
+				client->header = HTTP_SERVER_HEADER_UPGRADE;
+			} else if (strcasecmp(client->header_name,
+					      "Sec-WebSocket-Key") == 0) {
+				client->header = HTTP_SERVER_HEADER_WS_KEY;
+			} else if (strcasecmp(client->header_name,
+					      "Sec-WebSocket-Version") == 0) {
+				client->header = HTTP_SERVER_HEADER_WS_VERSION;
+			}
+		}
+	}
+
+	if (client->header == HTTP_SERVER_HEADER_OTHER) {
+		return 0;
+	}
+
+	if (client->header_value_len + length >= sizeof(client->header_value)) {
+		client->header_value_len = sizeof(client->header_value);
+		return 0;
+	}
+
+	memcpy(client->header_value + client->header_value_len, at, length);
+	client->header_value_len += length;
+
+	return 0;
+}
+
+static int on_headers_complete(struct http_parser *parser)
+{
+	struct http_client_ctx *client = CONTAINER_OF(parser,
+						      struct http_client_ctx,
+						      parser);
+	char *query;
+
+	if (client->header_in_value) {
+		header_complete(client);
+		client->header_in_value = 0;
+	}
+
+	client->headers_complete = 1;
+	client->method = parser->method;
+
+	if (client->url_too_long) {
+		client->status = 414;
+		return 0;
+	}
+
+	query = strchr(client->url_buffer, '?');
+	if (query != NULL) {
+		*query = '\0';
+	}
+
+	client->resource = find_resource(client->service, client->url_buffer,
+					 &client->resource_prefix_len);
+	if (client->resource == NULL) {
+		client->status = 404;
+	} else if (!(client->resource->bitmask_of_supported_http_methods &
+		     BIT(client->method))) {
+		client->status = 405;
+	}
+
+	NET_DBG("[%p] %s %s", client, http_method_str(client->method),
+		client->url_buffer);
+
+	return 0;
+}
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = CONTAINER_OF(parser,
+						      struct http_client_ctx,
+						      parser);
+	const struct http_resource_detail_dynamic *dyn =
+		(const struct http_resource_detail_dynamic *)client->resource;
+
+	if (client->status != 0 || client->dynamic_failed ||
+	    client->resource->type != HTTP_RESOURCE_TYPE_DYNAMIC) {
+		return 0;
+	}
+
+	if (dyn->cb(client, HTTP_SERVER_DATA_MORE, (uint8_t *)at, length,
+		    dyn->user_data) < 0) {
+		client->dynamic_failed = 1;
+	}
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_client_ctx *client = CONTAINER_OF(parser,
+						      struct http_client_ctx,
+						      parser);
+
+	client->message_complete = 1;
+
+	prepare_response(client);
+
+	/* Keep the next pipelined request until this response is out */
+	http_parser_pause(parser, 1);
+
+	return 0;
+}
+
+static void init_parser(struct http_client_ctx *client)
+{
+	http_parser_init(&client->parser, HTTP_REQUEST);
+	http_parser_settings_init(&client->parser_settings);
+
+	client->parser_settings.on_message_begin = on_message_begin;
+	client->parser_settings.on_url = on_url;
+	client->parser_settings.on_header_field = on_header_field;
+	client->parser_settings.on_header_value = on_header_value;
+	client->parser_settings.on_headers_complete = on_headers_complete;
+	client->parser_settings.on_body = on_body;
+	client->parser_settings.on_message_complete = on_message_complete;
+}
+
+static int process_data(struct http_client_ctx *client)
+{
+	enum http_errno err;
+	size_t parsed;
+
+	while (client->data_len > 0 && !client->tx_pending) {
+		parsed = http_parser_execute(&client->parser,
+					     &client->parser_settings,
+					     (const char *)client->buffer,
+					     client->data_len);
+
+		err = HTTP_PARSER_ERRNO(&client->parser);
+		if (err != HPE_OK && err != HPE_PAUSED) {
+			NET_DBG("[%p] HTTP parser error %s", client,
+				http_errno_name(err));
+
+			dynamic_abort(client);
+
+			client->data_len = 0;
+			client->tx_hdr_sent = 0;
+			client->tx_body_len = 0;
+			client->tx_pending = 1;
+			client->close_after_tx = 1;
+			error_response(client, 400);
+
+			return 0;
+		}
+
+		client->data_len -= parsed;
+		memmove(client->buffer, client->buffer + parsed,
+			client->data_len);
+
+		if (!client->message_complete) {
+			/* The parser consumes everything until the end of a
+			 * message.
+			 */
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static int send_data(struct http_client_ctx *client, const void *data,
+		     size_t len)
+{
+	int ret;
+
+	ret = zsock_send(client->fd, data, len, 0);
+	if (ret < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	client->last_activity = k_uptime_get();
+
+	return ret;
+}
+
+static int response_done(struct http_client_ctx *client)
+{
+	client->tx_pending = 0;
+
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+	if (client->ws_after_tx) {
+		return ws_handoff(client);
+	}
+#endif
+
+	if (client->close_after_tx) {
+		return -ECONNRESET;
+	}
+
+	/* Ready for the next request, which may already be buffered */
+	http_parser_init(&client->parser, HTTP_REQUEST);
+	client->message_complete = 0;
+	client->headers_complete = 0;
+
+	return process_data(client);
+}
+
+int http_server_client_send(struct http_client_ctx *client)
+{
+	int ret;
+
+	while (client->tx_pending) {
+		if (client->tx_hdr_sent < client->tx_hdr_len) {
+			ret = send_data(client, client->tx_hdr + client->tx_hdr_sent,
+					client->tx_hdr_len - client->tx_hdr_sent);
+			if (ret <= 0) {
+				return ret;
+			}
+
+			client->tx_hdr_sent += ret;
+			continue;
+		}
+
+		if (client->tx_body_len > 0) {
+			ret = send_data(client, client->tx_body, client->tx_body_len);
+			if (ret <= 0) {
+				return ret;
+			}
+
+			client->tx_body += ret;
+			client->tx_body_len -= ret;
+			continue;
+		}
+
+#if defined(CONFIG_FILE_SYSTEM)
+		if (client->file_open) {
+			if (client->file_remaining == 0) {
+				(void)fs_close(&client->file);
+				client->file_open = 0;
+				continue;
+			}
+
+			ret = fs_read(&client->file, client->tx_buf,
+				      MIN(sizeof(client->tx_buf),
+					  client->file_remaining));
+			if (ret <= 0) {
+				NET_DBG("[%p] Cannot read file (%d)", client, ret);
+				return -EIO;
+			}
+
+			client->tx_body = client->tx_buf;
+			client->tx_body_len = ret;
+			client->file_remaining -= ret;
+			continue;
+		}
+#endif
+
+		ret = response_done(client);
+		if (ret < 0) {
+			return ret;
+		}
+
+		/* The next buffered request may have a response already */
+	}
+
+	return 0;
+}
+
+int http_server_client_recv(struct http_client_ctx *client)
+{
+	int ret;
+
+	ret = zsock_recv(client->fd, client->buffer + client->data_len,
+			 sizeof(client->buffer) - client->data_len, 0);
+	if (ret == 0) {
+		NET_DBG("[%p] Connection closed by peer", client);
+		return -ENOTCONN;
+	} else if (ret < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	client->data_len += ret;
+	client->last_activity = k_uptime_get();
+
+	ret = process_data(client);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Most responses fit in the socket buffer, try right away */
+	if (client->tx_pending) {
+		return http_server_client_send(client);
+	}
+
+	return 0;
+}
+
+void http_server_client_init(struct http_client_ctx *client, int fd,
+			     const struct http_service_desc *service)
+{
+	memset(client, 0, sizeof(*client));
+
+	client->fd = fd;
+	client->service = service;
+	client->last_activity = k_uptime_get();
+
+	init_parser(client);
+}
+
+void http_server_client_release(struct http_client_ctx *client,
+				bool close_socket)
+{
+	dynamic_abort(client);
+
+#if defined(CONFIG_FILE_SYSTEM)
+	if (client->file_open) {
+		(void)fs_close(&client->file);
+		client->file_open = 0;
+	}
+#endif
+
+	if (close_socket && client->fd >= 0) {
+		(void)zsock_close(client->fd);
+	}
+
+	client->fd = -1;
+}
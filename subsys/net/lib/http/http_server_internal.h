@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_NET_LIB_HTTP_SERVER_INTERNAL_H_
+#define ZEPHYR_SUBSYS_NET_LIB_HTTP_SERVER_INTERNAL_H_
+
+#include <zephyr/net/http/server.h>
+
+/* Start serving a newly accepted connection */
+void http_server_client_init(struct http_client_ctx *client, int fd,
+			     const struct http_service_desc *service);
+
+/* Release the resources of a connection, closing the socket if
+ * close_socket is set.
+ */
+void http_server_client_release(struct http_client_ctx *client,
+				bool close_socket);
+
+/* Read and process the data received from the client. Returns <0 if the
+ * connection is to be closed.
+ */
+int http_server_client_recv(struct http_client_ctx *client);
+
+/* Send the pending response. Returns <0 if the connection is to be
+ * closed. The connection may have been given to the WebSocket library, in
+ * which case the fd of the client is set to -1.
+ */
+int http_server_client_send(struct http_client_ctx *client);
+
+#endif /* ZEPHYR_SUBSYS_NET_LIB_HTTP_SERVER_INTERNAL_H_ */
@@ -1608,7 +1608,8 @@ static inline int time_left(uint32_t start, uint32_t timeout)
 	return timeout - elapsed;
 }
 
-int zsock_poll_internal(struct zsock_pollfd *fds, int nfds, k_timeout_t timeout)
+int zsock_poll_signal_internal(struct zsock_pollfd *fds, int nfds,
+			       struct k_poll_signal *wakeup, k_timeout_t timeout)
 {
 	bool retry;
 	int ret = 0;
@@ -1683,6 +1684,20 @@ int zsock_poll_internal(struct zsock_pollfd *fds, int nfds, k_timeout_t timeout)
 		}
 	}
 
+	/* The wakeup signal goes after the socket events so that the
+	 * update loop below sees the socket events in the same order.
+	 */
+	if (wakeup != NULL) {
+		if (pev == pev_end) {
+			errno = ENOMEM;
+			return -1;
+		}
+
+		k_poll_event_init(pev, K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, wakeup);
+		pev++;
+	}
+
 	if (offload) {
 		int poll_timeout;
 
@@ -1756,6 +1771,10 @@ int zsock_poll_internal(struct zsock_pollfd *fds, int nfds, k_timeout_t timeout)
 				break;
 			}
 
+			if (wakeup != NULL && wakeup->signaled) {
+				break;
+			}
+
 			timeout_recalc(end, &timeout);
 
 			if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
@@ -1767,6 +1786,11 @@ int zsock_poll_internal(struct zsock_pollfd *fds, int nfds, k_timeout_t timeout)
 	return ret;
 }
 
+int zsock_poll_internal(struct zsock_pollfd *fds, int nfds, k_timeout_t timeout)
+{
+	return zsock_poll_signal_internal(fds, nfds, NULL, timeout);
+}
+
 int z_impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int poll_timeout)
 {
 	k_timeout_t timeout;
@@ -18,6 +18,12 @@
 int zsock_close_ctx(struct net_context *ctx);
 int zsock_poll_internal(struct zsock_pollfd *fds, int nfds, k_timeout_t timeout);
 
+/* Same as zsock_poll_internal() but also returns early when the wakeup
+ * signal is raised. The caller is responsible for resetting the signal.
+ */
+int zsock_poll_signal_internal(struct zsock_pollfd *fds, int nfds,
+			       struct k_poll_signal *wakeup, k_timeout_t timeout);
+
 int zsock_wait_data(struct net_context *ctx, k_timeout_t *timeout);
 
 static inline void sock_set_flag(struct net_context *ctx, uintptr_t mask,
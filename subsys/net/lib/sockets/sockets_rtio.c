@@ -0,0 +1,403 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* RTIO iodev for BSD sockets.
+ *
+ * Submissions are queued to the iodev from any context and a single
+ * reactor thread executes them with non-blocking socket calls. An
+ * operation that would block stays at the head of its queue and the
+ * reactor waits for the socket to become ready together with all the
+ * other bound sockets, using the same poll machinery as zsock_poll()
+ * plus a signal that is raised on every new submission.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_sock_rtio, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_rtio.h>
+#ifdef CONFIG_ARCH_POSIX
+#include <fcntl.h>
+#else
+#include <zephyr/posix/fcntl.h>
+#endif
+
+#include "sockets_internal.h"
+
+#define MAX_SOCKETS CONFIG_NET_SOCKETS_RTIO_MAX_SOCKETS
+
+/* Each socket uses at most two poll events, plus one for the wakeup */
+BUILD_ASSERT(CONFIG_NET_SOCKETS_POLL_MAX >= 2 * MAX_SOCKETS + 1,
+	     "CONFIG_NET_SOCKETS_POLL_MAX too small for the socket RTIO iodevs");
+
+static struct zsock_rtio_data *bound[MAX_SOCKETS];
+static struct zsock_pollfd fds[MAX_SOCKETS];
+static K_MUTEX_DEFINE(lock);
+static struct k_poll_signal wakeup = K_POLL_SIGNAL_INITIALIZER(wakeup);
+
+static struct rtio_iodev_sqe *queue_pop(struct rtio_mpsc *q)
+{
+	struct rtio_mpsc_node *node = rtio_mpsc_pop(q);
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	return CONTAINER_OF(node, struct rtio_iodev_sqe, q);
+}
+
+static void complete(struct zsock_rtio_data *data,
+		     struct rtio_iodev_sqe *iodev_sqe, int result)
+{
+	struct rtio_sqe *sqe = &iodev_sqe->sqe;
+
+	/* A multishot receive would be resubmitted right away by the
+	 * executor, so stop it when the peer closed the connection or on
+	 * error. The final completion carries the reason.
+	 */
+	if (result < 0 || (result == 0 && data->stream && sqe->op == RTIO_OP_RX)) {
+		sqe->flags &= ~RTIO_SQE_MULTISHOT;
+	}
+
+	if (result < 0) {
+		rtio_iodev_sqe_err(iodev_sqe, result);
+	} else {
+		rtio_iodev_sqe_ok(iodev_sqe, result);
+	}
+}
+
+static int sock_recv(struct zsock_rtio_data *data,
+		     struct rtio_iodev_sqe *iodev_sqe)
+{
+	uint32_t buf_len;
+	uint8_t *buf;
+	int ret;
+
+	ret = rtio_sqe_rx_buf(iodev_sqe, 1, CONFIG_NET_SOCKETS_RTIO_RX_BUF_SIZE,
+			      &buf, &buf_len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = zsock_recv(data->sock, buf, buf_len, ZSOCK_MSG_DONTWAIT);
+
+	return ret < 0 ? -errno : ret;
+}
+
+static int sock_accept(struct zsock_rtio_data *data,
+		       struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_sqe *sqe = &iodev_sqe->sqe;
+	socklen_t addrlen = sqe->buf_len;
+	int ret;
+
+	ret = zsock_accept(data->sock, (struct sockaddr *)sqe->buf,
+			   sqe->buf != NULL ? &addrlen : NULL);
+
+	return ret < 0 ? -errno : ret;
+}
+
+static int sock_connect(struct zsock_rtio_data *data,
+			struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_sqe *sqe = &iodev_sqe->sqe;
+	int ret;
+
+	ret = zsock_connect(data->sock, (struct sockaddr *)sqe->buf,
+			    sqe->buf_len);
+	if (ret == 0) {
+		return 0;
+	}
+
+	/* A non-blocking connect is polled for completion by calling
+	 * connect() again until it stops reporting EALREADY.
+	 */
+	if (errno == EINPROGRESS || errno == EALREADY) {
+		return -EAGAIN;
+	}
+
+	return errno == EISCONN ? 0 : -errno;
+}
+
+static int sock_send(struct zsock_rtio_data *data,
+		     struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_sqe *sqe = &iodev_sqe->sqe;
+	const uint8_t *buf;
+	uint32_t len;
+	int ret;
+
+	if (sqe->op == RTIO_OP_TINY_TX) {
+		buf = sqe->tiny_buf;
+		len = sqe->tiny_buf_len;
+	} else {
+		buf = sqe->buf;
+		len = sqe->buf_len;
+	}
+
+	/* Stream sockets may accept only part of the buffer, keep sending
+	 * so that a completion always means that the whole buffer is out.
+	 */
+	while (data->tx_off < len) {
+		ret = zsock_send(data->sock, buf + data->tx_off,
+				 len - data->tx_off, ZSOCK_MSG_DONTWAIT);
+		if (ret < 0) {
+			if (errno != EAGAIN) {
+				data->tx_off = 0U;
+			}
+
+			return -errno;
+		}
+
+		data->tx_off += ret;
+	}
+
+	ret = data->tx_off;
+	data->tx_off = 0U;
+
+	return ret;
+}
+
+static int execute(struct zsock_rtio_data *data,
+		   struct rtio_iodev_sqe *iodev_sqe)
+{
+	switch (iodev_sqe->sqe.op) {
+	case RTIO_OP_RX:
+		return sock_recv(data, iodev_sqe);
+	case RTIO_OP_ACCEPT:
+		return sock_accept(data, iodev_sqe);
+	case RTIO_OP_TX:
+	case RTIO_OP_TINY_TX:
+		return sock_send(data, iodev_sqe);
+	case RTIO_OP_CONNECT:
+		return sock_connect(data, iodev_sqe);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+/* Execute the operations of one queue until one of them would block */
+static bool process_queue(struct zsock_rtio_data *data, struct rtio_mpsc *q,
+			  struct rtio_iodev_sqe **cur)
+{
+	struct rtio_iodev_sqe *done;
+	int ret;
+
+	while (true) {
+		if (*cur == NULL) {
+			*cur = queue_pop(q);
+			if (*cur == NULL) {
+				return false;
+			}
+		}
+
+		if ((*cur)->sqe.flags & RTIO_SQE_CANCELED) {
+			ret = -ECANCELED;
+		} else {
+			ret = execute(data, *cur);
+			if (ret == -EAGAIN) {
+				return true;
+			}
+		}
+
+		/* The completion may resubmit a multishot operation or the
+		 * next operation of a chain to this very queue.
+		 */
+		done = *cur;
+		*cur = NULL;
+		complete(data, done, ret);
+	}
+}
+
+static void fail_queue(struct rtio_mpsc *q, struct rtio_iodev_sqe **cur,
+		       int result)
+{
+	struct rtio_iodev_sqe *iodev_sqe = *cur;
+
+	*cur = NULL;
+
+	while (iodev_sqe != NULL) {
+		iodev_sqe->sqe.flags &= ~RTIO_SQE_MULTISHOT;
+		rtio_iodev_sqe_err(iodev_sqe, result);
+		iodev_sqe = queue_pop(q);
+	}
+}
+
+static void reactor_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		int nfds = 0;
+
+		k_poll_signal_reset(&wakeup);
+
+		k_mutex_lock(&lock, K_FOREVER);
+
+		for (int i = 0; i < MAX_SOCKETS; i++) {
+			struct zsock_rtio_data *data = bound[i];
+
+			fds[i].fd = -1;
+			fds[i].events = 0;
+
+			if (data == NULL) {
+				continue;
+			}
+
+			if (process_queue(data, &data->rx_q, &data->rx_cur)) {
+				fds[i].events |= ZSOCK_POLLIN;
+			}
+
+			if (process_queue(data, &data->tx_q, &data->tx_cur)) {
+				fds[i].events |= ZSOCK_POLLOUT;
+			}
+
+			if (fds[i].events != 0) {
+				fds[i].fd = data->sock;
+				nfds = i + 1;
+			}
+		}
+
+		k_mutex_unlock(&lock);
+
+		if (zsock_poll_signal_internal(fds, nfds, &wakeup, K_FOREVER) < 0) {
+			NET_ERR("poll failed (%d)", errno);
+			k_sleep(K_MSEC(10));
+		}
+	}
+}
+
+K_THREAD_DEFINE(zsock_rtio_reactor, CONFIG_NET_SOCKETS_RTIO_STACK_SIZE,
+		reactor_thread, NULL, NULL, NULL,
+		K_PRIO_PREEMPT(CONFIG_NET_SOCKETS_RTIO_THREAD_PRIO), 0, 0);
+
+static void zsock_rtio_submit(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct zsock_rtio_data *data = iodev_sqe->sqe.iodev->data;
+
+	if (data->sock < 0) {
+		rtio_iodev_sqe_err(iodev_sqe, -EBADF);
+		return;
+	}
+
+	if (iodev_sqe->sqe.flags & RTIO_SQE_TRANSACTION) {
+		rtio_iodev_sqe_err(iodev_sqe, -ENOTSUP);
+		return;
+	}
+
+	switch (iodev_sqe->sqe.op) {
+	case RTIO_OP_NOP:
+		rtio_iodev_sqe_ok(iodev_sqe, 0);
+		return;
+	case RTIO_OP_RX:
+	case RTIO_OP_ACCEPT:
+		rtio_mpsc_push(&data->rx_q, &iodev_sqe->q);
+		break;
+	case RTIO_OP_TX:
+	case RTIO_OP_TINY_TX:
+	case RTIO_OP_CONNECT:
+		rtio_mpsc_push(&data->tx_q, &iodev_sqe->q);
+		break;
+	default:
+		rtio_iodev_sqe_err(iodev_sqe, -ENOTSUP);
+		return;
+	}
+
+	k_poll_signal_raise(&wakeup, 0);
+}
+
+const struct rtio_iodev_api zsock_rtio_iodev_api = {
+	.submit = zsock_rtio_submit,
+};
+
+int zsock_rtio_iodev_bind(struct rtio_iodev *iodev, int sock)
+{
+	struct zsock_rtio_data *data = iodev->data;
+	socklen_t optlen = sizeof(int);
+	int type;
+	int ret;
+	int i;
+
+	if (iodev->api != &zsock_rtio_iodev_api || sock < 0) {
+		return -EINVAL;
+	}
+
+	ret = zsock_getsockopt(sock, SOL_SOCKET, SO_TYPE, &type, &optlen);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	ret = zsock_fcntl(sock, F_GETFL, 0);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	ret = zsock_fcntl(sock, F_SETFL, ret | O_NONBLOCK);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	if (data->sock >= 0) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	for (i = 0; i < MAX_SOCKETS; i++) {
+		if (bound[i] == NULL) {
+			break;
+		}
+	}
+
+	if (i == MAX_SOCKETS) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	data->stream = (type == SOCK_STREAM);
+	data->rx_cur = NULL;
+	data->tx_cur = NULL;
+	data->tx_off = 0U;
+	data->sock = sock;
+	bound[i] = data;
+
+out:
+	k_mutex_unlock(&lock);
+
+	return ret;
+}
+
+int zsock_rtio_iodev_unbind(struct rtio_iodev *iodev)
+{
+	struct zsock_rtio_data *data = iodev->data;
+	int ret = -EALREADY;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	for (int i = 0; i < MAX_SOCKETS; i++) {
+		if (bound[i] == data) {
+			bound[i] = NULL;
+			ret = 0;
+			break;
+		}
+	}
+
+	if (ret == 0) {
+		data->sock = -1;
+		fail_queue(&data->rx_q, &data->rx_cur, -ECANCELED);
+		fail_queue(&data->tx_q, &data->tx_cur, -ECANCELED);
+		data->tx_off = 0U;
+	}
+
+	k_mutex_unlock(&lock);
+
+	/* Make the reactor drop the socket from its poll set */
+	k_poll_signal_raise(&wakeup, 0);
+
+	return ret;
+}
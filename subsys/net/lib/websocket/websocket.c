@@ -274,6 +274,7 @@ int websocket_connect(int sock, struct websocket_request *wreq,
 	}
 
 	ctx->real_sock = sock;
+	ctx->server = 0;
 	ctx->recv_buf.buf = wreq->tmp_buf;
 	ctx->recv_buf.size = wreq->tmp_buf_len;
 	ctx->sec_accept_key = sec_accept_key;
@@ -404,6 +405,56 @@ out:
 	return ret;
 }
 
+int websocket_register(int sock, uint8_t *recv_buf, size_t recv_buf_len)
+{
+	struct websocket_context *ctx;
+	int ret, fd;
+
+	if (sock < 0 || recv_buf == NULL || recv_buf_len == 0) {
+		return -EINVAL;
+	}
+
+	ctx = websocket_find(sock);
+	if (ctx) {
+		NET_DBG("[%p] Websocket for sock %d already exists!", ctx,
+			sock);
+		return -EEXIST;
+	}
+
+	ctx = websocket_get();
+	if (!ctx) {
+		return -ENOENT;
+	}
+
+	ctx->real_sock = sock;
+	ctx->recv_buf.buf = recv_buf;
+	ctx->recv_buf.size = recv_buf_len;
+	ctx->recv_buf.count = 0;
+	ctx->user_data = NULL;
+	ctx->server = 1;
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	ctx->sock = fd;
+	z_finalize_fd(fd, ctx,
+		      (const struct fd_op_vtable *)&websocket_fd_op_vtable);
+
+	/* Init parser FSM */
+	ctx->parser_state = WEBSOCKET_PARSER_STATE_OPCODE;
+
+	NET_DBG("[%p] WS connection from peer registered (fd %d)", ctx, fd);
+
+	return fd;
+
+out:
+	websocket_context_unref(ctx);
+	return ret;
+}
+
 int websocket_disconnect(int ws_sock)
 {
 	return close(ws_sock);
@@ -420,7 +471,7 @@ static int websocket_interal_disconnect(struct websocket_context *ctx)
 	NET_DBG("[%p] Disconnecting", ctx);
 
 	ret = websocket_send_msg(ctx->sock, NULL, 0, WEBSOCKET_OPCODE_CLOSE,
-				 true, true, SYS_FOREVER_MS);
+				 !ctx->server, true, SYS_FOREVER_MS);
 	if (ret < 0) {
 		NET_ERR("[%p] Failed to send close message (err %d).", ctx, ret);
 	}
@@ -1058,7 +1109,7 @@ static int websocket_send(struct websocket_context *ctx, const uint8_t *buf,
 
 	ret = websocket_send_msg(ctx->sock, buf, buf_len,
 				 WEBSOCKET_OPCODE_DATA_TEXT,
-				 true, true, timeout);
+				 !ctx->server, true, timeout);
 	if (ret < 0) {
 		errno = -ret;
 		return -1;
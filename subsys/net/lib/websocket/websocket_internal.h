@@ -119,6 +119,11 @@ __net_socket struct websocket_context {
 
 	/** Did we receive all from peer during HTTP handshake */
 	uint8_t all_received : 1;
+
+	/** The Websocket was registered by a server, the frames it sends
+	 * are not masked.
+	 */
+	uint8_t server : 1;
 };
 
 #if defined(CONFIG_NET_TEST)
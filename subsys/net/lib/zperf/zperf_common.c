@@ -47,6 +47,12 @@ K_THREAD_STACK_DEFINE(zperf_work_q_stack, CONFIG_ZPERF_WORK_Q_STACK_SIZE);
 
 static struct k_work_q zperf_work_q;
 
+/* Threads of the streams of an upload, used by one upload at a time */
+static K_THREAD_STACK_ARRAY_DEFINE(zperf_stream_stacks, ZPERF_MAX_STREAMS,
+				   CONFIG_NET_ZPERF_STREAM_STACK_SIZE);
+static struct k_thread zperf_stream_threads[ZPERF_MAX_STREAMS];
+static K_MUTEX_DEFINE(zperf_streams_lock);
+
 int zperf_get_ipv6_addr(char *host, char *prefix_str, struct in6_addr *addr)
 {
 	struct net_if_ipv6_prefix *prefix;
@@ -208,6 +214,108 @@ uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps)
 			  (rate_in_kbps * 1024U));
 }
 
+void zperf_report_init(struct zperf_report *report, uint32_t interval_ms,
+		       zperf_callback callback, void *user_data,
+		       int64_t start_time)
+{
+	memset(report, 0, sizeof(*report));
+
+	if (callback == NULL || interval_ms == 0U) {
+		return;
+	}
+
+	report->callback = callback;
+	report->user_data = user_data;
+	report->interval = k_ms_to_ticks_ceil64(interval_ms);
+	report->last_time = start_time;
+}
+
+void zperf_report_update(struct zperf_report *report, int64_t now,
+			 uint32_t nb_packets, uint64_t total_len,
+			 uint32_t packet_size)
+{
+	struct zperf_results results = { 0 };
+
+	if (report->interval == 0 ||
+	    now - report->last_time < report->interval) {
+		return;
+	}
+
+	results.nb_packets_sent = nb_packets - report->last_packets;
+	results.total_len = (uint32_t)(total_len - report->last_len);
+	results.client_time_in_us =
+		k_ticks_to_us_ceil32(now - report->last_time);
+	results.packet_size = packet_size;
+
+	report->last_time = now;
+	report->last_packets = nb_packets;
+	report->last_len = total_len;
+
+	report->callback(ZPERF_SESSION_PERIODIC_RESULT, &results,
+			 report->user_data);
+}
+
+static void zperf_stream_thread(void *ptr1, void *ptr2, void *ptr3)
+{
+	struct zperf_stream *stream = ptr1;
+
+	ARG_UNUSED(ptr2);
+	ARG_UNUSED(ptr3);
+
+	stream->func(stream);
+}
+
+static void zperf_streams_report(struct zperf_stream *streams,
+				 int num_streams, struct zperf_report *report)
+{
+	uint32_t nb_packets = 0U;
+	uint32_t total_len = 0U;
+
+	/* The length may wrap, only its increments are reported */
+	for (int i = 0; i < num_streams; i++) {
+		nb_packets += (uint32_t)atomic_get(&streams[i].nb_packets);
+		total_len += (uint32_t)atomic_get(&streams[i].total_len);
+	}
+
+	zperf_report_update(report, k_uptime_ticks(), nb_packets, total_len,
+			    streams[0].packet_size);
+}
+
+void zperf_streams_run(struct zperf_stream *streams, int num_streams,
+		       struct zperf_report *report)
+{
+	k_timeout_t timeout = K_FOREVER;
+	int64_t next;
+
+	__ASSERT_NO_MSG(num_streams > 0 && num_streams <= ZPERF_MAX_STREAMS);
+
+	k_mutex_lock(&zperf_streams_lock, K_FOREVER);
+
+	for (int i = 0; i < num_streams; i++) {
+		k_thread_create(&zperf_stream_threads[i], zperf_stream_stacks[i],
+				K_THREAD_STACK_SIZEOF(zperf_stream_stacks[i]),
+				zperf_stream_thread, &streams[i], NULL, NULL,
+				ZPERF_WORK_Q_THREAD_PRIORITY, 0, K_NO_WAIT);
+		k_thread_name_set(&zperf_stream_threads[i], "zperf_stream");
+	}
+
+	/* Wait for the streams, reporting their progress meanwhile */
+	for (int i = 0; i < num_streams; i++) {
+		do {
+			if (report->interval > 0) {
+				zperf_streams_report(streams, num_streams,
+						     report);
+				next = report->last_time + report->interval;
+				timeout = K_TICKS(MAX(next - k_uptime_ticks(),
+						      1));
+			}
+		} while (k_thread_join(&zperf_stream_threads[i], timeout) ==
+			 -EAGAIN);
+	}
+
+	k_mutex_unlock(&zperf_streams_lock);
+}
+
 void zperf_async_work_submit(struct k_work *work)
 {
 	k_work_submit_to_queue(&zperf_work_q, work);
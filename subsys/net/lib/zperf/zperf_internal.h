@@ -10,6 +10,7 @@
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/zperf.h>
 #include <zephyr/shell/shell.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/__assert.h>
 
 #define IP6PREFIX_STR2(s) #s
@@ -45,6 +46,20 @@
 
 #define ZPERF_VERSION "1.1"
 
+#define ZPERF_MAX_STREAMS CONFIG_NET_ZPERF_MAX_STREAMS
+
+/* zperf specific client header flag: the server echoes the datagram back
+ * to the client instead of accounting it to a session. Used for the
+ * request/response latency test.
+ */
+#define ZPERF_FLAGS_ECHO 0x00100000
+
+/* zperf specific flag sent in the first four bytes of a TCP connection:
+ * the server sends data back on the connection while receiving, for the
+ * bidirectional test.
+ */
+#define ZPERF_FLAGS_BIDIR 0x00200000
+
 struct zperf_udp_datagram {
 	int32_t id;
 	uint32_t tv_sec;
@@ -82,6 +97,40 @@ struct zperf_async_upload_context {
 	void *user_data;
 };
 
+struct zperf_report {
+	zperf_callback callback;
+	void *user_data;
+	/* Report interval in ticks, 0 if periodic reports are disabled */
+	int64_t interval;
+	int64_t last_time;
+	uint32_t last_packets;
+	uint64_t last_len;
+};
+
+struct zperf_stream;
+
+typedef void (*zperf_stream_func)(struct zperf_stream *stream);
+
+/* One connection of an upload, run in its own thread by
+ * zperf_streams_run().
+ */
+struct zperf_stream {
+	zperf_stream_func func;
+	const struct zperf_upload_params *param;
+	int64_t end_time;
+	uint32_t packet_size;
+	int id;
+	int sock;
+	/* Read by the reporting thread while the stream runs */
+	atomic_t nb_packets;
+	atomic_t total_len;
+	/* Only read once the stream is done */
+	int ret;
+	uint32_t nb_errors;
+	uint32_t alloc_errors;
+	uint32_t rx_len;
+};
+
 static inline uint32_t time_delta(uint32_t ts, uint32_t t)
 {
 	return (t >= ts) ? (t - ts) : (ULONG_MAX - ts + t);
@@ -103,6 +152,16 @@ int zperf_prepare_upload_sock(const struct sockaddr *peer_addr, int tos,
 
 uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps);
 
+void zperf_report_init(struct zperf_report *report, uint32_t interval_ms,
+		       zperf_callback callback, void *user_data,
+		       int64_t start_time);
+void zperf_report_update(struct zperf_report *report, int64_t now,
+			 uint32_t nb_packets, uint64_t total_len,
+			 uint32_t packet_size);
+
+void zperf_streams_run(struct zperf_stream *streams, int num_streams,
+		       struct zperf_report *report);
+
 void zperf_async_work_submit(struct k_work *work);
 void zperf_udp_uploader_init(void);
 void zperf_tcp_uploader_init(void);
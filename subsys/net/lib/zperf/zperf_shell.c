@@ -126,6 +126,24 @@ static long parse_number(const char *string, const uint32_t *divisor_arr,
 	return (*divisor == 0U) ? dec : dec * *divisor;
 }
 
+static uint32_t rate_kbps(uint64_t len, uint32_t time_in_us)
+{
+	if (time_in_us == 0U) {
+		return 0U;
+	}
+
+	return (uint32_t)((len * 8ULL * (uint64_t)USEC_PER_SEC) /
+			  ((uint64_t)time_in_us * 1024ULL));
+}
+
+struct upload_shell_ctx {
+	const struct shell *sh;
+	bool json;
+};
+
+static struct upload_shell_ctx udp_upload_ctx;
+static struct upload_shell_ctx tcp_upload_ctx;
+
 static int parse_ipv6_addr(const struct shell *sh, char *host, char *port,
 			   struct sockaddr_in6 *addr)
 {
@@ -361,6 +379,54 @@ static int cmd_udp_download(const struct shell *sh, size_t argc,
 	}
 }
 
+static void shell_upload_print_json(const struct shell *sh, const char *proto,
+				    struct zperf_results *results)
+{
+	shell_fprintf(sh, SHELL_NORMAL,
+		      "{\"protocol\":\"%s\",\"duration_us\":%u,"
+		      "\"client_duration_us\":%u,\"packet_size\":%u,"
+		      "\"packets_sent\":%u,\"packets_received\":%u,"
+		      "\"packets_lost\":%u,\"packets_outorder\":%u,"
+		      "\"errors\":%u,\"jitter_us\":%u,\"rate_kbps\":%u,"
+		      "\"client_rate_kbps\":%u,\"reverse_bytes\":%u,"
+		      "\"reverse_rate_kbps\":%u}\n",
+		      proto, results->time_in_us, results->client_time_in_us,
+		      results->packet_size, results->nb_packets_sent,
+		      results->nb_packets_rcvd, results->nb_packets_lost,
+		      results->nb_packets_outorder, results->nb_packets_errors,
+		      results->jitter_in_us,
+		      rate_kbps(results->total_len, results->time_in_us),
+		      rate_kbps((uint64_t)results->nb_packets_sent *
+				results->packet_size,
+				results->client_time_in_us),
+		      results->reverse_total_len,
+		      rate_kbps(results->reverse_total_len,
+				results->client_time_in_us));
+}
+
+static void shell_upload_print_interval(const struct shell *sh, bool json,
+					struct zperf_results *results)
+{
+	uint32_t rate = rate_kbps(results->total_len,
+				  results->client_time_in_us);
+
+	if (json) {
+		shell_fprintf(sh, SHELL_NORMAL,
+			      "{\"interval_us\":%u,\"packets_sent\":%u,"
+			      "\"bytes\":%u,\"rate_kbps\":%u}\n",
+			      results->client_time_in_us,
+			      results->nb_packets_sent, results->total_len,
+			      rate);
+		return;
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, "Interval:\t");
+	print_number(sh, results->client_time_in_us, TIME_US, TIME_US_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, "\t%u packets\t", results->nb_packets_sent);
+	print_number(sh, rate, KBPS, KBPS_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, "\n");
+}
+
 static void shell_udp_upload_print_stats(const struct shell *sh,
 					 struct zperf_results *results)
 {
@@ -456,6 +522,14 @@ static void shell_tcp_upload_print_stats(const struct shell *sh,
 		shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t");
 		print_number(sh, client_rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, "\n");
+
+		if (results->reverse_total_len > 0U) {
+			shell_fprintf(sh, SHELL_NORMAL, "Reverse rate:\t");
+			print_number(sh, rate_kbps(results->reverse_total_len,
+						   results->client_time_in_us),
+				     KBPS, KBPS_UNIT);
+			shell_fprintf(sh, SHELL_NORMAL, "\n");
+		}
 	}
 }
 
@@ -463,14 +537,23 @@ static void udp_upload_cb(enum zperf_status status,
 			  struct zperf_results *result,
 			  void *user_data)
 {
-	const struct shell *sh = user_data;
+	struct upload_shell_ctx *ctx = user_data;
+	const struct shell *sh = ctx->sh;
 
 	switch (status) {
 	case ZPERF_SESSION_STARTED:
 		break;
 
+	case ZPERF_SESSION_PERIODIC_RESULT:
+		shell_upload_print_interval(sh, ctx->json, result);
+		break;
+
 	case ZPERF_SESSION_FINISHED: {
-		shell_udp_upload_print_stats(sh, result);
+		if (ctx->json) {
+			shell_upload_print_json(sh, "udp", result);
+		} else {
+			shell_udp_upload_print_stats(sh, result);
+		}
 		break;
 	}
 
@@ -484,14 +567,23 @@ static void tcp_upload_cb(enum zperf_status status,
 			  struct zperf_results *result,
 			  void *user_data)
 {
-	const struct shell *sh = user_data;
+	struct upload_shell_ctx *ctx = user_data;
+	const struct shell *sh = ctx->sh;
 
 	switch (status) {
 	case ZPERF_SESSION_STARTED:
 		break;
 
+	case ZPERF_SESSION_PERIODIC_RESULT:
+		shell_upload_print_interval(sh, ctx->json, result);
+		break;
+
 	case ZPERF_SESSION_FINISHED: {
-		shell_tcp_upload_print_stats(sh, result);
+		if (ctx->json) {
+			shell_upload_print_json(sh, "tcp", result);
+		} else {
+			shell_tcp_upload_print_stats(sh, result);
+		}
 		break;
 	}
 
@@ -503,11 +595,23 @@ static void tcp_upload_cb(enum zperf_status status,
 
 static int execute_upload(const struct shell *sh,
 			  const struct zperf_upload_params *param,
-			  bool is_udp, bool async)
+			  bool is_udp, bool async, bool json)
 {
 	struct zperf_results results = { 0 };
 	int ret;
 
+	if (param->report_interval_ms > 0U && !async) {
+		shell_fprintf(sh, SHELL_WARNING,
+			      "Periodic reports need an asynchronous upload (-a)\n");
+	}
+
+	if (json) {
+		/* Skip the human readable preamble to keep the output
+		 * parseable.
+		 */
+		goto start;
+	}
+
 	shell_fprintf(sh, SHELL_NORMAL, "Duration:\t");
 	print_number(sh, param->duration_ms * USEC_PER_MSEC, TIME_US,
 		     TIME_US_UNIT);
@@ -516,8 +620,16 @@ static int execute_upload(const struct shell *sh,
 		      param->packet_size);
 	shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t%u kbps\n",
 		      param->rate_kbps);
+	if (param->num_streams > 1U) {
+		shell_fprintf(sh, SHELL_NORMAL, "Streams:\t%u\n",
+			      param->num_streams);
+	}
+	if (param->bidirectional) {
+		shell_fprintf(sh, SHELL_NORMAL, "Bidirectional\n");
+	}
 	shell_fprintf(sh, SHELL_NORMAL, "Starting...\n");
 
+start:
 	if (IS_ENABLED(CONFIG_NET_IPV6) && param->peer_addr.sa_family == AF_INET6) {
 		struct sockaddr_in6 *ipv6 =
 				(struct sockaddr_in6 *)&param->peer_addr;
@@ -535,21 +647,28 @@ static int execute_upload(const struct shell *sh,
 		uint32_t packet_duration =
 			zperf_packet_duration(param->packet_size, param->rate_kbps);
 
-		shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t");
-		print_number(sh, param->rate_kbps, KBPS, KBPS_UNIT);
-		shell_fprintf(sh, SHELL_NORMAL, "\n");
-
-		if (packet_duration > 1000U) {
-			shell_fprintf(sh, SHELL_NORMAL, "Packet duration %u ms\n",
-				      (unsigned int)(packet_duration / 1000U));
-		} else {
-			shell_fprintf(sh, SHELL_NORMAL, "Packet duration %u us\n",
-				      (unsigned int)packet_duration);
+		if (!json) {
+			shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t");
+			print_number(sh, param->rate_kbps, KBPS, KBPS_UNIT);
+			shell_fprintf(sh, SHELL_NORMAL, "\n");
+
+			if (packet_duration > 1000U) {
+				shell_fprintf(sh, SHELL_NORMAL,
+					      "Packet duration %u ms\n",
+					      (unsigned int)(packet_duration / 1000U));
+			} else {
+				shell_fprintf(sh, SHELL_NORMAL,
+					      "Packet duration %u us\n",
+					      (unsigned int)packet_duration);
+			}
 		}
 
 		if (async) {
+			udp_upload_ctx.sh = sh;
+			udp_upload_ctx.json = json;
+
 			ret = zperf_udp_upload_async(param, udp_upload_cb,
-						     (void *)sh);
+						     &udp_upload_ctx);
 			if (ret < 0) {
 				shell_fprintf(sh, SHELL_ERROR,
 					"Failed to start UDP async upload (%d)\n", ret);
@@ -563,7 +682,11 @@ static int execute_upload(const struct shell *sh,
 				return ret;
 			}
 
-			shell_udp_upload_print_stats(sh, &results);
+			if (json) {
+				shell_upload_print_json(sh, "udp", &results);
+			} else {
+				shell_udp_upload_print_stats(sh, &results);
+			}
 		}
 	} else {
 		if (!IS_ENABLED(CONFIG_NET_UDP)) {
@@ -574,8 +697,11 @@ static int execute_upload(const struct shell *sh,
 
 	if (!is_udp && IS_ENABLED(CONFIG_NET_TCP)) {
 		if (async) {
+			tcp_upload_ctx.sh = sh;
+			tcp_upload_ctx.json = json;
+
 			ret = zperf_tcp_upload_async(param, tcp_upload_cb,
-						     (void *)sh);
+						     &tcp_upload_ctx);
 			if (ret < 0) {
 				shell_fprintf(sh, SHELL_ERROR,
 					"Failed to start TCP async upload (%d)\n", ret);
@@ -589,7 +715,11 @@ static int execute_upload(const struct shell *sh,
 				return ret;
 			}
 
-			shell_tcp_upload_print_stats(sh, &results);
+			if (json) {
+				shell_upload_print_json(sh, "tcp", &results);
+			} else {
+				shell_tcp_upload_print_stats(sh, &results);
+			}
 		}
 	} else {
 		if (!IS_ENABLED(CONFIG_NET_TCP)) {
@@ -638,6 +768,7 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 	struct sockaddr_in ipv4 = { .sin_family = AF_INET };
 	char *port_str;
 	bool async = false;
+	bool json = false;
 	bool is_udp;
 	int start = 0;
 	size_t opt_cnt = 0;
@@ -670,6 +801,50 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int streams = parse_arg(&i, argc, argv);
+
+			if (streams < 1 || streams > ZPERF_MAX_STREAMS) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Parse error: %s (max %d streams)\n",
+					      argv[i], ZPERF_MAX_STREAMS);
+				return -ENOEXEC;
+			}
+
+			param.num_streams = streams;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'i': {
+			int interval = parse_arg(&i, argc, argv);
+
+			if (interval < 0) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Parse error: %s\n", argv[i]);
+				return -ENOEXEC;
+			}
+
+			param.report_interval_ms = interval * MSEC_PER_SEC;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'J':
+			json = true;
+			opt_cnt += 1;
+			break;
+
+		case 'd':
+			if (is_udp) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "UDP does not support -d option\n");
+				return -ENOEXEC;
+			}
+			param.bidirectional = true;
+			opt_cnt += 1;
+			break;
+
 		case 'n':
 			if (is_udp) {
 				shell_fprintf(sh, SHELL_WARNING,
@@ -792,7 +967,7 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 		param.rate_kbps = 10U;
 	}
 
-	return execute_upload(sh, &param, is_udp, async);
+	return execute_upload(sh, &param, is_udp, async, json);
 }
 
 static int cmd_tcp_upload(const struct shell *sh, size_t argc, char *argv[])
@@ -812,6 +987,7 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 	sa_family_t family;
 	uint8_t is_udp;
 	bool async = false;
+	bool json = false;
 	int start = 0;
 	size_t opt_cnt = 0;
 
@@ -843,6 +1019,50 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int streams = parse_arg(&i, argc, argv);
+
+			if (streams < 1 || streams > ZPERF_MAX_STREAMS) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Parse error: %s (max %d streams)\n",
+					      argv[i], ZPERF_MAX_STREAMS);
+				return -ENOEXEC;
+			}
+
+			param.num_streams = streams;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'i': {
+			int interval = parse_arg(&i, argc, argv);
+
+			if (interval < 0) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Parse error: %s\n", argv[i]);
+				return -ENOEXEC;
+			}
+
+			param.report_interval_ms = interval * MSEC_PER_SEC;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'J':
+			json = true;
+			opt_cnt += 1;
+			break;
+
+		case 'd':
+			if (is_udp) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "UDP does not support -d option\n");
+				return -ENOEXEC;
+			}
+			param.bidirectional = true;
+			opt_cnt += 1;
+			break;
+
 		case 'n':
 			if (is_udp) {
 				shell_fprintf(sh, SHELL_WARNING,
@@ -930,7 +1150,7 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 		param.rate_kbps = 10U;
 	}
 
-	return execute_upload(sh, &param, is_udp, async);
+	return execute_upload(sh, &param, is_udp, async, json);
 }
 
 static int cmd_tcp_upload2(const struct shell *sh, size_t argc,
@@ -945,6 +1165,157 @@ static int cmd_udp_upload2(const struct shell *sh, size_t argc,
 	return shell_cmd_upload2(sh, argc, argv, IPPROTO_UDP);
 }
 
+static void shell_latency_print(const struct shell *sh, bool json,
+				struct zperf_latency_results *results)
+{
+	if (json) {
+		shell_fprintf(sh, SHELL_NORMAL,
+			      "{\"protocol\":\"udp\",\"requests\":%u,"
+			      "\"replies\":%u,\"timeouts\":%u,"
+			      "\"outorder\":%u,\"rtt_min_us\":%u,"
+			      "\"rtt_avg_us\":%u,\"rtt_max_us\":%u,"
+			      "\"jitter_us\":%u,\"histogram\":[",
+			      results->nb_requests, results->nb_replies,
+			      results->nb_timeouts, results->nb_outorder,
+			      results->rtt_min_us, results->rtt_avg_us,
+			      results->rtt_max_us, results->jitter_in_us);
+
+		for (int i = 0; i < ZPERF_LATENCY_HIST_BUCKETS; i++) {
+			shell_fprintf(sh, SHELL_NORMAL, "%s%u", i ? "," : "",
+				      results->hist[i]);
+		}
+
+		shell_fprintf(sh, SHELL_NORMAL, "]}\n");
+		return;
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, "-\nLatency test completed!\n");
+	shell_fprintf(sh, SHELL_NORMAL, "Requests:\t%u\n", results->nb_requests);
+	shell_fprintf(sh, SHELL_NORMAL, "Replies:\t%u\n", results->nb_replies);
+	shell_fprintf(sh, SHELL_NORMAL, "Timeouts:\t%u\n", results->nb_timeouts);
+	shell_fprintf(sh, SHELL_NORMAL, "Out of order:\t%u\n",
+		      results->nb_outorder);
+	shell_fprintf(sh, SHELL_NORMAL, "RTT min/avg/max:\t");
+	print_number(sh, results->rtt_min_us, TIME_US, TIME_US_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, " / ");
+	print_number(sh, results->rtt_avg_us, TIME_US, TIME_US_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, " / ");
+	print_number(sh, results->rtt_max_us, TIME_US, TIME_US_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, "\nJitter:\t\t");
+	print_number(sh, results->jitter_in_us, TIME_US, TIME_US_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, "\nRTT histogram:\n");
+
+	for (int i = 0; i < ZPERF_LATENCY_HIST_BUCKETS; i++) {
+		if (results->hist[i] == 0U) {
+			continue;
+		}
+
+		shell_fprintf(sh, SHELL_NORMAL, " %s%u us\t%u\n",
+			      i == ZPERF_LATENCY_HIST_BUCKETS - 1 ? ">= " : "< ",
+			      (uint32_t)(i == ZPERF_LATENCY_HIST_BUCKETS - 1 ?
+					 BIT(i) : BIT(i + 1)),
+			      results->hist[i]);
+	}
+}
+
+static int cmd_udp_latency(const struct shell *sh, size_t argc, char *argv[])
+{
+	struct zperf_latency_params param = { 0 };
+	struct zperf_latency_results results;
+	struct sockaddr_in6 ipv6 = { .sin6_family = AF_INET6 };
+	struct sockaddr_in ipv4 = { .sin_family = AF_INET };
+	char *port_str = DEF_PORT_STR;
+	bool json = false;
+	int start = 0;
+	size_t opt_cnt = 0;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_NET_UDP)) {
+		return -ENOTSUP;
+	}
+
+	/* Parse options */
+	for (size_t i = 1; i < argc; ++i) {
+		if (*argv[i] != '-') {
+			break;
+		}
+
+		switch (argv[i][1]) {
+		case 'S': {
+			int tos = parse_arg(&i, argc, argv);
+
+			if (tos < 0 || tos > UINT8_MAX) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Parse error: %s\n", argv[i]);
+				return -ENOEXEC;
+			}
+
+			param.options.tos = tos;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'J':
+			json = true;
+			opt_cnt += 1;
+			break;
+
+		default:
+			shell_fprintf(sh, SHELL_WARNING,
+				      "Unrecognized argument: %s\n", argv[i]);
+			return -ENOEXEC;
+		}
+	}
+
+	start += opt_cnt;
+	argc -= opt_cnt;
+
+	if (argc < 2) {
+		shell_fprintf(sh, SHELL_WARNING, "Not enough parameters.\n");
+		shell_help(sh);
+		return -ENOEXEC;
+	}
+
+	if (argc > 2) {
+		port_str = argv[start + 2];
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    parse_ipv6_addr(sh, argv[start + 1], port_str, &ipv6) == 0) {
+		memcpy(&param.peer_addr, &ipv6, sizeof(ipv6));
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   parse_ipv4_addr(sh, argv[start + 1], port_str, &ipv4) == 0) {
+		memcpy(&param.peer_addr, &ipv4, sizeof(ipv4));
+	} else {
+		shell_fprintf(sh, SHELL_WARNING,
+			      "Please specify the IP address of the "
+			      "remote server.\n");
+		return -ENOEXEC;
+	}
+
+	param.count = (argc > 3) ? strtoul(argv[start + 3], NULL, 10) : 100U;
+	param.interval_ms = (argc > 4) ? strtoul(argv[start + 4], NULL, 10) : 10U;
+	param.packet_size = (argc > 5) ? parse_number(argv[start + 5], K, K_UNIT) :
+			    64U;
+
+	if (!json) {
+		shell_fprintf(sh, SHELL_NORMAL,
+			      "Sending %u requests of %u bytes every %u ms\n",
+			      param.count, param.packet_size, param.interval_ms);
+	}
+
+	ret = zperf_udp_latency(&param, &results);
+	if (ret < 0) {
+		shell_fprintf(sh, SHELL_ERROR, "UDP latency test failed (%d)\n",
+			      ret);
+		return -ENOEXEC;
+	}
+
+	shell_latency_print(sh, json, &results);
+
+	return 0;
+}
+
 static int cmd_tcp(const struct shell *sh, size_t argc, char *argv[])
 {
 	if (IS_ENABLED(CONFIG_NET_TCP)) {
@@ -1146,6 +1517,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
 		  "-n: Disable Nagle's algorithm\n"
+		  "-d: Bidirectional, the zperf server sends data back\n"
+		  "-P streams: Number of parallel connections\n"
+		  "-i interval: Seconds between periodic reports (with -a)\n"
+		  "-J: Print the results in JSON format\n"
 		  "Example: tcp upload 192.0.2.2 1111 1 1K\n"
 		  "Example: tcp upload 2001:db8::2\n",
 		  cmd_tcp_upload),
@@ -1159,9 +1534,13 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-n: Disable Nagle's algorithm\n"
+		  "-d: Bidirectional, the zperf server sends data back\n"
+		  "-P streams: Number of parallel connections\n"
+		  "-i interval: Seconds between periodic reports (with -a)\n"
+		  "-J: Print the results in JSON format\n"
 		  "Example: tcp upload2 v6 1 1K\n"
 		  "Example: tcp upload2 v4\n"
-		  "-n: Disable Nagle's algorithm\n"
 #if defined(CONFIG_NET_IPV6) && defined(MY_IP6ADDR_SET)
 		  "Default IPv6 address is " MY_IP6ADDR
 		  ", destination [" DST_IP6ADDR "]:" DEF_PORT_STR "\n"
@@ -1198,6 +1577,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P streams: Number of parallel streams\n"
+		  "-i interval: Seconds between periodic reports (with -a)\n"
+		  "-J: Print the results in JSON format\n"
 		  "Example: udp upload 192.0.2.2 1111 1 1K 1M\n"
 		  "Example: udp upload 2001:db8::2\n",
 		  cmd_udp_upload),
@@ -1212,6 +1594,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P streams: Number of parallel streams\n"
+		  "-i interval: Seconds between periodic reports (with -a)\n"
+		  "-J: Print the results in JSON format\n"
 		  "Example: udp upload2 v4 1 1K 1M\n"
 		  "Example: udp upload2 v6\n"
 #if defined(CONFIG_NET_IPV6) && defined(MY_IP6ADDR_SET)
@@ -1228,6 +1613,17 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "[<port>]\n"
 		  "Example: udp download 5001\n",
 		  cmd_udp_download),
+	SHELL_CMD(latency, NULL,
+		  "[<options>] <dest ip> [<dest port> <count> <interval ms> "
+							"<packet size>[K]]\n"
+		  "Measure request/response round trip times. The peer must "
+		  "run the zperf UDP server (udp download).\n"
+		  "Available options:\n"
+		  "-S tos: Specify IPv4/6 type of service\n"
+		  "-J: Print the results in JSON format\n"
+		  "Example: udp latency 192.0.2.2 5001 1000 10 64\n"
+		  "Example: udp latency 127.0.0.1\n",
+		  cmd_udp_latency),
 	SHELL_SUBCMD_SET_END
 );
 
@@ -130,6 +130,21 @@ out:
 	return ret;
 }
 
+/* Send data back on a connection of a bidirectional test */
+static void tcp_send_back(struct zsock_pollfd *pollfd, bool *bidir)
+{
+	static uint8_t tx_buf[TCP_RECEIVER_BUF_SIZE];
+	ssize_t ret;
+
+	ret = zsock_send(pollfd->fd, tx_buf, sizeof(tx_buf),
+			 ZSOCK_MSG_DONTWAIT);
+	if (ret < 0 && errno != EAGAIN) {
+		/* The client is done, keep receiving until it closes */
+		pollfd->events = ZSOCK_POLLIN;
+		*bidir = false;
+	}
+}
+
 static void tcp_session_error_report(void)
 {
 	if (tcp_session_cb != NULL) {
@@ -142,10 +157,15 @@ static void tcp_server_session(void)
 	static uint8_t buf[TCP_RECEIVER_BUF_SIZE];
 	static struct zsock_pollfd fds[SOCK_ID_MAX];
 	static struct sockaddr sock_addr[SOCK_ID_MAX];
+	/* Set until the first data of a connection is received */
+	static bool sock_new[SOCK_ID_MAX];
+	static bool sock_bidir[SOCK_ID_MAX];
 	int ret;
 
 	for (int i = 0; i < ARRAY_SIZE(fds); i++) {
 		fds[i].fd = -1;
+		sock_new[i] = false;
+		sock_bidir[i] = false;
 	}
 
 	if (IS_ENABLED(CONFIG_NET_IPV4)) {
@@ -261,6 +281,16 @@ use_existing_ipv6:
 		}
 
 		for (int i = 0; i < ARRAY_SIZE(fds); i++) {
+			if ((fds[i].revents & ZSOCK_POLLERR) && sock_bidir[i]) {
+				/* Client gone while we were sending back */
+				tcp_received(&sock_addr[i], 0);
+				zsock_close(fds[i].fd);
+				fds[i].fd = -1;
+				sock_bidir[i] = false;
+				memset(&sock_addr[i], 0, sizeof(struct sockaddr));
+				continue;
+			}
+
 			if ((fds[i].revents & ZSOCK_POLLERR) ||
 			    (fds[i].revents & ZSOCK_POLLNVAL)) {
 				NET_ERR("TCP receiver IPv%d socket error",
@@ -269,6 +299,10 @@ use_existing_ipv6:
 				goto error;
 			}
 
+			if ((fds[i].revents & ZSOCK_POLLOUT) && sock_bidir[i]) {
+				tcp_send_back(&fds[i], &sock_bidir[i]);
+			}
+
 			if (!(fds[i].revents & ZSOCK_POLLIN)) {
 				continue;
 			}
@@ -301,13 +335,20 @@ use_existing_ipv6:
 				} else {
 					fds[j].fd = sock;
 					fds[j].events = ZSOCK_POLLIN;
+					sock_new[j] = true;
+					sock_bidir[j] = false;
 					memcpy(&sock_addr[j],
 					       &addr_incoming_conn,
 					       addrlen);
 				}
 			} else if ((i > SOCK_ID_IPV6_LISTEN) && (i < SOCK_ID_MAX)) {
 				ret = zsock_recv(fds[i].fd, buf, sizeof(buf), 0);
-				if (ret < 0) {
+				if (ret < 0 && sock_bidir[i]) {
+					/* The client may reset the connection
+					 * with our data still unread.
+					 */
+					ret = 0;
+				} else if (ret < 0) {
 					NET_ERR("recv failed on IPv%d socket (%d)",
 						(sock_addr[i].sa_family == AF_INET
 							? 4 : 6),
@@ -317,11 +358,24 @@ use_existing_ipv6:
 					ret = 0;
 				}
 
+				if (sock_new[i] && ret > 0) {
+					sock_new[i] = false;
+
+					if (ret >= (int)sizeof(uint32_t) &&
+					    (ntohl(UNALIGNED_GET((uint32_t *)buf)) &
+					     ZPERF_FLAGS_BIDIR)) {
+						sock_bidir[i] = true;
+						fds[i].events |= ZSOCK_POLLOUT;
+					}
+				}
+
 				tcp_received(&sock_addr[i], ret);
 
 				if (ret == 0) {
 					zsock_close(fds[i].fd);
 					fds[i].fd = -1;
+					sock_new[i] = false;
+					sock_bidir[i] = false;
 					memset(&sock_addr[i], 0,
 					sizeof(struct sockaddr));
 				}
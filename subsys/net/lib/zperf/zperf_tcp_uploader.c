@@ -18,60 +18,90 @@ LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
 
 static char sample_packet[PACKET_SIZE_MAX];
 
+/* Data sent back by the server, never looked at, so shared by the streams */
+static char discard_buf[PACKET_SIZE_MAX];
+
 static struct zperf_async_upload_context tcp_async_upload_ctx;
 
-static int tcp_upload(int sock,
-		      unsigned int duration_in_ms,
-		      unsigned int packet_size,
-		      struct zperf_results *results)
+static void tcp_stream_receive(struct zperf_stream *stream)
 {
-	int64_t duration = sys_clock_timeout_end_calc(K_MSEC(duration_in_ms));
-	int64_t start_time, last_print_time, end_time, remaining;
-	uint32_t nb_packets = 0U, nb_errors = 0U;
-	uint32_t alloc_errors = 0U;
-	int ret = 0;
+	ssize_t ret;
 
-	if (packet_size > PACKET_SIZE_MAX) {
-		NET_WARN("Packet size too large! max size: %u\n",
-			PACKET_SIZE_MAX);
-		packet_size = PACKET_SIZE_MAX;
-	}
+	do {
+		ret = zsock_recv(stream->sock, discard_buf, sizeof(discard_buf),
+				 ZSOCK_MSG_DONTWAIT);
+		if (ret > 0) {
+			stream->rx_len += ret;
+		}
+	} while (ret > 0);
+}
 
-	/* Start the loop */
-	start_time = k_uptime_ticks();
-	last_print_time = start_time;
+static void tcp_stream_wait(struct zperf_stream *stream, int64_t remaining)
+{
+	struct zsock_pollfd fds = {
+		.fd = stream->sock,
+		.events = ZSOCK_POLLIN | ZSOCK_POLLOUT,
+	};
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+	(void)zsock_poll(&fds, 1,
+			 MIN(k_ticks_to_ms_ceil32(MAX(remaining, 0)), 100));
+}
 
-	/* Set the "flags" field in start of the packet to be 0.
-	 * As the protocol is not properly described anywhere, it is
-	 * not certain if this is a proper thing to do.
-	 */
-	(void)memset(sample_packet, 0, sizeof(uint32_t));
+static void tcp_stream_upload(struct zperf_stream *stream)
+{
+	bool bidir = stream->param->bidirectional;
+	int64_t remaining;
+	ssize_t ret;
+
+	if (bidir) {
+		uint32_t flags = htonl(ZPERF_FLAGS_BIDIR);
+
+		ret = zsock_send(stream->sock, &flags, sizeof(flags), 0);
+		if (ret < 0) {
+			NET_ERR("Failed to send the header (%d)", errno);
+			stream->ret = -errno;
+			return;
+		}
+	}
 
 	do {
-		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		if (bidir) {
+			tcp_stream_receive(stream);
+		}
+
+		/* In bidirectional mode the stream must keep reading while
+		 * the socket is full, so it does not block on sending.
+		 */
+		ret = zsock_send(stream->sock, sample_packet,
+				 stream->packet_size,
+				 bidir ? ZSOCK_MSG_DONTWAIT : 0);
 		if (ret < 0) {
-			if (nb_errors == 0 && ret != -ENOMEM) {
+			if (bidir && errno == EAGAIN) {
+				tcp_stream_wait(stream, stream->end_time -
+						k_uptime_ticks());
+				goto next;
+			}
+
+			if (stream->nb_errors == 0 && errno != ENOMEM) {
 				NET_ERR("Failed to send the packet (%d)", errno);
 			}
 
-			nb_errors++;
+			stream->nb_errors++;
 
-			if (errno == -ENOMEM) {
+			if (errno == ENOMEM) {
 				/* Ignore memory errors as we just run out of
 				 * buffers which is kind of expected if the
 				 * buffer count is not optimized for the test
 				 * and device.
 				 */
-				alloc_errors++;
+				stream->alloc_errors++;
 			} else {
-				ret = -errno;
+				stream->ret = -errno;
 				break;
 			}
 		} else {
-			nb_packets++;
+			atomic_inc(&stream->nb_packets);
+			atomic_add(&stream->total_len, ret);
 		}
 
 #if defined(CONFIG_ARCH_POSIX)
@@ -79,18 +109,105 @@ static int tcp_upload(int sock,
 #else
 		k_yield();
 #endif
-
-		remaining = duration - k_uptime_ticks();
+next:
+		remaining = stream->end_time - k_uptime_ticks();
 	} while (remaining > 0);
 
+	if (bidir) {
+		tcp_stream_receive(stream);
+	}
+}
+
+static int tcp_upload_streams(const struct zperf_upload_params *param,
+			      struct zperf_report *report,
+			      struct zperf_results *result)
+{
+	struct zperf_stream streams[ZPERF_MAX_STREAMS];
+	int num_socks = MAX(param->num_streams, 1);
+	uint32_t packet_size = param->packet_size;
+	uint32_t alloc_errors = 0U;
+	int64_t start_time, end_time;
+	int ret = 0;
+	int i;
+
+	if (num_socks > ZPERF_MAX_STREAMS) {
+		NET_ERR("Too many streams (%d), max %d", num_socks,
+			ZPERF_MAX_STREAMS);
+		return -EINVAL;
+	}
+
+	if (packet_size > PACKET_SIZE_MAX) {
+		NET_WARN("Packet size too large! max size: %u\n",
+			PACKET_SIZE_MAX);
+		packet_size = PACKET_SIZE_MAX;
+	}
+
+	for (i = 0; i < num_socks; i++) {
+		int sock;
+
+		sock = zperf_prepare_upload_sock(&param->peer_addr,
+						 param->options.tos,
+						 IPPROTO_TCP);
+		if (sock < 0) {
+			ret = sock;
+			goto out;
+		}
+
+		memset(&streams[i], 0, sizeof(streams[i]));
+		streams[i].sock = sock;
+
+		if (param->options.tcp_nodelay &&
+		    zsock_setsockopt(sock, IPPROTO_TCP, TCP_NODELAY,
+				     &param->options.tcp_nodelay,
+				     sizeof(param->options.tcp_nodelay)) != 0) {
+			NET_WARN("Failed to set IPPROTO_TCP - TCP_NODELAY socket option.");
+			zsock_close(sock);
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+
+	/* Set the "flags" field in start of the packet to be 0.
+	 * As the protocol is not properly described anywhere, it is
+	 * not certain if this is a proper thing to do.
+	 */
+	(void)memset(sample_packet, 0, sizeof(uint32_t));
+
+	start_time = k_uptime_ticks();
+
+	for (i = 0; i < num_socks; i++) {
+		streams[i].func = tcp_stream_upload;
+		streams[i].param = param;
+		streams[i].end_time = start_time +
+			k_ms_to_ticks_ceil64(param->duration_ms);
+		streams[i].packet_size = packet_size;
+		streams[i].id = i;
+	}
+
+	zperf_streams_run(streams, num_socks, report);
+
 	end_time = k_uptime_ticks();
 
+	memset(result, 0, sizeof(*result));
+
+	for (i = 0; i < num_socks; i++) {
+		result->nb_packets_sent +=
+			(uint32_t)atomic_get(&streams[i].nb_packets);
+		result->nb_packets_errors += streams[i].nb_errors;
+		result->reverse_total_len += streams[i].rx_len;
+		alloc_errors += streams[i].alloc_errors;
+
+		if (ret == 0) {
+			ret = streams[i].ret;
+		}
+	}
+
 	/* Add result coming from the client */
-	results->nb_packets_sent = nb_packets;
-	results->client_time_in_us =
+	result->client_time_in_us =
 				k_ticks_to_us_ceil32(end_time - start_time);
-	results->packet_size = packet_size;
-	results->nb_packets_errors = nb_errors;
+	result->packet_size = packet_size;
 
 	if (alloc_errors > 0) {
 		NET_WARN("There was %u network buffer allocation "
@@ -101,42 +218,29 @@ static int tcp_upload(int sock,
 			 alloc_errors);
 	}
 
-	if (ret < 0) {
-		return ret;
+	/* All the sockets are open */
+	i = num_socks;
+
+out:
+	while (i-- > 0) {
+		zsock_close(streams[i].sock);
 	}
 
-	return 0;
+	return ret;
 }
 
 int zperf_tcp_upload(const struct zperf_upload_params *param,
 		     struct zperf_results *result)
 {
-	int sock;
-	int ret;
+	struct zperf_report report;
 
 	if (param == NULL || result == NULL) {
 		return -EINVAL;
 	}
 
-	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
-					 IPPROTO_TCP);
-	if (sock < 0) {
-		return sock;
-	}
-
-	if (param->options.tcp_nodelay &&
-	    zsock_setsockopt(sock, IPPROTO_TCP, TCP_NODELAY,
-			     &param->options.tcp_nodelay,
-			     sizeof(param->options.tcp_nodelay)) != 0) {
-		NET_WARN("Failed to set IPPROTO_TCP - TCP_NODELAY socket option.");
-		return -EINVAL;
-	}
-
-	ret = tcp_upload(sock, param->duration_ms, param->packet_size, result);
-
-	zsock_close(sock);
+	zperf_report_init(&report, 0, NULL, NULL, 0);
 
-	return ret;
+	return tcp_upload_streams(param, &report, result);
 }
 
 static void tcp_upload_async_work(struct k_work *work)
@@ -144,12 +248,17 @@ static void tcp_upload_async_work(struct k_work *work)
 	struct zperf_async_upload_context *upload_ctx =
 		CONTAINER_OF(work, struct zperf_async_upload_context, work);
 	struct zperf_results result;
+	struct zperf_report report;
 	int ret;
 
 	upload_ctx->callback(ZPERF_SESSION_STARTED, NULL,
 			     upload_ctx->user_data);
 
-	ret = zperf_tcp_upload(&upload_ctx->param, &result);
+	zperf_report_init(&report, upload_ctx->param.report_interval_ms,
+			  upload_ctx->callback, upload_ctx->user_data,
+			  k_uptime_ticks());
+
+	ret = tcp_upload_streams(&upload_ctx->param, &report, &result);
 	if (ret < 0) {
 		upload_ctx->callback(ZPERF_SESSION_ERROR, NULL,
 				     upload_ctx->user_data);
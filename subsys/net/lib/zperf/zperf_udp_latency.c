@@ -0,0 +1,190 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/math_extras.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/zperf.h>
+
+#include "zperf_internal.h"
+
+#define LATENCY_MIN_PACKET_SIZE (sizeof(struct zperf_udp_datagram) + \
+				 sizeof(struct zperf_client_hdr_v1))
+
+#define LATENCY_DEFAULT_TIMEOUT_MS 1000
+
+static uint8_t request[PACKET_SIZE_MAX];
+static uint8_t reply[PACKET_SIZE_MAX];
+
+static int rtt_bucket(uint32_t rtt_us)
+{
+	int bucket;
+
+	if (rtt_us < 2U) {
+		return 0;
+	}
+
+	bucket = 31 - u32_count_leading_zeros(rtt_us);
+
+	return MIN(bucket, ZPERF_LATENCY_HIST_BUCKETS - 1);
+}
+
+static void record_rtt(struct zperf_latency_results *result,
+		       uint32_t rtt_us, uint32_t *last_rtt_us,
+		       uint64_t *rtt_sum)
+{
+	result->nb_replies++;
+	result->hist[rtt_bucket(rtt_us)]++;
+
+	*rtt_sum += rtt_us;
+
+	if (result->nb_replies == 1U || rtt_us < result->rtt_min_us) {
+		result->rtt_min_us = rtt_us;
+	}
+
+	if (rtt_us > result->rtt_max_us) {
+		result->rtt_max_us = rtt_us;
+	}
+
+	/* Same estimator as the UDP receiver, see RFC 3550 6.4.1 */
+	if (result->nb_replies > 1U) {
+		int32_t delta = (int32_t)(rtt_us - *last_rtt_us);
+
+		delta = (delta < 0) ? -delta : delta;
+		result->jitter_in_us += (delta - (int32_t)result->jitter_in_us) / 16;
+	}
+
+	*last_rtt_us = rtt_us;
+}
+
+static int wait_reply(int sock, uint32_t id, uint32_t *outorder)
+{
+	struct zperf_udp_datagram *datagram;
+	int ret;
+
+	while (true) {
+		ret = zsock_recv(sock, reply, sizeof(reply), 0);
+		if (ret < 0) {
+			return (errno == EAGAIN) ? -EAGAIN : -errno;
+		}
+
+		if (ret < (int)sizeof(*datagram)) {
+			continue;
+		}
+
+		datagram = (struct zperf_udp_datagram *)reply;
+
+		/* A late reply to a request that already timed out */
+		if (ntohl(UNALIGNED_GET(&datagram->id)) != id) {
+			(*outorder)++;
+			continue;
+		}
+
+		return 0;
+	}
+}
+
+int zperf_udp_latency(const struct zperf_latency_params *param,
+		      struct zperf_latency_results *result)
+{
+	struct zperf_udp_datagram *datagram;
+	struct zperf_client_hdr_v1 *hdr;
+	struct timeval rcvtimeo = { 0 };
+	uint32_t packet_size, timeout_ms;
+	uint32_t last_rtt_us = 0U;
+	uint64_t rtt_sum = 0U;
+	int sock;
+	int ret = 0;
+
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	packet_size = CLAMP(param->packet_size, LATENCY_MIN_PACKET_SIZE,
+			    PACKET_SIZE_MAX);
+	timeout_ms = param->timeout_ms ? param->timeout_ms :
+		     LATENCY_DEFAULT_TIMEOUT_MS;
+
+	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
+					 IPPROTO_UDP);
+	if (sock < 0) {
+		return sock;
+	}
+
+	rcvtimeo.tv_sec = timeout_ms / MSEC_PER_SEC;
+	rcvtimeo.tv_usec = (timeout_ms % MSEC_PER_SEC) * USEC_PER_MSEC;
+
+	ret = zsock_setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &rcvtimeo,
+			       sizeof(rcvtimeo));
+	if (ret < 0) {
+		NET_ERR("setsockopt error (%d)", errno);
+		ret = -errno;
+		goto out;
+	}
+
+	memset(result, 0, sizeof(*result));
+	(void)memset(request, 'z', sizeof(request));
+
+	datagram = (struct zperf_udp_datagram *)request;
+	hdr = (struct zperf_client_hdr_v1 *)(request + sizeof(*datagram));
+
+	hdr->flags = htonl(ZPERF_FLAGS_ECHO);
+	hdr->num_of_threads = htonl(1);
+	hdr->port = 0;
+	hdr->buffer_len = 0;
+	hdr->bandwidth = 0;
+	hdr->num_of_bytes = htonl(packet_size);
+
+	for (uint32_t id = 0; id < param->count; id++) {
+		uint64_t now = k_uptime_ticks();
+		uint32_t start;
+
+		datagram->id = htonl(id);
+		datagram->tv_sec = htonl(k_ticks_to_ms_floor64(now) / MSEC_PER_SEC);
+		datagram->tv_usec = htonl(k_ticks_to_us_floor64(now) % USEC_PER_SEC);
+
+		/* Cycle counter for a finer resolution than the uptime */
+		start = k_cycle_get_32();
+
+		ret = zsock_send(sock, request, packet_size, 0);
+		if (ret < 0) {
+			NET_ERR("Failed to send the packet (%d)", errno);
+			ret = -errno;
+			goto out;
+		}
+
+		result->nb_requests++;
+
+		ret = wait_reply(sock, id, &result->nb_outorder);
+		if (ret == -EAGAIN) {
+			result->nb_timeouts++;
+		} else if (ret < 0) {
+			NET_ERR("Failed to receive packet (%d)", ret);
+			goto out;
+		} else {
+			record_rtt(result,
+				   k_cyc_to_us_floor32(k_cycle_get_32() - start),
+				   &last_rtt_us, &rtt_sum);
+		}
+
+		if (param->interval_ms > 0U) {
+			k_msleep(param->interval_ms);
+		}
+	}
+
+	if (result->nb_replies > 0U) {
+		result->rtt_avg_us = rtt_sum / result->nb_replies;
+	}
+
+	ret = 0;
+
+out:
+	zsock_close(sock);
+
+	return ret;
+}
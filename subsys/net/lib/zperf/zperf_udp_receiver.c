@@ -115,6 +115,24 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 	hdr = (struct zperf_udp_datagram *)data;
 	time = k_uptime_ticks();
 
+	if (datalen >= sizeof(struct zperf_udp_datagram) +
+		       sizeof(struct zperf_client_hdr_v1)) {
+		struct zperf_client_hdr_v1 *client_hdr =
+			(struct zperf_client_hdr_v1 *)(data + sizeof(*hdr));
+
+		/* Latency test request, send it back as is */
+		if (ntohl(UNALIGNED_GET(&client_hdr->flags)) == ZPERF_FLAGS_ECHO) {
+			if (zsock_sendto(sock, data, datalen, 0, addr,
+					 addr->sa_family == AF_INET6 ?
+					 sizeof(struct sockaddr_in6) :
+					 sizeof(struct sockaddr_in)) < 0) {
+				NET_ERR("Cannot send data to peer (%d)", errno);
+			}
+
+			return;
+		}
+	}
+
 	session = get_session(addr, SESSION_UDP);
 	if (!session) {
 		NET_ERR("Cannot get a session!");
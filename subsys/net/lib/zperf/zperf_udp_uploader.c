@@ -14,7 +14,9 @@ LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
 
 #include "zperf_internal.h"
 
-static uint8_t sample_packet[sizeof(struct zperf_udp_datagram) +
+/* One packet buffer per stream, the headers differ */
+static uint8_t sample_packet[ZPERF_MAX_STREAMS]
+			    [sizeof(struct zperf_udp_datagram) +
 			     sizeof(struct zperf_client_hdr_v1) +
 			     PACKET_SIZE_MAX];
 
@@ -45,7 +47,7 @@ static inline void zperf_upload_decode_stat(const uint8_t *data,
 		ntohl(UNALIGNED_GET(&stat->jitter1)) * USEC_PER_SEC;
 }
 
-static inline int zperf_upload_fin(int sock,
+static inline int zperf_upload_fin(int sock, uint8_t *packet,
 				   uint32_t nb_packets,
 				   uint64_t end_time,
 				   uint32_t packet_size,
@@ -65,14 +67,14 @@ static inline int zperf_upload_fin(int sock,
 	};
 
 	while (ret <= 0 && loop-- > 0) {
-		datagram = (struct zperf_udp_datagram *)sample_packet;
+		datagram = (struct zperf_udp_datagram *)packet;
 
 		/* Fill the packet header */
 		datagram->id = htonl(-nb_packets);
 		datagram->tv_sec = htonl(secs);
 		datagram->tv_usec = htonl(usecs);
 
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
+		hdr = (struct zperf_client_hdr_v1 *)(packet +
 						     sizeof(*datagram));
 
 		/* According to iperf documentation (in include/Settings.hpp),
@@ -83,13 +85,13 @@ static inline int zperf_upload_fin(int sock,
 		hdr->flags = 0;
 		hdr->num_of_threads = htonl(1);
 		hdr->port = 0;
-		hdr->buffer_len = sizeof(sample_packet) -
+		hdr->buffer_len = sizeof(sample_packet[0]) -
 			sizeof(*datagram) - sizeof(*hdr);
 		hdr->bandwidth = 0;
 		hdr->num_of_bytes = htonl(packet_size);
 
 		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		ret = zsock_send(sock, packet, packet_size, 0);
 		if (ret < 0) {
 			NET_ERR("Failed to send the packet (%d)", errno);
 			continue;
@@ -131,37 +133,30 @@ static inline int zperf_upload_fin(int sock,
 	return 0;
 }
 
-static int udp_upload(int sock, int port,
-		      unsigned int duration_in_ms,
-		      unsigned int packet_size,
-		      unsigned int rate_in_kbps,
-		      struct zperf_results *results)
+static void udp_stream_upload(struct zperf_stream *stream)
 {
-	uint32_t packet_duration = zperf_packet_duration(packet_size, rate_in_kbps);
-	uint64_t duration = sys_clock_timeout_end_calc(K_MSEC(duration_in_ms));
+	const struct zperf_upload_params *param = stream->param;
+	int num_streams = MAX(param->num_streams, 1);
+	uint8_t *packet = sample_packet[stream->id];
+	/* The rate is shared by the streams */
+	uint32_t packet_duration = num_streams *
+		zperf_packet_duration(stream->packet_size, param->rate_kbps);
 	uint64_t delay = packet_duration;
 	uint32_t nb_packets = 0U;
-	int64_t start_time, end_time;
-	int64_t last_print_time, last_loop_time;
+	int64_t last_loop_time;
 	int64_t remaining;
+	int port = 0;
 	int ret;
 
-	if (packet_size > PACKET_SIZE_MAX) {
-		NET_WARN("Packet size too large! max size: %u",
-			 PACKET_SIZE_MAX);
-		packet_size = PACKET_SIZE_MAX;
-	} else if (packet_size < sizeof(struct zperf_udp_datagram)) {
-		NET_WARN("Packet size set to the min size: %zu",
-			 sizeof(struct zperf_udp_datagram));
-		packet_size = sizeof(struct zperf_udp_datagram);
+	if (param->peer_addr.sa_family == AF_INET) {
+		port = ntohs(net_sin(&param->peer_addr)->sin_port);
+	} else {
+		port = ntohs(net_sin6(&param->peer_addr)->sin6_port);
 	}
 
-	/* Start the loop */
-	start_time = k_uptime_ticks();
-	last_print_time = start_time;
-	last_loop_time = start_time;
+	last_loop_time = k_uptime_ticks();
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+	(void)memset(packet, 'z', sizeof(sample_packet[0]));
 
 	do {
 		struct zperf_udp_datagram *datagram;
@@ -198,45 +193,48 @@ static int udp_upload(int sock, int port,
 		usecs = k_ticks_to_us_ceil32(loop_time) - secs * USEC_PER_SEC;
 
 		/* Fill the packet header */
-		datagram = (struct zperf_udp_datagram *)sample_packet;
+		datagram = (struct zperf_udp_datagram *)packet;
 
 		datagram->id = htonl(nb_packets);
 		datagram->tv_sec = htonl(secs);
 		datagram->tv_usec = htonl(usecs);
 
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
+		hdr = (struct zperf_client_hdr_v1 *)(packet +
 						     sizeof(*datagram));
 		hdr->flags = 0;
-		hdr->num_of_threads = htonl(1);
+		hdr->num_of_threads = htonl(num_streams);
 		hdr->port = htonl(port);
-		hdr->buffer_len = sizeof(sample_packet) -
+		hdr->buffer_len = sizeof(sample_packet[0]) -
 			sizeof(*datagram) - sizeof(*hdr);
-		hdr->bandwidth = htonl(rate_in_kbps);
-		hdr->num_of_bytes = htonl(packet_size);
+		hdr->bandwidth = htonl(param->rate_kbps);
+		hdr->num_of_bytes = htonl(stream->packet_size);
 
 		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		ret = zsock_send(stream->sock, packet, stream->packet_size, 0);
 		if (ret < 0) {
 			NET_ERR("Failed to send the packet (%d)", errno);
-			return -errno;
-		} else {
-			nb_packets++;
+			stream->ret = -errno;
+			return;
 		}
 
+		nb_packets++;
+		atomic_inc(&stream->nb_packets);
+		atomic_add(&stream->total_len, stream->packet_size);
+
 		if (IS_ENABLED(CONFIG_NET_ZPERF_LOG_LEVEL_DBG)) {
 			int64_t print_interval = sys_clock_timeout_end_calc(K_SECONDS(1));
 			/* Print log every seconds */
 			int64_t print_info = print_interval - k_uptime_ticks();
 
 			if (print_info <= 0) {
-				NET_DBG("nb_packets=%u\tdelay=%u\tadjust=%d",
-					nb_packets, (unsigned int)delay,
-					(int)adjust);
+				NET_DBG("stream=%d\tnb_packets=%u\tdelay=%u\tadjust=%d",
+					stream->id, nb_packets,
+					(unsigned int)delay, (int)adjust);
 				print_interval = sys_clock_timeout_end_calc(K_SECONDS(1));
 			}
 		}
 
-		remaining = duration - k_uptime_ticks();
+		remaining = stream->end_time - k_uptime_ticks();
 
 		/* Wait */
 #if defined(CONFIG_ARCH_POSIX)
@@ -251,57 +249,138 @@ static int udp_upload(int sock, int port,
 		}
 #endif
 	} while (remaining > 0);
+}
+
+static int udp_upload_streams(const struct zperf_upload_params *param,
+			      struct zperf_report *report,
+			      struct zperf_results *result)
+{
+	struct zperf_stream streams[ZPERF_MAX_STREAMS];
+	int num_socks = MAX(param->num_streams, 1);
+	uint32_t packet_size = param->packet_size;
+	int64_t start_time, end_time;
+	uint32_t nb_packets = 0U;
+	int ret = 0;
+	int i;
+
+	if (param->peer_addr.sa_family != AF_INET &&
+	    param->peer_addr.sa_family != AF_INET6) {
+		NET_ERR("Invalid address family (%d)",
+			param->peer_addr.sa_family);
+		return -EINVAL;
+	}
+
+	if (num_socks > ZPERF_MAX_STREAMS) {
+		NET_ERR("Too many streams (%d), max %d", num_socks,
+			ZPERF_MAX_STREAMS);
+		return -EINVAL;
+	}
+
+	if (packet_size > PACKET_SIZE_MAX) {
+		NET_WARN("Packet size too large! max size: %u",
+			 PACKET_SIZE_MAX);
+		packet_size = PACKET_SIZE_MAX;
+	} else if (packet_size < sizeof(struct zperf_udp_datagram)) {
+		NET_WARN("Packet size set to the min size: %zu",
+			 sizeof(struct zperf_udp_datagram));
+		packet_size = sizeof(struct zperf_udp_datagram);
+	}
+
+	for (i = 0; i < num_socks; i++) {
+		int sock;
+
+		sock = zperf_prepare_upload_sock(&param->peer_addr,
+						 param->options.tos,
+						 IPPROTO_UDP);
+		if (sock < 0) {
+			ret = sock;
+			goto out;
+		}
+
+		memset(&streams[i], 0, sizeof(streams[i]));
+		streams[i].sock = sock;
+	}
+
+	memset(result, 0, sizeof(*result));
+
+	start_time = k_uptime_ticks();
+
+	for (i = 0; i < num_socks; i++) {
+		streams[i].func = udp_stream_upload;
+		streams[i].param = param;
+		streams[i].end_time = start_time +
+			k_ms_to_ticks_ceil64(param->duration_ms);
+		streams[i].packet_size = packet_size;
+		streams[i].id = i;
+	}
+
+	zperf_streams_run(streams, num_socks, report);
 
 	end_time = k_uptime_ticks();
 
-	ret = zperf_upload_fin(sock, nb_packets, end_time, packet_size,
-			       results);
-	if (ret < 0) {
-		return ret;
+	for (i = 0; i < num_socks; i++) {
+		nb_packets += (uint32_t)atomic_get(&streams[i].nb_packets);
+
+		if (ret == 0) {
+			ret = streams[i].ret;
+		}
+	}
+
+	/* Each stream is a separate session on the server, so collect
+	 * the statistics of every stream and merge them.
+	 */
+	for (i = 0; i < num_socks && ret == 0; i++) {
+		struct zperf_results stream_results = { 0 };
+		uint32_t stream_packets =
+			(uint32_t)atomic_get(&streams[i].nb_packets);
+
+		ret = zperf_upload_fin(streams[i].sock, sample_packet[i],
+				       stream_packets, end_time, packet_size,
+				       &stream_results);
+		if (ret < 0) {
+			break;
+		}
+
+		result->nb_packets_rcvd += stream_results.nb_packets_rcvd;
+		result->nb_packets_lost += stream_results.nb_packets_lost;
+		result->nb_packets_outorder +=
+			stream_results.nb_packets_outorder;
+		result->total_len += stream_results.total_len;
+		result->time_in_us = MAX(result->time_in_us,
+					 stream_results.time_in_us);
+		result->jitter_in_us = MAX(result->jitter_in_us,
+					   stream_results.jitter_in_us);
 	}
 
 	/* Add result coming from the client */
-	results->nb_packets_sent = nb_packets;
-	results->client_time_in_us =
+	result->nb_packets_sent = nb_packets;
+	result->client_time_in_us =
 				k_ticks_to_us_ceil32(end_time - start_time);
-	results->packet_size = packet_size;
+	result->packet_size = packet_size;
 
-	return 0;
+	/* All the sockets are open */
+	i = num_socks;
+
+out:
+	while (i-- > 0) {
+		zsock_close(streams[i].sock);
+	}
+
+	return ret;
 }
 
 int zperf_udp_upload(const struct zperf_upload_params *param,
 		     struct zperf_results *result)
 {
-	int port = 0;
-	int sock;
-	int ret;
+	struct zperf_report report;
 
 	if (param == NULL || result == NULL) {
 		return -EINVAL;
 	}
 
-	if (param->peer_addr.sa_family == AF_INET) {
-		port = ntohs(net_sin(&param->peer_addr)->sin_port);
-	} else if (param->peer_addr.sa_family == AF_INET6) {
-		port = ntohs(net_sin6(&param->peer_addr)->sin6_port);
-	} else {
-		NET_ERR("Invalid address family (%d)",
-			param->peer_addr.sa_family);
-		return -EINVAL;
-	}
-
-	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
-					 IPPROTO_UDP);
-	if (sock < 0) {
-		return sock;
-	}
-
-	ret = udp_upload(sock, port, param->duration_ms, param->packet_size,
-			 param->rate_kbps, result);
-
-	zsock_close(sock);
+	zperf_report_init(&report, 0, NULL, NULL, 0);
 
-	return ret;
+	return udp_upload_streams(param, &report, result);
 }
 
 static void udp_upload_async_work(struct k_work *work)
@@ -309,12 +388,17 @@ static void udp_upload_async_work(struct k_work *work)
 	struct zperf_async_upload_context *upload_ctx =
 		&udp_async_upload_ctx;
 	struct zperf_results result;
+	struct zperf_report report;
 	int ret;
 
 	upload_ctx->callback(ZPERF_SESSION_STARTED, NULL,
 			     upload_ctx->user_data);
 
-	ret = zperf_udp_upload(&upload_ctx->param, &result);
+	zperf_report_init(&report, upload_ctx->param.report_interval_ms,
+			  upload_ctx->callback, upload_ctx->user_data,
+			  k_uptime_ticks());
+
+	ret = udp_upload_streams(&upload_ctx->param, &report, &result);
 	if (ret < 0) {
 		upload_ctx->callback(ZPERF_SESSION_ERROR, NULL,
 				     upload_ctx->user_data);
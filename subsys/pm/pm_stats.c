@@ -10,6 +10,7 @@
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
 #include <zephyr/stats/stats.h>
+#include <zephyr/stats/metrics.h>
 #include <zephyr/sys/printk.h>
 
 STATS_SECT_START(pm_stats)
@@ -31,6 +32,29 @@ static char names[CONFIG_MP_MAX_NUM_CPUS][PM_STATE_COUNT][PM_STAT_NAME_LEN];
 static uint32_t time_start[CONFIG_MP_MAX_NUM_CPUS];
 static uint32_t time_stop[CONFIG_MP_MAX_NUM_CPUS];
 
+#ifdef CONFIG_PM_STATS_METRICS
+#define PM_RESIDENCY_DEFINE(_state)						\
+	METRIC_HISTOGRAM_DEFINE_LABELED(pm_residency_##_state,			\
+					pm_state_residency_us,			\
+					"state=\"" #_state "\"",			\
+					"Time spent in the power state",	\
+					100, 1000, 10000, 100000, 1000000, 10000000)
+
+PM_RESIDENCY_DEFINE(runtime_idle);
+PM_RESIDENCY_DEFINE(suspend_to_idle);
+PM_RESIDENCY_DEFINE(standby);
+PM_RESIDENCY_DEFINE(suspend_to_ram);
+PM_RESIDENCY_DEFINE(suspend_to_disk);
+
+static const struct metric *const residency[PM_STATE_COUNT] = {
+	[PM_STATE_RUNTIME_IDLE] = &pm_residency_runtime_idle,
+	[PM_STATE_SUSPEND_TO_IDLE] = &pm_residency_suspend_to_idle,
+	[PM_STATE_STANDBY] = &pm_residency_standby,
+	[PM_STATE_SUSPEND_TO_RAM] = &pm_residency_suspend_to_ram,
+	[PM_STATE_SUSPEND_TO_DISK] = &pm_residency_suspend_to_disk,
+};
+#endif
+
 static int pm_stats_init(void)
 {
 
@@ -69,4 +93,11 @@ void pm_stats_update(enum pm_state state)
 	STATS_INC(stats[cpu][state], state_count);
 	STATS_INCN(stats[cpu][state], state_total_cycles, time_total);
 	STATS_SET(stats[cpu][state], state_last_cycles, time_total);
+
+#ifdef CONFIG_PM_STATS_METRICS
+	if (residency[state] != NULL) {
+		metric_histogram_observe(residency[state],
+					 k_cyc_to_us_floor32(time_total));
+	}
+#endif
 }
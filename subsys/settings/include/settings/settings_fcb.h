@@ -20,6 +20,14 @@ struct settings_fcb {
 	struct fcb cf_fcb;
 };
 
+/* Names of the marker records written around the records of a transaction.
+ * They are written as deletion records, so they are never loaded.
+ */
+#define SETTINGS_FCB_TXN_PREFIX		"\x7ftxn/"
+#define SETTINGS_FCB_TXN_BEGIN		SETTINGS_FCB_TXN_PREFIX "begin"
+#define SETTINGS_FCB_TXN_COMMIT		SETTINGS_FCB_TXN_PREFIX "commit"
+#define SETTINGS_FCB_TXN_ABORT		SETTINGS_FCB_TXN_PREFIX "abort"
+
 extern int settings_fcb_src(struct settings_fcb *cf);
 extern int settings_fcb_dst(struct settings_fcb *cf);
 void settings_mount_fcb_backend(struct settings_fcb *cf);
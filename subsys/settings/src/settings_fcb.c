@@ -8,6 +8,7 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <zephyr/fs/fcb.h>
+#include <zephyr/sys/crc.h>
 #include <string.h>
 
 #include <zephyr/settings/settings.h>
@@ -32,11 +33,22 @@ static int settings_fcb_load(struct settings_store *cs,
 static int settings_fcb_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
 static void *settings_fcb_storage_get(struct settings_store *cs);
+static void settings_fcb_index_reset(struct settings_fcb *cf);
+static void settings_fcb_txn_reset(void);
+static void settings_fcb_txn_check(struct settings_fcb *cf);
+#ifdef CONFIG_SETTINGS_TRANSACTION
+static int settings_fcb_save_batch(struct settings_store *cs,
+				   const struct settings_batch_entry *entries,
+				   size_t cnt);
+#endif
 
 static const struct settings_store_itf settings_fcb_itf = {
 	.csi_load = settings_fcb_load,
 	.csi_save = settings_fcb_save,
-	.csi_storage_get = settings_fcb_storage_get
+	.csi_storage_get = settings_fcb_storage_get,
+#ifdef CONFIG_SETTINGS_TRANSACTION
+	.csi_save_batch = settings_fcb_save_batch,
+#endif
 };
 
 /**
@@ -89,6 +101,9 @@ int settings_fcb_src(struct settings_fcb *cf)
 	cf->cf_store.cs_itf = &settings_fcb_itf;
 	settings_src_register(&cf->cf_store);
 
+	settings_fcb_index_reset(cf);
+	settings_fcb_txn_reset();
+
 	return 0;
 }
 
@@ -143,6 +158,249 @@ static int read_entry_len(const struct fcb_entry_ctx *entry_ctx, off_t off)
 	return entry_ctx->loc.fe_data_len - off;
 }
 
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_SETTINGS_FCB_INDEX_SIZE),
+	     "Index size must be a power of two");
+
+/* Location of the newest record of a name, deletion records included so
+ * that older records of a deleted name are not seen.
+ */
+struct settings_fcb_index_entry {
+	struct fcb_entry loc; /* loc.fe_sector is NULL for a free entry */
+	uint32_t name_hash;
+	uint16_t root_hash; /* hash of the first name component */
+};
+
+enum settings_fcb_index_state {
+	INDEX_NOT_BUILT,
+	INDEX_VALID,
+	/* More names than entries, the FCB is scanned instead */
+	INDEX_OVERFLOW,
+};
+
+/* The index covers one backend, the one most recently registered as source */
+static struct {
+	struct settings_fcb *cf;
+	enum settings_fcb_index_state state;
+	struct settings_fcb_index_entry entries[CONFIG_SETTINGS_FCB_INDEX_SIZE];
+} settings_fcb_index;
+
+#define INDEX_MASK (CONFIG_SETTINGS_FCB_INDEX_SIZE - 1)
+
+static uint32_t index_name_hash(const char *name, size_t name_len)
+{
+	return crc32_ieee((const uint8_t *)name, name_len);
+}
+
+static uint16_t index_root_hash(const char *name)
+{
+	const char *sep = strchr(name, SETTINGS_NAME_SEPARATOR);
+	size_t len = (sep != NULL) ? (size_t)(sep - name) : strlen(name);
+
+	return crc16_ccitt(0xffff, (const uint8_t *)name, len);
+}
+
+static void settings_fcb_index_reset(struct settings_fcb *cf)
+{
+	settings_fcb_index.cf = cf;
+	settings_fcb_index.state = INDEX_NOT_BUILT;
+	memset(settings_fcb_index.entries, 0,
+	       sizeof(settings_fcb_index.entries));
+}
+
+/* Find the entry of a name, or the free entry where it belongs. Returns NULL
+ * if the name is not indexed and the index is full.
+ */
+static struct settings_fcb_index_entry *index_lookup(struct settings_fcb *cf,
+						     const char *name,
+						     size_t name_len,
+						     uint32_t hash)
+{
+	struct settings_fcb_index_entry *entry;
+	struct fcb_entry_ctx entry_ctx = { .fap = cf->cf_fcb.fap };
+	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name2_len;
+
+	for (uint32_t i = 0; i < CONFIG_SETTINGS_FCB_INDEX_SIZE; i++) {
+		entry = &settings_fcb_index.entries[(hash + i) & INDEX_MASK];
+
+		if (entry->loc.fe_sector == NULL) {
+			return entry;
+		}
+
+		if (entry->name_hash != hash) {
+			continue;
+		}
+
+		entry_ctx.loc = entry->loc;
+		if ((settings_line_name_read(name2, sizeof(name2), &name2_len,
+					     &entry_ctx) == 0) &&
+		    (name2_len == name_len) && !memcmp(name, name2, name_len)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void index_remove(struct settings_fcb_index_entry *entry)
+{
+	uint32_t hole = entry - settings_fcb_index.entries;
+	uint32_t i = hole;
+	uint32_t home;
+
+	/* Shift back the following entries of the probe sequence, so that no
+	 * lookup stops at the freed entry before reaching them.
+	 */
+	while (true) {
+		i = (i + 1) & INDEX_MASK;
+		entry = &settings_fcb_index.entries[i];
+		if (entry->loc.fe_sector == NULL) {
+			break;
+		}
+
+		home = entry->name_hash & INDEX_MASK;
+		if (((i - home) & INDEX_MASK) >= ((i - hole) & INDEX_MASK)) {
+			settings_fcb_index.entries[hole] = *entry;
+			hole = i;
+		}
+	}
+
+	settings_fcb_index.entries[hole].loc.fe_sector = NULL;
+}
+
+static void index_remove_sector(const struct flash_sector *sector)
+{
+	uint32_t i = 0;
+
+	while (i < CONFIG_SETTINGS_FCB_INDEX_SIZE) {
+		if (settings_fcb_index.entries[i].loc.fe_sector == sector) {
+			/* An entry may be shifted into this one */
+			index_remove(&settings_fcb_index.entries[i]);
+		} else {
+			i++;
+		}
+	}
+}
+
+/* Record the newest location of a name. */
+static int index_update(struct settings_fcb *cf, const char *name,
+			size_t name_len, const struct fcb_entry *loc)
+{
+	uint32_t hash = index_name_hash(name, name_len);
+	struct settings_fcb_index_entry *entry;
+
+	entry = index_lookup(cf, name, name_len, hash);
+	if (entry == NULL) {
+		LOG_WRN("Settings index full, scanning FCB instead");
+		settings_fcb_index.state = INDEX_OVERFLOW;
+		return -ENOMEM;
+	}
+
+	entry->loc = *loc;
+	entry->name_hash = hash;
+	entry->root_hash = index_root_hash(name);
+
+	return 0;
+}
+
+/* Build the index with a single pass over the FCB, newer records of a name
+ * replacing older ones.
+ */
+static void index_build(struct settings_fcb *cf)
+{
+	struct fcb_entry_ctx entry_ctx = {
+		{.fe_sector = NULL, .fe_elem_off = 0},
+		.fap = cf->cf_fcb.fap
+	};
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+
+	settings_fcb_index.state = INDEX_VALID;
+
+	while (fcb_getnext(&cf->cf_fcb, &entry_ctx.loc) == 0) {
+		if (settings_line_name_read(name, sizeof(name), &name_len,
+					    &entry_ctx)) {
+			continue;
+		}
+		name[name_len] = '\0';
+
+		if (index_update(cf, name, name_len, &entry_ctx.loc)) {
+			return;
+		}
+	}
+}
+
+/* Returns true if the index of the backend can be used. */
+static bool settings_fcb_index_ready(struct settings_fcb *cf)
+{
+	if (settings_fcb_index.cf != cf) {
+		return false;
+	}
+
+	if (settings_fcb_index.state == INDEX_NOT_BUILT) {
+		index_build(cf);
+	}
+
+	return settings_fcb_index.state == INDEX_VALID;
+}
+
+static bool index_entry_is(const struct settings_fcb_index_entry *entry,
+			   const struct fcb_entry *loc)
+{
+	return (entry != NULL) && (entry->loc.fe_sector == loc->fe_sector) &&
+	       (entry->loc.fe_elem_off == loc->fe_elem_off);
+}
+
+static int settings_fcb_index_load(struct settings_fcb *cf, line_load_cb cb,
+				   void *cb_arg, const char *subtree)
+{
+	struct fcb_entry_ctx entry_ctx = { .fap = cf->cf_fcb.fap };
+	uint16_t root_hash = (subtree != NULL) ? index_root_hash(subtree) : 0;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+
+	for (uint32_t i = 0; i < CONFIG_SETTINGS_FCB_INDEX_SIZE; i++) {
+		const struct settings_fcb_index_entry *entry =
+			&settings_fcb_index.entries[i];
+
+		if ((entry->loc.fe_sector == NULL) ||
+		    ((subtree != NULL) && (entry->root_hash != root_hash))) {
+			continue;
+		}
+
+		entry_ctx.loc = entry->loc;
+		if (settings_line_name_read(name, sizeof(name), &name_len,
+					    &entry_ctx)) {
+			LOG_ERR("Failed to load line name");
+			continue;
+		}
+		name[name_len] = '\0';
+
+		/* Skip deletion records */
+		if (!read_entry_len(&entry_ctx, name_len + 1)) {
+			continue;
+		}
+
+		cb(name, &entry_ctx, name_len + 1, cb_arg);
+	}
+
+	return 0;
+}
+#else
+static inline void settings_fcb_index_reset(struct settings_fcb *cf)
+{
+	ARG_UNUSED(cf);
+}
+
+static inline bool settings_fcb_index_ready(struct settings_fcb *cf)
+{
+	ARG_UNUSED(cf);
+
+	return false;
+}
+#endif /* CONFIG_SETTINGS_FCB_INDEX */
+
 static int settings_fcb_load_priv(struct settings_store *cs,
 				  line_load_cb cb,
 				  void *cb_arg,
@@ -189,6 +447,17 @@ static int settings_fcb_load_priv(struct settings_store *cs,
 static int settings_fcb_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg)
 {
+	struct settings_fcb *cf = CONTAINER_OF(cs, struct settings_fcb, cf_store);
+
+	settings_fcb_txn_check(cf);
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	if (settings_fcb_index_ready(cf)) {
+		return settings_fcb_index_load(cf, settings_line_load_cb,
+					       (void *)arg, arg->subtree);
+	}
+#endif
+
 	return settings_fcb_load_priv(
 		cs,
 		settings_line_load_cb,
@@ -249,17 +518,36 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 			continue;
 		}
 
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+		struct settings_fcb_index_entry *entry = NULL;
+
+		if (settings_fcb_index_ready(cf)) {
+			entry = index_lookup(cf, name1, val1_off,
+					     index_name_hash(name1, val1_off));
+			if (!index_entry_is(entry, &loc1.loc)) {
+				/* A newer record exists */
+				continue;
+			}
+		}
+#endif
+
 		if (val1_off + 1 == loc1.loc.fe_data_len) {
 			/* Lack of a value so the record is a deletion-record */
 			/* No sense to copy empty entry from */
 			/* the oldest sector */
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+			if (entry != NULL) {
+				index_remove(entry);
+			}
+#endif
 			continue;
 		}
 
 		loc2 = loc1;
 		copy = 1;
 
-		while (fcb_getnext(&cf->cf_fcb, &loc2.loc) == 0) {
+		while (!settings_fcb_index_ready(cf) &&
+		       (fcb_getnext(&cf->cf_fcb, &loc2.loc) == 0)) {
 			size_t val2_off;
 
 			rc = settings_line_name_read(name2, sizeof(name2),
@@ -295,8 +583,23 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 
 		if (rc != 0) {
 			LOG_ERR("Failed to finish fcb_append (%d)", rc);
+			continue;
+		}
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+		if (entry != NULL) {
+			entry->loc = loc2.loc;
 		}
+#endif
+	}
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	if (settings_fcb_index_ready(cf)) {
+		/* Forget the records which could not be copied */
+		index_remove_sector(cf->cf_fcb.f_oldest);
 	}
+#endif
+
 	rc = fcb_rotate(&cf->cf_fcb);
 
 	if (rc != 0) {
@@ -322,7 +625,8 @@ static int write_handler(void *ctx, off_t off, char const *buf, size_t len)
 
 /* ::csi_save implementation */
 static int settings_fcb_save_priv(struct settings_store *cs, const char *name,
-				  const char *value, size_t val_len)
+				  const char *value, size_t val_len,
+				  struct fcb_entry_ctx *out_loc)
 {
 	struct settings_fcb *cf = CONTAINER_OF(cs, struct settings_fcb, cf_store);
 	struct fcb_entry_ctx loc;
@@ -361,30 +665,504 @@ static int settings_fcb_save_priv(struct settings_store *cs, const char *name,
 			rc = i;
 		}
 	}
+
+	*out_loc = loc;
+
+	return rc;
+}
+
+/* Find the newest record of a name, deletion records included. */
+static int settings_fcb_find(struct settings_fcb *cf, const char *name,
+			     struct fcb_entry_ctx *found)
+{
+	struct fcb_entry_ctx entry_ctx = {
+		{.fe_sector = NULL, .fe_elem_off = 0},
+		.fap = cf->cf_fcb.fap
+	};
+	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len = strlen(name);
+	size_t name2_len;
+	int rc = -ENOENT;
+
+	found->fap = cf->cf_fcb.fap;
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	if (settings_fcb_index_ready(cf)) {
+		struct settings_fcb_index_entry *entry;
+
+		entry = index_lookup(cf, name, name_len,
+				     index_name_hash(name, name_len));
+		if ((entry == NULL) || (entry->loc.fe_sector == NULL)) {
+			return -ENOENT;
+		}
+
+		found->loc = entry->loc;
+		return 0;
+	}
+#endif
+
+	while (fcb_getnext(&cf->cf_fcb, &entry_ctx.loc) == 0) {
+		if (settings_line_name_read(name2, sizeof(name2), &name2_len,
+					    &entry_ctx)) {
+			continue;
+		}
+
+		if ((name2_len == name_len) && !memcmp(name, name2, name_len)) {
+			found->loc = entry_ctx.loc;
+			rc = 0;
+		}
+	}
+
+	return rc;
+}
+
+/* Check if the newest record of a name, if any, holds the same value. */
+static bool settings_fcb_is_dup(const char *name, const char *value,
+				size_t val_len, struct fcb_entry_ctx *found)
+{
+	struct settings_line_dup_check_arg cdca = {
+		.name = name,
+		.val = value,
+		.val_len = val_len,
+		.is_dup = 0,
+	};
+
+	if (found == NULL) {
+		/* Nothing to delete */
+		return val_len == 0;
+	}
+
+	settings_line_dup_check_cb(name, found, strlen(name) + 1, &cdca);
+
+	return cdca.is_dup == 1;
+}
+
+static int settings_fcb_save_record(struct settings_fcb *cf, const char *name,
+				    const char *value, size_t val_len)
+{
+	struct fcb_entry_ctx loc;
+	int rc;
+
+	rc = settings_fcb_save_priv(&cf->cf_store, name, value, val_len, &loc);
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	/* The index may have overflowed while compressing */
+	if ((rc == 0) && settings_fcb_index_ready(cf)) {
+		(void)index_update(cf, name, strlen(name), &loc.loc);
+	}
+#endif
+
+	return rc;
+}
+
+#ifdef CONFIG_SETTINGS_TRANSACTION
+/*
+ * The records of a batch are written between a begin and a commit marker.
+ * Before the begin marker is written, room is made for the batch and, should
+ * it be interrupted, for the records restoring the previous values of its
+ * keys followed by an abort marker. The FCB is then never compressed while a
+ * batch is incomplete, and an incomplete batch can always be rolled back. This
+ * is done at first use of the FCB.
+ */
+
+#define TXN_MAX_KEYS CONFIG_SETTINGS_TRANSACTION_MAX_KEYS
+
+/* FCB checked for an incomplete batch */
+static struct settings_fcb *settings_fcb_txn_checked;
+
+static void settings_fcb_txn_reset(void)
+{
+	settings_fcb_txn_checked = NULL;
+}
+
+static bool txn_is_marker(const char *name, size_t name_len)
+{
+	return (name_len >= sizeof(SETTINGS_FCB_TXN_PREFIX) - 1) &&
+	       !memcmp(name, SETTINGS_FCB_TXN_PREFIX,
+		       sizeof(SETTINGS_FCB_TXN_PREFIX) - 1);
+}
+
+static bool txn_name_is(const char *name, size_t name_len, const char *marker)
+{
+	return (name_len == strlen(marker)) && !memcmp(name, marker, name_len);
+}
+
+/* Find the begin marker of a batch without commit or abort marker */
+static int txn_open_find(struct settings_fcb *cf, struct fcb_entry *begin)
+{
+	struct fcb_entry_ctx entry_ctx = {
+		{.fe_sector = NULL, .fe_elem_off = 0},
+		.fap = cf->cf_fcb.fap
+	};
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+
+	begin->fe_sector = NULL;
+
+	while (fcb_getnext(&cf->cf_fcb, &entry_ctx.loc) == 0) {
+		if (settings_line_name_read(name, sizeof(name), &name_len,
+					    &entry_ctx) ||
+		    !txn_is_marker(name, name_len)) {
+			continue;
+		}
+
+		if (txn_name_is(name, name_len, SETTINGS_FCB_TXN_BEGIN)) {
+			*begin = entry_ctx.loc;
+		} else {
+			begin->fe_sector = NULL;
+		}
+	}
+
+	return (begin->fe_sector != NULL) ? 0 : -ENOENT;
+}
+
+/* Find the newest record of a name after from, or from the start of the FCB
+ * if from is NULL, and before to, or up to the end of the FCB if to is NULL.
+ */
+static int txn_find_between(struct settings_fcb *cf, const char *name,
+			    size_t name_len, const struct fcb_entry *from,
+			    const struct fcb_entry *to,
+			    struct fcb_entry_ctx *found)
+{
+	struct fcb_entry_ctx entry_ctx = {
+		{.fe_sector = NULL, .fe_elem_off = 0},
+		.fap = cf->cf_fcb.fap
+	};
+	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name2_len;
+	int rc = -ENOENT;
+
+	if (from != NULL) {
+		entry_ctx.loc = *from;
+	}
+
+	while (fcb_getnext(&cf->cf_fcb, &entry_ctx.loc) == 0) {
+		if ((to != NULL) && (entry_ctx.loc.fe_sector == to->fe_sector) &&
+		    (entry_ctx.loc.fe_elem_off == to->fe_elem_off)) {
+			break;
+		}
+
+		if (settings_line_name_read(name2, sizeof(name2), &name2_len,
+					    &entry_ctx)) {
+			continue;
+		}
+
+		if ((name2_len == name_len) && !memcmp(name, name2, name_len)) {
+			*found = entry_ctx;
+			rc = 0;
+		}
+	}
+
+	return rc;
+}
+
+static bool txn_values_equal(struct fcb_entry_ctx *a, struct fcb_entry_ctx *b,
+			     off_t val_off)
+{
+	size_t len = settings_line_val_get_len(val_off, a);
+	char buf_a[16];
+	char buf_b[16];
+	size_t len_a;
+	size_t len_b;
+
+	if (len != settings_line_val_get_len(val_off, b)) {
+		return false;
+	}
+
+	for (size_t off = 0; off < len; off += len_a) {
+		if (settings_line_val_read(val_off, off, buf_a,
+					   MIN(sizeof(buf_a), len - off),
+					   &len_a, a) ||
+		    settings_line_val_read(val_off, off, buf_b, len_a,
+					   &len_b, b) ||
+		    (len_a == 0) || (len_a != len_b) ||
+		    memcmp(buf_a, buf_b, len_a)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int txn_record_copy(struct settings_fcb *cf, struct fcb_entry_ctx *src)
+{
+	struct fcb_entry_ctx dst = { .fap = cf->cf_fcb.fap };
+	int rc;
+
+	rc = fcb_append(&cf->cf_fcb, src->loc.fe_data_len, &dst.loc);
+	if (rc) {
+		return rc;
+	}
+
+	rc = settings_line_entry_copy(&dst, 0, src, 0, src->loc.fe_data_len);
+	if (rc) {
+		return rc;
+	}
+
+	return fcb_append_finish(&cf->cf_fcb, &dst.loc);
+}
+
+/*
+ * Go through the records written after the begin marker of an incomplete
+ * batch, and restore the previous value of their names, unless it was already
+ * restored. With lens set, only get the lengths of the records to write.
+ */
+static int txn_rollback_pass(struct settings_fcb *cf,
+			     const struct fcb_entry *begin, uint16_t *lens,
+			     int *cnt)
+{
+	struct fcb_entry_ctx rec = { .loc = *begin, .fap = cf->cf_fcb.fap };
+	struct fcb_entry_ctx prev;
+	struct fcb_entry_ctx loc;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+	int rc;
+
+	while (fcb_getnext(&cf->cf_fcb, &rec.loc) == 0) {
+		if (settings_line_name_read(name, sizeof(name), &name_len,
+					    &rec) ||
+		    txn_is_marker(name, name_len)) {
+			continue;
+		}
+		name[name_len] = '\0';
+
+		/* Only the newest record of a name matters */
+		if (txn_find_between(cf, name, name_len, &rec.loc, NULL,
+				     &prev) == 0) {
+			continue;
+		}
+
+		rc = txn_find_between(cf, name, name_len, NULL, begin, &prev);
+		if (rc == 0) {
+			if (txn_values_equal(&prev, &rec, name_len + 1)) {
+				continue;
+			}
+		} else if (!read_entry_len(&rec, name_len + 1)) {
+			/* Deleted, and it did not exist before */
+			continue;
+		}
+
+		if (lens != NULL) {
+			if (*cnt == TXN_MAX_KEYS) {
+				return -ENOMEM;
+			}
+
+			lens[(*cnt)++] = (rc == 0) ? prev.loc.fe_data_len :
+				settings_line_len_calc(name, 0);
+			continue;
+		}
+
+		if (rc == 0) {
+			rc = txn_record_copy(cf, &prev);
+		} else {
+			rc = settings_fcb_save_priv(&cf->cf_store, name, NULL, 0,
+						    &loc);
+		}
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+static void settings_fcb_txn_rollback(struct settings_fcb *cf)
+{
+	uint16_t lens[TXN_MAX_KEYS + 1];
+	struct fcb_entry begin;
+	struct fcb_entry_ctx loc;
+	int cnt = 0;
+	int rc;
+
+	if (txn_open_find(cf, &begin)) {
+		return;
+	}
+
+	LOG_WRN("Rolling back incomplete settings transaction");
+
+	rc = txn_rollback_pass(cf, &begin, lens, &cnt);
+	if (rc == 0) {
+		lens[cnt++] = settings_line_len_calc(SETTINGS_FCB_TXN_ABORT, 0);
+
+		/* Room was made when the batch was started */
+		if (!fcb_append_fits(&cf->cf_fcb, lens, cnt)) {
+			rc = -ENOSPC;
+		}
+	}
+
+	if (rc == 0) {
+		rc = txn_rollback_pass(cf, &begin, NULL, NULL);
+	}
+
+	if (rc == 0) {
+		rc = settings_fcb_save_priv(&cf->cf_store,
+					    SETTINGS_FCB_TXN_ABORT, NULL, 0,
+					    &loc);
+	}
+
+	if (rc) {
+		LOG_ERR("Failed to roll back settings transaction (%d)", rc);
+	}
+
+	/* The index may point to rolled back records */
+	settings_fcb_index_reset(cf);
+}
+
+static void settings_fcb_txn_check(struct settings_fcb *cf)
+{
+	if (settings_fcb_txn_checked != cf) {
+		settings_fcb_txn_checked = cf;
+		settings_fcb_txn_rollback(cf);
+	}
+}
+
+/* Make room for records, compressing the FCB if needed */
+static int settings_fcb_reserve(struct settings_fcb *cf, const uint16_t *lens,
+				int cnt)
+{
+	/* FCB can compress up to cf->cf_fcb.f_sector_cnt - 1 times. */
+	for (int i = 0; i < cf->cf_fcb.f_sector_cnt - 1; i++) {
+		if (fcb_append_fits(&cf->cf_fcb, lens, cnt)) {
+			return 0;
+		}
+
+		settings_fcb_compress(cf);
+	}
+
+	return fcb_append_fits(&cf->cf_fcb, lens, cnt) ? 0 : -ENOSPC;
+}
+
+/* ::csi_save_batch implementation */
+static int settings_fcb_save_batch(struct settings_store *cs,
+				   const struct settings_batch_entry *entries,
+				   size_t cnt)
+{
+	struct settings_fcb *cf = CONTAINER_OF(cs, struct settings_fcb, cf_store);
+	/* Begin marker, records, restoring records, commit and abort markers */
+	uint16_t lens[1 + 2 * TXN_MAX_KEYS + 2];
+	bool changed[TXN_MAX_KEYS];
+	struct fcb_entry_ctx found;
+	struct fcb_entry_ctx loc;
+	size_t changed_cnt = 0;
+	size_t last = 0;
+	int rc;
+
+	if (cnt > TXN_MAX_KEYS) {
+		return -EINVAL;
+	}
+
+	settings_fcb_txn_check(cf);
+
+	for (size_t i = 0; i < cnt; i++) {
+		const struct settings_batch_entry *entry = &entries[i];
+
+		if ((entry->name == NULL) ||
+		    ((entry->val_len > 0) && (entry->value == NULL))) {
+			return -EINVAL;
+		}
+
+		rc = settings_fcb_find(cf, entry->name, &found);
+		changed[i] = !settings_fcb_is_dup(entry->name, entry->value,
+						  entry->val_len,
+						  (rc == 0) ? &found : NULL);
+		if (!changed[i]) {
+			continue;
+		}
+
+		lens[1 + changed_cnt] =
+			settings_line_len_calc(entry->name, entry->val_len);
+		lens[1 + TXN_MAX_KEYS + changed_cnt] = (rc == 0) ?
+			found.loc.fe_data_len :
+			settings_line_len_calc(entry->name, 0);
+		changed_cnt++;
+		last = i;
+	}
+
+	if (changed_cnt == 0) {
+		return 0;
+	}
+
+	if (changed_cnt == 1) {
+		/* A single record is written atomically */
+		return settings_fcb_save_record(cf, entries[last].name,
+						entries[last].value,
+						entries[last].val_len);
+	}
+
+	lens[0] = settings_line_len_calc(SETTINGS_FCB_TXN_BEGIN, 0);
+	memmove(&lens[1 + changed_cnt], &lens[1 + TXN_MAX_KEYS],
+		changed_cnt * sizeof(lens[0]));
+	lens[1 + 2 * changed_cnt] =
+		settings_line_len_calc(SETTINGS_FCB_TXN_COMMIT, 0);
+	lens[2 + 2 * changed_cnt] =
+		settings_line_len_calc(SETTINGS_FCB_TXN_ABORT, 0);
+
+	rc = settings_fcb_reserve(cf, lens, 3 + 2 * changed_cnt);
+	if (rc) {
+		return rc;
+	}
+
+	rc = settings_fcb_save_priv(cs, SETTINGS_FCB_TXN_BEGIN, NULL, 0, &loc);
+	if (rc) {
+		return rc;
+	}
+
+	for (size_t i = 0; (rc == 0) && (i < cnt); i++) {
+		if (changed[i]) {
+			rc = settings_fcb_save_record(cf, entries[i].name,
+						      entries[i].value,
+						      entries[i].val_len);
+		}
+	}
+
+	if (rc == 0) {
+		rc = settings_fcb_save_priv(cs, SETTINGS_FCB_TXN_COMMIT, NULL,
+					    0, &loc);
+	}
+
+	if (rc) {
+		settings_fcb_txn_rollback(cf);
+	}
+
 	return rc;
 }
+#else
+static inline void settings_fcb_txn_reset(void)
+{
+}
+
+static inline void settings_fcb_txn_check(struct settings_fcb *cf)
+{
+	ARG_UNUSED(cf);
+}
+#endif /* CONFIG_SETTINGS_TRANSACTION */
 
 static int settings_fcb_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len)
 {
-	struct settings_line_dup_check_arg cdca;
+	struct settings_fcb *cf = CONTAINER_OF(cs, struct settings_fcb, cf_store);
+	struct fcb_entry_ctx found;
 
 	if (val_len > 0 && value == NULL) {
 		return -EINVAL;
 	}
 
+	if (!name) {
+		return -EINVAL;
+	}
+
+	settings_fcb_txn_check(cf);
+
 	/*
 	 * Check if we're writing the same value again.
 	 */
-	cdca.name = name;
-	cdca.val = (char *)value;
-	cdca.is_dup = 0;
-	cdca.val_len = val_len;
-	settings_fcb_load_priv(cs, settings_line_dup_check_cb, &cdca, false);
-	if (cdca.is_dup == 1) {
+	if (settings_fcb_is_dup(name, value, val_len,
+				(settings_fcb_find(cf, name, &found) == 0) ?
+				&found : NULL)) {
 		return 0;
 	}
-	return settings_fcb_save_priv(cs, name, value, val_len);
+
+	return settings_fcb_save_record(cf, name, value, val_len);
 }
 
 void settings_mount_fcb_backend(struct settings_fcb *cf)
@@ -121,6 +121,17 @@ void settings_line_io_init(int (*read_cb)(void *ctx, off_t off, char *buf,
 			  uint8_t io_rwbs);
 
 
+/* Transaction and write-back cache, called with settings_lock held. */
+
+/* Returns true if the saves of the calling thread go to the cache */
+bool settings_txn_caching(void);
+
+int settings_txn_save(struct settings_store *cs, const char *name,
+		      const void *value, size_t val_len);
+
+/* Write the write-back cache, unless a transaction is in progress */
+int settings_txn_write_back(void);
+
 extern sys_slist_t settings_load_srcs;
 extern sys_slist_t settings_handlers;
 extern struct settings_store *settings_save_dst;
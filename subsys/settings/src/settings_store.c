@@ -54,6 +54,9 @@ int settings_load_subtree(const char *subtree)
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+	if (IS_ENABLED(CONFIG_SETTINGS_WRITE_BACK)) {
+		(void)settings_txn_write_back();
+	}
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -81,6 +84,9 @@ int settings_load_subtree_direct(
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+	if (IS_ENABLED(CONFIG_SETTINGS_WRITE_BACK)) {
+		(void)settings_txn_write_back();
+	}
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -103,7 +109,11 @@ int settings_save_one(const char *name, const void *value, size_t val_len)
 
 	k_mutex_lock(&settings_lock, K_FOREVER);
 
-	rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+	if (IS_ENABLED(CONFIG_SETTINGS_TRANSACTION) && settings_txn_caching()) {
+		rc = settings_txn_save(cs, name, value, val_len);
+	} else {
+		rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+	}
 
 	k_mutex_unlock(&settings_lock);
 
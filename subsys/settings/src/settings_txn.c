@@ -0,0 +1,304 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include "settings_priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
+
+extern struct k_mutex settings_lock;
+
+/* Values saved and not written to the backend yet. The name and value of a
+ * key are stored together in buf, a later save of the key reusing the space
+ * of the value when the new one fits. The space is given back when the cache
+ * is written.
+ */
+static struct {
+	struct settings_batch_entry entries[CONFIG_SETTINGS_TRANSACTION_MAX_KEYS];
+	size_t cnt;
+	uint8_t buf[CONFIG_SETTINGS_TRANSACTION_BUF_SIZE];
+	size_t buf_used;
+	/* Thread with a transaction in progress, holding settings_lock */
+	k_tid_t owner;
+} settings_txn;
+
+#ifdef CONFIG_SETTINGS_WRITE_BACK
+static void write_back_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(write_back_work, write_back_handler);
+#endif
+
+static struct settings_batch_entry *txn_find(const char *name)
+{
+	for (size_t i = 0; i < settings_txn.cnt; i++) {
+		if (strcmp(settings_txn.entries[i].name, name) == 0) {
+			return &settings_txn.entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static uint8_t *txn_alloc(size_t len)
+{
+	uint8_t *ptr = &settings_txn.buf[settings_txn.buf_used];
+
+	if (len > sizeof(settings_txn.buf) - settings_txn.buf_used) {
+		return NULL;
+	}
+
+	settings_txn.buf_used += len;
+
+	return ptr;
+}
+
+static int txn_stage(const char *name, const void *value, size_t val_len)
+{
+	struct settings_batch_entry *entry = txn_find(name);
+	size_t name_len;
+	uint8_t *ptr;
+
+	if (entry != NULL) {
+		if ((val_len > 0) && (val_len <= entry->val_len)) {
+			ptr = (uint8_t *)entry->value;
+		} else {
+			ptr = txn_alloc(val_len);
+			if (ptr == NULL) {
+				return -ENOMEM;
+			}
+		}
+	} else {
+		if (settings_txn.cnt == ARRAY_SIZE(settings_txn.entries)) {
+			return -ENOMEM;
+		}
+
+		name_len = strlen(name) + 1;
+		ptr = txn_alloc(name_len + val_len);
+		if (ptr == NULL) {
+			return -ENOMEM;
+		}
+
+		entry = &settings_txn.entries[settings_txn.cnt++];
+		entry->name = memcpy(ptr, name, name_len);
+		ptr += name_len;
+	}
+
+	entry->value = (val_len > 0) ? memcpy(ptr, value, val_len) : NULL;
+	entry->val_len = val_len;
+
+	return 0;
+}
+
+static void txn_drop(void)
+{
+	settings_txn.cnt = 0;
+	settings_txn.buf_used = 0;
+}
+
+static int txn_save_each(struct settings_store *cs)
+{
+	int rc = 0;
+	int rc2;
+
+	if (cs->cs_itf->csi_save_start) {
+		cs->cs_itf->csi_save_start(cs);
+	}
+
+	for (size_t i = 0; i < settings_txn.cnt; i++) {
+		const struct settings_batch_entry *entry =
+			&settings_txn.entries[i];
+
+		rc2 = cs->cs_itf->csi_save(cs, entry->name, entry->value,
+					   entry->val_len);
+		if (!rc) {
+			rc = rc2;
+		}
+	}
+
+	if (cs->cs_itf->csi_save_end) {
+		cs->cs_itf->csi_save_end(cs);
+	}
+
+	return rc;
+}
+
+/* Write the cache to the backend, in a batch if the backend supports it.
+ * Outside of transactions, the values are written one at a time when there
+ * is not enough room for the batch. The values are kept on failure, to be
+ * written again by the next flush.
+ */
+static int txn_flush(struct settings_store *cs)
+{
+	int rc;
+
+	if (settings_txn.cnt == 0) {
+		return 0;
+	}
+
+	if (cs == NULL) {
+		rc = -ENOENT;
+	} else if (cs->cs_itf->csi_save_batch) {
+		rc = cs->cs_itf->csi_save_batch(cs, settings_txn.entries,
+						settings_txn.cnt);
+		if ((rc == -ENOSPC) && (settings_txn.owner == NULL)) {
+			rc = txn_save_each(cs);
+		}
+	} else {
+		rc = txn_save_each(cs);
+	}
+
+	if (rc == 0) {
+		txn_drop();
+	}
+
+	return rc;
+}
+
+bool settings_txn_caching(void)
+{
+	return IS_ENABLED(CONFIG_SETTINGS_WRITE_BACK) ||
+	       (settings_txn.owner == k_current_get());
+}
+
+int settings_txn_save(struct settings_store *cs, const char *name,
+		      const void *value, size_t val_len)
+{
+	int rc;
+
+	if (name == NULL) {
+		return -EINVAL;
+	}
+
+	rc = txn_stage(name, value, val_len);
+	if (settings_txn.owner != NULL) {
+		return rc;
+	}
+
+#ifdef CONFIG_SETTINGS_WRITE_BACK
+	if (rc == -ENOMEM) {
+		/* Make room, or write a value too large for the cache */
+		rc = txn_flush(cs);
+		if (rc == 0) {
+			rc = txn_stage(name, value, val_len);
+		}
+		if (rc == -ENOMEM) {
+			return cs->cs_itf->csi_save(cs, name, value, val_len);
+		}
+	}
+
+	if (rc == 0) {
+		(void)k_work_schedule(&write_back_work,
+				      K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY));
+	}
+#endif /* CONFIG_SETTINGS_WRITE_BACK */
+
+	return rc;
+}
+
+int settings_txn_write_back(void)
+{
+	if (settings_txn.owner != NULL) {
+		return 0;
+	}
+
+	return txn_flush(settings_save_dst);
+}
+
+#ifdef CONFIG_SETTINGS_WRITE_BACK
+static void write_back_handler(struct k_work *work)
+{
+	int rc;
+
+	if (k_mutex_lock(&settings_lock, K_NO_WAIT) != 0) {
+		/* Do not block the work queue during a transaction */
+		(void)k_work_reschedule(k_work_delayable_from_work(work),
+					K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY));
+		return;
+	}
+
+	rc = settings_txn_write_back();
+	if (rc != 0) {
+		LOG_ERR("Failed to write back settings (%d)", rc);
+		(void)k_work_reschedule(k_work_delayable_from_work(work),
+					K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY));
+	}
+
+	k_mutex_unlock(&settings_lock);
+}
+#endif /* CONFIG_SETTINGS_WRITE_BACK */
+
+int settings_transaction_begin(void)
+{
+	int rc;
+
+	if (settings_save_dst == NULL) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (settings_txn.owner == k_current_get()) {
+		k_mutex_unlock(&settings_lock);
+		return -EALREADY;
+	}
+
+	/* Keep the values cached before out of the transaction */
+	rc = txn_flush(settings_save_dst);
+	if (rc != 0) {
+		k_mutex_unlock(&settings_lock);
+		return rc;
+	}
+
+	/* settings_lock is held until the end of the transaction */
+	settings_txn.owner = k_current_get();
+
+	return 0;
+}
+
+int settings_transaction_commit(void)
+{
+	int rc;
+
+	if (settings_txn.owner != k_current_get()) {
+		return -EINVAL;
+	}
+
+	/* A transaction which failed is not written again later */
+	rc = txn_flush(settings_save_dst);
+	txn_drop();
+	settings_txn.owner = NULL;
+
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+
+int settings_transaction_abort(void)
+{
+	if (settings_txn.owner != k_current_get()) {
+		return -EINVAL;
+	}
+
+	txn_drop();
+	settings_txn.owner = NULL;
+
+	k_mutex_unlock(&settings_lock);
+
+	return 0;
+}
+
+int settings_flush(void)
+{
+	int rc;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	rc = settings_txn_write_back();
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
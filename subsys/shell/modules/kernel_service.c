@@ -22,6 +22,10 @@
 #if defined(CONFIG_LOG_RUNTIME_FILTERING)
 #include <zephyr/logging/log_ctrl.h>
 #endif
+#if defined(CONFIG_LATENCY_HISTOGRAMS)
+#include <zephyr/kernel/latency.h>
+#include <zephyr/timing/timing.h>
+#endif
 
 #if defined(CONFIG_THREAD_MAX_NAME_LEN)
 #define THREAD_MAX_NAM_LEN CONFIG_THREAD_MAX_NAME_LEN
@@ -326,6 +330,113 @@ static int cmd_kernel_log_level_set(const struct shell *sh,
 }
 #endif
 
+#if defined(CONFIG_LATENCY_HISTOGRAMS)
+static void latency_print(const struct shell *sh, const char *name,
+			  const struct k_latency_histogram *hist)
+{
+	if (hist->count == 0U) {
+		return;
+	}
+
+	shell_print(sh, "%s: count %u, max %llu ns", name, hist->count,
+		    timing_cycles_to_ns(hist->max));
+
+	for (unsigned int i = 0; i < K_LATENCY_HISTOGRAM_BUCKETS; i++) {
+		if (hist->buckets[i] != 0U) {
+			shell_print(sh, "\t>= %llu ns: %u",
+				    timing_cycles_to_ns(k_latency_bucket_start(i)),
+				    hist->buckets[i]);
+		}
+	}
+}
+
+#if defined(CONFIG_SCHED_LATENCY_HISTOGRAM) && defined(CONFIG_THREAD_MONITOR)
+static void thread_latency_print(const struct k_thread *thread, void *user_data)
+{
+	struct k_latency_histogram hist;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+
+	if (k_thread_sched_latency_get((k_tid_t)thread, &hist) == 0) {
+		latency_print(user_data, (name != NULL) ? name : "NA", &hist);
+	}
+}
+#endif
+
+#if defined(CONFIG_ISR_LATENCY_HISTOGRAMS)
+static void isr_latency_print(const void *isr,
+			      const struct k_latency_histogram *hist,
+			      void *user_data)
+{
+	char name[sizeof("isr 0x") + 2 * sizeof(void *)];
+
+	snprintk(name, sizeof(name), "isr %p", isr);
+	latency_print(user_data, name, hist);
+}
+#endif
+
+static int cmd_kernel_latency(const struct shell *sh,
+			      size_t argc, char **argv)
+{
+	struct k_latency_histogram hist;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_SCHED_LATENCY_HISTOGRAM) && defined(CONFIG_THREAD_MONITOR)
+	shell_print(sh, "Scheduling latency:");
+	k_thread_foreach_unlocked(thread_latency_print, (void *)sh);
+#endif
+
+#if defined(CONFIG_ISR_LATENCY_HISTOGRAMS)
+	uint32_t untracked;
+
+	shell_print(sh, "Interrupt handler duration:");
+	untracked = k_isr_latency_foreach(isr_latency_print, (void *)sh);
+	if (untracked != 0U) {
+		shell_print(sh, "untracked: %u", untracked);
+	}
+#endif
+
+	if (k_wait_latency_get(K_LATENCY_SEM_TAKE, &hist) == 0) {
+		shell_print(sh, "Wait time:");
+		latency_print(sh, "k_sem_take", &hist);
+		(void)k_wait_latency_get(K_LATENCY_MSGQ_GET, &hist);
+		latency_print(sh, "k_msgq_get", &hist);
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_SCHED_LATENCY_HISTOGRAM) && defined(CONFIG_THREAD_MONITOR)
+static void thread_latency_reset(const struct k_thread *thread, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	k_thread_sched_latency_reset((k_tid_t)thread);
+}
+#endif
+
+static int cmd_kernel_latency_reset(const struct shell *sh,
+				    size_t argc, char **argv)
+{
+	ARG_UNUSED(sh);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_SCHED_LATENCY_HISTOGRAM) && defined(CONFIG_THREAD_MONITOR)
+	k_thread_foreach(thread_latency_reset, NULL);
+#endif
+	k_latency_reset();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_latency,
+	SHELL_CMD(reset, NULL, "Clear the histograms.", cmd_kernel_latency_reset),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *sh,
 				  size_t argc, char **argv)
@@ -370,6 +481,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 #endif
 #if defined(CONFIG_SYS_HEAP_RUNTIME_STATS) && (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 	SHELL_CMD(heap, NULL, "System heap usage statistics.", cmd_kernel_heap),
+#endif
+#if defined(CONFIG_LATENCY_HISTOGRAMS)
+	SHELL_CMD(latency, &sub_kernel_latency, "Latency histograms.",
+		  cmd_kernel_latency),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
@@ -32,6 +32,9 @@
 #define SHELL_MSG_TOO_MANY_ARGS		"Too many arguments in the command.\n"
 #define SHELL_INIT_OPTION_PRINTER	(NULL)
 
+/* Log messages printed between two refreshes of the command line */
+#define SHELL_LOG_BATCH_SIZE		8
+
 #define SHELL_THREAD_PRIORITY \
 	COND_CODE_1(CONFIG_SHELL_THREAD_PRIORITY_OVERRIDE, \
 			(CONFIG_SHELL_THREAD_PRIORITY), (K_LOWEST_APPLICATION_THREAD_PRIO))
@@ -1149,6 +1152,11 @@ static void state_collect(const struct shell *sh)
 	z_transport_buffer_flush(sh);
 }
 
+static void shell_tx_process(const struct shell *sh)
+{
+	(void)z_shell_tx_flush(sh);
+}
+
 static void transport_evt_handler(enum shell_transport_evt evt_type, void *ctx)
 {
 	struct shell *sh = (struct shell *)ctx;
@@ -1162,6 +1170,7 @@ static void transport_evt_handler(enum shell_transport_evt evt_type, void *ctx)
 
 static void shell_log_process(const struct shell *sh)
 {
+	struct k_poll_signal *signal = &sh->ctx->signals[SHELL_SIGNAL_RXRDY];
 	bool processed = false;
 	int signaled = 0;
 	int result;
@@ -1170,13 +1179,19 @@ static void shell_log_process(const struct shell *sh)
 		if (!IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE)) {
 			z_shell_cmd_line_erase(sh);
 
-			processed = z_shell_log_backend_process(
-					sh->log_backend);
+			/* Print a batch of messages before restoring the
+			 * command line, unless input is pending.
+			 */
+			for (int i = 0; i < SHELL_LOG_BATCH_SIZE; i++) {
+				processed = z_shell_log_backend_process(
+						sh->log_backend);
+				k_poll_signal_check(signal, &signaled, &result);
+				if (!processed || signaled) {
+					break;
+				}
+			}
 		}
 
-		struct k_poll_signal *signal =
-			&sh->ctx->signals[SHELL_SIGNAL_RXRDY];
-
 		z_shell_print_prompt_and_cmd(sh);
 
 		/* Arbitrary delay added to ensure that prompt is
@@ -1217,7 +1232,12 @@ static int instance_init(const struct shell *sh,
 	}
 
 	if (IS_ENABLED(CONFIG_SHELL_STATS)) {
-		sh->stats->log_lost_cnt = 0;
+		memset(sh->stats, 0, sizeof(*sh->stats));
+		sh->stats->reset_time = k_uptime_get();
+	}
+
+	if (IS_ENABLED(CONFIG_SHELL_TX_BUFFER)) {
+		ring_buf_reset(sh->tx_buf);
 	}
 
 	z_flag_tx_rdy_set(sh, true);
@@ -1333,8 +1353,10 @@ void shell_thread(void *shell_handle, void *arg_log_backend,
 	}
 
 	while (true) {
-		/* waiting for all signals except SHELL_SIGNAL_TXDONE */
-		err = k_poll(sh->ctx->events, SHELL_SIGNAL_TXDONE,
+		/* SHELL_SIGNAL_TXDONE is awaited only to flush the TX buffer */
+		err = k_poll(sh->ctx->events,
+			     IS_ENABLED(CONFIG_SHELL_TX_BUFFER) ?
+			     SHELL_SIGNALS : SHELL_SIGNAL_TXDONE,
 			     K_FOREVER);
 
 		if (err != 0) {
@@ -1353,6 +1375,10 @@ void shell_thread(void *shell_handle, void *arg_log_backend,
 			shell_signal_handle(sh, SHELL_SIGNAL_LOG_MSG,
 					    shell_log_process);
 		}
+		if (IS_ENABLED(CONFIG_SHELL_TX_BUFFER)) {
+			shell_signal_handle(sh, SHELL_SIGNAL_TXDONE,
+					    shell_tx_process);
+		}
 
 		if (sh->iface->api->update) {
 			sh->iface->api->update(sh->iface);
@@ -375,7 +375,15 @@ static int cmd_shell_stats_show(const struct shell *sh, size_t argc,
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 
-	shell_print(sh, "Lost logs: %lu", sh->stats->log_lost_cnt);
+	struct shell_stats *stats = sh->stats;
+	int64_t elapsed = k_uptime_get() - stats->reset_time;
+	unsigned long long tx_cnt = (unsigned long)atomic_get(&stats->tx_cnt);
+
+	shell_print(sh, "Lost logs: %lu", stats->log_lost_cnt);
+	shell_print(sh, "Printed logs: %lu", stats->log_cnt);
+	shell_print(sh, "TX bytes: %llu (%llu B/s)", tx_cnt,
+		    (elapsed > 0) ? (tx_cnt * MSEC_PER_SEC / elapsed) : 0ULL);
+	shell_print(sh, "TX stalls: %lu", stats->tx_stall_cnt);
 
 	return 0;
 }
@@ -386,7 +394,8 @@ static int cmd_shell_stats_reset(const struct shell *sh,
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 
-	sh->stats->log_lost_cnt = 0;
+	memset(sh->stats, 0, sizeof(*sh->stats));
+	sh->stats->reset_time = k_uptime_get();
 
 	return 0;
 }
@@ -70,8 +70,19 @@ bool z_shell_log_backend_process(const struct shell_log_backend *backend)
 			z_shell_vt100_color_set(sh, SHELL_VT100_COLOR_RED);
 		}
 
+		if (IS_ENABLED(CONFIG_SHELL_LOG_BACKEND_DROP_ON_TX_FULL)) {
+			z_shell_tx_log_begin(sh);
+		}
+
 		log_output_dropped_process(backend->log_output, dropped);
 
+		if (IS_ENABLED(CONFIG_SHELL_LOG_BACKEND_DROP_ON_TX_FULL) &&
+		    !z_shell_tx_log_end(sh)) {
+			/* Report it with the next message. */
+			atomic_add(&backend->control_block->dropped_cnt,
+				   dropped);
+		}
+
 		if (colors) {
 			z_shell_vt100_colors_restore(sh, &col);
 		}
@@ -184,7 +195,23 @@ static void process_log_msg(const struct shell *sh,
 		}
 	}
 
-	log_output_msg_process(log_output, &msg->log, flags);
+	if (!locked && IS_ENABLED(CONFIG_SHELL_LOG_BACKEND_DROP_ON_TX_FULL)) {
+		/* Messages processed in the shell thread are dropped rather
+		 * than waiting for the transport when the TX buffer is full.
+		 */
+		z_shell_tx_log_begin(sh);
+		log_output_msg_process(log_output, &msg->log, flags);
+		if (!z_shell_tx_log_end(sh)) {
+			dropped(sh->log_backend->backend, 1);
+			return;
+		}
+	} else {
+		log_output_msg_process(log_output, &msg->log, flags);
+	}
+
+	if (IS_ENABLED(CONFIG_SHELL_STATS)) {
+		atomic_inc(&sh->stats->log_cnt);
+	}
 
 	if (locked) {
 		if (!z_flag_cmd_ctx_get(sh)) {
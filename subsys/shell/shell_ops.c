@@ -382,6 +382,10 @@ void z_shell_print_prompt_and_cmd(const struct shell *sh)
 
 static void shell_pend_on_txdone(const struct shell *sh)
 {
+	if (IS_ENABLED(CONFIG_SHELL_STATS)) {
+		(void)atomic_inc(&sh->stats->tx_stall_cnt);
+	}
+
 	if (IS_ENABLED(CONFIG_MULTITHREADING) &&
 	    (sh->ctx->state < SHELL_STATE_PANIC_MODE_ACTIVE)) {
 		struct k_poll_event event;
@@ -400,6 +404,127 @@ static void shell_pend_on_txdone(const struct shell *sh)
 	}
 }
 
+static inline void tx_cnt_add(const struct shell *sh, size_t cnt)
+{
+	if (IS_ENABLED(CONFIG_SHELL_STATS)) {
+		(void)atomic_add(&sh->stats->tx_cnt, (atomic_val_t)cnt);
+	}
+}
+
+#ifdef CONFIG_SHELL_TX_BUFFER
+/* The TX buffer is bypassed when the transport is used in blocking mode. */
+static bool tx_buffer_used(const struct shell *sh)
+{
+	return (sh->tx_buf != NULL) &&
+	       (sh->ctx->state != SHELL_STATE_PANIC_MODE_ACTIVE) &&
+	       !z_flag_sync_mode_get(sh);
+}
+
+static void tx_buffer_write(const struct shell *sh, const uint8_t *data,
+			    size_t length)
+{
+	uint32_t cnt;
+
+	while (length > 0) {
+		cnt = ring_buf_put(sh->tx_buf, data, length);
+		data += cnt;
+		length -= cnt;
+
+		/* Wait for the transport only if the buffer is full. */
+		if ((z_shell_tx_flush(sh) == 0) && (length > 0)) {
+			shell_pend_on_txdone(sh);
+		}
+	}
+}
+
+static void tx_log_write(const struct shell *sh, const uint8_t *data,
+			 size_t length)
+{
+	uint8_t *dst;
+	uint32_t cnt;
+
+	/* Data is claimed and committed by z_shell_tx_log_end(), so that
+	 * a message which does not fit can be dropped as a whole.
+	 */
+	while (!z_flag_tx_log_drop_get(sh) && (length > 0)) {
+		cnt = ring_buf_put_claim(sh->tx_buf, &dst, length);
+		if (cnt == 0) {
+			z_flag_tx_log_drop_set(sh, true);
+			break;
+		}
+
+		memcpy(dst, data, cnt);
+		sh->ctx->tx_log_len += cnt;
+		data += cnt;
+		length -= cnt;
+	}
+}
+#endif /* CONFIG_SHELL_TX_BUFFER */
+
+size_t z_shell_tx_flush(const struct shell *sh)
+{
+	size_t total = 0;
+#ifdef CONFIG_SHELL_TX_BUFFER
+	struct ring_buf *buf = sh->tx_buf;
+	size_t tmp_cnt;
+	uint8_t *data;
+	uint32_t len;
+	int err;
+
+	while ((len = ring_buf_get_claim(buf, &data,
+					 ring_buf_capacity_get(buf))) > 0) {
+		tmp_cnt = 0;
+		err = sh->iface->api->write(sh->iface, data, len, &tmp_cnt);
+		if (err != 0) {
+			tmp_cnt = 0;
+		}
+
+		(void)ring_buf_get_finish(buf, tmp_cnt);
+		total += tmp_cnt;
+
+		if (tmp_cnt < len) {
+			/* Transport is busy, flushing resumes on TXDONE. */
+			break;
+		}
+	}
+
+	tx_cnt_add(sh, total);
+#endif
+	return total;
+}
+
+void z_shell_tx_log_begin(const struct shell *sh)
+{
+#ifdef CONFIG_SHELL_TX_BUFFER
+	if (tx_buffer_used(sh)) {
+		sh->ctx->tx_log_len = 0;
+		z_flag_tx_log_drop_set(sh, false);
+		z_flag_tx_log_set(sh, true);
+	}
+#endif
+}
+
+bool z_shell_tx_log_end(const struct shell *sh)
+{
+#ifdef CONFIG_SHELL_TX_BUFFER
+	bool dropped;
+
+	if (!z_flag_tx_log_set(sh, false)) {
+		return true;
+	}
+
+	dropped = z_flag_tx_log_drop_set(sh, false);
+	(void)ring_buf_put_finish(sh->tx_buf,
+				  dropped ? 0 : sh->ctx->tx_log_len);
+	if (dropped) {
+		return false;
+	}
+
+	(void)z_shell_tx_flush(sh);
+#endif
+	return true;
+}
+
 void z_shell_write(const struct shell *sh, const void *data,
 		 size_t length)
 {
@@ -408,6 +533,23 @@ void z_shell_write(const struct shell *sh, const void *data,
 	size_t offset = 0;
 	size_t tmp_cnt;
 
+#ifdef CONFIG_SHELL_TX_BUFFER
+	if (z_flag_tx_log_get(sh)) {
+		tx_log_write(sh, data, length);
+		return;
+	}
+
+	if (tx_buffer_used(sh)) {
+		tx_buffer_write(sh, data, length);
+		return;
+	}
+
+	/* Data buffered before switching to blocking mode is sent first. */
+	while ((sh->tx_buf != NULL) && !ring_buf_is_empty(sh->tx_buf) &&
+	       (z_shell_tx_flush(sh) > 0)) {
+	}
+#endif
+
 	while (length) {
 		int err = sh->iface->api->write(sh->iface,
 				&((const uint8_t *) data)[offset], length,
@@ -417,6 +559,7 @@ void z_shell_write(const struct shell *sh, const void *data,
 		__ASSERT_NO_MSG(length >= tmp_cnt);
 		offset += tmp_cnt;
 		length -= tmp_cnt;
+		tx_cnt_add(sh, tmp_cnt);
 		if (tmp_cnt == 0 &&
 		    (sh->ctx->state != SHELL_STATE_PANIC_MODE_ACTIVE)) {
 			shell_pend_on_txdone(sh);
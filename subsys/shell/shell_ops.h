@@ -221,6 +221,32 @@ static inline bool z_flag_sync_mode_set(const struct shell *sh, bool val)
 	return ret;
 }
 
+static inline bool z_flag_tx_log_get(const struct shell *sh)
+{
+	return sh->ctx->ctx.flags.tx_log == 1;
+}
+
+static inline bool z_flag_tx_log_set(const struct shell *sh, bool val)
+{
+	bool ret;
+
+	Z_SHELL_SET_FLAG_ATOMIC(sh, ctx, tx_log, val, ret);
+	return ret;
+}
+
+static inline bool z_flag_tx_log_drop_get(const struct shell *sh)
+{
+	return sh->ctx->ctx.flags.tx_log_drop == 1;
+}
+
+static inline bool z_flag_tx_log_drop_set(const struct shell *sh, bool val)
+{
+	bool ret;
+
+	Z_SHELL_SET_FLAG_ATOMIC(sh, ctx, tx_log_drop, val, ret);
+	return ret;
+}
+
 /* Function sends VT100 command to clear the screen from cursor position to
  * end of the screen.
  */
@@ -327,6 +353,21 @@ void z_shell_print_prompt_and_cmd(const struct shell *sh);
  */
 void z_shell_write(const struct shell *sh, const void *data, size_t length);
 
+/* Function moves data from the TX buffer to the transport, as much as the
+ * transport accepts without blocking. Returns the number of bytes moved.
+ */
+size_t z_shell_tx_flush(const struct shell *sh);
+
+/* Function starts writing a log message. Until z_shell_tx_log_end() is
+ * called, data is only stored in the TX buffer and the whole message is
+ * dropped if it does not fit, instead of waiting for the transport.
+ * It has no effect when the TX buffer is not used.
+ */
+void z_shell_tx_log_begin(const struct shell *sh);
+
+/* Function ends writing a log message. Returns false if it was dropped. */
+bool z_shell_tx_log_end(const struct shell *sh);
+
 /**
  * @internal @brief This function shall not be used directly, it is required by
  *		    the fprintf module.
@@ -266,22 +266,123 @@ static inline uint32_t shell_root_cmd_count(void)
 	return len;
 }
 
-/* Function returning pointer to parent command matching requested syntax. */
+/* Compare syntaxes in the order of the root command sections, named
+ * shell_cmd_<syntax>_ and sorted by name by the linker. Because of the
+ * trailing '_', "foo2" sorts before "foo".
+ */
+static int root_cmd_cmp(const char *a, const char *b)
+{
+	int ca;
+	int cb;
+
+	while ((*a != '\0') && (*a == *b)) {
+		a++;
+		b++;
+	}
+
+	if (*a == *b) {
+		return 0;
+	}
+
+	ca = (*a == '\0') ? '_' : (unsigned char)*a;
+	cb = (*b == '\0') ? '_' : (unsigned char)*b;
+	if (ca != cb) {
+		return ca - cb;
+	}
+
+	/* "foo" against "foo_bar": "foo_" is a prefix of "foo_bar_". */
+	return (*a == '\0') ? -1 : 1;
+}
+
+/* Function returning pointer to parent command matching requested syntax.
+ * Root commands are sorted by section name, see SHELL_CMD_ARG_REGISTER(),
+ * so a binary search is used.
+ */
 const struct shell_static_entry *root_cmd_find(const char *syntax)
 {
-	const size_t cmd_count = shell_root_cmd_count();
-	const union shell_cmd_entry *cmd;
+	const struct shell_static_entry *entry;
+	size_t low = 0;
+	size_t high = shell_root_cmd_count();
+	size_t mid;
+	int cmp;
 
-	for (size_t cmd_idx = 0; cmd_idx < cmd_count; ++cmd_idx) {
-		cmd = shell_root_cmd_get(cmd_idx);
-		if (strcmp(syntax, cmd->entry->syntax) == 0) {
-			return cmd->entry;
+	while (low < high) {
+		mid = low + (high - low) / 2;
+		entry = shell_root_cmd_get(mid)->entry;
+		cmp = root_cmd_cmp(syntax, entry->syntax);
+
+		if (cmp == 0) {
+			return entry;
+		} else if (cmp < 0) {
+			high = mid;
+		} else {
+			low = mid + 1;
 		}
 	}
 
 	return NULL;
 }
 
+#if CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE > 0
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE),
+	     "Lookup cache size must be a power of two");
+
+/* Direct mapped cache of static subcommands found by name. Static and
+ * section subcommand sets are constant, so a cached entry never gets stale.
+ */
+struct cmd_cache_entry {
+	const union shell_cmd_entry *subcmd;
+	const struct shell_static_entry *entry;
+};
+
+static struct cmd_cache_entry cmd_cache[CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE];
+static struct k_spinlock cmd_cache_lock;
+
+static size_t cmd_cache_idx(const union shell_cmd_entry *subcmd,
+			    const char *cmd_str)
+{
+	/* FNV-1a over the name, seeded with the subcommand set address. */
+	uint32_t hash = 2166136261U ^ (uint32_t)POINTER_TO_UINT(subcmd);
+
+	while (*cmd_str != '\0') {
+		hash = (hash ^ (uint8_t)*cmd_str++) * 16777619U;
+	}
+
+	return hash & (CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE - 1);
+}
+
+static const struct shell_static_entry *cmd_cache_get(size_t idx,
+					const union shell_cmd_entry *subcmd,
+					const char *cmd_str)
+{
+	const struct shell_static_entry *entry = NULL;
+	k_spinlock_key_t key = k_spin_lock(&cmd_cache_lock);
+
+	if (cmd_cache[idx].subcmd == subcmd) {
+		entry = cmd_cache[idx].entry;
+	}
+
+	k_spin_unlock(&cmd_cache_lock, key);
+
+	if ((entry != NULL) && (strcmp(cmd_str, entry->syntax) != 0)) {
+		entry = NULL;
+	}
+
+	return entry;
+}
+
+static void cmd_cache_set(size_t idx, const union shell_cmd_entry *subcmd,
+			  const struct shell_static_entry *entry)
+{
+	k_spinlock_key_t key = k_spin_lock(&cmd_cache_lock);
+
+	cmd_cache[idx].subcmd = subcmd;
+	cmd_cache[idx].entry = entry;
+
+	k_spin_unlock(&cmd_cache_lock, key);
+}
+#endif /* CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE > 0 */
+
 const struct shell_static_entry *z_shell_cmd_get(
 					const struct shell_static_entry *parent,
 					size_t idx,
@@ -342,6 +443,14 @@ const struct shell_static_entry *z_shell_find_cmd(
 	const struct shell_static_entry *entry;
 	struct shell_static_entry parent_cpy;
 	size_t idx = 0;
+#if CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE > 0
+	size_t cache_idx = 0;
+	bool cacheable;
+#endif
+
+	if (parent == NULL) {
+		return root_cmd_find(cmd_str);
+	}
 
 	/* Dynamic command operates on shared memory. If we are processing two
 	 * dynamic commands at the same time (current and subcommand) they
@@ -349,13 +458,28 @@ const struct shell_static_entry *z_shell_find_cmd(
 	 * behaviour.
 	 * Hence we need a separate memory for each of them.
 	 */
-	if (parent) {
-		memcpy(&parent_cpy, parent, sizeof(struct shell_static_entry));
-		parent = &parent_cpy;
+	memcpy(&parent_cpy, parent, sizeof(struct shell_static_entry));
+	parent = &parent_cpy;
+
+#if CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE > 0
+	cacheable = (parent->subcmd != NULL) && !is_dynamic_cmd(parent->subcmd);
+
+	if (cacheable) {
+		cache_idx = cmd_cache_idx(parent->subcmd, cmd_str);
+		entry = cmd_cache_get(cache_idx, parent->subcmd, cmd_str);
+		if (entry != NULL) {
+			return entry;
+		}
 	}
+#endif
 
 	while ((entry = z_shell_cmd_get(parent, idx++, dloc)) != NULL) {
 		if (strcmp(cmd_str, entry->syntax) == 0) {
+#if CONFIG_SHELL_CMD_LOOKUP_CACHE_SIZE > 0
+			if (cacheable) {
+				cmd_cache_set(cache_idx, parent->subcmd, entry);
+			}
+#endif
 			return entry;
 		}
 	}
@@ -0,0 +1,298 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/stats/metrics.h>
+#include <zephyr/sys/printk.h>
+#ifdef CONFIG_METRICS_CBOR
+#include <zcbor_common.h>
+#include <zcbor_encode.h>
+#endif
+
+/* Longest Prometheus line: name, suffix, labels, le label and value */
+#define LINE_MAX_LEN 192
+
+static const char *const type_names[] = {
+	[METRIC_COUNTER] = "counter",
+	[METRIC_GAUGE] = "gauge",
+	[METRIC_HISTOGRAM] = "histogram",
+};
+
+uint64_t metric_counter_get(const struct metric *m)
+{
+	uint64_t value = 0;
+
+	for (unsigned int cpu = 0; cpu < CONFIG_MP_MAX_NUM_CPUS; cpu++) {
+		value += z_metric_get64(&m->shards[cpu * m->stride]);
+	}
+
+	return value;
+}
+
+int32_t metric_gauge_get(const struct metric *m)
+{
+	return (int32_t)atomic_get(&m->shards[0]);
+}
+
+void metric_histogram_get(const struct metric *m, uint64_t *buckets,
+			  uint64_t *count, uint64_t *sum)
+{
+	*count = 0;
+	*sum = 0;
+
+	if (buckets != NULL) {
+		memset(buckets, 0, (m->bounds_cnt + 1) * sizeof(buckets[0]));
+	}
+
+	for (unsigned int cpu = 0; cpu < CONFIG_MP_MAX_NUM_CPUS; cpu++) {
+		const atomic_t *shard = &m->shards[cpu * m->stride];
+
+		for (uint16_t i = 0; i <= m->bounds_cnt; i++) {
+			uint32_t n = (uint32_t)atomic_get(&shard[i]);
+
+			if (buckets != NULL) {
+				buckets[i] += n;
+			}
+			*count += n;
+		}
+
+		*sum += z_metric_get64(&shard[m->bounds_cnt + 1]);
+	}
+}
+
+/* Count of a histogram bucket over all CPUs */
+static uint64_t bucket_get(const struct metric *m, uint16_t bucket)
+{
+	uint64_t count = 0;
+
+	for (unsigned int cpu = 0; cpu < CONFIG_MP_MAX_NUM_CPUS; cpu++) {
+		count += (uint32_t)atomic_get(&m->shards[cpu * m->stride + bucket]);
+	}
+
+	return count;
+}
+
+void metric_reset(const struct metric *m)
+{
+	unsigned int shards = (m->type == METRIC_GAUGE) ? 1 : CONFIG_MP_MAX_NUM_CPUS;
+
+	for (unsigned int i = 0; i < shards * m->stride; i++) {
+		(void)atomic_clear(&m->shards[i]);
+	}
+}
+
+const struct metric *metric_find(const char *name, const char *labels)
+{
+	STRUCT_SECTION_FOREACH(metric, m) {
+		if (strcmp(m->name, name) != 0) {
+			continue;
+		}
+
+		if ((labels == NULL) ? (m->labels == NULL) :
+		    ((m->labels != NULL) && (strcmp(m->labels, labels) == 0))) {
+			return m;
+		}
+	}
+
+	return NULL;
+}
+
+/* Print a sample line, @p le is the histogram bucket bound or NULL */
+static int sample_print(metrics_output_t out, void *ctx, const struct metric *m,
+			const char *suffix, const char *le, uint64_t value,
+			bool negative)
+{
+	char line[LINE_MAX_LEN];
+	bool braces = (m->labels != NULL) || (le != NULL);
+	int len;
+
+	len = snprintk(line, sizeof(line), "%s%s%s%s%s%s%s%s%s %s%llu\n",
+		       m->name, suffix,
+		       braces ? "{" : "",
+		       (m->labels != NULL) ? m->labels : "",
+		       ((m->labels != NULL) && (le != NULL)) ? "," : "",
+		       (le != NULL) ? "le=\"" : "",
+		       (le != NULL) ? le : "",
+		       (le != NULL) ? "\"" : "",
+		       braces ? "}" : "",
+		       negative ? "-" : "", (unsigned long long)value);
+	if ((len < 0) || ((size_t)len >= sizeof(line))) {
+		return -ENOMEM;
+	}
+
+	return out(line, len, ctx);
+}
+
+static int histogram_print(metrics_output_t out, void *ctx, const struct metric *m)
+{
+	uint64_t cumulative = 0;
+	uint64_t count;
+	uint64_t sum;
+	char le[sizeof("4294967295")];
+	int err;
+
+	metric_histogram_get(m, NULL, &count, &sum);
+
+	for (uint16_t i = 0; i < m->bounds_cnt; i++) {
+		cumulative += bucket_get(m, i);
+		snprintk(le, sizeof(le), "%u", m->bounds[i]);
+
+		err = sample_print(out, ctx, m, "_bucket", le, cumulative, false);
+		if (err < 0) {
+			return err;
+		}
+	}
+
+	err = sample_print(out, ctx, m, "_bucket", "+Inf", count, false);
+	if (err == 0) {
+		err = sample_print(out, ctx, m, "_sum", NULL, sum, false);
+	}
+	if (err == 0) {
+		err = sample_print(out, ctx, m, "_count", NULL, count, false);
+	}
+
+	return err;
+}
+
+int metrics_export_prometheus(metrics_output_t out, void *ctx)
+{
+	const char *family = NULL;
+	char line[LINE_MAX_LEN];
+	int32_t gauge;
+	int len;
+	int err;
+
+	STRUCT_SECTION_FOREACH(metric, m) {
+		/* HELP and TYPE are given once for all the labeled metrics
+		 * of a family.
+		 */
+		if ((family == NULL) || (strcmp(family, m->name) != 0)) {
+			family = m->name;
+
+			len = snprintk(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n",
+				       m->name, m->help, m->name, type_names[m->type]);
+			if ((len < 0) || ((size_t)len >= sizeof(line))) {
+				return -ENOMEM;
+			}
+
+			err = out(line, len, ctx);
+			if (err < 0) {
+				return err;
+			}
+		}
+
+		switch (m->type) {
+		case METRIC_COUNTER:
+			err = sample_print(out, ctx, m, "", NULL,
+					   metric_counter_get(m), false);
+			break;
+		case METRIC_GAUGE:
+			gauge = metric_gauge_get(m);
+			err = sample_print(out, ctx, m, "", NULL,
+					   (gauge < 0) ? -(int64_t)gauge : gauge,
+					   gauge < 0);
+			break;
+		case METRIC_HISTOGRAM:
+			err = histogram_print(out, ctx, m);
+			break;
+		default:
+			err = 0;
+			break;
+		}
+
+		if (err < 0) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_METRICS_CBOR
+static bool histogram_encode(zcbor_state_t *zse, const struct metric *m)
+{
+	uint64_t count;
+	uint64_t sum;
+	bool ok;
+
+	metric_histogram_get(m, NULL, &count, &sum);
+
+	ok = zcbor_tstr_put_lit(zse, "bounds") &&
+	     zcbor_list_start_encode(zse, m->bounds_cnt);
+	for (uint16_t i = 0; ok && (i < m->bounds_cnt); i++) {
+		ok = zcbor_uint32_put(zse, m->bounds[i]);
+	}
+	ok = ok && zcbor_list_end_encode(zse, m->bounds_cnt) &&
+	     zcbor_tstr_put_lit(zse, "buckets") &&
+	     zcbor_list_start_encode(zse, m->bounds_cnt + 1);
+	for (uint16_t i = 0; ok && (i <= m->bounds_cnt); i++) {
+		ok = zcbor_uint64_put(zse, bucket_get(m, i));
+	}
+
+	return ok && zcbor_list_end_encode(zse, m->bounds_cnt + 1) &&
+	       zcbor_tstr_put_lit(zse, "sum") &&
+	       zcbor_uint64_put(zse, sum);
+}
+
+int metrics_export_cbor(uint8_t *buf, size_t size, size_t *len)
+{
+	/* Backups for the outer list, a map and a bucket list */
+	ZCBOR_STATE_E(zse, 3, buf, size, 1);
+	size_t count;
+	bool ok;
+
+	STRUCT_SECTION_COUNT(metric, &count);
+
+	ok = zcbor_list_start_encode(zse, count);
+
+	STRUCT_SECTION_FOREACH(metric, m) {
+		if (!ok) {
+			break;
+		}
+
+		ok = zcbor_map_start_encode(zse, 6) &&
+		     zcbor_tstr_put_lit(zse, "name") &&
+		     zcbor_tstr_put_term(zse, m->name) &&
+		     zcbor_tstr_put_lit(zse, "type") &&
+		     zcbor_uint32_put(zse, m->type);
+
+		if (ok && (m->labels != NULL)) {
+			ok = zcbor_tstr_put_lit(zse, "labels") &&
+			     zcbor_tstr_put_term(zse, m->labels);
+		}
+
+		if (!ok) {
+			break;
+		}
+
+		switch (m->type) {
+		case METRIC_COUNTER:
+			ok = zcbor_tstr_put_lit(zse, "value") &&
+			     zcbor_uint64_put(zse, metric_counter_get(m));
+			break;
+		case METRIC_GAUGE:
+			ok = zcbor_tstr_put_lit(zse, "value") &&
+			     zcbor_int32_put(zse, metric_gauge_get(m));
+			break;
+		case METRIC_HISTOGRAM:
+			ok = histogram_encode(zse, m);
+			break;
+		default:
+			break;
+		}
+
+		ok = ok && zcbor_map_end_encode(zse, 6);
+	}
+
+	ok = ok && zcbor_list_end_encode(zse, count);
+	if (!ok) {
+		return -ENOMEM;
+	}
+
+	*len = zse->payload - buf;
+
+	return 0;
+}
+#endif /* CONFIG_METRICS_CBOR */
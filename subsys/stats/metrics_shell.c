@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/shell/shell.h>
+#include <zephyr/stats/metrics.h>
+
+static int metrics_shell_out(const char *data, size_t len, void *ctx)
+{
+	const struct shell *sh = ctx;
+
+	/* Lines include their new line */
+	shell_fprintf(sh, SHELL_NORMAL, "%.*s", (int)len, data);
+
+	return 0;
+}
+
+static int cmd_metrics_show(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	return metrics_export_prometheus(metrics_shell_out, (void *)sh);
+}
+
+static int cmd_metrics_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(sh);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	STRUCT_SECTION_FOREACH(metric, m) {
+		metric_reset(m);
+	}
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_metrics,
+			       SHELL_CMD(show, NULL, "Show metrics in Prometheus format",
+					 cmd_metrics_show),
+			       SHELL_CMD(reset, NULL, "Zero all metrics", cmd_metrics_reset),
+			       SHELL_SUBCMD_SET_END /* Array terminated. */
+			       );
+
+SHELL_CMD_REGISTER(metrics, &sub_metrics, "Metrics commands", NULL);
@@ -13,6 +13,8 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME, CONFIG_STREAM_FLASH_LOG_LEVEL);
 #include <zephyr/types.h>
 #include <string.h>
 #include <zephyr/drivers/flash.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
 
 #include <zephyr/storage/stream_flash.h>
 
@@ -39,6 +41,9 @@ static int settings_direct_loader(const char *key, size_t len,
 		/* Check that loaded progress is not outdated. */
 		if (bytes_written >= ctx->bytes_written) {
 			ctx->bytes_written = bytes_written;
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+			ctx->bytes_submitted = bytes_written;
+#endif
 		} else {
 			LOG_WRN("Loaded outdated bytes_written %zu < %zu",
 				bytes_written, ctx->bytes_written);
@@ -104,7 +109,15 @@ int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off)
 
 #endif /* CONFIG_STREAM_FLASH_ERASE */
 
-static int flash_sync(struct stream_flash_ctx *ctx)
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+static K_KERNEL_STACK_DEFINE(flash_work_stack,
+			     CONFIG_STREAM_FLASH_WORKQUEUE_STACK_SIZE);
+static struct k_work_q flash_work_q;
+#endif
+
+/* Program @p bytes of @p buf at the end of the data written so far. */
+static int flash_program(struct stream_flash_ctx *ctx, uint8_t *buf,
+			 size_t bytes)
 {
 	int rc = 0;
 	size_t write_addr = ctx->offset + ctx->bytes_written;
@@ -112,15 +125,9 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 	size_t fill_length;
 	uint8_t filler;
 
-
-	if (ctx->buf_bytes == 0) {
-		return 0;
-	}
-
 	if (IS_ENABLED(CONFIG_STREAM_FLASH_ERASE)) {
 
-		rc = stream_flash_erase_page(ctx,
-					     write_addr + ctx->buf_bytes - 1);
+		rc = stream_flash_erase_page(ctx, write_addr + bytes - 1);
 		if (rc < 0) {
 			LOG_ERR("stream_flash_erase_page err %d offset=0x%08zx",
 				rc, write_addr);
@@ -129,17 +136,17 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 	}
 
 	fill_length = flash_get_write_block_size(ctx->fdev);
-	if (ctx->buf_bytes % fill_length) {
-		fill_length -= ctx->buf_bytes % fill_length;
+	if (bytes % fill_length) {
+		fill_length -= bytes % fill_length;
 		filler = flash_get_parameters(ctx->fdev)->erase_value;
 
-		memset(ctx->buf + ctx->buf_bytes, filler, fill_length);
+		memset(buf + bytes, filler, fill_length);
 	} else {
 		fill_length = 0;
 	}
 
-	buf_bytes_aligned = ctx->buf_bytes + fill_length;
-	rc = flash_write(ctx->fdev, write_addr, ctx->buf, buf_bytes_aligned);
+	buf_bytes_aligned = bytes + fill_length;
+	rc = flash_write(ctx->fdev, write_addr, buf, buf_bytes_aligned);
 
 	if (rc != 0) {
 		LOG_ERR("flash_write error %d offset=0x%08zx", rc,
@@ -151,27 +158,160 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 		/* Invert to ensure that caller is able to discover a faulty
 		 * flash_read() even if no error code is returned.
 		 */
-		for (int i = 0; i < ctx->buf_bytes; i++) {
-			ctx->buf[i] = ~ctx->buf[i];
+		for (int i = 0; i < bytes; i++) {
+			buf[i] = ~buf[i];
 		}
 
-		rc = flash_read(ctx->fdev, write_addr, ctx->buf,
-				ctx->buf_bytes);
+		rc = flash_read(ctx->fdev, write_addr, buf, bytes);
 		if (rc != 0) {
 			LOG_ERR("flash read failed: %d", rc);
 			return rc;
 		}
 
-		rc = ctx->callback(ctx->buf, ctx->buf_bytes, write_addr);
+		rc = ctx->callback(buf, bytes, write_addr);
 		if (rc != 0) {
 			LOG_ERR("callback failed: %d", rc);
 			return rc;
 		}
 	}
 
-	ctx->bytes_written += ctx->buf_bytes;
+	ctx->bytes_written += bytes;
+
+	return rc;
+}
+
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+
+static void flash_program_work(struct k_work *work)
+{
+	struct stream_flash_ctx *ctx =
+		CONTAINER_OF(work, struct stream_flash_ctx, work);
+	int rc;
+
+	rc = flash_program(ctx, ctx->wr_buf, ctx->wr_bytes);
+
+#ifdef CONFIG_STREAM_FLASH_ERASE_AHEAD
+	/* A partial buffer ends the stream, nothing follows it. The page
+	 * holding the next byte is either the one just written to, which is
+	 * not erased again, or the next one.
+	 */
+	if ((rc == 0) && (ctx->wr_bytes == ctx->buf_len) &&
+	    (ctx->bytes_written < ctx->available)) {
+		rc = stream_flash_erase_page(ctx,
+					     ctx->offset + ctx->bytes_written);
+	}
+#endif
+
+	if ((rc != 0) && (ctx->wr_rc == 0)) {
+		ctx->wr_rc = rc;
+	}
+
+	k_sem_give(&ctx->idle);
+}
+
+/* Hand the buffer over to the work queue and switch to the other half. */
+static int flash_submit(struct stream_flash_ctx *ctx)
+{
+	(void)k_sem_take(&ctx->idle, K_FOREVER);
+
+	if (ctx->wr_rc != 0) {
+		k_sem_give(&ctx->idle);
+		return ctx->wr_rc;
+	}
+
+	ctx->wr_buf = ctx->buf;
+	ctx->wr_bytes = ctx->buf_bytes;
+	ctx->bytes_submitted += ctx->buf_bytes;
+	ctx->buf = (ctx->buf == ctx->buf_base) ?
+		   ctx->buf_base + ctx->buf_len : ctx->buf_base;
 	ctx->buf_bytes = 0U;
 
+	(void)k_work_submit_to_queue(&flash_work_q, &ctx->work);
+
+	return 0;
+}
+
+/* Wait for the buffer handed over last to be programmed. */
+static int flash_wait(struct stream_flash_ctx *ctx)
+{
+	int rc;
+
+	(void)k_sem_take(&ctx->idle, K_FOREVER);
+	rc = ctx->wr_rc;
+	k_sem_give(&ctx->idle);
+
+	return rc;
+}
+
+int stream_flash_double_buffer_enable(struct stream_flash_ctx *ctx)
+{
+	size_t half;
+
+	if (!ctx) {
+		return -EFAULT;
+	}
+
+	if (ctx->double_buffer) {
+		return 0;
+	}
+
+	half = ctx->buf_len / 2;
+	if ((ctx->buf_bytes != 0U) || (half == 0U) ||
+	    (half % flash_get_write_block_size(ctx->fdev))) {
+		LOG_ERR("Buffer halves not aligned to write-block-size");
+		return -EINVAL;
+	}
+
+	ctx->buf_base = ctx->buf;
+	ctx->buf_len = half;
+	ctx->wr_buf = NULL;
+	ctx->wr_bytes = 0U;
+	ctx->bytes_submitted = ctx->bytes_written;
+	ctx->wr_rc = 0;
+	k_work_init(&ctx->work, flash_program_work);
+	k_sem_init(&ctx->idle, 1, 1);
+	ctx->double_buffer = true;
+
+	return 0;
+}
+
+static int stream_flash_work_q_init(void)
+{
+	static const struct k_work_queue_config cfg = {
+		.name = "stream_flash",
+	};
+
+	k_work_queue_start(&flash_work_q, flash_work_stack,
+			   K_KERNEL_STACK_SIZEOF(flash_work_stack),
+			   CONFIG_STREAM_FLASH_WORKQUEUE_THREAD_PRIORITY, &cfg);
+
+	return 0;
+}
+
+SYS_INIT(stream_flash_work_q_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif /* CONFIG_STREAM_FLASH_DOUBLE_BUFFER */
+
+static int flash_sync(struct stream_flash_ctx *ctx)
+{
+	int rc;
+
+	if (ctx->buf_bytes == 0) {
+		return 0;
+	}
+
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	if (ctx->double_buffer) {
+		return flash_submit(ctx);
+	}
+#endif
+
+	rc = flash_program(ctx, ctx->buf, ctx->buf_bytes);
+	if (rc == 0) {
+		ctx->buf_bytes = 0U;
+	}
+
 	return rc;
 }
 
@@ -181,12 +321,21 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 	int processed = 0;
 	int rc = 0;
 	int buf_empty_bytes;
+	size_t bytes_written;
 
 	if (!ctx) {
 		return -EFAULT;
 	}
 
-	if (ctx->bytes_written + ctx->buf_bytes + len > ctx->available) {
+	bytes_written = ctx->bytes_written;
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	if (ctx->double_buffer) {
+		/* Includes the data still being programmed */
+		bytes_written = ctx->bytes_submitted;
+	}
+#endif
+
+	if (bytes_written + ctx->buf_bytes + len > ctx->available) {
 		return -ENOMEM;
 	}
 
@@ -216,6 +365,12 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		rc = flash_sync(ctx);
 	}
 
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	if (flush && (rc == 0) && ctx->double_buffer) {
+		rc = flash_wait(ctx);
+	}
+#endif
+
 	return rc;
 }
 
@@ -299,6 +454,9 @@ int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 #ifdef CONFIG_STREAM_FLASH_ERASE
 	ctx->last_erased_page_start_offset = -1;
 #endif
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	ctx->double_buffer = false;
+#endif
 
 	return 0;
 }
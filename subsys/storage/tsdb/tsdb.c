@@ -0,0 +1,713 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/tsdb.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(tsdb, CONFIG_TSDB_LOG_LEVEL);
+
+/*
+ * Each sector starts with a header giving its sequence number, followed by
+ * blocks of samples. Sectors are used in a ring, in the order of their
+ * sequence numbers, so samples are ordered by time across sectors.
+ *
+ * A block holds the timestamps of its first and last samples, then the
+ * samples themselves: the difference between the timestamp delta of a sample
+ * and the one of the previous sample (delta of delta, 0 for periodic
+ * samples) and the difference between the value of a sample and the one of
+ * the previous sample, both as zigzag varints. Blocks are decoded on their
+ * own, with the previous delta and value starting at 0.
+ */
+#define TSDB_MAGIC		0x42445354 /* "TSDB" */
+#define TSDB_ALIGN_MAX		32
+#define TSDB_SAMPLE_LEN_MAX	15
+
+/* Returned by query helpers when the query must not go on */
+#define TSDB_QUERY_STOP		1
+
+struct tsdb_sector_hdr {
+	uint32_t magic;
+	uint32_t seq;
+} __packed;
+
+struct tsdb_block_hdr {
+	uint32_t crc32;		/* Of the rest of the header and the payload */
+	uint16_t len;		/* Length of the payload */
+	uint16_t cnt;		/* Number of samples */
+	int64_t first_ts;
+	int64_t last_ts;
+} __packed;
+
+BUILD_ASSERT(CONFIG_TSDB_BLOCK_SIZE >=
+	     sizeof(struct tsdb_block_hdr) + TSDB_SAMPLE_LEN_MAX,
+	     "Blocks can not hold a sample");
+
+static inline uint32_t tsdb_align(const struct tsdb_fs *fs, uint32_t len)
+{
+	return ROUND_UP(len, fs->write_align);
+}
+
+static inline off_t tsdb_sector_off(const struct tsdb_fs *fs, uint16_t sector)
+{
+	return (off_t)sector * fs->sector_size;
+}
+
+static inline bool tsdb_sector_has_data(const struct tsdb_sector *s)
+{
+	return ((s->state == TSDB_SECTOR_USED) ||
+		(s->state == TSDB_SECTOR_CLOSED)) && (s->count > 0);
+}
+
+static inline uint64_t tsdb_zigzag(int64_t val)
+{
+	return ((uint64_t)val << 1) ^ (uint64_t)(val >> 63);
+}
+
+static inline int64_t tsdb_unzigzag(uint64_t val)
+{
+	return (int64_t)(val >> 1) ^ -(int64_t)(val & 1);
+}
+
+static size_t tsdb_put_varint(uint8_t *buf, uint64_t val)
+{
+	size_t len = 0;
+
+	while (val >= 0x80) {
+		buf[len++] = (uint8_t)val | 0x80;
+		val >>= 7;
+	}
+	buf[len++] = (uint8_t)val;
+
+	return len;
+}
+
+/* Returns the number of bytes used by the varint, -EIO if truncated */
+static int tsdb_get_varint(const uint8_t *buf, size_t size, uint64_t *val)
+{
+	uint64_t res = 0;
+
+	for (size_t i = 0; (i < size) && (i < 10); i++) {
+		res |= (uint64_t)(buf[i] & 0x7f) << (7 * i);
+		if ((buf[i] & 0x80) == 0) {
+			*val = res;
+			return i + 1;
+		}
+	}
+
+	return -EIO;
+}
+
+/* Encode a sample following the ones of the current block */
+static size_t tsdb_encode(const struct tsdb_fs *fs, int64_t ts, int32_t value,
+			  uint8_t *buf)
+{
+	uint64_t delta = 0;
+	int64_t prev_value = 0;
+	size_t len;
+
+	if (fs->block_cnt > 0) {
+		delta = (uint64_t)ts - (uint64_t)fs->last_ts;
+		prev_value = fs->last_value;
+	}
+
+	len = tsdb_put_varint(buf,
+		tsdb_zigzag((int64_t)(delta - (uint64_t)fs->last_delta)));
+	len += tsdb_put_varint(&buf[len], tsdb_zigzag((int64_t)value - prev_value));
+
+	return len;
+}
+
+/* Report the samples of a block in [from, to] */
+static int tsdb_decode(const uint8_t *buf, size_t len, int64_t first_ts,
+		       uint16_t cnt, int64_t from, int64_t to,
+		       tsdb_query_cb_t cb, void *user_data, int *found)
+{
+	struct tsdb_sample sample;
+	uint64_t delta = 0;
+	uint64_t ts = first_ts;
+	int64_t value = 0;
+	uint64_t val;
+	size_t pos = 0;
+	int rc;
+
+	for (uint16_t i = 0; i < cnt; i++) {
+		rc = tsdb_get_varint(&buf[pos], len - pos, &val);
+		if (rc < 0) {
+			return rc;
+		}
+		pos += rc;
+		delta += (uint64_t)tsdb_unzigzag(val);
+		ts += delta;
+
+		rc = tsdb_get_varint(&buf[pos], len - pos, &val);
+		if (rc < 0) {
+			return rc;
+		}
+		pos += rc;
+		value += tsdb_unzigzag(val);
+
+		sample.ts = (int64_t)ts;
+		sample.value = (int32_t)value;
+
+		if (sample.ts > to) {
+			return TSDB_QUERY_STOP;
+		}
+		if (sample.ts >= from) {
+			(*found)++;
+			if (cb(&sample, user_data)) {
+				return TSDB_QUERY_STOP;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t tsdb_block_crc(const struct tsdb_block_hdr *hdr,
+			       const uint8_t *payload)
+{
+	uint32_t crc;
+
+	crc = crc32_ieee((const uint8_t *)hdr + sizeof(hdr->crc32),
+			 sizeof(*hdr) - sizeof(hdr->crc32));
+
+	return crc32_ieee_update(crc, payload, hdr->len);
+}
+
+static int tsdb_sector_erase(struct tsdb_fs *fs, uint16_t sector)
+{
+	struct tsdb_sector *s = &fs->sectors[sector];
+	int rc;
+
+	rc = flash_area_erase(fs->fa, tsdb_sector_off(fs, sector),
+			      fs->sector_size);
+	if (rc) {
+		s->state = TSDB_SECTOR_DIRTY;
+		return rc;
+	}
+
+	fs->sectors_erased++;
+	(void)memset(s, 0, sizeof(*s));
+	s->state = TSDB_SECTOR_ERASED;
+
+	return 0;
+}
+
+/* Erase the sectors holding only samples older than the retention */
+static int tsdb_retention_apply(struct tsdb_fs *fs)
+{
+	struct tsdb_sector *s;
+	int64_t limit;
+	int rc;
+
+	if ((fs->retention <= 0) || fs->empty ||
+	    (fs->last_ts < INT64_MIN + fs->retention)) {
+		return 0;
+	}
+
+	limit = fs->last_ts - fs->retention;
+
+	for (uint16_t i = 0; i < fs->sector_count; i++) {
+		s = &fs->sectors[i];
+		if ((i == fs->active) || !tsdb_sector_has_data(s) ||
+		    (s->last_ts >= limit)) {
+			continue;
+		}
+
+		LOG_DBG("Sector %u expired", i);
+		rc = tsdb_sector_erase(fs, i);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+/* Start writing to the sector following the active one */
+static int tsdb_sector_open(struct tsdb_fs *fs)
+{
+	uint8_t buf[TSDB_ALIGN_MAX];
+	struct tsdb_sector_hdr hdr = {
+		.magic = TSDB_MAGIC,
+		.seq = fs->seq + 1,
+	};
+	uint16_t next = (fs->active + 1) % fs->sector_count;
+	struct tsdb_sector *s = &fs->sectors[next];
+	uint32_t len = tsdb_align(fs, sizeof(hdr));
+	int rc;
+
+	rc = tsdb_retention_apply(fs);
+	if (rc) {
+		return rc;
+	}
+
+	/* When the ring is full, this drops the oldest samples */
+	if (s->state != TSDB_SECTOR_ERASED) {
+		rc = tsdb_sector_erase(fs, next);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	(void)memset(buf, fs->erase_value, sizeof(buf));
+	memcpy(buf, &hdr, sizeof(hdr));
+
+	rc = flash_area_write(fs->fa, tsdb_sector_off(fs, next), buf, len);
+	if (rc) {
+		s->state = TSDB_SECTOR_DIRTY;
+		return rc;
+	}
+
+	fs->bytes_written += len;
+	s->state = TSDB_SECTOR_USED;
+	s->seq = hdr.seq;
+	s->wr_off = len;
+	s->count = 0;
+	fs->active = next;
+	fs->seq = hdr.seq;
+
+	return 0;
+}
+
+/* Write the block being built to flash */
+static int tsdb_block_write(struct tsdb_fs *fs)
+{
+	struct tsdb_sector *s = &fs->sectors[fs->active];
+	struct tsdb_block_hdr hdr;
+	uint32_t len;
+	off_t off;
+	int rc;
+
+	if (fs->block_cnt == 0) {
+		return 0;
+	}
+
+	hdr.len = fs->block_len;
+	hdr.cnt = fs->block_cnt;
+	hdr.first_ts = fs->block_first_ts;
+	hdr.last_ts = fs->last_ts;
+	hdr.crc32 = tsdb_block_crc(&hdr, &fs->block[sizeof(hdr)]);
+	memcpy(fs->block, &hdr, sizeof(hdr));
+
+	len = tsdb_align(fs, sizeof(hdr) + fs->block_len);
+	(void)memset(&fs->block[sizeof(hdr) + fs->block_len], fs->erase_value,
+		     len - sizeof(hdr) - fs->block_len);
+
+	if ((s->state != TSDB_SECTOR_USED) ||
+	    (s->wr_off + len > fs->sector_size)) {
+		rc = tsdb_sector_open(fs);
+		if (rc) {
+			return rc;
+		}
+		s = &fs->sectors[fs->active];
+	}
+
+	off = tsdb_sector_off(fs, fs->active) + s->wr_off;
+	rc = flash_area_write(fs->fa, off, fs->block, len);
+	if (rc &&
+	    ((flash_area_read(fs->fa, off, fs->read_buf, len) != 0) ||
+	     (memcmp(fs->read_buf, fs->block, len) != 0))) {
+		/*
+		 * Keep the block, it goes to the next sector on retry. Unless
+		 * it made it to flash anyway, which would duplicate it.
+		 */
+		s->state = TSDB_SECTOR_CLOSED;
+		return rc;
+	}
+
+	fs->bytes_written += len;
+	if (s->count == 0) {
+		s->first_ts = hdr.first_ts;
+	}
+	s->last_ts = hdr.last_ts;
+	s->count += hdr.cnt;
+	s->wr_off += len;
+
+	fs->block_cnt = 0;
+	fs->block_len = 0;
+
+	return 0;
+}
+
+static bool tsdb_is_erased(const struct tsdb_fs *fs, const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+
+	for (size_t i = 0; i < len; i++) {
+		if (p[i] != fs->erase_value) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Rebuild the time index of a used sector, checking the blocks if verify */
+static int tsdb_sector_scan(struct tsdb_fs *fs, uint16_t sector, bool verify)
+{
+	struct tsdb_sector *s = &fs->sectors[sector];
+	off_t base = tsdb_sector_off(fs, sector);
+	struct tsdb_block_hdr hdr;
+	uint32_t off = tsdb_align(fs, sizeof(struct tsdb_sector_hdr));
+	uint32_t len;
+	int rc;
+
+	s->count = 0;
+
+	while (off + sizeof(hdr) <= fs->sector_size) {
+		rc = flash_area_read(fs->fa, base + off, &hdr, sizeof(hdr));
+		if (rc) {
+			return rc;
+		}
+
+		if (tsdb_is_erased(fs, &hdr, sizeof(hdr))) {
+			break;
+		}
+
+		len = tsdb_align(fs, sizeof(hdr) + hdr.len);
+		if ((hdr.cnt == 0) || (hdr.last_ts < hdr.first_ts) ||
+		    (sizeof(hdr) + hdr.len > CONFIG_TSDB_BLOCK_SIZE) ||
+		    (off + len > fs->sector_size) ||
+		    ((s->count > 0) && (hdr.first_ts < s->last_ts))) {
+			goto corrupt;
+		}
+
+		if (verify) {
+			rc = flash_area_read(fs->fa, base + off + sizeof(hdr),
+					     fs->read_buf, hdr.len);
+			if (rc) {
+				return rc;
+			}
+			if (tsdb_block_crc(&hdr, fs->read_buf) != hdr.crc32) {
+				goto corrupt;
+			}
+		}
+
+		if (s->count == 0) {
+			s->first_ts = hdr.first_ts;
+		}
+		s->last_ts = hdr.last_ts;
+		s->count += hdr.cnt;
+		off += len;
+	}
+
+	s->wr_off = off;
+	return 0;
+
+corrupt:
+	/* Keep the blocks before, but do not write after garbage */
+	LOG_WRN("Sector %u: invalid block at offset %u", sector, off);
+	s->state = TSDB_SECTOR_CLOSED;
+	s->wr_off = off;
+	return 0;
+}
+
+static void tsdb_reset(struct tsdb_fs *fs)
+{
+	fs->active = fs->sector_count - 1;
+	fs->seq = 0;
+	fs->block_cnt = 0;
+	fs->block_len = 0;
+	fs->last_delta = 0;
+	fs->last_value = 0;
+	fs->empty = true;
+}
+
+int tsdb_mount(struct tsdb_fs *fs)
+{
+	struct flash_pages_info info;
+	struct tsdb_sector_hdr hdr;
+	struct tsdb_sector *s;
+	const struct device *dev;
+	int rc;
+
+	fs->ready = false;
+	k_mutex_init(&fs->lock);
+
+	rc = flash_area_open(fs->area_id, &fs->fa);
+	if (rc) {
+		return rc;
+	}
+
+	if ((fs->sector_count < 2) ||
+	    (fs->sector_count > CONFIG_TSDB_SECTOR_COUNT_MAX) ||
+	    (fs->sector_size == 0) ||
+	    ((uint64_t)fs->sector_size * fs->sector_count > fs->fa->fa_size)) {
+		LOG_ERR("Invalid sector geometry");
+		return -EINVAL;
+	}
+
+	dev = flash_area_get_device(fs->fa);
+	rc = flash_get_page_info_by_offs(dev, fs->fa->fa_off, &info);
+	if (rc || (fs->sector_size % info.size)) {
+		LOG_ERR("Sector size not a multiple of the flash page size");
+		return -EINVAL;
+	}
+
+	fs->write_align = flash_area_align(fs->fa);
+	fs->erase_value = flash_area_erased_val(fs->fa);
+	if ((fs->write_align == 0) || (fs->write_align > TSDB_ALIGN_MAX) ||
+	    (CONFIG_TSDB_BLOCK_SIZE % fs->write_align) ||
+	    (tsdb_align(fs, sizeof(hdr)) + CONFIG_TSDB_BLOCK_SIZE >
+	     fs->sector_size)) {
+		LOG_ERR("Unsupported write block size");
+		return -EINVAL;
+	}
+
+	tsdb_reset(fs);
+	fs->bytes_written = 0;
+	fs->sectors_erased = 0;
+
+	for (uint16_t i = 0; i < fs->sector_count; i++) {
+		s = &fs->sectors[i];
+		(void)memset(s, 0, sizeof(*s));
+
+		rc = flash_area_read(fs->fa, tsdb_sector_off(fs, i), &hdr,
+				     sizeof(hdr));
+		if (rc) {
+			return rc;
+		}
+
+		/* Sectors without a valid header are erased before use */
+		if ((hdr.magic != TSDB_MAGIC) || (hdr.seq == 0)) {
+			s->state = TSDB_SECTOR_DIRTY;
+			continue;
+		}
+
+		s->state = TSDB_SECTOR_USED;
+		s->seq = hdr.seq;
+		if (hdr.seq > fs->seq) {
+			fs->seq = hdr.seq;
+			fs->active = i;
+		}
+	}
+
+	for (uint16_t i = 0; i < fs->sector_count; i++) {
+		s = &fs->sectors[i];
+		if (s->state != TSDB_SECTOR_USED) {
+			continue;
+		}
+
+		/* Only the last sector written can hold a partial block */
+		rc = tsdb_sector_scan(fs, i, i == fs->active);
+		if (rc) {
+			return rc;
+		}
+
+		if (tsdb_sector_has_data(s) &&
+		    (fs->empty || (s->last_ts > fs->last_ts))) {
+			fs->last_ts = s->last_ts;
+			fs->empty = false;
+		}
+	}
+
+	rc = tsdb_retention_apply(fs);
+	if (rc) {
+		return rc;
+	}
+
+	fs->ready = true;
+	LOG_DBG("Mounted, %u sectors of %u bytes, sequence %u",
+		fs->sector_count, fs->sector_size, fs->seq);
+
+	return 0;
+}
+
+int tsdb_append(struct tsdb_fs *fs, int64_t ts, int32_t value)
+{
+	uint8_t buf[TSDB_SAMPLE_LEN_MAX];
+	size_t len;
+	int rc = 0;
+
+	if (!fs->ready) {
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+
+	if (!fs->empty && (ts < fs->last_ts)) {
+		rc = -EINVAL;
+		goto end;
+	}
+
+	len = tsdb_encode(fs, ts, value, buf);
+	if ((fs->block_cnt == UINT16_MAX) ||
+	    (sizeof(struct tsdb_block_hdr) + fs->block_len + len >
+	     CONFIG_TSDB_BLOCK_SIZE)) {
+		rc = tsdb_block_write(fs);
+		if (rc) {
+			goto end;
+		}
+	}
+
+	if (fs->block_cnt == 0) {
+		/* A block starts with no previous sample */
+		fs->block_first_ts = ts;
+		fs->last_delta = 0;
+		len = tsdb_encode(fs, ts, value, buf);
+	} else {
+		fs->last_delta = (int64_t)((uint64_t)ts - (uint64_t)fs->last_ts);
+	}
+
+	memcpy(&fs->block[sizeof(struct tsdb_block_hdr) + fs->block_len], buf,
+	       len);
+	fs->block_len += len;
+	fs->block_cnt++;
+	fs->last_ts = ts;
+	fs->last_value = value;
+	fs->empty = false;
+
+end:
+	k_mutex_unlock(&fs->lock);
+	return rc;
+}
+
+int tsdb_flush(struct tsdb_fs *fs)
+{
+	int rc;
+
+	if (!fs->ready) {
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	rc = tsdb_block_write(fs);
+	k_mutex_unlock(&fs->lock);
+
+	return rc;
+}
+
+/* Report the samples of a sector in [from, to] */
+static int tsdb_sector_query(struct tsdb_fs *fs, uint16_t sector, int64_t from,
+			     int64_t to, tsdb_query_cb_t cb, void *user_data,
+			     int *found)
+{
+	struct tsdb_sector *s = &fs->sectors[sector];
+	off_t base = tsdb_sector_off(fs, sector);
+	struct tsdb_block_hdr hdr;
+	uint32_t off = tsdb_align(fs, sizeof(struct tsdb_sector_hdr));
+	int rc;
+
+	while (off + sizeof(hdr) <= s->wr_off) {
+		rc = flash_area_read(fs->fa, base + off, &hdr, sizeof(hdr));
+		if (rc) {
+			return rc;
+		}
+		if (tsdb_is_erased(fs, &hdr, sizeof(hdr))) {
+			break;
+		}
+
+		if (hdr.first_ts > to) {
+			return TSDB_QUERY_STOP;
+		}
+
+		if (hdr.last_ts >= from) {
+			rc = flash_area_read(fs->fa, base + off + sizeof(hdr),
+					     fs->read_buf, hdr.len);
+			if (rc) {
+				return rc;
+			}
+
+			/* Blocks of older sectors were not checked on mount */
+			if (tsdb_block_crc(&hdr, fs->read_buf) != hdr.crc32) {
+				LOG_WRN("Sector %u: skipping invalid block at "
+					"offset %u", sector, off);
+			} else {
+				rc = tsdb_decode(fs->read_buf, hdr.len,
+						 hdr.first_ts, hdr.cnt, from, to,
+						 cb, user_data, found);
+				if (rc) {
+					return rc;
+				}
+			}
+		}
+
+		off += tsdb_align(fs, sizeof(hdr) + hdr.len);
+	}
+
+	return 0;
+}
+
+int tsdb_query(struct tsdb_fs *fs, int64_t from, int64_t to,
+	       tsdb_query_cb_t cb, void *user_data)
+{
+	struct tsdb_sector *s;
+	uint16_t sector;
+	int found = 0;
+	int rc = 0;
+
+	if (!fs->ready) {
+		return -EACCES;
+	}
+
+	if (from > to) {
+		return 0;
+	}
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+
+	/* From the oldest sector to the active one */
+	for (uint16_t i = 1; i <= fs->sector_count; i++) {
+		sector = (fs->active + i) % fs->sector_count;
+		s = &fs->sectors[sector];
+
+		if (!tsdb_sector_has_data(s) || (s->last_ts < from)) {
+			continue;
+		}
+		if (s->first_ts > to) {
+			rc = TSDB_QUERY_STOP;
+			break;
+		}
+
+		rc = tsdb_sector_query(fs, sector, from, to, cb, user_data,
+				       &found);
+		if (rc) {
+			break;
+		}
+	}
+
+	if ((rc == 0) && (fs->block_cnt > 0) && (fs->last_ts >= from)) {
+		rc = tsdb_decode(&fs->block[sizeof(struct tsdb_block_hdr)],
+				 fs->block_len, fs->block_first_ts,
+				 fs->block_cnt, from, to, cb, user_data, &found);
+	}
+
+	k_mutex_unlock(&fs->lock);
+
+	return (rc < 0) ? rc : found;
+}
+
+int tsdb_clear(struct tsdb_fs *fs)
+{
+	int rc = 0;
+
+	if (!fs->ready) {
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+
+	for (uint16_t i = 0; i < fs->sector_count; i++) {
+		if (fs->sectors[i].state == TSDB_SECTOR_ERASED) {
+			continue;
+		}
+
+		rc = tsdb_sector_erase(fs, i);
+		if (rc) {
+			break;
+		}
+	}
+
+	tsdb_reset(fs);
+
+	k_mutex_unlock(&fs->lock);
+
+	return rc;
+}
@@ -319,3 +319,15 @@ void sys_trace_k_timer_status_sync_exit(struct k_timer *timer, uint32_t result)
 		result
 		);
 }
+
+void sys_trace_k_latency_bucket(uint32_t type, const void *id, uint32_t start,
+				uint32_t count)
+{
+	ctf_top_latency_bucket((uint8_t)type, (uint32_t)(uintptr_t)id, start,
+			       count);
+}
+
+void tracing_packet_drop_report(uint32_t count)
+{
+	ctf_top_packets_dropped(count);
+}
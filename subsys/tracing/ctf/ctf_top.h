@@ -11,6 +11,7 @@
 #include <string.h>
 #include <ctf_map.h>
 #include <zephyr/tracing/tracing_format.h>
+#include <tracing_core.h>
 
 /* Limit strings to 20 bytes to optimize bandwidth */
 #define CTF_MAX_STRING_LEN 20
@@ -30,31 +31,37 @@
 	}
 
 /*
- * Gather fields to a contiguous event-packet, then atomically emit.
+ * Gather fields to a contiguous event-packet, then atomically emit with
+ * the given function.
  */
-#define CTF_GATHER_FIELDS(...)                                                  \
+#define CTF_GATHER_FIELDS_EMIT(emit, ...)                                       \
 	{                                                                       \
 		uint8_t epacket[0 MAP(CTF_INTERNAL_FIELD_SIZE, ##__VA_ARGS__)]; \
 		uint8_t *epacket_cursor = &epacket[0];                          \
 										\
 		MAP(CTF_INTERNAL_FIELD_APPEND, ##__VA_ARGS__)                   \
-		tracing_format_raw_data(epacket, sizeof(epacket));              \
+		emit(epacket, sizeof(epacket));                                 \
 	}
 
+#define CTF_GATHER_FIELDS(...)                                                  \
+	CTF_GATHER_FIELDS_EMIT(tracing_format_raw_data, __VA_ARGS__)
+
 #ifdef CONFIG_TRACING_CTF_TIMESTAMP
-#define CTF_EVENT(...)                                                         \
+#define CTF_EVENT_EMIT(emit, ...)                                              \
 	{                                                                      \
 		const uint32_t tstamp = k_cyc_to_ns_floor64(k_cycle_get_32()); \
 									       \
-		CTF_GATHER_FIELDS(tstamp, __VA_ARGS__)                         \
+		CTF_GATHER_FIELDS_EMIT(emit, tstamp, __VA_ARGS__)              \
 	}
 #else
-#define CTF_EVENT(...)                                                         \
+#define CTF_EVENT_EMIT(emit, ...)                                              \
 	{                                                                      \
-		CTF_GATHER_FIELDS(__VA_ARGS__)                                 \
+		CTF_GATHER_FIELDS_EMIT(emit, __VA_ARGS__)                      \
 	}
 #endif
 
+#define CTF_EVENT(...) CTF_EVENT_EMIT(tracing_format_raw_data, __VA_ARGS__)
+
 /* Anonymous compound literal with 1 member. Legal since C99.
  * This permits us to take the address of literals, like so:
  *  &CTF_LITERAL(int, 1234)
@@ -102,7 +109,9 @@ typedef enum {
 	CTF_EVENT_TIMER_STOP = 0x30,
 	CTF_EVENT_TIMER_STATUS_SYNC_ENTER = 0x31,
 	CTF_EVENT_TIMER_STATUS_SYNC_BLOCKING = 0x32,
-	CTF_EVENT_TIMER_STATUS_SYNC_EXIT = 0x33
+	CTF_EVENT_TIMER_STATUS_SYNC_EXIT = 0x33,
+	CTF_EVENT_PACKETS_DROPPED = 0x34,
+	CTF_EVENT_LATENCY_BUCKET = 0x35
 
 } ctf_event_t;
 
@@ -328,5 +337,21 @@ static inline void ctf_top_timer_status_sync_exit(uint32_t timer, uint32_t resul
 	CTF_EVENT(CTF_LITERAL(uint8_t, CTF_EVENT_TIMER_STATUS_SYNC_EXIT), timer, result);
 }
 
+static inline void ctf_top_latency_bucket(uint8_t type, uint32_t id,
+					  uint32_t start, uint32_t count)
+{
+	CTF_EVENT(CTF_LITERAL(uint8_t, CTF_EVENT_LATENCY_BUCKET), type, id, start,
+		  count);
+}
+
+/* Emitted by the tracing thread. tracing_format_raw_data() ignores the events
+ * of that thread, so the event is given to the backend directly.
+ */
+static inline void ctf_top_packets_dropped(uint32_t count)
+{
+	CTF_EVENT_EMIT(tracing_buffer_handle,
+		       CTF_LITERAL(uint8_t, CTF_EVENT_PACKETS_DROPPED), count);
+}
+
 
 #endif /* SUBSYS_DEBUG_TRACING_CTF_TOP_H */
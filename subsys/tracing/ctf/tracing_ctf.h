@@ -347,6 +347,9 @@ extern "C" {
 #define sys_port_trace_pm_device_runtime_disable_enter(dev)
 #define sys_port_trace_pm_device_runtime_disable_exit(dev, ret)
 
+#define sys_port_trace_k_latency_bucket(type, id, start, count)			\
+	sys_trace_k_latency_bucket(type, id, start, count)
+
 void sys_trace_idle(void);
 void sys_trace_isr_enter(void);
 void sys_trace_isr_exit(void);
@@ -436,6 +439,9 @@ void sys_trace_k_timer_status_sync_exit(struct k_timer *timer, uint32_t result);
 
 void sys_trace_k_event_init(struct k_event *event);
 
+void sys_trace_k_latency_bucket(uint32_t type, const void *id, uint32_t start,
+				uint32_t count);
+
 #ifdef __cplusplus
 }
 #endif
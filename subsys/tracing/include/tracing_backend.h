@@ -31,6 +31,12 @@ struct tracing_backend_api {
 	void (*init)(void);
 	void (*output)(const struct tracing_backend *backend,
 		       uint8_t *data, uint32_t length);
+	/* Optional, write out the data kept by the backend. */
+	void (*flush)(const struct tracing_backend *backend);
+	/* Optional, write out the data kept by the backend before the
+	 * system halts. Called from the fatal error handler.
+	 */
+	void (*panic)(const struct tracing_backend *backend);
 };
 
 /**
@@ -82,6 +88,34 @@ static inline void tracing_backend_output(
 	}
 }
 
+/**
+ * @brief Flush the data kept by tracing backend.
+ *
+ * Called by the tracing thread when no more tracing data is coming.
+ *
+ * @param backend Pointer to tracing_backend instance.
+ */
+static inline void tracing_backend_flush(
+		const struct tracing_backend *backend)
+{
+	if (backend && backend->api && backend->api->flush) {
+		backend->api->flush(backend);
+	}
+}
+
+/**
+ * @brief Put tracing backend in panic mode.
+ *
+ * @param backend Pointer to tracing_backend instance.
+ */
+static inline void tracing_backend_panic(
+		const struct tracing_backend *backend)
+{
+	if (backend && backend->api && backend->api->panic) {
+		backend->api->panic(backend);
+	}
+}
+
 /**
  * @brief Get tracing backend based on the name of
  *        tracing backend in tracing backend section.
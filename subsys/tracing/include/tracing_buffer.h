@@ -80,7 +80,8 @@ uint32_t tracing_buffer_put(uint8_t *data, uint32_t size);
  * @param size Requested buffer size (in bytes).
  *
  * @return Size of valid buffer which can be smaller than requested
- *         if there isn't enough valid data or buffer wraps.
+ *         if there isn't enough valid data, buffer wraps or a packet
+ *         boundary is reached.
  */
 uint32_t tracing_buffer_get_claim(uint8_t **data, uint32_t size);
 
@@ -104,6 +105,20 @@ int tracing_buffer_get_finish(uint32_t size);
  */
 uint32_t tracing_buffer_get(uint8_t *data, uint32_t size);
 
+/**
+ * @brief Check if reading ends on a packet boundary.
+ *
+ * Reading ends on a packet boundary once the data that was present in the
+ * buffer when it started is read. With per CPU buffers, the buffers are
+ * read one after the other, from one boundary to the next.
+ *
+ * @param size Number of claimed bytes not finished yet, if any.
+ *
+ * @return true if the data read so far and the @p size claimed bytes end on
+ *         a packet boundary, or false if not.
+ */
+bool tracing_buffer_get_at_boundary(uint32_t size);
+
 /**
  * @brief Get buffer from tracing command buffer.
  *
@@ -14,9 +14,18 @@
 extern "C" {
 #endif
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+/* Each CPU only writes its own buffer, locking the local interrupts is
+ * enough and CPUs do not contend on the global lock.
+ */
+#define TRACING_LOCK()		{ unsigned int key; key = arch_irq_lock()
+
+#define TRACING_UNLOCK()	{ arch_irq_unlock(key); } }
+#else
 #define TRACING_LOCK()		{ int key; key = irq_lock()
 
 #define TRACING_UNLOCK()	{ irq_unlock(key); } }
+#endif
 
 /**
  * @brief Check tracing enabled or not.
@@ -38,6 +47,18 @@ void tracing_buffer_handle(uint8_t *data, uint32_t length);
  */
 void tracing_packet_drop_handle(void);
 
+/**
+ * @brief Report dropped packets.
+ *
+ * Called from the tracing thread, on a packet boundary, with the number of
+ * packets dropped since the previous report. The tracing format outputs an
+ * event with the count using tracing_buffer_handle(). Does nothing unless
+ * implemented by the tracing format.
+ *
+ * @param count Number of dropped packets.
+ */
+void tracing_packet_drop_report(uint32_t count);
+
 /**
  * @brief Handle tracing command.
  *
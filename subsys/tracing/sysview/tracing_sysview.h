@@ -661,6 +661,8 @@ void sys_trace_k_thread_info(struct k_thread *thread);
 	SEGGER_SYSVIEW_RecordEndCallU32(TID_PM_DEVICE_RUNTIME_DISABLE,	       \
 					(uint32_t)ret)
 
+#define sys_port_trace_k_latency_bucket(type, id, start, count)
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,215 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <tracing_core.h>
+#include <tracing_backend.h>
+#include <tracing_buffer.h>
+
+#define MAX_PATH_LEN 256
+#define FILE_PREFIX CONFIG_TRACING_BACKEND_FS_FILE_PREFIX
+#define FILE_PREFIX_LEN (sizeof(FILE_PREFIX) - 1)
+#define MAX_FILE_NUMERAL 10000
+
+enum backend_fs_state {
+	BACKEND_FS_NOT_INITIALIZED = 0,
+	BACKEND_FS_CORRUPTED,
+	BACKEND_FS_OK
+};
+
+static enum backend_fs_state backend_state;
+static struct fs_file_t file;
+/* Number of the current chunk, chunks older than the last
+ * CONFIG_TRACING_BACKEND_FS_FILES_LIMIT ones are deleted.
+ */
+static uint32_t chunk_num;
+static size_t chunk_size;
+/* Data written to the current chunk since it was last synced. */
+static size_t unsynced;
+/* Taken without waiting in panic, the chunk may be in use by the tracing
+ * thread.
+ */
+static K_MUTEX_DEFINE(file_lock);
+
+static void chunk_name_get(char *name, uint32_t num)
+{
+	snprintf(name, MAX_PATH_LEN, "%s/%s%04u", CONFIG_TRACING_BACKEND_FS_DIR,
+		 FILE_PREFIX, (unsigned int)(num % MAX_FILE_NUMERAL));
+}
+
+/* Remove the chunks of a previous trace. */
+static int chunks_remove(void)
+{
+	struct fs_dir_t dir;
+	struct fs_dirent ent;
+	char name[MAX_PATH_LEN];
+	int rc;
+
+	fs_dir_t_init(&dir);
+
+	rc = fs_opendir(&dir, CONFIG_TRACING_BACKEND_FS_DIR);
+	if (rc < 0) {
+		return rc;
+	}
+
+	while (true) {
+		rc = fs_readdir(&dir, &ent);
+		if ((rc < 0) || (ent.name[0] == 0)) {
+			break;
+		}
+
+		if ((ent.type == FS_DIR_ENTRY_FILE) &&
+		    (strncmp(ent.name, FILE_PREFIX, FILE_PREFIX_LEN) == 0)) {
+			snprintf(name, sizeof(name), "%s/%s",
+				 CONFIG_TRACING_BACKEND_FS_DIR, ent.name);
+			(void)fs_unlink(name);
+		}
+	}
+
+	(void)fs_closedir(&dir);
+
+	return rc;
+}
+
+static int chunk_open(void)
+{
+	char name[MAX_PATH_LEN];
+	int rc;
+
+	if (chunk_num >= CONFIG_TRACING_BACKEND_FS_FILES_LIMIT) {
+		chunk_name_get(name, chunk_num - CONFIG_TRACING_BACKEND_FS_FILES_LIMIT);
+		rc = fs_unlink(name);
+		if ((rc < 0) && (rc != -ENOENT)) {
+			return rc;
+		}
+	}
+
+	chunk_name_get(name, chunk_num);
+	rc = fs_open(&file, name, FS_O_CREATE | FS_O_WRITE);
+	if (rc < 0) {
+		return rc;
+	}
+
+	chunk_size = 0;
+	unsynced = 0;
+
+	return fs_truncate(&file, 0);
+}
+
+static int chunk_next(void)
+{
+	int rc = fs_close(&file);
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	chunk_num++;
+
+	return chunk_open();
+}
+
+/* Must be called with file_lock locked. */
+static void chunk_sync(void)
+{
+	if ((backend_state != BACKEND_FS_OK) || (unsynced == 0)) {
+		return;
+	}
+
+	if (fs_sync(&file) < 0) {
+		backend_state = BACKEND_FS_CORRUPTED;
+		return;
+	}
+
+	unsynced = 0;
+}
+
+static void tracing_backend_fs_output(
+		const struct tracing_backend *backend,
+		uint8_t *data, uint32_t length)
+{
+	ssize_t written;
+	int rc;
+
+	k_mutex_lock(&file_lock, K_FOREVER);
+
+	if (backend_state == BACKEND_FS_NOT_INITIALIZED) {
+		/* The file system may not be mounted yet, data is dropped
+		 * until it is.
+		 */
+		if (chunks_remove() < 0) {
+			goto out;
+		}
+
+		rc = chunk_open();
+		backend_state = (rc < 0) ? BACKEND_FS_CORRUPTED : BACKEND_FS_OK;
+	}
+
+	if (backend_state != BACKEND_FS_OK) {
+		goto out;
+	}
+
+	written = fs_write(&file, data, length);
+	if (written != (ssize_t)length) {
+		backend_state = BACKEND_FS_CORRUPTED;
+		goto out;
+	}
+
+	chunk_size += written;
+	unsynced += written;
+
+	/* Chunks end on packet boundaries so that each of them can be
+	 * decoded, they may exceed the size by up to a tracing buffer.
+	 * Closing a chunk syncs it.
+	 */
+	if ((chunk_size >= CONFIG_TRACING_BACKEND_FS_FILE_SIZE) &&
+	    tracing_buffer_get_at_boundary(length)) {
+		if (chunk_next() < 0) {
+			backend_state = BACKEND_FS_CORRUPTED;
+		}
+	} else if (unsynced >= CONFIG_TRACING_BACKEND_FS_SYNC_SIZE) {
+		chunk_sync();
+	}
+
+out:
+	k_mutex_unlock(&file_lock);
+}
+
+static void tracing_backend_fs_flush(const struct tracing_backend *backend)
+{
+	k_mutex_lock(&file_lock, K_FOREVER);
+	chunk_sync();
+	k_mutex_unlock(&file_lock);
+}
+
+static void tracing_backend_fs_panic(const struct tracing_backend *backend)
+{
+	/* The file system can not be used from an ISR, nor while the
+	 * tracing thread is writing to it, or after it failed doing so.
+	 */
+	if (k_is_in_isr() || is_tracing_thread() ||
+	    (k_mutex_lock(&file_lock, K_NO_WAIT) != 0)) {
+		return;
+	}
+
+	chunk_sync();
+	k_mutex_unlock(&file_lock);
+}
+
+static void tracing_backend_fs_init(void)
+{
+	fs_file_t_init(&file);
+}
+
+const struct tracing_backend_api tracing_backend_fs_api = {
+	.init = tracing_backend_fs_init,
+	.output  = tracing_backend_fs_output,
+	.flush = tracing_backend_fs_flush,
+	.panic = tracing_backend_fs_panic
+};
+
+TRACING_BACKEND_DEFINE(tracing_backend_fs, tracing_backend_fs_api);
@@ -4,12 +4,40 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
+#include <zephyr/kernel.h>
 #include <zephyr/sys/ring_buffer.h>
+#include <tracing_buffer.h>
 
-static struct ring_buf tracing_ring_buf;
-static uint8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+#define TRACING_BUFFER_CNT CONFIG_MP_MAX_NUM_CPUS
+#else
+#define TRACING_BUFFER_CNT 1
+#endif
+
+static struct ring_buf tracing_ring_buf[TRACING_BUFFER_CNT];
+static uint8_t tracing_buffer[TRACING_BUFFER_CNT][CONFIG_TRACING_BUFFER_SIZE + 1];
 static uint8_t tracing_cmd_buffer[CONFIG_TRACING_CMD_BUFFER_SIZE];
 
+/* Buffer being read and amount of data to read from it before the next
+ * packet boundary. Packets are put whole, so the data present in a buffer
+ * when reading starts ends on a packet boundary.
+ */
+static uint32_t get_idx;
+static uint32_t get_remaining;
+
+/* Buffer written by the current CPU. Called with interrupts locked so that
+ * the thread stays on the CPU.
+ */
+static inline struct ring_buf *put_buf(void)
+{
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+	return &tracing_ring_buf[arch_curr_cpu()->id];
+#else
+	return &tracing_ring_buf[0];
+#endif
+}
+
 uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
 {
 	*data = &tracing_cmd_buffer[0];
@@ -19,51 +47,104 @@ uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
 
 uint32_t tracing_buffer_put_claim(uint8_t **data, uint32_t size)
 {
-	return ring_buf_put_claim(&tracing_ring_buf, data, size);
+	return ring_buf_put_claim(put_buf(), data, size);
 }
 
 int tracing_buffer_put_finish(uint32_t size)
 {
-	return ring_buf_put_finish(&tracing_ring_buf, size);
+	return ring_buf_put_finish(put_buf(), size);
 }
 
 uint32_t tracing_buffer_put(uint8_t *data, uint32_t size)
 {
-	return ring_buf_put(&tracing_ring_buf, data, size);
+	return ring_buf_put(put_buf(), data, size);
 }
 
 uint32_t tracing_buffer_get_claim(uint8_t **data, uint32_t size)
 {
-	return ring_buf_get_claim(&tracing_ring_buf, data, size);
+	if (get_remaining == 0) {
+		/* Continue with the next buffer holding data, so that no CPU
+		 * is starved.
+		 */
+		for (uint32_t i = 1; i <= TRACING_BUFFER_CNT; i++) {
+			uint32_t idx = (get_idx + i) % TRACING_BUFFER_CNT;
+
+			get_remaining = ring_buf_size_get(&tracing_ring_buf[idx]);
+			if (get_remaining > 0) {
+				get_idx = idx;
+				break;
+			}
+		}
+	}
+
+	return ring_buf_get_claim(&tracing_ring_buf[get_idx], data,
+				  MIN(size, get_remaining));
 }
 
 int tracing_buffer_get_finish(uint32_t size)
 {
-	return ring_buf_get_finish(&tracing_ring_buf, size);
+	int err = ring_buf_get_finish(&tracing_ring_buf[get_idx], size);
+
+	if (err == 0) {
+		get_remaining -= MIN(size, get_remaining);
+	}
+
+	return err;
 }
 
 uint32_t tracing_buffer_get(uint8_t *data, uint32_t size)
 {
-	return ring_buf_get(&tracing_ring_buf, data, size);
+	uint32_t total = 0;
+
+	while (total < size) {
+		uint8_t *src;
+		uint32_t len = tracing_buffer_get_claim(&src, size - total);
+
+		if (len == 0) {
+			break;
+		}
+
+		memcpy(&data[total], src, len);
+		(void)tracing_buffer_get_finish(len);
+		total += len;
+	}
+
+	return total;
+}
+
+bool tracing_buffer_get_at_boundary(uint32_t size)
+{
+	return get_remaining == size;
 }
 
 void tracing_buffer_init(void)
 {
-	ring_buf_init(&tracing_ring_buf,
-		      sizeof(tracing_buffer), tracing_buffer);
+	for (int i = 0; i < TRACING_BUFFER_CNT; i++) {
+		ring_buf_init(&tracing_ring_buf[i],
+			      sizeof(tracing_buffer[i]), tracing_buffer[i]);
+	}
+
+	get_idx = 0;
+	get_remaining = 0;
 }
 
 bool tracing_buffer_is_empty(void)
 {
-	return ring_buf_is_empty(&tracing_ring_buf);
+	for (int i = 0; i < TRACING_BUFFER_CNT; i++) {
+		if (!ring_buf_is_empty(&tracing_ring_buf[i])) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
 uint32_t tracing_buffer_capacity_get(void)
 {
-	return ring_buf_capacity_get(&tracing_ring_buf);
+	return ring_buf_capacity_get(&tracing_ring_buf[0]);
 }
 
 uint32_t tracing_buffer_space_get(void)
 {
-	return ring_buf_space_get(&tracing_ring_buf);
+	return ring_buf_space_get(put_buf());
 }
@@ -29,6 +29,8 @@
 #define TRACING_BACKEND_NAME "tracing_backend_posix"
 #elif defined CONFIG_TRACING_BACKEND_RAM
 #define TRACING_BACKEND_NAME "tracing_backend_ram"
+#elif defined CONFIG_TRACING_BACKEND_FS
+#define TRACING_BACKEND_NAME "tracing_backend_fs"
 #else
 #define TRACING_BACKEND_NAME ""
 #endif
@@ -56,6 +58,7 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 {
 	uint8_t *transferring_buf;
 	uint32_t transferring_length, tracing_buffer_max_length;
+	bool flushed = true;
 
 	tracing_thread_tid = k_current_get();
 
@@ -63,8 +66,18 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 
 	while (true) {
 		if (tracing_buffer_is_empty()) {
-			k_sem_take(&tracing_thread_sem, K_FOREVER);
+			/* Once no more data comes, let the backend write out
+			 * what it keeps.
+			 */
+			if (flushed) {
+				k_sem_take(&tracing_thread_sem, K_FOREVER);
+			} else if (k_sem_take(&tracing_thread_sem,
+				   K_MSEC(CONFIG_TRACING_THREAD_FLUSH_TIMEOUT)) != 0) {
+				tracing_backend_flush(working_backend);
+				flushed = true;
+			}
 		} else {
+			flushed = false;
 			transferring_length =
 				tracing_buffer_get_claim(
 						&transferring_buf,
@@ -72,6 +85,14 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 			tracing_buffer_handle(transferring_buf,
 					      transferring_length);
 			tracing_buffer_get_finish(transferring_length);
+
+			if (tracing_buffer_get_at_boundary(0)) {
+				uint32_t dropped = atomic_set(&tracing_packet_drop_num, 0);
+
+				if (dropped > 0) {
+					tracing_packet_drop_report(dropped);
+				}
+			}
 		}
 	}
 }
@@ -158,3 +179,14 @@ void tracing_packet_drop_handle(void)
 {
 	atomic_inc(&tracing_packet_drop_num);
 }
+
+void tracing_panic(void)
+{
+	tracing_set_state(TRACING_DISABLE);
+	tracing_backend_panic(working_backend);
+}
+
+void __weak tracing_packet_drop_report(uint32_t count)
+{
+	ARG_UNUSED(count);
+}
@@ -340,6 +340,8 @@ void sys_trace_idle(void);
 #define sys_port_trace_pm_device_runtime_disable_enter(dev)
 #define sys_port_trace_pm_device_runtime_disable_exit(dev, ret)
 
+#define sys_port_trace_k_latency_bucket(type, id, start, count)
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the throughput of 4 KiB reads and writes spread over a disk, done
+ * one at a time with the synchronous disk access API and with several
+ * requests in flight with the asynchronous one. Runs on a RAM disk on
+ * native_posix and on an NVMe disk on qemu_x86_64.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/random/rand32.h>
+#include <zephyr/storage/disk_access.h>
+
+#if defined(CONFIG_NVME)
+#define DISK_NAME	"nvme0n0"
+#else
+#define DISK_NAME	CONFIG_DISK_RAM_VOLUME_NAME
+#endif
+
+#define SECTOR_SIZE	512
+#define BLOCK_SECTORS	8
+#define MAX_DEPTH	16
+#define AREA_SECTORS	(256 * 1024 / SECTOR_SIZE)
+#define BLOCK_COUNT	(AREA_SECTORS / BLOCK_SECTORS)
+
+static const size_t depths[] = { 1, 4, MAX_DEPTH };
+
+static uint8_t bufs[MAX_DEPTH][BLOCK_SECTORS * SECTOR_SIZE] __aligned(32);
+static struct disk_access_buf req_bufs[MAX_DEPTH][2];
+static struct disk_access_req reqs[MAX_DEPTH];
+static uint32_t blocks[BLOCK_COUNT];
+
+static uint32_t start;
+
+static void timer_start(void)
+{
+	start = k_cycle_get_32();
+}
+
+/* Returns the throughput in KiB per second since timer_start() */
+static uint32_t timer_kib_per_s(uint32_t bytes)
+{
+	uint64_t us = k_cyc_to_us_floor64(k_cycle_get_32() - start);
+
+	return (uint32_t)((uint64_t)bytes * USEC_PER_SEC / 1024 / MAX(us, 1));
+}
+
+static uint32_t bench_sync(bool write)
+{
+	int rc;
+
+	timer_start();
+	for (size_t i = 0; i < BLOCK_COUNT; i++) {
+		if (write) {
+			rc = disk_access_write(DISK_NAME, bufs[0], blocks[i],
+					       BLOCK_SECTORS);
+		} else {
+			rc = disk_access_read(DISK_NAME, bufs[0], blocks[i],
+					      BLOCK_SECTORS);
+		}
+		zassert_equal(rc, 0, "Disk access failed");
+	}
+
+	return timer_kib_per_s(AREA_SECTORS * SECTOR_SIZE);
+}
+
+/* Requests of two buffers, each with half of a block */
+static uint32_t bench_async(struct disk_info *disk, bool write, size_t depth)
+{
+	int rc;
+
+	timer_start();
+	for (size_t i = 0; i < BLOCK_COUNT; i += depth) {
+		for (size_t j = 0; j < depth; j++) {
+			reqs[j] = (struct disk_access_req) {
+				.op = write ? DISK_ACCESS_OP_WRITE :
+					      DISK_ACCESS_OP_READ,
+				.start_sector = blocks[i + j],
+				.bufs = req_bufs[j],
+				.num_bufs = ARRAY_SIZE(req_bufs[j]),
+			};
+		}
+
+		rc = disk_access_submit(disk, reqs, depth);
+		zassert_equal(rc, 0, "Submit failed");
+
+		for (size_t j = 0; j < depth; j++) {
+			rc = disk_access_wait(&reqs[j], K_FOREVER);
+			zassert_equal(rc, 0, "Disk access failed");
+		}
+	}
+
+	return timer_kib_per_s(AREA_SECTORS * SECTOR_SIZE);
+}
+
+ZTEST(disk_async_perf, test_throughput)
+{
+	struct disk_info *disk = disk_access_get(DISK_NAME);
+	uint32_t write_kib_s;
+	uint32_t read_kib_s;
+
+	zassert_not_null(disk, "Disk %s not found", DISK_NAME);
+
+	TC_PRINT("4 KiB accesses on %s, disk cache %s\n", DISK_NAME,
+		 IS_ENABLED(CONFIG_DISK_CACHE) ? "enabled" : "disabled");
+	TC_PRINT("%-8s %12s %12s\n", "depth", "write(KiB/s)", "read(KiB/s)");
+
+	write_kib_s = bench_sync(true);
+	read_kib_s = bench_sync(false);
+	TC_PRINT("%-8s %12u %12u\n", "sync", write_kib_s, read_kib_s);
+
+	for (size_t i = 0; i < ARRAY_SIZE(depths); i++) {
+		write_kib_s = bench_async(disk, true, depths[i]);
+		read_kib_s = bench_async(disk, false, depths[i]);
+		TC_PRINT("%-8zu %12u %12u\n", depths[i], write_kib_s,
+			 read_kib_s);
+	}
+}
+
+static void *disk_async_perf_setup(void)
+{
+	uint32_t sector_count;
+	uint32_t sector_size;
+	int rc;
+
+	rc = disk_access_init(DISK_NAME);
+	zassert_equal(rc, 0, "Can't init disk %s", DISK_NAME);
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_COUNT,
+			       &sector_count);
+	zassert_equal(rc, 0, "Can't get sector count");
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_SIZE,
+			       &sector_size);
+	zassert_equal(rc, 0, "Can't get sector size");
+	zassert_equal(sector_size, SECTOR_SIZE, "Unexpected sector size");
+	zassert_true(sector_count >= AREA_SECTORS, "Disk too small");
+
+	/* Each block of the area once, in random order */
+	for (size_t i = 0; i < BLOCK_COUNT; i++) {
+		blocks[i] = i * BLOCK_SECTORS;
+	}
+
+	for (size_t i = BLOCK_COUNT - 1; i > 0; i--) {
+		size_t j = sys_rand32_get() % (i + 1);
+		uint32_t tmp = blocks[i];
+
+		blocks[i] = blocks[j];
+		blocks[j] = tmp;
+	}
+
+	for (size_t i = 0; i < MAX_DEPTH; i++) {
+		req_bufs[i][0].data = bufs[i];
+		req_bufs[i][0].num_sector = BLOCK_SECTORS / 2;
+		req_bufs[i][1].data = bufs[i] + BLOCK_SECTORS / 2 * SECTOR_SIZE;
+		req_bufs[i][1].num_sector = BLOCK_SECTORS / 2;
+	}
+
+	return NULL;
+}
+
+ZTEST_SUITE(disk_async_perf, NULL, disk_async_perf_setup, NULL, NULL, NULL);
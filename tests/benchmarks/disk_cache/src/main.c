@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the throughput of small sequential reads and writes of a file,
+ * on FAT on a RAM disk and on a flash disk on the flash simulator, with
+ * and without the disk cache.
+ */
+
+#include <stdio.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <ff.h>
+
+#define FILE_SIZE	(32 * 1024)
+#define SYNC_SIZE	(4 * 1024)
+
+static const size_t chunk_sizes[] = { 16, 64, 256 };
+
+static FATFS ram_fat_fs;
+static struct fs_mount_t ram_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = "/RAM:",
+	.fs_data = &ram_fat_fs,
+};
+
+static FATFS flash_fat_fs;
+static struct fs_mount_t flash_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = "/NAND:",
+	.fs_data = &flash_fat_fs,
+};
+
+static uint8_t chunk[256];
+
+static uint32_t start;
+
+static void timer_start(void)
+{
+	start = k_cycle_get_32();
+}
+
+/* Returns the throughput in KiB per second since timer_start() */
+static uint32_t timer_kib_per_s(uint32_t bytes)
+{
+	uint64_t us = k_cyc_to_us_floor64(k_cycle_get_32() - start);
+
+	return (uint32_t)((uint64_t)bytes * USEC_PER_SEC / 1024 / MAX(us, 1));
+}
+
+static void bench_file(struct fs_mount_t *mp, size_t chunk_size)
+{
+	struct fs_file_t file;
+	char path[32];
+	uint32_t write_kib_s;
+	uint32_t read_kib_s;
+	ssize_t len;
+	int rc;
+
+	fs_file_t_init(&file);
+	snprintf(path, sizeof(path), "%s/BENCH.BIN", mp->mnt_point);
+
+	rc = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+	zassert_equal(rc, 0, "Can't create %s", path);
+
+	/* Data logger like writes, synchronized now and then */
+	timer_start();
+	for (size_t off = 0; off < FILE_SIZE; off += chunk_size) {
+		len = fs_write(&file, chunk, chunk_size);
+		zassert_equal(len, chunk_size, "Can't write %s", path);
+
+		if (((off + chunk_size) % SYNC_SIZE) == 0) {
+			rc = fs_sync(&file);
+			zassert_equal(rc, 0, "Can't sync %s", path);
+		}
+	}
+	rc = fs_close(&file);
+	write_kib_s = timer_kib_per_s(FILE_SIZE);
+	zassert_equal(rc, 0, "Can't close %s", path);
+
+	rc = fs_open(&file, path, FS_O_READ);
+	zassert_equal(rc, 0, "Can't open %s", path);
+
+	timer_start();
+	for (size_t off = 0; off < FILE_SIZE; off += chunk_size) {
+		len = fs_read(&file, chunk, chunk_size);
+		zassert_equal(len, chunk_size, "Can't read %s", path);
+	}
+	read_kib_s = timer_kib_per_s(FILE_SIZE);
+
+	rc = fs_close(&file);
+	zassert_equal(rc, 0, "Can't close %s", path);
+	rc = fs_unlink(path);
+	zassert_equal(rc, 0, "Can't delete %s", path);
+
+	TC_PRINT("%-8s %8zu %12u %12u\n", mp->mnt_point, chunk_size,
+		 write_kib_s, read_kib_s);
+}
+
+ZTEST(disk_cache_perf, test_sequential_io)
+{
+	struct fs_mount_t *mounts[] = { &ram_mnt, &flash_mnt };
+	int rc;
+
+	TC_PRINT("Small sequential I/O, disk cache %s\n",
+		 !IS_ENABLED(CONFIG_DISK_CACHE) ? "disabled" :
+		 IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK) ? "write-back" :
+		 "write-through");
+	TC_PRINT("%-8s %8s %12s %12s\n", "mount", "chunk", "write(KiB/s)",
+		 "read(KiB/s)");
+
+	for (size_t i = 0; i < ARRAY_SIZE(mounts); i++) {
+		/* The volumes are formatted when mounted the first time */
+		rc = fs_mount(mounts[i]);
+		zassert_equal(rc, 0, "Can't mount %s", mounts[i]->mnt_point);
+
+		for (size_t j = 0; j < ARRAY_SIZE(chunk_sizes); j++) {
+			bench_file(mounts[i], chunk_sizes[j]);
+		}
+
+		rc = fs_unmount(mounts[i]);
+		zassert_equal(rc, 0, "Can't unmount %s", mounts[i]->mnt_point);
+	}
+}
+
+ZTEST_SUITE(disk_cache_perf, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,170 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the rate at which small records are appended to an FCB, one by one
+ * and in batches, and the rate at which they are walked afterwards.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(storage_partition)
+#define SECTOR_CNT_MAX		16
+/* Fits in the 16 KiB storage partition of native_posix */
+#define RECORD_CNT		96
+#define BATCH_CNT		16
+
+static const uint16_t record_sizes[] = { 8, 32, 128 };
+
+static struct flash_sector fcb_sectors[SECTOR_CNT_MAX];
+#ifdef CONFIG_FCB_INDEX
+static struct fcb_index_entry fcb_index[128];
+#endif
+static struct fcb fcb;
+
+static uint8_t record[128];
+static uint32_t walked;
+
+/* Initialize the FCB from the flash contents, erased first if requested */
+static void fcb_setup(bool erase)
+{
+	const struct flash_area *fap;
+	uint32_t cnt = ARRAY_SIZE(fcb_sectors);
+	int rc;
+
+	rc = flash_area_open(TEST_PARTITION_ID, &fap);
+	zassert_equal(rc, 0, "Can't open storage flash area");
+	if (erase) {
+		rc = flash_area_erase(fap, 0, fap->fa_size);
+		zassert_equal(rc, 0, "Can't erase storage flash area");
+	}
+	(void)memset(&fcb, 0, sizeof(fcb));
+	fcb.f_erase_value = flash_area_erased_val(fap);
+	flash_area_close(fap);
+
+	rc = flash_area_get_sectors(TEST_PARTITION_ID, &cnt, fcb_sectors);
+	zassert_true(rc == 0 || rc == -ENOMEM, "Can't get flash sectors");
+
+	fcb.f_magic = 0x12345678;
+	fcb.f_sectors = fcb_sectors;
+	fcb.f_sector_cnt = cnt;
+#ifdef CONFIG_FCB_INDEX
+	fcb.f_index = fcb_index;
+	fcb.f_index_cnt = ARRAY_SIZE(fcb_index);
+#endif
+
+	rc = fcb_init(TEST_PARTITION_ID, &fcb);
+	zassert_equal(rc, 0, "Can't initialize FCB");
+}
+
+/* Returns the rate in records per second of count records in cycles */
+static uint32_t records_per_s(uint32_t count, uint32_t cycles)
+{
+	uint64_t us = k_cyc_to_us_floor64(cycles);
+
+	return (uint32_t)((uint64_t)count * USEC_PER_SEC / MAX(us, 1));
+}
+
+static uint32_t append_single(uint16_t size)
+{
+	struct fcb_entry loc;
+	uint32_t start;
+	int rc;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < RECORD_CNT; i++) {
+		rc = fcb_append(&fcb, size, &loc);
+		zassert_equal(rc, 0, "Can't append record %u", i);
+		rc = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc),
+				      record, size);
+		zassert_equal(rc, 0, "Can't write record %u", i);
+		rc = fcb_append_finish(&fcb, &loc);
+		zassert_equal(rc, 0, "Can't finish record %u", i);
+	}
+
+	return records_per_s(RECORD_CNT, k_cycle_get_32() - start);
+}
+
+static uint32_t append_batch(uint16_t size)
+{
+	const void *data[BATCH_CNT];
+	uint16_t lens[BATCH_CNT];
+	uint32_t start;
+	int rc;
+
+	for (uint32_t i = 0; i < BATCH_CNT; i++) {
+		data[i] = record;
+		lens[i] = size;
+	}
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < RECORD_CNT; i += BATCH_CNT) {
+		rc = fcb_append_batch(&fcb, data, lens, BATCH_CNT);
+		zassert_equal(rc, 0, "Can't append batch at record %u", i);
+	}
+
+	return records_per_s(RECORD_CNT, k_cycle_get_32() - start);
+}
+
+static int walk_cb(struct fcb_entry_ctx *entry_ctx, void *arg)
+{
+	walked++;
+
+	return 0;
+}
+
+static uint32_t walk(void)
+{
+	uint32_t start;
+	int rc;
+
+	walked = 0;
+
+	start = k_cycle_get_32();
+	rc = fcb_walk(&fcb, NULL, walk_cb, NULL);
+	zassert_equal(rc, 0, "Can't walk FCB");
+
+	return records_per_s(walked, k_cycle_get_32() - start);
+}
+
+ZTEST(fcb_append_perf, test_append_walk)
+{
+	uint32_t single_rps;
+	uint32_t batch_rps;
+	uint32_t walk_rps;
+	uint32_t rewalk_rps;
+
+	for (size_t i = 0; i < sizeof(record); i++) {
+		record[i] = i;
+	}
+
+	TC_PRINT("FCB append and walk, entry index %s\n",
+		 IS_ENABLED(CONFIG_FCB_INDEX) ? "enabled" : "disabled");
+	TC_PRINT("%6s %12s %12s %12s %12s\n", "size", "single(r/s)",
+		 "batch(r/s)", "walk(r/s)", "rewalk(r/s)");
+
+	for (size_t i = 0; i < ARRAY_SIZE(record_sizes); i++) {
+		uint16_t size = record_sizes[i];
+
+		fcb_setup(true);
+		single_rps = append_single(size);
+
+		fcb_setup(true);
+		batch_rps = append_batch(size);
+
+		/* After init, only the records of the newest sector are indexed */
+		fcb_setup(false);
+		walk_rps = walk();
+		zassert_equal(walked, RECORD_CNT, "Walked %u records of %u",
+			      walked, RECORD_CNT);
+		rewalk_rps = walk();
+
+		TC_PRINT("%6u %12u %12u %12u %12u\n", size, single_rps,
+			 batch_rps, walk_rps, rewalk_rps);
+	}
+}
+
+ZTEST_SUITE(fcb_append_perf, NULL, NULL, NULL, NULL, NULL);
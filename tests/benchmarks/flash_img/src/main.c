@@ -0,0 +1,111 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the throughput of writing an image to the secondary slot with the
+ * flash image API, as a DFU transport would: chunks arrive after a given
+ * link time and are handed to flash_img_buffered_write(). Flash operations
+ * take time on the flash simulator, so writes hold up the reception of the
+ * next chunk unless they are done in the background.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/dfu/flash_img.h>
+#include <zephyr/storage/flash_map.h>
+
+#define SLOT1_PARTITION_ID	FIXED_PARTITION_ID(slot1_partition)
+
+#define IMAGE_SIZE	(64 * 1024)
+#define CHUNK_SIZE	256
+
+static const uint32_t link_times_us[] = { 0, 200, 1000 };
+
+static struct flash_img_context ctx;
+static uint8_t chunk[CHUNK_SIZE];
+static uint8_t read_buf[CHUNK_SIZE];
+
+static uint32_t start;
+
+static void timer_start(void)
+{
+	start = k_cycle_get_32();
+}
+
+/* Returns the throughput in KiB per second since timer_start() */
+static uint32_t timer_kib_per_s(uint32_t bytes)
+{
+	uint64_t us = k_cyc_to_us_floor64(k_cycle_get_32() - start);
+
+	return (uint32_t)((uint64_t)bytes * USEC_PER_SEC / 1024 / MAX(us, 1));
+}
+
+static void fill_chunk(size_t off)
+{
+	for (size_t i = 0; i < CHUNK_SIZE; i++) {
+		chunk[i] = (uint8_t)((off + i) * 7);
+	}
+}
+
+static uint32_t bench_image(uint32_t link_time_us)
+{
+	const struct flash_area *fa;
+	uint32_t kib_s;
+	int rc;
+
+	/* Pages are erased as the image is written, previous data included */
+	rc = flash_img_init(&ctx);
+	zassert_equal(rc, 0, "Can't init image writer");
+
+	timer_start();
+	for (size_t off = 0; off < IMAGE_SIZE; off += CHUNK_SIZE) {
+		if (link_time_us > 0) {
+			k_usleep(link_time_us);
+		}
+
+		fill_chunk(off);
+		rc = flash_img_buffered_write(&ctx, chunk, CHUNK_SIZE,
+					      off + CHUNK_SIZE == IMAGE_SIZE);
+		zassert_equal(rc, 0, "Can't write image at %zu", off);
+	}
+	kib_s = timer_kib_per_s(IMAGE_SIZE);
+
+	zassert_equal(flash_img_bytes_written(&ctx), IMAGE_SIZE,
+		      "Image not fully written");
+
+	rc = flash_area_open(SLOT1_PARTITION_ID, &fa);
+	zassert_equal(rc, 0, "Can't open slot");
+
+	for (size_t off = 0; off < IMAGE_SIZE; off += CHUNK_SIZE) {
+		fill_chunk(off);
+		rc = flash_area_read(fa, off, read_buf, CHUNK_SIZE);
+		zassert_equal(rc, 0, "Can't read slot");
+		zassert_mem_equal(read_buf, chunk, CHUNK_SIZE,
+				  "Bad image data at %zu", off);
+	}
+
+	flash_area_close(fa);
+
+	return kib_s;
+}
+
+ZTEST(flash_img_perf, test_image_write)
+{
+	TC_PRINT("Image write, %u KiB in %u B chunks, %s\n",
+		 IMAGE_SIZE / 1024, CHUNK_SIZE,
+		 !IS_ENABLED(CONFIG_IMG_DOUBLE_BUFFER) ? "single buffer" :
+		 IS_ENABLED(CONFIG_STREAM_FLASH_ERASE_AHEAD) ?
+		 "double buffer, erase-ahead" : "double buffer");
+	TC_PRINT("%12s %16s %16s\n", "link(us)", "link(KiB/s)",
+		 "image(KiB/s)");
+
+	for (size_t i = 0; i < ARRAY_SIZE(link_times_us); i++) {
+		uint32_t link_kib_s = (link_times_us[i] == 0) ? 0 :
+			CHUNK_SIZE * USEC_PER_SEC / 1024 / link_times_us[i];
+
+		TC_PRINT("%12u %16u %16u\n", link_times_us[i], link_kib_s,
+			 bench_image(link_times_us[i]));
+	}
+}
+
+ZTEST_SUITE(flash_img_perf, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,195 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Compare files stored as they are in littlefs with files stored through
+ * the compressed file system layer in the same littlefs partition. Data is
+ * written in small chunks, as a logger would, then read back sequentially
+ * and from random positions. Flash operations take time on the flash
+ * simulator, so writing fewer bytes shows up in the throughput.
+ */
+
+#include <stdio.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/fs/compress_fs.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/random/rand32.h>
+#include <zephyr/sys/byteorder.h>
+
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(slot1_partition)
+
+#define DATA_SIZE	(64 * 1024)
+#define WRITE_CHUNK	64
+#define READ_CHUNK	256
+#define RANDOM_READS	200
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(lfs_data);
+
+static struct fs_mount_t lfs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &lfs_data,
+	.storage_dev = (void *)TEST_PARTITION_ID,
+	.mnt_point = "/lfs",
+};
+
+static struct fs_compress cfs_data = {
+	.backing_dir = "/lfs/z",
+};
+
+static struct fs_mount_t cfs_mnt = {
+	.type = FS_COMPRESS,
+	.fs_data = &cfs_data,
+	.mnt_point = "/cfs",
+};
+
+static uint8_t data[DATA_SIZE];
+static uint8_t read_buf[READ_CHUNK];
+
+static uint32_t start;
+
+static void timer_start(void)
+{
+	start = k_cycle_get_32();
+}
+
+static uint64_t timer_us(void)
+{
+	return MAX(k_cyc_to_us_floor64(k_cycle_get_32() - start), 1);
+}
+
+static uint32_t kib_per_s(uint32_t bytes, uint64_t us)
+{
+	return (uint32_t)((uint64_t)bytes * USEC_PER_SEC / 1024 / us);
+}
+
+/* Lines of a text log, with a running timestamp and varying values */
+static void fill_log(void)
+{
+	size_t len = 0;
+	uint32_t n = 0;
+	char line[64];
+	int rc;
+
+	while (len < DATA_SIZE) {
+		rc = snprintf(line, sizeof(line),
+			      "[%08u] <inf> sensor: temp %d.%02u C, hum %u %%\n",
+			      n * 125, 20 + (n % 7), (n * 13) % 100,
+			      40 + (n % 11));
+		memcpy(&data[len], line, MIN(rc, DATA_SIZE - len));
+		len += rc;
+		n++;
+	}
+}
+
+/* Records of 16-bit samples of a slowly changing signal, with noise */
+static void fill_sensor(void)
+{
+	int16_t value = 1000;
+
+	for (size_t i = 0; i < DATA_SIZE; i += 8) {
+		value += (int16_t)(sys_rand32_get() % 5) - 2;
+		sys_put_le32(i / 8, &data[i]);
+		sys_put_le16(value, &data[i + 4]);
+		sys_put_le16(value / 16, &data[i + 6]);
+	}
+}
+
+static void bench_file(const char *path, const char *stored_path,
+		       const char *label)
+{
+	struct fs_dirent entry;
+	struct fs_file_t file;
+	uint32_t write_kib_s;
+	uint32_t read_kib_s;
+	uint32_t random_rd_s;
+	uint32_t off;
+
+	(void)fs_unlink(path);
+	fs_file_t_init(&file);
+
+	timer_start();
+	zassert_ok(fs_open(&file, path, FS_O_CREATE | FS_O_WRITE));
+	for (size_t i = 0; i < DATA_SIZE; i += WRITE_CHUNK) {
+		zassert_equal(fs_write(&file, &data[i], WRITE_CHUNK),
+			      WRITE_CHUNK);
+	}
+	zassert_ok(fs_close(&file));
+	write_kib_s = kib_per_s(DATA_SIZE, timer_us());
+
+	timer_start();
+	zassert_ok(fs_open(&file, path, FS_O_READ));
+	for (size_t i = 0; i < DATA_SIZE; i += READ_CHUNK) {
+		zassert_equal(fs_read(&file, read_buf, READ_CHUNK), READ_CHUNK);
+		zassert_mem_equal(read_buf, &data[i], READ_CHUNK);
+	}
+	read_kib_s = kib_per_s(DATA_SIZE, timer_us());
+
+	timer_start();
+	for (int i = 0; i < RANDOM_READS; i++) {
+		off = sys_rand32_get() % (DATA_SIZE - WRITE_CHUNK);
+		zassert_ok(fs_seek(&file, off, FS_SEEK_SET));
+		zassert_equal(fs_read(&file, read_buf, WRITE_CHUNK),
+			      WRITE_CHUNK);
+		zassert_mem_equal(read_buf, &data[off], WRITE_CHUNK);
+	}
+	random_rd_s = (uint32_t)((uint64_t)RANDOM_READS * USEC_PER_SEC /
+				 timer_us());
+	zassert_ok(fs_close(&file));
+
+	zassert_ok(fs_stat(stored_path, &entry));
+
+	TC_PRINT("%-12s %10u %10u %12u %10zu %6zu%%\n", label, write_kib_s,
+		 read_kib_s, random_rd_s, entry.size,
+		 entry.size * 100 / DATA_SIZE);
+}
+
+static void bench_data(const char *name)
+{
+	char path[32];
+	char stored_path[32];
+
+	TC_PRINT("%s, %u KiB written in %u B chunks, %u B compressed blocks\n",
+		 name, DATA_SIZE / 1024, WRITE_CHUNK,
+		 CONFIG_FS_COMPRESS_BLOCK_SIZE);
+	TC_PRINT("%-12s %10s %10s %12s %10s %7s\n", "", "wr(KiB/s)",
+		 "rd(KiB/s)", "rand rd(/s)", "stored(B)", "ratio");
+
+	snprintf(path, sizeof(path), "/lfs/%s", name);
+	bench_file(path, path, "littlefs");
+
+	snprintf(path, sizeof(path), "/cfs/%s", name);
+	snprintf(stored_path, sizeof(stored_path), "/lfs/z/%s", name);
+	bench_file(path, stored_path, "compressed");
+}
+
+ZTEST(fs_compress_perf, test_log)
+{
+	fill_log();
+	bench_data("log");
+}
+
+ZTEST(fs_compress_perf, test_sensor)
+{
+	fill_sensor();
+	bench_data("sensor");
+}
+
+static void *fs_compress_perf_setup(void)
+{
+	const struct flash_area *fa;
+
+	zassert_ok(flash_area_open(TEST_PARTITION_ID, &fa));
+	zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+	flash_area_close(fa);
+
+	zassert_ok(fs_mount(&lfs_mnt));
+	zassert_ok(fs_mount(&cfs_mnt));
+
+	return NULL;
+}
+
+ZTEST_SUITE(fs_compress_perf, NULL, fs_compress_perf_setup, NULL, NULL,
+	    NULL);
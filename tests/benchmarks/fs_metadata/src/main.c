@@ -0,0 +1,179 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the rate of metadata operations going through the VFS: creating,
+ * opening, stating and deleting small files, on LittleFS in flash and on FAT
+ * on a RAM disk. The log phase stats these files while appending to another
+ * one, as an application logging to a file does.
+ */
+
+#include <stdio.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+#include <ff.h>
+
+#define LFS_PARTITION_ID	FIXED_PARTITION_ID(lfs_partition)
+#define FILE_CNT		16
+#define STAT_ROUNDS		8
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(lfs_data);
+static struct fs_mount_t lfs_mnt = {
+	.type = FS_LITTLEFS,
+	.mnt_point = "/lfs",
+	.fs_data = &lfs_data,
+	.storage_dev = (void *)LFS_PARTITION_ID,
+};
+
+static FATFS fat_fs;
+static struct fs_mount_t fat_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = "/RAM:",
+	.fs_data = &fat_fs,
+};
+
+static uint32_t start;
+
+static void timer_start(void)
+{
+	start = k_cycle_get_32();
+}
+
+/* Returns the number of operations per second since timer_start() */
+static uint32_t timer_ops(uint32_t ops)
+{
+	uint64_t us = k_cyc_to_us_floor64(k_cycle_get_32() - start);
+
+	return (uint32_t)((uint64_t)ops * USEC_PER_SEC / MAX(us, 1));
+}
+
+/* FAT without long file names reports names in upper case */
+static void file_path(char *path, size_t size, struct fs_mount_t *mp, int i)
+{
+	snprintf(path, size, "%s/F%02d.TXT", mp->mnt_point, i);
+}
+
+static void bench_mount(struct fs_mount_t *mp)
+{
+	const struct flash_area *fap;
+	int rc;
+
+	if (mp->type == FS_LITTLEFS) {
+		rc = flash_area_open(LFS_PARTITION_ID, &fap);
+		zassert_equal(rc, 0, "Can't open flash area");
+		rc = flash_area_erase(fap, 0, fap->fa_size);
+		zassert_equal(rc, 0, "Can't erase flash area");
+		flash_area_close(fap);
+	}
+
+	rc = fs_mount(mp);
+	zassert_equal(rc, 0, "Can't mount %s", mp->mnt_point);
+}
+
+static void bench_fs(struct fs_mount_t *mp)
+{
+	static const char data[16] = "0123456789abcde";
+	char path[32];
+	char missing[32];
+	char log[32];
+	struct fs_file_t file;
+	struct fs_dirent entry;
+	uint32_t create_ops;
+	uint32_t open_ops;
+	uint32_t stat_ops;
+	uint32_t miss_ops;
+	uint32_t log_ops;
+	uint32_t unlink_ops;
+	int rc;
+
+	bench_mount(mp);
+	fs_file_t_init(&file);
+	snprintf(missing, sizeof(missing), "%s/MISSING.TXT", mp->mnt_point);
+	snprintf(log, sizeof(log), "%s/LOG.TXT", mp->mnt_point);
+
+	timer_start();
+	for (int i = 0; i < FILE_CNT; i++) {
+		file_path(path, sizeof(path), mp, i);
+		rc = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+		zassert_equal(rc, 0, "Can't create %s", path);
+		rc = fs_write(&file, data, sizeof(data));
+		zassert_equal(rc, sizeof(data), "Can't write %s", path);
+		rc = fs_close(&file);
+		zassert_equal(rc, 0, "Can't close %s", path);
+	}
+	create_ops = timer_ops(FILE_CNT);
+
+	timer_start();
+	for (int i = 0; i < FILE_CNT; i++) {
+		file_path(path, sizeof(path), mp, i);
+		rc = fs_open(&file, path, FS_O_READ);
+		zassert_equal(rc, 0, "Can't open %s", path);
+		rc = fs_close(&file);
+		zassert_equal(rc, 0, "Can't close %s", path);
+	}
+	open_ops = timer_ops(FILE_CNT);
+
+	timer_start();
+	for (int r = 0; r < STAT_ROUNDS; r++) {
+		for (int i = 0; i < FILE_CNT; i++) {
+			file_path(path, sizeof(path), mp, i);
+			rc = fs_stat(path, &entry);
+			zassert_equal(rc, 0, "Can't stat %s", path);
+			zassert_equal(entry.size, sizeof(data), "Bad size");
+		}
+	}
+	stat_ops = timer_ops(STAT_ROUNDS * FILE_CNT);
+
+	timer_start();
+	for (int r = 0; r < STAT_ROUNDS * FILE_CNT; r++) {
+		rc = fs_stat(missing, &entry);
+		zassert_equal(rc, -ENOENT, "Stat of a missing file");
+	}
+	miss_ops = timer_ops(STAT_ROUNDS * FILE_CNT);
+
+	rc = fs_open(&file, log, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+	zassert_equal(rc, 0, "Can't create %s", log);
+	timer_start();
+	for (int r = 0; r < STAT_ROUNDS * FILE_CNT; r++) {
+		rc = fs_write(&file, data, sizeof(data));
+		zassert_equal(rc, sizeof(data), "Can't write %s", log);
+		file_path(path, sizeof(path), mp, r % FILE_CNT);
+		rc = fs_stat(path, &entry);
+		zassert_equal(rc, 0, "Can't stat %s", path);
+	}
+	log_ops = timer_ops(STAT_ROUNDS * FILE_CNT);
+	rc = fs_close(&file);
+	zassert_equal(rc, 0, "Can't close %s", log);
+	rc = fs_unlink(log);
+	zassert_equal(rc, 0, "Can't delete %s", log);
+
+	timer_start();
+	for (int i = 0; i < FILE_CNT; i++) {
+		file_path(path, sizeof(path), mp, i);
+		rc = fs_unlink(path);
+		zassert_equal(rc, 0, "Can't delete %s", path);
+	}
+	unlink_ops = timer_ops(FILE_CNT);
+
+	rc = fs_unmount(mp);
+	zassert_equal(rc, 0, "Can't unmount %s", mp->mnt_point);
+
+	TC_PRINT("%-8s %10u %10u %10u %10u %10u %10u\n", mp->mnt_point,
+		 create_ops, open_ops, stat_ops, miss_ops, log_ops, unlink_ops);
+}
+
+ZTEST(fs_metadata_perf, test_metadata_ops)
+{
+	TC_PRINT("VFS metadata operations per second, path cache %s\n",
+		 IS_ENABLED(CONFIG_FILE_SYSTEM_PATH_CACHE) ? "enabled" : "disabled");
+	TC_PRINT("%-8s %10s %10s %10s %10s %10s %10s\n", "mount", "create",
+		 "open", "stat", "miss", "log", "unlink");
+
+	bench_fs(&lfs_mnt);
+	bench_fs(&fat_mnt);
+}
+
+ZTEST_SUITE(fs_metadata_perf, NULL, NULL, NULL, NULL, NULL);
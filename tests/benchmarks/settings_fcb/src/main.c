@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the time taken by the settings FCB backend to save and load keys,
+ * depending on the number of keys stored.
+ */
+
+#include <stdio.h>
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/storage/flash_map.h>
+
+#include "settings_priv.h"
+#include "settings/settings_fcb.h"
+
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(storage_partition)
+#define SECTOR_CNT_MAX		16
+
+static const uint16_t key_counts[] = { 32, 64, 128, 256 };
+
+static struct flash_sector fcb_sectors[SECTOR_CNT_MAX];
+static struct settings_fcb cf;
+static uint32_t loaded;
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t val;
+
+	if (len != sizeof(val) || read_cb(cb_arg, &val, sizeof(val)) < 0) {
+		return -EINVAL;
+	}
+
+	loaded++;
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", NULL, bench_set, NULL, NULL);
+
+static void fcb_setup(void)
+{
+	const struct flash_area *fap;
+	uint32_t cnt = ARRAY_SIZE(fcb_sectors);
+	int rc;
+
+	rc = flash_area_open(TEST_PARTITION_ID, &fap);
+	zassert_equal(rc, 0, "Can't open storage flash area");
+	rc = flash_area_erase(fap, 0, fap->fa_size);
+	zassert_equal(rc, 0, "Can't erase storage flash area");
+	flash_area_close(fap);
+
+	rc = flash_area_get_sectors(TEST_PARTITION_ID, &cnt, fcb_sectors);
+	zassert_true(rc == 0 || rc == -ENOMEM, "Can't get flash sectors");
+
+	sys_slist_init(&settings_load_srcs);
+	settings_save_dst = NULL;
+
+	(void)memset(&cf, 0, sizeof(cf));
+	cf.cf_fcb.f_magic = CONFIG_SETTINGS_FCB_MAGIC;
+	cf.cf_fcb.f_sectors = fcb_sectors;
+	cf.cf_fcb.f_sector_cnt = cnt;
+
+	rc = settings_fcb_src(&cf);
+	zassert_equal(rc, 0, "Can't register FCB as settings source");
+	settings_mount_fcb_backend(&cf);
+	rc = settings_fcb_dst(&cf);
+	zassert_equal(rc, 0, "Can't register FCB as settings destination");
+}
+
+/* Save all the keys, returns the average time of a save in microseconds */
+static uint32_t save_all(uint16_t count, uint32_t base)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t val;
+	int rc;
+
+	start = k_cycle_get_32();
+	for (uint16_t i = 0; i < count; i++) {
+		snprintf(name, sizeof(name), "bench/k%u", i);
+		val = base + i;
+
+		rc = settings_save_one(name, &val, sizeof(val));
+		zassert_equal(rc, 0, "Can't save %s", name);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	return (uint32_t)k_cyc_to_us_floor64(cycles) / count;
+}
+
+static uint32_t load_subtree(const char *subtree)
+{
+	uint32_t start;
+	uint32_t cycles;
+	int rc;
+
+	loaded = 0;
+
+	start = k_cycle_get_32();
+	rc = settings_load_subtree(subtree);
+	cycles = k_cycle_get_32() - start;
+	zassert_equal(rc, 0, "Can't load %s", subtree);
+
+	return (uint32_t)k_cyc_to_us_floor64(cycles);
+}
+
+ZTEST(settings_fcb_perf, test_load_save)
+{
+	uint32_t save_us;
+	uint32_t update_us;
+	uint32_t dup_us;
+	uint32_t load_us;
+	uint32_t miss_us;
+
+	TC_PRINT("Settings FCB backend, key index %s\n",
+		 IS_ENABLED(CONFIG_SETTINGS_FCB_INDEX) ? "enabled" : "disabled");
+	TC_PRINT("%6s %10s %10s %10s %10s %10s\n", "keys", "save(us)",
+		 "update(us)", "dup(us)", "load(us)", "miss(us)");
+
+	for (size_t i = 0; i < ARRAY_SIZE(key_counts); i++) {
+		uint16_t count = key_counts[i];
+
+		fcb_setup();
+
+		/* New keys, changed values, then unchanged values */
+		save_us = save_all(count, 0);
+		update_us = save_all(count, count);
+		dup_us = save_all(count, count);
+
+		load_us = load_subtree("bench");
+		zassert_equal(loaded, count, "Loaded %u keys out of %u",
+			      loaded, count);
+
+		/* Subtree without any key */
+		miss_us = load_subtree("other");
+		zassert_equal(loaded, 0, "Unexpected keys loaded");
+
+		TC_PRINT("%6u %10u %10u %10u %10u %10u\n", count, save_us,
+			 update_us, dup_us, load_us, miss_us);
+	}
+}
+
+ZTEST_SUITE(settings_fcb_perf, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,314 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the insert rate, query latency and write amplification of the
+ * time-series store on the flash simulator, with samples flushed to flash at
+ * different intervals. Samples stored as raw FCB records are measured as a
+ * reference.
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/stats/stats.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/storage/tsdb.h>
+
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(storage_partition)
+#define TSDB_SECTOR_SIZE	4096
+#define TSDB_SECTOR_COUNT	4
+#define FCB_SECTOR_CNT_MAX	16
+
+#define SAMPLE_CNT		4000
+#define SAMPLE_PERIOD		1000
+/* Bytes of a timestamp and a value */
+#define SAMPLE_RAW_SIZE		12U
+
+static const uint16_t flush_intervals[] = { 1, 16, 256 };
+/* Query ranges, in percent of the newest samples */
+static const uint8_t query_ranges[] = { 1, 10, 100 };
+
+static struct tsdb_fs tsdb;
+static struct fcb fcb;
+static struct flash_sector fcb_sectors[FCB_SECTOR_CNT_MAX];
+
+static struct stats_hdr *sim_stats;
+static uint32_t *sim_bytes_written;
+static uint32_t *sim_erase_calls;
+
+struct stat_find {
+	const char *name;
+	uint32_t *val;
+};
+
+static int stat_find_cb(struct stats_hdr *hdr, void *arg, const char *name,
+			uint16_t off)
+{
+	struct stat_find *find = arg;
+
+	if (strcmp(name, find->name) == 0) {
+		find->val = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t *stat_find(const char *name)
+{
+	struct stat_find find = {
+		.name = name,
+	};
+
+	stats_walk(sim_stats, stat_find_cb, &find);
+	zassert_not_null(find.val, "No %s flash simulator stat", name);
+
+	return find.val;
+}
+
+/* Sensor like samples: periodic, with a slowly changing value */
+static int64_t sample_ts(uint32_t i)
+{
+	return (int64_t)i * SAMPLE_PERIOD + (i % 13);
+}
+
+static int32_t sample_value(uint32_t i)
+{
+	return 2000 + (int32_t)((i / 8) % 64) - 32;
+}
+
+static uint32_t start;
+
+static void timer_start(void)
+{
+	start = k_cycle_get_32();
+}
+
+static uint32_t timer_us(void)
+{
+	return (uint32_t)k_cyc_to_us_floor64(k_cycle_get_32() - start);
+}
+
+static uint32_t rate_per_s(uint32_t count, uint32_t us)
+{
+	return (uint32_t)((uint64_t)count * USEC_PER_SEC / MAX(us, 1));
+}
+
+/* Returns the erase value of the partition */
+static uint8_t partition_erase(void)
+{
+	const struct flash_area *fap;
+	uint8_t erase_value;
+	int rc;
+
+	rc = flash_area_open(TEST_PARTITION_ID, &fap);
+	zassert_equal(rc, 0, "Can't open storage flash area");
+	rc = flash_area_erase(fap, 0, fap->fa_size);
+	zassert_equal(rc, 0, "Can't erase storage flash area");
+	erase_value = flash_area_erased_val(fap);
+	flash_area_close(fap);
+
+	return erase_value;
+}
+
+static int count_cb(const struct tsdb_sample *sample, void *user_data)
+{
+	(*(uint32_t *)user_data)++;
+
+	return 0;
+}
+
+static void bench_tsdb(uint16_t flush_interval)
+{
+	uint32_t bytes_written;
+	uint32_t erases;
+	uint32_t insert_us;
+	uint32_t query_us[ARRAY_SIZE(query_ranges)];
+	int64_t newest = sample_ts(SAMPLE_CNT - 1);
+	int64_t oldest;
+	uint32_t found;
+	int rc;
+
+	(void)partition_erase();
+
+	(void)memset(&tsdb, 0, sizeof(tsdb));
+	tsdb.area_id = TEST_PARTITION_ID;
+	tsdb.sector_size = TSDB_SECTOR_SIZE;
+	tsdb.sector_count = TSDB_SECTOR_COUNT;
+	rc = tsdb_mount(&tsdb);
+	zassert_equal(rc, 0, "Can't mount store");
+
+	bytes_written = *sim_bytes_written;
+	erases = *sim_erase_calls;
+
+	timer_start();
+	for (uint32_t i = 0; i < SAMPLE_CNT; i++) {
+		rc = tsdb_append(&tsdb, sample_ts(i), sample_value(i));
+		zassert_equal(rc, 0, "Can't append sample %u", i);
+
+		if (((i + 1) % flush_interval) == 0) {
+			rc = tsdb_flush(&tsdb);
+			zassert_equal(rc, 0, "Can't flush");
+		}
+	}
+	rc = tsdb_flush(&tsdb);
+	insert_us = timer_us();
+	zassert_equal(rc, 0, "Can't flush");
+
+	bytes_written = *sim_bytes_written - bytes_written;
+	erases = *sim_erase_calls - erases;
+
+	/* Ranges of the newest samples, which are the ones retained */
+	found = 0;
+	rc = tsdb_query(&tsdb, INT64_MIN, INT64_MAX, count_cb, &found);
+	zassert_true(rc > 0, "No samples retained");
+	oldest = newest - (int64_t)(found - 1) * SAMPLE_PERIOD;
+
+	for (size_t i = 0; i < ARRAY_SIZE(query_ranges); i++) {
+		found = 0;
+		timer_start();
+		rc = tsdb_query(&tsdb,
+				newest - (newest - oldest) * query_ranges[i] / 100,
+				newest, count_cb, &found);
+		query_us[i] = timer_us();
+		zassert_true(rc >= 0, "Query failed");
+	}
+
+	TC_PRINT("%-6s %6u %10u %8u %8u %6u %8u %8u %8u\n", "tsdb",
+		 flush_interval, rate_per_s(SAMPLE_CNT, insert_us),
+		 bytes_written / SAMPLE_CNT,
+		 (uint32_t)((uint64_t)bytes_written * 100 /
+			    (SAMPLE_CNT * SAMPLE_RAW_SIZE)),
+		 erases, query_us[0], query_us[1], query_us[2]);
+}
+
+struct fcb_query {
+	int64_t from;
+	int64_t to;
+	uint32_t found;
+};
+
+static int fcb_query_cb(struct fcb_entry_ctx *entry_ctx, void *arg)
+{
+	struct fcb_query *query = arg;
+	struct tsdb_sample sample;
+	int rc;
+
+	rc = flash_area_read(entry_ctx->fap,
+			     FCB_ENTRY_FA_DATA_OFF(entry_ctx->loc), &sample,
+			     sizeof(sample));
+	if (rc) {
+		return rc;
+	}
+
+	if ((sample.ts >= query->from) && (sample.ts <= query->to)) {
+		query->found++;
+	}
+
+	return 0;
+}
+
+/* One raw record per sample, written to flash right away */
+static void bench_fcb(void)
+{
+	uint32_t cnt = ARRAY_SIZE(fcb_sectors);
+	uint32_t bytes_written;
+	uint32_t erases;
+	uint32_t insert_us;
+	uint32_t query_us[ARRAY_SIZE(query_ranges)];
+	struct fcb_query query;
+	struct tsdb_sample sample;
+	struct fcb_entry loc;
+	int64_t newest = sample_ts(SAMPLE_CNT - 1);
+	int64_t oldest;
+	uint8_t erase_value;
+	int rc;
+
+	erase_value = partition_erase();
+
+	rc = flash_area_get_sectors(TEST_PARTITION_ID, &cnt, fcb_sectors);
+	zassert_true(rc == 0 || rc == -ENOMEM, "Can't get flash sectors");
+
+	(void)memset(&fcb, 0, sizeof(fcb));
+	fcb.f_magic = 0x54534442;
+	fcb.f_sectors = fcb_sectors;
+	fcb.f_sector_cnt = cnt;
+	fcb.f_erase_value = erase_value;
+	rc = fcb_init(TEST_PARTITION_ID, &fcb);
+	zassert_equal(rc, 0, "Can't initialize FCB");
+
+	bytes_written = *sim_bytes_written;
+	erases = *sim_erase_calls;
+
+	timer_start();
+	for (uint32_t i = 0; i < SAMPLE_CNT; i++) {
+		sample.ts = sample_ts(i);
+		sample.value = sample_value(i);
+
+		rc = fcb_append(&fcb, sizeof(sample), &loc);
+		if (rc == -ENOSPC) {
+			rc = fcb_rotate(&fcb);
+			zassert_equal(rc, 0, "Can't rotate FCB");
+			rc = fcb_append(&fcb, sizeof(sample), &loc);
+		}
+		zassert_equal(rc, 0, "Can't append sample %u", i);
+
+		rc = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc),
+				      &sample, sizeof(sample));
+		zassert_equal(rc, 0, "Can't write sample %u", i);
+		rc = fcb_append_finish(&fcb, &loc);
+		zassert_equal(rc, 0, "Can't finish sample %u", i);
+	}
+	insert_us = timer_us();
+
+	bytes_written = *sim_bytes_written - bytes_written;
+	erases = *sim_erase_calls - erases;
+
+	query.from = INT64_MIN;
+	query.to = INT64_MAX;
+	query.found = 0;
+	rc = fcb_walk(&fcb, NULL, fcb_query_cb, &query);
+	zassert_equal(rc, 0, "Can't walk FCB");
+	oldest = newest - (int64_t)(query.found - 1) * SAMPLE_PERIOD;
+
+	/* Every record is read, whatever the range */
+	for (size_t i = 0; i < ARRAY_SIZE(query_ranges); i++) {
+		query.from = newest - (newest - oldest) * query_ranges[i] / 100;
+		query.to = newest;
+		query.found = 0;
+		timer_start();
+		rc = fcb_walk(&fcb, NULL, fcb_query_cb, &query);
+		query_us[i] = timer_us();
+		zassert_equal(rc, 0, "Can't walk FCB");
+	}
+
+	TC_PRINT("%-6s %6u %10u %8u %8u %6u %8u %8u %8u\n", "fcb", 1,
+		 rate_per_s(SAMPLE_CNT, insert_us),
+		 bytes_written / SAMPLE_CNT,
+		 (uint32_t)((uint64_t)bytes_written * 100 /
+			    (SAMPLE_CNT * SAMPLE_RAW_SIZE)),
+		 erases, query_us[0], query_us[1], query_us[2]);
+}
+
+ZTEST(tsdb_perf, test_insert_query)
+{
+	sim_stats = stats_group_find("flash_sim_stats");
+	zassert_not_null(sim_stats, "No flash simulator stats");
+	sim_bytes_written = stat_find("bytes_written");
+	sim_erase_calls = stat_find("flash_erase_calls");
+
+	TC_PRINT("%u samples of %u bytes, blocks of %u bytes\n", SAMPLE_CNT,
+		 SAMPLE_RAW_SIZE, CONFIG_TSDB_BLOCK_SIZE);
+	TC_PRINT("%-6s %6s %10s %8s %8s %6s %8s %8s %8s\n", "store", "flush",
+		 "insert/s", "B/sample", "WA(%)", "erases", "q1%(us)",
+		 "q10%(us)", "q100%(us)");
+
+	for (size_t i = 0; i < ARRAY_SIZE(flush_intervals); i++) {
+		bench_tsdb(flush_intervals[i]);
+	}
+
+	bench_fcb();
+}
+
+ZTEST_SUITE(tsdb_perf, NULL, NULL, NULL, NULL, NULL);
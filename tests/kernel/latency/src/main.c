@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel/latency.h>
+#include <zephyr/timing/timing.h>
+
+#define HELPER_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+static struct k_thread helper_thread;
+static K_THREAD_STACK_DEFINE(helper_stack, HELPER_STACK_SIZE);
+
+static K_SEM_DEFINE(test_sem, 0, 1);
+
+static uint32_t histogram_sum(const struct k_latency_histogram *hist)
+{
+	uint32_t sum = 0;
+
+	for (unsigned int i = 0; i < K_LATENCY_HISTOGRAM_BUCKETS; i++) {
+		sum += hist->buckets[i];
+	}
+
+	return sum;
+}
+
+/**
+ * @brief Verify the buckets cover increasing, contiguous ranges
+ */
+ZTEST(latency, test_bucket_start)
+{
+	zassert_equal(k_latency_bucket_start(0), 0, "first bucket not at 0");
+
+	for (unsigned int i = 1; i < K_LATENCY_HISTOGRAM_BUCKETS; i++) {
+		zassert_true(k_latency_bucket_start(i) > k_latency_bucket_start(i - 1),
+			     "bucket %u does not start after bucket %u", i, i - 1);
+	}
+
+	zassert_equal(k_latency_bucket_start(K_LATENCY_HISTOGRAM_BUCKETS - 1) >>
+		      (CONFIG_LATENCY_HISTOGRAM_RANGE - 1), 1,
+		      "last bucket not in the top range");
+}
+
+static void helper_ready(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+}
+
+/**
+ * @brief Verify a thread made ready records its scheduling latency
+ */
+ZTEST(latency, test_sched_latency)
+{
+	struct k_latency_histogram hist;
+	k_tid_t tid;
+
+	tid = k_thread_create(&helper_thread, helper_stack,
+			      K_THREAD_STACK_SIZEOF(helper_stack), helper_ready,
+			      NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_FOREVER);
+
+	k_thread_sched_latency_reset(tid);
+	k_thread_start(tid);
+	k_thread_join(tid, K_FOREVER);
+
+	zassert_ok(k_thread_sched_latency_get(tid, &hist));
+	zassert_equal(hist.count, 1, "unexpected count %u", hist.count);
+	zassert_equal(histogram_sum(&hist), hist.count, "buckets do not add up");
+
+	k_thread_sched_latency_reset(tid);
+	zassert_ok(k_thread_sched_latency_get(tid, &hist));
+	zassert_equal(hist.count, 0, "histogram not cleared");
+}
+
+static void helper_give(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sleep(K_MSEC(10));
+	k_sem_give(&test_sem);
+}
+
+/**
+ * @brief Verify only blocking k_sem_take() calls are counted
+ */
+ZTEST(latency, test_sem_take_latency)
+{
+	struct k_latency_histogram hist;
+
+	k_latency_reset();
+
+	k_sem_give(&test_sem);
+	zassert_ok(k_sem_take(&test_sem, K_FOREVER));
+	zassert_ok(k_wait_latency_get(K_LATENCY_SEM_TAKE, &hist));
+	zassert_equal(hist.count, 0, "non-blocking take counted");
+
+	k_thread_create(&helper_thread, helper_stack,
+			K_THREAD_STACK_SIZEOF(helper_stack), helper_give,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	zassert_ok(k_sem_take(&test_sem, K_FOREVER));
+	k_thread_join(&helper_thread, K_FOREVER);
+
+	zassert_ok(k_wait_latency_get(K_LATENCY_SEM_TAKE, &hist));
+	zassert_equal(hist.count, 1, "unexpected count %u", hist.count);
+	zassert_true(timing_cycles_to_ns(hist.max) >= 5 * NSEC_PER_MSEC,
+		     "wait too short: %u cycles", hist.max);
+
+	zassert_equal(k_wait_latency_get(K_LATENCY_ISR, &hist), -EINVAL);
+}
+
+ZTEST_SUITE(latency, NULL, NULL, NULL, NULL, NULL);
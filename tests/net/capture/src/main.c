@@ -0,0 +1,217 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/capture.h>
+#include <zephyr/net/dummy.h>
+
+#define PCAP_FILE_HDR_LEN   24
+#define PCAP_RECORD_HDR_LEN 16
+
+/* IPv4 + UDP from 192.0.2.1:4242 to 192.0.2.2:53 followed by payload */
+static const uint8_t udp4_pkt[] = {
+	0x45, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00,
+	0x40, 0x11, 0x00, 0x00, 0xc0, 0x00, 0x02, 0x01,
+	0xc0, 0x00, 0x02, 0x02, 0x10, 0x92, 0x00, 0x35,
+	0x00, 0x50, 0x00, 0x00,
+	/* Payload so that the packet is longer than the snaplen */
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+	0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+	0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+	0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+	0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+	0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+};
+
+/* IPv6 + TCP from 2001:db8::1 port 80 to 2001:db8::2 port 1234 */
+static const uint8_t tcp6_pkt[] = {
+	0x60, 0x00, 0x00, 0x00, 0x00, 0x14, 0x06, 0x40,
+	0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+	0x00, 0x50, 0x04, 0xd2, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x50, 0x02, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00,
+};
+
+static struct net_if *iface;
+
+struct dump_result {
+	uint8_t data[512];
+	size_t len;
+};
+
+static struct net_pkt *build_pkt(const uint8_t *data, size_t len)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	zassert_ok(net_pkt_write(pkt, data, len), "Cannot write pkt");
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static bool match(const char *expr, const uint8_t *data, size_t len)
+{
+	struct net_capture_filter filter;
+	struct net_pkt *pkt;
+	bool ret;
+
+	zassert_ok(net_capture_filter_parse(expr, &filter),
+		   "Cannot parse \"%s\"", expr);
+
+	pkt = build_pkt(data, len);
+	ret = net_capture_filter_match(&filter, iface, pkt);
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+
+static void capture(const uint8_t *data, size_t len)
+{
+	struct net_pkt *pkt = build_pkt(data, len);
+
+	net_capture_ring_pkt(iface, pkt);
+	net_pkt_unref(pkt);
+}
+
+static int dump_cb(const uint8_t *data, size_t len, void *user_data)
+{
+	struct dump_result *result = user_data;
+
+	zassert_true(result->len + len <= sizeof(result->data), "Dump overflow");
+
+	memcpy(&result->data[result->len], data, len);
+	result->len += len;
+
+	return 0;
+}
+
+ZTEST(net_capture, test_filter_parse)
+{
+	struct net_capture_filter filter;
+
+	zassert_ok(net_capture_filter_parse("", &filter));
+	zassert_equal(filter.flags, 0);
+
+	zassert_ok(net_capture_filter_parse("any", &filter));
+	zassert_equal(filter.flags, 0);
+
+	zassert_ok(net_capture_filter_parse("udp and port 53 and host 192.0.2.2",
+					    &filter));
+	zassert_equal(filter.flags, NET_CAPTURE_FILTER_PROTO |
+		      NET_CAPTURE_FILTER_PORT | NET_CAPTURE_FILTER_HOST |
+		      NET_CAPTURE_FILTER_FAMILY);
+	zassert_equal(filter.proto, IPPROTO_UDP);
+	zassert_equal(filter.port, 53);
+	zassert_equal(filter.family, AF_INET);
+
+	zassert_equal(net_capture_filter_parse("udp port 53", &filter), -EINVAL);
+	zassert_equal(net_capture_filter_parse("udp and", &filter), -EINVAL);
+	zassert_equal(net_capture_filter_parse("port 0", &filter), -EINVAL);
+	zassert_equal(net_capture_filter_parse("port 70000", &filter), -EINVAL);
+	zassert_equal(net_capture_filter_parse("udp and tcp", &filter), -EINVAL);
+	zassert_equal(net_capture_filter_parse("ip6 and host 192.0.2.2", &filter),
+		      -EINVAL);
+	zassert_equal(net_capture_filter_parse("foo", &filter), -EINVAL);
+}
+
+ZTEST(net_capture, test_filter_match)
+{
+	zassert_true(match("", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_true(match("ip and udp", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_true(match("port 53", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_true(match("port 4242", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_true(match("host 192.0.2.1", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_false(match("tcp", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_false(match("ip6", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_false(match("port 80", udp4_pkt, sizeof(udp4_pkt)));
+	zassert_false(match("host 192.0.2.3", udp4_pkt, sizeof(udp4_pkt)));
+
+	zassert_true(match("ip6 and tcp and port 80", tcp6_pkt, sizeof(tcp6_pkt)));
+	zassert_true(match("host 2001:db8::2", tcp6_pkt, sizeof(tcp6_pkt)));
+	zassert_false(match("udp", tcp6_pkt, sizeof(tcp6_pkt)));
+	zassert_false(match("host 2001:db8::3", tcp6_pkt, sizeof(tcp6_pkt)));
+}
+
+ZTEST(net_capture, test_ring)
+{
+	static struct dump_result result;
+	struct net_capture_filter filter;
+	struct net_capture_ring_stats stats;
+	uint32_t magic, incl_len, orig_len;
+	int ret;
+
+	zassert_ok(net_capture_filter_parse("udp", &filter));
+	zassert_ok(net_capture_ring_enable(iface, &filter, 0));
+	zassert_equal(net_capture_ring_enable(iface, &filter, 0), -EALREADY);
+
+	capture(udp4_pkt, sizeof(udp4_pkt));
+	capture(tcp6_pkt, sizeof(tcp6_pkt));
+
+	net_capture_ring_get_stats(&stats);
+	zassert_equal(stats.captured, 1);
+	zassert_equal(stats.filtered, 1);
+	zassert_equal(stats.truncated, 1);
+	zassert_equal(stats.overwritten, 0);
+
+	memset(&result, 0, sizeof(result));
+	ret = net_capture_ring_dump(dump_cb, &result);
+	zassert_equal(ret, 1, "Unexpected record count %d", ret);
+	zassert_equal(result.len, PCAP_FILE_HDR_LEN + PCAP_RECORD_HDR_LEN +
+		      CONFIG_NET_CAPTURE_RING_SNAPLEN);
+
+	/* The pcap data is in host byte order */
+	memcpy(&magic, result.data, sizeof(magic));
+	memcpy(&incl_len, &result.data[PCAP_FILE_HDR_LEN + 8], sizeof(incl_len));
+	memcpy(&orig_len, &result.data[PCAP_FILE_HDR_LEN + 12], sizeof(orig_len));
+	zassert_equal(magic, 0xa1b2c3d4);
+	zassert_equal(incl_len, CONFIG_NET_CAPTURE_RING_SNAPLEN);
+	zassert_equal(orig_len, sizeof(udp4_pkt));
+	zassert_mem_equal(&result.data[PCAP_FILE_HDR_LEN + PCAP_RECORD_HDR_LEN],
+			  udp4_pkt, incl_len);
+
+	/* Wrap the ring, only the newest records must be dumped */
+	for (int i = 0; i < CONFIG_NET_CAPTURE_RING_SLOTS + 2; i++) {
+		capture(udp4_pkt, sizeof(udp4_pkt));
+	}
+
+	net_capture_ring_get_stats(&stats);
+	zassert_equal(stats.overwritten, 3);
+
+	memset(&result, 0, sizeof(result));
+	ret = net_capture_ring_dump(dump_cb, &result);
+	zassert_equal(ret, CONFIG_NET_CAPTURE_RING_SLOTS);
+
+	zassert_ok(net_capture_ring_disable());
+	zassert_false(net_capture_ring_is_enabled());
+
+	/* Nothing is recorded after disabling */
+	capture(udp4_pkt, sizeof(udp4_pkt));
+	net_capture_ring_get_stats(&stats);
+	zassert_equal(stats.captured, CONFIG_NET_CAPTURE_RING_SLOTS + 3);
+}
+
+static void *setup(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "No dummy interface");
+
+	return NULL;
+}
+
+ZTEST_SUITE(net_capture, NULL, setup, NULL, NULL, NULL);
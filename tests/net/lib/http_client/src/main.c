@@ -0,0 +1,478 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+
+#define MY_IPV6_ADDR "::1"
+#define SERVER_PORT 8080
+
+#define TIMEOUT_MS 2000
+
+#define GET_REQ "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"
+
+#define RSP_HELLO "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello"
+#define RSP_WORLD "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" \
+		  "3\r\nwor\r\n2\r\nld\r\n0\r\n\r\n"
+
+/* What the server thread expects from the client and answers to it */
+struct exchange {
+	const char *req;
+	const char *rsp;
+	bool new_conn;
+};
+
+static int listen_sock = -1;
+static int server_conn = -1;
+static int accepted;
+static bool server_ok;
+static const struct exchange *server_ex;
+
+static K_SEM_DEFINE(server_go, 0, 1);
+static K_SEM_DEFINE(server_done, 0, 1);
+
+struct test_rsp {
+	char body[32];
+	size_t body_len;
+	int final_calls;
+	uint16_t status;
+};
+
+static void server_exchange(const struct exchange *ex)
+{
+	size_t expected = strlen(ex->req);
+	static char buf[256];
+	size_t len = 0;
+	int ret;
+
+	server_ok = false;
+
+	if (ex->new_conn) {
+		if (server_conn >= 0) {
+			(void)zsock_close(server_conn);
+		}
+
+		server_conn = zsock_accept(listen_sock, NULL, NULL);
+		if (server_conn < 0) {
+			return;
+		}
+
+		accepted++;
+	}
+
+	while (len < expected) {
+		struct zsock_pollfd fds[1] = {
+			{ .fd = server_conn, .events = ZSOCK_POLLIN },
+		};
+
+		if (zsock_poll(fds, 1, TIMEOUT_MS) <= 0) {
+			return;
+		}
+
+		ret = zsock_recv(server_conn, buf + len,
+				 MIN(expected - len, sizeof(buf) - len), 0);
+		if (ret <= 0) {
+			return;
+		}
+
+		len += ret;
+	}
+
+	if (memcmp(buf, ex->req, expected) != 0) {
+		return;
+	}
+
+	/* Everything is sent at once to exercise splitting the responses */
+	ret = zsock_send(server_conn, ex->rsp, strlen(ex->rsp), 0);
+	server_ok = (ret == strlen(ex->rsp));
+}
+
+static void server_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&server_go, K_FOREVER);
+		server_exchange(server_ex);
+		k_sem_give(&server_done);
+	}
+}
+
+K_THREAD_DEFINE(http_server, 2048, server_thread, NULL, NULL, NULL,
+		K_PRIO_PREEMPT(7), 0, 0);
+
+static void server_start(const struct exchange *ex)
+{
+	server_ex = ex;
+	k_sem_give(&server_go);
+}
+
+static void server_wait(void)
+{
+	zassert_ok(k_sem_take(&server_done, K_MSEC(2 * TIMEOUT_MS)),
+		   "Server did not finish");
+	zassert_true(server_ok, "Unexpected request");
+}
+
+static int client_connect(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(SERVER_PORT),
+		.sin6_addr = IN6ADDR_LOOPBACK_INIT,
+	};
+	int sock;
+
+	sock = zsock_socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "socket failed (%d)", errno);
+	zassert_ok(zsock_connect(sock, (struct sockaddr *)&addr, sizeof(addr)),
+		   "connect failed (%d)", errno);
+
+	return sock;
+}
+
+static struct http_request reqs[2];
+static uint8_t recv_bufs[2][128];
+static struct test_rsp results[2];
+
+static struct test_rsp *result_of(struct http_response *rsp)
+{
+	struct http_request *req = CONTAINER_OF(rsp, struct http_request,
+						internal.response);
+
+	return &results[req - reqs];
+}
+
+static void response_cb(struct http_response *rsp,
+			enum http_final_call final_data,
+			void *user_data)
+{
+	struct test_rsp *result = result_of(rsp);
+
+	if (final_data == HTTP_DATA_FINAL) {
+		result->final_calls++;
+		result->status = rsp->http_status_code;
+	}
+}
+
+static int body_cb(struct http_response *rsp, const uint8_t *data,
+		   size_t len, void *user_data)
+{
+	struct test_rsp *result = result_of(rsp);
+
+	if (result->body_len + len > sizeof(result->body)) {
+		return -ENOMEM;
+	}
+
+	memcpy(result->body + result->body_len, data, len);
+	result->body_len += len;
+
+	return 0;
+}
+
+static void init_req(int i)
+{
+	memset(&reqs[i], 0, sizeof(reqs[i]));
+	reqs[i].method = HTTP_GET;
+	reqs[i].url = "/";
+	reqs[i].host = "localhost";
+	reqs[i].protocol = "HTTP/1.1";
+	reqs[i].response = response_cb;
+	reqs[i].body_cb = body_cb;
+	reqs[i].recv_buf = recv_bufs[i];
+	reqs[i].recv_buf_len = sizeof(recv_bufs[i]);
+
+	memset(&results[i], 0, sizeof(results[i]));
+}
+
+static void check_result(int i, const char *body)
+{
+	zassert_equal(results[i].final_calls, 1, "Response %d not final", i);
+	zassert_equal(results[i].status, 200, "Wrong status for response %d", i);
+	zassert_equal(results[i].body_len, strlen(body),
+		      "Wrong body length for response %d", i);
+	zassert_mem_equal(results[i].body, body, strlen(body));
+}
+
+ZTEST(http_client, test_pipeline)
+{
+	static const struct exchange ex = {
+		.req = GET_REQ GET_REQ,
+		.rsp = RSP_HELLO RSP_WORLD,
+		.new_conn = true,
+	};
+	struct http_request *list[] = { &reqs[0], &reqs[1] };
+	int sock;
+	int ret;
+
+	init_req(0);
+	init_req(1);
+
+	server_start(&ex);
+	sock = client_connect();
+
+	ret = http_client_req_pipeline(sock, list, ARRAY_SIZE(list),
+				       TIMEOUT_MS, NULL);
+	zassert_equal(ret, 2, "Wrong number of responses (%d)", ret);
+
+	server_wait();
+
+	check_result(0, "hello");
+	check_result(1, "world");
+	zassert_true(reqs[1].internal.response.keep_alive);
+
+	/* Both buffers must be used, one per response */
+	init_req(0);
+	list[1] = &reqs[0];
+	zassert_equal(http_client_req_pipeline(sock, list, ARRAY_SIZE(list),
+					       TIMEOUT_MS, NULL), -EINVAL);
+
+	zassert_ok(zsock_close(sock));
+}
+
+static int chunked_payload_cb(int sock, struct http_request *req,
+			      void *user_data)
+{
+	int total = 0;
+	int ret;
+
+	ret = http_client_send_chunk(sock, "hel", 3);
+	if (ret < 0) {
+		return ret;
+	}
+
+	total += ret;
+
+	ret = http_client_send_chunk(sock, "lo", 2);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return total + ret;
+}
+
+ZTEST(http_client, test_chunked_upload)
+{
+	static const struct exchange ex = {
+		.req = "POST / HTTP/1.1\r\nHost: localhost\r\n"
+		       "Transfer-Encoding: chunked\r\n\r\n"
+		       "3\r\nhel\r\n2\r\nlo\r\n0\r\n\r\n",
+		.rsp = RSP_WORLD,
+		.new_conn = true,
+	};
+	int sock;
+	int ret;
+
+	init_req(0);
+	reqs[0].method = HTTP_POST;
+	reqs[0].payload_cb = chunked_payload_cb;
+	reqs[0].chunked = true;
+
+	server_start(&ex);
+	sock = client_connect();
+
+	ret = http_client_req(sock, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+
+	server_wait();
+
+	check_result(0, "world");
+
+	zassert_ok(zsock_close(sock));
+}
+
+static int abort_body_cb(struct http_response *rsp, const uint8_t *data,
+			 size_t len, void *user_data)
+{
+	return -ECANCELED;
+}
+
+ZTEST(http_client, test_body_cb_abort)
+{
+	static const struct exchange ex = {
+		.req = GET_REQ,
+		.rsp = RSP_HELLO,
+		.new_conn = true,
+	};
+	int sock;
+	int ret;
+
+	init_req(0);
+	reqs[0].body_cb = abort_body_cb;
+
+	server_start(&ex);
+	sock = client_connect();
+
+	ret = http_client_req(sock, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_equal(ret, -EBADMSG, "Aborted request not failed (%d)", ret);
+
+	server_wait();
+
+	zassert_false(reqs[0].internal.response.message_complete,
+		      "Aborted response completed");
+
+	zassert_ok(zsock_close(sock));
+}
+
+ZTEST(http_client, test_malformed_response)
+{
+	static const struct exchange ex = {
+		.req = GET_REQ,
+		.rsp = "HTTP/1.1 200 OK\r\nContent-Length: 5x\r\n\r\nhello",
+		.new_conn = true,
+	};
+	int sock;
+	int ret;
+
+	init_req(0);
+
+	server_start(&ex);
+	sock = client_connect();
+
+	ret = http_client_req(sock, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_equal(ret, -EBADMSG, "Malformed response not reported (%d)",
+		      ret);
+
+	server_wait();
+
+	zassert_equal(results[0].final_calls, 0, "Malformed response completed");
+
+	zassert_ok(zsock_close(sock));
+}
+
+ZTEST(http_client, test_pool_reuse)
+{
+	static const struct exchange first = {
+		.req = GET_REQ,
+		.rsp = RSP_HELLO,
+		.new_conn = true,
+	};
+	static const struct exchange second = {
+		.req = GET_REQ,
+		.rsp = RSP_WORLD,
+		.new_conn = false,
+	};
+	static const struct http_client_endpoint ep = {
+		.host = MY_IPV6_ADDR,
+		.port = SERVER_PORT,
+		.sec_tag = HTTP_CLIENT_NO_TLS,
+	};
+	int ret;
+
+	accepted = 0;
+
+	init_req(0);
+	server_start(&first);
+	ret = http_client_pool_req(&ep, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+	server_wait();
+	check_result(0, "hello");
+
+	/* The second request goes over the same connection */
+	init_req(0);
+	server_start(&second);
+	ret = http_client_pool_req(&ep, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+	server_wait();
+	check_result(0, "world");
+
+	zassert_equal(accepted, 1, "Connection was not reused");
+
+	http_client_pool_flush();
+}
+
+/* Do a request over a connection the pool keeps open afterwards */
+static void pool_req_hello(const struct http_client_endpoint *ep)
+{
+	static const struct exchange ex = {
+		.req = GET_REQ,
+		.rsp = RSP_HELLO,
+		.new_conn = true,
+	};
+	int ret;
+
+	init_req(0);
+	server_start(&ex);
+	ret = http_client_pool_req(ep, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+	server_wait();
+	check_result(0, "hello");
+}
+
+ZTEST(http_client, test_pool_no_retry)
+{
+	static const struct exchange no_answer = {
+		.req = GET_REQ,
+		.rsp = "",
+		.new_conn = false,
+	};
+	static const struct exchange malformed = {
+		.req = GET_REQ,
+		.rsp = "HTTP/1.1 200 OK\r\nContent-Length: 5x\r\n\r\nhello",
+		.new_conn = false,
+	};
+	static const struct http_client_endpoint ep = {
+		.host = MY_IPV6_ADDR,
+		.port = SERVER_PORT,
+		.sec_tag = HTTP_CLIENT_NO_TLS,
+	};
+	int ret;
+
+	accepted = 0;
+
+	/* A timeout may come after the server processed the request */
+	pool_req_hello(&ep);
+	init_req(0);
+	server_start(&no_answer);
+	ret = http_client_pool_req(&ep, &reqs[0], TIMEOUT_MS / 4, NULL);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+	server_wait();
+	zassert_equal(results[0].final_calls, 1, "Request sent again");
+	zassert_equal(results[0].status, 0, "Unexpected response");
+
+	/* So may a response failing after its status line */
+	pool_req_hello(&ep);
+	init_req(0);
+	server_start(&malformed);
+	ret = http_client_pool_req(&ep, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_equal(ret, -EBADMSG, "Malformed response not reported (%d)",
+		      ret);
+	server_wait();
+	zassert_equal(results[0].final_calls, 0, "Request sent again");
+
+	zassert_equal(accepted, 2, "Unexpected connections");
+
+	http_client_pool_flush();
+}
+
+static void *http_client_setup(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(SERVER_PORT),
+		.sin6_addr = IN6ADDR_LOOPBACK_INIT,
+	};
+	int opt = 1;
+
+	listen_sock = zsock_socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_sock >= 0, "socket failed (%d)", errno);
+
+	(void)zsock_setsockopt(listen_sock, SOL_SOCKET, SO_REUSEADDR, &opt,
+			       sizeof(opt));
+
+	zassert_ok(zsock_bind(listen_sock, (struct sockaddr *)&addr,
+			      sizeof(addr)), "bind failed (%d)", errno);
+	zassert_ok(zsock_listen(listen_sock, 2), "listen failed (%d)", errno);
+
+	return NULL;
+}
+
+ZTEST_SUITE(http_client, NULL, http_client_setup, NULL, NULL, NULL);
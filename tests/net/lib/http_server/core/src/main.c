@@ -0,0 +1,379 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/websocket.h>
+#include <zephyr/net/http/server.h>
+
+#define TIMEOUT_MS 2000
+
+#define HELLO "Hello, world!"
+
+#define GET_REQ(url) "GET " url " HTTP/1.1\r\nHost: localhost\r\n\r\n"
+
+#define RSP_HELLO "HTTP/1.1 200 OK\r\n" \
+		  "Content-Type: text/plain\r\n" \
+		  "Content-Length: 13\r\n\r\n" HELLO
+#define RSP_NOT_FOUND "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n"
+
+static uint16_t test_http_service_port;
+HTTP_SERVICE_DEFINE(test_http_service, "::1", &test_http_service_port,
+		    CONFIG_HTTP_SERVER_MAX_CLIENTS, CONFIG_HTTP_SERVER_MAX_CLIENTS,
+		    NULL);
+
+static const uint8_t hello[] = HELLO;
+
+static struct http_resource_detail_static hello_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET) | BIT(HTTP_HEAD),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_type = "text/plain",
+	},
+	.static_data = hello,
+	.static_data_len = sizeof(hello) - 1,
+};
+
+HTTP_RESOURCE_DEFINE(hello_resource, test_http_service, "/", &hello_detail);
+
+/* Counts the bytes of the request body and replies with the count */
+static size_t dyn_received;
+
+static int dyn_cb(struct http_client_ctx *client, enum http_data_status status,
+		  uint8_t *data, size_t len, void *user_data)
+{
+	switch (status) {
+	case HTTP_SERVER_DATA_MORE:
+		dyn_received += len;
+		return 0;
+	case HTTP_SERVER_DATA_FINAL:
+		len = snprintk((char *)data, len, "%zu", dyn_received);
+		dyn_received = 0;
+		return len;
+	default:
+		dyn_received = 0;
+		return 0;
+	}
+}
+
+static struct http_resource_detail_dynamic dyn_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET) | BIT(HTTP_POST),
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+	},
+	.cb = dyn_cb,
+};
+
+HTTP_RESOURCE_DEFINE(dyn_resource, test_http_service, "/dyn", &dyn_detail);
+
+static uint8_t ws_buf[64];
+static int ws_sock = -1;
+static K_SEM_DEFINE(ws_ready, 0, 1);
+
+static int ws_cb(int sock, void *user_data)
+{
+	int ret;
+
+	/* Frames sent by the server are not masked */
+	ret = websocket_send_msg(sock, (const uint8_t *)"hi", 2,
+				 WEBSOCKET_OPCODE_DATA_TEXT, false, true,
+				 TIMEOUT_MS);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ws_sock = sock;
+	k_sem_give(&ws_ready);
+
+	return 0;
+}
+
+static struct http_resource_detail_websocket ws_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_WEBSOCKET,
+	},
+	.cb = ws_cb,
+	.data_buffer = ws_buf,
+	.data_buffer_len = sizeof(ws_buf),
+};
+
+HTTP_RESOURCE_DEFINE(ws_resource, test_http_service, "/ws", &ws_detail);
+
+static int client_connect(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(test_http_service_port),
+		.sin6_addr = IN6ADDR_LOOPBACK_INIT,
+	};
+	int sock;
+
+	sock = zsock_socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "socket failed (%d)", errno);
+	zassert_ok(zsock_connect(sock, (struct sockaddr *)&addr, sizeof(addr)),
+		   "connect failed (%d)", errno);
+
+	return sock;
+}
+
+static void client_send(int sock, const char *data)
+{
+	size_t len = strlen(data);
+
+	zassert_equal(zsock_send(sock, data, len, 0), len, "send failed (%d)",
+		      errno);
+}
+
+/* Read exactly the length of the expected data and compare it */
+static int client_expect(int sock, const char *expected, size_t len)
+{
+	static char buf[256];
+	size_t total = 0;
+	int ret;
+
+	if (len > sizeof(buf)) {
+		return -ENOMEM;
+	}
+
+	while (total < len) {
+		struct zsock_pollfd fds[1] = {
+			{ .fd = sock, .events = ZSOCK_POLLIN },
+		};
+
+		if (zsock_poll(fds, 1, TIMEOUT_MS) <= 0) {
+			return -ETIMEDOUT;
+		}
+
+		ret = zsock_recv(sock, buf + total, len - total, 0);
+		if (ret <= 0) {
+			return -ECONNRESET;
+		}
+
+		total += ret;
+	}
+
+	return memcmp(buf, expected, len) == 0 ? 0 : -EBADMSG;
+}
+
+#define CLIENT_EXPECT(sock, str) \
+	zassert_ok(client_expect(sock, str, sizeof(str) - 1), \
+		   "Unexpected response")
+
+/* Nothing more comes from the server but the end of the connection */
+static void client_expect_close(int sock)
+{
+	struct zsock_pollfd fds[1] = {
+		{ .fd = sock, .events = ZSOCK_POLLIN },
+	};
+	char c;
+
+	zassert_equal(zsock_poll(fds, 1, TIMEOUT_MS), 1, "Not closed");
+	zassert_equal(zsock_recv(sock, &c, 1, 0), 0, "Data after close");
+}
+
+ZTEST(http_server, test_static_keep_alive)
+{
+	int sock = client_connect();
+
+	client_send(sock, GET_REQ("/"));
+	CLIENT_EXPECT(sock, RSP_HELLO);
+
+	/* Same connection, query string ignored */
+	client_send(sock, GET_REQ("/?lang=en"));
+	CLIENT_EXPECT(sock, RSP_HELLO);
+
+	client_send(sock, "HEAD / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	CLIENT_EXPECT(sock, "HTTP/1.1 200 OK\r\n"
+			    "Content-Type: text/plain\r\n"
+			    "Content-Length: 13\r\n\r\n");
+
+	zassert_ok(zsock_close(sock));
+}
+
+ZTEST(http_server, test_errors)
+{
+	int sock = client_connect();
+
+	client_send(sock, GET_REQ("/missing"));
+	CLIENT_EXPECT(sock, RSP_NOT_FOUND);
+
+	client_send(sock, "DELETE / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	CLIENT_EXPECT(sock, "HTTP/1.1 405 Method Not Allowed\r\n"
+			    "Content-Length: 0\r\n\r\n");
+
+	/* Garbage ends the connection */
+	client_send(sock, "NOT HTTP\r\n\r\n");
+	CLIENT_EXPECT(sock, "HTTP/1.1 400 Bad Request\r\n"
+			    "Content-Length: 0\r\n"
+			    "Connection: close\r\n\r\n");
+	client_expect_close(sock);
+
+	zassert_ok(zsock_close(sock));
+}
+
+ZTEST(http_server, test_pipelining)
+{
+	int sock = client_connect();
+
+	/* Responses come in the order of the requests, the last one closes */
+	client_send(sock, GET_REQ("/missing") GET_REQ("/")
+			  "GET / HTTP/1.1\r\nConnection: close\r\n\r\n");
+	CLIENT_EXPECT(sock, RSP_NOT_FOUND RSP_HELLO
+			    "HTTP/1.1 200 OK\r\n"
+			    "Content-Type: text/plain\r\n"
+			    "Content-Length: 13\r\n"
+			    "Connection: close\r\n\r\n" HELLO);
+	client_expect_close(sock);
+
+	zassert_ok(zsock_close(sock));
+}
+
+ZTEST(http_server, test_dynamic)
+{
+	int sock = client_connect();
+
+	client_send(sock, "POST /dyn HTTP/1.1\r\nHost: localhost\r\n"
+			  "Transfer-Encoding: chunked\r\n\r\n"
+			  "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n");
+	CLIENT_EXPECT(sock, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n11");
+
+	client_send(sock, GET_REQ("/dyn"));
+	CLIENT_EXPECT(sock, "HTTP/1.1 200 OK\r\nContent-Length: 1\r\n\r\n0");
+
+	zassert_ok(zsock_close(sock));
+}
+
+ZTEST(http_server, test_websocket)
+{
+	/* Example handshake of RFC 6455 */
+	static const char upgrade[] =
+		"GET /ws HTTP/1.1\r\n"
+		"Host: localhost\r\n"
+		"Upgrade: websocket\r\n"
+		"Connection: Upgrade\r\n"
+		"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+		"Sec-WebSocket-Version: 13\r\n\r\n";
+	int sock = client_connect();
+
+	client_send(sock, upgrade);
+	CLIENT_EXPECT(sock, "HTTP/1.1 101 Switching Protocols\r\n"
+			    "Upgrade: websocket\r\n"
+			    "Connection: Upgrade\r\n"
+			    "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"
+			    "\r\n");
+
+	zassert_ok(k_sem_take(&ws_ready, K_MSEC(TIMEOUT_MS)),
+		   "Websocket callback not called");
+
+	/* Unmasked final text frame */
+	CLIENT_EXPECT(sock, "\x81\x02hi");
+
+	zassert_ok(websocket_disconnect(ws_sock));
+	ws_sock = -1;
+
+	zassert_ok(zsock_close(sock));
+}
+
+static K_SEM_DEFINE(load_done, 0, CONFIG_TEST_LOAD_CLIENTS);
+static int load_errors;
+
+static void load_client(void *p1, void *p2, void *p3)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(test_http_service_port),
+		.sin6_addr = IN6ADDR_LOOPBACK_INIT,
+	};
+	static const char req[] = GET_REQ("/");
+	int sock;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = zsock_socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		load_errors++;
+		goto out;
+	}
+
+	if (zsock_connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		load_errors++;
+		goto close;
+	}
+
+	for (int i = 0; i < CONFIG_TEST_LOAD_REQUESTS; i++) {
+		if (zsock_send(sock, req, sizeof(req) - 1, 0) != sizeof(req) - 1 ||
+		    client_expect(sock, RSP_HELLO, sizeof(RSP_HELLO) - 1) < 0) {
+			load_errors++;
+			break;
+		}
+	}
+
+close:
+	(void)zsock_close(sock);
+out:
+	k_sem_give(&load_done);
+}
+
+static K_THREAD_STACK_ARRAY_DEFINE(load_stacks, CONFIG_TEST_LOAD_CLIENTS, 2048);
+static struct k_thread load_threads[CONFIG_TEST_LOAD_CLIENTS];
+
+/* Several keep-alive clients over the loopback interface at once */
+ZTEST(http_server, test_load)
+{
+	uint32_t total = CONFIG_TEST_LOAD_CLIENTS * CONFIG_TEST_LOAD_REQUESTS;
+	int64_t start, elapsed;
+
+	load_errors = 0;
+	start = k_uptime_get();
+
+	for (int i = 0; i < CONFIG_TEST_LOAD_CLIENTS; i++) {
+		k_thread_create(&load_threads[i], load_stacks[i],
+				K_THREAD_STACK_SIZEOF(load_stacks[i]),
+				load_client, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(9), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < CONFIG_TEST_LOAD_CLIENTS; i++) {
+		zassert_ok(k_sem_take(&load_done, K_SECONDS(60)),
+			   "Load client stuck");
+	}
+
+	elapsed = MAX(k_uptime_get() - start, 1);
+
+	TC_PRINT("%u requests from %d clients in %lld ms (%lld req/s)\n",
+		 total, CONFIG_TEST_LOAD_CLIENTS, (long long)elapsed,
+		 (long long)(total * MSEC_PER_SEC / elapsed));
+
+	zassert_equal(load_errors, 0, "Failed requests");
+}
+
+static void *http_server_setup(void)
+{
+	zassert_ok(http_server_start());
+	zassert_not_equal(test_http_service_port, 0, "No port assigned");
+	zassert_equal(http_server_start(), -EALREADY);
+
+	return NULL;
+}
+
+static void http_server_teardown(void *fixture)
+{
+	zassert_ok(http_server_stop());
+}
+
+static void http_server_after(void *fixture)
+{
+	/* Let the server notice the closed connections */
+	k_msleep(100);
+}
+
+ZTEST_SUITE(http_server, NULL, http_server_setup, NULL, http_server_after,
+	    http_server_teardown);
@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_ZPERF_LOG_LEVEL);
+
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/zperf.h>
+
+#define ZPERF_PORT 5001
+
+static K_SEM_DEFINE(upload_done, 0, 1);
+static struct zperf_results upload_results;
+static enum zperf_status upload_status;
+static int periodic_reports;
+
+static void server_cb(enum zperf_status status, struct zperf_results *result,
+		      void *user_data)
+{
+	ARG_UNUSED(status);
+	ARG_UNUSED(result);
+	ARG_UNUSED(user_data);
+}
+
+static void upload_cb(enum zperf_status status, struct zperf_results *result,
+		      void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	switch (status) {
+	case ZPERF_SESSION_STARTED:
+		break;
+	case ZPERF_SESSION_PERIODIC_RESULT:
+		zassert_not_null(result);
+		periodic_reports++;
+		break;
+	case ZPERF_SESSION_FINISHED:
+		upload_results = *result;
+		__fallthrough;
+	case ZPERF_SESSION_ERROR:
+		upload_status = status;
+		k_sem_give(&upload_done);
+		break;
+	}
+}
+
+static void loopback_addr(struct sockaddr *addr)
+{
+	struct sockaddr_in *sin = (struct sockaddr_in *)addr;
+
+	memset(addr, 0, sizeof(*addr));
+	sin->sin_family = AF_INET;
+	sin->sin_port = htons(ZPERF_PORT);
+	zassert_ok(net_addr_pton(AF_INET, "127.0.0.1", &sin->sin_addr));
+}
+
+ZTEST(net_zperf, test_udp_parallel_upload)
+{
+	struct zperf_download_params server = { .port = ZPERF_PORT };
+	struct zperf_upload_params param = {
+		.duration_ms = 1000,
+		.rate_kbps = 200,
+		.packet_size = 256,
+		.num_streams = 2,
+		.report_interval_ms = 250,
+	};
+
+	loopback_addr(&param.peer_addr);
+
+	zassert_ok(zperf_udp_download(&server, server_cb, NULL));
+
+	periodic_reports = 0;
+	zassert_ok(zperf_udp_upload_async(&param, upload_cb, NULL));
+	zassert_ok(k_sem_take(&upload_done, K_SECONDS(10)));
+
+	zassert_equal(upload_status, ZPERF_SESSION_FINISHED);
+	zassert_true(upload_results.nb_packets_sent > 0);
+	zassert_equal(upload_results.nb_packets_rcvd,
+		      upload_results.nb_packets_sent,
+		      "Sent %u received %u", upload_results.nb_packets_sent,
+		      upload_results.nb_packets_rcvd);
+	zassert_true(periodic_reports >= 2, "Only %d reports", periodic_reports);
+
+	zassert_ok(zperf_udp_download_stop());
+}
+
+ZTEST(net_zperf, test_udp_latency)
+{
+	struct zperf_download_params server = { .port = ZPERF_PORT };
+	struct zperf_latency_params param = {
+		.count = 20,
+		.interval_ms = 1,
+		.timeout_ms = 500,
+		.packet_size = 64,
+	};
+	struct zperf_latency_results results;
+	uint32_t hist_total = 0;
+
+	loopback_addr(&param.peer_addr);
+
+	zassert_ok(zperf_udp_download(&server, server_cb, NULL));
+
+	zassert_ok(zperf_udp_latency(&param, &results));
+	zassert_equal(results.nb_requests, param.count);
+	zassert_equal(results.nb_replies, param.count);
+	zassert_equal(results.nb_timeouts, 0);
+	zassert_true(results.rtt_min_us <= results.rtt_avg_us);
+	zassert_true(results.rtt_avg_us <= results.rtt_max_us);
+
+	for (int i = 0; i < ZPERF_LATENCY_HIST_BUCKETS; i++) {
+		hist_total += results.hist[i];
+	}
+
+	zassert_equal(hist_total, results.nb_replies);
+
+	zassert_ok(zperf_udp_download_stop());
+}
+
+ZTEST(net_zperf, test_tcp_parallel_upload)
+{
+	struct zperf_download_params server = { .port = ZPERF_PORT };
+	struct zperf_upload_params param = {
+		.duration_ms = 1000,
+		.packet_size = 256,
+		.num_streams = 2,
+	};
+	struct zperf_results results = { 0 };
+
+	loopback_addr(&param.peer_addr);
+
+	zassert_ok(zperf_tcp_download(&server, server_cb, NULL));
+
+	zassert_ok(zperf_tcp_upload(&param, &results));
+	zassert_true(results.nb_packets_sent > 0);
+	zassert_equal(results.nb_packets_errors, 0);
+
+	zassert_ok(zperf_tcp_download_stop());
+}
+
+ZTEST(net_zperf, test_tcp_bidirectional_upload)
+{
+	struct zperf_download_params server = { .port = ZPERF_PORT };
+	struct zperf_upload_params param = {
+		.duration_ms = 1000,
+		.packet_size = 256,
+		.num_streams = 2,
+		.bidirectional = true,
+	};
+	struct zperf_results results = { 0 };
+
+	loopback_addr(&param.peer_addr);
+
+	zassert_ok(zperf_tcp_download(&server, server_cb, NULL));
+
+	zassert_ok(zperf_tcp_upload(&param, &results));
+	zassert_true(results.nb_packets_sent > 0);
+	zassert_true(results.reverse_total_len > 0, "Nothing sent back");
+
+	zassert_ok(zperf_tcp_download_stop());
+}
+
+ZTEST(net_zperf, test_too_many_streams)
+{
+	struct zperf_upload_params param = {
+		.duration_ms = 100,
+		.packet_size = 64,
+		.num_streams = CONFIG_NET_ZPERF_MAX_STREAMS + 1,
+	};
+	struct zperf_results results;
+
+	loopback_addr(&param.peer_addr);
+
+	zassert_equal(zperf_udp_upload(&param, &results), -EINVAL);
+	zassert_equal(zperf_tcp_upload(&param, &results), -EINVAL);
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Let the servers notice the stop request before the next test */
+	k_sleep(K_MSEC(300));
+}
+
+ZTEST_SUITE(net_zperf, NULL, NULL, NULL, after, NULL);
@@ -0,0 +1,202 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_rtio.h>
+
+#include "../../socket_helpers.h"
+
+#define MY_IPV6_ADDR "::1"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+#define TEST_STR "test"
+
+#define CQE_TIMEOUT K_SECONDS(2)
+
+RTIO_DEFINE_WITH_MEMPOOL(r, 8, 8, 8, 64, 4);
+
+ZSOCK_RTIO_IODEV_DEFINE(server_iodev);
+ZSOCK_RTIO_IODEV_DEFINE(client_iodev);
+ZSOCK_RTIO_IODEV_DEFINE(conn_iodev);
+
+static struct rtio_cqe *wait_cqe(void)
+{
+	int64_t end = k_uptime_get() + k_ticks_to_ms_ceil64(CQE_TIMEOUT.ticks);
+	struct rtio_cqe *cqe;
+
+	while ((cqe = rtio_cqe_consume(&r)) == NULL) {
+		zassert_true(k_uptime_get() < end, "No completion");
+		k_msleep(1);
+	}
+
+	return cqe;
+}
+
+static int consume(void *userdata)
+{
+	struct rtio_cqe *cqe = wait_cqe();
+	int result = cqe->result;
+
+	zassert_equal(cqe->userdata, userdata, "Unexpected completion");
+	rtio_cqe_release(&r, cqe);
+
+	return result;
+}
+
+ZTEST(net_socket_rtio, test_udp_multishot_recv)
+{
+	struct sockaddr_in6 c_addr, s_addr;
+	struct rtio_sqe *recv_sqe;
+	int c_sock, s_sock;
+	int ret;
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock, &c_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock, &s_addr);
+
+	zassert_ok(bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr)));
+	zassert_ok(connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr)));
+
+	zassert_ok(zsock_rtio_iodev_bind(&server_iodev, s_sock));
+	zassert_equal(zsock_rtio_iodev_bind(&server_iodev, s_sock), -EALREADY);
+
+	recv_sqe = rtio_sqe_acquire(&r);
+	zassert_not_null(recv_sqe);
+	rtio_sqe_prep_read_multishot(recv_sqe, &server_iodev, RTIO_PRIO_NORM,
+				     &server_iodev);
+	zassert_ok(rtio_submit(&r, 0));
+
+	/* Nothing was sent yet */
+	k_msleep(50);
+	zassert_is_null(rtio_cqe_consume(&r));
+
+	for (int i = 0; i < 3; i++) {
+		struct rtio_cqe *cqe;
+		uint32_t buf_len;
+		uint8_t *buf;
+
+		ret = send(c_sock, TEST_STR, strlen(TEST_STR), 0);
+		zassert_equal(ret, strlen(TEST_STR), "send failed (%d)", errno);
+
+		cqe = wait_cqe();
+		zassert_equal(cqe->userdata, &server_iodev);
+		zassert_equal(cqe->result, strlen(TEST_STR));
+		zassert_ok(rtio_cqe_get_mempool_buffer(&r, cqe, &buf, &buf_len));
+		zassert_mem_equal(buf, TEST_STR, strlen(TEST_STR));
+
+		rtio_cqe_release(&r, cqe);
+		rtio_release_buffer(&r, buf, buf_len);
+	}
+
+	/* Pending operations fail when the iodev is unbound */
+	zassert_ok(zsock_rtio_iodev_unbind(&server_iodev));
+	zassert_equal(consume(&server_iodev), -ECANCELED);
+	zassert_equal(zsock_rtio_iodev_unbind(&server_iodev), -EALREADY);
+
+	zassert_ok(close(c_sock));
+	zassert_ok(close(s_sock));
+}
+
+ZTEST(net_socket_rtio, test_tcp_accept_connect_chain)
+{
+	struct sockaddr_in6 c_addr, s_addr, peer_addr;
+	struct rtio_sqe *sqe;
+	uint8_t buf[sizeof(TEST_STR)];
+	int c_sock, s_sock, new_sock;
+
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock, &c_addr);
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock, &s_addr);
+
+	zassert_ok(bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr)));
+	zassert_ok(listen(s_sock, 1));
+
+	zassert_ok(zsock_rtio_iodev_bind(&server_iodev, s_sock));
+	zassert_ok(zsock_rtio_iodev_bind(&client_iodev, c_sock));
+
+	sqe = rtio_sqe_acquire(&r);
+	zsock_rtio_prep_accept(sqe, &server_iodev, (struct sockaddr *)&peer_addr,
+			       sizeof(peer_addr), &server_iodev);
+
+	/* Connect and send in a single chain */
+	sqe = rtio_sqe_acquire(&r);
+	zsock_rtio_prep_connect(sqe, &client_iodev, (struct sockaddr *)&s_addr,
+				sizeof(s_addr), &c_addr);
+	sqe->flags |= RTIO_SQE_CHAINED;
+
+	sqe = rtio_sqe_acquire(&r);
+	rtio_sqe_prep_write(sqe, &client_iodev, RTIO_PRIO_NORM, (uint8_t *)TEST_STR,
+			    strlen(TEST_STR), &client_iodev);
+
+	zassert_ok(rtio_submit(&r, 0));
+
+	/* The completions may come in any order */
+	for (int i = 0; i < 3; i++) {
+		struct rtio_cqe *cqe = wait_cqe();
+
+		zassert_true(cqe->result >= 0, "Operation failed (%d)", cqe->result);
+
+		if (cqe->userdata == &server_iodev) {
+			new_sock = cqe->result;
+		} else if (cqe->userdata == &client_iodev) {
+			zassert_equal(cqe->result, strlen(TEST_STR));
+		} else {
+			zassert_equal(cqe->userdata, &c_addr);
+		}
+
+		rtio_cqe_release(&r, cqe);
+	}
+
+	zassert_equal(peer_addr.sin6_family, AF_INET6);
+	zassert_equal(peer_addr.sin6_port, htons(CLIENT_PORT));
+
+	zassert_ok(zsock_rtio_iodev_bind(&conn_iodev, new_sock));
+
+	memset(buf, 0, sizeof(buf));
+	sqe = rtio_sqe_acquire(&r);
+	rtio_sqe_prep_read(sqe, &conn_iodev, RTIO_PRIO_NORM, buf, sizeof(buf),
+			   &conn_iodev);
+	zassert_ok(rtio_submit(&r, 0));
+
+	zassert_equal(consume(&conn_iodev), strlen(TEST_STR));
+	zassert_mem_equal(buf, TEST_STR, strlen(TEST_STR));
+
+	/* A stream receive completes with 0 once the peer is gone */
+	zassert_ok(zsock_rtio_iodev_unbind(&client_iodev));
+	zassert_ok(close(c_sock));
+
+	sqe = rtio_sqe_acquire(&r);
+	rtio_sqe_prep_read(sqe, &conn_iodev, RTIO_PRIO_NORM, buf, sizeof(buf),
+			   &conn_iodev);
+	zassert_ok(rtio_submit(&r, 0));
+	zassert_equal(consume(&conn_iodev), 0);
+
+	zassert_ok(zsock_rtio_iodev_unbind(&conn_iodev));
+	zassert_ok(zsock_rtio_iodev_unbind(&server_iodev));
+	zassert_ok(close(new_sock));
+	zassert_ok(close(s_sock));
+
+	/* Give the TCP stack time to release the connections */
+	k_sleep(K_SECONDS(1));
+}
+
+ZTEST(net_socket_rtio, test_unbound)
+{
+	struct rtio_sqe *sqe;
+	uint8_t buf[4];
+
+	sqe = rtio_sqe_acquire(&r);
+	rtio_sqe_prep_read(sqe, &client_iodev, RTIO_PRIO_NORM, buf, sizeof(buf),
+			   &client_iodev);
+	zassert_ok(rtio_submit(&r, 0));
+
+	zassert_equal(consume(&client_iodev), -EBADF);
+}
+
+ZTEST_SUITE(net_socket_rtio, NULL, NULL, NULL, NULL, NULL);
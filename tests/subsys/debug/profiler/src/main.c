@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/debug/profiler.h>
+#include <zephyr/ztest.h>
+
+#define FREQUENCY 100
+#define DURATION_MS 500
+
+#ifdef CONFIG_PROFILER_CALL_STACK
+#define STACK_DEPTH CONFIG_PROFILER_STACK_DEPTH
+#else
+#define STACK_DEPTH 1
+#endif
+
+struct histogram_sum {
+	uint32_t entries;
+	uint32_t count;
+};
+
+static void entry_check(const uintptr_t *stack, size_t depth, uint32_t count,
+			void *user_data)
+{
+	struct histogram_sum *sum = user_data;
+
+	zassert_not_null(stack);
+	zassert_true((depth > 0) && (depth <= STACK_DEPTH), "Bad depth: %zu", depth);
+	zassert_true(count > 0);
+
+	sum->entries++;
+	sum->count += count;
+}
+
+ZTEST(profiler, test_start_stop)
+{
+	zassert_equal(profiler_start(0), -EINVAL);
+	zassert_equal(profiler_start(CONFIG_SYS_CLOCK_TICKS_PER_SEC + 1), -EINVAL);
+	zassert_false(profiler_is_running());
+
+	zassert_ok(profiler_start(FREQUENCY));
+	zassert_true(profiler_is_running());
+	zassert_equal(profiler_start(FREQUENCY), -EALREADY);
+	zassert_equal(profiler_foreach(entry_check, NULL), -EBUSY);
+
+	zassert_ok(profiler_stop());
+	zassert_false(profiler_is_running());
+	zassert_equal(profiler_stop(), -EALREADY);
+}
+
+ZTEST(profiler, test_sampling)
+{
+	struct histogram_sum sum = { 0 };
+	struct profiler_stats stats;
+
+	zassert_ok(profiler_start(FREQUENCY));
+	k_busy_wait(DURATION_MS * USEC_PER_MSEC);
+	zassert_ok(profiler_stop());
+
+	profiler_stats_get(&stats);
+	zassert_true(stats.samples >= (FREQUENCY * DURATION_MS / MSEC_PER_SEC) / 2,
+		     "Too few samples: %u", stats.samples);
+	zassert_true(stats.missed < stats.samples, "No thread sampled");
+
+	zassert_ok(profiler_foreach(entry_check, &sum));
+	zassert_true(sum.entries > 0);
+	zassert_equal(sum.count, stats.samples - stats.missed - stats.lost);
+}
+
+ZTEST(profiler, test_reset)
+{
+	struct histogram_sum sum = { 0 };
+	struct profiler_stats stats;
+
+	zassert_ok(profiler_start(FREQUENCY));
+	k_busy_wait(100 * USEC_PER_MSEC);
+	zassert_ok(profiler_stop());
+
+	profiler_reset();
+
+	profiler_stats_get(&stats);
+	zassert_equal(stats.samples, 0);
+	zassert_equal(stats.missed, 0);
+	zassert_equal(stats.lost, 0);
+
+	zassert_ok(profiler_foreach(entry_check, &sum));
+	zassert_equal(sum.entries, 0);
+}
+
+static void profiler_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	if (profiler_is_running()) {
+		(void)profiler_stop();
+	}
+	profiler_reset();
+}
+
+ZTEST_SUITE(profiler, NULL, NULL, profiler_before, NULL, NULL);
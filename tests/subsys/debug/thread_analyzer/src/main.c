@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/debug/thread_analyzer.h>
+#include <string.h>
+
+#define HELPER_STACK_SIZE 1024
+#define HELPER_STACK_USE  (HELPER_STACK_SIZE * 3 / 4)
+
+static struct k_thread helper_thread;
+static K_THREAD_STACK_DEFINE(helper_stack, HELPER_STACK_SIZE);
+static K_SEM_DEFINE(helper_sem, 0, 1);
+
+static const struct k_thread *event_thread;
+static unsigned int event_value;
+static unsigned int event_count;
+static size_t helper_used;
+
+static void event_cb(const struct k_thread *thread, uint32_t event,
+		     unsigned int value)
+{
+	if ((thread == &helper_thread) && (event == THREAD_ANALYZER_EVENT_STACK)) {
+		event_thread = thread;
+		event_value = value;
+		event_count++;
+	}
+}
+
+static void info_cb(struct thread_analyzer_info *info)
+{
+	if (strcmp(info->name, "helper") == 0) {
+		helper_used = info->stack_used;
+	}
+}
+
+static void __noinline stack_fill(void)
+{
+	volatile uint8_t buf[HELPER_STACK_USE];
+
+	memset((uint8_t *)buf, 0x55, sizeof(buf));
+}
+
+static void helper(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	stack_fill();
+	k_sem_take(&helper_sem, K_FOREVER);
+}
+
+static void *setup(void)
+{
+	thread_analyzer_event_cb_set(event_cb);
+
+	k_thread_create(&helper_thread, helper_stack,
+			K_THREAD_STACK_SIZEOF(helper_stack), helper,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_thread_name_set(&helper_thread, "helper");
+	k_sleep(K_MSEC(10));
+
+	return NULL;
+}
+
+static void teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_give(&helper_sem);
+	k_thread_join(&helper_thread, K_FOREVER);
+	thread_analyzer_event_cb_set(NULL);
+}
+
+/**
+ * @brief Verify a step finds the stack growth and raises a single event
+ */
+ZTEST(thread_analyzer, test_stack_event)
+{
+	thread_analyzer_step();
+
+	zassert_equal(event_count, 1, "unexpected event count %u", event_count);
+	zassert_equal_ptr(event_thread, &helper_thread);
+	zassert_true(event_value >= 75, "stack usage %u %% too low", event_value);
+
+	thread_analyzer_step();
+	zassert_equal(event_count, 1, "event raised twice");
+}
+
+/**
+ * @brief Verify the full analysis agrees with the incremental watermark
+ */
+ZTEST(thread_analyzer, test_full_run)
+{
+	size_t used = helper_thread.analyzer.stack_used;
+
+	thread_analyzer_run(info_cb);
+
+	zassert_true(helper_used >= HELPER_STACK_USE, "usage %zu too low", helper_used);
+	zassert_true(helper_used >= used, "watermark went back");
+}
+
+ZTEST_SUITE(thread_analyzer, NULL, setup, NULL, NULL, teardown);
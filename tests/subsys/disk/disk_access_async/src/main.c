@@ -0,0 +1,322 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/disk.h>
+#include <zephyr/storage/disk_access.h>
+
+#define SECTOR_SIZE	512
+#define SECTOR_COUNT	32
+#define MAX_PARTS	8
+
+/* Disks sharing their data in RAM. The "QUEUE" disk queues transfers until
+ * the test completes them, the "SYNC" disk only has synchronous operations.
+ */
+static uint8_t disk_data[SECTOR_COUNT][SECTOR_SIZE];
+
+struct part {
+	struct disk_access_req *req;
+	uint8_t *data;
+	uint32_t start_sector;
+	uint32_t num_sector;
+};
+
+static struct part parts[MAX_PARTS];
+static size_t num_parts;
+static int submit_error;
+
+static uint8_t bufs[4][2][SECTOR_SIZE];
+
+static int mock_disk_init(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int mock_disk_status(struct disk_info *disk)
+{
+	return DISK_STATUS_OK;
+}
+
+static int mock_disk_read(struct disk_info *disk, uint8_t *data_buf,
+			  uint32_t start_sector, uint32_t num_sector)
+{
+	if (start_sector + num_sector > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(data_buf, disk_data[start_sector], num_sector * SECTOR_SIZE);
+
+	return 0;
+}
+
+static int mock_disk_write(struct disk_info *disk, const uint8_t *data_buf,
+			   uint32_t start_sector, uint32_t num_sector)
+{
+	if (start_sector + num_sector > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(disk_data[start_sector], data_buf, num_sector * SECTOR_SIZE);
+
+	return 0;
+}
+
+static int mock_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case DISK_IOCTL_CTRL_SYNC:
+		break;
+	case DISK_IOCTL_GET_SECTOR_COUNT:
+		*(uint32_t *)buff = SECTOR_COUNT;
+		break;
+	case DISK_IOCTL_GET_SECTOR_SIZE:
+		*(uint32_t *)buff = SECTOR_SIZE;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int mock_disk_submit(struct disk_info *disk,
+			    struct disk_access_req *req, uint8_t *data_buf,
+			    uint32_t start_sector, uint32_t num_sector)
+{
+	if ((submit_error != 0) || (num_parts == MAX_PARTS)) {
+		return submit_error != 0 ? submit_error : -ENOMEM;
+	}
+
+	parts[num_parts++] = (struct part) {
+		.req = req,
+		.data = data_buf,
+		.start_sector = start_sector,
+		.num_sector = num_sector,
+	};
+
+	return 0;
+}
+
+/* Complete the queued transfers, last queued first */
+static void complete_parts(int result)
+{
+	while (num_parts > 0) {
+		struct part *part = &parts[--num_parts];
+		int rc;
+
+		if (part->req->op == DISK_ACCESS_OP_READ) {
+			rc = mock_disk_read(NULL, part->data,
+					    part->start_sector,
+					    part->num_sector);
+		} else {
+			rc = mock_disk_write(NULL, part->data,
+					     part->start_sector,
+					     part->num_sector);
+		}
+
+		disk_access_req_done(part->req, result != 0 ? result : rc);
+	}
+}
+
+static const struct disk_operations sync_disk_ops = {
+	.init = mock_disk_init,
+	.status = mock_disk_status,
+	.read = mock_disk_read,
+	.write = mock_disk_write,
+	.ioctl = mock_disk_ioctl,
+};
+
+static const struct disk_operations queue_disk_ops = {
+	.init = mock_disk_init,
+	.status = mock_disk_status,
+	.read = mock_disk_read,
+	.write = mock_disk_write,
+	.ioctl = mock_disk_ioctl,
+	.submit = mock_disk_submit,
+};
+
+static struct disk_info sync_disk = {
+	.name = "SYNC",
+	.ops = &sync_disk_ops,
+};
+
+static struct disk_info queue_disk = {
+	.name = "QUEUE",
+	.ops = &queue_disk_ops,
+};
+
+static const struct disk_access_buf req_bufs[4][2] = {
+	{ { bufs[0][0], 1 }, { bufs[0][1], 1 } },
+	{ { bufs[1][0], 1 }, { bufs[1][1], 1 } },
+	{ { bufs[2][0], 1 }, { bufs[2][1], 1 } },
+	{ { bufs[3][0], 1 }, { bufs[3][1], 1 } },
+};
+
+/* Build four requests of two scattered sectors each, from sector 4 */
+static void make_reqs(struct disk_access_req *reqs, uint8_t op)
+{
+	for (size_t i = 0; i < 4; i++) {
+		reqs[i] = (struct disk_access_req) {
+			.op = op,
+			.start_sector = 4 + 2 * i,
+			.bufs = req_bufs[i],
+			.num_bufs = 2,
+		};
+	}
+}
+
+/* With the cache, all requests go through the work queue */
+static bool is_queued(struct disk_info *disk)
+{
+	return (disk == &queue_disk) && !IS_ENABLED(CONFIG_DISK_CACHE);
+}
+
+static void write_read(struct disk_info *disk)
+{
+	struct disk_access_req reqs[4];
+	int rc;
+
+	for (size_t i = 0; i < 4; i++) {
+		memset(bufs[i][0], 0x20 + 2 * i, SECTOR_SIZE);
+		memset(bufs[i][1], 0x21 + 2 * i, SECTOR_SIZE);
+	}
+
+	make_reqs(reqs, DISK_ACCESS_OP_WRITE);
+	rc = disk_access_submit(disk, reqs, ARRAY_SIZE(reqs));
+	zassert_equal(rc, 0, "Submit failed");
+
+	if (is_queued(disk)) {
+		zassert_equal(num_parts, 8, "Buffers not queued");
+		zassert_equal(disk_access_wait(&reqs[0], K_NO_WAIT), -EAGAIN,
+			      "Request completed too early");
+		complete_parts(0);
+	}
+
+	for (size_t i = 0; i < 4; i++) {
+		rc = disk_access_wait(&reqs[i], K_SECONDS(1));
+		zassert_equal(rc, 0, "Request %zu failed", i);
+	}
+
+	rc = disk_access_ioctl(disk->name, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "Sync failed");
+
+	for (uint32_t i = 0; i < 8; i++) {
+		zassert_equal(disk_data[4 + i][0], 0x20 + i, "Bad data written");
+	}
+
+	memset(bufs, 0, sizeof(bufs));
+	make_reqs(reqs, DISK_ACCESS_OP_READ);
+	rc = disk_access_submit(disk, reqs, ARRAY_SIZE(reqs));
+	zassert_equal(rc, 0, "Submit failed");
+
+	if (is_queued(disk)) {
+		complete_parts(0);
+	}
+
+	for (size_t i = 0; i < 4; i++) {
+		rc = disk_access_wait(&reqs[i], K_SECONDS(1));
+		zassert_equal(rc, 0, "Request %zu failed", i);
+		zassert_equal(bufs[i][0][0], 0x20 + 2 * i, "Bad data read");
+		zassert_equal(bufs[i][1][0], 0x21 + 2 * i, "Bad data read");
+	}
+}
+
+ZTEST(disk_access_async, test_work_queue)
+{
+	write_read(disk_access_get("SYNC"));
+}
+
+ZTEST(disk_access_async, test_driver_queue)
+{
+	write_read(disk_access_get("QUEUE"));
+}
+
+static void req_cb(struct disk_access_req *req)
+{
+	k_sem_give(req->user_data);
+}
+
+ZTEST(disk_access_async, test_error)
+{
+	struct disk_info *disk = disk_access_get("QUEUE");
+	struct k_sem sem;
+	struct disk_access_req req = {
+		.op = DISK_ACCESS_OP_READ,
+		.start_sector = 4,
+		.bufs = req_bufs[0],
+		.num_bufs = 2,
+		.cb = req_cb,
+		.user_data = &sem,
+	};
+	int rc;
+
+	Z_TEST_SKIP_IFDEF(CONFIG_DISK_CACHE);
+
+	k_sem_init(&sem, 0, 1);
+
+	/* The first error is reported once all transfers completed */
+	rc = disk_access_submit(disk, &req, 1);
+	zassert_equal(rc, 0, "Submit failed");
+	zassert_equal(k_sem_take(&sem, K_NO_WAIT), -EBUSY,
+		      "Request completed too early");
+	complete_parts(-EIO);
+	zassert_equal(k_sem_take(&sem, K_NO_WAIT), 0, "Request not completed");
+	zassert_equal(req.result, -EIO, "Error not reported");
+
+	/* Including when the driver can't queue a transfer */
+	submit_error = -ENOMEM;
+	rc = disk_access_submit(disk, &req, 1);
+	zassert_equal(rc, 0, "Submit failed");
+	zassert_equal(k_sem_take(&sem, K_NO_WAIT), 0, "Request not completed");
+	zassert_equal(req.result, -ENOMEM, "Error not reported");
+	submit_error = 0;
+
+	/* Past the end of the disk */
+	req.start_sector = SECTOR_COUNT - 1;
+	req.cb = NULL;
+	disk = disk_access_get("SYNC");
+	rc = disk_access_submit(disk, &req, 1);
+	zassert_equal(rc, 0, "Submit failed");
+	zassert_equal(disk_access_wait(&req, K_SECONDS(1)), -EIO,
+		      "Error not reported");
+}
+
+ZTEST(disk_access_async, test_invalid)
+{
+	struct disk_access_req reqs[4];
+
+	zassert_is_null(disk_access_get("NONE"), "Unknown disk found");
+	zassert_equal(disk_access_submit(NULL, reqs, 1), -EINVAL,
+		      "Request on an unknown disk");
+
+	make_reqs(reqs, DISK_ACCESS_OP_READ);
+	reqs[3].op = 0xff;
+	zassert_equal(disk_access_submit(&queue_disk, reqs, 4), -EINVAL,
+		      "Invalid request submitted");
+	zassert_equal(num_parts, 0, "Request submitted");
+}
+
+static void *disk_access_async_setup(void)
+{
+	zassert_equal(disk_access_register(&sync_disk), 0,
+		      "Can't register disk");
+	zassert_equal(disk_access_register(&queue_disk), 0,
+		      "Can't register disk");
+
+	return NULL;
+}
+
+static void disk_access_async_before(void *fixture)
+{
+	/* Start with an empty cache */
+	zassert_equal(disk_access_init("SYNC"), 0, "Can't init disk");
+	zassert_equal(disk_access_init("QUEUE"), 0, "Can't init disk");
+	memset(disk_data, 0, sizeof(disk_data));
+	num_parts = 0;
+	submit_error = 0;
+}
+
+ZTEST_SUITE(disk_access_async, NULL, disk_access_async_setup,
+	    disk_access_async_before, NULL, NULL);
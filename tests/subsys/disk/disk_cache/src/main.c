@@ -0,0 +1,190 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/disk.h>
+#include <zephyr/storage/disk_access.h>
+
+#define DISK_NAME	"CACHE"
+#define SECTOR_SIZE	512
+#define SECTOR_COUNT	64
+
+/* Disk in RAM counting the operations reaching it */
+static uint8_t disk_data[SECTOR_COUNT][SECTOR_SIZE];
+static uint32_t disk_reads;
+static uint32_t disk_writes;
+
+static uint8_t buf[4][SECTOR_SIZE];
+
+static int mock_disk_init(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int mock_disk_status(struct disk_info *disk)
+{
+	return DISK_STATUS_OK;
+}
+
+static int mock_disk_read(struct disk_info *disk, uint8_t *data_buf,
+			  uint32_t start_sector, uint32_t num_sector)
+{
+	if (start_sector + num_sector > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(data_buf, disk_data[start_sector], num_sector * SECTOR_SIZE);
+	disk_reads++;
+
+	return 0;
+}
+
+static int mock_disk_write(struct disk_info *disk, const uint8_t *data_buf,
+			   uint32_t start_sector, uint32_t num_sector)
+{
+	if (start_sector + num_sector > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(disk_data[start_sector], data_buf, num_sector * SECTOR_SIZE);
+	disk_writes++;
+
+	return 0;
+}
+
+static int mock_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case DISK_IOCTL_CTRL_SYNC:
+		break;
+	case DISK_IOCTL_GET_SECTOR_COUNT:
+		*(uint32_t *)buff = SECTOR_COUNT;
+		break;
+	case DISK_IOCTL_GET_SECTOR_SIZE:
+		*(uint32_t *)buff = SECTOR_SIZE;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static const struct disk_operations mock_disk_ops = {
+	.init = mock_disk_init,
+	.status = mock_disk_status,
+	.read = mock_disk_read,
+	.write = mock_disk_write,
+	.ioctl = mock_disk_ioctl,
+};
+
+static struct disk_info mock_disk = {
+	.name = DISK_NAME,
+	.ops = &mock_disk_ops,
+};
+
+ZTEST(disk_cache, test_write_behind)
+{
+	int rc;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(buf); i++) {
+		memset(buf[i], 0x10 + i, SECTOR_SIZE);
+		rc = disk_access_write(DISK_NAME, buf[i], 8 + i, 1);
+		zassert_equal(rc, 0, "Write failed");
+	}
+
+	rc = disk_access_read(DISK_NAME, buf[0], 10, 1);
+	zassert_equal(rc, 0, "Read failed");
+	zassert_equal(buf[0][0], 0x12, "Bad data read");
+
+	if (!IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK)) {
+		zassert_equal(disk_writes, 4, "Writes not done");
+		return;
+	}
+
+	/* Written sectors are read back from the cache */
+	zassert_equal(disk_reads, 0, "Sector read from the disk");
+	zassert_equal(disk_writes, 0, "Writes not delayed");
+
+	/* The sectors are written at once on sync */
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "Sync failed");
+	zassert_equal(disk_writes, 1, "Writes not merged");
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(buf); i++) {
+		zassert_equal(disk_data[8 + i][0], 0x10 + i, "Bad data written");
+	}
+}
+
+ZTEST(disk_cache, test_read_ahead)
+{
+	int rc;
+
+	for (uint32_t i = 0; i < SECTOR_COUNT; i++) {
+		memset(disk_data[i], i, SECTOR_SIZE);
+	}
+
+	/* Sectors following a sequential read are read in advance */
+	for (uint32_t i = 20; i < 30; i++) {
+		rc = disk_access_read(DISK_NAME, buf[0], i, 1);
+		zassert_equal(rc, 0, "Read failed");
+		zassert_equal(buf[0][0], i, "Bad data read");
+	}
+
+	zassert_equal(disk_reads, 5, "Unexpected number of reads (%u)",
+		      disk_reads);
+
+	/* Including at the end of the disk */
+	for (uint32_t i = SECTOR_COUNT - 4; i < SECTOR_COUNT; i++) {
+		rc = disk_access_read(DISK_NAME, buf[0], i, 1);
+		zassert_equal(rc, 0, "Read failed");
+		zassert_equal(buf[0][0], i, "Bad data read");
+	}
+}
+
+ZTEST(disk_cache, test_eviction)
+{
+	int rc;
+
+	/* More sectors than the cache holds */
+	for (uint32_t i = 0; i < SECTOR_COUNT; i++) {
+		memset(buf[0], 0x80 + i, SECTOR_SIZE);
+		rc = disk_access_write(DISK_NAME, buf[0], i, 1);
+		zassert_equal(rc, 0, "Write failed");
+	}
+
+	for (uint32_t i = 0; i < SECTOR_COUNT; i++) {
+		rc = disk_access_read(DISK_NAME, buf[0], i, 1);
+		zassert_equal(rc, 0, "Read failed");
+		zassert_equal(buf[0][0], 0x80 + i, "Bad data read");
+	}
+
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "Sync failed");
+
+	for (uint32_t i = 0; i < SECTOR_COUNT; i++) {
+		zassert_equal(disk_data[i][0], 0x80 + i, "Bad data written");
+	}
+}
+
+static void *disk_cache_setup(void)
+{
+	zassert_equal(disk_access_register(&mock_disk), 0,
+		      "Can't register disk");
+
+	return NULL;
+}
+
+static void disk_cache_before(void *fixture)
+{
+	/* Start with an empty cache */
+	zassert_equal(disk_access_init(DISK_NAME), 0, "Can't init disk");
+	memset(disk_data, 0, sizeof(disk_data));
+	disk_reads = 0;
+	disk_writes = 0;
+}
+
+ZTEST_SUITE(disk_cache, NULL, disk_cache_setup, disk_cache_before, NULL,
+	    NULL);
@@ -0,0 +1,342 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/fs/compress_fs.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/stats/stats.h>
+#include <zephyr/random/rand32.h>
+
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(slot1_partition)
+#define TEST_SIZE		(10 * CONFIG_FS_COMPRESS_BLOCK_SIZE + 123)
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(lfs_data);
+
+static struct fs_mount_t lfs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &lfs_data,
+	.storage_dev = (void *)TEST_PARTITION_ID,
+	.mnt_point = "/lfs",
+};
+
+static struct fs_compress cfs_data = {
+	.backing_dir = "/lfs/z",
+};
+
+static struct fs_mount_t cfs_mnt = {
+	.type = FS_COMPRESS,
+	.fs_data = &cfs_data,
+	.mnt_point = "/cfs",
+};
+
+static uint8_t ref[TEST_SIZE];
+static uint8_t buf[TEST_SIZE];
+
+/* Log-like text, which compresses well */
+static void fill_text(uint8_t *dst, size_t len)
+{
+	static const char line[] = "00:00:12.345 <inf> app: sensor 3 value 1234\n";
+
+	for (size_t i = 0; i < len; i++) {
+		dst[i] = line[i % (sizeof(line) - 1)] + ((i / 512) % 10);
+	}
+}
+
+static void write_file(const char *path, const uint8_t *data, size_t len,
+		       size_t chunk)
+{
+	struct fs_file_t file;
+	size_t done = 0;
+	size_t n;
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, path, FS_O_CREATE | FS_O_RDWR));
+
+	while (done < len) {
+		n = MIN(chunk, len - done);
+		zassert_equal(fs_write(&file, &data[done], n), n);
+		done += n;
+	}
+
+	zassert_ok(fs_close(&file));
+}
+
+static void check_file(const char *path, const uint8_t *data, size_t len)
+{
+	struct fs_dirent entry;
+	struct fs_file_t file;
+
+	zassert_ok(fs_stat(path, &entry));
+	zassert_equal(entry.size, len, "size %zu", entry.size);
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, path, FS_O_READ));
+	memset(buf, 0, sizeof(buf));
+	zassert_equal(fs_read(&file, buf, sizeof(buf)), len);
+	zassert_mem_equal(buf, data, len);
+	zassert_ok(fs_close(&file));
+}
+
+static size_t stored_size(const char *path)
+{
+	struct fs_dirent entry;
+
+	zassert_ok(fs_stat(path, &entry));
+
+	return entry.size;
+}
+
+ZTEST(fs_compress, test_round_trip)
+{
+	fill_text(ref, sizeof(ref));
+
+	write_file("/cfs/text", ref, sizeof(ref), 37);
+	check_file("/cfs/text", ref, sizeof(ref));
+
+	TC_PRINT("Stored %zu bytes for %zu\n", stored_size("/lfs/z/text"),
+		 sizeof(ref));
+	zassert_true(stored_size("/lfs/z/text") < (sizeof(ref) / 2));
+}
+
+ZTEST(fs_compress, test_incompressible)
+{
+	sys_rand_get(ref, sizeof(ref));
+
+	write_file("/cfs/random", ref, sizeof(ref), sizeof(ref));
+	check_file("/cfs/random", ref, sizeof(ref));
+}
+
+ZTEST(fs_compress, test_seek_read)
+{
+	struct fs_file_t file;
+	uint8_t data[300];
+	uint32_t off;
+
+	fill_text(ref, sizeof(ref));
+	write_file("/cfs/seek", ref, sizeof(ref), sizeof(ref));
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, "/cfs/seek", FS_O_READ));
+
+	for (int i = 0; i < 100; i++) {
+		off = sys_rand32_get() % (sizeof(ref) - sizeof(data));
+		zassert_ok(fs_seek(&file, off, FS_SEEK_SET));
+		zassert_equal(fs_read(&file, data, sizeof(data)), sizeof(data));
+		zassert_mem_equal(data, &ref[off], sizeof(data), "at %u", off);
+		zassert_equal(fs_tell(&file), off + sizeof(data));
+	}
+
+	zassert_ok(fs_seek(&file, -10, FS_SEEK_END));
+	zassert_equal(fs_read(&file, data, sizeof(data)), 10);
+	zassert_mem_equal(data, &ref[sizeof(ref) - 10], 10);
+	zassert_equal(fs_seek(&file, 1, FS_SEEK_END), -EINVAL);
+
+	/* Not opened for writing */
+	zassert_equal(fs_write(&file, data, 1), -EBADF);
+
+	zassert_ok(fs_close(&file));
+}
+
+ZTEST(fs_compress, test_append)
+{
+	struct fs_file_t file;
+	size_t half = sizeof(ref) / 2 + 7;
+
+	fill_text(ref, sizeof(ref));
+	write_file("/cfs/append", ref, half, 100);
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, "/cfs/append", FS_O_WRITE | FS_O_APPEND));
+	zassert_equal(fs_write(&file, &ref[half], 10), 10);
+	zassert_ok(fs_sync(&file));
+	zassert_equal(fs_write(&file, &ref[half + 10], sizeof(ref) - half - 10),
+		      sizeof(ref) - half - 10);
+	zassert_ok(fs_close(&file));
+
+	check_file("/cfs/append", ref, sizeof(ref));
+
+	/* Data can not be overwritten */
+	zassert_ok(fs_open(&file, "/cfs/append", FS_O_RDWR));
+	zassert_equal(fs_write(&file, ref, 1), -ENOTSUP);
+	zassert_ok(fs_close(&file));
+}
+
+static int flash_write_calls_find(struct stats_hdr *hdr, void *arg,
+				  const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_write_calls")) {
+		uint32_t **flash_write_stat = (uint32_t **)arg;
+		*flash_write_stat = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t flash_write_calls(void)
+{
+	struct stats_hdr *sim_stats = stats_group_find("flash_sim_stats");
+	uint32_t *flash_write_stat = NULL;
+
+	zassert_not_null(sim_stats, "No flash simulator stats");
+	stats_walk(sim_stats, flash_write_calls_find, &flash_write_stat);
+	zassert_not_null(flash_write_stat, "No flash write counter");
+
+	return *flash_write_stat;
+}
+
+ZTEST(fs_compress, test_read_while_appending)
+{
+	/* Parts of earlier blocks, one crossing a block boundary */
+	static const uint32_t offs[] = {
+		0,
+		700,
+		CONFIG_FS_COMPRESS_BLOCK_SIZE - 150,
+		CONFIG_FS_COMPRESS_BLOCK_SIZE + 300,
+		2 * CONFIG_FS_COMPRESS_BLOCK_SIZE + 1,
+		3 * CONFIG_FS_COMPRESS_BLOCK_SIZE - 300,
+	};
+	struct fs_file_t file;
+	uint8_t data[300];
+	size_t len = 3 * CONFIG_FS_COMPRESS_BLOCK_SIZE + 100;
+	uint32_t writes;
+
+	fill_text(ref, sizeof(ref));
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, "/cfs/rdapp",
+			   FS_O_CREATE | FS_O_RDWR | FS_O_APPEND));
+	zassert_equal(fs_write(&file, ref, len), len);
+
+	for (int i = 0; i < ARRAY_SIZE(offs); i++) {
+		/* The last block stays in the buffer, not written yet */
+		zassert_equal(fs_write(&file, &ref[len], 100), 100);
+		len += 100;
+
+		writes = flash_write_calls();
+		zassert_ok(fs_seek(&file, offs[i], FS_SEEK_SET));
+		zassert_equal(fs_read(&file, data, sizeof(data)), sizeof(data));
+		zassert_mem_equal(data, &ref[offs[i]], sizeof(data), "at %u",
+				  offs[i]);
+		zassert_equal(flash_write_calls(), writes,
+			      "Flash written by a read at %u", offs[i]);
+	}
+
+	zassert_equal(fs_write(&file, &ref[len], sizeof(ref) - len),
+		      sizeof(ref) - len);
+	zassert_ok(fs_close(&file));
+
+	check_file("/cfs/rdapp", ref, sizeof(ref));
+}
+
+ZTEST(fs_compress, test_truncate)
+{
+	static const size_t sizes[] = {
+		TEST_SIZE - 1,
+		5 * CONFIG_FS_COMPRESS_BLOCK_SIZE,
+		3 * CONFIG_FS_COMPRESS_BLOCK_SIZE - 1,
+		1,
+		0,
+	};
+	struct fs_file_t file;
+
+	fill_text(ref, sizeof(ref));
+	write_file("/cfs/trunc", ref, sizeof(ref), sizeof(ref));
+
+	fs_file_t_init(&file);
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		zassert_ok(fs_open(&file, "/cfs/trunc", FS_O_RDWR));
+		zassert_ok(fs_truncate(&file, sizes[i]));
+		zassert_ok(fs_close(&file));
+
+		check_file("/cfs/trunc", ref, sizes[i]);
+	}
+
+	zassert_equal(stored_size("/lfs/z/trunc"), 0);
+
+	/* Growing fills with zeros */
+	zassert_ok(fs_open(&file, "/cfs/trunc", FS_O_RDWR));
+	zassert_equal(fs_write(&file, ref, 10), 10);
+	zassert_ok(fs_truncate(&file, 2 * CONFIG_FS_COMPRESS_BLOCK_SIZE));
+	zassert_equal(fs_tell(&file), 10);
+	zassert_ok(fs_close(&file));
+
+	memset(&ref[10], 0, 2 * CONFIG_FS_COMPRESS_BLOCK_SIZE - 10);
+	check_file("/cfs/trunc", ref, 2 * CONFIG_FS_COMPRESS_BLOCK_SIZE);
+}
+
+ZTEST(fs_compress, test_dir_ops)
+{
+	struct fs_dirent entry;
+	struct fs_dir_t dir;
+	int files = 0;
+
+	fill_text(ref, sizeof(ref));
+
+	zassert_ok(fs_mkdir("/cfs/dir"));
+	write_file("/cfs/dir/a", ref, 1000, 1000);
+	write_file("/cfs/dir/b", ref, 3000, 1000);
+	zassert_ok(fs_mkdir("/cfs/dir/sub"));
+
+	fs_dir_t_init(&dir);
+	zassert_ok(fs_opendir(&dir, "/cfs/dir"));
+	while ((fs_readdir(&dir, &entry) == 0) && (entry.name[0] != '\0')) {
+		if (strcmp(entry.name, "a") == 0) {
+			zassert_equal(entry.size, 1000);
+			files++;
+		} else if (strcmp(entry.name, "b") == 0) {
+			zassert_equal(entry.size, 3000);
+			files++;
+		} else {
+			zassert_equal(entry.type, FS_DIR_ENTRY_DIR);
+		}
+	}
+	zassert_ok(fs_closedir(&dir));
+	zassert_equal(files, 2);
+
+	zassert_ok(fs_rename("/cfs/dir/b", "/cfs/dir/sub/c"));
+	check_file("/cfs/dir/sub/c", ref, 3000);
+	zassert_ok(fs_unlink("/cfs/dir/sub/c"));
+	zassert_equal(fs_stat("/cfs/dir/sub/c", &entry), -ENOENT);
+	zassert_equal(fs_stat("/lfs/z/dir/sub/c", &entry), -ENOENT);
+}
+
+ZTEST(fs_compress, test_bad_backing_dir)
+{
+	static struct fs_compress bad = {
+		.backing_dir = "/cfs2/z",
+	};
+	static struct fs_mount_t mnt = {
+		.type = FS_COMPRESS,
+		.fs_data = &bad,
+		.mnt_point = "/cfs2",
+	};
+
+	zassert_equal(fs_mount(&mnt), -EINVAL);
+}
+
+static void *fs_compress_setup(void)
+{
+	const struct flash_area *fa;
+
+	zassert_ok(flash_area_open(TEST_PARTITION_ID, &fa));
+	zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+	flash_area_close(fa);
+
+	zassert_ok(fs_mount(&lfs_mnt));
+	zassert_ok(fs_mount(&cfs_mnt));
+
+	return NULL;
+}
+
+static void fs_compress_teardown(void *fixture)
+{
+	zassert_ok(fs_unmount(&cfs_mnt));
+	zassert_ok(fs_unmount(&lfs_mnt));
+}
+
+ZTEST_SUITE(fs_compress, NULL, fs_compress_setup, NULL, NULL,
+	    fs_compress_teardown);
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "fcb_test.h"
+
+#define TEST_BATCH_CNT	8
+
+static void test_fcb_append_batch(struct fcb *_fcb)
+{
+	static uint8_t test_data[128][128];
+	const void *data[TEST_BATCH_CNT];
+	uint16_t lens[TEST_BATCH_CNT];
+	int rc;
+	int i;
+	int j;
+	int var_cnt;
+
+	for (i = 0; i < ARRAY_SIZE(test_data); i++) {
+		for (j = 0; j < i; j++) {
+			test_data[i][j] = fcb_test_append_data(i, j);
+		}
+	}
+
+	/* Entries of length 0 to 127, in batches */
+	for (i = 0; i < ARRAY_SIZE(test_data); i += TEST_BATCH_CNT) {
+		for (j = 0; j < TEST_BATCH_CNT; j++) {
+			data[j] = test_data[i + j];
+			lens[j] = i + j;
+		}
+		rc = fcb_append_batch(_fcb, data, lens, TEST_BATCH_CNT);
+		zassert_true(rc == 0, "fcb_append_batch call failure");
+	}
+
+	var_cnt = 0;
+	rc = fcb_walk(_fcb, 0, fcb_test_data_walk_cb, &var_cnt);
+	zassert_true(rc == 0, "fcb_walk call failure");
+	zassert_true(var_cnt == ARRAY_SIZE(test_data),
+		     "fetched data size not match to wrote data size");
+
+	/* An empty batch appends nothing */
+	rc = fcb_append_batch(_fcb, NULL, NULL, 0);
+	zassert_true(rc == 0, "fcb_append_batch of no entries failure");
+
+	var_cnt = 0;
+	rc = fcb_walk(_fcb, 0, fcb_test_data_walk_cb, &var_cnt);
+	zassert_true(rc == 0, "fcb_walk call failure");
+	zassert_true(var_cnt == ARRAY_SIZE(test_data),
+		     "fetched data size not match to wrote data size");
+}
+
+ZTEST(fcb_test_with_2sectors_set, test_fcb_append_batch_2sectors)
+{
+	test_fcb_append_batch(&test_fcb);
+}
+
+ZTEST(fcb_test_crc_disabled, test_fcb_append_batch_crc_disabled)
+{
+	test_fcb_append_batch(&test_fcb_crc_disabled);
+}
+
+ZTEST(fcb_test_with_2sectors_set, test_fcb_append_batch_fill)
+{
+	struct fcb *fcb;
+	uint8_t test_data[128];
+	const void *data[TEST_BATCH_CNT];
+	uint16_t lens[TEST_BATCH_CNT];
+	int elem_cnts[2] = {0, 0};
+	struct append_arg aa = {
+		.elem_cnts = elem_cnts
+	};
+	int appended = 0;
+	int rc;
+	int i;
+
+	fcb = &test_fcb;
+
+	for (i = 0; i < sizeof(test_data); i++) {
+		test_data[i] = fcb_test_append_data(sizeof(test_data), i);
+	}
+	for (i = 0; i < TEST_BATCH_CNT; i++) {
+		data[i] = test_data;
+		lens[i] = sizeof(test_data);
+	}
+
+	/* Batches cross into the second sector, then run out of space */
+	while (1) {
+		rc = fcb_append_batch(fcb, data, lens, TEST_BATCH_CNT);
+		if (rc == -ENOSPC) {
+			break;
+		}
+		zassert_true(rc == 0, "fcb_append_batch call failure");
+		appended += TEST_BATCH_CNT;
+	}
+
+	rc = fcb_walk(fcb, NULL, fcb_test_cnt_elems_cb, &aa);
+	zassert_true(rc == 0, "fcb_walk call failure");
+	zassert_true(elem_cnts[0] > 0, "no elements in the first sector");
+	zassert_true(elem_cnts[0] == elem_cnts[1],
+		     "both sectors should be filled alike");
+	zassert_true(elem_cnts[0] + elem_cnts[1] >= appended,
+		     "fcb_walk: elements count read different than expected");
+	zassert_true(elem_cnts[0] + elem_cnts[1] < appended + TEST_BATCH_CNT,
+		     "fcb_walk: elements count read different than expected");
+}
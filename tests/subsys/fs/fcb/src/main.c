@@ -18,6 +18,10 @@ struct fcb test_fcb_crc_disabled = { .f_flags = FCB_FLAGS_CRC_DISABLED };
 
 uint8_t fcb_test_erase_value;
 
+#ifdef CONFIG_FCB_INDEX
+static struct fcb_index_entry test_fcb_index[64];
+#endif
+
 #if defined(CONFIG_SOC_SERIES_STM32H7X)
 	#define SECTOR_SIZE 0x20000 /* 128K */
 #else
@@ -118,6 +122,10 @@ void fcb_tc_pretest(int sectors, struct fcb *_fcb)
 	_fcb->f_erase_value = fcb_test_erase_value;
 	_fcb->f_sector_cnt = sectors;
 	_fcb->f_sectors = test_fcb_sector; /* XXX */
+#ifdef CONFIG_FCB_INDEX
+	_fcb->f_index = test_fcb_index;
+	_fcb->f_index_cnt = ARRAY_SIZE(test_fcb_index);
+#endif
 
 	rc = 0;
 	rc = fcb_init(TEST_FCB_FLASH_AREA_ID, _fcb);
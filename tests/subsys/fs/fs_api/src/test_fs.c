@@ -23,6 +23,8 @@ static int file_length;
 static struct fs_mount_t *mp[FS_TYPE_EXTERNAL_BASE];
 static bool nospace;
 static int opendir_result;
+static int stat_result;
+static int stat_calls;
 
 static
 int temp_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
@@ -288,9 +290,29 @@ static int temp_stat(struct fs_mount_t *mountp,
 		return -EINVAL;
 	}
 
+	stat_calls++;
+	if (stat_result < 0) {
+		return stat_result;
+	}
+
+	strncpy(entry->name, strrchr(path, '/') + 1, sizeof(entry->name) - 1);
+	entry->name[sizeof(entry->name) - 1] = '\0';
+	entry->type = FS_DIR_ENTRY_FILE;
+	entry->size = file_length;
+
 	return 0;
 }
 
+void mock_stat_result(int ret)
+{
+	stat_result = ret;
+}
+
+int mock_stat_calls(void)
+{
+	return stat_calls;
+}
+
 static int temp_statvfs(struct fs_mount_t *mountp,
 			 const char *path, struct fs_statvfs *stat)
 {
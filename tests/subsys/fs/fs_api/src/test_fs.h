@@ -33,4 +33,6 @@ struct test_fs_data {
 };
 
 void mock_opendir_result(int ret);
+void mock_stat_result(int ret);
+int mock_stat_calls(void);
 #endif
@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_fs.h"
+#include <string.h>
+
+#define CACHE_MNTP	"/NAND:"
+#define CACHE_SUB_MNTP	CACHE_MNTP"/SUB:"
+#define CACHE_FILE	CACHE_MNTP"/file.txt"
+#define CACHE_MISSING	CACHE_MNTP"/missing.txt"
+#define CACHE_NEW	CACHE_MNTP"/new.txt"
+#define CACHE_LOG	CACHE_MNTP"/log.txt"
+
+static struct test_fs_data cache_data;
+static struct fs_mount_t cache_mnt = {
+		.type = TEST_FS_1,
+		.mnt_point = CACHE_MNTP,
+		.fs_data = &cache_data,
+};
+
+static struct test_fs_data cache_sub_data;
+static struct fs_mount_t cache_sub_mnt = {
+		.type = TEST_FS_2,
+		.mnt_point = CACHE_SUB_MNTP,
+		.fs_data = &cache_sub_data,
+};
+
+static int expected_calls(int uncached, int cached)
+{
+	return IS_ENABLED(CONFIG_FILE_SYSTEM_PATH_CACHE) ? cached : uncached;
+}
+
+/**
+ * @brief Test that a path resolves to its longest matching mount point
+ *
+ * @ingroup filesystem_api
+ */
+ZTEST(fs_api_path_cache, test_mount_longest_match)
+{
+	int ret;
+
+	/* The longest match is found whatever the mount order */
+	ret = fs_rename(CACHE_SUB_MNTP"/a.txt", CACHE_MNTP"/b.txt");
+	zassert_equal(ret, -EINVAL, "Rename across mount points");
+
+	ret = fs_rename(CACHE_MNTP"/a.txt", CACHE_MNTP"/b.txt");
+	zassert_equal(ret, 0, "Fail to rename a file");
+
+	ret = fs_rename(CACHE_SUB_MNTP"/a.txt", CACHE_SUB_MNTP"/b.txt");
+	zassert_equal(ret, 0, "Fail to rename a file");
+
+	/* Not a separate mount point, the name only starts the same */
+	ret = fs_rename(CACHE_MNTP"/SUB:x/a.txt", CACHE_MNTP"/b.txt");
+	zassert_equal(ret, 0, "Fail to rename a file");
+}
+
+/**
+ * @brief Test the cache of resolved paths
+ *
+ * @ingroup filesystem_api
+ */
+ZTEST(fs_api_path_cache, test_path_cache)
+{
+	struct fs_dirent entry;
+	struct fs_file_t file;
+	int calls = mock_stat_calls();
+	int ret;
+
+	fs_file_t_init(&file);
+
+	ret = fs_stat(CACHE_FILE, &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	ret = fs_stat(CACHE_FILE, &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(strcmp(entry.name, "file.txt"), 0, "Bad name");
+	zassert_equal(mock_stat_calls() - calls, expected_calls(2, 1),
+		      "Stat not cached");
+
+	/* An unlink invalidates the cache */
+	ret = fs_unlink(CACHE_FILE);
+	zassert_equal(ret, 0, "Fail to delete a file");
+	ret = fs_stat(CACHE_FILE, &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(mock_stat_calls() - calls, expected_calls(3, 2),
+		      "Cache not invalidated");
+
+	/* Paths which do not exist are cached too */
+	mock_stat_result(-ENOENT);
+	ret = fs_stat(CACHE_MISSING, &entry);
+	zassert_equal(ret, -ENOENT, "Stat a not existing file");
+	ret = fs_stat(CACHE_MISSING, &entry);
+	zassert_equal(ret, -ENOENT, "Stat a not existing file");
+	zassert_equal(mock_stat_calls() - calls, expected_calls(5, 3),
+		      "Stat not cached");
+
+	if (IS_ENABLED(CONFIG_FILE_SYSTEM_PATH_CACHE)) {
+		ret = fs_open(&file, CACHE_MISSING, FS_O_READ);
+		zassert_equal(ret, -ENOENT, "Open a not existing file");
+		ret = fs_unlink(CACHE_MISSING);
+		zassert_equal(ret, -ENOENT, "Delete a not existing file");
+	}
+
+	/* A rename invalidates the cache */
+	ret = fs_rename(CACHE_FILE, CACHE_MISSING);
+	zassert_equal(ret, 0, "Fail to rename a file");
+	mock_stat_result(0);
+	ret = fs_stat(CACHE_MISSING, &entry);
+	zassert_equal(ret, 0, "Fail to stat a renamed file");
+
+	/* So does an unmount */
+	calls = mock_stat_calls();
+	ret = fs_stat(CACHE_SUB_MNTP"/file.txt", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	ret = fs_unmount(&cache_sub_mnt);
+	zassert_equal(ret, 0, "Fail to unmount");
+	ret = fs_stat(CACHE_SUB_MNTP"/file.txt", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(mock_stat_calls() - calls, 2, "Cache not invalidated");
+	ret = fs_mount(&cache_sub_mnt);
+	zassert_equal(ret, 0, "Fail to mount");
+}
+
+/**
+ * @brief Test that changing a file only drops the cached stat of its path
+ *
+ * @ingroup filesystem_api
+ */
+ZTEST(fs_api_path_cache, test_path_cache_file_change)
+{
+	struct fs_dirent entry;
+	struct fs_file_t file;
+	int calls;
+	int ret;
+
+	fs_file_t_init(&file);
+
+	/* Start from an empty cache */
+	ret = fs_unlink(CACHE_FILE);
+	zassert_equal(ret, 0, "Fail to delete a file");
+
+	calls = mock_stat_calls();
+	ret = fs_stat(CACHE_FILE, &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	mock_stat_result(-ENOENT);
+	ret = fs_stat(CACHE_NEW, &entry);
+	zassert_equal(ret, -ENOENT, "Stat a not existing file");
+	mock_stat_result(0);
+
+	/* Appending to a log keeps other paths cached */
+	ret = fs_open(&file, CACHE_LOG, FS_O_CREATE | FS_O_WRITE);
+	zassert_equal(ret, 0, "Fail to open a file");
+	fs_write(&file, "x", 1);
+	ret = fs_close(&file);
+	zassert_equal(ret, 0, "Fail to close a file");
+
+	ret = fs_stat(CACHE_FILE, &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(mock_stat_calls() - calls, expected_calls(3, 2),
+		      "Stat of another path not cached");
+
+	/* Creating a file drops its cached absence */
+	ret = fs_open(&file, CACHE_NEW, FS_O_CREATE | FS_O_WRITE);
+	zassert_equal(ret, 0, "Fail to create a file");
+	ret = fs_stat(CACHE_NEW, &entry);
+	zassert_equal(ret, 0, "Fail to stat a created file");
+	zassert_equal(mock_stat_calls() - calls, expected_calls(4, 3),
+		      "Cache not invalidated");
+	ret = fs_close(&file);
+	zassert_equal(ret, 0, "Fail to close a file");
+}
+
+static void *fs_api_path_cache_setup(void)
+{
+	fs_register(TEST_FS_1, &temp_fs);
+	fs_register(TEST_FS_2, &temp_fs);
+	/* Longest mount point first */
+	fs_mount(&cache_sub_mnt);
+	fs_mount(&cache_mnt);
+	return NULL;
+}
+
+static void fs_api_path_cache_teardown(void *fixture)
+{
+	fs_unmount(&cache_mnt);
+	fs_unmount(&cache_sub_mnt);
+	fs_unregister(TEST_FS_2, &temp_fs);
+	fs_unregister(TEST_FS_1, &temp_fs);
+}
+
+ZTEST_SUITE(fs_api_path_cache, NULL, fs_api_path_cache_setup, NULL, NULL,
+	    fs_api_path_cache_teardown);
@@ -175,6 +175,9 @@ ZTEST_F(nvs, test_nvs_corrupted_write)
 	uint32_t *flash_write_stat;
 	uint32_t *flash_max_write_calls;
 
+	/* The background gc makes the number of flash writes unpredictable */
+	Z_TEST_SKIP_IFDEF(CONFIG_NVS_GC_BACKGROUND);
+
 	err = nvs_mount(&fixture->fs);
 	zassert_true(err == 0,  "nvs_mount call failure: %d", err);
 
@@ -463,6 +466,9 @@ ZTEST_F(nvs, test_nvs_corrupted_sector_close_operation)
 	/* 25th write will trigger GC. */
 	const uint16_t max_writes = 26;
 
+	/* The background gc makes the number of flash writes unpredictable */
+	Z_TEST_SKIP_IFDEF(CONFIG_NVS_GC_BACKGROUND);
+
 	/* Get the address of simulator parameters. */
 	stats_walk(fixture->sim_thresholds, flash_sim_max_write_calls_find,
 		   &flash_max_write_calls);
@@ -869,3 +875,242 @@ ZTEST_F(nvs, test_nvs_cache_gc)
 	zassert_equal(num, 2, "invalid cache content after gc");
 #endif
 }
+
+static int flash_sim_read_calls_find(struct stats_hdr *hdr, void *arg,
+				     const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		uint32_t **flash_read_stat = (uint32_t **) arg;
+		*flash_read_stat = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+/*
+ * Test that the NVS ID index finds IDs without walking the allocation table,
+ * and IDs that are not stored without reading the flash.
+ */
+ZTEST_F(nvs, test_nvs_index_lookup)
+{
+#ifdef CONFIG_NVS_INDEX
+	int err;
+	uint32_t *flash_read_stat;
+	uint32_t read_calls;
+	uint16_t id;
+	uint16_t data;
+
+	stats_walk(fixture->sim_stats, flash_sim_read_calls_find, &flash_read_stat);
+
+	fixture->fs.sector_count = 3;
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	for (id = 0; id < 8; id++) {
+		data = id;
+		err = nvs_write(&fixture->fs, id, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+	}
+
+	read_calls = *flash_read_stat;
+	err = nvs_read(&fixture->fs, 100, &data, sizeof(data));
+	zassert_equal(err, -ENOENT, "nvs_read unexpected result: %d", err);
+	zassert_equal(*flash_read_stat, read_calls, "flash read for a missing ID");
+
+	/* One read for the ATE and one for the data */
+	read_calls = *flash_read_stat;
+	err = nvs_read(&fixture->fs, 0, &data, sizeof(data));
+	zassert_equal(err, sizeof(data), "nvs_read call failure: %d", err);
+	zassert_equal(data, 0, "incorrect data read");
+	zassert_equal(*flash_read_stat, read_calls + 2, "allocation table walked");
+
+	/* A deleted ID is found missing as well */
+	err = nvs_delete(&fixture->fs, 1);
+	zassert_equal(err, 0, "nvs_delete call failure: %d", err);
+	err = nvs_read(&fixture->fs, 1, &data, sizeof(data));
+	zassert_equal(err, -ENOENT, "nvs_read unexpected result: %d", err);
+#else
+	ztest_test_skip();
+#endif
+}
+
+/*
+ * Test that IDs left out of a full NVS ID index are still found.
+ */
+ZTEST_F(nvs, test_nvs_index_full)
+{
+#ifdef CONFIG_NVS_INDEX
+	int err;
+	uint16_t id;
+	uint16_t data;
+
+	fixture->fs.sector_count = 3;
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	for (id = 0; id < CONFIG_NVS_INDEX_SIZE + 4; id++) {
+		data = id;
+		err = nvs_write(&fixture->fs, id, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+	}
+
+	for (int i = 0; i < 2; i++) {
+		for (id = 0; id < CONFIG_NVS_INDEX_SIZE + 4; id++) {
+			err = nvs_read(&fixture->fs, id, &data, sizeof(data));
+			zassert_equal(err, sizeof(data), "nvs_read call failure: %d", err);
+			zassert_equal(data, id, "incorrect data read");
+		}
+
+		err = nvs_read(&fixture->fs, CONFIG_NVS_INDEX_SIZE + 4, &data, sizeof(data));
+		zassert_equal(err, -ENOENT, "nvs_read unexpected result: %d", err);
+
+		/* The index is rebuilt on mount */
+		err = nvs_mount(&fixture->fs);
+		zassert_true(err == 0, "nvs_mount call failure: %d", err);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+/*
+ * Test that the background gc closes the sector being written before it is
+ * full, so that writes do not have to run the gc themselves.
+ */
+ZTEST_F(nvs, test_nvs_gc_background)
+{
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	int err;
+	uint32_t *flash_erase_stat;
+	uint32_t erase_calls;
+	uint16_t data = 0;
+	uint16_t rd_data;
+
+	stats_walk(fixture->sim_stats, flash_sim_erase_calls_find, &flash_erase_stat);
+
+	fixture->fs.sector_count = 3;
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	/* Keep writing ID 1 until the background gc moves it to sector 1 */
+	while ((fixture->fs.ate_wra >> ADDR_SECT_SHIFT) == 0 || fixture->fs.gc.active) {
+		erase_calls = *flash_erase_stat;
+
+		++data;
+		err = nvs_write(&fixture->fs, 1, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+		zassert_equal(*flash_erase_stat, erase_calls, "gc run by nvs_write");
+
+		/* Let the system work queue run the gc */
+		k_sleep(K_MSEC(1));
+	}
+
+	zassert_true(*flash_erase_stat > 0, "gc not run");
+
+	err = nvs_read(&fixture->fs, 1, &rd_data, sizeof(rd_data));
+	zassert_equal(err, sizeof(rd_data), "nvs_read call failure: %d", err);
+	zassert_equal(rd_data, data, "incorrect data read");
+
+	/* The content is kept across a remount */
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+	err = nvs_read(&fixture->fs, 1, &rd_data, sizeof(rd_data));
+	zassert_equal(err, sizeof(rd_data), "nvs_read call failure: %d", err);
+	zassert_equal(rd_data, data, "incorrect data read after remount");
+#else
+	ztest_test_skip();
+#endif
+}
+
+#ifdef CONFIG_NVS_GC_BACKGROUND
+static K_SEM_DEFINE(gc_hold_sem, 0, 1);
+
+/* Hold the system work queue, and the background gc with it */
+static void gc_hold_handler(struct k_work *work)
+{
+	k_sem_take(&gc_hold_sem, K_FOREVER);
+}
+
+static K_WORK_DEFINE(gc_hold_work, gc_hold_handler);
+#endif
+
+/*
+ * Test that a background gc interrupted by a reset is resumed at the next
+ * mount without losing the entries written while it was in progress.
+ */
+ZTEST_F(nvs, test_nvs_gc_background_interrupted)
+{
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	int err;
+	uint16_t i = 0;
+	uint32_t *flash_write_stat;
+	uint32_t *flash_erase_stat;
+	uint32_t *flash_max_write_calls;
+	uint32_t *flash_max_erase_calls;
+	const uint16_t max_id = 10;
+	const uint16_t user_id = max_id;
+	uint32_t user_data = 0xdeadbeef;
+	uint32_t rd_data;
+
+	stats_walk(fixture->sim_thresholds, flash_sim_max_write_calls_find,
+		   &flash_max_write_calls);
+	stats_walk(fixture->sim_thresholds, flash_sim_max_erase_calls_find,
+		   &flash_max_erase_calls);
+	stats_walk(fixture->sim_stats, flash_sim_write_calls_find, &flash_write_stat);
+	stats_walk(fixture->sim_stats, flash_sim_erase_calls_find, &flash_erase_stat);
+
+	fixture->fs.sector_count = 3;
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	/* Fill sector 0, the first gc collects the empty sector 2 */
+	while ((fixture->fs.ate_wra >> ADDR_SECT_SHIFT) == 0 || fixture->fs.gc.active) {
+		write_content(max_id, i, i + 1, &fixture->fs);
+		i++;
+		k_sleep(K_MSEC(1));
+	}
+
+	/* Fill sector 1 until the gc of sector 0 is requested */
+	(void)k_work_submit(&gc_hold_work);
+	k_yield();
+	while (!k_work_is_pending(&fixture->fs.gc_work)) {
+		write_content(max_id, i, i + 1, &fixture->fs);
+		i++;
+	}
+
+	/* Let the gc run a single step */
+	(void)k_work_submit(&gc_hold_work);
+	k_sem_give(&gc_hold_sem);
+	k_sleep(K_MSEC(1));
+	zassert_true(fixture->fs.gc.active && fixture->fs.gc.moving,
+		     "gc not in progress");
+	zassert_equal(fixture->fs.ate_wra >> ADDR_SECT_SHIFT, 2,
+		      "unexpected write sector");
+
+	/* Written to sector 2 in the middle of the gc */
+	err = nvs_write(&fixture->fs, user_id, &user_data, sizeof(user_data));
+	zassert_equal(err, sizeof(user_data), "nvs_write call failure: %d", err);
+
+	/* Power down, the rest of the gc does not reach the flash */
+	*flash_write_stat = 0;
+	*flash_max_write_calls = 1;
+	*flash_erase_stat = 1;
+	*flash_max_erase_calls = 1;
+
+	k_sem_give(&gc_hold_sem);
+	k_sleep(K_MSEC(10));
+
+	*flash_max_write_calls = 0;
+	*flash_max_erase_calls = 0;
+
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	check_content(max_id, &fixture->fs);
+	err = nvs_read(&fixture->fs, user_id, &rd_data, sizeof(rd_data));
+	zassert_equal(err, sizeof(rd_data), "nvs_read call failure: %d", err);
+	zassert_equal(rd_data, user_data, "entry written during gc lost");
+#else
+	ztest_test_skip();
+#endif
+}
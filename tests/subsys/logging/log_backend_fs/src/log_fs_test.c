@@ -16,6 +16,8 @@
 #include <zephyr/ztest.h>
 #include <zephyr/fs/fs.h>
 
+#include "log_backend_fs_priv.h"
+
 #define DT_DRV_COMPAT zephyr_fstab_littlefs
 #define TEST_AUTOMOUNT DT_PROP(DT_DRV_INST(0), automount)
 #if !TEST_AUTOMOUNT
@@ -28,8 +30,6 @@ FS_FSTAB_DECLARE_ENTRY(PARTITION_NODE);
 
 static const char *log_prefix = CONFIG_LOG_BACKEND_FS_FILE_PREFIX;
 
-int write_log_to_file(uint8_t *data, size_t length, void *ctx);
-
 
 ZTEST(test_log_backend_fs, test_fs_nonexist)
 {
@@ -230,4 +230,92 @@ ZTEST(test_log_backend_fs, test_log_fs_files_max)
 	zassert_equal(test_mask, 0b11110, "Unexpected file numeration");
 }
 
+#ifdef CONFIG_LOG_BACKEND_FS_BUFFERED
+/* Get size and end of the newest log file. */
+static void newest_file_tail(char *tail, size_t len, size_t *size)
+{
+	struct fs_dir_t dir;
+	struct fs_dirent ent;
+	struct fs_file_t file;
+	char fname[MAX_PATH_LEN];
+	int newest = -1;
+	int rc;
+
+	fs_dir_t_init(&dir);
+	fs_file_t_init(&file);
+
+	rc = fs_opendir(&dir, CONFIG_LOG_BACKEND_FS_DIR);
+	zassert_equal(rc, 0, "Can not open directory.");
+	while (true) {
+		rc = fs_readdir(&dir, &ent);
+		if ((rc < 0) || (ent.name[0] == 0)) {
+			break;
+		}
+		if (strncmp(ent.name, log_prefix, strlen(log_prefix)) == 0) {
+			newest = MAX(newest, atoi(&ent.name[strlen(log_prefix)]));
+		}
+	}
+	(void)fs_closedir(&dir);
+	zassert_true(newest >= 0, "No log file");
+
+	sprintf(fname, "%s/%s%04d", CONFIG_LOG_BACKEND_FS_DIR, log_prefix, newest);
+	zassert_equal(fs_stat(fname, &ent), 0, "Can not get file info.");
+	*size = ent.size;
+
+	memset(tail, 0, len);
+	zassert_equal(fs_open(&file, fname, FS_O_READ), 0, "Can not open log file.");
+	if (ent.size >= len) {
+		zassert_equal(fs_seek(&file, ent.size - len, FS_SEEK_SET), 0);
+		zassert_equal(fs_read(&file, tail, len), len, "Can not read log file.");
+	}
+	zassert_equal(fs_close(&file), 0, "Can not close log file.");
+}
+#endif
+
+ZTEST(test_log_backend_fs, test_log_fs_write_buffered)
+{
+#ifndef CONFIG_LOG_BACKEND_FS_BUFFERED
+	ztest_test_skip();
+#else
+	uint8_t to_log[] = "Buffered";
+	uint8_t fill[CONFIG_LOG_BACKEND_FS_BUFFER_SIZE];
+	char tail[sizeof(to_log)];
+	size_t size;
+	size_t off;
+
+	flush_log_buffer();
+
+	/* Data is kept in RAM until flushed. */
+	off = 0;
+	while (off < sizeof(to_log)) {
+		off += write_log_to_buffer(&to_log[off], sizeof(to_log) - off, NULL);
+	}
+	newest_file_tail(tail, sizeof(tail), &size);
+	zassert_not_equal(memcmp(tail, to_log, sizeof(to_log)), 0, "Data written");
+
+	flush_log_buffer();
+	newest_file_tail(tail, sizeof(tail), &size);
+	zassert_mem_equal(tail, to_log, sizeof(to_log), "Data not written");
+
+	/* Full chunks are written aligned on the chunk size. */
+	memset(fill, '.', sizeof(fill));
+	off = 0;
+	while (off < sizeof(fill)) {
+		off += write_log_to_buffer(&fill[off], sizeof(fill) - off, NULL);
+	}
+	newest_file_tail(tail, sizeof(tail), &size);
+	zassert_equal(size % CONFIG_LOG_BACKEND_FS_BUFFER_SIZE, 0,
+		      "Unaligned file size %zu", size);
+
+	/* Data is written after the timeout. */
+	off = 0;
+	while (off < sizeof(to_log)) {
+		off += write_log_to_buffer(&to_log[off], sizeof(to_log) - off, NULL);
+	}
+	k_msleep(CONFIG_LOG_BACKEND_FS_FLUSH_TIMEOUT_MS + 100);
+	newest_file_tail(tail, sizeof(tail), &size);
+	zassert_mem_equal(tail, to_log, sizeof(to_log), "Data not written");
+#endif
+}
+
 ZTEST_SUITE(test_log_backend_fs, NULL, NULL, NULL, NULL, NULL);
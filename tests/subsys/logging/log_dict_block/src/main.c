@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test block framing of dictionary based log messages
+ */
+
+#include <zephyr/logging/log_output_dict.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#define BLOCK_SIZE 64
+#define MAX_BLOCKS 32
+
+static uint8_t sink_buf[2048];
+static size_t sink_len;
+static uint32_t sink_calls;
+
+static uint8_t decoded[2048];
+static size_t decoded_len;
+static size_t raw_lens[MAX_BLOCKS];
+static uint16_t first_seq;
+
+static int sink(uint8_t *data, size_t length, void *ctx)
+{
+	zassert_equal_ptr(ctx, &sink_len, "Unexpected context");
+	zassert_true(sink_len + length <= sizeof(sink_buf), "Sink overflow");
+
+	memcpy(&sink_buf[sink_len], data, length);
+	sink_len += length;
+	sink_calls++;
+
+	return length;
+}
+
+LOG_DICT_BLOCK_DEFINE(block, sink, BLOCK_SIZE);
+
+/* Append one message, passed in small chunks as log_output would do. */
+static void msg_write(const uint8_t *data, size_t len)
+{
+	size_t off = 0;
+
+	while (off < len) {
+		size_t chunk = MIN(len - off, 5);
+
+		off += log_dict_block_out((uint8_t *)&data[off], chunk, &block);
+	}
+
+	log_dict_block_commit(&block);
+}
+
+static size_t payload_decode(const uint8_t *payload, size_t len, bool compressed)
+{
+	size_t out = decoded_len;
+
+	if (!compressed) {
+		memcpy(&decoded[out], payload, len);
+		return len;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		if (payload[i] != 0U) {
+			decoded[out++] = payload[i];
+		} else {
+			zassert_true(i + 1 < len, "Truncated zero run");
+			i++;
+			memset(&decoded[out], 0, payload[i]);
+			out += payload[i];
+		}
+	}
+
+	return out - decoded_len;
+}
+
+/* Check the blocks received by the sink and concatenate their decoded
+ * payload. Returns the number of blocks.
+ */
+static int blocks_decode(void)
+{
+	size_t off = 0;
+	int cnt = 0;
+
+	decoded_len = 0;
+	while (off < sink_len) {
+		struct log_dict_output_block_hdr_t hdr;
+		uint16_t len;
+		size_t raw_len;
+
+		zassert_true(cnt < MAX_BLOCKS);
+		memcpy(&hdr, &sink_buf[off], sizeof(hdr));
+		off += sizeof(hdr);
+
+		zassert_mem_equal(hdr.magic, "ZLDB", sizeof(hdr.magic), "Bad magic");
+		zassert_equal(hdr.version, LOG_DICT_BLOCK_VERSION);
+		zassert_equal(sys_le16_to_cpu(hdr.seq), (uint16_t)(first_seq + cnt),
+			      "Unexpected sequence number");
+
+		len = sys_le16_to_cpu(hdr.len);
+		raw_len = payload_decode(&sink_buf[off], len,
+					 hdr.flags & LOG_DICT_BLOCK_FLAG_COMPRESSED);
+		zassert_equal(raw_len, sys_le16_to_cpu(hdr.raw_len));
+		zassert_true(raw_len <= BLOCK_SIZE);
+		zassert_true(len <= raw_len, "Block expanded");
+
+		raw_lens[cnt++] = raw_len;
+		decoded_len += raw_len;
+		off += len;
+	}
+
+	return cnt;
+}
+
+static void block_reset(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	log_dict_block_flush(&block);
+	log_dict_block_ctx_set(&block, &sink_len);
+	first_seq = block.seq;
+	sink_len = 0;
+	sink_calls = 0;
+}
+
+ZTEST(log_dict_block, test_messages_kept_whole)
+{
+	uint8_t msg[24];
+	uint8_t expected[sizeof(msg) * 5];
+	int cnt;
+
+	for (int i = 0; i < 5; i++) {
+		memset(msg, 'a' + i, sizeof(msg));
+		memcpy(&expected[i * sizeof(msg)], msg, sizeof(msg));
+		msg_write(msg, sizeof(msg));
+	}
+
+	/* Two messages fit in a block, the third one goes to the next. */
+	zassert_equal(sink_calls, 2);
+
+	log_dict_block_flush(&block);
+	zassert_equal(sink_calls, 3);
+
+	cnt = blocks_decode();
+	zassert_equal(cnt, 3);
+	zassert_equal(raw_lens[0], 2 * sizeof(msg));
+	zassert_equal(raw_lens[1], 2 * sizeof(msg));
+	zassert_equal(raw_lens[2], sizeof(msg));
+	zassert_equal(decoded_len, sizeof(expected));
+	zassert_mem_equal(decoded, expected, sizeof(expected));
+}
+
+ZTEST(log_dict_block, test_long_message_split)
+{
+	uint8_t msg[BLOCK_SIZE * 2 + 10];
+	uint8_t first[8];
+	int cnt;
+
+	for (size_t i = 0; i < sizeof(msg); i++) {
+		msg[i] = (uint8_t)(i + 1);
+	}
+	memset(first, 0x55, sizeof(first));
+
+	msg_write(first, sizeof(first));
+	msg_write(msg, sizeof(msg));
+	log_dict_block_flush(&block);
+
+	cnt = blocks_decode();
+	zassert_equal(cnt, 4);
+	zassert_equal(raw_lens[0], sizeof(first));
+	zassert_equal(decoded_len, sizeof(first) + sizeof(msg));
+	zassert_mem_equal(decoded, first, sizeof(first));
+	zassert_mem_equal(&decoded[sizeof(first)], msg, sizeof(msg));
+}
+
+ZTEST(log_dict_block, test_partial_message_not_flushed)
+{
+	uint8_t msg[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+	msg_write(msg, sizeof(msg));
+	(void)log_dict_block_out(msg, 4, &block);
+
+	/* Only the complete message is sent. */
+	log_dict_block_flush(&block);
+	zassert_equal(blocks_decode(), 1);
+	zassert_equal(decoded_len, sizeof(msg));
+
+	log_dict_block_commit(&block);
+	sink_len = 0;
+	first_seq = block.seq;
+	log_dict_block_flush(&block);
+	zassert_equal(blocks_decode(), 1);
+	zassert_equal(decoded_len, 4);
+}
+
+ZTEST(log_dict_block, test_compression)
+{
+	struct log_dict_output_block_hdr_t hdr;
+	uint8_t msg[BLOCK_SIZE / 2] = { 0 };
+
+	msg[0] = MSG_NORMAL;
+	msg[5] = 0x12;
+	msg[6] = 0x34;
+	msg_write(msg, sizeof(msg));
+	log_dict_block_flush(&block);
+
+	memcpy(&hdr, sink_buf, sizeof(hdr));
+	if (IS_ENABLED(CONFIG_LOG_DICTIONARY_BLOCK_COMPRESSION)) {
+		zassert_true(hdr.flags & LOG_DICT_BLOCK_FLAG_COMPRESSED);
+		zassert_true(sys_le16_to_cpu(hdr.len) < sizeof(msg) / 4,
+			     "Block not compressed: %u", sys_le16_to_cpu(hdr.len));
+	} else {
+		zassert_equal(hdr.flags, 0);
+		zassert_equal(sys_le16_to_cpu(hdr.len), sizeof(msg));
+	}
+
+	zassert_equal(blocks_decode(), 1);
+	zassert_equal(decoded_len, sizeof(msg));
+	zassert_mem_equal(decoded, msg, sizeof(msg));
+}
+
+ZTEST_SUITE(log_dict_block, NULL, NULL, block_reset, NULL, NULL);
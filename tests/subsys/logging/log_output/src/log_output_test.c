@@ -218,6 +218,86 @@ ZTEST(test_log_output, test_colors)
 	}
 }
 
+/* Formatted message must be the same as with cbprintf. */
+#define TEST_FORMAT(fmt, ...) do { \
+	char package[128]; \
+	char exp_str[128]; \
+	int err; \
+	\
+	reset_mock_buffer(); \
+	err = cbprintf_package(package, sizeof(package), 0, fmt, ##__VA_ARGS__); \
+	zassert_true(err > 0); \
+	snprintk(exp_str, sizeof(exp_str), fmt, ##__VA_ARGS__); \
+	log_output_process(&log_output, 0, NULL, NULL, LOG_LEVEL_INF, package, \
+			   NULL, 0, LOG_OUTPUT_FLAG_CRLF_NONE); \
+	mock_buffer[mock_len] = '\0'; \
+	zassert_equal(strcmp(exp_str, mock_buffer), 0, \
+		      "\"%s\" instead of \"%s\"", mock_buffer, exp_str); \
+} while (0)
+
+ZTEST(test_log_output, test_formats)
+{
+	TEST_FORMAT("plain text");
+	TEST_FORMAT("%d %i %u", -5, 42, 3000000000U);
+	TEST_FORMAT("%5d|%-5d|%05d", -42, 7, -42);
+	TEST_FORMAT("%x %X %08x", 0xdeadbeef, 0xabcU, 0x12U);
+	TEST_FORMAT("%lld %llu", -1234567890123LL, 18446744073709551615ULL);
+	TEST_FORMAT("%hhd %hu %zu", 300, 70000, (size_t)12345);
+	TEST_FORMAT("%c %5s|%-5s|%s", 'a', "ab", "cd", "long string");
+	TEST_FORMAT("100%% done");
+	TEST_FORMAT("%p %s", (void *)0x1234, "fallback");
+}
+
+static uint32_t bench_len;
+
+static int bench_output_func(uint8_t *buf, size_t size, void *ctx)
+{
+	bench_len += size;
+
+	return size;
+}
+
+static uint8_t bench_buf[128];
+
+LOG_OUTPUT_DEFINE(bench_output, bench_output_func, bench_buf, sizeof(bench_buf));
+
+/* Throughput of formatting typical messages, to compare the cbprintf and
+ * the fast formatting.
+ */
+ZTEST(test_log_output, test_benchmark)
+{
+	char package[128];
+	uint32_t flags = LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP |
+			 LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP;
+	uint32_t repeat = 1000;
+	uint32_t cycles;
+	uint64_t us;
+	int err;
+
+	err = cbprintf_package(package, sizeof(package), 0,
+			       "Received %u bytes from %s, status 0x%08x",
+			       1234U, "peer", 0xcafeU);
+	zassert_true(err > 0);
+
+	log_output_timestamp_freq_set(1000000);
+	bench_len = 0;
+
+	cycles = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < repeat; i++) {
+		log_output_process(&bench_output, i * 1000U, NULL, SNAME,
+				   LOG_LEVEL_INF, package, NULL, 0, flags);
+	}
+
+	cycles = k_cycle_get_32() - cycles;
+	us = MAX(k_cyc_to_us_ceil64(cycles), 1);
+
+	TC_PRINT("%s formatting: %u messages (%u bytes) in %u us, %u messages/s\n",
+		 IS_ENABLED(CONFIG_LOG_OUTPUT_FAST_FORMATTING) ? "fast" : "cbprintf",
+		 repeat, bench_len, (uint32_t)us,
+		 (uint32_t)((uint64_t)repeat * USEC_PER_SEC / us));
+}
+
 static void before(void *notused)
 {
 	reset_mock_buffer();
@@ -0,0 +1,155 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Throughput of deferred logging when all CPUs log at the same time. */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_backend.h>
+
+LOG_MODULE_REGISTER(test);
+
+#define THREADS CONFIG_MP_MAX_NUM_CPUS
+#define MSGS_PER_THREAD 2000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+#define CNT_BITS 24
+
+struct mock_log_backend {
+	uint32_t last_id[THREADS];
+	uint32_t cnt;
+	uint32_t dropped;
+	uint32_t missing;
+	uint32_t unordered;
+	log_timestamp_t last_timestamp;
+};
+
+static struct mock_log_backend mock_backend;
+
+static void process(const struct log_backend *const backend,
+		    union log_msg_generic *msg)
+{
+	size_t len;
+	uint8_t *package = log_msg_get_package(&msg->log, &len);
+	log_timestamp_t timestamp = log_msg_get_timestamp(&msg->log);
+	uint32_t arg0;
+	uint32_t thread;
+	uint32_t id;
+
+	package += 2 * sizeof(void *);
+	arg0 = *(uint32_t *)package;
+	thread = arg0 >> CNT_BITS;
+	id = arg0 & BIT_MASK(CNT_BITS);
+
+	if (thread >= THREADS) {
+		return;
+	}
+
+	/* Messages of one thread keep their order, gaps are dropped ones. */
+	if (id > mock_backend.last_id[thread] + 1) {
+		mock_backend.missing += id - mock_backend.last_id[thread] - 1;
+	}
+
+	mock_backend.last_id[thread] = id;
+	mock_backend.cnt++;
+
+	if (timestamp < mock_backend.last_timestamp) {
+		mock_backend.unordered++;
+	}
+
+	mock_backend.last_timestamp = timestamp;
+}
+
+static void mock_init(struct log_backend const *const backend)
+{
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	mock_backend.dropped += cnt;
+}
+
+static const struct log_backend_api log_backend_api = {
+	.process = process,
+	.init = mock_init,
+	.dropped = dropped,
+};
+
+LOG_BACKEND_DEFINE(test, log_backend_api, true, NULL);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, THREADS, STACK_SIZE);
+static struct k_thread threads[THREADS];
+static atomic_t ready;
+
+static void log_thread(void *p1, void *p2, void *p3)
+{
+	uint32_t idx = POINTER_TO_UINT(p1);
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* Start logging on all CPUs at the same time. */
+	atomic_dec(&ready);
+	while (atomic_get(&ready) > 0) {
+	}
+
+	for (uint32_t i = 1; i <= MSGS_PER_THREAD; i++) {
+		LOG_INF("%u %u", (idx << CNT_BITS) | i, 100);
+	}
+}
+
+ZTEST(log_smp_benchmark, test_throughput)
+{
+	uint32_t total = THREADS * MSGS_PER_THREAD;
+	uint32_t start, cycles;
+	uint64_t ns;
+
+	memset(&mock_backend, 0, sizeof(mock_backend));
+	atomic_set(&ready, THREADS);
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i],
+				K_THREAD_STACK_SIZEOF(stacks[i]), log_thread,
+				UINT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < THREADS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	while (log_data_pending()) {
+		k_msleep(10);
+	}
+
+	/* Let the dropped messages be reported. */
+	k_msleep(CONFIG_LOG_FAILURE_REPORT_PERIOD + 100);
+	(void)log_process();
+
+	ns = k_cyc_to_ns_floor64(cycles);
+
+	TC_PRINT("%d CPUs, %s buffers: %u messages in %u us (%u msgs/s), "
+	      "%u dropped, %u out of timestamp order\n",
+	      THREADS,
+	      IS_ENABLED(CONFIG_LOG_PER_CPU_BUFFERS) ? "per CPU" : "shared",
+	      total, (uint32_t)(ns / 1000),
+	      (uint32_t)((uint64_t)total * NSEC_PER_SEC / MAX(ns, 1)),
+	      mock_backend.dropped, mock_backend.unordered);
+
+	zassert_equal(mock_backend.cnt + mock_backend.dropped, total,
+		      "processed:%u dropped:%u", mock_backend.cnt,
+		      mock_backend.dropped);
+	/* The last messages of a thread may be dropped without a gap. */
+	zassert_true(mock_backend.missing <= mock_backend.dropped,
+		     "dropped:%u missing:%u", mock_backend.dropped,
+		     mock_backend.missing);
+}
+
+ZTEST_SUITE(log_smp_benchmark, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,225 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "settings_test.h"
+#include "settings_priv.h"
+#include "settings/settings_fcb.h"
+
+#ifdef CONFIG_SETTINGS_TRANSACTION
+
+static struct settings_fcb cf;
+
+static void fcb_register(void)
+{
+	int rc;
+
+	config_wipe_srcs();
+
+	(void)memset(&cf, 0, sizeof(cf));
+	cf.cf_fcb.f_magic = CONFIG_SETTINGS_FCB_MAGIC;
+	cf.cf_fcb.f_sectors = fcb_sectors;
+	cf.cf_fcb.f_sector_cnt = ARRAY_SIZE(fcb_sectors);
+
+	rc = settings_fcb_src(&cf);
+	zassert_true(rc == 0, "can't register FCB as configuration source");
+
+	settings_mount_fcb_backend(&cf);
+
+	rc = settings_fcb_dst(&cf);
+	zassert_true(rc == 0,
+		     "can't register FCB as configuration destination");
+}
+
+/* Write a record the way the backend does, bypassing the duplicate check */
+static void fcb_record_write(const char *name, const void *value,
+			     size_t val_len)
+{
+	struct fcb_entry_ctx loc = { .fap = cf.cf_fcb.fap };
+	int rc;
+
+	rc = fcb_append(&cf.cf_fcb, settings_line_len_calc(name, val_len),
+			&loc.loc);
+	zassert_true(rc == 0, "fcb_append failed");
+
+	rc = settings_line_write(name, value, val_len, 0, &loc);
+	zassert_true(rc == 0, "settings_line_write failed");
+
+	rc = fcb_append_finish(&cf.cf_fcb, &loc.loc);
+	zassert_true(rc == 0, "fcb_append_finish failed");
+}
+
+ZTEST(settings_config_fcb, test_config_transaction_commit)
+{
+	uint8_t val = 1U;
+	uint64_t val_64 = 2U;
+	int rc;
+
+	rc = settings_register(&c_test_handlers[0]);
+	zassert_true(rc == 0 || rc == -EEXIST, "settings_register fail");
+	config_wipe_fcb(fcb_sectors, ARRAY_SIZE(fcb_sectors));
+	fcb_register();
+
+	rc = settings_transaction_begin();
+	zassert_true(rc == 0, "can't begin transaction");
+	zassert_equal(settings_transaction_begin(), -EALREADY,
+		      "nested transaction");
+
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "can't save in transaction");
+	val = 3U;
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "can't save in transaction");
+	rc = settings_save_one("myfoo/mybar64", &val_64, sizeof(val_64));
+	zassert_true(rc == 0, "can't save in transaction");
+
+	zassert_true(fcb_is_empty(&cf.cf_fcb),
+		     "values written before commit");
+
+	rc = settings_transaction_commit();
+	zassert_true(rc == 0, "can't commit transaction");
+	zassert_equal(settings_transaction_commit(), -EINVAL,
+		      "commit without transaction");
+
+	/* The values are loaded after a reset */
+	fcb_register();
+	val8 = 0U;
+	val64 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_equal(val8, 3U, "bad value read");
+	zassert_equal(val64, 2U, "bad value read");
+
+	settings_unregister(&c_test_handlers[0]);
+}
+
+ZTEST(settings_config_fcb, test_config_transaction_abort)
+{
+	uint8_t val = 5U;
+	int rc;
+
+	rc = settings_register(&c_test_handlers[0]);
+	zassert_true(rc == 0 || rc == -EEXIST, "settings_register fail");
+	config_wipe_fcb(fcb_sectors, ARRAY_SIZE(fcb_sectors));
+	fcb_register();
+
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "fcb write error");
+	rc = settings_flush();
+	zassert_true(rc == 0, "fcb write error");
+
+	rc = settings_transaction_begin();
+	zassert_true(rc == 0, "can't begin transaction");
+	val = 6U;
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "can't save in transaction");
+	rc = settings_transaction_abort();
+	zassert_true(rc == 0, "can't abort transaction");
+
+	val8 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_equal(val8, 5U, "aborted value read");
+
+	settings_unregister(&c_test_handlers[0]);
+}
+
+ZTEST(settings_config_fcb, test_config_transaction_rollback)
+{
+	uint8_t val = 7U;
+	uint64_t val_64 = 8U;
+	int rc;
+
+	rc = settings_register(&c_test_handlers[0]);
+	zassert_true(rc == 0 || rc == -EEXIST, "settings_register fail");
+	config_wipe_fcb(fcb_sectors, ARRAY_SIZE(fcb_sectors));
+	fcb_register();
+
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "fcb write error");
+	rc = settings_flush();
+	zassert_true(rc == 0, "fcb write error");
+
+	/* Transaction interrupted before its commit marker */
+	fcb_record_write(SETTINGS_FCB_TXN_BEGIN, NULL, 0);
+	val = 9U;
+	fcb_record_write("myfoo/mybar", &val, sizeof(val));
+	fcb_record_write("myfoo/mybar64", &val_64, sizeof(val_64));
+
+	fcb_register();
+	val8 = 0U;
+	val64 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_equal(val8, 7U, "transaction not rolled back");
+	zassert_equal(val64, 0U, "transaction not rolled back");
+
+	/* The rollback is persistent */
+	fcb_register();
+	val8 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_equal(val8, 7U, "transaction not rolled back");
+	zassert_equal(val64, 0U, "transaction not rolled back");
+
+	settings_unregister(&c_test_handlers[0]);
+}
+
+extern struct k_mutex settings_lock;
+
+static int fail_rc;
+static int fail_saves;
+
+static int fail_save(struct settings_store *cs, const char *name,
+		     const char *value, size_t val_len)
+{
+	if (fail_rc != 0) {
+		return fail_rc;
+	}
+
+	fail_saves++;
+
+	return 0;
+}
+
+static const struct settings_store_itf fail_itf = {
+	.csi_save = fail_save,
+};
+
+static struct settings_store fail_store = {
+	.cs_itf = &fail_itf,
+};
+
+ZTEST(settings_config_fcb, test_config_write_back_retry)
+{
+	uint8_t val = 10U;
+	int rc;
+
+	config_wipe_srcs();
+	settings_dst_register(&fail_store);
+	fail_saves = 0;
+
+	/* Cache the value as a write-back save does */
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	rc = settings_txn_save(&fail_store, "myfoo/mybar", &val, sizeof(val));
+	k_mutex_unlock(&settings_lock);
+	zassert_true(rc == 0, "can't cache value");
+
+	fail_rc = -EIO;
+	rc = settings_flush();
+	zassert_equal(rc, -EIO, "write failure not reported");
+
+	/* The value is kept and written by the next flush */
+	fail_rc = 0;
+	rc = settings_flush();
+	zassert_true(rc == 0, "can't write value again");
+	zassert_equal(fail_saves, 1, "value lost after failure");
+
+	rc = settings_flush();
+	zassert_true(rc == 0, "flush of empty cache failed");
+	zassert_equal(fail_saves, 1, "value written twice");
+
+	config_wipe_srcs();
+}
+
+#endif /* CONFIG_SETTINGS_TRANSACTION */
@@ -489,6 +489,70 @@ ZTEST(sh, test_section_cmd)
 	test_shell_execute_cmd("section_cmd cmd1 sub_cmd2", -EINVAL);
 }
 
+static int cmd_lookup(const struct shell *sh, size_t argc, char **argv)
+{
+	return 30;
+}
+
+static int cmd_lookup2(const struct shell *sh, size_t argc, char **argv)
+{
+	return 31;
+}
+
+static int cmd_lookup_x(const struct shell *sh, size_t argc, char **argv)
+{
+	return 32;
+}
+
+/* The linker sorts root commands by section name, shell_cmd_<syntax>_, so
+ * lookup2 and lookup_x come before lookup.
+ */
+SHELL_CMD_REGISTER(lookup, NULL, NULL, cmd_lookup);
+SHELL_CMD_REGISTER(lookup2, NULL, NULL, cmd_lookup2);
+SHELL_CMD_REGISTER(lookup_x, NULL, NULL, cmd_lookup_x);
+
+ZTEST(sh, test_cmd_lookup)
+{
+	/* Names sorting before, between and after the root commands. */
+	test_shell_execute_cmd("_unknown", -ENOEXEC);
+	test_shell_execute_cmd("dict", -ENOEXEC);
+	test_shell_execute_cmd("zzz", -ENOEXEC);
+
+	/* Names which are prefixes of other names. */
+	test_shell_execute_cmd("lookup", 30);
+	test_shell_execute_cmd("lookup2", 31);
+	test_shell_execute_cmd("lookup_x", 32);
+	test_shell_execute_cmd("lookup_", -ENOEXEC);
+	test_shell_execute_cmd("lookup2_", -ENOEXEC);
+
+	/* Found subcommands are cached, same names in different sets must
+	 * still resolve to their own set.
+	 */
+	for (int i = 0; i < 2; i++) {
+		test_shell_execute_cmd("dict1 one", 1);
+		test_shell_execute_cmd("dict2 one", 2);
+		test_shell_execute_cmd("dict1 two", 2);
+		test_shell_execute_cmd("dict2 two", 4);
+		test_shell_execute_cmd("section_cmd cmd1", 10);
+		test_shell_execute_cmd("section_cmd cmd1 sub_cmd1", 11);
+		test_shell_execute_cmd("section_cmd cmd1 sub_cmd3", -EINVAL);
+	}
+}
+
+ZTEST(sh, test_stats_tx)
+{
+	const struct shell *sh = shell_backend_dummy_get_ptr();
+	atomic_val_t tx_cnt;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_SHELL_STATS);
+
+	tx_cnt = atomic_get(&sh->stats->tx_cnt);
+	shell_print(sh, "0123456789");
+
+	zassert_true(atomic_get(&sh->stats->tx_cnt) - tx_cnt >= 10,
+		     "TX bytes not counted");
+}
+
 static void *shell_setup(void)
 {
 	const struct shell *sh = shell_backend_dummy_get_ptr();
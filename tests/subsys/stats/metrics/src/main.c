@@ -0,0 +1,130 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/irq_offload.h>
+#include <zephyr/stats/metrics.h>
+
+METRIC_COUNTER_DEFINE(test_events_total, "Test events");
+METRIC_GAUGE_DEFINE(test_level, "Test level");
+METRIC_HISTOGRAM_DEFINE_LABELED(test_size_a, test_size, "src=\"a\"", "Test sizes",
+				10, 100);
+METRIC_HISTOGRAM_DEFINE_LABELED(test_size_b, test_size, "src=\"b\"", "Test sizes",
+				10, 100);
+
+static char output[1024];
+static size_t output_len;
+
+static int output_cb(const char *data, size_t len, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	if (output_len + len >= sizeof(output)) {
+		return -ENOMEM;
+	}
+
+	memcpy(&output[output_len], data, len);
+	output_len += len;
+	output[output_len] = '\0';
+
+	return 0;
+}
+
+static void isr_update(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	metric_counter_inc(&test_events_total);
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	STRUCT_SECTION_FOREACH(metric, m) {
+		metric_reset(m);
+	}
+	output_len = 0;
+}
+
+ZTEST(metrics, test_counter)
+{
+	metric_counter_add(&test_events_total, UINT32_MAX);
+	metric_counter_inc(&test_events_total);
+	irq_offload(isr_update, NULL);
+
+	zassert_equal(metric_counter_get(&test_events_total), (uint64_t)UINT32_MAX + 2);
+}
+
+ZTEST(metrics, test_gauge)
+{
+	metric_gauge_set(&test_level, 10);
+	metric_gauge_add(&test_level, -15);
+
+	zassert_equal(metric_gauge_get(&test_level), -5);
+}
+
+ZTEST(metrics, test_histogram)
+{
+	uint64_t buckets[3];
+	uint64_t count;
+	uint64_t sum;
+
+	metric_histogram_observe(&test_size_a, 10);
+	metric_histogram_observe(&test_size_a, 11);
+	metric_histogram_observe(&test_size_a, 1000);
+
+	metric_histogram_get(&test_size_a, buckets, &count, &sum);
+	zassert_equal(buckets[0], 1);
+	zassert_equal(buckets[1], 1);
+	zassert_equal(buckets[2], 1);
+	zassert_equal(count, 3);
+	zassert_equal(sum, 1021);
+}
+
+ZTEST(metrics, test_find)
+{
+	zassert_equal_ptr(metric_find("test_size", "src=\"b\""), &test_size_b);
+	zassert_equal_ptr(metric_find("test_level", NULL), &test_level);
+	zassert_is_null(metric_find("test_size", NULL));
+	zassert_is_null(metric_find("unknown", NULL));
+}
+
+ZTEST(metrics, test_prometheus)
+{
+	metric_counter_add(&test_events_total, 3);
+	metric_gauge_set(&test_level, -2);
+	metric_histogram_observe(&test_size_b, 50);
+
+	zassert_ok(metrics_export_prometheus(output_cb, NULL));
+
+	zassert_not_null(strstr(output, "# TYPE test_events_total counter\n"
+				"test_events_total 3\n"));
+	zassert_not_null(strstr(output, "test_level -2\n"));
+	zassert_not_null(strstr(output, "test_size_bucket{src=\"b\",le=\"100\"} 1\n"
+				"test_size_bucket{src=\"b\",le=\"+Inf\"} 1\n"
+				"test_size_sum{src=\"b\"} 50\n"));
+
+	/* One header for both labeled histograms */
+	const char *type = strstr(output, "# TYPE test_size histogram\n");
+
+	zassert_not_null(type);
+	zassert_is_null(strstr(type + 1, "# TYPE test_size histogram\n"));
+}
+
+#ifdef CONFIG_METRICS_CBOR
+ZTEST(metrics, test_cbor)
+{
+	uint8_t buf[256];
+	size_t len;
+
+	zassert_ok(metrics_export_cbor(buf, sizeof(buf), &len));
+	zassert_true(len > 0);
+
+	zassert_equal(metrics_export_cbor(buf, 16, &len), -ENOMEM);
+}
+#endif
+
+ZTEST_SUITE(metrics, NULL, NULL, before, NULL, NULL);
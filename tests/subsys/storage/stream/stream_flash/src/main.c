@@ -463,6 +463,98 @@ ZTEST(lib_stream_flash, test_stream_flash_buffered_write_whole_page)
 }
 #endif
 
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+ZTEST(lib_stream_flash, test_stream_flash_double_buffer)
+{
+	size_t len = (page_size * 2) + 128;
+	size_t chunk = 100;
+	int rc;
+
+	init_target();
+
+	rc = stream_flash_double_buffer_enable(&ctx);
+	zassert_equal(rc, 0, "expected success");
+	zassert_equal(ctx.buf_len, BUF_LEN / 2, "buffer should be split");
+
+	for (size_t off = 0; off < len; off += chunk) {
+		rc = stream_flash_buffered_write(&ctx, write_buf,
+						 MIN(chunk, len - off), false);
+		zassert_equal(rc, 0, "expected success");
+	}
+
+	/* The flush waits for the data being programmed */
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+	zassert_equal(stream_flash_bytes_written(&ctx), len,
+		      "all bytes should be written");
+
+	VERIFY_WRITTEN(0, len);
+
+	/* More data than available is refused, including buffered data */
+	ctx.available = len + BUF_LEN;
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN / 2, false);
+	zassert_equal(rc, 0, "expected success");
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN, false);
+	zassert_equal(rc, -ENOMEM, "expected failure");
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+}
+
+ZTEST(lib_stream_flash, test_stream_flash_double_buffer_error)
+{
+	struct device fake_dev = *fdev;
+	struct flash_driver_api fake_api = *(struct flash_driver_api *)fdev->api;
+	int rc;
+
+	init_target();
+
+	fake_api.write = bad_write;
+	fake_dev.api = &fake_api;
+	rc = stream_flash_init(&ctx, &fake_dev, buf, BUF_LEN, FLASH_BASE, 0,
+			       NULL);
+	zassert_equal(rc, 0, "expected success");
+	rc = stream_flash_double_buffer_enable(&ctx);
+	zassert_equal(rc, 0, "expected success");
+
+	/* The first half is handed over without waiting for the write */
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN / 2, false);
+	zassert_equal(rc, 0, "expected success");
+
+	/* The failure is reported when handing over the next one */
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN / 2, false);
+	zassert_equal(rc, -EINVAL, "expected failure");
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, -EINVAL, "expected failure");
+	zassert_equal(stream_flash_bytes_written(&ctx), 0,
+		      "no bytes should be written");
+}
+
+#ifdef CONFIG_STREAM_FLASH_ERASE_AHEAD
+ZTEST(lib_stream_flash, test_stream_flash_erase_ahead)
+{
+	int rc;
+
+	init_target();
+
+	/* Data left in the second page by a previous image */
+	rc = flash_write(fdev, FLASH_BASE + page_size, write_buf, page_size);
+	zassert_equal(rc, 0, "should succeed");
+
+	rc = stream_flash_double_buffer_enable(&ctx);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, page_size, true);
+	zassert_equal(rc, 0, "expected success");
+
+	/* The page following the data is erased before being written to */
+	VERIFY_WRITTEN(0, page_size);
+	VERIFY_ERASED(page_size, page_size);
+	zassert_equal(ctx.last_erased_page_start_offset, FLASH_BASE + page_size,
+		      "second page should be the last erased");
+}
+#endif /* CONFIG_STREAM_FLASH_ERASE_AHEAD */
+#endif /* CONFIG_STREAM_FLASH_DOUBLE_BUFFER */
+
 static size_t write_and_save_progress(size_t bytes, const char *save_key)
 {
 	int rc;
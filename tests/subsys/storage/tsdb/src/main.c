@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/storage/tsdb.h>
+#include <zephyr/storage/flash_map.h>
+
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(storage_partition)
+#define TEST_SECTOR_SIZE	4096
+#define TEST_SECTOR_COUNT	4
+
+static struct tsdb_fs fs;
+
+struct query_result {
+	int cnt;
+	int64_t first_ts;
+	int64_t last_ts;
+	bool ordered;
+	bool valid;
+	int stop_at;
+};
+
+/* Values are derived from the timestamps to check the samples read */
+static int32_t test_value(int64_t ts)
+{
+	return (int32_t)((ts * 7) % 1000) - 500;
+}
+
+static int query_cb(const struct tsdb_sample *sample, void *user_data)
+{
+	struct query_result *res = user_data;
+
+	if (res->cnt == 0) {
+		res->first_ts = sample->ts;
+	} else if (sample->ts < res->last_ts) {
+		res->ordered = false;
+	}
+	if (sample->value != test_value(sample->ts)) {
+		res->valid = false;
+	}
+
+	res->last_ts = sample->ts;
+	res->cnt++;
+
+	return (res->cnt == res->stop_at) ? 1 : 0;
+}
+
+static struct query_result query(int64_t from, int64_t to)
+{
+	struct query_result res = {
+		.ordered = true,
+		.valid = true,
+	};
+	int rc;
+
+	rc = tsdb_query(&fs, from, to, query_cb, &res);
+	zassert_equal(rc, res.cnt, "Query failed (%d)", rc);
+	zassert_true(res.ordered, "Samples out of order");
+	zassert_true(res.valid, "Bad sample values");
+
+	return res;
+}
+
+static void mount(int64_t retention)
+{
+	int rc;
+
+	(void)memset(&fs, 0, sizeof(fs));
+	fs.area_id = TEST_PARTITION_ID;
+	fs.sector_size = TEST_SECTOR_SIZE;
+	fs.sector_count = TEST_SECTOR_COUNT;
+	fs.retention = retention;
+
+	rc = tsdb_mount(&fs);
+	zassert_equal(rc, 0, "Can't mount (%d)", rc);
+}
+
+static void append(int64_t ts)
+{
+	int rc;
+
+	rc = tsdb_append(&fs, ts, test_value(ts));
+	zassert_equal(rc, 0, "Can't append sample %lld (%d)", ts, rc);
+}
+
+ZTEST(tsdb, test_append_query)
+{
+	struct query_result res;
+	int64_t ts = 1000;
+
+	for (int i = 0; i < 1000; i++) {
+		ts += 100 + (i % 5);
+		append(ts);
+	}
+
+	res = query(INT64_MIN, INT64_MAX);
+	zassert_equal(res.cnt, 1000, "Got %d samples", res.cnt);
+	zassert_equal(res.last_ts, ts, "Newest sample missing");
+
+	res = query(20000, 30000);
+	zassert_true(res.cnt > 0, "No samples in range");
+	zassert_true(res.first_ts >= 20000 && res.last_ts <= 30000,
+		     "Samples out of range");
+
+	res = query(ts + 1, INT64_MAX);
+	zassert_equal(res.cnt, 0, "Samples after the newest one");
+
+	/* Samples must be appended in time order */
+	zassert_equal(tsdb_append(&fs, ts - 1, 0), -EINVAL,
+		      "Older sample appended");
+}
+
+ZTEST(tsdb, test_compression)
+{
+	int64_t ts = 0;
+	int rc;
+
+	/* Periodic samples of a slowly changing value */
+	for (int i = 0; i < 1000; i++) {
+		ts += 1000;
+		rc = tsdb_append(&fs, ts, 2000 + (i % 3));
+		zassert_equal(rc, 0, "Can't append sample");
+	}
+	rc = tsdb_flush(&fs);
+	zassert_equal(rc, 0, "Can't flush");
+
+	/* Far less than the 12 bytes of a sample */
+	zassert_true(fs.bytes_written < 1000 * 4, "%u bytes written",
+		     fs.bytes_written);
+}
+
+ZTEST(tsdb, test_remount)
+{
+	struct query_result res;
+	int64_t ts = 0;
+	int rc;
+
+	for (int i = 0; i < 500; i++) {
+		ts += 10;
+		append(ts);
+	}
+	rc = tsdb_flush(&fs);
+	zassert_equal(rc, 0, "Can't flush");
+
+	/* Not flushed, lost on remount */
+	append(ts + 10);
+
+	mount(0);
+
+	res = query(INT64_MIN, INT64_MAX);
+	zassert_equal(res.cnt, 500, "Got %d samples", res.cnt);
+	zassert_equal(res.last_ts, ts, "Newest sample missing");
+
+	/* The order is kept across mounts */
+	zassert_equal(tsdb_append(&fs, ts - 1, 0), -EINVAL,
+		      "Older sample appended");
+	append(ts + 10);
+	res = query(ts, INT64_MAX);
+	zassert_equal(res.cnt, 2, "Got %d samples", res.cnt);
+}
+
+ZTEST(tsdb, test_recycle)
+{
+	struct query_result res;
+	int64_t first_ts;
+	int64_t ts = 0;
+
+	/* Noisy timestamps, so that samples take more space */
+	for (int i = 0; i < 20000; i++) {
+		ts += 1000 + (i * 7919) % 97;
+		append(ts);
+	}
+
+	zassert_true(fs.sectors_erased > TEST_SECTOR_COUNT,
+		     "Oldest sectors not recycled");
+
+	res = query(INT64_MIN, INT64_MAX);
+	zassert_true(res.cnt < 20000, "Oldest samples kept");
+	zassert_equal(res.last_ts, ts, "Newest sample missing");
+
+	/* Old samples go with their sector when the retention is set */
+	first_ts = res.first_ts;
+	zassert_equal(tsdb_flush(&fs), 0, "Can't flush");
+	mount((ts - first_ts) / 2);
+
+	res = query(INT64_MIN, INT64_MAX);
+	zassert_true(res.first_ts > first_ts, "Expired samples kept");
+	zassert_equal(res.last_ts, ts, "Newest sample missing");
+	zassert_true(fs.sectors_erased > 0, "Expired sector not erased");
+}
+
+ZTEST(tsdb, test_query_stop)
+{
+	struct query_result res = {
+		.ordered = true,
+		.valid = true,
+		.stop_at = 10,
+	};
+	int rc;
+
+	for (int64_t ts = 1; ts <= 100; ts++) {
+		append(ts);
+	}
+
+	rc = tsdb_query(&fs, 50, 100, query_cb, &res);
+	zassert_equal(rc, 10, "Query not stopped (%d)", rc);
+	zassert_equal(res.first_ts, 50, "Bad first sample");
+}
+
+static void tsdb_before(void *fixture)
+{
+	mount(0);
+	zassert_equal(tsdb_clear(&fs), 0, "Can't clear");
+	fs.bytes_written = 0;
+	fs.sectors_erased = 0;
+}
+
+ZTEST_SUITE(tsdb, NULL, NULL, tsdb_before, NULL, NULL);
@@ -0,0 +1,294 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Tracing is disabled by CONFIG_TRACING_HANDLE_HOST_CMD, so only the data
+ * put in the tracing buffer by the tests reaches the backend.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/tracing/tracing_format.h>
+#include <tracing_core.h>
+#include <tracing_buffer.h>
+
+/* ID of the CTF packets_dropped event, see subsys/tracing/ctf/ctf_top.h */
+#define CTF_EVENT_PACKETS_DROPPED 0x34
+
+static k_tid_t tracing_tid;
+
+static void tracing_thread_find(const struct k_thread *thread, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (strcmp(k_thread_name_get((k_tid_t)thread), "tracing_thread") == 0) {
+		tracing_tid = (k_tid_t)thread;
+	}
+}
+
+static uint32_t buffer_put(uint8_t *data, uint32_t size)
+{
+	unsigned int key;
+	uint32_t len;
+
+	/* The buffer written depends on the CPU */
+	key = arch_irq_lock();
+	len = tracing_buffer_put(data, size);
+	arch_irq_unlock(key);
+
+	return len;
+}
+
+/* Let the tracing thread output the buffer, as it does after events. */
+static void output_wait(void)
+{
+	tracing_trigger_output(true);
+	k_msleep(CONFIG_TRACING_THREAD_WAIT_THRESHOLD + 100);
+	zassert_true(tracing_buffer_is_empty(), "Tracing data not output");
+}
+
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+static K_THREAD_STACK_DEFINE(put_stack, 1024);
+static struct k_thread put_thread;
+static uint8_t put_value;
+static uint32_t put_len;
+static uint32_t put_done;
+static uint32_t put_space;
+
+static void put_func(void *p1, void *p2, void *p3)
+{
+	uint8_t data[16];
+	uint32_t len;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	memset(data, put_value, sizeof(data));
+	put_done = 0;
+
+	while (put_done < put_len) {
+		len = buffer_put(data, MIN(sizeof(data), put_len - put_done));
+		if (len == 0) {
+			break;
+		}
+
+		put_done += len;
+	}
+
+	put_space = tracing_buffer_space_get();
+}
+
+/* Put len bytes of value in the tracing buffer from a given CPU */
+static uint32_t put_on_cpu(int cpu, uint8_t value, uint32_t len)
+{
+	put_value = value;
+	put_len = len;
+
+	k_thread_create(&put_thread, put_stack, K_THREAD_STACK_SIZEOF(put_stack),
+			put_func, NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0,
+			K_FOREVER);
+	zassert_ok(k_thread_cpu_pin(&put_thread, cpu));
+	k_thread_start(&put_thread);
+	zassert_ok(k_thread_join(&put_thread, K_SECONDS(1)));
+
+	return put_done;
+}
+#endif
+
+ZTEST(tracing_backends, test_per_cpu_buffers)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_TRACING_PER_CPU_BUFFERS);
+
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+	uint32_t capacity = tracing_buffer_capacity_get();
+	uint32_t counts[2] = { 0 };
+	bool run_start = true;
+	uint8_t run_value = 0;
+	uint8_t *data;
+	uint32_t len;
+
+	/* The buffers are read by the test */
+	k_thread_suspend(tracing_tid);
+	zassert_true(tracing_buffer_is_empty());
+
+	/* A full buffer on CPU 0 does not take space from CPU 1 */
+	zassert_equal(put_on_cpu(0, 0xa0, capacity), capacity);
+	zassert_equal(put_space, 0);
+	zassert_equal(put_on_cpu(1, 0xa1, 100), 100);
+	zassert_equal(put_space, capacity - 100);
+
+	/* Reading stops on the boundary of the data of each buffer */
+	while (!tracing_buffer_is_empty()) {
+		len = tracing_buffer_get_claim(&data, capacity);
+		zassert_true(len > 0);
+
+		if (run_start) {
+			run_value = data[0];
+			zassert_true((run_value == 0xa0) || (run_value == 0xa1),
+				     "Unexpected data %x", run_value);
+		}
+
+		for (uint32_t i = 0; i < len; i++) {
+			zassert_equal(data[i], run_value, "Data of CPUs mixed");
+		}
+
+		counts[run_value - 0xa0] += len;
+		zassert_ok(tracing_buffer_get_finish(len));
+		run_start = tracing_buffer_get_at_boundary(0);
+	}
+
+	zassert_equal(counts[0], capacity);
+	zassert_equal(counts[1], 100);
+
+	k_thread_resume(tracing_tid);
+#endif
+}
+
+#ifdef CONFIG_TRACING_BACKEND_RAM
+extern uint8_t ram_tracing[];
+static uint32_t ram_pos;
+#endif
+
+ZTEST(tracing_backends, test_ram_drop_event)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_TRACING_BACKEND_RAM);
+
+#ifdef CONFIG_TRACING_BACKEND_RAM
+	uint8_t packet[] = "packet";
+	uint32_t count;
+
+	/* Drops are reported once the data in the buffer is output */
+	for (int i = 0; i < 3; i++) {
+		tracing_packet_drop_handle();
+	}
+
+	zassert_equal(buffer_put(packet, sizeof(packet)), sizeof(packet));
+	output_wait();
+
+	zassert_mem_equal(&ram_tracing[ram_pos], packet, sizeof(packet));
+	ram_pos += sizeof(packet);
+	zassert_equal(ram_tracing[ram_pos], CTF_EVENT_PACKETS_DROPPED,
+		      "No drop event");
+	memcpy(&count, &ram_tracing[ram_pos + 1], sizeof(count));
+	zassert_equal(count, 3, "Wrong drop count %u", count);
+	ram_pos += 1 + sizeof(count);
+
+	/* The count restarts after a report */
+	zassert_equal(buffer_put(packet, sizeof(packet)), sizeof(packet));
+	output_wait();
+
+	zassert_mem_equal(&ram_tracing[ram_pos], packet, sizeof(packet));
+	ram_pos += sizeof(packet);
+	zassert_equal(ram_tracing[ram_pos], 0, "Unexpected drop event");
+#endif
+}
+
+#ifdef CONFIG_TRACING_BACKEND_FS
+#define FS_CHUNK_DATA 400
+#define FS_ROUNDS 3
+#define FS_PANIC_DATA 100
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(lfs_data);
+
+static struct fs_mount_t lfs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &lfs_data,
+	.storage_dev = (void *)FIXED_PARTITION_ID(storage_partition),
+	.mnt_point = CONFIG_TRACING_BACKEND_FS_DIR,
+};
+
+static uint8_t fs_data[FS_ROUNDS * FS_CHUNK_DATA + FS_PANIC_DATA];
+static uint8_t fs_read_buf[sizeof(fs_data) + 1];
+
+/* Concatenate the trace chunks, returns the number of chunks */
+static int chunks_read(size_t *size)
+{
+	char name[64];
+	struct fs_file_t file;
+	ssize_t rc;
+	int num;
+
+	*size = 0;
+
+	for (num = 0; ; num++) {
+		snprintf(name, sizeof(name), "%s/%s%04u",
+			 CONFIG_TRACING_BACKEND_FS_DIR,
+			 CONFIG_TRACING_BACKEND_FS_FILE_PREFIX, num);
+
+		fs_file_t_init(&file);
+		if (fs_open(&file, name, FS_O_READ) != 0) {
+			break;
+		}
+
+		rc = fs_read(&file, &fs_read_buf[*size],
+			     sizeof(fs_read_buf) - *size);
+		zassert_true(rc >= 0, "Can not read %s", name);
+		*size += rc;
+
+		zassert_ok(fs_close(&file));
+	}
+
+	return num;
+}
+#endif
+
+ZTEST(tracing_backends, test_fs_round_trip)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_TRACING_BACKEND_FS);
+
+#ifdef CONFIG_TRACING_BACKEND_FS
+	size_t size;
+	int chunks;
+
+	for (size_t i = 0; i < sizeof(fs_data); i++) {
+		fs_data[i] = (uint8_t)(i * 7 + i / 256);
+	}
+
+	/* Chunks are closed on the first boundary after the chunk size, the
+	 * first one after two rounds.
+	 */
+	for (int i = 0; i < FS_ROUNDS; i++) {
+		zassert_equal(buffer_put(&fs_data[i * FS_CHUNK_DATA],
+					 FS_CHUNK_DATA), FS_CHUNK_DATA);
+		output_wait();
+	}
+
+	/* The last chunk is synced once no more data comes */
+	k_msleep(CONFIG_TRACING_THREAD_FLUSH_TIMEOUT + 100);
+
+	chunks = chunks_read(&size);
+	zassert_equal(chunks, 2, "Unexpected number of chunks %d", chunks);
+	zassert_equal(size, FS_ROUNDS * FS_CHUNK_DATA, "Wrong size %zu", size);
+	zassert_mem_equal(fs_read_buf, fs_data, size);
+
+	/* Data written before a panic is synced */
+	zassert_equal(buffer_put(&fs_data[FS_ROUNDS * FS_CHUNK_DATA],
+				 FS_PANIC_DATA), FS_PANIC_DATA);
+	output_wait();
+	tracing_panic();
+
+	chunks_read(&size);
+	zassert_equal(size, sizeof(fs_data), "Wrong size %zu", size);
+	zassert_mem_equal(fs_read_buf, fs_data, size);
+#endif
+}
+
+static void *tracing_backends_setup(void)
+{
+	k_thread_foreach(tracing_thread_find, NULL);
+	zassert_not_null(tracing_tid, "No tracing thread");
+
+#ifdef CONFIG_TRACING_BACKEND_FS
+	zassert_ok(fs_mount(&lfs_mnt));
+#endif
+
+	return NULL;
+}
+
+ZTEST_SUITE(tracing_backends, NULL, tracing_backends_setup, NULL, NULL, NULL);